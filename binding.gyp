@@ -119,11 +119,17 @@
             'type': 'executable',
             'sources': [
                 'test/cpp/test_main.cpp',
+                'test/cpp/test_btree.cpp',
+                'test/cpp/test_clustering.cpp',
+                'test/cpp/test_geoindex.cpp',
+                'test/cpp/test_gix.cpp',
                 'test/cpp/test_linalg.cpp',
                 'test/cpp/test_misc.cpp',
+                'test/cpp/test_pgblob.cpp',
                 'test/cpp/test_quantiles.cpp',
                 'test/cpp/test_slotted_histogram.cpp',
                 'test/cpp/test_sizeof.cpp',
+                'test/cpp/test_svm.cpp',
                 'test/cpp/test_temaspvec.cpp',
                 'test/cpp/test_tgix.cpp',
                 'test/cpp/test_thash.cpp',
@@ -71,6 +71,7 @@ typedef long long index_t;
   #include <windows.h>
   #include <oleauto.h>
   #include <shellapi.h>
+  #include <io.h>
 #endif
 
 #if defined(GLib_UNIX)
@@ -85,6 +86,7 @@ typedef long long index_t;
   #include <signal.h>
   #include <sys/poll.h>
   #include <sys/socket.h>
+  #include <sys/mman.h>
   #include <sys/stat.h>
   #include <sys/time.h>
   #include <sys/types.h>
@@ -156,6 +158,12 @@ typedef long long index_t;
 #include <time.h>
 #include <typeinfo>
 #include <stdexcept>
+#include <mutex>
+#include <shared_mutex>
+
+#ifdef GLib_OPENMP
+  #include <omp.h>
+#endif
 
 #ifdef GLib_CYGWIN
   #define timezone _timezone
@@ -279,7 +279,13 @@ TGBlobBs::TGBlobBs(
 }
 
 TGBlobBs::~TGBlobBs(){
+  Flush();
+  FBlobBs=NULL;
+}
+
+void TGBlobBs::Flush(){
   if (Access!=faRdOnly){
+    // header is marked closed, so the file can be opened from here after a crash
     FBlobBs->SetFPos(0);
     PutVersionStr(FBlobBs);
     PutBlobBsStateStr(FBlobBs, bbsClosed);
@@ -288,7 +294,6 @@ TGBlobBs::~TGBlobBs(){
     PutFFreeBlobPtV(FBlobBs, FFreeBlobPtV);
   }
   FBlobBs->Flush();
-  FBlobBs=NULL;
 }
 
 TBlobPt TGBlobBs::PutBlob(const PSIn& SIn){
@@ -574,6 +579,14 @@ TMBlobBs::~TMBlobBs(){
   }
 }
 
+void TMBlobBs::Flush(){
+  if (Access!=faRdOnly){
+    SaveMain();
+  }
+  for (int SegN=0; SegN<SegV.Len(); SegN++){
+    SegV[SegN]->Flush();}
+}
+
 // save a new buffer in SIn to a blob
 TBlobPt TMBlobBs::PutBlob(const PSIn& SIn){
   EAssert((Access==faCreate)||(Access==faUpdate)||(Access==faRestore));
@@ -163,6 +163,10 @@ public:
 
   virtual const TBlobBsStats& GetStats()=0;
   virtual void ResetStats() = 0;
+
+  /// write the header to disk, so the blob base can be opened from its current
+  /// state even when it is not closed
+  virtual void Flush()=0;
 };
 
 /////////////////////////////////////////////////
@@ -211,6 +215,8 @@ public:
 
   const TBlobBsStats& GetStats() { return Stats; }
   void ResetStats() { Stats.Reset(); }
+
+  void Flush();
 };
 
 /////////////////////////////////////////////////
@@ -259,4 +265,6 @@ public:
 
   const TBlobBsStats& GetStats();
   void ResetStats();
+
+  void Flush();
 };
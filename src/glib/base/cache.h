@@ -562,6 +562,8 @@ private:
     int GetLastBlock(PBlockDat& BlockDat);
     // delete oldest block
     void DelBlock();
+    // save block map and offsets to FNm
+    void SaveBlockMap() const;
 
     // value id transformations
     uint64 GetValId(const int& BlockId, const int& BlockValId) const {
@@ -620,6 +622,8 @@ public:
         }
         return res;
     }
+    /// Save changed blocks and the block map, keeping the cache loaded
+    void Save();
     /// Get statistics about BLOB storage
     TBlobBsStats GetBlobBsStats() { return BlockBlobBs->GetStats(); }
 };
@@ -750,15 +754,27 @@ TWndBlockCache<TVal>::~TWndBlockCache() {
         // flush all the latest changes in cache to the disk        
         BlockCache.Flush();
         // save the rest to FNm
-        TFOut FOut(FNm);
-        Vals.Save(FOut);
-        BlockSize.Save(FOut);
-        BlockBlobPtV.Save(FOut);
-        FirstBlockOffset.Save(FOut);
-        FirstValOffset.Save(FOut);
+        SaveBlockMap();
     }
 }
 
+template <class TVal>
+void TWndBlockCache<TVal>::SaveBlockMap() const {
+    TFOut FOut(FNm);
+    Vals.Save(FOut);
+    BlockSize.Save(FOut);
+    BlockBlobPtV.Save(FOut);
+    FirstBlockOffset.Save(FOut);
+    FirstValOffset.Save(FOut);
+}
+
+template <class TVal>
+void TWndBlockCache<TVal>::Save() {
+    AssertReadOnly();
+    PartialFlush(TInt::Mx);
+    SaveBlockMap();
+}
+
 template <class TVal>
 uint64 TWndBlockCache<TVal>::AddVal(const TVal& Val) {
     // get last block, with some space left
@@ -1412,6 +1412,10 @@ public:
         VVec.XDim = (RowEnd - RowStart + 1);
         VVec.YDim = YDim;
     }
+    /// Constructs a _XDim x _YDim matrix on memory array _ValT, which it does not own (see TVec::GenExt)
+    void GenExt(TVal* _ValT, const TSizeTy& _XDim, const TSizeTy& _YDim){
+        XDim = _XDim; YDim = _YDim; ValV.GenExt(_ValT, XDim*YDim); ColMajor = colmajor;
+    }
     explicit TVVec(TSIn& SIn) { Load(SIn); }
     void Load(TSIn& SIn){
         SIn.Load(XDim);
@@ -1739,6 +1743,10 @@ public:
       Last=Queue.Last; Next=Queue.Next; ValV=Queue.ValV;}
       return *this;}
 
+  /// Memory footprint, including the reserved space
+  uint64 GetMemUsed() const {
+    return sizeof(TQQueue<TVal>) + TMemUtils::GetExtraMemberSize(ValV);}
+
   /// Index operator. Queue[0] corresponds to Back() and Queue[Queue.Len()-1] corresponts to Front()
   const TVal& operator[](const int& ValN) const {
     Assert((0<=ValN)&&(ValN<Len()));
@@ -134,7 +134,8 @@ TStr TVec<TVal, TSizeTy>::GetXOutOfBoundsErrMsg(const TSizeTy& ValN) const {
 
 template <class TVal, class TSizeTy>
 TVec<TVal, TSizeTy>::TVec(const TVec<TVal, TSizeTy>& Vec){
-  MxVals=Vec.MxVals; Vals=Vec.Vals;
+  // copy of an external vector (see GenExt) owns its memory
+  MxVals=(Vec.MxVals==-1) ? Vec.Vals : Vec.MxVals; Vals=Vec.Vals;
   if (MxVals==0){ValT=NULL;} else {ValT=new TVal[MxVals];}
   for (TSizeTy ValN=0; ValN<Vec.Vals; ValN++){ValT[ValN]=Vec.ValT[ValN];}
 }
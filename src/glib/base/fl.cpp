@@ -520,6 +520,15 @@ void TFOut::Flush(){
   EAssertR(fflush(FileId)==0, "Can not flush file '"+GetSNm()+"'.");
 }
 
+void TFOut::Sync(){
+  Flush();
+#ifdef GLib_WIN
+  EAssertR(_commit(_fileno(FileId))==0, "Can not sync file '"+GetSNm()+"'.");
+#else
+  EAssertR(fsync(fileno(FileId))==0, "Can not sync file '"+GetSNm()+"'.");
+#endif
+}
+
 TStr TFOut::GetSNm() const {
   return SNm; 
 }
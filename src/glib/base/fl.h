@@ -357,6 +357,8 @@ public:
   int PutCh(const char& Ch);
   int PutBf(const void* LBf, const TSize& LBfL);
   void Flush();
+  // flushes and forces the data to the disk (fsync)
+  void Sync();
 
   TStr GetSNm() const;
   TFileId GetFileId() const {return FileId;}
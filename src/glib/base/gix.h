@@ -12,6 +12,7 @@
 /////////////////////////////////////////////////
 // Forward-declarations
 template <class TKey, class TItem> class TGix;
+template <class TKey, class TItem, class TResItem> class TGixMerger;
 
 /////////////////////////////////////////////////
 /// Item Handler.
@@ -32,10 +33,75 @@ public:
     /// Is Item1 <= Item2?
     virtual bool IsLtE(const TItem& Item1, const TItem& Item2) const = 0;
 
+    /// Should child vectors of the given key be stored compressed?
+    virtual bool IsCompress(const TKey& Key) const { return false; }
+    /// Encode merged items into compact byte representation. Returns false when
+    /// items cannot be encoded, in which case child vector is stored uncompressed.
+    virtual bool Encode(const TVec<TItem>& ItemV, TMem& Mem) const { return false; }
+    /// Decode items encoded with Encode
+    virtual void Decode(const TMem& Mem, const int& Items, TVec<TItem>& ItemV) const {
+        FailR("Item handler does not support compressed child vectors"); }
+
     /// Memory footprint
     virtual uint64 GetMemUsed() const = 0;
 };
 
+/////////////////////////////////////////////////
+/// Variable-length integer coding.
+/// Helper for item handlers supporting compressed child vectors. Integers are
+/// written 7 bits per byte, starting with lowest bits. Highest bit of the byte
+/// marks that more bytes follow.
+class TGixVarInt {
+public:
+    /// Append unsigned integer to the buffer
+    static void Save(uint64 Val, TMem& Mem) {
+        while (Val >= 0x80) { Mem += (char)((Val & 0x7F) | 0x80); Val >>= 7; }
+        Mem += (char)Val;
+    }
+    /// Read unsigned integer from the buffer and move BfC after it
+    static uint64 Load(const TMem& Mem, int& BfC) {
+        const uchar* Bf = (const uchar*)Mem.GetBf();
+        uint64 Val = 0; int Shift = 0;
+        forever {
+            EAssertR(BfC < Mem.Len() && Shift < 64, "Corrupted compressed child vector");
+            const uchar Ch = Bf[BfC++];
+            Val |= (uint64)(Ch & 0x7F) << Shift;
+            if ((Ch & 0x80) == 0) { break; }
+            Shift += 7;
+        }
+        return Val;
+    }
+    /// Map signed integer to unsigned so that small absolute values get short codes
+    static uint64 GetZigZag(const int64& Val) { return ((uint64)Val << 1) ^ (uint64)(Val >> 63); }
+    /// Inverse of GetZigZag
+    static int64 GetUnZigZag(const uint64& Val) { return (int64)(Val >> 1) ^ -(int64)(Val & 1); }
+};
+
+/////////////////////////////////////////////////
+/// Galloping search.
+/// Helper for intersecting sorted vectors of very different lengths. Probes
+/// positions at exponentially growing distances and finishes with binary search.
+class TGixGallop {
+public:
+    /// Get index of the first element in sorted ItemV, starting from StartN, which
+    /// is not smaller than Item. Returns ItemV.Len() when there is no such element.
+    template <class TItem>
+    static int GetLowerBoundN(const TVec<TItem>& ItemV, const int& StartN, const TItem& Item) {
+        const int Items = ItemV.Len();
+        if (StartN >= Items || !(ItemV[StartN] < Item)) { return StartN; }
+        // gallop until we overshoot, ItemV[PrevN] < Item always holds
+        int PrevN = StartN, Step = 1;
+        while (PrevN + Step < Items && ItemV[PrevN + Step] < Item) { PrevN += Step; Step *= 2; }
+        // binary search in (PrevN, MxN]
+        int MnN = PrevN + 1, MxN = TInt::GetMn(PrevN + Step, Items);
+        while (MnN < MxN) {
+            const int MidN = MnN + (MxN - MnN) / 2;
+            if (ItemV[MidN] < Item) { MnN = MidN + 1; } else { MxN = MidN; }
+        }
+        return MnN;
+    }
+};
+
 /////////////////////////////////////////////////
 /// Default Item Handler.
 /// Uses basic set operations defined on TVec and TItem.
@@ -202,11 +268,17 @@ public:
     /// Get item at given index (including child itemsets)
     const TItem& GetItem(const int& ItemN) const;
     /// Get items into vector
-    void GetItemV(TVec<TItem>& _ItemV);
+    void GetItemV(TVec<TItem>& _ItemV) const;
     /// Go over all children and working buffer and pass it to HandleItemV function
-    template <typename THandler> void GetItemV(THandler& Handler);
+    template <typename THandler> void GetItemV(THandler& Handler) const;
+    /// Get items that can intersect with the given sorted result items. Child vectors
+    /// whose [MinItem, MaxItem] range contains no result item are skipped and not loaded.
+    template <class TResItem> void GetIntrsItemV(const TVec<TResItem>& ResItemV,
+        const TGixMerger<TKey, TItem, TResItem>* Merger, TVec<TItem>& _ItemV) const;
     /// Delete specified item from this itemset
     void DelItem(const TItem& Item);
+    /// Delete a set of items at once
+    void DelItemV(const TVec<TItem>& DelItemV);
     /// Clear all items from this itemset
     void Clr();
 
@@ -217,6 +289,8 @@ public:
 
     /// Flag if itemset is merged
     bool IsMerged() const { return MergedP; }
+    /// Is itemset merged and are all child vectors in memory, so reading items does not change it
+    bool IsLoaded() const;
     /// Flag if itemset is dirty
     bool IsDirty() const { return DirtyP; }
     /// Tests if current itemset is full and subsequent item should be pushed to children
@@ -251,6 +325,12 @@ public:
     TFlt AvgLen;
     /// memory usage for gix
     TUInt64 MemUsed;
+    /// Number of item set reads served from cache
+    TUInt64 CacheHits;
+    /// Number of item set reads which had to load from disk
+    TUInt64 CacheMisses;
+    /// Number of item sets evicted from cache to make room for others
+    TUInt64 CacheEvictions;
 
 public:
 
@@ -268,13 +348,19 @@ public:
             NewStats.CacheDirtyLoadedPerc = (CacheDirty * CacheDirtyLoadedPerc + Stats.CacheDirty * Stats.CacheDirtyLoadedPerc) / NewStats.CacheDirty;
         }
         NewStats.MemUsed = MemUsed + Stats.MemUsed;
+        NewStats.CacheHits = CacheHits + Stats.CacheHits;
+        NewStats.CacheMisses = CacheMisses + Stats.CacheMisses;
+        NewStats.CacheEvictions = CacheEvictions + Stats.CacheEvictions;
         // replace this stats with summed up ones
         *this = NewStats;
     }
 };
 
 /////////////////////////////////////////////////
-// General Inverted Index
+// General Inverted Index.
+// Reads through GetItemV and expression evaluation hold ItemSetLock, a
+// std::shared_mutex, for reading, while writes and flushes hold it exclusively,
+// so queries can be evaluated from several threads at the same time.
 template <class TKey, class TItem>
 class TGix {
 private:
@@ -296,8 +382,11 @@ private:
     /// ItemHandler used for packing item vectors in item sets
     const TGixItemHandler<TKey, TItem>* ItemHandler;
 
-    /// Item set cache
-    mutable TCache<TBlobPt, PGixItemSet> ItemSetCache;
+    /// Number of item set cache shards (fewer for small caches)
+    static const int GixCacheShards = 8;
+    /// Item set cache, segmented so that scans over rarely used keys do not
+    /// push out the frequently used ones, and sharded for concurrent readers
+    mutable TSegCache<TBlobPt, PGixItemSet> ItemSetCache;
     /// Disk storage (blob base)
     PBlobBs ItemSetBlobBs;
 
@@ -321,6 +410,10 @@ private:
     /// Internal member for holding statistics
     mutable TGixStats Stats;
 
+    /// Guards key map, item sets and their cache. Reads of loaded item sets share it,
+    /// loading and merging item sets and all changes to the index take it exclusively.
+    mutable std::shared_mutex ItemSetLock;
+
 private:
     /// Returns pointer to this object. Used in cache call-backs
     void* GetVoidThis() const { return (void*)this; }
@@ -335,14 +428,16 @@ private:
     /// Get handle to the merger
     const TGixItemHandler<TKey, TItem>* GetItemHandler() const { return ItemHandler; }
 
+    /// Serialize child vector, compressed when item handler requests it for the key
+    void SaveChildVector(const TKey& Key, const TVec<TItem>& Data, TSOut& SOut) const;
     /// Load child vector for given blob pointer from disk
     void GetChildVector(const TBlobPt& Pt, TVec<TItem>& Dest) const;
     /// Store child vectors to disk and get back pointer to where it was stored.
-    TBlobPt StoreChildVector(const TBlobPt& ExistingKeyId, const TVec<TItem>& Data) const;
+    TBlobPt StoreChildVector(const TKey& Key, const TBlobPt& ExistingKeyId, const TVec<TItem>& Data) const;
     /// Delete child vectors from cache and disk
     void DeleteChildVector(const TBlobPt& KeyId) const;
     /// For enlisting new child vectors into blob
-    TBlobPt EnlistChildVector(const TVec<TItem>& Data) const;
+    TBlobPt EnlistChildVector(const TKey& Key, const TVec<TItem>& Data) const;
 
     /// This method refreshes gix statistics
     void RefreshStats() const;
@@ -379,17 +474,20 @@ public:
     /// sort keys
     void SortKeys() { KeyIdH.SortByKey(true); }
 
-    /// get item set for given key
+    /// get item set for given key, caller must hold ItemSetLock exclusively
     PGixItemSet GetItemSet(const TKey& Key) const;
-    /// get item set for given BLOB pointer
+    /// get item set for given BLOB pointer, caller must hold ItemSetLock exclusively
     PGixItemSet GetItemSet(const TBlobPt& Pt) const;
+    /// Call Fun with merged item set of the key. Loaded item sets are read by concurrent
+    /// readers at the same time, others are loaded and merged first under exclusive lock.
+    template <class TFun> void ReadItemSet(const TKey& Key, const TFun& Fun) const;
     /// Get items for given key
     void GetItemV(const TKey& Key, TVec<TItem>& ItemV) const;
     /// Go over all children and working buffer and pass it to HandleItemV function
     template <typename THandler> void GetItemV(const TKey& Key, THandler& Handler) const;
-    /// for storing item sets from cache to blob
+    /// for storing item sets from cache to blob, caller must hold ItemSetLock exclusively
     TBlobPt StoreItemSet(const TBlobPt& KeyId);
-    /// for deleting itemset from cache and blob
+    /// for deleting itemset from cache and blob, caller must hold ItemSetLock exclusively
     void DeleteItemSet(const TKey& Key);
     /// For enlisting new itemsets into blob
     TBlobPt EnlistItemSet(const PGixItemSet& ItemSet) const;
@@ -400,12 +498,16 @@ public:
     void AddItemV(const TKey& Key, const TVec<TItem>& ItemV);
     // delete one item
     void DelItem(const TKey& Key, const TItem& Item);
+    /// delete items under the same key, loading the item set only once
+    void DelItemV(const TKey& Key, const TVec<TItem>& ItemV);
     /// clears items
     void Clr(const TKey& Key);
     /// flush all data from cache to disk
-    void Flush() { ItemSetCache.FlushAndClr(); }
+    void Flush() { std::unique_lock<std::shared_mutex> Lock(ItemSetLock); ItemSetCache.FlushAndClr(); }
     /// flush a portion of data from cache to disk
     int PartialFlush(int WndInMsec = 500);
+    /// save all changed item sets and the key map, keeping the cache loaded
+    void Save();
 
     /// get first key id
     int FFirstKeyId() const { return KeyIdH.FFirstKeyId(); }
@@ -472,6 +574,9 @@ public:
 
     /// Initialize vector of items for given key.
     virtual void Def(const TKey& Key, TVec<TItem>& MainV, TVec<TResItem>& ResV) const = 0;
+    /// Get result item with the same position in the ordering as the given item. Used to
+    /// compare child vector ranges with results when intersecting. Returns false if not supported.
+    virtual bool GetResItem(const TItem& Item, TResItem& ResItem) const { return false; }
 
     /// Memory footprint
     virtual uint64 GetMemUsed() const = 0;
@@ -487,6 +592,7 @@ public:
     void Intrs(TVec<TResItem>& MainV, const TVec<TResItem>& JoinV) const { MainV.Intrs(JoinV); }
     void Minus(const TVec<TResItem>& MainV, const TVec<TResItem>& JoinV, TVec<TResItem>& ResV) const { MainV.Diff(JoinV, ResV); }
     void Def(const TKey& Key, TVec<TItem>& MainV, TVec<TResItem>& ResV) const { ResV.MoveFrom(MainV); }
+    bool GetResItem(const TItem& Item, TResItem& ResItem) const { ResItem = Item; return true; }
 
     uint64 GetMemUsed() const { return sizeof(TGixDefMerger<TKey, TItem, TResItem>); }
 };
@@ -527,6 +633,8 @@ private:
     void PutAnd(const PGixExpItem& _LeftExpItem, const PGixExpItem& _RightExpItem);
     /// Convert expression item to OR
     void PutOr(const PGixExpItem& _LeftExpItem, const PGixExpItem& _RightExpItem);
+    /// Intersect results with items of the key, loading only child vectors that can match
+    void EvalIntrs(const PGix& Gix, TVec<TResItem>& ResItemV, const TGixMerger<TKey, TItem, TResItem>* Merger);
 
     TGixExpItem(const TGixExpType& _ExpType, const PGixExpItem& _LeftExpItem,
         const PGixExpItem& _RightExpItem) : ExpType(_ExpType),
@@ -558,6 +666,9 @@ public:
     static PGixExpItem NewAndV(const TVec<TKey>& KeyV);
     /// Create an OR tree from given array of leaf items
     static PGixExpItem NewOrV(const TVec<TKey>& KeyV);
+    /// Create an AND chain from given array of leaf items, ordered from the rarest
+    /// to the most frequent key, so intersections can skip child vectors of frequent keys
+    static PGixExpItem NewAndV(const PGix& Gix, const TVec<TKey>& KeyV);
 
     /// Is current item empty?
     bool IsEmpty() const { return (ExpType == getEmpty); }
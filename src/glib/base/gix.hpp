@@ -99,7 +99,7 @@ void TGixItemSet<TKey, TItem>::PushWorkBufferToChildren() {
         TVec<TItem> SplitItemV;
         ItemV.GetSubValV(0, SplitLen - 1, SplitItemV);
         // create the child info for the vector and also push the vector to a blob
-        TChildInfo ChildInfo(SplitItemV[0], SplitItemV.Last(), SplitLen, Gix->EnlistChildVector(SplitItemV));
+        TChildInfo ChildInfo(SplitItemV[0], SplitItemV.Last(), SplitLen, Gix->EnlistChildVector(ItemSetKey, SplitItemV));
         ChildInfo.LoadedP = false;
         ChildInfo.DirtyP = false;
         ChildInfoV.Add(ChildInfo);
@@ -275,7 +275,7 @@ void TGixItemSet<TKey, TItem>::Save(TMOut& SOut) {
     // save child vectors separately
     for (int ChildN = 0; ChildN < ChildInfoV.Len(); ChildN++) {
         if (ChildInfoV[ChildN].DirtyP && ChildInfoV[ChildN].LoadedP) {
-            ChildInfoV[ChildN].Pt = Gix->StoreChildVector(ChildInfoV[ChildN].Pt, ChildV[ChildN]);
+            ChildInfoV[ChildN].Pt = Gix->StoreChildVector(ItemSetKey, ChildInfoV[ChildN].Pt, ChildV[ChildN]);
             ChildInfoV[ChildN].DirtyP = false;
         }
     }
@@ -382,7 +382,7 @@ const TItem& TGixItemSet<TKey, TItem>::GetItem(const int& ItemN) const {
 }
 
 template <class TKey, class TItem>
-void TGixItemSet<TKey, TItem>::GetItemV(TVec<TItem>& _ItemV) {
+void TGixItemSet<TKey, TItem>::GetItemV(TVec<TItem>& _ItemV) const {
     // reserve place for all the elements
     _ItemV.Gen(TotalCnt, 0);
     // load items
@@ -398,7 +398,7 @@ void TGixItemSet<TKey, TItem>::GetItemV(TVec<TItem>& _ItemV) {
 
 template <class TKey, class TItem>
 template <typename THandler>
-void TGixItemSet<TKey, TItem>::GetItemV(THandler& Handler) {
+void TGixItemSet<TKey, TItem>::GetItemV(THandler& Handler) const {
     if (ChildInfoV.Len() > 0) {
         // collect data from child itemsets
         LoadChildVectors();
@@ -409,6 +409,29 @@ void TGixItemSet<TKey, TItem>::GetItemV(THandler& Handler) {
     Handler(ItemV);
 }
 
+template <class TKey, class TItem>
+template <class TResItem>
+void TGixItemSet<TKey, TItem>::GetIntrsItemV(const TVec<TResItem>& ResItemV,
+        const TGixMerger<TKey, TItem, TResItem>* Merger, TVec<TItem>& _ItemV) const {
+
+    _ItemV.Clr();
+    int ResItemN = 0; TResItem MinResItem, MaxResItem;
+    for (int ChildN = 0; ChildN < ChildInfoV.Len(); ChildN++) {
+        // no more results to match, remaining child vectors are not needed
+        if (ResItemN >= ResItemV.Len()) { break; }
+        const TChildInfo& ChildInfo = ChildInfoV[ChildN];
+        if (Merger->GetResItem(ChildInfo.MinItem, MinResItem) && Merger->GetResItem(ChildInfo.MaxItem, MaxResItem)) {
+            // skip results smaller than the child vector
+            ResItemN = TGixGallop::GetLowerBoundN(ResItemV, ResItemN, MinResItem);
+            // skip child vector if no result falls into its range
+            if (ResItemN >= ResItemV.Len() || MaxResItem < ResItemV[ResItemN]) { continue; }
+        }
+        LoadChildVector(ChildN);
+        _ItemV.AddV(ChildV[ChildN]);
+    }
+    _ItemV.AddV(ItemV);
+}
+
 template <class TKey, class TItem>
 void TGixItemSet<TKey, TItem>::DelItem(const TItem& Item) {
     if (IsFull()) {
@@ -431,6 +454,13 @@ void TGixItemSet<TKey, TItem>::DelItem(const TItem& Item) {
     TotalCnt++;
 }
 
+template <class TKey, class TItem>
+void TGixItemSet<TKey, TItem>::DelItemV(const TVec<TItem>& DelItemV) {
+    for (int i = 0; i < DelItemV.Len(); i++) {
+        DelItem(DelItemV[i]);
+    }
+}
+
 template <class TKey, class TItem>
 void TGixItemSet<TKey, TItem>::Clr() {
     const int OldSize = GetMemUsed();
@@ -513,6 +543,15 @@ void TGixItemSet<TKey, TItem>::DefLocal() {
     }
 }
 
+template <class TKey, class TItem>
+bool TGixItemSet<TKey, TItem>::IsLoaded() const {
+    if (!MergedP) { return false; }
+    for (int ChildN = 0; ChildN < ChildInfoV.Len(); ChildN++) {
+        if (!ChildInfoV[ChildN].LoadedP) { return false; }
+    }
+    return true;
+}
+
 template <class TKey, class TItem>
 double TGixItemSet<TKey, TItem>::GetLoadedPerc() const {
     int LoadedCount = 0;
@@ -573,21 +612,48 @@ TBlobPt TGix<TKey, TItem>::GetKeyId(const TKey& Key) const {
     return TBlobPt();
 }
 
+template <class TKey, class TItem>
+void TGix<TKey, TItem>::SaveChildVector(const TKey& Key, const TVec<TItem>& Data, TSOut& SOut) const {
+    if (ItemHandler->IsCompress(Key)) {
+        TMem Mem;
+        if (ItemHandler->Encode(Data, Mem)) {
+            // uncompressed vectors start with their (non-negative) capacity,
+            // so -1 marks compressed vector
+            SOut.Save(-1);
+            SOut.Save(Data.Len());
+            Mem.Save(SOut);
+            return;
+        }
+    }
+    Data.Save(SOut);
+}
+
 template <class TKey, class TItem>
 void TGix<TKey, TItem>::GetChildVector(const TBlobPt& KeyId, TVec<TItem>& Dest) const {
     if (KeyId.Empty()) { return; }
     PSIn ItemSetSIn = ItemSetBlobBs->GetBlob(KeyId);
-    Dest.Load(*ItemSetSIn);
+    int MxVals; ItemSetSIn->Load(MxVals);
+    if (MxVals == -1) {
+        // compressed vector
+        int Vals; ItemSetSIn->Load(Vals);
+        TMem Mem(*ItemSetSIn);
+        ItemHandler->Decode(Mem, Vals, Dest);
+        EAssertR(Dest.Len() == Vals, "Corrupted compressed child vector");
+    } else {
+        // same as TVec::Load, we already consumed the capacity
+        int Vals; ItemSetSIn->Load(Vals);
+        Dest.Gen(Vals);
+        for (int ValN = 0; ValN < Vals; ValN++) { Dest[ValN] = TItem(*ItemSetSIn); }
+    }
 }
 
 template <class TKey, class TItem>
-TBlobPt TGix<TKey, TItem>::StoreChildVector(const TBlobPt& ExistingKeyId, const TVec<TItem>& Data) const {
+TBlobPt TGix<TKey, TItem>::StoreChildVector(const TKey& Key, const TBlobPt& ExistingKeyId, const TVec<TItem>& Data) const {
     // check if we are allowed to write
     AssertReadOnly();
     // store the current version to the blob
     TMOut MOut;
-    //Data.SaveMemCpy(MOut);
-    Data.Save(MOut);
+    SaveChildVector(Key, Data, MOut);
     int ReleasedSize;
     return ItemSetBlobBs->PutBlob(ExistingKeyId, MOut.GetSIn(), ReleasedSize);
 }
@@ -599,16 +665,18 @@ void TGix<TKey, TItem>::DeleteChildVector(const TBlobPt& KeyId) const {
 }
 
 template <class TKey, class TItem>
-TBlobPt TGix<TKey, TItem>::EnlistChildVector(const TVec<TItem>& Data) const {
+TBlobPt TGix<TKey, TItem>::EnlistChildVector(const TKey& Key, const TVec<TItem>& Data) const {
     AssertReadOnly(); // check if we are allowed to write
     TMOut MOut;
-    Data.Save(MOut);
+    SaveChildVector(Key, Data, MOut);
     TBlobPt res = ItemSetBlobBs->PutBlob(MOut.GetSIn());
     return res;
 }
 
 template <class TKey, class TItem>
 void TGix<TKey, TItem>::RefreshStats() const {
+    // copies item set pointers from the cache
+    std::unique_lock<std::shared_mutex> Lock(ItemSetLock);
     Stats.CacheAll = 0;
     Stats.CacheDirty = 0;
     Stats.CacheAllLoadedPerc = 0;
@@ -616,9 +684,13 @@ void TGix<TKey, TItem>::RefreshStats() const {
     Stats.AvgLen = 0;
 
     Stats.MemUsed = this->GetMemUsed();
-    TBlobPt BlobPt; PGixItemSet ItemSet;
-    void* KeyDatP = ItemSetCache.FFirstKeyDat();
-    while (ItemSetCache.FNextKeyDat(KeyDatP, BlobPt, ItemSet)) {
+    Stats.CacheHits = ItemSetCache.GetHits();
+    Stats.CacheMisses = ItemSetCache.GetMisses();
+    Stats.CacheEvictions = ItemSetCache.GetEvictions();
+    TVec<TPair<TBlobPt, PGixItemSet> > KeyItemSetV;
+    ItemSetCache.GetKeyDatV(KeyItemSetV);
+    for (int KeyN = 0; KeyN < KeyItemSetV.Len(); KeyN++) {
+        const PGixItemSet& ItemSet = KeyItemSetV[KeyN].Val2;
         Stats.CacheAll++;
         const double LoadedPerc = ItemSet->GetLoadedPerc();
         Stats.CacheAllLoadedPerc += LoadedPerc;
@@ -641,7 +713,7 @@ template <class TKey, class TItem>
 TGix<TKey, TItem>::TGix(const TStr& Nm, const TStr& FPath, const TFAccess& _Access,
     const TGixItemHandler<TKey, TItem>* _ItemHandler, const int64& CacheSize, const int _SplitLen,
     const bool _FirstChildBeUnfilledP, const int _SplitLenMin, const int _SplitLenMax) :
-        Access(_Access), ItemHandler(_ItemHandler), ItemSetCache(CacheSize, 1000000, GetVoidThis()),
+        Access(_Access), ItemHandler(_ItemHandler), ItemSetCache(CacheSize, GixCacheShards, GetVoidThis()),
         SplitLen(_SplitLen), SplitLenMin(_SplitLenMin), SplitLenMax(_SplitLenMax),
         FirstChildBeUnfilledP(_FirstChildBeUnfilledP) {
 
@@ -700,30 +772,57 @@ TPt<TGixItemSet<TKey, TItem> > TGix<TKey, TItem>::GetItemSet(const TBlobPt& KeyI
 }
 
 template <class TKey, class TItem>
-void TGix<TKey, TItem>::GetItemV(const TKey& Key, TVec<TItem>& ItemV) const {
-    PGixItemSet ItemSet = GetItemSet(Key);
+template <class TFun>
+void TGix<TKey, TItem>::ReadItemSet(const TKey& Key, const TFun& Fun) const {
+    // true when the cache already counted this read as a hit
+    bool HitP = false;
+    {
+        std::shared_lock<std::shared_mutex> Lock(ItemSetLock);
+        const TBlobPt KeyId = GetKeyId(Key);
+        if (KeyId.Empty()) {
+            // no items for the key
+            Fun(TGixItemSet<TKey, TItem>(TKey(), this));
+            return;
+        }
+        // cached item set is not copied, so readers do not touch its reference count
+        const PGixItemSet* ItemSetPt = ItemSetCache.GetDatPt(KeyId);
+        if (ItemSetPt != NULL && (*ItemSetPt)->IsLoaded()) {
+            Fun(**ItemSetPt);
+            return;
+        }
+        HitP = (ItemSetPt != NULL);
+    }
+    // item set has to be loaded or merged, which changes it
+    std::unique_lock<std::shared_mutex> Lock(ItemSetLock);
+    PGixItemSet ItemSet;
+    if (!HitP || !ItemSetCache.Peek(GetKeyId(Key), ItemSet)) {
+        ItemSet = GetItemSet(Key);
+    }
     // first call Def() so that we can process some pending actions (like deletes) first
     ItemSet->Def();
-    // get the items for the key
-    return ItemSet->GetItemV(ItemV);
+    Fun(*ItemSet);
+}
+
+template <class TKey, class TItem>
+void TGix<TKey, TItem>::GetItemV(const TKey& Key, TVec<TItem>& ItemV) const {
+    ReadItemSet(Key, [&ItemV](const TGixItemSet<TKey, TItem>& ItemSet) {
+        ItemSet.GetItemV(ItemV); });
 }
 
 template <class TKey, class TItem>
 template <typename THandler>
 void TGix<TKey, TItem>::GetItemV(const TKey& Key, THandler& Handler) const {
-    PGixItemSet ItemSet = GetItemSet(Key);
-    // first call Def() so that we can process some pending actions (like deletes) first
-    ItemSet->Def();
-    // get the items for the key
-    return ItemSet->GetItemV(Handler);
+    ReadItemSet(Key, [&Handler](const TGixItemSet<TKey, TItem>& ItemSet) {
+        ItemSet.GetItemV(Handler); });
 }
 
 template <class TKey, class TItem>
 TBlobPt TGix<TKey, TItem>::StoreItemSet(const TBlobPt& KeyId) {
     AssertReadOnly(); // check if we are allowed to write
     // get the pointer to the item set
+    // not a read, so it does not count towards cache statistics
     PGixItemSet ItemSet;
-    EAssert(ItemSetCache.Get(KeyId, ItemSet));
+    EAssert(ItemSetCache.Peek(KeyId, ItemSet));
     ItemSet->Def();
     if (ItemSet->Empty()) {
         // itemset is empty after all deletes were processed => remove it
@@ -766,6 +865,7 @@ TBlobPt TGix<TKey, TItem>::EnlistItemSet(const PGixItemSet& ItemSet) const {
 template <class TKey, class TItem>
 void TGix<TKey, TItem>::AddItem(const TKey& Key, const TItem& Item) {
     AssertReadOnly(); // check if we are allowed to write
+    std::unique_lock<std::shared_mutex> Lock(ItemSetLock);
     if (IsKey(Key)) {
         // get the key handle
         TBlobPt KeyId = KeyIdH.GetDat(Key);
@@ -787,6 +887,7 @@ void TGix<TKey, TItem>::AddItem(const TKey& Key, const TItem& Item) {
 template <class TKey, class TItem>
 void TGix<TKey, TItem>::AddItemV(const TKey& Key, const TVec<TItem>& ItemV) {
     AssertReadOnly(); // check if we are allowed to write
+    std::unique_lock<std::shared_mutex> Lock(ItemSetLock);
     if (IsKey(Key)) {
         // get the key handle
         TBlobPt KeyId = KeyIdH.GetDat(Key);
@@ -796,9 +897,13 @@ void TGix<TKey, TItem>::AddItemV(const TKey& Key, const TVec<TItem>& ItemV) {
     } else {
         // we don't have this key, create a new itemset and add new item immidiatelly
         PGixItemSet ItemSet = TGixItemSet<TKey, TItem>::New(Key, this);
-        ItemSet->AddItemV(ItemV);
+        for (int ItemN = 0; ItemN < ItemV.Len(); ItemN++) {
+            // first item also reports the size of the new itemset, same as in AddItem
+            ItemSet->AddItem(ItemV[ItemN], ItemN > 0);
+        }
         TBlobPt KeyId = EnlistItemSet(ItemSet); // now store this itemset to disk
         KeyIdH.AddDat(Key, KeyId); // remember the new key and its Id
+        ItemSetCache.Put(KeyId, ItemSet); // add it to cache
     }
     // check if we have to drop anything from the cache
     RefreshMemUsed();
@@ -807,6 +912,7 @@ void TGix<TKey, TItem>::AddItemV(const TKey& Key, const TVec<TItem>& ItemV) {
 template <class TKey, class TItem>
 void TGix<TKey, TItem>::DelItem(const TKey& Key, const TItem& Item) {
     AssertReadOnly(); // check if we are allowed to write
+    std::unique_lock<std::shared_mutex> Lock(ItemSetLock);
     if (IsKey(Key)) { // check if this key exists
         // load the current item set
         PGixItemSet ItemSet = GetItemSet(Key);
@@ -818,9 +924,25 @@ void TGix<TKey, TItem>::DelItem(const TKey& Key, const TItem& Item) {
     }
 }
 
+template <class TKey, class TItem>
+void TGix<TKey, TItem>::DelItemV(const TKey& Key, const TVec<TItem>& ItemV) {
+    AssertReadOnly(); // check if we are allowed to write
+    std::unique_lock<std::shared_mutex> Lock(ItemSetLock);
+    if (IsKey(Key)) { // check if this key exists
+        // load the current item set
+        PGixItemSet ItemSet = GetItemSet(Key);
+        // clear the items from the ItemSet
+        ItemSet->DelItemV(ItemV);
+        if (ItemSet->Empty()) {
+            DeleteItemSet(Key);
+        }
+    }
+}
+
 template <class TKey, class TItem>
 void TGix<TKey, TItem>::Clr(const TKey& Key) {
     AssertReadOnly(); // check if we are allowed to write
+    std::unique_lock<std::shared_mutex> Lock(ItemSetLock);
     if (IsKey(Key)) { // check if this key exists
         // load the current item set
         PGixItemSet ItemSet = GetItemSet(Key);
@@ -831,17 +953,18 @@ void TGix<TKey, TItem>::Clr(const TKey& Key) {
 
 template <class TKey, class TItem>
 int TGix<TKey, TItem>::PartialFlush(int WndInMsec) {
-    TBlobPt BlobPt;
-    PGixItemSet ItemSet;
-    THashSet<TBlobPt> BlobToDelH;
+    std::unique_lock<std::shared_mutex> Lock(ItemSetLock);
     int Changes = 0;
-    void* KeyDatP;
 
     TTmStopWatch sw(true);
 
-    KeyDatP = ItemSetCache.FLastKeyDat();
-    while (ItemSetCache.FPrevKeyDat(KeyDatP, BlobPt, ItemSet)) {
+    // start with item sets which are first in line for eviction
+    TVec<TPair<TBlobPt, PGixItemSet> > KeyItemSetV;
+    ItemSetCache.GetKeyDatV(KeyItemSetV);
+    for (int KeyN = 0; KeyN < KeyItemSetV.Len(); KeyN++) {
         if (sw.GetMSecInt() > WndInMsec) break;
+        const TBlobPt& BlobPt = KeyItemSetV[KeyN].Val1;
+        const PGixItemSet& ItemSet = KeyItemSetV[KeyN].Val2;
         if (ItemSet->IsDirty()) {
             TBlobPt NewBlobPt = StoreItemSet(BlobPt);
             if (NewBlobPt.Empty()) { // if itemset is empty, we get NULL pointer
@@ -856,6 +979,17 @@ int TGix<TKey, TItem>::PartialFlush(int WndInMsec) {
     return Changes;
 }
 
+template <class TKey, class TItem>
+void TGix<TKey, TItem>::Save() {
+    if ((Access == faCreate) || (Access == faUpdate)) {
+        // store all dirty item sets, this also updates their keys
+        PartialFlush(TInt::Mx);
+        std::unique_lock<std::shared_mutex> Lock(ItemSetLock);
+        TFOut FOut(GixFNm); KeyIdH.Save(FOut);
+        ItemSetBlobBs->Flush();
+    }
+}
+
 template <class TKey, class TItem>
 int64 TGix<TKey, TItem>::GetMemUsed() const {
     int64 res = sizeof(TCRef);
@@ -881,11 +1015,10 @@ void TGix<TKey, TItem>::RefreshMemUsed() {
         const bool ReportP = CacheResetThreshold > (uint64)(TInt::Giga);
         if (ReportP) { printf("Cache clean-up [%s] ... ", TUInt64::GetMegaStr(NewCacheSizeInc).CStr()); }
         // pack all the item sets
-        TBlobPt BlobPt;
-        PGixItemSet ItemSet;
-        void* KeyDatP = ItemSetCache.FFirstKeyDat();
-        while (ItemSetCache.FNextKeyDat(KeyDatP, BlobPt, ItemSet)) {
-            ItemSet->DefLocal();
+        TVec<TPair<TBlobPt, PGixItemSet> > KeyItemSetV;
+        ItemSetCache.GetKeyDatV(KeyItemSetV);
+        for (int KeyN = 0; KeyN < KeyItemSetV.Len(); KeyN++) {
+            KeyItemSetV[KeyN].Val2->DefLocal();
         }
         // clean-up cache
         CacheFullP = ItemSetCache.RefreshMemUsed();
@@ -949,6 +1082,9 @@ void TGix<TKey, TItem>::PrintStats() {
     printf(".... gix cache stats - all=%d dirty=%d, loaded_perc=%f dirty_loaded_perc=%f, avg_len=%f, mem_used=%d \n",
         Stats.CacheAll, Stats.CacheDirty, Stats.CacheAllLoadedPerc, Stats.CacheDirtyLoadedPerc,
         Stats.AvgLen, Stats.MemUsed);
+    printf(".... gix cache hits=%s misses=%s evictions=%s\n",
+        TUInt64::GetStr(Stats.CacheHits).CStr(), TUInt64::GetStr(Stats.CacheMisses).CStr(),
+        TUInt64::GetStr(Stats.CacheEvictions).CStr());
     const TBlobBsStats& blob_stats = ItemSetBlobBs->GetStats();
     printf(".... gix blob stats - puts=%u puts_new=%u gets=%u dels=%u size_chngs=%u avg_len_get=%f avg_len_put=%f avg_len_put_new=%f\n",
         blob_stats.Puts, blob_stats.PutsNew, blob_stats.Gets,
@@ -1054,6 +1190,45 @@ TPt<TGixExpItem<TKey, TItem, TResItem> > TGixExpItem<TKey, TItem, TResItem>::New
     return NewOrV(ExpItemV);
 }
 
+template <class TKey, class TItem, class TResItem>
+TPt<TGixExpItem<TKey, TItem, TResItem> > TGixExpItem<TKey, TItem, TResItem>::NewAndV(
+        const TPt<TGix<TKey, TItem> >& Gix, const TVec<TKey>& KeyV) {
+
+    // return empty item if no key is given
+    if (KeyV.Empty()) { return TGixExpItem<TKey, TItem, TResItem>::NewEmpty(); }
+    // sort keys by the number of their items
+    TIntKdV ItemsKeyNV(KeyV.Len(), 0);
+    for (int KeyN = 0; KeyN < KeyV.Len(); KeyN++) {
+        int Items = 0;
+        Gix->ReadItemSet(KeyV[KeyN], [&Items](const TGixItemSet<TKey, TItem>& ItemSet) {
+            Items = ItemSet.GetItems(); });
+        // intersection with missing key is empty, no need to look further
+        if (Items == 0) { return TGixExpItem<TKey, TItem, TResItem>::NewItem(KeyV[KeyN]); }
+        ItemsKeyNV.Add(TIntKd(Items, KeyN));
+    }
+    ItemsKeyNV.Sort();
+    // make left-deep chain, so each right subtree is a key
+    TPt<TGixExpItem<TKey, TItem, TResItem> > TopExpItem = NewItem(KeyV[ItemsKeyNV[0].Dat]);
+    for (int KeyN = 1; KeyN < ItemsKeyNV.Len(); KeyN++) {
+        TopExpItem = NewAnd(TopExpItem, NewItem(KeyV[ItemsKeyNV[KeyN].Dat]));
+    }
+    return TopExpItem;
+}
+
+template <class TKey, class TItem, class TResItem>
+void TGixExpItem<TKey, TItem, TResItem>::EvalIntrs(const TPt<TGix<TKey, TItem> >& Gix,
+        TVec<TResItem>& ResItemV, const TGixMerger<TKey, TItem, TResItem>* Merger) {
+
+    // nothing to intersect with
+    if (ResItemV.Empty()) { return; }
+    // get only items from child vectors overlapping with results
+    TVec<TItem> ItemV;
+    Gix->ReadItemSet(Key, [&ResItemV, Merger, &ItemV](const TGixItemSet<TKey, TItem>& ItemSet) {
+        if (!ItemSet.Empty()) { ItemSet.GetIntrsItemV(ResItemV, Merger, ItemV); } });
+    TVec<TResItem> KeyItemV; Merger->Def(Key, ItemV, KeyItemV);
+    Merger->Intrs(ResItemV, KeyItemV);
+}
+
 template <class TKey, class TItem, class TResItem>
 bool TGixExpItem<TKey, TItem, TResItem>::Eval(const TPt<TGix<TKey, TItem> >& Gix,
     TVec<TResItem>& ResItemV, const TGixMerger<TKey, TItem, TResItem>* Merger) {
@@ -1083,6 +1258,11 @@ bool TGixExpItem<TKey, TItem, TResItem>::Eval(const TPt<TGix<TKey, TItem> >& Gix
         EAssert(!LeftExpItem.Empty() && !RightExpItem.Empty());
         TVec<TResItem> RightItemV;
         const bool NotLeft = LeftExpItem->Eval(Gix, ResItemV, Merger);
+        // when right side is a key, we only need its items that can match left side
+        if (!NotLeft && RightExpItem->GetExpType() == getKey) {
+            RightExpItem->EvalIntrs(Gix, ResItemV, Merger);
+            return false;
+        }
         const bool NotRight = RightExpItem->Eval(Gix, RightItemV, Merger);
         if (NotLeft && NotRight) {
             Merger->Union(ResItemV, RightItemV);
@@ -1099,12 +1279,11 @@ bool TGixExpItem<TKey, TItem, TResItem>::Eval(const TPt<TGix<TKey, TItem> >& Gix
         }
         return (NotLeft && NotRight);
     } else if (ExpType == getKey) {
-        PGixItemSet ItemSet = Gix->GetItemSet(Key);
-        if (!ItemSet.Empty()) {
-            ItemSet->Def();
-            TVec<TItem> ItemV; ItemSet->GetItemV(ItemV);
-            Merger->Def(ItemSet->GetKey(), ItemV, ResItemV);
-        }
+        TVec<TItem> ItemV; TKey ItemSetKey;
+        Gix->ReadItemSet(Key, [&ItemV, &ItemSetKey](const TGixItemSet<TKey, TItem>& ItemSet) {
+            ItemSet.GetItemV(ItemV);
+            ItemSetKey = ItemSet.GetKey(); });
+        Merger->Def(ItemSetKey, ItemV, ResItemV);
         return false;
     } else if (ExpType == getNot) {
         return !RightExpItem->Eval(Gix, ResItemV, Merger);
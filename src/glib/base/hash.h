@@ -1354,6 +1354,7 @@ public:
     TCache& operator=(const TCache&);
     int64 GetMemUsed() const;
     int64 GetMxMemUsed() const { return MxMemUsed; }
+    void PutMxMemUsed(const int64& _MxMemUsed) { MxMemUsed = _MxMemUsed; }
     bool RefreshMemUsed();
 
     void Put(const TKey& Key, const TDat& Dat);
@@ -1534,6 +1535,420 @@ bool TCache<TKey, TDat, THashFunc>::FPrevKeyDat(void*& KeyDatP, TKey& Key, TDat&
     }
 }
 
+/////////////////////////////////////////////////
+// Segmented-Cache
+/// Memory bounded cache, split into shards by key hash. Each shard is a segmented
+/// LRU: new entries enter the probation segment and move to the protected segment
+/// when they are read again. Entries are evicted from the probation segment first,
+/// so a scan which reads each key once cannot push out the working set held in the
+/// protected segment. Each shard has its own (reentrant) lock, so readers of keys
+/// from different shards do not wait for each other. Evicted entries are notified
+/// through TDat::OnDelFromCache, same as with TCache.
+template <class TKey, class TDat, class THashFunc = TDefaultHashFunc<TKey> >
+class TSegCache {
+private:
+    typedef TLstNd<TKey>* TKeyLN;
+
+    /// Cached data and its position in one of the segments
+    class TEntry {
+    public:
+        TDat Dat;
+        TKeyLN KeyLN;
+        int64 MemUsed;
+        bool ProtectedP;
+        TEntry(): KeyLN(NULL), MemUsed(0), ProtectedP(false) { }
+        /// Data is accounted for separately in MemUsed
+        uint64 GetMemUsed() const { return sizeof(TEntry); }
+    };
+
+    /// One shard of the cache
+    class TShard {
+    public:
+        /// Cached entries
+        THash<TKey, TEntry, THashFunc> KeyEntryH;
+        /// Probation segment, most recently used first
+        TLst<TKey> ProbationL;
+        /// Protected segment, most recently used first
+        TLst<TKey> ProtectedL;
+        /// Memory used by all entries and by protected entries
+        int64 CurMemUsed, ProtectedMemUsed;
+        /// Statistics
+        uint64 Hits, Misses, Evictions;
+        /// Guards the shard. Recursive, since OnDelFromCache may look the
+        /// evicted entry up again.
+        std::recursive_mutex Lock;
+        TShard(): CurMemUsed(0), ProtectedMemUsed(0), Hits(0), Misses(0), Evictions(0) { }
+    };
+
+    /// Holds shard lock during its lifetime
+    class TShardLock {
+    private:
+        std::lock_guard<std::recursive_mutex> Guard;
+    public:
+        TShardLock(TShard& Shard): Guard(Shard.Lock) { }
+    };
+
+    /// Minimal memory budget of a shard
+    static const int64 MnShardMemUsed = 1024 * 1024;
+
+    /// Memory budget for all shards
+    int64 MxMemUsed;
+    /// Share of shard budget for the protected segment
+    double ProtectedFrac;
+    /// Number of shards
+    int Shards;
+    /// Shards
+    TShard* ShardT;
+    /// Pointer passed to OnDelFromCache
+    void* RefToBs;
+
+    TShard& GetShard(const TKey& Key) const {
+        const int HashCd = THashFunc::GetPrimHashCd(Key);
+        return ShardT[((HashCd ^ (HashCd >> 16)) & 0x7fffffff) % Shards]; }
+    int64 GetShardMxMemUsed() const { return MxMemUsed / Shards; }
+    int64 GetEntryMemUsed(const TKey& Key, const TDat& Dat) const {
+        return int64(Key.GetMemUsed() + Dat->GetMemUsed()); }
+
+    /// Move entry to the front of the protected segment
+    void Protect(TShard& Shard, const TKey& Key, TEntry& Entry);
+    /// Move least recently used protected entries to probation while over budget
+    void Demote(TShard& Shard);
+    /// Evict entries until there is room for the given amount of memory
+    void Purge(TShard& Shard, const int64& MemToAdd);
+    /// Remove entry from the shard, optionally with eviction notification
+    void DelEntry(TShard& Shard, const TKey& Key, const bool& DoEventCall, const bool& EvictionP);
+
+    TSegCache(const TSegCache&);
+    TSegCache& operator=(const TSegCache&);
+
+public:
+    /// Create cache with given memory budget. The number of shards is reduced
+    /// so that each shard gets at least MnShardMemUsed of memory.
+    TSegCache(const int64& _MxMemUsed, const int& _Shards, void* _RefToBs,
+        const double& _ProtectedFrac = 0.8);
+    ~TSegCache() { delete[] ShardT; }
+
+    /// Memory used by the cache structures and cached entries
+    int64 GetMemUsed() const;
+    int64 GetMxMemUsed() const { return MxMemUsed; }
+    void PutMxMemUsed(const int64& _MxMemUsed) { MxMemUsed = _MxMemUsed; }
+    /// Measure memory of all the entries again and evict when over budget.
+    /// Returns true when anything had to be evicted.
+    bool RefreshMemUsed();
+
+    /// Add new entry to probation or replace data of existing one
+    void Put(const TKey& Key, const TDat& Dat);
+    /// Get entry and mark it as used, counts hits and misses
+    bool Get(const TKey& Key, TDat& Dat);
+    /// Get entry without affecting its position or statistics
+    bool Peek(const TKey& Key, TDat& Dat) const;
+    /// Get pointer to entry data and mark it as used, NULL when not cached. Data is not
+    /// copied, so readers can share it. The pointer is valid until the entry is replaced
+    /// or removed, which callers must prevent while using it. Only hits are counted;
+    /// callers fall back to Peek after a hit and to Get after a miss.
+    const TDat* GetDatPt(const TKey& Key);
+    void Del(const TKey& Key, const bool& DoEventCall = true);
+    void ChangeKey(const TKey& OldKey, const TKey& NewKey);
+    bool IsKey(const TKey& Key) const;
+    int Len() const;
+    int GetShards() const { return Shards; }
+    /// Call OnDelFromCache for all entries
+    void Flush();
+    void FlushAndClr();
+    /// All entries, from the first to the last candidate for eviction in each shard
+    void GetKeyDatV(TVec<TPair<TKey, TDat> >& KeyDatV) const;
+
+    /// Number of reads which found the entry
+    uint64 GetHits() const;
+    /// Number of reads which did not find the entry
+    uint64 GetMisses() const;
+    /// Number of entries removed to make room for others
+    uint64 GetEvictions() const;
+    /// Forget hit, miss and eviction counts
+    void ResetStats();
+
+    void PutRefToBs(void* _RefToBs) { RefToBs = _RefToBs; }
+    void* GetRefToBs() { return RefToBs; }
+};
+
+template <class TKey, class TDat, class THashFunc>
+TSegCache<TKey, TDat, THashFunc>::TSegCache(const int64& _MxMemUsed, const int& _Shards,
+        void* _RefToBs, const double& _ProtectedFrac): MxMemUsed(_MxMemUsed),
+        ProtectedFrac(_ProtectedFrac), Shards(TInt::GetMx(1, _Shards)), RefToBs(_RefToBs) {
+
+    while (Shards > 1 && MxMemUsed / Shards < MnShardMemUsed) { Shards /= 2; }
+    ShardT = new TShard[Shards];
+}
+
+template <class TKey, class TDat, class THashFunc>
+void TSegCache<TKey, TDat, THashFunc>::Protect(TShard& Shard, const TKey& Key, TEntry& Entry) {
+    if (Entry.ProtectedP) {
+        Shard.ProtectedL.PutFront(Entry.KeyLN);
+    } else {
+        Shard.ProbationL.Del(Entry.KeyLN);
+        Entry.KeyLN = Shard.ProtectedL.AddFront(Key);
+        Entry.ProtectedP = true;
+        Shard.ProtectedMemUsed += Entry.MemUsed;
+        Demote(Shard);
+    }
+}
+
+template <class TKey, class TDat, class THashFunc>
+void TSegCache<TKey, TDat, THashFunc>::Demote(TShard& Shard) {
+    const int64 MxProtectedMemUsed = int64(ProtectedFrac * double(GetShardMxMemUsed()));
+    // always keep the most recently protected entry
+    while (Shard.ProtectedL.Len() > 1 && Shard.ProtectedMemUsed > MxProtectedMemUsed) {
+        const TKey Key = Shard.ProtectedL.Last()->GetVal();
+        TEntry& Entry = Shard.KeyEntryH.GetDat(Key);
+        Shard.ProtectedL.DelLast();
+        Entry.KeyLN = Shard.ProbationL.AddFront(Key);
+        Entry.ProtectedP = false;
+        Shard.ProtectedMemUsed -= Entry.MemUsed;
+    }
+}
+
+template <class TKey, class TDat, class THashFunc>
+void TSegCache<TKey, TDat, THashFunc>::Purge(TShard& Shard, const int64& MemToAdd) {
+    const int64 ShardMxMemUsed = GetShardMxMemUsed();
+    while (!Shard.KeyEntryH.Empty() && Shard.CurMemUsed + MemToAdd > ShardMxMemUsed) {
+        const TKey Key = Shard.ProbationL.Empty() ?
+            Shard.ProtectedL.Last()->GetVal() : Shard.ProbationL.Last()->GetVal();
+        DelEntry(Shard, Key, true, true);
+    }
+}
+
+template <class TKey, class TDat, class THashFunc>
+void TSegCache<TKey, TDat, THashFunc>::DelEntry(TShard& Shard, const TKey& Key,
+        const bool& DoEventCall, const bool& EvictionP) {
+
+    // event call can store the data and look it up in the cache, so it is still there
+    if (DoEventCall) {
+        TDat Dat = Shard.KeyEntryH.GetDat(Key).Dat;
+        Dat->OnDelFromCache(Key, RefToBs);
+    }
+    const int KeyId = Shard.KeyEntryH.GetKeyId(Key);
+    if (KeyId == -1) { return; }
+    TEntry& Entry = Shard.KeyEntryH[KeyId];
+    if (Entry.ProtectedP) {
+        Shard.ProtectedL.Del(Entry.KeyLN);
+        Shard.ProtectedMemUsed -= Entry.MemUsed;
+    } else {
+        Shard.ProbationL.Del(Entry.KeyLN);
+    }
+    Shard.CurMemUsed -= Entry.MemUsed;
+    Shard.KeyEntryH.DelKeyId(KeyId);
+    if (EvictionP) { Shard.Evictions++; }
+}
+
+template <class TKey, class TDat, class THashFunc>
+int64 TSegCache<TKey, TDat, THashFunc>::GetMemUsed() const {
+    int64 MemUsed = sizeof(TSegCache);
+    for (int ShardN = 0; ShardN < Shards; ShardN++) {
+        TShard& Shard = ShardT[ShardN]; TShardLock Lock(Shard);
+        MemUsed += sizeof(TShard) +
+            TMemUtils::GetExtraContainerSizeShallow(Shard.KeyEntryH) +
+            TMemUtils::GetExtraMemberSize(Shard.ProbationL) +
+            TMemUtils::GetExtraMemberSize(Shard.ProtectedL) +
+            Shard.CurMemUsed;
+    }
+    return MemUsed;
+}
+
+template <class TKey, class TDat, class THashFunc>
+bool TSegCache<TKey, TDat, THashFunc>::RefreshMemUsed() {
+    bool PurgedP = false;
+    for (int ShardN = 0; ShardN < Shards; ShardN++) {
+        TShard& Shard = ShardT[ShardN]; TShardLock Lock(Shard);
+        Shard.CurMemUsed = 0; Shard.ProtectedMemUsed = 0;
+        int KeyId = Shard.KeyEntryH.FFirstKeyId();
+        while (Shard.KeyEntryH.FNextKeyId(KeyId)) {
+            TEntry& Entry = Shard.KeyEntryH[KeyId];
+            Entry.MemUsed = GetEntryMemUsed(Shard.KeyEntryH.GetKey(KeyId), Entry.Dat);
+            Shard.CurMemUsed += Entry.MemUsed;
+            if (Entry.ProtectedP) { Shard.ProtectedMemUsed += Entry.MemUsed; }
+        }
+        Demote(Shard);
+        if (Shard.CurMemUsed > GetShardMxMemUsed()) {
+            Purge(Shard, 0);
+            PurgedP = true;
+        }
+    }
+    return PurgedP;
+}
+
+template <class TKey, class TDat, class THashFunc>
+void TSegCache<TKey, TDat, THashFunc>::Put(const TKey& Key, const TDat& Dat) {
+    TShard& Shard = GetShard(Key); TShardLock Lock(Shard);
+    const int KeyId = Shard.KeyEntryH.GetKeyId(Key);
+    if (KeyId == -1) {
+        const int64 MemUsed = GetEntryMemUsed(Key, Dat);
+        Purge(Shard, MemUsed);
+        TEntry& Entry = Shard.KeyEntryH.AddDat(Key);
+        Entry.Dat = Dat;
+        Entry.KeyLN = Shard.ProbationL.AddFront(Key);
+        Entry.MemUsed = MemUsed;
+        Entry.ProtectedP = false;
+        Shard.CurMemUsed += MemUsed;
+    } else {
+        Shard.KeyEntryH[KeyId].Dat = Dat;
+    }
+}
+
+template <class TKey, class TDat, class THashFunc>
+bool TSegCache<TKey, TDat, THashFunc>::Get(const TKey& Key, TDat& Dat) {
+    TShard& Shard = GetShard(Key); TShardLock Lock(Shard);
+    const int KeyId = Shard.KeyEntryH.GetKeyId(Key);
+    if (KeyId == -1) { Shard.Misses++; return false; }
+    TEntry& Entry = Shard.KeyEntryH[KeyId];
+    Dat = Entry.Dat;
+    Protect(Shard, Key, Entry);
+    Shard.Hits++;
+    return true;
+}
+
+template <class TKey, class TDat, class THashFunc>
+const TDat* TSegCache<TKey, TDat, THashFunc>::GetDatPt(const TKey& Key) {
+    TShard& Shard = GetShard(Key); TShardLock Lock(Shard);
+    const int KeyId = Shard.KeyEntryH.GetKeyId(Key);
+    if (KeyId == -1) { return NULL; }
+    TEntry& Entry = Shard.KeyEntryH[KeyId];
+    Protect(Shard, Key, Entry);
+    Shard.Hits++;
+    return &Entry.Dat;
+}
+
+template <class TKey, class TDat, class THashFunc>
+bool TSegCache<TKey, TDat, THashFunc>::Peek(const TKey& Key, TDat& Dat) const {
+    TShard& Shard = GetShard(Key); TShardLock Lock(Shard);
+    const int KeyId = Shard.KeyEntryH.GetKeyId(Key);
+    if (KeyId == -1) { return false; }
+    Dat = Shard.KeyEntryH[KeyId].Dat;
+    return true;
+}
+
+template <class TKey, class TDat, class THashFunc>
+void TSegCache<TKey, TDat, THashFunc>::Del(const TKey& Key, const bool& DoEventCall) {
+    TShard& Shard = GetShard(Key); TShardLock Lock(Shard);
+    if (Shard.KeyEntryH.IsKey(Key)) { DelEntry(Shard, Key, DoEventCall, false); }
+}
+
+template <class TKey, class TDat, class THashFunc>
+void TSegCache<TKey, TDat, THashFunc>::ChangeKey(const TKey& OldKey, const TKey& NewKey) {
+    if (OldKey == NewKey) { return; }
+    TShard& OldShard = GetShard(OldKey);
+    TShard& NewShard = GetShard(NewKey);
+    // lock shards in the same order as everyone else
+    TShardLock FirstLock(&OldShard < &NewShard ? OldShard : NewShard);
+    TShardLock SecondLock(&OldShard < &NewShard ? NewShard : OldShard);
+    const int OldKeyId = OldShard.KeyEntryH.GetKeyId(OldKey);
+    EAssertR(OldKeyId != -1, "OldKeyId should be a valid key");
+    const TEntry OldEntry = OldShard.KeyEntryH[OldKeyId];
+    if (&OldShard == &NewShard) {
+        // same shard, keep the position in the segment
+        OldShard.KeyEntryH.DelKeyId(OldKeyId);
+        OldEntry.KeyLN->GetVal() = NewKey;
+        OldShard.KeyEntryH.AddDat(NewKey, OldEntry);
+        return;
+    }
+    DelEntry(OldShard, OldKey, false, false);
+    // keep the entry in the same segment of the new shard
+    TEntry& Entry = NewShard.KeyEntryH.AddDat(NewKey);
+    Entry.Dat = OldEntry.Dat;
+    Entry.MemUsed = OldEntry.MemUsed;
+    Entry.ProtectedP = OldEntry.ProtectedP;
+    NewShard.CurMemUsed += Entry.MemUsed;
+    if (Entry.ProtectedP) {
+        Entry.KeyLN = NewShard.ProtectedL.AddFront(NewKey);
+        NewShard.ProtectedMemUsed += Entry.MemUsed;
+    } else {
+        Entry.KeyLN = NewShard.ProbationL.AddFront(NewKey);
+    }
+}
+
+template <class TKey, class TDat, class THashFunc>
+bool TSegCache<TKey, TDat, THashFunc>::IsKey(const TKey& Key) const {
+    TShard& Shard = GetShard(Key); TShardLock Lock(Shard);
+    return Shard.KeyEntryH.IsKey(Key);
+}
+
+template <class TKey, class TDat, class THashFunc>
+int TSegCache<TKey, TDat, THashFunc>::Len() const {
+    int Len = 0;
+    for (int ShardN = 0; ShardN < Shards; ShardN++) {
+        TShard& Shard = ShardT[ShardN]; TShardLock Lock(Shard);
+        Len += Shard.KeyEntryH.Len();
+    }
+    return Len;
+}
+
+template <class TKey, class TDat, class THashFunc>
+void TSegCache<TKey, TDat, THashFunc>::Flush() {
+    for (int ShardN = 0; ShardN < Shards; ShardN++) {
+        TShard& Shard = ShardT[ShardN]; TShardLock Lock(Shard);
+        int KeyId = Shard.KeyEntryH.FFirstKeyId();
+        while (Shard.KeyEntryH.FNextKeyId(KeyId)) {
+            TDat Dat = Shard.KeyEntryH[KeyId].Dat;
+            Dat->OnDelFromCache(Shard.KeyEntryH.GetKey(KeyId), RefToBs);
+        }
+    }
+}
+
+template <class TKey, class TDat, class THashFunc>
+void TSegCache<TKey, TDat, THashFunc>::FlushAndClr() {
+    Flush();
+    for (int ShardN = 0; ShardN < Shards; ShardN++) {
+        TShard& Shard = ShardT[ShardN]; TShardLock Lock(Shard);
+        Shard.KeyEntryH.Clr();
+        Shard.ProbationL.Clr();
+        Shard.ProtectedL.Clr();
+        Shard.CurMemUsed = 0;
+        Shard.ProtectedMemUsed = 0;
+    }
+}
+
+template <class TKey, class TDat, class THashFunc>
+void TSegCache<TKey, TDat, THashFunc>::GetKeyDatV(TVec<TPair<TKey, TDat> >& KeyDatV) const {
+    KeyDatV.Clr();
+    for (int ShardN = 0; ShardN < Shards; ShardN++) {
+        TShard& Shard = ShardT[ShardN]; TShardLock Lock(Shard);
+        for (TKeyLN KeyLN = Shard.ProbationL.Last(); KeyLN != NULL; KeyLN = KeyLN->Prev()) {
+            KeyDatV.Add(TPair<TKey, TDat>(KeyLN->GetVal(), Shard.KeyEntryH.GetDat(KeyLN->GetVal()).Dat));
+        }
+        for (TKeyLN KeyLN = Shard.ProtectedL.Last(); KeyLN != NULL; KeyLN = KeyLN->Prev()) {
+            KeyDatV.Add(TPair<TKey, TDat>(KeyLN->GetVal(), Shard.KeyEntryH.GetDat(KeyLN->GetVal()).Dat));
+        }
+    }
+}
+
+template <class TKey, class TDat, class THashFunc>
+uint64 TSegCache<TKey, TDat, THashFunc>::GetHits() const {
+    uint64 Hits = 0;
+    for (int ShardN = 0; ShardN < Shards; ShardN++) { Hits += ShardT[ShardN].Hits; }
+    return Hits;
+}
+
+template <class TKey, class TDat, class THashFunc>
+uint64 TSegCache<TKey, TDat, THashFunc>::GetMisses() const {
+    uint64 Misses = 0;
+    for (int ShardN = 0; ShardN < Shards; ShardN++) { Misses += ShardT[ShardN].Misses; }
+    return Misses;
+}
+
+template <class TKey, class TDat, class THashFunc>
+uint64 TSegCache<TKey, TDat, THashFunc>::GetEvictions() const {
+    uint64 Evictions = 0;
+    for (int ShardN = 0; ShardN < Shards; ShardN++) { Evictions += ShardT[ShardN].Evictions; }
+    return Evictions;
+}
+
+template <class TKey, class TDat, class THashFunc>
+void TSegCache<TKey, TDat, THashFunc>::ResetStats() {
+    for (int ShardN = 0; ShardN < Shards; ShardN++) {
+        TShard& Shard = ShardT[ShardN]; TShardLock Lock(Shard);
+        Shard.Hits = 0; Shard.Misses = 0; Shard.Evictions = 0;
+    }
+}
+
 /////////////////////////////////////////////////
 // Old-Hash-Functions
 
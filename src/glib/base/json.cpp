@@ -415,19 +415,42 @@ PJsonVal TJsonVal::GetValFromLx(TILx& Lx){
   return Val;
 }
 
-PJsonVal TJsonVal::GetValFromSIn(const PSIn& SIn, bool& Ok, TStr& MsgStr){
-  TILx Lx(SIn, TFSet()|iloCmtAlw|iloCsSens|iloExcept|iloSigNum|iloIgnoreEscape);
-  PJsonVal Val;
-  try {
-    Lx.GetSym(TFSet()|syIdStr|syFlt|syQStr|syLBracket|syLBrace);
-    Val=GetValFromLx(Lx);
-    Ok=true; MsgStr="Ok";
+/// Builds TJsonVal tree from SAX events
+class TJsonValSaxBuilder : public TJsonSaxHandler {
+private:
+  /// Parsed value
+  PJsonVal RootVal;
+  /// Open arrays and objects
+  TJsonValV OpenValV;
+  /// Key of the next member for each open object
+  TStrV KeyV;
+
+  void AddVal(const PJsonVal& Val) {
+    if (OpenValV.Empty()) { RootVal = Val; return; }
+    const PJsonVal& ParentVal = OpenValV.Last();
+    if (ParentVal->IsArr()) { ParentVal->AddToArr(Val); }
+    else { ParentVal->AddToObj(KeyV.Last(), Val); }
   }
-  catch (const PExcept& Except){
-    Val=TJsonVal::New();
-    Ok=false; MsgStr=Except->GetMsgStr();
-  }
-  return Val;
+  void OpenVal(const PJsonVal& Val) { AddVal(Val); OpenValV.Add(Val); KeyV.Add(); }
+  void CloseVal() { OpenValV.DelLast(); KeyV.DelLast(); }
+
+public:
+  void OnNull() { AddVal(TJsonVal::NewNull()); }
+  void OnBool(const bool& Bool) { AddVal(TJsonVal::NewBool(Bool)); }
+  void OnNum(const double& Num) { AddVal(TJsonVal::NewNum(Num)); }
+  void OnStr(const TChA& Str) { AddVal(TJsonVal::NewStr(Str)); }
+  void OnBeginArr() { OpenVal(TJsonVal::NewArr()); }
+  void OnEndArr() { CloseVal(); }
+  void OnBeginObj() { OpenVal(TJsonVal::NewObj()); }
+  void OnKey(const TChA& Key) { KeyV.Last() = Key; }
+  void OnEndObj() { CloseVal(); }
+
+  const PJsonVal& GetVal() const { return RootVal; }
+};
+
+PJsonVal TJsonVal::GetValFromSIn(const PSIn& SIn, bool& Ok, TStr& MsgStr){
+  TChA JsonChA; TChA::LoadTxt(SIn, JsonChA);
+  return GetValFromBf(JsonChA.CStr(), JsonChA.Len(), Ok, MsgStr);
 }
 
 PJsonVal TJsonVal::GetValFromSIn(const PSIn& SIn){
@@ -436,13 +459,27 @@ PJsonVal TJsonVal::GetValFromSIn(const PSIn& SIn){
 }
 
 PJsonVal TJsonVal::GetValFromStr(const TStr& JsonStr, bool& Ok, TStr& MsgStr){
-  PSIn SIn=TStrIn::New(JsonStr, false);
-  return GetValFromSIn(SIn, Ok, MsgStr);
+  return GetValFromBf(JsonStr.CStr(), JsonStr.Len(), Ok, MsgStr);
 }
 
 PJsonVal TJsonVal::GetValFromStr(const TStr& JsonStr){
-  PSIn SIn=TStrIn::New(JsonStr, false);
-  return GetValFromSIn(SIn);
+  bool Ok = true; TStr MsgStr;
+  return GetValFromBf(JsonStr.CStr(), JsonStr.Len(), Ok, MsgStr);
+}
+
+PJsonVal TJsonVal::GetValFromBf(const char* Bf, const int& BfL, bool& Ok, TStr& MsgStr){
+  PJsonVal Val;
+  try {
+    TJsonValSaxBuilder Builder;
+    TJsonSaxParser::Parse(Bf, BfL, Builder);
+    Val = Builder.GetVal();
+    Ok = true; MsgStr = "Ok";
+  }
+  catch (const PExcept& Except){
+    Val = TJsonVal::New();
+    Ok = false; MsgStr = Except->GetMsgStr();
+  }
+  return Val;
 }
 
 void TJsonVal::AddEscapeChAFromStr(const TStr& Str, TChA& ChA){
@@ -564,6 +601,165 @@ uint64 TJsonVal::GetMSecsFromJsonVal(const PJsonVal& Val) {
     }
 }
 
+/////////////////////////////////////////////////
+// Json-SAX-Parser
+TJsonSaxParser::TJsonSaxParser(const char* _Bf, const int& _BfL, TJsonSaxHandler& _Handler):
+  Bf(_Bf), BfL(_BfL), BfC(0), Ch(' '), Handler(_Handler) { }
+
+void TJsonSaxParser::Throw(const TStr& MsgStr) const {
+  TExcept::Throw(MsgStr + " [Char:" + TInt::GetStr(BfC) + "]");
+}
+
+void TJsonSaxParser::SkipSpace() {
+  const TLxChDef& ChDef = TLxChDef::GetChDef();
+  forever {
+    // end-of-lines count as whitespace, same as in TILx
+    while (Ch != TCh::EofCh && (ChDef.IsSpace(Ch) || Ch == TCh::CrCh || Ch == TCh::LfCh)) { GetCh(); }
+    if (Ch == '#') {
+      // line comment
+      while (Ch != TCh::EofCh && Ch != TCh::CrCh && Ch != TCh::LfCh) { GetCh(); }
+    } else if (Ch == '/' && BfC < BfL && Bf[BfC] == '/') {
+      // line comment
+      while (Ch != TCh::EofCh && Ch != TCh::CrCh && Ch != TCh::LfCh) { GetCh(); }
+    } else if (Ch == '/' && BfC < BfL && Bf[BfC] == '*') {
+      // block comment
+      GetCh(); GetCh();
+      while (Ch != TCh::EofCh && !(Ch == '*' && BfC < BfL && Bf[BfC] == '/')) { GetCh(); }
+      if (Ch == TCh::EofCh) { Throw("Unterminated JSON comment."); }
+      GetCh(); GetCh();
+    } else {
+      break;
+    }
+  }
+}
+
+void TJsonSaxParser::ParseVal() {
+  if (Ch == '{') {
+    ParseObj();
+  } else if (Ch == '[') {
+    ParseArr();
+  } else if (Ch == '"' || Ch == '\'') {
+    ParseQStr(); Handler.OnStr(StrBf);
+  } else if (TCh::IsNum(Ch) || Ch == '+' || Ch == '-') {
+    Handler.OnNum(ParseNum());
+  } else if (TLxChDef::GetChDef().IsAlpha(Ch)) {
+    ParseIdStr();
+    if (StrBf == "null") { Handler.OnNull(); }
+    else if (StrBf == "true") { Handler.OnBool(true); }
+    else if (StrBf == "false") { Handler.OnBool(false); }
+    else { Throw("Unexpected JSON symbol."); }
+  } else {
+    Throw("Unexpected JSON symbol.");
+  }
+  SkipSpace();
+}
+
+void TJsonSaxParser::ParseArr() {
+  Handler.OnBeginArr();
+  GetCh(); SkipSpace();
+  if (Ch != ']') {
+    forever {
+      ParseVal();
+      if (Ch == ',') { GetCh(); SkipSpace(); }
+      else if (Ch == ']') { break; }
+      else { Throw("JSON Array not properly formed."); }
+    }
+  }
+  GetCh();
+  Handler.OnEndArr();
+}
+
+void TJsonSaxParser::ParseObj() {
+  Handler.OnBeginObj();
+  GetCh(); SkipSpace();
+  if (Ch != '}') {
+    forever {
+      if (Ch != '"' && Ch != '\'') { Throw("Expected quoted key in JSON Object."); }
+      ParseQStr(); Handler.OnKey(StrBf);
+      SkipSpace();
+      if (Ch != ':') { Throw("Expected colon in JSON Object."); }
+      GetCh(); SkipSpace();
+      ParseVal();
+      if (Ch == ',') { GetCh(); SkipSpace(); }
+      else if (Ch == '}') { break; }
+      else { Throw("JSON Object not properly formed."); }
+    }
+  }
+  GetCh();
+  Handler.OnEndObj();
+}
+
+void TJsonSaxParser::ParseQStr() {
+  const char QuoteCh = Ch;
+  StrBf.Clr(); GetCh();
+  forever {
+    // copy unescaped run in one go
+    const int StartC = BfC - 1;
+    while (Ch != QuoteCh && Ch != '\\' && Ch != TCh::EofCh) { GetCh(); }
+    if (Ch == TCh::EofCh) {
+      Throw("Unterminated JSON string.");
+    }
+    StrBf.AddBf(const_cast<char*>(Bf) + StartC, BfC - 1 - StartC);
+    if (Ch == QuoteCh) { GetCh(); break; }
+    // escape sequence
+    GetCh();
+    if (Ch == TCh::EofCh) { Throw("Unterminated JSON string."); }
+    switch (Ch) {
+      case 'b': StrBf.AddCh('\b'); break;
+      case 'f': StrBf.AddCh('\f'); break;
+      case 'n': StrBf.AddCh('\n'); break;
+      case 'r': StrBf.AddCh('\r'); break;
+      case 't': StrBf.AddCh('\t'); break;
+      case 'u': {
+        // unicode character, represented using 4 hexadecimal digits
+        int UChCd = 0;
+        for (int HexN = 0; HexN < 4; HexN++) {
+          GetCh(); EAssertR(TCh::IsHex(Ch), "Invalid hexadecimal digit in unicode escape");
+          UChCd = 16 * UChCd + TCh::GetHex(Ch);
+        }
+        // null character is replaced with space
+        if (UChCd == 0) { UChCd = 32; }
+        TUnicode::EncodeUtf8(UChCd, StrBf);
+        break; }
+      default:
+        // unknown escapes keep the escaped character
+        StrBf.AddCh(Ch); break;
+    }
+    GetCh();
+  }
+}
+
+double TJsonSaxParser::ParseNum() {
+  StrBf.Clr();
+  if (Ch == '+' || Ch == '-') { StrBf.AddCh(Ch); GetCh(); }
+  // a sign alone is not a number
+  bool DigitP = false;
+  while (TCh::IsNum(Ch)) { StrBf.AddCh(Ch); GetCh(); DigitP = true; }
+  if (Ch == '.') {
+    StrBf.AddCh(Ch);
+    while (TCh::IsNum(GetCh())) { StrBf.AddCh(Ch); DigitP = true; }
+  }
+  if (!DigitP) { Throw("Number expected in JSON."); }
+  if (Ch == 'e' || Ch == 'E') {
+    StrBf.AddCh(Ch); GetCh();
+    if (Ch == '+' || Ch == '-') { StrBf.AddCh(Ch); GetCh(); }
+    while (TCh::IsNum(Ch)) { StrBf.AddCh(Ch); GetCh(); }
+  }
+  return atof(StrBf.CStr());
+}
+
+void TJsonSaxParser::ParseIdStr() {
+  const TLxChDef& ChDef = TLxChDef::GetChDef();
+  StrBf.Clr();
+  do { StrBf.AddCh(Ch); } while (ChDef.IsAlNum(GetCh()));
+}
+
+void TJsonSaxParser::Parse(const char* Bf, const int& BfL, TJsonSaxHandler& Handler) {
+  TJsonSaxParser Parser(Bf, BfL, Handler);
+  Parser.GetCh(); Parser.SkipSpace();
+  Parser.ParseVal();
+}
+
 ///////////////////////////////////////////////////////////////////////////////////
 // TBsonObj methods
 int64 TBsonObj::GetMemUsedRecursive(const TJsonVal& JsonVal, bool UseVoc) {
@@ -213,6 +213,7 @@ public:
   static PJsonVal GetValFromSIn(const PSIn& SIn);
   static PJsonVal GetValFromStr(const TStr& JsonStr, bool& Ok, TStr& MsgStr);
   static PJsonVal GetValFromStr(const TStr& JsonStr);
+  static PJsonVal GetValFromBf(const char* Bf, const int& BfL, bool& Ok, TStr& MsgStr);
   static void AddEscapeChAFromStr(const TStr& Str, TChA& ChA);
   static TStr AddEscapeStrFromStr(const TStr& Str) {
 	  TChA ChA; AddEscapeChAFromStr(Str, ChA); return ChA; }
@@ -227,6 +228,69 @@ public:
   static uint64 GetMSecsFromJsonVal(const PJsonVal& Val);
 };
 
+/////////////////////////////////////////////////
+// Json-SAX-Handler
+/// Receives parsing events from TJsonSaxParser in document order.
+/// Strings and keys are passed in a buffer owned by the parser, which
+/// is only valid until the callback returns.
+class TJsonSaxHandler {
+public:
+  virtual ~TJsonSaxHandler() { }
+
+  virtual void OnNull() = 0;
+  virtual void OnBool(const bool& Bool) = 0;
+  virtual void OnNum(const double& Num) = 0;
+  virtual void OnStr(const TChA& Str) = 0;
+  virtual void OnBeginArr() = 0;
+  virtual void OnEndArr() = 0;
+  virtual void OnBeginObj() = 0;
+  /// Called before the value of each object member
+  virtual void OnKey(const TChA& Key) = 0;
+  virtual void OnEndObj() = 0;
+};
+
+/////////////////////////////////////////////////
+// Json-SAX-Parser
+/// Streaming JSON parser working directly on a character buffer. Accepts
+/// the same dialect as TJsonVal::GetValFromLx (comments, single-quoted
+/// strings, lenient escapes) without going through TILx.
+/// Throws PExcept on malformed input, content after the top value is ignored.
+class TJsonSaxParser {
+private:
+  /// Input buffer
+  const char* Bf;
+  /// Input length
+  int BfL;
+  /// Current position in the input
+  int BfC;
+  /// Current character, TCh::EofCh at the end of the input
+  char Ch;
+  /// Buffer for decoded strings and number tokens, reused between symbols
+  TChA StrBf;
+  /// Handler receiving the events
+  TJsonSaxHandler& Handler;
+
+  char GetCh() { Ch = (BfC < BfL) ? Bf[BfC++] : TCh::EofCh; return Ch; }
+  /// Skip whitespace and comments
+  void SkipSpace();
+  void ParseVal();
+  void ParseArr();
+  void ParseObj();
+  /// Parse quoted string into StrBf
+  void ParseQStr();
+  double ParseNum();
+  void ParseIdStr();
+  void Throw(const TStr& MsgStr) const;
+
+  TJsonSaxParser(const char* _Bf, const int& _BfL, TJsonSaxHandler& _Handler);
+  UndefCopyAssign(TJsonSaxParser);
+public:
+  /// Parse the buffer and fire events on the handler
+  static void Parse(const char* Bf, const int& BfL, TJsonSaxHandler& Handler);
+  static void Parse(const TStr& JsonStr, TJsonSaxHandler& Handler) {
+    Parse(JsonStr.CStr(), JsonStr.Len(), Handler); }
+};
+
 //////////////////////////////////////////////////////////////////////////////
 // Binary serialization of Json Value
 class TBsonObj {
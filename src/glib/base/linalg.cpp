@@ -16,6 +16,15 @@
 #include <Eigen/Sparse>
 #endif
 
+///////////////////////////////////////////////////////////////////////
+// Dense kernels
+// block sizes are bound to references (TMath::Mn), so they need a definition
+const int TLinAlgKernel::GemmRowBlock;
+const int TLinAlgKernel::GemmColBlock;
+const int TLinAlgKernel::GemmInnerBlock;
+const int TLinAlgKernel::GemvColBlock;
+const int TLinAlgKernel::ParallelMults;
+
 ///////////////////////////////////////////////////////////////////////
 // Sparse-Column-Matrix
 void TSparseColMatrix::PMultiply(const TFltVV& B, int ColId, TFltV& Result) const {
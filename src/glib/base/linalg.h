@@ -580,6 +580,68 @@ public:
 	TEMP_LA	static void GetColMinIdxV(const TDenseVV& X, TVec<TNum<TSizeTy>, TSizeTy>& IdxV);
 };
 
+//////////////////////////////////////////////////////////////////////
+/// Dense kernels used by TLinAlg when compiled without BLAS.
+/// Matrices are given as raw row-major arrays with a leading dimension
+/// (distance between consecutive rows). Inner loops run over contiguous
+/// memory with independent accumulators so the compiler can vectorize them
+/// for the target instruction set. Large problems are split into cache-sized
+/// blocks and processed with OpenMP.
+class TLinAlgKernel {
+private:
+	/// Rows of C processed by one task in Gemm
+	static const int GemmRowBlock = 64;
+	/// Columns of C packed together in Gemm
+	static const int GemmColBlock = 256;
+	/// Length of the inner dimension packed together in Gemm
+	static const int GemmInnerBlock = 256;
+	/// Columns of y updated by one task in transposed Gemv
+	static const int GemvColBlock = 1024;
+	/// Minimal number of multiplications before work is split between threads
+	static const int ParallelMults = 1 << 18;
+
+	/// Element (RowN, ColN) of op(X), where X is row-major
+	template <class TType, class TSizeTy>
+	static const TType& At(const bool& TransX, const TType* X, const TSizeTy& LdX,
+			const TSizeTy& RowN, const TSizeTy& ColN) {
+		return TransX ? X[ColN * LdX + RowN] : X[RowN * LdX + ColN]; }
+	/// C(i:i+4, :) += [a0 a1 a2 a3]' * b(:) for four rows of C at once
+	template <class TType, class TSizeTy>
+	static void Axpy4(const TType& a0, const TType& a1, const TType& a2, const TType& a3,
+		const TType* b, TType* c0, TType* c1, TType* c2, TType* c3, const TSizeTy& Len);
+
+public:
+	/// Result = <x, y>
+	template <class TType, class TSizeTy>
+	static TType Dot(const TType* x, const TType* y, const TSizeTy& Len);
+	/// y := k * x + y
+	template <class TType, class TSizeTy>
+	static void Axpy(const TType& k, const TType* x, TType* y, const TSizeTy& Len);
+	/// x := k * x, sets x to zero when k is zero
+	template <class TType, class TSizeTy>
+	static void Scale(const TType& k, TType* x, const TSizeTy& Len);
+
+	/// y := Alpha * op(A) * x + Beta * y, where op(A) is Rows x Cols and A is row-major
+	template <class TType, class TSizeTy>
+	static void Gemv(const bool& TransA, const TSizeTy& Rows, const TSizeTy& Cols,
+		const TType& Alpha, const TType* A, const TSizeTy& LdA, const TType* x,
+		const TType& Beta, TType* y);
+	/// C := Alpha * op(A) * op(B) + Beta * C, where op(A) is M x K, op(B) is K x N
+	/// and all matrices are row-major
+	template <class TType, class TSizeTy>
+	static void Gemm(const bool& TransA, const bool& TransB, const TSizeTy& M,
+		const TSizeTy& N, const TSizeTy& K, const TType& Alpha, const TType* A,
+		const TSizeTy& LdA, const TType* B, const TSizeTy& LdB, const TType& Beta,
+		TType* C, const TSizeTy& LdC);
+
+	/// y := Alpha * op(A) * x + Beta * y for matrices in either storage order
+	TEMP_LA static void Gemv(const TType& Alpha, const TDenseVV& A, const bool& TransA,
+		const TDenseV& x, const TType& Beta, TDenseV& y);
+	/// C := Alpha * op(A) * op(B) + Beta * C for matrices in either storage order
+	TEMP_LA static void Gemm(const TType& Alpha, const TDenseVV& A, const bool& TransA,
+		const TDenseVV& B, const bool& TransB, const TType& Beta, TDenseVV& C);
+};
+
 ///////////////////////////////////////////////////////////////////////
 // Basic Linear Algebra operations
 class TLinAlg {
@@ -581,16 +581,185 @@ void TLinAlgSearch::GetColMinIdxV(const TVVec<TNum<TType>, TSizeTy, ColMajor>& X
 }
 
 
+//////////////////////////////////////////////////////////////////////
+// Dense kernels
+template <class TType, class TSizeTy>
+TType TLinAlgKernel::Dot(const TType* x, const TType* y, const TSizeTy& Len) {
+    // independent partial sums break the dependency chain between iterations
+    TType Sum0 = 0.0, Sum1 = 0.0, Sum2 = 0.0, Sum3 = 0.0;
+    TSizeTy ElN = 0;
+    for (; ElN + 4 <= Len; ElN += 4) {
+        Sum0 += x[ElN] * y[ElN];
+        Sum1 += x[ElN + 1] * y[ElN + 1];
+        Sum2 += x[ElN + 2] * y[ElN + 2];
+        Sum3 += x[ElN + 3] * y[ElN + 3];
+    }
+    for (; ElN < Len; ElN++) { Sum0 += x[ElN] * y[ElN]; }
+    return (Sum0 + Sum1) + (Sum2 + Sum3);
+}
+
+template <class TType, class TSizeTy>
+void TLinAlgKernel::Axpy(const TType& k, const TType* x, TType* y, const TSizeTy& Len) {
+    for (TSizeTy ElN = 0; ElN < Len; ElN++) {
+        y[ElN] += k * x[ElN];
+    }
+}
+
+template <class TType, class TSizeTy>
+void TLinAlgKernel::Axpy4(const TType& a0, const TType& a1, const TType& a2, const TType& a3,
+        const TType* b, TType* c0, TType* c1, TType* c2, TType* c3, const TSizeTy& Len) {
+    for (TSizeTy ElN = 0; ElN < Len; ElN++) {
+        const TType bVal = b[ElN];
+        c0[ElN] += a0 * bVal;
+        c1[ElN] += a1 * bVal;
+        c2[ElN] += a2 * bVal;
+        c3[ElN] += a3 * bVal;
+    }
+}
+
+template <class TType, class TSizeTy>
+void TLinAlgKernel::Scale(const TType& k, TType* x, const TSizeTy& Len) {
+    if (k == TType(1.0)) { return; }
+    if (k == TType(0.0)) {
+        for (TSizeTy ElN = 0; ElN < Len; ElN++) { x[ElN] = 0.0; }
+    } else {
+        for (TSizeTy ElN = 0; ElN < Len; ElN++) { x[ElN] *= k; }
+    }
+}
+
+template <class TType, class TSizeTy>
+void TLinAlgKernel::Gemv(const bool& TransA, const TSizeTy& Rows, const TSizeTy& Cols,
+        const TType& Alpha, const TType* A, const TSizeTy& LdA, const TType* x,
+        const TType& Beta, TType* y) {
+
+    Scale(Beta, y, Rows);
+    if (Rows == 0 || Cols == 0 || Alpha == TType(0.0)) { return; }
+    const bool ParallelP = double(Rows) * double(Cols) >= double(ParallelMults);
+    if (!TransA) {
+        // rows of A are contiguous, each element of y is one dot product
+        #pragma omp parallel for schedule(static) if (ParallelP)
+        for (int RowN = 0; RowN < int(Rows); RowN++) {
+            y[RowN] += Alpha * Dot(A + TSizeTy(RowN) * LdA, x, Cols);
+        }
+    } else {
+        // y is a linear combination of rows of A, each thread updates its own part of y
+        const int ColBlocks = int((Rows + GemvColBlock - 1) / GemvColBlock);
+        #pragma omp parallel for schedule(static) if (ParallelP && ColBlocks > 1)
+        for (int BlockN = 0; BlockN < ColBlocks; BlockN++) {
+            const TSizeTy MnColN = TSizeTy(BlockN) * GemvColBlock;
+            const TSizeTy BlockCols = TMath::Mn<TSizeTy>(GemvColBlock, Rows - MnColN);
+            for (TSizeTy RowN = 0; RowN < Cols; RowN++) {
+                Axpy(Alpha * x[RowN], A + RowN * LdA + MnColN, y + MnColN, BlockCols);
+            }
+        }
+    }
+}
+
+template <class TType, class TSizeTy>
+void TLinAlgKernel::Gemm(const bool& TransA, const bool& TransB, const TSizeTy& M,
+        const TSizeTy& N, const TSizeTy& K, const TType& Alpha, const TType* A,
+        const TSizeTy& LdA, const TType* B, const TSizeTy& LdB, const TType& Beta,
+        TType* C, const TSizeTy& LdC) {
+
+    for (TSizeTy RowN = 0; RowN < M; RowN++) { Scale(Beta, C + RowN * LdC, N); }
+    if (M == 0 || N == 0 || K == 0 || Alpha == TType(0.0)) { return; }
+    // blocks of rows of C are independent and are processed in parallel for large products
+    const int RowBlocks = int((M + GemmRowBlock - 1) / GemmRowBlock);
+    const bool ParallelP = (RowBlocks > 1) &&
+        (double(M) * double(N) * double(K) >= double(ParallelMults));
+    // block of op(B) is copied into contiguous rows which stay in cache
+    // while all the rows of C are updated with it
+    TType* PackB = new TType[GemmInnerBlock * GemmColBlock];
+    for (TSizeTy MnColN = 0; MnColN < N; MnColN += GemmColBlock) {
+        const TSizeTy Cols = TMath::Mn<TSizeTy>(GemmColBlock, N - MnColN);
+        for (TSizeTy MnInN = 0; MnInN < K; MnInN += GemmInnerBlock) {
+            const TSizeTy Inner = TMath::Mn<TSizeTy>(GemmInnerBlock, K - MnInN);
+            for (TSizeTy InN = 0; InN < Inner; InN++) {
+                TType* PackRow = PackB + InN * Cols;
+                for (TSizeTy ColN = 0; ColN < Cols; ColN++) {
+                    PackRow[ColN] = At(TransB, B, LdB, MnInN + InN, MnColN + ColN);
+                }
+            }
+            #pragma omp parallel for schedule(static) if (ParallelP)
+            for (int BlockN = 0; BlockN < RowBlocks; BlockN++) {
+                const TSizeTy MnRowN = TSizeTy(BlockN) * GemmRowBlock;
+                const TSizeTy MxRowN = TMath::Mn<TSizeTy>(MnRowN + GemmRowBlock, M);
+                TSizeTy RowN = MnRowN;
+                // four rows of C at a time reuse each loaded element of B
+                for (; RowN + 4 <= MxRowN; RowN += 4) {
+                    TType* C0 = C + RowN * LdC + MnColN;
+                    for (TSizeTy InN = 0; InN < Inner; InN++) {
+                        const TSizeTy ColA = MnInN + InN;
+                        Axpy4(Alpha * At(TransA, A, LdA, RowN, ColA),
+                            Alpha * At(TransA, A, LdA, RowN + 1, ColA),
+                            Alpha * At(TransA, A, LdA, RowN + 2, ColA),
+                            Alpha * At(TransA, A, LdA, RowN + 3, ColA),
+                            PackB + InN * Cols, C0, C0 + LdC, C0 + 2 * LdC, C0 + 3 * LdC, Cols);
+                    }
+                }
+                for (; RowN < MxRowN; RowN++) {
+                    TType* C0 = C + RowN * LdC + MnColN;
+                    for (TSizeTy InN = 0; InN < Inner; InN++) {
+                        Axpy(Alpha * At(TransA, A, LdA, RowN, MnInN + InN), PackB + InN * Cols, C0, Cols);
+                    }
+                }
+            }
+        }
+    }
+    delete[] PackB;
+}
+
+template <class TType, class TSizeTy, bool ColMajor>
+void TLinAlgKernel::Gemv(const TType& Alpha, const TVVec<TNum<TType>, TSizeTy, ColMajor>& A,
+        const bool& TransA, const TVec<TNum<TType>, TSizeTy>& x, const TType& Beta,
+        TVec<TNum<TType>, TSizeTy>& y) {
+
+    const TSizeTy Rows = TransA ? A.GetCols() : A.GetRows();
+    const TSizeTy Cols = TransA ? A.GetRows() : A.GetCols();
+    EAssertR(x.Len() == Cols && y.Len() == Rows, "TLinAlgKernel::Gemv: dimension mismatch");
+    if (A.Empty()) { Scale(Beta, (TType*)y.BegI(), Rows); return; }
+    // column-major matrix has the same layout as its row-major transpose
+    const TType* RawA = (const TType*)&A(0, 0).Val;
+    const TSizeTy LdA = ColMajor ? A.GetRows() : A.GetCols();
+    Gemv(ColMajor ? !TransA : TransA, Rows, Cols, Alpha, RawA, LdA,
+        (const TType*)x.BegI(), Beta, (TType*)y.BegI());
+}
+
+template <class TType, class TSizeTy, bool ColMajor>
+void TLinAlgKernel::Gemm(const TType& Alpha, const TVVec<TNum<TType>, TSizeTy, ColMajor>& A,
+        const bool& TransA, const TVVec<TNum<TType>, TSizeTy, ColMajor>& B, const bool& TransB,
+        const TType& Beta, TVVec<TNum<TType>, TSizeTy, ColMajor>& C) {
+
+    const TSizeTy M = TransA ? A.GetCols() : A.GetRows();
+    const TSizeTy K = TransA ? A.GetRows() : A.GetCols();
+    const TSizeTy N = TransB ? B.GetRows() : B.GetCols();
+    EAssertR(K == (TransB ? B.GetCols() : B.GetRows()) && M == C.GetRows() && N == C.GetCols(),
+        "TLinAlgKernel::Gemm: dimension mismatch");
+    if (C.Empty()) { return; }
+    TType* RawC = (TType*)&C(0, 0).Val;
+    if (A.Empty() || B.Empty()) {
+        Scale(Beta, RawC, M * N);
+        return;
+    }
+    const TType* RawA = (const TType*)&A(0, 0).Val;
+    const TType* RawB = (const TType*)&B(0, 0).Val;
+    if (ColMajor) {
+        // column-major matrices are row-major transposes, compute C' = op(B)' * op(A)'
+        Gemm(TransB, TransA, N, M, K, Alpha, RawB, B.GetRows(), RawA, A.GetRows(),
+            Beta, RawC, C.GetRows());
+    } else {
+        Gemm(TransA, TransB, M, N, K, Alpha, RawA, A.GetCols(), RawB, B.GetCols(),
+            Beta, RawC, C.GetCols());
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////
 // Basic Linear Algebra operations
 template <class TType, class TSizeTy, bool ColMajor>
 TType TLinAlg::DotProduct(const TVec<TNum<TType>, TSizeTy>& x,
         const TVec<TNum<TType>, TSizeTy>& y) {
     EAssertR(x.Len() == y.Len(), TStr::Fmt("%d != %d", x.Len(), y.Len()));
-    TType result = 0.0; const  TSizeTy Len = x.Len();
-    for (TSizeTy i = 0; i < Len; i++)
-        result += x[i] * y[i];
-    return result;
+    return TLinAlgKernel::Dot((const TType*)x.BegI(), (const TType*)y.BegI(), x.Len());
 }
 
 template <class TType, class TSizeTy, bool ColMajor>
@@ -901,13 +1070,8 @@ void TLinAlg::AddVec(const TType& k, const TVec<TNum<TType>, TSizeTy>& x,
 
 template <class TType, class TSizeTy, bool ColMajor>
 void TLinAlg::AddVec(const TType& k, const TVec<TNum<TType>, TSizeTy>& x, TVec<TNum<TType>, TSizeTy>& y) {
-    const int Size = x.Len();
-
-    EAssert(y.Len() == Size);
-
-    for (int ValN = 0; ValN < Size; ValN++) {
-        y[ValN] = k*x[ValN] + y[ValN];
-    }
+    EAssert(y.Len() == x.Len());
+    TLinAlgKernel::Axpy(k, (const TType*)x.BegI(), (TType*)y.BegI(), x.Len());
 }
 
 #endif
@@ -1556,13 +1720,7 @@ void TLinAlg::Multiply(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A,
 #ifdef BLAS
     TLinAlg::Multiply(A, x, y, TLinAlgBlasTranspose::NOTRANS, 1.0, 0.0);
 #else
-    TSizeTy n = A.GetRows(), m = A.GetCols();
-    for (TSizeTy i = 0; i < n; i++) {
-        y[i] = 0.0;
-        for (TSizeTy j = 0; j < m; j++) {
-            y[i] += A(i, j) * x[j];
-        }
-    }
+    TLinAlgKernel::Gemv(TType(1.0), A, false, x, TType(0.0), y);
 #endif
 }
 
@@ -2029,12 +2187,7 @@ void TLinAlg::MultiplyT(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A, const TV
         TVec<TNum<TType>, TSizeTy>& y) {
     if (y.Empty()) y.Gen(A.GetCols());
     EAssert(A.GetRows() == x.Len() && A.GetCols() == y.Len());
-    TSizeTy n = A.GetCols(), m = A.GetRows();
-    for (TSizeTy i = 0; i < n; i++) {
-        y[i] = 0.0;
-        for (TSizeTy j = 0; j < m; j++)
-            y[i] += A(j, i) * x[j];
-    }
+    TLinAlgKernel::Gemv(TType(1.0), A, true, x, TType(0.0), y);
 }
 
 #ifdef BLAS
@@ -2126,7 +2279,8 @@ template <class TType, class TSizeTy, bool ColMajor>
 inline void TLinAlg::Multiply(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A,
     const TVVec<TNum<TType>, TSizeTy, ColMajor>& B, TVVec<TNum<TType>,
     TSizeTy, ColMajor>& C, const int& BlasTransposeFlagA, const int& BlasTransposeFlagB) {
-    throw TExcept::New("TLinAlg::Multiply(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A, const TVVec<TNum<TType>, TSizeTy, ColMajor>& B, TVVec<TNum<TType>, TSizeTy, ColMajor>& C, const int& BlasTransposeFlagA, const int& BlasTransposeFlagB) not implemented yet!");
+    TLinAlgKernel::Gemm(TType(1.0), A, BlasTransposeFlagA == TLinAlgBlasTranspose::TRANS,
+        B, BlasTransposeFlagB == TLinAlgBlasTranspose::TRANS, TType(0.0), C);
 }
 
 #endif
@@ -2199,7 +2353,10 @@ void TLinAlg::Multiply(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A, const TVe
 //Andrej ToDo In the future replace TType with TNum<type> and change double to type
 template <class TType, class TSizeTy, bool ColMajor>
 void TLinAlg::Multiply(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A, const TVec<TNum<TType>, TSizeTy>& x, TVec<TNum<TType>, TSizeTy>& y, const int& BlasTransposeFlagA, TType alpha, TType beta) {
-    throw TExcept::New("TLinAlg::Multiply(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A, const TVec<TNum<TType>, TSizeTy>& x, TVec<TNum<TType>, TSizeTy>& y, const int& BlasTransposeFlagA, TType alpha, TType beta) not implemented yet!");
+    const bool TransA = (BlasTransposeFlagA == TLinAlgBlasTranspose::TRANS);
+    const TSizeTy Rows = TransA ? A.GetCols() : A.GetRows();
+    if (y.Len() != Rows) { y.Gen(Rows); }
+    TLinAlgKernel::Gemv(alpha, A, TransA, x, beta, y);
 }
 
 #endif
@@ -2214,18 +2371,7 @@ void TLinAlg::Multiply(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A,
 #ifdef BLAS
     TLinAlg::Multiply(A, B, C, TLinAlgBlasTranspose::NOTRANS, TLinAlgBlasTranspose::NOTRANS);
 #else
-    TSizeTy RowsA = A.GetRows();
-    TSizeTy ColsA = A.GetCols();
-    TSizeTy ColsB = B.GetCols();
-    C.PutAll(0.0);
-    for (TSizeTy RowN = 0; RowN < RowsA; RowN++) {
-        for (TSizeTy ColAN = 0; ColAN < ColsA; ColAN++) {
-            TType Weight = A(RowN, ColAN);
-            for (TSizeTy ColBN = 0; ColBN < ColsB; ColBN++) {
-                C(RowN, ColBN) += Weight * B(ColAN, ColBN);
-            }
-        }
-    }
+    TLinAlgKernel::Gemm(TType(1.0), A, false, B, false, TType(0.0), C);
 #endif
 }
 
@@ -2238,15 +2384,7 @@ void TLinAlg::MultiplyT(const TVVec<TNum<TType>, TSizeTy, ColMajor>& A,
 #ifdef BLAS
     TLinAlg::Multiply(A, B, C, TLinAlgBlasTranspose::TRANS, TLinAlgBlasTranspose::NOTRANS);
 #else
-    TSizeTy n = C.GetRows(), m = C.GetCols(), l = A.GetRows(); TType sum;
-    for (TSizeTy i = 0; i < n; i++) {
-        for (TSizeTy j = 0; j < m; j++) {
-            sum = 0.0;
-            for (TSizeTy k = 0; k < l; k++)
-                sum += A(k, i)*B(k, j);
-            C(i, j) = sum;
-        }
-    }
+    TLinAlgKernel::Gemm(TType(1.0), A, true, B, false, TType(0.0), C);
 #endif
 }
 
@@ -2585,26 +2723,15 @@ void TLinAlg::Gemm(const double& Alpha, const TVVec<TNum<TType>, TSizeTy, ColMaj
     // assertions for dimensions
     EAssert(a_j == c_j && b_i == c_i && a_i == b_j && c_i == d_i && c_j == d_j);
 
-    double Aij, Bij, Cij;
-
-    // rows of D
-    for (TSizeTy j = 0; j < a_j; j++) {
-        // cols of D
-        for (TSizeTy i = 0; i < b_i; i++) {
-            // not optimized for speed - naive algorithm
-            double sum = 0.0;
-            // cols of A
-            for (TSizeTy k = 0; k < a_i; k++) {
-                Aij = tA ? A.At(k, j) : A.At(j, k);
-                Bij = tB ? B.At(i, k) : B.At(k, i);
-                sum += Alpha * Aij * Bij;
+    // D := op(C), the product is then accumulated on top of it
+    if (Beta != 0.0) {
+        for (TSizeTy j = 0; j < d_j; j++) {
+            for (TSizeTy i = 0; i < d_i; i++) {
+                D.At(j, i) = tC ? C.At(i, j) : C.At(j, i);
             }
-            Cij = tC ? C.At(i, j) : C.At(j, i);
-            sum += Beta * Cij;
-            D.At(j, i) = sum;
         }
     }
-
+    TLinAlgKernel::Gemm(TType(Alpha), A, tA, B, tB, TType(Beta), D);
 }
 
 template <class TType, class TSizeTy, bool ColMajor>
@@ -751,12 +751,13 @@ uint64 TSysTm::GetPerfTimerTicks(){
   struct timespec ts;
   int ErrCd=clock_gettime(CLOCK_MONOTONIC, &ts);
   //Assert(ErrCd==0); //J: vcasih se prevede in ne dela
-  if (ErrCd != 0) {
+  if (ErrCd == 0) {
     return (uint64)ts.tv_sec*1000000000ll + (uint64)ts.tv_nsec; }
   else {
+    // fall back to wall clock, scaled to the nanoseconds of GetPerfTimerFq
     struct timeval tv;
     gettimeofday(&tv, NULL);
-    return (uint64)tv.tv_usec + ((uint64)tv.tv_sec)*1000000;
+    return ((uint64)tv.tv_usec + ((uint64)tv.tv_sec)*1000000) * 1000;
   }
 #else
   //#warning "CLOCK_MONOTONIC not available; using gettimeofday()"
@@ -112,6 +112,11 @@ TPgBlobFile::TPgBlobFile(
     Access = _Access;
     FNm = _FNm;
     MxFileLen = _MxSegLen;
+    MapBf = NULL;
+    MapLen = 0;
+#ifdef GLib_WIN
+    MapId = NULL;
+#endif
 
     switch (Access) {
     case faCreate:
@@ -133,17 +138,61 @@ TPgBlobFile::TPgBlobFile(
         break;
     }
     PgCnt = (long) (TFile::GetSize(FNm) / PG_PAGE_SIZE);
+    // read-only files never change, so we can map them
+    if (Access == faRdOnly) { MapFile(); }
 }
 
 /// Destructor
 TPgBlobFile::~TPgBlobFile() {
+    UnmapFile();
     EAssertR(
         fclose(FileId) == 0,
         "Can not close file '" + TStr(FNm.CStr()) + "'.");
 }
 
+/// Map the file into memory
+void TPgBlobFile::MapFile() {
+    EAssert(Access == faRdOnly);
+    if (FileId == NULL || PgCnt == 0) { return; }
+    const uint64 Len = (uint64)PgCnt * PG_PAGE_SIZE;
+#if defined(GLib_WIN)
+    HANDLE FileHnd = (HANDLE)_get_osfhandle(_fileno(FileId));
+    MapId = CreateFileMapping(FileHnd, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (MapId == NULL) { return; }
+    void* Bf = MapViewOfFile(MapId, FILE_MAP_READ, 0, 0, (SIZE_T)Len);
+    if (Bf == NULL) { CloseHandle(MapId); MapId = NULL; return; }
+    MapBf = (char*)Bf;
+#elif defined(GLib_UNIX)
+    void* Bf = mmap(NULL, (size_t)Len, PROT_READ, MAP_SHARED, fileno(FileId), 0);
+    if (Bf == MAP_FAILED) { return; }
+    MapBf = (char*)Bf;
+#else
+    return;
+#endif
+    MapLen = Len;
+}
+
+/// Release the memory map
+void TPgBlobFile::UnmapFile() {
+    if (MapBf == NULL) { return; }
+#if defined(GLib_WIN)
+    UnmapViewOfFile(MapBf);
+    CloseHandle(MapId);
+    MapId = NULL;
+#elif defined(GLib_UNIX)
+    munmap(MapBf, (size_t)MapLen);
+#endif
+    MapBf = NULL;
+    MapLen = 0;
+}
+
 /// Load page with given index from the file into buffer
 int TPgBlobFile::LoadPage(const uint32& Page, void* Bf) {
+    if (IsMapped()) {
+        EAssertR(Page < (uint32)PgCnt, "Error reading file '" + TStr(FNm) + "'.");
+        memcpy(Bf, GetMapPage(Page), PG_PAGE_SIZE);
+        return 0;
+    }
     SetFPos(Page * PG_PAGE_SIZE);
     EAssertR(
         fread(Bf, 1, PG_PAGE_SIZE, FileId) == PG_PAGE_SIZE,
@@ -161,6 +210,11 @@ int TPgBlobFile::SavePage(const uint32& Page, const void* Bf, int Len) {
     return 0;
 }
 
+/// Write buffered pages to the file
+void TPgBlobFile::Flush() {
+    EAssertR(fflush(FileId) == 0, "Error flushing file '" + TStr(FNm) + "'.");
+}
+
 /// Refresh the position - internal check
 void TPgBlobFile::RefreshFPos() {
     EAssertR(
@@ -487,6 +541,17 @@ char* TPgBlob::LoadPage(const TPgBlobPgPt& Pt, const bool& LoadData) {
     return PgPt;
 }
 
+/// Get page for reading
+char* TPgBlob::GetReadPage(const TPgBlobPgPt& Pt) {
+    const PPgBlobFile& File = Files[Pt.GetFIx()];
+    if (File->IsMapped()) {
+        EAssertR(Pt.GetPg() < (uint32)File->GetPgCnt(),
+            "Page out of range in file '" + File->GetFNm() + "'.");
+        return File->GetMapPage(Pt.GetPg());
+    }
+    return LoadPage(Pt);
+}
+
 /// Create new page and return pointers to it
 void TPgBlob::CreateNewPage(TPgBlobPgPt& Pt, char** Bf) {
     // determine if last file is empty
@@ -627,7 +692,7 @@ TPgBlobPt TPgBlob::Put(
 
 /// Retrieve BLOB from storage
 TThinMIn TPgBlob::Get(const TPgBlobPt& Pt) {
-    char* Pg = LoadPage(Pt);
+    char* Pg = GetReadPage(Pt);
     TPgBlobPageItem* Item = GetItemRec(Pg, Pt.GetIIx());
     char* Data;
     int Len = Item->Len;
@@ -659,7 +724,10 @@ TMemBase TPgBlob::GetMemBase(const TPgBlobPt& Pt) {
 /// Loads all pages into cache - cache must be big enough
 void TPgBlob::LoadAll() {
     for (int i = 0; i < Fsm.Len(); i++) {
-        LoadPage(Fsm.GetVal(i));
+        const TPgBlobPgPt& Pt = Fsm.GetVal(i);
+        if (!Files[Pt.GetFIx()]->IsMapped()) {
+            LoadPage(Pt);
+        }
     }
 }
 
@@ -691,6 +759,17 @@ void TPgBlob::PartialFlush(int WndInMsec) {
     }
 }
 
+/// Save all dirty pages and the main file, keeping the pages loaded
+void TPgBlob::Flush() {
+    if (Access == TFAccess::faRdOnly)
+        return;
+    PartialFlush(TInt::Mx);
+    SaveMain();
+    for (int i = 0; i < Files.Len(); i++) {
+        Files[i]->Flush();
+    }
+}
+
 /// Marks page as dirty - data inside was written directly
 void TPgBlob::SetDirty(const TPgBlobPt& Pt) {
     IAssert(Access != TFAccess::faRdOnly);
@@ -713,6 +792,16 @@ PJsonVal TPgBlob::GetStats() {
     res->AddToObj("dirty_pages", dirty);
     res->AddToObj("loaded_extents", Extents.Len());
     res->AddToObj("cache_size", PG_EXTENT_SIZE * Extents.Len());
+    // memory-mapped files (read-only mode)
+    int MappedFiles = 0; uint64 MappedSize = 0;
+    for (int FileN = 0; FileN < Files.Len(); FileN++) {
+        if (Files[FileN]->IsMapped()) {
+            MappedFiles++;
+            MappedSize += Files[FileN]->GetMapLen();
+        }
+    }
+    res->AddToObj("mapped_files", MappedFiles);
+    res->AddToObj("mapped_size", (double)MappedSize);
     return res;
 }
 
@@ -236,6 +236,15 @@ private:
     FILE* FileId;
     static char* EmptyPage;
 
+    /// Read-only memory map of the whole file (NULL when file is not mapped)
+    char* MapBf;
+    /// Length of the memory map in bytes
+    uint64 MapLen;
+#ifdef GLib_WIN
+    /// Handle of the file mapping object
+    HANDLE MapId;
+#endif
+
     /// Private constructor
     TPgBlobFile(const TStr& _FNm, const TFAccess& _Access = faRdOnly,
         const uint32& _MxSegLen = -1);
@@ -245,6 +254,12 @@ private:
     /// Set position in the file
     void SetFPos(const int& FPos);
 
+    /// Map the file into memory, only used in read-only mode.
+    /// When mapping fails, the file is read using page loads.
+    void MapFile();
+    /// Release the memory map
+    void UnmapFile();
+
 public:
     /// Reference count for smart pointers
     TCRef CRef;
@@ -264,15 +279,27 @@ public:
     int SavePage(const uint32& Page, const void* Bf, int Len = -1);
     /// Reserve new space in the file. Returns -1 if file is full.
     long CreateNewPage();
+    /// Write buffered pages to the file
+    void Flush();
     /// Returns name of the file
     const TStr& GetFNm() const { return FNm; }
     /// Returns the number of pages stored in this file
     long GetPgCnt() const { return PgCnt; }
+
+    /// Is the file mapped into memory
+    bool IsMapped() const { return MapBf != NULL; }
+    /// Returns pointer to the page inside memory map, file must be mapped
+    char* GetMapPage(const uint32& Page) const {
+        return MapBf + (uint64)Page * PG_PAGE_SIZE; }
+    /// Returns length of the memory map in bytes
+    uint64 GetMapLen() const { return MapLen; }
 };
 
 ////////////////////////////////////////////////////////////
 /// Multi-file paged-BLOB-storage with cache.
 /// Has no clue about the meaning of the data in pages.
+/// In read-only mode the files are memory-mapped and pages are read directly
+/// from the maps, so processes opening the same files share the OS page cache.
 class TPgBlob {
 private:
     static const int MxBlobFLen;
@@ -411,6 +438,9 @@ protected:
     bool CanEvictPageP(char* Pt) { return !((TPgHeader*)Pt)->IsLock(); }
     /// Load given page into memory
     char* LoadPage(const TPgBlobPgPt& Pt, const bool& LoadData = true);
+    /// Get page for reading. Pages of memory-mapped files are read
+    /// directly from the map, other pages are loaded into cache.
+    char* GetReadPage(const TPgBlobPgPt& Pt);
     /// Create new page and return pointers to it
     void CreateNewPage(TPgBlobPgPt& Pt, char** Bf);
 
@@ -457,13 +487,16 @@ public:
     void Del(const TPgBlobPt& Pt);
     /// Retrieve BLOB from storage as TMemBase
     TMemBase GetMemBase(const TPgBlobPt& Pt);
-    /// Loads all pages into cache- cache must be big enough
+    /// Loads all pages into cache- cache must be big enough.
+    /// Pages from memory-mapped files are skipped.
     void LoadAll();
     /// Clear all contents
     void Clr();
 
     /// Save part of the data, given time-window
     void PartialFlush(int WndInMsec = 500);
+    /// Save all dirty pages and the main file, keeping the pages loaded
+    void Flush();
     /// Retrieve statistics for this object
     PJsonVal GetStats();
 
@@ -85,6 +85,27 @@ void TCriticalSection::Leave() {
     pthread_mutex_unlock(&Cs);
 }
 
+////////////////////////////////////////////
+// Read-write lock
+TRWLock::TRWLock() {
+    pthread_rwlock_init(&RWLock, NULL);
+}
+TRWLock::~TRWLock() {
+    pthread_rwlock_destroy(&RWLock);
+}
+void TRWLock::EnterRead() {
+    pthread_rwlock_rdlock(&RWLock);
+}
+void TRWLock::LeaveRead() {
+    pthread_rwlock_unlock(&RWLock);
+}
+void TRWLock::EnterWrite() {
+    pthread_rwlock_wrlock(&RWLock);
+}
+void TRWLock::LeaveWrite() {
+    pthread_rwlock_unlock(&RWLock);
+}
+
 ////////////////////////////////////////////
 // Conditional variable lock
 TCondVarLock::TCondVarLock():
@@ -134,13 +155,27 @@ TBlocker::~TBlocker() {
 }
 
 void TBlocker::Block(int Msecs) {
-    timespec waitTime;
-    long nano = Msecs * 1000000;
-    waitTime.tv_nsec = nano;
-    pthread_cond_timedwait(&Event, &Mutex, &waitTime);
+    pthread_mutex_lock(&Mutex);
+    if (Msecs < 0 || Msecs == INFINITE) {
+        pthread_cond_wait(&Event, &Mutex);
+    } else {
+        // timed wait expects absolute time
+        timespec waitTime;
+        clock_gettime(CLOCK_REALTIME, &waitTime);
+        waitTime.tv_sec += Msecs / 1000;
+        waitTime.tv_nsec += (long)(Msecs % 1000) * 1000000;
+        if (waitTime.tv_nsec >= 1000000000) {
+            waitTime.tv_sec++;
+            waitTime.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&Event, &Mutex, &waitTime);
+    }
+    pthread_mutex_unlock(&Mutex);
 }
 void TBlocker::Release() {
+    pthread_mutex_lock(&Mutex);
     pthread_cond_broadcast(&Event);
+    pthread_mutex_unlock(&Mutex);
 }
 
 
@@ -54,6 +54,25 @@ public:
     void Leave();
 };
 
+////////////////////////////////////////////
+// Read-write lock
+//   many threads can hold it for reading or one for writing,
+//   the same thread must not enter it more than once
+class TRWLock {
+private:
+    pthread_rwlock_t RWLock;
+
+    UndefCopyAssign(TRWLock);
+public:
+    TRWLock();
+    ~TRWLock();
+
+    void EnterRead();
+    void LeaveRead();
+    void EnterWrite();
+    void LeaveWrite();
+};
+
 ////////////////////////////////////////////
 // Thread
 ClassTP(TThread, PThread)// {
@@ -222,12 +222,12 @@ public:
 
 	void AddJob(TPt<TJob<InItem, OutItem> > Job){
 		int AllItems = Job->Items->Len();
-		int ItemsPerThread = AllItems / Len() + 1;
+		int ItemsPerThread = AllItems / this->Len() + 1;
 		int Start = 0;
 		int End = ItemsPerThread;
-		TVec<TPt<TJob<InItem, OutItem> > > SubJobs(Len());
+		TVec<TPt<TJob<InItem, OutItem> > > SubJobs(this->Len());
 		
-		for (int i = 0; i < MIN(Len(), AllItems); i++) {
+		for (int i = 0; i < MIN(this->Len(), AllItems); i++) {
 			TPt<TJob<InItem, OutItem> > SubJob = TJob<InItem, OutItem>::New(Job->Task, Job->Items, Job->Outputs);
 			SubJob->IndexOffset = Start;
 			SubJob->IndexEnd = MIN(AllItems, End);
@@ -240,7 +240,7 @@ public:
 	}
 
 	bool IsFinished() {
-		for (int i = 0; i < Len(); i++) {
+		for (int i = 0; i < this->Len(); i++) {
 			if (!(*this)[i]->IsFinished()) {
 				return false;
 			}
@@ -249,7 +249,7 @@ public:
 	}
 
 	void WaitForTasks(int TaskId = 0) {
-		for (int i = 0; i < Len(); i++) {
+		for (int i = 0; i < this->Len(); i++) {
 			(*this)[i]->WaitForTask(TaskId);
 		}
 	}
@@ -275,47 +275,69 @@ public:
 
 };
 
-/** Parallel for-each loob with its own thread manager. Reusing is encouraged. */
+/** Parallel for-each loop running on its own work-stealing scheduler. Reusing is encouraged.
+	Items are split into one contiguous segment per thread, same as with TJobThreadPool,
+	so TAggregationTask partials are never shared between threads. */
 template<class InItem, class OutItem>
 class TParallel : public TLoops<InItem, OutItem> {
 protected:
-	TJobThreadPool<InItem, OutItem> Threads;
+	/** Processes one segment of items */
+	class TSegmentTask : public TTaskScheduler::TTask {
+	private:
+		::TTask<InItem, OutItem>& Task;
+		const TVec<InItem>& Items;
+		TVec<OutItem>& Outputs;
+		const int IndexOffset, IndexEnd;
+	public:
+		TSegmentTask(::TTask<InItem, OutItem>& _Task, const TVec<InItem>& _Items, TVec<OutItem>& _Outputs,
+			const int& _IndexOffset, const int& _IndexEnd): Task(_Task), Items(_Items),
+			Outputs(_Outputs), IndexOffset(_IndexOffset), IndexEnd(_IndexEnd) { }
+		void Run() {
+			for (int n = IndexOffset; n < IndexEnd; n++) {
+				Task.Each(Items[n], Outputs[n], n);
+			}
+		}
+	};
+
+	int ThreadNo;
+	TTaskScheduler* Scheduler;
+	TTaskScheduler::TTaskGroup* Group;
+	/** Segments spawned since the last WaitForCompletion */
+	TVec<TSegmentTask*> SegmentTaskV;
 
+	TParallel(const TParallel&);
+	TParallel& operator=(const TParallel&);
 public:
 
-	TParallel(int NumCpu, bool DoStart = true)  {
-		Threads = TJobThreadPool<InItem, OutItem>(NumCpu);
+	TParallel(int NumCpu, bool DoStart = true): ThreadNo(NumCpu), Scheduler(NULL), Group(NULL) {
 		if (DoStart) {
 			Start();
 		}
 	}
 
-	TParallel(bool DoStart = true)   {
-		int NumCpu = TThread::GetCoreCount();
-		Threads = TJobThreadPool<InItem, OutItem>(NumCpu);
+	TParallel(bool DoStart = true): ThreadNo(TThread::GetCoreCount()), Scheduler(NULL), Group(NULL) {
 		if (DoStart) {
 			Start();
 		}
 	}
 
 	~TParallel() {
-		for (int i = 0; i < Threads.Len(); i++) {
-			Threads[i]->Stop();
-		}
-		for (int i = 0; i < Threads.Len(); i++) {
-			Threads[i]->Interrupt();
-			Threads[i]->Join();
+		if (Scheduler != NULL) {
+			WaitForCompletion();
+			delete Group;
+			delete Scheduler;
 		}
 	}
 
 	void Start() {
-		for (int i = 0; i < Threads.Len(); i++) {
-			Threads[i]->Start();
+		if (Scheduler == NULL) {
+			Scheduler = new TTaskScheduler(ThreadNo);
+			Group = new TTaskScheduler::TTaskGroup(*Scheduler);
 		}
 	}
 
 	int GetThreadNo() const {
-		return Threads.Len();
+		return ThreadNo;
 	}
 
 	virtual void ForEach(const TVec<InItem>& Items, TVec<OutItem>& Outputs, TTask<InItem, OutItem>& DoThis) {
@@ -325,13 +347,29 @@ public:
 	}
 
 	virtual void ExecuteAndForget(const TVec<InItem>& Items, TVec<OutItem>& Outputs, TTask<InItem, OutItem>& DoThis) {
-		TPt<TJob<InItem, OutItem> > Job = TJob<InItem, OutItem>::New(&DoThis, &Items, &Outputs);
-		Threads.AddJob(Job);
+		IAssertR(Scheduler != NULL, "TParallel not started!");
+		IAssertR(Items.Len() == Outputs.Len(), "InItems must be same size as OutItems!");
+		const int AllItems = Items.Len();
+		const int ItemsPerThread = AllItems / ThreadNo + 1;
+		for (int Start = 0; Start < AllItems; Start += ItemsPerThread) {
+			TSegmentTask* SegmentTask = new TSegmentTask(DoThis, Items, Outputs,
+				Start, MIN(AllItems, Start + ItemsPerThread));
+			SegmentTaskV.Add(SegmentTask);
+			Group->Spawn(*SegmentTask);
+		}
 	}
 
 	virtual void WaitForCompletion() {
-		Threads.WaitForTasks();
-		while(!Threads.IsFinished()) { TSysProc::Sleep(1); }
+		if (Group == NULL) { return; }
+		try {
+			Group->Wait();
+		} catch (const PExcept& Except) {
+			for (int i = 0; i < SegmentTaskV.Len(); i++) { delete SegmentTaskV[i]; }
+			SegmentTaskV.Clr();
+			throw;
+		}
+		for (int i = 0; i < SegmentTaskV.Len(); i++) { delete SegmentTaskV[i]; }
+		SegmentTaskV.Clr();
 	}
 
 };
@@ -146,3 +146,194 @@ TWPt<TThreadPool::TRunnable> TThreadPool::WaitForTask(const uint64& ThreadId) {
 
     return Runnable;
 }
+
+////////////////////////////////////////////
+// Work-stealing task scheduler
+namespace {
+    /// Scheduler the calling thread is a worker of
+    thread_local const TTaskScheduler* WorkerScheduler = NULL;
+    /// Index of the calling thread among the workers of WorkerScheduler
+    thread_local int WorkerSchedulerN = -1;
+}
+
+bool TTaskScheduler::TTaskGroup::OnTaskDone(const PExcept& TaskExcept) {
+    if (!TaskExcept.Empty()) {
+        TLock Lck(ExceptLock);
+        if (Except.Empty()) { Except = TaskExcept; }
+    }
+    return --PendingTasks == 0;
+}
+
+void TTaskScheduler::TTaskGroup::Wait() {
+    Scheduler.Wait(*this);
+    // rethrow the first exception
+    PExcept TaskExcept;
+    {
+        TLock Lck(ExceptLock);
+        TaskExcept = Except; Except.Clr();
+    }
+    if (!TaskExcept.Empty()) { throw TaskExcept; }
+}
+
+void TTaskScheduler::TTaskDeque::Push(TTask* Task) {
+    TLock Lck(Lock);
+    TaskV.Add(Task);
+}
+
+TTaskScheduler::TTask* TTaskScheduler::TTaskDeque::Pop() {
+    TLock Lck(Lock);
+    if (FirstTaskN == TaskV.Len()) { return NULL; }
+    TTask* Task = TaskV.Last(); TaskV.DelLast();
+    if (FirstTaskN == TaskV.Len()) { TaskV.Clr(false); FirstTaskN = 0; }
+    return Task;
+}
+
+TTaskScheduler::TTask* TTaskScheduler::TTaskDeque::Steal() {
+    TLock Lck(Lock);
+    if (FirstTaskN == TaskV.Len()) { return NULL; }
+    TTask* Task = TaskV[FirstTaskN++];
+    if (FirstTaskN == TaskV.Len()) { TaskV.Clr(false); FirstTaskN = 0; }
+    return Task;
+}
+
+void TTaskScheduler::TWorkerThread::Run() {
+    Scheduler->RunWorker(WorkerN);
+}
+
+int TTaskScheduler::GetWorkerN() const {
+    return (WorkerScheduler == this) ? WorkerSchedulerN : -1;
+}
+
+void TTaskScheduler::Spawn(TTaskGroup& Group, TTask& Task) {
+    Task.Group = &Group;
+    Group.PendingTasks++;
+    // workers push to their own deque, other threads to the shared one
+    // count the task before it is visible, so the counter never goes negative
+    QueuedTasks++;
+    const int WorkerN = GetWorkerN();
+    DequeV[(WorkerN == -1) ? ThreadV.Len() : WorkerN].Push(&Task);
+    // wake up an idle worker or a waiting thread
+    if (IdleThreads > 0) {
+        IdleLock.Lock();
+        IdleLock.Signal();
+        IdleLock.Release();
+    }
+}
+
+TTaskScheduler::TTask* TTaskScheduler::GetTask(const int& WorkerN) {
+    if (QueuedTasks == 0) { return NULL; }
+    // newest task from own deque first, it is most likely still in cache
+    TTask* Task = (WorkerN == -1) ? NULL : DequeV[WorkerN].Pop();
+    // steal the oldest task from others, starting after own deque
+    const int Deques = DequeV.Len();
+    const int FirstDequeN = (WorkerN == -1) ? Deques - 1 : WorkerN + 1;
+    for (int DequeN = 0; Task == NULL && DequeN < Deques; DequeN++) {
+        Task = DequeV[(FirstDequeN + DequeN) % Deques].Steal();
+    }
+    if (Task != NULL) { QueuedTasks--; }
+    return Task;
+}
+
+void TTaskScheduler::RunTask(TTask* Task) {
+    TTaskGroup* Group = Task->Group;
+    PExcept TaskExcept;
+    try {
+        Task->Run();
+    } catch (const PExcept& Except) {
+        TaskExcept = Except;
+    } catch (...) {
+        TaskExcept = TExcept::New("Unknown exception in scheduled task");
+    }
+    // the task and the group can be freed once the group is notified
+    if (Group->OnTaskDone(TaskExcept) && IdleThreads > 0) {
+        // wake up the thread waiting for the group
+        IdleLock.Lock();
+        IdleLock.Broadcast();
+        IdleLock.Release();
+    }
+}
+
+void TTaskScheduler::Wait(TTaskGroup& Group) {
+    const int WorkerN = GetWorkerN();
+    while (Group.PendingTasks > 0) {
+        TTask* Task = GetTask(WorkerN);
+        if (Task != NULL) {
+            RunTask(Task);
+        } else {
+            // remaining tasks of the group are running on other threads, sleep
+            // until one of them finishes the group or a new task is spawned
+            IdleLock.Lock();
+            IdleThreads++;
+            while (Group.PendingTasks > 0 && QueuedTasks == 0) {
+                IdleLock.WaitForSignal();
+            }
+            IdleThreads--;
+            IdleLock.Release();
+        }
+    }
+}
+
+void TTaskScheduler::RunWorker(const int& WorkerN) {
+    WorkerScheduler = this;
+    WorkerSchedulerN = WorkerN;
+    while (!StopP) {
+        TTask* Task = GetTask(WorkerN);
+        if (Task != NULL) {
+            RunTask(Task);
+        } else {
+            // nothing to do, sleep until a task is spawned
+            IdleLock.Lock();
+            IdleThreads++;
+            while (QueuedTasks == 0 && !StopP) {
+                IdleLock.WaitForSignal();
+            }
+            IdleThreads--;
+            IdleLock.Release();
+        }
+    }
+}
+
+TTaskScheduler::TTaskScheduler(const int& Threads): QueuedTasks(0), IdleThreads(0), StopP(false) {
+    EAssertR(Threads > 0, "Number of threads should be greater than zero.");
+    DequeV.Gen(Threads + 1);
+    ThreadV.Gen(Threads, 0);
+    for (int ThreadN = 0; ThreadN < Threads; ThreadN++) {
+        ThreadV.Add(TWorkerThread(this, ThreadN));
+    }
+    for (int ThreadN = 0; ThreadN < Threads; ThreadN++) {
+        ThreadV[ThreadN].Start();
+    }
+}
+
+TTaskScheduler::~TTaskScheduler() {
+    IdleLock.Lock();
+    StopP = true;
+    IdleLock.Broadcast();
+    IdleLock.Release();
+    for (int ThreadN = 0; ThreadN < ThreadV.Len(); ThreadN++) {
+        ThreadV[ThreadN].Join();
+    }
+}
+
+TTaskScheduler& TTaskScheduler::GetDefault() {
+    static TTaskScheduler* DefaultScheduler = new TTaskScheduler(TThread::GetCoreCount());
+    return *DefaultScheduler;
+}
+
+////////////////////////////////////////////
+// Parallel loops
+void TParallelLoop::For(TTaskScheduler& Scheduler, const int& MnValN, const int& MxValN,
+        const TParallelForBody& Body, const int& GrainSize) {
+
+    if (MxValN - MnValN <= TInt::GetMx(GrainSize, 1)) {
+        if (MnValN < MxValN) { Body.Run(MnValN, MxValN); }
+        return;
+    }
+    // spawn the right half and process the left half on this thread
+    const int MidValN = MnValN + (MxValN - MnValN) / 2;
+    TForTask RightTask(Scheduler, Body, MidValN, MxValN, GrainSize);
+    TTaskScheduler::TTaskGroup Group(Scheduler);
+    Group.Spawn(RightTask);
+    For(Scheduler, MnValN, MidValN, Body, GrainSize);
+    Group.Wait();
+}
@@ -10,6 +10,7 @@
 #define THREAD_H
 
 #include <base.h>
+#include <atomic>
 
 enum TMutexType {
     mtFast,
@@ -57,6 +58,32 @@ public:
     ~TLock() { CriticalSection.Leave(); }
 };
 
+////////////////////////////////////////////
+// Read lock
+//   Wrapper around read-write lock, which enters it for reading
+//   on construct, and leaves on scope unwinding (destruct)
+class TReadLock {
+private:
+    TRWLock& RWLock;
+    UndefCopyAssign(TReadLock);
+public:
+    TReadLock(TRWLock& _RWLock): RWLock(_RWLock) { RWLock.EnterRead(); }
+    ~TReadLock() { RWLock.LeaveRead(); }
+};
+
+////////////////////////////////////////////
+// Write lock
+//   Wrapper around read-write lock, which enters it for writing
+//   on construct, and leaves on scope unwinding (destruct)
+class TWriteLock {
+private:
+    TRWLock& RWLock;
+    UndefCopyAssign(TWriteLock);
+public:
+    TWriteLock(TRWLock& _RWLock): RWLock(_RWLock) { RWLock.EnterWrite(); }
+    ~TWriteLock() { RWLock.LeaveWrite(); }
+};
+
 ////////////////////////////////////////////
 /// Thread pool
 ///   Contains a pool of worker threads which can execute TRunnable objects. The runnable
@@ -131,4 +158,242 @@ private:
     TWPt<TRunnable> WaitForTask(const uint64& ThreadId);
 };
 
+////////////////////////////////////////////
+/// Work-stealing task scheduler
+///   Each worker thread owns a deque of tasks. Workers push and pop their own tasks
+///   at the back of the deque and steal from the front of other deques when they run
+///   out of work, so threads do not contend on a single queue. Tasks spawned from
+///   threads outside the scheduler go to a shared deque that workers steal from.
+///   A thread waiting for a task group executes pending tasks and blocks only when
+///   there are none left to run, which makes nested parallelism safe.
+///  IMPORTANT: unlike TThreadPool the scheduler does not take ownership of tasks.
+///  Tasks are usually allocated on the stack of the spawning function and must live
+///  until the task group they were spawned into finishes.
+class TTaskScheduler {
+public:
+    class TTaskGroup;
+
+    /// Has to implement Run()
+    class TTask {
+    friend class TTaskScheduler;
+    private:
+        /// Group the task was spawned into
+        TTaskGroup* Group;
+    public:
+        TTask(): Group(NULL) { }
+        virtual ~TTask() { }
+        /// Main logic to be implemented
+        virtual void Run() = 0;
+    };
+
+    /// Set of spawned tasks which can be waited for together
+    class TTaskGroup {
+    friend class TTaskScheduler;
+    private:
+        /// Scheduler executing the tasks
+        TTaskScheduler& Scheduler;
+        /// Number of spawned tasks which did not finish yet
+        std::atomic<int> PendingTasks;
+        /// First exception thrown by a task of the group
+        PExcept Except;
+        /// Protects Except
+        TCriticalSection ExceptLock;
+
+        /// Returns true when this was the last pending task of the group
+        bool OnTaskDone(const PExcept& TaskExcept);
+        UndefCopyAssign(TTaskGroup);
+    public:
+        TTaskGroup(TTaskScheduler& _Scheduler): Scheduler(_Scheduler), PendingTasks(0) { }
+        /// Waits for all the tasks, leaving the scope with running tasks is not allowed
+        ~TTaskGroup() { if (PendingTasks > 0) { Scheduler.Wait(*this); } }
+
+        /// Queues the task for execution
+        void Spawn(TTask& Task) { Scheduler.Spawn(*this, Task); }
+        /// Runs queued tasks until all tasks of the group are done. Rethrows the
+        /// first exception thrown by a task of the group.
+        void Wait();
+        /// Number of tasks which did not finish yet
+        int GetPendingTasks() const { return PendingTasks; }
+    };
+
+private:
+    /// Deque of tasks, protected by its own lock
+    class TTaskDeque {
+    private:
+        TCriticalSection Lock;
+        TVec<TTask*> TaskV;
+        /// Index of the first task, tasks before it were stolen
+        int FirstTaskN;
+    public:
+        TTaskDeque(): FirstTaskN(0) { }
+        /// Adds a task at the back
+        void Push(TTask* Task);
+        /// Takes the newest task from the back, NULL when empty
+        TTask* Pop();
+        /// Takes the oldest task from the front, NULL when empty
+        TTask* Steal();
+    };
+
+    class TWorkerThread: public TThread {
+    friend class TTaskScheduler;
+    private:
+        /// Scheduler this thread works for
+        TTaskScheduler* Scheduler;
+        /// Index of the worker and its deque
+        int WorkerN;
+    public:
+        /// Only needed for Vector constructor
+        TWorkerThread(): TThread(), Scheduler(NULL), WorkerN(-1) { }
+        TWorkerThread(TTaskScheduler* _Scheduler, const int& _WorkerN):
+            TThread(), Scheduler(_Scheduler), WorkerN(_WorkerN) { }
+        /// Runs tasks until the scheduler stops
+        void Run();
+    };
+
+private:
+    /// Worker threads
+    TVec<TWorkerThread> ThreadV;
+    /// One deque per worker, the last one is for tasks spawned from other threads
+    TVec<TTaskDeque> DequeV;
+    /// Number of tasks in all deques
+    std::atomic<int> QueuedTasks;
+    /// Number of workers and waiting threads sleeping on IdleLock
+    std::atomic<int> IdleThreads;
+    /// Used for waking up idle workers when tasks are spawned, and waiting
+    /// threads when tasks are spawned or their group finishes
+    TCondVarLock IdleLock;
+    /// Set when the scheduler is being destroyed
+    volatile bool StopP;
+
+    /// Worker index of the calling thread for this scheduler, -1 for other threads
+    int GetWorkerN() const;
+    void Spawn(TTaskGroup& Group, TTask& Task);
+    /// Takes a task from own deque or steals one from other deques, NULL if none found
+    TTask* GetTask(const int& WorkerN);
+    /// Runs the task and notifies its group
+    void RunTask(TTask* Task);
+    /// Helps running tasks until the group is done
+    void Wait(TTaskGroup& Group);
+    /// Main loop of worker threads
+    void RunWorker(const int& WorkerN);
+
+    UndefCopyAssign(TTaskScheduler);
+public:
+    /// Creates and starts worker threads
+    TTaskScheduler(const int& Threads = TThread::GetCoreCount());
+    /// Stops worker threads, all task groups must be finished before
+    ~TTaskScheduler();
+
+    /// Number of worker threads
+    int GetThreads() const { return ThreadV.Len(); }
+
+    /// Scheduler shared by the process, with one worker per core.
+    /// Created on first use and never destroyed.
+    static TTaskScheduler& GetDefault();
+};
+
+////////////////////////////////////////////
+/// Body of TParallelLoop::For
+class TParallelForBody {
+public:
+    virtual ~TParallelForBody() { }
+    /// Processes elements with indexes from [MnValN, MxValN)
+    virtual void Run(const int& MnValN, const int& MxValN) const = 0;
+};
+
+////////////////////////////////////////////
+/// Body of TParallelLoop::Reduce
+template <class TRes>
+class TParallelReduceBody {
+public:
+    virtual ~TParallelReduceBody() { }
+    /// Accumulates elements with indexes from [MnValN, MxValN) into Res
+    virtual void Run(const int& MnValN, const int& MxValN, TRes& Res) const = 0;
+    /// Merges partial result OtherRes into Res
+    virtual void Merge(TRes& Res, const TRes& OtherRes) const = 0;
+};
+
+////////////////////////////////////////////
+/// Parallel loops on top of TTaskScheduler
+///   Index ranges are split in halves until they are smaller than the grain size. One
+///   half is spawned as a task which idle workers can steal, the other is processed by
+///   the current thread. The splitting depends only on the range and the grain size, so
+///   Reduce merges partial results in the same order on every run.
+class TParallelLoop {
+private:
+    class TForTask: public TTaskScheduler::TTask {
+    private:
+        TTaskScheduler& Scheduler;
+        const TParallelForBody& Body;
+        const int MnValN, MxValN, GrainSize;
+    public:
+        TForTask(TTaskScheduler& _Scheduler, const TParallelForBody& _Body, const int& _MnValN,
+            const int& _MxValN, const int& _GrainSize): Scheduler(_Scheduler), Body(_Body),
+            MnValN(_MnValN), MxValN(_MxValN), GrainSize(_GrainSize) { }
+        void Run() { For(Scheduler, MnValN, MxValN, Body, GrainSize); }
+    };
+
+    template <class TRes>
+    class TReduceTask: public TTaskScheduler::TTask {
+    private:
+        TTaskScheduler& Scheduler;
+        const TParallelReduceBody<TRes>& Body;
+        const int MnValN, MxValN, GrainSize;
+        TRes& Res;
+    public:
+        TReduceTask(TTaskScheduler& _Scheduler, const TParallelReduceBody<TRes>& _Body,
+            const int& _MnValN, const int& _MxValN, const int& _GrainSize, TRes& _Res):
+            Scheduler(_Scheduler), Body(_Body), MnValN(_MnValN), MxValN(_MxValN),
+            GrainSize(_GrainSize), Res(_Res) { }
+        void Run() { Reduce(Scheduler, MnValN, MxValN, Body, Res, GrainSize); }
+    };
+
+public:
+    /// Calls Body on disjoint ranges covering [MnValN, MxValN), returns when all are done
+    static void For(TTaskScheduler& Scheduler, const int& MnValN, const int& MxValN,
+        const TParallelForBody& Body, const int& GrainSize = 1);
+    static void For(const int& MnValN, const int& MxValN, const TParallelForBody& Body,
+            const int& GrainSize = 1) {
+        For(TTaskScheduler::GetDefault(), MnValN, MxValN, Body, GrainSize); }
+    /// Calls Body on disjoint ranges covering all indexes of the vector
+    template <class TVal, class TSizeTy>
+    static void For(const TVec<TVal, TSizeTy>& ValV, const TParallelForBody& Body,
+            const int& GrainSize = 1) {
+        For(TTaskScheduler::GetDefault(), 0, (int)ValV.Len(), Body, GrainSize); }
+
+    /// Accumulates [MnValN, MxValN) into Res. Each split range starts from a copy
+    /// of the value Res has on the call, which should be the neutral element.
+    template <class TRes>
+    static void Reduce(TTaskScheduler& Scheduler, const int& MnValN, const int& MxValN,
+        const TParallelReduceBody<TRes>& Body, TRes& Res, const int& GrainSize = 1);
+    template <class TRes>
+    static void Reduce(const int& MnValN, const int& MxValN, const TParallelReduceBody<TRes>& Body,
+            TRes& Res, const int& GrainSize = 1) {
+        Reduce(TTaskScheduler::GetDefault(), MnValN, MxValN, Body, Res, GrainSize); }
+    /// Accumulates all indexes of the vector into Res
+    template <class TVal, class TSizeTy, class TRes>
+    static void Reduce(const TVec<TVal, TSizeTy>& ValV, const TParallelReduceBody<TRes>& Body,
+            TRes& Res, const int& GrainSize = 1) {
+        Reduce(TTaskScheduler::GetDefault(), 0, (int)ValV.Len(), Body, Res, GrainSize); }
+};
+
+template <class TRes>
+void TParallelLoop::Reduce(TTaskScheduler& Scheduler, const int& MnValN, const int& MxValN,
+        const TParallelReduceBody<TRes>& Body, TRes& Res, const int& GrainSize) {
+
+    if (MxValN - MnValN <= TInt::GetMx(GrainSize, 1)) {
+        Body.Run(MnValN, MxValN, Res);
+        return;
+    }
+    // right half accumulates into its own copy of the neutral element
+    const int MidValN = MnValN + (MxValN - MnValN) / 2;
+    TRes RightRes = Res;
+    TReduceTask<TRes> RightTask(Scheduler, Body, MidValN, MxValN, GrainSize, RightRes);
+    TTaskScheduler::TTaskGroup Group(Scheduler);
+    Group.Spawn(RightTask);
+    Reduce(Scheduler, MnValN, MidValN, Body, Res, GrainSize);
+    Group.Wait();
+    Body.Merge(Res, RightRes);
+}
+
 #endif
@@ -56,6 +56,24 @@ void TCriticalSection::Leave() {
 	LeaveCriticalSection(&Cs);
 }
 
+////////////////////////////////////////////
+// Read-write lock
+TRWLock::TRWLock() {
+	InitializeSRWLock(&RWLock);
+}
+void TRWLock::EnterRead() {
+	AcquireSRWLockShared(&RWLock);
+}
+void TRWLock::LeaveRead() {
+	ReleaseSRWLockShared(&RWLock);
+}
+void TRWLock::EnterWrite() {
+	AcquireSRWLockExclusive(&RWLock);
+}
+void TRWLock::LeaveWrite() {
+	ReleaseSRWLockExclusive(&RWLock);
+}
+
 ////////////////////////////////////////////
 // Blocker 
 TBlocker::TBlocker() {
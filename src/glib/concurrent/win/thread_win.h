@@ -50,6 +50,28 @@ public:
 	void Leave();
 };
 
+////////////////////////////////////////////
+// Read-write lock
+// many threads can hold it for reading or one for writing,
+// the same thread must not enter it more than once
+class TRWLock {
+private:
+	SRWLOCK RWLock;
+
+	UndefCopyAssign(TRWLock);
+public:
+	TRWLock();
+
+	// start of shared (read) access
+	void EnterRead();
+	// end of shared (read) access
+	void LeaveRead();
+	// start of exclusive (write) access
+	void EnterWrite();
+	// end of exclusive (write) access
+	void LeaveWrite();
+};
+
 ////////////////////////////////////////////
 // Blocker 
 class TBlocker {
@@ -53,8 +53,8 @@ public:
 // given to TBtreeOps as the TLeafStore and TInternalStore template parameters.  In practice,
 // you don't have to actually derive your store implementation from IBtreeStore or anything of that sort.
 //
-// For examples of concrete node store implementations, see TBtreeNodeMemStore
-// and TBtreeNodeMemStore_Paranoid below.
+// For examples of concrete node store implementations, see TBtreeNodeMemStore,
+// TBtreeNodeMemStore_Paranoid and TBtreeNodeDiskStore below.
 //
 // The store has to support the following operations:
 // - AllocNode/FreeNode
@@ -1096,6 +1096,194 @@ public:
 			IAssert(nodes[node]->checkedOut == 0); }}
 };
 
+
+//----------------------------------------------------------------------------
+// TBtreeNodeDiskStore
+//----------------------------------------------------------------------------
+//
+// This store can keep the nodes in a blob base on disk, with only a bounded
+// LRU cache of nodes in memory.  Nodes are loaded into the cache on checkout;
+// a checked-out node is pinned so that the pointer given to the caller stays
+// valid even if the cache decides to evict it in the meantime.  Modified nodes
+// are written back to the blob base when evicted from the cache and on Flush/Save,
+// so only the node id -> blob pointer table is serialized with the store.
+//
+// A store created without a blob base keeps all nodes in memory and is serialized
+// in the same format as TBtreeNodeMemStore, so it can load streams saved by it.
+// Paged streams start with -1 in place of the node vector length.  After loading
+// a paged store, the blob base has to be attached using Open().
+
+template <typename TKey_, typename TDat_, typename TNodeId_>
+class TBtreeNodeDiskStore
+{
+public:
+	TCRef CRef;
+	typedef TKey_ TKey;
+	typedef TDat_ TDat;
+	typedef TNodeId_ TNodeId;
+	typedef TBtreeNode<TKey, TDat, TNodeId> TNode;
+	typedef TVec<TNodeId> TNodeIdV;
+
+protected:
+	class TNodeWrapper;
+	typedef TPt<TNodeWrapper> PNodeWrapper;
+	typedef TVec<PNodeWrapper> TNodeWrapperV;
+	class TNodeWrapper
+	{
+	private:
+		TCRef CRef;
+		friend class TPt<TNodeWrapper>;
+	public:
+		TNode node;
+		// true when the node was modified since it was last written to the blob base
+		bool dirty;
+		// memory footprint as accounted for in the cache
+		uint64 memUsed;
+		// number of check-outs not yet checked in
+		int checkOuts;
+		TNodeWrapper() : dirty(false), memUsed(0), checkOuts(0) { }
+		explicit TNodeWrapper(TSIn& SIn) : node(SIn), dirty(false), memUsed(0), checkOuts(0) { }
+		static PNodeWrapper Load(TSIn& SIn) { return new TNodeWrapper(SIn); }
+		void Save(TSOut& SOut) const { node.Save(SOut); }
+		uint64 GetMemUsed() const { return memUsed; }
+		// called by the cache on eviction and flush; writes the node back if modified
+		void OnDelFromCache(const TNodeId& nodeId, void* refToBs) {
+			if (! dirty) return;
+			((TBtreeNodeDiskStore *) refToBs)->StoreNode(nodeId, *this);
+			dirty = false; }
+	};
+
+	// memory mode: all the nodes
+	TNodeWrapperV nodes;
+	TNodeIdV freeNodes;
+	// paged mode: node id -> location in the blob base (empty if not yet written)
+	TVec<TBlobPt> nodeBlobPts;
+	PBlobBs blobBs;
+	TCache<TNodeId, PNodeWrapper> nodeCache;
+	// nodes currently checked out; they stay valid even if evicted from the cache
+	THash<TNodeId, PNodeWrapper> checkedOut;
+	bool paged;
+
+	void StoreNode(const TNodeId& nodeId, const TNodeWrapper& w) {
+		IAssertR(! blobBs.Empty(), "B-tree node store has no blob base attached");
+		TMOut MOut; w.Save(MOut);
+		TBlobPt& blobPt = nodeBlobPts[nodeId];
+		if (blobPt.Empty()) blobPt = blobBs->PutBlob(MOut.GetSIn());
+		else { int releasedSize; blobPt = blobBs->PutBlob(blobPt, MOut.GetSIn(), releasedSize); }}
+
+	// adds a node to the cache, possibly evicting the least recently used ones
+	void CacheNode(const TNodeId& nodeId, const PNodeWrapper& w) {
+		typedef typename TNode::TKd TKd;
+		w->memUsed = sizeof(TNodeWrapper) + w->node.v.Reserved() * sizeof(TKd);
+		nodeCache.Put(nodeId, w); }
+
+public:
+
+	// Creates a store which keeps all the nodes in memory.
+	TBtreeNodeDiskStore() : nodeCache(0, 1024, this), paged(false) { }
+	// Creates a store which keeps the nodes in the given blob base and at most
+	// about CacheSize bytes of nodes in memory.
+	TBtreeNodeDiskStore(const PBlobBs& BlobBs, const uint64& CacheSize) :
+		blobBs(BlobBs), nodeCache(CacheSize, 1024, this), paged(true) { }
+	TBtreeNodeDiskStore(TSIn& SIn) : nodeCache(0, 1024, this), paged(false) {
+		int nNodes; SIn.Load(nNodes);
+		if (nNodes == -1) {
+			paged = true;
+			nodeBlobPts.Load(SIn); freeNodes.Load(SIn);
+			uint64 cacheSize; SIn.Load(cacheSize);
+			nodeCache.PutMxMemUsed(cacheSize); }
+		else {
+			// same format as TVec::Save; we already consumed its capacity
+			SIn.Load(nNodes); nodes.Gen(nNodes);
+			for (int node = 0; node < nNodes; node++) nodes[node] = PNodeWrapper(SIn);
+			freeNodes.Load(SIn); }}
+	static TPt<TBtreeNodeDiskStore> Load(TSIn &SIn) { return new TBtreeNodeDiskStore(SIn); }
+	// Writes the modified nodes to the blob base and saves the node table.
+	void Save(TSOut &SOut) {
+		if (! paged) { nodes.Save(SOut); freeNodes.Save(SOut); return; }
+		Flush(); SOut.Save(int(-1));
+		nodeBlobPts.Save(SOut); freeNodes.Save(SOut);
+		SOut.Save(uint64(nodeCache.GetMxMemUsed())); }
+
+	// Attaches the blob base to a store loaded from a stream.
+	void Open(const PBlobBs& BlobBs) { IAssert(paged); blobBs = BlobBs; }
+	bool IsPaged() const { return paged; }
+	// Writes all the modified cached nodes to the blob base.
+	void Flush() { if (paged) nodeCache.Flush(); }
+	// Number of nodes currently held in memory.
+	int GetCachedNodes() const { return paged ? nodeCache.Len() : nodes.Len() - freeNodes.Len(); }
+
+	TNodeId AllocNode() {
+		TNodeId node;
+		if (! paged) {
+			if (freeNodes.Empty()) node = nodes.Add();
+			else { node = freeNodes.Last(); freeNodes.DelLast(); Assert(nodes[node].Empty()); }
+			nodes[node] = new TNodeWrapper();
+			return node; }
+		if (freeNodes.Empty()) node = nodeBlobPts.Add();
+		else { node = freeNodes.Last(); freeNodes.DelLast(); Assert(nodeBlobPts[node].Empty()); }
+		PNodeWrapper w = new TNodeWrapper(); w->dirty = true;
+		CacheNode(node, w);
+		return node; }
+
+	void FreeNode(const TNodeId& nodeId) {
+		Assert(nodeId >= 0); Assert(! checkedOut.IsKey(nodeId));
+		if (! paged) {
+			IAssert(nodeId < nodes.Len()); Assert(! nodes[nodeId].Empty());
+			nodes[nodeId] = 0; }
+		else {
+			IAssert(nodeId < nodeBlobPts.Len());
+			nodeCache.Del(nodeId, false);
+			TBlobPt& blobPt = nodeBlobPts[nodeId];
+			if (! blobPt.Empty()) { blobBs->DelBlob(blobPt); blobPt = TBlobPt(); }}
+		freeNodes.Add(nodeId); }
+
+	TNode *CheckOutNode(const TNodeId& nodeId)
+	{
+		Assert(nodeId >= 0);
+		if (! paged) { Assert(nodeId < nodes.Len()); Assert(! nodes[nodeId].Empty()); return &nodes[nodeId]->node; }
+		IAssert(nodeId < nodeBlobPts.Len());
+		// a checked out node may have been evicted from the cache, but it is
+		// still the current copy of the node
+		PNodeWrapper w;
+		if (! checkedOut.IsKeyGetDat(nodeId, w) && ! nodeCache.Get(nodeId, w)) {
+			w = TNodeWrapper::Load(*blobBs->GetBlob(nodeBlobPts[nodeId]));
+			CacheNode(nodeId, w); }
+		if (w->checkOuts++ == 0) checkedOut.AddDat(nodeId, w);
+		return &w->node;
+	}
+
+	void CheckInNode(const TNodeId& nodeId, TNode *node, bool dirty)
+	{
+		if (! paged) { Assert(nodeId >= 0); Assert(nodeId < nodes.Len()); Assert(! nodes[nodeId].Empty()); return; }
+		const int keyId = checkedOut.GetKeyId(nodeId); IAssert(keyId != -1);
+		PNodeWrapper w = checkedOut[keyId];
+		Assert(&w->node == node);
+		if (--w->checkOuts == 0) checkedOut.DelKeyId(keyId);
+		if (dirty) {
+			// re-add to the cache, so that it accounts for the new size of the node
+			w->dirty = true; nodeCache.Del(nodeId, false); CacheNode(nodeId, w); }
+		else {
+			// move to the front of the LRU list, or back into the cache if it was
+			// evicted while checked out
+			nodeCache.Put(nodeId, w); }
+	}
+
+	void Clr() {
+		IAssert(checkedOut.Empty());
+		nodes.Clr(); freeNodes.Clr();
+		if (! paged) return;
+		TNodeIdV cachedNodes; TNodeId nodeId; PNodeWrapper w;
+		void *keyDatP = nodeCache.FFirstKeyDat();
+		while (nodeCache.FNextKeyDat(keyDatP, nodeId, w)) cachedNodes.Add(nodeId);
+		for (int i = 0; i < cachedNodes.Len(); i++) nodeCache.Del(cachedNodes[i], false);
+		for (int i = 0; i < nodeBlobPts.Len(); i++) {
+			if (! nodeBlobPts[i].Empty()) blobBs->DelBlob(nodeBlobPts[i]); }
+		nodeBlobPts.Clr(); }
+
+	void IAssertNoCheckouts() { IAssert(checkedOut.Empty()); }
+};
+
 }
 
 #endif // ____BTREE_H_INCLUDED____
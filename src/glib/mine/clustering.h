@@ -291,12 +291,21 @@ protected:
             const bool& AllowEmptyP=true, const int& MaxIter=10000,
             const TWPt<TNotify>& Notify = TNotify::NullNotify()) = 0;
 
-    /// can still optimize
+    /// recomputes the centroids as means of the assigned instances (including the old
+    /// centroid), reselects empty clusters if they are not allowed
     template<class TDataType>
-    void UpdateCentroids(const TDataType& FtrVV, const int& NInst, TIntV& AssignV,
-            const TFltV& OnesN, const TIntV& RangeN, TFltV& TempK, TCentroidType& TempDxKV,
-            TCentroidType& TempDxKV2, TVec<TIntFltKdV>& TempKxKSpVV, const TFltV& NormX2,
+    void UpdateCentroids(const TDataType& FtrVV, TIntV& AssignV, const TFltV& NormX2,
             TFltV& NormC2, const bool& AllowEmptyP);
+    /// computes CentroidVV = (CentroidVV*diag(CentWgtV) + FtrVV*AssignMat)*diag(NormV), where
+    /// AssignMat is the n x k indicator matrix of AssignV; dense centroids are accumulated
+    /// in parallel, each thread summing its instances into its own partial sum matrix,
+    /// sparse centroids are summed in parallel one centroid per thread
+    template<class TDataType>
+    static void UpdateCentroidVV(const TDataType& FtrVV, const TIntV& AssignV,
+            const TFltV& CentWgtV, const TFltV& NormV, TFltVV& CentroidVV);
+    template<class TDataType>
+    static void UpdateCentroidVV(const TDataType& FtrVV, const TIntV& AssignV,
+            const TFltV& CentWgtV, const TFltV& NormV, TVec<TIntFltKdV>& CentroidVV);
 
     template<class TDataType>
     void SelectInitCentroids(const TDataType& FtrVV, const int& K, const int& NInst);
@@ -305,6 +314,15 @@ protected:
 
     template<class TDataType>
     inline void Assign(const TDataType& FtrVV, const TFltV& NormX2, const TFltV& NormC2, TIntV& AssignV) const;
+    /// assigns the instances to their nearest centroids, the instances are split into
+    /// blocks of AssignBlockSize columns which are processed in parallel; MnDistV
+    /// holds the quasi-distance of each instance to its centroid
+    template<class TDataType>
+    void AssignBlocked(const TDataType& FtrVV, const TFltV& NormX2, const TFltV& NormC2,
+            TIntV& AssignV, TFltV& MnDistV) const;
+
+    /// returns the number of threads used to process NInst instances in blocks
+    static int GetBlockThreads(const int& NInst);
 
     /// methods that return the number of examples in the input data
     static int GetDataCount(const TFltVV& X);
@@ -320,8 +338,28 @@ protected:
     /// get column/cluster of the matrix
     static void GetCol(const TFltVV& FtrVV, const int& ColN, TFltV& Col);
     static void GetCol(const TVec<TIntFltKdV>& FtrVV, const int& ColN, TIntFltKdV& Col);
+    /// get the columns MnColN...MxColN-1 of the matrix
+    static void GetColBlock(const TFltVV& FtrVV, const int& MnColN, const int& MxColN, TFltVV& BlockVV);
+    static void GetColBlock(const TVec<TIntFltKdV>& FtrVV, const int& MnColN, const int& MxColN,
+            TVec<TIntFltKdV>& BlockVV);
+    /// get the columns with the given indexes
+    static void GetCols(const TFltVV& FtrVV, const TIntV& ColNV, TFltVV& ColVV);
+    static void GetCols(const TVec<TIntFltKdV>& FtrVV, const TIntV& ColNV, TVec<TIntFltKdV>& ColVV);
+    /// adds the column of the matrix to a column of the dense matrix
+    static void AddToCol(const TFltVV& FtrVV, const int& ColN, const int& DstColN, TFltVV& DstVV);
+    static void AddToCol(const TVec<TIntFltKdV>& FtrVV, const int& ColN, const int& DstColN, TFltVV& DstVV);
+    /// appends the non-zero elements of the column to the sparse vector
+    static void AppendCol(const TFltVV& FtrVV, const int& ColN, TIntFltKdV& DstV);
+    static void AppendCol(const TVec<TIntFltKdV>& FtrVV, const int& ColN, TIntFltKdV& DstV);
+
+    /// number of instances in one unit of parallel work
+    static const int AssignBlockSize;
 
 private:
+    template<class TDataType>
+    void AssignBlock(const TDataType& BlockVV, const TFltV& BlockNormX2, const TFltV& NormC2,
+            const int& FirstInstN, TIntV& AssignV, TFltV& MnDistV) const;
+
     inline void SelectRndCentroid(const TFltVV& FtrVV, const int& CentroidN);
     inline void SelectRndCentroid(const TVec<TIntFltKdV>& FtrVV, const int& CentroidN);
 
@@ -357,6 +395,12 @@ public:
     // saves the model to the output stream
     void Save(TSOut& SOut) const;
 
+    /// sets the number of instances sampled in each iteration, when set (> 0) the centroids
+    /// are updated from mini-batches instead of the whole dataset; not saved with the model
+    void SetBatchSize(const int& _BatchSize) { BatchSize = _BatchSize; }
+    /// returns the mini-batch size, 0 when the whole dataset is used in each iteration
+    int GetBatchSize() const { return BatchSize; }
+
 protected:
     void VirtApply(const TFltVV& FtrVV, const TFltVV& InitCentVV,
             const bool& AllowEmptyP=true, const int& MaxIter=10000,
@@ -378,8 +422,14 @@ private:
     void VirtApply(const TDataType& FtrVV, const TInitCentroidType& InitCentVV,
             const int& NInst, const int& Dim, const bool& AllowEmptyP, const int& MaxIter,
             const TWPt<TNotify>& Notify);
+    /// runs MaxIter iterations, each moving the centroids towards the means of a
+    /// random sample of BatchSize instances
+    template<class TDataType>
+    void MiniBatchApply(const TDataType& FtrVV, const int& NInst, const int& MaxIter,
+            const TWPt<TNotify>& Notify);
 
     const TInt K;
+    TInt BatchSize {0};
 };
 
 ///////////////////////////////////////////
@@ -425,8 +475,7 @@ private:
             const TWPt<TNotify>& Notify);
 
     template <class TDataType>
-    inline void AddCentroid(const TDataType& FtrVV, TFltVV& ClustDistVV, TFltV& NormC2,
-        TFltV& TempK, TCentroidType& TempDxK, TCentroidType& TempDxK2, const int& InstN);
+    inline void AddCentroid(const TDataType& FtrVV, const int& InstN);
 };
 
 // typedefs
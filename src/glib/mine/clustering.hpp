@@ -231,8 +231,9 @@ namespace TClustering {
     template <class TCentroidType>
     template <class TMatType>
     void TAbsKMeans<TCentroidType>::Assign(const TMatType& FtrVV, TIntV& AssignV) const {
-        TFltVV DistVV;	Dist->GetQuasiDistVV(CentroidVV, FtrVV, DistVV);
-        TLinAlgSearch::GetColMinIdxV(DistVV, AssignV);
+        TFltV NormX2;   Dist->UpdateXLenDistHelpV(FtrVV, NormX2);
+        TFltV NormC2;   Dist->UpdateCLenDistHelpV(CentroidVV, NormC2);
+        Assign(FtrVV, NormX2, NormC2, AssignV);
     }
 
     template<class TCentroidType>
@@ -291,31 +292,29 @@ namespace TClustering {
 
     template<class TCentroidType>
     template<class TDataType>
-    void TAbsKMeans<TCentroidType>::UpdateCentroids(const TDataType& FtrVV, const int& NInst,
-            TIntV& AssignV, const TFltV& OnesN, const TIntV& RangeN, TFltV& TempK,
-            TCentroidType& TempDxKV, TCentroidType& TempDxKV2, TVec<TIntFltKdV>& TempKxKSpVV,
+    void TAbsKMeans<TCentroidType>::UpdateCentroids(const TDataType& FtrVV, TIntV& AssignV,
             const TFltV& XLenDistHelpV, TFltV& CLenDistHelpV, const bool& AllowEmptyP) {
 
         const int K = GetDataCount(CentroidVV);
+        const int NInst = AssignV.Len();
 
-        // I. create a sparse matrix (coordinate representation) that encodes the closest centroids
-        TSparseColMatrix AssignMat(NInst, K);
+        TFltV CountV(K);
 
         bool ExistsEmpty;
         int LoopN = 0;
         do {
             ExistsEmpty = false;
 
-            TSparseOps<TInt, TFlt>::CoordinateCreateSparseColMatrix(RangeN, AssignV, OnesN, AssignMat.ColSpVV, K);
-
-            // II. compute the number of points that belong to each centroid, invert
-            AssignMat.MultiplyT(OnesN, TempK);
+            // I. compute the number of points that belong to each centroid
+            CountV.PutAll(0);
+            for (int InstN = 0; InstN < NInst; InstN++) {
+                CountV[AssignV[InstN]] += 1;
+            }
 
-            // invert
+            // II. check if a cluster is empty, if we don't allow empty clusters, select a
+            // random point as the centroid
             for (int ClustN = 0; ClustN < K; ClustN++) {
-                // check if the cluster is empty, if we don't allow empty clusters, select a
-                // random point as the centroid
-                if (TempK[ClustN] == 0.0 && !AllowEmptyP) {	// don't allow empty clusters
+                if (CountV[ClustN] == 0.0 && !AllowEmptyP) {	// don't allow empty clusters
                     // select a random point and create a new centroid from it
                     SelectRndCentroid(FtrVV, ClustN);
                     Dist->UpdateCLenDistHelpV(CentroidVV, CLenDistHelpV);
@@ -323,20 +322,105 @@ namespace TClustering {
                     ExistsEmpty = true;
                     break;
                 }
-                TempK[ClustN] = 1.0 / (TempK[ClustN] + 1.0);
             }
         } while (ExistsEmpty && ++LoopN < 10);
 
         // III. compute the centroids
-        // compute: CentroidMat = ((FtrVV * AssignIdxMat) + CentroidMat) * ColSumDiag;
-        TLinAlgTransform::Diag(TempK, TempKxKSpVV);
+        // compute: CentroidMat = ((FtrVV * AssignIdxMat) + CentroidMat) * diag(1 / (CountV + 1))
+        TFltV CentWgtV(K);  CentWgtV.PutAll(1);
+        TFltV NormV(K);
+        for (int ClustN = 0; ClustN < K; ClustN++) {
+            NormV[ClustN] = 1.0 / (CountV[ClustN] + 1.0);
+        }
+        UpdateCentroidVV(FtrVV, AssignV, CentWgtV, NormV, CentroidVV);
+    }
 
-        // 1) FtrVV * AssignIdxMat
-        TLinAlg::Multiply(FtrVV, AssignMat.ColSpVV, TempDxKV);
-        // 2) (FtrVV * AssignIdxMat) + CentroidMat
-        TLinAlg::LinComb(1, TempDxKV, 1, CentroidVV, TempDxKV2);
-        // 3) ((FtrVV * AssignIdxMat) + CentroidMat) * ColSumDiag
-        TLinAlg::Multiply(TempDxKV2, TempKxKSpVV, CentroidVV);
+    template<class TCentroidType>
+    template<class TDataType>
+    void TAbsKMeans<TCentroidType>::UpdateCentroidVV(const TDataType& FtrVV, const TIntV& AssignV,
+            const TFltV& CentWgtV, const TFltV& NormV, TFltVV& CentroidVV) {
+        const int Dim = CentroidVV.GetRows();
+        const int K = CentroidVV.GetCols();
+        const int NInst = AssignV.Len();
+        const int Blocks = (NInst + AssignBlockSize - 1) / AssignBlockSize;
+        const int Threads = GetBlockThreads(NInst);
+
+        // each thread sums its instances into its own d x k matrix, the blocks are
+        // distributed statically so the summation order only depends on the thread count
+        TVec<TFltVV> PartSumVV(Threads);
+        #pragma omp parallel num_threads(Threads) if (Threads > 1)
+        {
+#ifdef GLib_OPENMP
+            TFltVV& SumVV = PartSumVV[omp_get_thread_num()];
+#else
+            TFltVV& SumVV = PartSumVV[0];
+#endif
+            SumVV.Gen(Dim, K);
+            #pragma omp for schedule(static)
+            for (int BlockN = 0; BlockN < Blocks; BlockN++) {
+                const int MnInstN = BlockN * AssignBlockSize;
+                const int MxInstN = TInt::GetMn(MnInstN + AssignBlockSize, NInst);
+                for (int InstN = MnInstN; InstN < MxInstN; InstN++) {
+                    AddToCol(FtrVV, InstN, AssignV[InstN], SumVV);
+                }
+            }
+        }
+
+        // merge the partial sums into the centroids
+        for (int ClustN = 0; ClustN < K; ClustN++) {
+            const double Wgt = CentWgtV[ClustN];
+            const double Norm = NormV[ClustN];
+            for (int RowN = 0; RowN < Dim; RowN++) {
+                double Sum = Wgt * CentroidVV(RowN, ClustN);
+                for (int ThreadN = 0; ThreadN < Threads; ThreadN++) {
+                    Sum += PartSumVV[ThreadN](RowN, ClustN);
+                }
+                CentroidVV(RowN, ClustN) = Sum * Norm;
+            }
+        }
+    }
+
+    template<class TCentroidType>
+    template<class TDataType>
+    void TAbsKMeans<TCentroidType>::UpdateCentroidVV(const TDataType& FtrVV, const TIntV& AssignV,
+            const TFltV& CentWgtV, const TFltV& NormV, TVec<TIntFltKdV>& CentroidVV) {
+        const int K = CentroidVV.Len();
+        const int NInst = AssignV.Len();
+        const int Threads = TInt::GetMn(GetBlockThreads(NInst), K);
+
+        // group the instances by their centroids
+        TVec<TIntV> ClustInstNVV(K);
+        for (int InstN = 0; InstN < NInst; InstN++) {
+            ClustInstNVV[AssignV[InstN]].Add(InstN);
+        }
+
+        // the centroids are independent, each one is summed by a single thread
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(Threads) if (Threads > 1)
+        for (int ClustN = 0; ClustN < K; ClustN++) {
+            const TIntV& InstNV = ClustInstNVV[ClustN];
+            // collect the elements of all the instances and sum the ones with equal keys
+            TIntFltKdV ElV;
+            for (int InstNN = 0; InstNN < InstNV.Len(); InstNN++) {
+                AppendCol(FtrVV, InstNV[InstNN], ElV);
+            }
+            ElV.Sort();
+            TIntFltKdV SumV;
+            for (int ElN = 0; ElN < ElV.Len(); ElN++) {
+                if (!SumV.Empty() && SumV.Last().Key == ElV[ElN].Key) {
+                    SumV.Last().Dat += ElV[ElN].Dat;
+                } else {
+                    SumV.Add(ElV[ElN]);
+                }
+            }
+            // (CentroidMat * diag(CentWgtV) + FtrVV * AssignIdxMat) * diag(NormV)
+            TIntFltKdV& CentroidV = CentroidVV[ClustN];
+            TIntFltKdV NewCentroidV;
+            TSparseOps<TInt, TFlt>::SparseLinComb(CentWgtV[ClustN], CentroidV, 1, SumV, NewCentroidV);
+            for (int ElN = 0; ElN < NewCentroidV.Len(); ElN++) {
+                NewCentroidV[ElN].Dat *= NormV[ClustN];
+            }
+            CentroidV = NewCentroidV;
+        }
     }
 
     template<class TCentroidType>
@@ -460,8 +544,71 @@ namespace TClustering {
     template<class TDataType>
     inline void TAbsKMeans<TCentroidType>::Assign(const TDataType& FtrVV, const TFltV& NormX2, const TFltV& NormC2,
         TIntV& AssignV) const {
-        TFltVV DistVV;	Dist->GetQuasiDistVV(CentroidVV, FtrVV, NormC2, NormX2, DistVV);
-        TLinAlgSearch::GetColMinIdxV(DistVV, AssignV);
+        TFltV MnDistV;  AssignBlocked(FtrVV, NormX2, NormC2, AssignV, MnDistV);
+    }
+
+    template<class TCentroidType>
+    template<class TDataType>
+    void TAbsKMeans<TCentroidType>::AssignBlocked(const TDataType& FtrVV, const TFltV& NormX2,
+            const TFltV& NormC2, TIntV& AssignV, TFltV& MnDistV) const {
+        const int NInst = GetDataCount(FtrVV);
+        const int Blocks = (NInst + AssignBlockSize - 1) / AssignBlockSize;
+
+        if (AssignV.Len() != NInst) { AssignV.Gen(NInst); }
+        if (MnDistV.Len() != NInst) { MnDistV.Gen(NInst); }
+
+        // no need to copy the instances when there is only one block
+        if (Blocks <= 1) {
+            AssignBlock(FtrVV, NormX2, NormC2, 0, AssignV, MnDistV);
+            return;
+        }
+
+        const int Threads = GetBlockThreads(NInst);
+        PExcept Except;
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(Threads) if (Threads > 1)
+        for (int BlockN = 0; BlockN < Blocks; BlockN++) {
+            const int MnInstN = BlockN * AssignBlockSize;
+            const int MxInstN = TInt::GetMn(MnInstN + AssignBlockSize, NInst);
+            try {
+                TDataType BlockVV;  GetColBlock(FtrVV, MnInstN, MxInstN, BlockVV);
+                TFltV BlockNormX2;
+                if (!NormX2.Empty()) { NormX2.GetSubValV(MnInstN, MxInstN - 1, BlockNormX2); }
+                AssignBlock(BlockVV, BlockNormX2, NormC2, MnInstN, AssignV, MnDistV);
+            } catch (PExcept& _Except) {
+                #pragma omp critical(TKMeansExcept)
+                if (Except.Empty()) { Except = _Except; }
+            }
+        }
+        // rethrow first exception
+        if (!Except.Empty()) { throw Except; }
+    }
+
+    template<class TCentroidType>
+    template<class TDataType>
+    void TAbsKMeans<TCentroidType>::AssignBlock(const TDataType& BlockVV, const TFltV& BlockNormX2,
+            const TFltV& NormC2, const int& FirstInstN, TIntV& AssignV, TFltV& MnDistV) const {
+        // distances between the centroids and the instances of the block (dimension k x b)
+        TFltVV DistVV;  Dist->GetQuasiDistVV(CentroidVV, BlockVV, NormC2, BlockNormX2, DistVV);
+        const int Cols = DistVV.GetCols();
+        for (int ColN = 0; ColN < Cols; ColN++) {
+            const int ClustN = TLinAlgSearch::GetColMinIdx(DistVV, ColN);
+            AssignV[FirstInstN + ColN] = ClustN;
+            MnDistV[FirstInstN + ColN] = DistVV(ClustN, ColN);
+        }
+    }
+
+    template<class TCentroidType>
+    const int TAbsKMeans<TCentroidType>::AssignBlockSize = 1024;
+
+    template<class TCentroidType>
+    int TAbsKMeans<TCentroidType>::GetBlockThreads(const int& NInst) {
+#ifdef GLib_OPENMP
+        // not worth the overhead when there are only a few blocks
+        const int Blocks = (NInst + AssignBlockSize - 1) / AssignBlockSize;
+        return TInt::GetMx(TInt::GetMn(omp_get_max_threads(), Blocks), 1);
+#else
+        return 1;
+#endif
     }
 
     template<class TCentroidType>
@@ -517,6 +664,76 @@ namespace TClustering {
         Col = FtrVV[ColN];
     }
 
+    template <class TCentroidType>
+    void TAbsKMeans<TCentroidType>::AppendCol(const TFltVV& FtrVV, const int& ColN, TIntFltKdV& DstV) {
+        const int Rows = FtrVV.GetRows();
+        for (int RowN = 0; RowN < Rows; RowN++) {
+            const double Val = FtrVV(RowN, ColN);
+            if (Val != 0.0) { DstV.Add(TIntFltKd(RowN, Val)); }
+        }
+    }
+
+    template <class TCentroidType>
+    void TAbsKMeans<TCentroidType>::AppendCol(const TVec<TIntFltKdV>& FtrVV, const int& ColN, TIntFltKdV& DstV) {
+        DstV.AddV(FtrVV[ColN]);
+    }
+
+    template <class TCentroidType>
+    void TAbsKMeans<TCentroidType>::GetColBlock(const TFltVV& FtrVV, const int& MnColN,
+            const int& MxColN, TFltVV& BlockVV) {
+        const int Rows = FtrVV.GetRows();
+        BlockVV.Gen(Rows, MxColN - MnColN);
+        for (int ColN = MnColN; ColN < MxColN; ColN++) {
+            for (int RowN = 0; RowN < Rows; RowN++) {
+                BlockVV(RowN, ColN - MnColN) = FtrVV(RowN, ColN);
+            }
+        }
+    }
+
+    template <class TCentroidType>
+    void TAbsKMeans<TCentroidType>::GetColBlock(const TVec<TIntFltKdV>& FtrVV, const int& MnColN,
+            const int& MxColN, TVec<TIntFltKdV>& BlockVV) {
+        FtrVV.GetSubValV(MnColN, MxColN - 1, BlockVV);
+    }
+
+    template <class TCentroidType>
+    void TAbsKMeans<TCentroidType>::GetCols(const TFltVV& FtrVV, const TIntV& ColNV, TFltVV& ColVV) {
+        const int Rows = FtrVV.GetRows();
+        ColVV.Gen(Rows, ColNV.Len());
+        for (int ColN = 0; ColN < ColNV.Len(); ColN++) {
+            for (int RowN = 0; RowN < Rows; RowN++) {
+                ColVV(RowN, ColN) = FtrVV(RowN, ColNV[ColN]);
+            }
+        }
+    }
+
+    template <class TCentroidType>
+    void TAbsKMeans<TCentroidType>::GetCols(const TVec<TIntFltKdV>& FtrVV, const TIntV& ColNV,
+            TVec<TIntFltKdV>& ColVV) {
+        ColVV.Gen(ColNV.Len());
+        for (int ColN = 0; ColN < ColNV.Len(); ColN++) {
+            ColVV[ColN] = FtrVV[ColNV[ColN]];
+        }
+    }
+
+    template <class TCentroidType>
+    void TAbsKMeans<TCentroidType>::AddToCol(const TFltVV& FtrVV, const int& ColN,
+            const int& DstColN, TFltVV& DstVV) {
+        const int Rows = FtrVV.GetRows();
+        for (int RowN = 0; RowN < Rows; RowN++) {
+            DstVV(RowN, DstColN) += FtrVV(RowN, ColN);
+        }
+    }
+
+    template <class TCentroidType>
+    void TAbsKMeans<TCentroidType>::AddToCol(const TVec<TIntFltKdV>& FtrVV, const int& ColN,
+            const int& DstColN, TFltVV& DstVV) {
+        const TIntFltKdV& FtrV = FtrVV[ColN];
+        for (int ElN = 0; ElN < FtrV.Len(); ElN++) {
+            DstVV(FtrV[ElN].Key, DstColN) += FtrV[ElN].Dat;
+        }
+    }
+
 
     ////////////////////////////////////////
     /// K-Means
@@ -592,17 +809,11 @@ namespace TClustering {
         TIntV* Temp;
 
         // constant reused variables
-        TFltV OnesN;			TLinAlgTransform::OnesV(NInst, OnesN);
         TFltV XLenDistHelpV;	TBase::Dist->UpdateXLenDistHelpV(FtrVV, XLenDistHelpV);
-        TIntV RangeN(NInst);	TLinAlgTransform::RangeV(NInst, RangeN);
 
         // reused variables
-        TFltVV ClustDistVV(K, NInst);		// (dimension k x n)
         TFltV CLenDistHelpV(K);
-        TFltV TempK(K);						// (dimension k)
-        TCentroidType TempDxK;				// (dimension d x k)
-        TCentroidType TempDxK2;				// (dimension d x k)
-        TVec<TIntFltKdV> TempKxKSpVV(K);	// (dimension k x k)
+        TFltV MnDistV(NInst);				// (dimension n)
 
         // select initial centroids
         if (InitCentroidVV.Empty()) {
@@ -613,46 +824,89 @@ namespace TClustering {
             TBase::SelectInitCentroids(InitCentroidVV);
         }
 
-        // do the work
+        if (0 < BatchSize && BatchSize < NInst) {
+            MiniBatchApply(FtrVV, NInst, MaxIter, Notify);
+        }
+        else {
+            // do the work
+            for (int IterN = 0; IterN < MaxIter; IterN++) {
+                if (IterN % 100 == 0) { Notify->OnNotifyFmt(TNotifyType::ntInfo, "%d", IterN); }
+
+                // get the distance of each of the points to each of the centroids
+                // and assign the instances
+                TBase::Dist->UpdateCLenDistHelpV(TBase::CentroidVV, CLenDistHelpV);
+                TBase::AssignBlocked(FtrVV, XLenDistHelpV, CLenDistHelpV, *AssignIdxVPtr, MnDistV);
+
+                // if the assignment hasn't changed then terminate the loop
+                if (*AssignIdxVPtr == *OldAssignIdxVPtr) {
+                    Notify->OnNotifyFmt(TNotifyType::ntInfo, "Converged at iteration: %d", IterN);
+                    break;
+                }
+
+                // recompute the means
+                TBase::UpdateCentroids(FtrVV, *AssignIdxVPtr, XLenDistHelpV, CLenDistHelpV, AllowEmptyP);
+
+                // swap the old and new assign vectors
+                Temp = AssignIdxVPtr;
+                AssignIdxVPtr = OldAssignIdxVPtr;
+                OldAssignIdxVPtr = Temp;
+            }
+        }
+
+        EAssertR(!TLinAlgCheck::ContainsNan(TBase::CentroidVV), "TDnsKMeans<TCentroidType>::Apply: Found NaN in the centroids!");
+    }
+
+    template<class TCentroidType>
+    template<class TDataType>
+    void TDnsKMeans<TCentroidType>::MiniBatchApply(const TDataType& FtrVV, const int& NInst,
+            const int& MaxIter, const TWPt<TNotify>& Notify) {
+        Notify->OnNotifyFmt(TNotifyType::ntInfo, "Using mini-batches of %d instances ...", (int)BatchSize);
+
+        // number of instances that contributed to each of the centroids so far
+        TFltV ClustCountV(K);
+
+        // reused variables
+        TIntV BatchInstNV(BatchSize);
+        TDataType BatchVV;
+        TFltV BatchXLenDistHelpV;
+        TFltV CLenDistHelpV(K);
+        TIntV AssignIdxV(BatchSize);
+        TFltV MnDistV(BatchSize);
+        TFltV BatchCountV(K);
+        TFltV CentWgtV(K);
+        TFltV NormV(K);
+
         for (int IterN = 0; IterN < MaxIter; IterN++) {
             if (IterN % 100 == 0) { Notify->OnNotifyFmt(TNotifyType::ntInfo, "%d", IterN); }
 
-            // get the distance of each of the points to each of the centroids
-            // and assign the instances
+            // sample the batch and assign it
+            for (int InstN = 0; InstN < BatchSize; InstN++) {
+                BatchInstNV[InstN] = TBase::Rnd.GetUniDevInt(NInst);
+            }
+            TBase::GetCols(FtrVV, BatchInstNV, BatchVV);
+            TBase::Dist->UpdateXLenDistHelpV(BatchVV, BatchXLenDistHelpV);
             TBase::Dist->UpdateCLenDistHelpV(TBase::CentroidVV, CLenDistHelpV);
-            TBase::Dist->GetQuasiDistVV(TBase::CentroidVV, FtrVV, CLenDistHelpV, XLenDistHelpV, ClustDistVV);
+            TBase::AssignBlocked(BatchVV, BatchXLenDistHelpV, CLenDistHelpV, AssignIdxV, MnDistV);
 
-            TLinAlgSearch::GetColMinIdxV(ClustDistVV, *AssignIdxVPtr);
-
-            // if the assignment hasn't changed then terminate the loop
-            if (*AssignIdxVPtr == *OldAssignIdxVPtr) {
-                Notify->OnNotifyFmt(TNotifyType::ntInfo, "Converged at iteration: %d", IterN);
-                break;
+            // each centroid becomes the mean of all the instances assigned to it so far:
+            // c = (n_old*c + sum(batch)) / (n_old + n_batch)
+            BatchCountV.PutAll(0);
+            for (int InstN = 0; InstN < BatchSize; InstN++) {
+                BatchCountV[AssignIdxV[InstN]] += 1;
             }
-
-            // recompute the means
-            TBase::UpdateCentroids(
-                    FtrVV,
-                    NInst,
-                    *AssignIdxVPtr,
-                    OnesN,
-                    RangeN,
-                    TempK,
-                    TempDxK,
-                    TempDxK2,
-                    TempKxKSpVV,
-                    XLenDistHelpV,
-                    CLenDistHelpV,
-                    AllowEmptyP
-            );
-
-            // swap the old and new assign vectors
-            Temp = AssignIdxVPtr;
-            AssignIdxVPtr = OldAssignIdxVPtr;
-            OldAssignIdxVPtr = Temp;
+            for (int ClustN = 0; ClustN < K; ClustN++) {
+                if (BatchCountV[ClustN] == 0.0) {
+                    // no new instances, leave the centroid as it is
+                    CentWgtV[ClustN] = 1;
+                    NormV[ClustN] = 1;
+                } else {
+                    CentWgtV[ClustN] = ClustCountV[ClustN];
+                    ClustCountV[ClustN] += BatchCountV[ClustN];
+                    NormV[ClustN] = 1.0 / ClustCountV[ClustN];
+                }
+            }
+            TBase::UpdateCentroidVV(BatchVV, AssignIdxV, CentWgtV, NormV, TBase::CentroidVV);
         }
-
-        EAssertR(!TLinAlgCheck::ContainsNan(TBase::CentroidVV), "TDnsKMeans<TCentroidType>::Apply: Found NaN in the centroids!");
     }
 
     ////////////////////////////////////////
@@ -745,40 +999,28 @@ namespace TClustering {
         int K = TBase::GetDataCount(TBase::CentroidVV);
 
         // const variables, reused throughtout the procedure
-        TFltV OnesN;			TLinAlgTransform::OnesV(NInst, OnesN);
         TFltV NormX2;			TBase::Dist->UpdateXLenDistHelpV(FtrVV, NormX2);
-        TIntV RangeN(NInst);	TLinAlgTransform::RangeV(NInst, RangeN);
 
         // temporary reused variables
-        TFltV FtrV;							// (dimension d)
-        TFltV MinClustDistV;				// (dimension n)
-        TFltVV ClustDistVV(K, NInst);		// (dimension k x n)
+        TFltV MinClustDistV(NInst);			// (dimension n)
         TFltV NormC2(K);					// (dimension k)
-        TFltV TempK(K);						// (dimension k)
-        TCentroidType TempDxK;				// (dimension d x k)
-        TCentroidType TempDxK2;				// (dimension d x k)
-        TVec<TIntFltKdV> TempKxKSpVV(K);	// (dimension k x k)
 
         int IterN = 0;
         while (IterN++ < MaxIter) {
             if (IterN % 100 == 0) { Notify->OnNotifyFmt(TNotifyType::ntInfo, "%d", IterN); }
 
-            // compute the distance matrix to all the centroids and assignments
+            // compute the distances to all the centroids and assignments
             TBase::Dist->UpdateCLenDistHelpV(TBase::CentroidVV, NormC2);
-            TBase::Dist->GetQuasiDistVV(TBase::CentroidVV, FtrVV, NormC2, NormX2, ClustDistVV);
-            TLinAlgSearch::GetColMinIdxV(ClustDistVV, *AssignIdxVPtr);
+            TBase::AssignBlocked(FtrVV, NormX2, NormC2, *AssignIdxVPtr, MinClustDistV);
 
             // check if we need to increase the number of centroids
             if (K < MxClusts) {
-                TLinAlgSearch::GetColMinV(ClustDistVV, MinClustDistV);
-
                 const int NewCentroidN = TLinAlgSearch::GetMaxIdx(MinClustDistV);
                 const double MxDist = MinClustDistV[NewCentroidN];
 
                 if (MxDist > LambdaSq) {
                     K++;
-                    AddCentroid(FtrVV, ClustDistVV, NormC2, TempK, TempDxK, TempDxK2, NewCentroidN);
-                    TempKxKSpVV.Gen(K);
+                    AddCentroid(FtrVV, NewCentroidN);
                     (*AssignIdxVPtr)[NewCentroidN] = K - 1;
                     Notify->OnNotifyFmt(TNotifyType::ntInfo, "Max distance to centroid: %.3f, number of clusters: %d ...", TMath::Sqrt(MxDist), K);
                 }
@@ -791,19 +1033,7 @@ namespace TClustering {
             }
 
             // recompute the centroids
-            TBase::UpdateCentroids(FtrVV,
-                    NInst,
-                    *AssignIdxVPtr,
-                    OnesN,
-                    RangeN,
-                    TempK,
-                    TempDxK,
-                    TempDxK2,
-                    TempKxKSpVV,
-                    NormX2,
-                    NormC2,
-                    AllowEmptyP
-            );
+            TBase::UpdateCentroids(FtrVV, *AssignIdxVPtr, NormX2, NormC2, AllowEmptyP);
 
             // swap old and new assign vectors
             Temp = AssignIdxVPtr;
@@ -816,57 +1046,31 @@ namespace TClustering {
 
     template<>
     template<>
-    inline void TDpMeans<TFltVV>::AddCentroid(const TFltVV& FtrVV, TFltVV& ClustDistVV, TFltV& NormC2,
-            TFltV& TempK, TFltVV& TempDxK, TFltVV& TempDxK2, const int& InstN) {
+    inline void TDpMeans<TFltVV>::AddCentroid(const TFltVV& FtrVV, const int& InstN) {
         TFltV FtrV;  FtrVV.GetCol(InstN, FtrV);
 		this->CentroidVV.AddCol(FtrV); // access through 'this', otherwise MSVC complains; see https://stackoverflow.com/questions/4643074/why-do-i-have-to-access-template-base-class-members-through-the-this-pointer
-        ClustDistVV.AddXDim();
-        NormC2.Add(0);
-        TempK.Add(0);
-        TempDxK.AddYDim();
-        TempDxK2.AddYDim();
     }
 
     template<>
     template<>
-    inline void TDpMeans<TFltVV>::AddCentroid(const TVec<TIntFltKdV>& FtrVV, TFltVV& ClustDistVV,
-            TFltV& NormC2, TFltV& TempK, TFltVV& TempDxK, TFltVV& TempDxK2, const int& InstN) {
+    inline void TDpMeans<TFltVV>::AddCentroid(const TVec<TIntFltKdV>& FtrVV, const int& InstN) {
         TIntFltKdV FtrV; this->GetCol(FtrVV, InstN, FtrV);
         TFltV DenseFtrV; TLinAlgTransform::ToVec(FtrV, DenseFtrV, this->GetDataDim(FtrVV));
         this->CentroidVV.AddCol(DenseFtrV);
-        ClustDistVV.AddXDim();
-        NormC2.Add(0);
-        TempK.Add(0);
-        TempDxK.AddYDim();
-        TempDxK2.AddYDim();
     }
 
     template<>
     template<>
-    inline void TDpMeans<TVec<TIntFltKdV>>::AddCentroid(const TFltVV& FtrVV, TFltVV& ClustDistVV,
-            TFltV& NormC2, TFltV& TempK, TVec<TIntFltKdV>& TempDxK, TVec<TIntFltKdV>& TempDxK2,
-            const int& InstN) {
+    inline void TDpMeans<TVec<TIntFltKdV>>::AddCentroid(const TFltVV& FtrVV, const int& InstN) {
         TFltV FtrV; FtrVV.GetCol(InstN, FtrV);
         TIntFltKdV SparseFtrV; TLinAlgTransform::ToSpVec(FtrV, SparseFtrV);
         this->CentroidVV.Add(SparseFtrV);
-        ClustDistVV.AddXDim();
-        NormC2.Add(0);
-        TempK.Add(0);
-        TempDxK.Add(TIntFltKdV());
-        TempDxK2.Add(TIntFltKdV());
     }
 
     template<>
     template<>
-    inline void TDpMeans<TVec<TIntFltKdV>>::AddCentroid(const TVec<TIntFltKdV>& FtrVV,
-            TFltVV& ClustDistVV, TFltV& NormC2, TFltV& TempK, TVec<TIntFltKdV>& TempDxK,
-            TVec<TIntFltKdV>& TempDxK2, const int& InstN) {
+    inline void TDpMeans<TVec<TIntFltKdV>>::AddCentroid(const TVec<TIntFltKdV>& FtrVV, const int& InstN) {
         const TIntFltKdV& FtrV = FtrVV[InstN];
         this->CentroidVV.Add(FtrV);
-        ClustDistVV.AddXDim();
-        NormC2.Add(0);
-        TempK.Add(0);
-        TempDxK.Add(TIntFltKdV());
-        TempDxK2.Add(TIntFltKdV());
     }
 }
@@ -34,12 +34,16 @@ TStr TStemmer::GetStem(const TStr& WordStr, const bool& ToUcP){
 
   // get real word from stem
   if (bool(RealWordP)){
-    TStr RealWordStr;
-    if (StemStrToRealWordStrH.IsKeyGetDat(StemStr, RealWordStr)){
-      StemStr=RealWordStr;
-    } else {
-      StemStrToRealWordStrH.AddDat(StemStr, UCWordStr);
-      StemStr=UCWordStr;
+    // the map grows on lookups, serialize when stemming from several threads
+    #pragma omp critical(TStemmerRealWord)
+    {
+      TStr RealWordStr;
+      if (StemStrToRealWordStrH.IsKeyGetDat(StemStr, RealWordStr)){
+        StemStr=RealWordStr;
+      } else {
+        StemStrToRealWordStrH.AddDat(StemStr, UCWordStr);
+        StemStr=UCWordStr;
+      }
     }
   }
 
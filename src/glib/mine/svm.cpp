@@ -11,7 +11,7 @@ namespace TSvm {
 ///////////////////////////////////////////////////////////////////////////////
 // TLinParam
 
-TLinParam::TLinParam(TSIn& SIn) { Load(SIn); }
+TLinParam::TLinParam(TSIn& SIn): Threads(1) { Load(SIn); }
 
 void TLinParam::Load(TSIn& SIn){
     Cost.Load(SIn);
@@ -35,6 +35,15 @@ void TLinParam::Save(TSOut& SOut) const {
     TBool(Verbose).Save(SOut);
 }
 
+int TLinParam::GetThreads(const int& Samples) const {
+#ifdef GLib_OPENMP
+    const int MxThreads = (Threads > 0) ? (int)Threads : omp_get_max_threads();
+    return TInt::GetMx(1, TInt::GetMn(MxThreads, Samples));
+#else
+    return 1;
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // TLinModel
 
@@ -61,6 +70,11 @@ void TLinModel::UpdateParams(const PJsonVal& ParamVal) {
     if (ParamVal->IsObjKey("maxTime")) { Param.MxTime = TFlt::Round(1000.0 * ParamVal->GetObjNum("maxTime")); }
     if (ParamVal->IsObjKey("minDiff")) { Param.MnDiff = ParamVal->GetObjNum("minDiff"); }
     if (ParamVal->IsObjKey("verbose")) { Param.Verbose = ParamVal->GetObjBool("verbose"); }
+    if (ParamVal->IsObjKey("threads")) {
+        const int Threads = ParamVal->GetObjInt("threads");
+        EAssertR(Threads >= 0, "Number of threads must be nonnegative!");
+        Param.Threads = Threads;
+    }
 }
 
 
@@ -74,6 +88,7 @@ PJsonVal TLinModel::GetParams() const {
     ParamVal->AddToObj("maxTime", Param.MxTime / 1000.0); // convert from miliseconds to seconds
     ParamVal->AddToObj("minDiff", Param.MnDiff);
     ParamVal->AddToObj("verbose", Param.Verbose);
+    ParamVal->AddToObj("threads", Param.Threads);
     return ParamVal;
 }
 
@@ -113,6 +128,83 @@ void TLinModel::FitRegression(const TVec<TIntFltKdV>& VecV, const int& Dims, con
     SolveRegression(VecV, Dims, Vecs, TargetV, LogNotify, ErrorNotify);
 }
 
+template <class TVecV>
+void TLinModel::GetSampleDotV(const TVecV& VecV, const TIntV& SampleVecNV, const TFltV& WgtV,
+        const int& Threads, TFltV& DotV) {
+
+    const int Samples = SampleVecNV.Len();
+    DotV.Gen(Samples);
+    #pragma omp parallel for schedule(static) num_threads(Threads) if (Threads > 1)
+    for (int SampleN = 0; SampleN < Samples; SampleN++) {
+        const int VecN = SampleVecNV[SampleN];
+        DotV[SampleN] = TLinAlg::DotProduct(VecV, VecN, WgtV);
+    }
+}
+
+template <class TVecV>
+void TLinModel::GetSampleNormV(const TVecV& VecV, const TIntV& SampleVecNV, const int& Threads,
+        TFltV& NormV) {
+
+    const int Samples = SampleVecNV.Len();
+    NormV.Gen(Samples);
+    #pragma omp parallel for schedule(static) num_threads(Threads) if (Threads > 1)
+    for (int SampleN = 0; SampleN < Samples; SampleN++) {
+        const int VecN = SampleVecNV[SampleN];
+        NormV[SampleN] = TLinAlg::Norm(VecV, VecN);
+    }
+}
+
+void TLinModel::AddUpdates(const TFltVV& VecV, const TVec<TPair<TFlt, TInt> >& UpdateV,
+        const int& Threads, TFltV& WgtV) {
+
+    if (Threads == 1) {
+        for (int UpdateN = 0; UpdateN < UpdateV.Len(); UpdateN++) {
+            TLinAlg::AddVec(UpdateV[UpdateN].Val1, VecV, UpdateV[UpdateN].Val2, WgtV, WgtV);
+        }
+        return;
+    }
+    // each thread applies all the updates to its own block of dimensions, so
+    // the result does not depend on the number of threads
+    const int Dims = WgtV.Len();
+    const int Blocks = TInt::GetMn(Threads, Dims);
+    #pragma omp parallel for schedule(static, 1) num_threads(Threads)
+    for (int BlockN = 0; BlockN < Blocks; BlockN++) {
+        const int StartDimN = (int)((int64)Dims * BlockN / Blocks);
+        const int EndDimN = (int)((int64)Dims * (BlockN + 1) / Blocks);
+        for (int UpdateN = 0; UpdateN < UpdateV.Len(); UpdateN++) {
+            const double Update = UpdateV[UpdateN].Val1;
+            const int VecN = UpdateV[UpdateN].Val2;
+            for (int DimN = StartDimN; DimN < EndDimN; DimN++) {
+                WgtV[DimN] += Update * VecV(DimN, VecN);
+            }
+        }
+    }
+}
+
+void TLinModel::AddUpdates(const TVec<TIntFltKdV>& VecV, const TVec<TPair<TFlt, TInt> >& UpdateV,
+        const int& Threads, TFltV& WgtV) {
+
+    if (Threads == 1) {
+        for (int UpdateN = 0; UpdateN < UpdateV.Len(); UpdateN++) {
+            TLinAlg::AddVec(UpdateV[UpdateN].Val1, VecV, UpdateV[UpdateN].Val2, WgtV, WgtV);
+        }
+        return;
+    }
+    // hogwild: sparse updates rarely touch the same weights, so threads add
+    // them without locking and only the individual additions are atomic
+    double* WgtT = (double*)WgtV.BegI();
+    #pragma omp parallel for schedule(static) num_threads(Threads)
+    for (int UpdateN = 0; UpdateN < UpdateV.Len(); UpdateN++) {
+        const double Update = UpdateV[UpdateN].Val1;
+        const TIntFltKdV& SpVec = VecV[UpdateV[UpdateN].Val2];
+        for (int ElN = 0; ElN < SpVec.Len(); ElN++) {
+            const double Val = Update * SpVec[ElN].Dat;
+            #pragma omp atomic
+            WgtT[SpVec[ElN].Key] += Val;
+        }
+    }
+}
+
 template <class TVecV>
 void TLinModel::SolveClassification(const TVecV& VecV, const int& Dims, const int& Vecs,
         const TFltV& TargetV, const PNotify& _LogNotify, const PNotify& ErrorNotify) {
@@ -168,6 +260,12 @@ void TLinModel::SolveClassification(const TVecV& VecV, const int& Dims, const in
     const int ProfilerBatch = Profiler.AddTimer("Batch");
     const int ProfilerPost = Profiler.AddTimer("Post");
 
+    // the sample and the updates it leads to
+    const int Threads = Param.GetThreads(Param.SampleSize);
+    TIntV SampleVecNV(Param.SampleSize); TFltV DotV;
+    TVec<TPair<TFlt, TInt> > UpdateV(Param.SampleSize, 0);
+    LogNotify->OnStatusFmt("Using %d threads", Threads);
+
     // function for writing progress reports
     int PosCount = 0, NegCount = 0;
     auto ProgressNotify = [&]() {
@@ -190,26 +288,31 @@ void TLinModel::SolveClassification(const TVecV& VecV, const int& Dims, const in
 
         // classify examples from the sample
         Profiler.StartTimer(ProfilerBatch);
-        int DiffCount = 0;
+        // draw the sample first so the random sequence does not depend on threads
         for (int SampleN = 0; SampleN < Param.SampleSize; SampleN++) {
-            int VecN = 0;
             if (Rnd.GetUniDev() > SamplingRatio) {
                 // we select negative vector
-                VecN = NegVecIdV[Rnd.GetUniDevInt(NegVecs)];
+                SampleVecNV[SampleN] = NegVecIdV[Rnd.GetUniDevInt(NegVecs)];
                 NegCount++;
             } else {
                 // we select positive vector
-                VecN = PosVecIdV[Rnd.GetUniDevInt(PosVecs)];
+                SampleVecNV[SampleN] = PosVecIdV[Rnd.GetUniDevInt(PosVecs)];
                 PosCount++;
             }
+        }
+        GetSampleDotV(VecV, SampleVecNV, WgtV, Threads, DotV);
+        UpdateV.Clr(false);
+        for (int SampleN = 0; SampleN < Param.SampleSize; SampleN++) {
+            const int VecN = SampleVecNV[SampleN];
             const double VecCfyVal = TargetV[VecN];
-            const double CfyVal = VecCfyVal * TLinAlg::DotProduct(VecV, VecN, WgtV);
+            const double CfyVal = VecCfyVal * DotV[SampleN];
             if (CfyVal < 1.0) {
                 // with update from the stochastic sub-gradient
-                TLinAlg::AddVec(VecUpdate * VecCfyVal, VecV, VecN, NewWgtV, NewWgtV);
-                DiffCount++;
+                UpdateV.Add(TPair<TFlt, TInt>(VecUpdate * VecCfyVal, VecN));
             }
         }
+        AddUpdates(VecV, UpdateV, Threads, NewWgtV);
+        const int DiffCount = UpdateV.Len();
         Profiler.StopTimer(ProfilerBatch);
 
         Profiler.StartTimer(ProfilerPost);
@@ -283,6 +386,11 @@ void TLinModel::SolveRegression(const TVecV& VecV, const int& Dims, const int& V
     const int ProfilerPre = Profiler.AddTimer("Pre");
     const int ProfilerBatch = Profiler.AddTimer("Batch");
 
+    // the sample and its dot products and norms
+    const int Threads = Param.GetThreads(Param.SampleSize);
+    TIntV SampleVecNV(Param.SampleSize); TFltV DotV, NormV;
+    LogNotify->OnStatusFmt("Using %d threads", Threads);
+
     // function for writing progress reports
     auto ProgressNotify = [&]() {
         LogNotify->OnStatusFmt("  %d iterations, %.3f seconds, last weight difference %g",
@@ -310,15 +418,22 @@ void TLinModel::SolveRegression(const TVecV& VecV, const int& Dims, const int& V
         // store which examples will lead to gradient updates (and their factors)
         TVec<TPair<TFlt, TInt> > Updates(Param.SampleSize, 0);
 
+        // draw the sample first so the random sequence does not depend on threads
+        for (int SampleN = 0; SampleN < Param.SampleSize; SampleN++) {
+            SampleVecNV[SampleN] = Rnd.GetUniDevInt(Vecs);
+        }
+        GetSampleDotV(VecV, SampleVecNV, WgtV, Threads, DotV);
+        GetSampleNormV(VecV, SampleVecNV, Threads, NormV);
+
         // in the first pass we find which samples will lead to updates
         for (int SampleN = 0; SampleN < Param.SampleSize; SampleN++) {
-            const int VecN = Rnd.GetUniDevInt(Vecs);
+            const int VecN = SampleVecNV[SampleN];
             // target
             const double Target = TargetV[VecN];
             // prediction
-            double Dot = TLinAlg::DotProduct(VecV, VecN, WgtV);
+            const double Dot = DotV[SampleN];
             // Used in bound computation
-            double NorX = TLinAlg::Norm(VecV, VecN);
+            const double NorX = NormV[SampleN];
             // For predictions we need to use the Norm to scale correctly
             const double Pred = Norm * Dot;
 
@@ -345,9 +460,7 @@ void TLinModel::SolveRegression(const TVecV& VecV, const int& Dims, const int& V
         Diff /= Normw;
 
         // in the second pass we update
-        for (int UpdateN = 0; UpdateN < Updates.Len(); UpdateN++) {
-            TLinAlg::AddVec(Updates[UpdateN].Val1, VecV, Updates[UpdateN].Val2, WgtV, WgtV);
-        }
+        AddUpdates(VecV, Updates, Threads, WgtV);
         Norm *= (1 - Nu * Lambda);
 
         Profiler.StopTimer(ProfilerBatch);
@@ -51,19 +51,26 @@ class TLinParam {
     TInt MxTime;
     TFlt MnDiff;
     TBool Verbose;
+    /// number of threads processing each sample, 0 uses all available threads;
+    /// a training resource setting, so it is not saved with the model
+    TInt Threads;
 
   public:
     TLinParam() : Cost(1.0), Unbalance(1.0), Eps(1e-3), SampleSize(1000),
-        MxIter(10000), MxTime(1000*1), MnDiff(1e-6), Verbose(false) {  }
+        MxIter(10000), MxTime(1000*1), MnDiff(1e-6), Verbose(false), Threads(1) {  }
     TLinParam(const double& _Cost, const double& _Unbalance, const int& _SampleSize,
-        const int& _MxIter, const int& _MxTime, const double& _MnDiff, const bool& _Verbose) :
+        const int& _MxIter, const int& _MxTime, const double& _MnDiff, const bool& _Verbose,
+        const int& _Threads = 1) :
         Cost(_Cost), Unbalance(_Unbalance), SampleSize(_SampleSize), MxIter(_MxIter),
-        MxTime(_MxTime), MnDiff(_MnDiff), Verbose(_Verbose) { }
+        MxTime(_MxTime), MnDiff(_MnDiff), Verbose(_Verbose), Threads(_Threads) { }
     ~TLinParam() { }
 
     TLinParam(TSIn& SIn);
     void Load(TSIn& SIn);
     void Save(TSOut& SOut) const;
+
+    /// number of threads to use for the sample of the given size
+    int GetThreads(const int& Samples) const;
 };
 
 /// Linear model
@@ -113,6 +120,22 @@ public:
     template <class TVecV>
     void SolveRegression(const TVecV& VecV, const int& Dims, const int& Vecs,
         const TFltV& TargetV, const PNotify& LogNotify, const PNotify& ErrorNotify);
+
+private:
+    /// computes the dot products between the sampled vectors and WgtV
+    template <class TVecV>
+    static void GetSampleDotV(const TVecV& VecV, const TIntV& SampleVecNV, const TFltV& WgtV,
+        const int& Threads, TFltV& DotV);
+    /// computes the norms of the sampled vectors
+    template <class TVecV>
+    static void GetSampleNormV(const TVecV& VecV, const TIntV& SampleVecNV, const int& Threads,
+        TFltV& NormV);
+    /// adds the sub-gradient updates (factor, vector id) to WgtV; dense vectors are
+    /// split among threads by dimension, sparse vectors are added hogwild style
+    static void AddUpdates(const TFltVV& VecV, const TVec<TPair<TFlt, TInt> >& UpdateV,
+        const int& Threads, TFltV& WgtV);
+    static void AddUpdates(const TVec<TIntFltKdV>& VecV, const TVec<TPair<TFlt, TInt> >& UpdateV,
+        const int& Threads, TFltV& WgtV);
 };
 
 /// constants for Type, LIBSVM specific
@@ -2209,6 +2209,10 @@ TNodeJsKMeans::~TNodeJsKMeans() {
 void TNodeJsKMeans::UpdateParams(const PJsonVal& ParamVal) {
     if (ParamVal->IsObjKey("iter")) { Iter = ParamVal->GetObjInt("iter"); }
     if (ParamVal->IsObjKey("k")) { K = ParamVal->GetObjInt("k"); }
+    if (ParamVal->IsObjKey("batchSize")) {
+        BatchSize = ParamVal->GetObjInt("batchSize");
+        EAssertR(BatchSize >= 0, "Update KMeans Exception: batchSize must be non-negative!");
+    }
     if (ParamVal->IsObjKey("fitIdx")) { ParamVal->GetObjIntV("fitIdx", FitIdx); }
     if (ParamVal->IsObjKey("allowEmpty")) { AllowEmptyP = ParamVal->GetObjBool("allowEmpty"); }
     if (ParamVal->IsObjKey("calcDistQual")) { CalcDistQualP = ParamVal->GetObjBool("calcDistQual"); }
@@ -2380,6 +2384,9 @@ void TNodeJsKMeans::getParams(const v8::FunctionCallbackInfo<v8::Value>& Args) {
         Nan::Set(JsObj, TNodeJsUtil::ToLocal(Nan::New("verbose")), Nan::New(JsKMeans->Verbose));
         Nan::Set(JsObj, TNodeJsUtil::ToLocal(Nan::New("allowEmpty")), Nan::New(JsKMeans->AllowEmptyP));
         Nan::Set(JsObj, TNodeJsUtil::ToLocal(Nan::New("calcDistQual")), Nan::New(JsKMeans->CalcDistQualP));
+        if (JsKMeans->BatchSize > 0) {
+            Nan::Set(JsObj, TNodeJsUtil::ToLocal(Nan::New("batchSize")), v8::Integer::New(Isolate, JsKMeans->BatchSize));
+        }
 
         if (!JsKMeans->FitIdx.Empty()) {
             v8::Local<v8::Array> FitIdx = v8::Array::New(Isolate, JsKMeans->FitIdx.Len());
@@ -2517,6 +2524,7 @@ void TNodeJsKMeans::TFitTask::Run() {
        // create a new model
        if (JsKMeans->CentType == TCentroidType::ctDense) {
            TClustering::TDenseKMeans* KMeans = new TClustering::TDenseKMeans(JsKMeans->K, TRnd(0), JsKMeans->Dist, CalcDistQualP);
+           KMeans->SetBatchSize(JsKMeans->BatchSize);
 
            JsKMeans->Model = (void*) KMeans;
 
@@ -2624,6 +2632,7 @@ void TNodeJsKMeans::TFitTask::Run() {
        }
        else if (JsKMeans->CentType == TCentroidType::ctSparse) {
            TClustering::TSparseKMeans* KMeans = new TClustering::TSparseKMeans(JsKMeans->K, TRnd(0), JsKMeans->Dist, CalcDistQualP);
+           KMeans->SetBatchSize(JsKMeans->BatchSize);
            JsKMeans->Model = (void*) KMeans;
 
            // input dense matrix
@@ -152,6 +152,7 @@ private:
 * @property  {number} [maxIterations=10000] - Maximum number of iterations.
 * @property  {number} [maxTime=1] - Maximum runtime in seconds.
 * @property  {number} [minDiff=1e-6] - Stopping criterion tolerance.
+* @property  {number} [threads=1] - Number of threads used by the `'SGD'` algorithm to process each batch. Sparse examples are added to the model without locking (hogwild), dense ones are split among threads by dimension. If set to 0, all available threads are used. The parameter is not saved with the model.
 * @property  {string} [type='C_SVC'] - The subalgorithm procedure in LIBSVM. Possible options are `'C_SVC'`, `'NU_SVC'` and `'ONE_CLASS'` for classification and `'EPSILON_SVR'`, `'NU_SVR'` and `'ONE_CLASS'` for regression.
 * @property  {string} [kernel='LINEAR'] - Kernel type in LIBSVM. Possible options are `'LINEAR'`, `'POLY'`, 'RBF'`, 'SIGMOID'`  and `'PRECOMPUTED'`.
 * @property  {number} [gamma=1.0] - Gamma parameter in LIBSVM. Set gamma in kernel function.
@@ -2144,6 +2145,8 @@ private:
 * @property {string} [centroidType="Dense"] - The type of centroids. Possible options are `'Dense'` and `'Sparse'`.
 * @property {string} [distanceType="Euclid"] - The distance type used at the calculations. Possible options are `'Euclid'` and `'Cos'`.
 * @property {boolean} [verbose=false] - If `false`, the console output is supressed.
+* @property {number} [batchSize=0] - If positive, the centroids are updated from random mini-batches of `batchSize` instances
+* and exactly `iter` iterations are run. The value is not saved with the model.
 * @property {Array.<number>} [fitIdx] - The index array used for the construction of the initial centroids.
 * @property {Object} [fitStart] - The KMeans model returned by {@link module:analytics.KMeans.prototype.getModel} used for centroid initialization.
 * @property {(module:la.Matrix | module:la.SparseMatrix)} fitStart.C - The centroid matrix.
@@ -2183,6 +2186,7 @@ private:
 
     int Iter;
     int K;
+    int BatchSize {0};
     TBool AllowEmptyP;
     TBool CalcDistQualP {false};
 
@@ -9,6 +9,7 @@ exports.view = {
     "title": "Vector - array of boolean.",
     "className": "BoolVector",
     "elementType": "boolean",
+    "typedArray": "Array",
 
     "example1": "[true, true, false]",
     "input1": "false, true",
@@ -42,6 +43,7 @@ exports.view = {
     "skipNorm": "skip.",
     "skipSparse": "skip.",
     "skipToMat": "skip.",
+    "skipToTypedArray": "skip.",
     "skipSave": "",
     "skipLoad": "",
     
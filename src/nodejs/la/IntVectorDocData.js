@@ -9,6 +9,7 @@ exports.view = {
     "title": "Vector - array of integers.",
     "className": "IntVector",
     "elementType": "number",
+    "typedArray": "Int32Array",
 
     "example1": "[1, 2, 3]",
     "input1": "4, 5",
@@ -42,6 +43,7 @@ exports.view = {
     "skipNorm": "skip.",
     "skipSparse": "skip.",
     "skipToMat": "skip.",
+    "skipToTypedArray": "",
     "skipSave": "",
     "skipLoad": "",
     
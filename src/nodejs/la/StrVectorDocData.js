@@ -9,6 +9,7 @@ exports.view = {
 	"title" : "Vector - array of strings.",
 	"className" : "StrVector",
 	"elementType": "string",
+	"typedArray": "Array",
 
 	"example1": "['a', 'b', 'c']",
     "input1": "'d', 'e'",
@@ -42,6 +43,7 @@ exports.view = {
 	"skipNorm": "skip.",
 	"skipSparse": "skip.",
 	"skipToMat": "skip.",
+	"skipToTypedArray": "skip.",
 	"skipSave": "",
     "skipLoad": "",
     
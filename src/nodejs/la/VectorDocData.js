@@ -9,6 +9,7 @@ exports.view = {
 	"title" : "Vector - array of doubles.",
 	"className" : "Vector",
 	"elementType": "number",
+	"typedArray": "Float64Array",
 
 	"example1": "[1, 2, 3]",
     "input1": "4, 5",
@@ -41,6 +42,7 @@ exports.view = {
 	"skipNorm": "",
 	"skipSparse": "",
 	"skipToMat": "",
+	"skipToTypedArray": "",
 	"skipSave": "",
     "skipLoad": "",
     
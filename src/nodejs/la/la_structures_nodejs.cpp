@@ -55,6 +55,7 @@ void TNodeJsFltVV::Init(v8::Local<v8::Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "frob", _frob);
     NODE_SET_PROTOTYPE_METHOD(tpl, "sparse", _sparse);
     NODE_SET_PROTOTYPE_METHOD(tpl, "toString", _toString);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "toTypedArray", _toTypedArray);
     NODE_SET_PROTOTYPE_METHOD(tpl, "rowMaxIdx", _rowMaxIdx);
     NODE_SET_PROTOTYPE_METHOD(tpl, "colMaxIdx", _colMaxIdx);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getCol", _getCol);
@@ -120,6 +121,17 @@ TNodeJsFltVV* TNodeJsFltVV::NewFromArgs(const v8::FunctionCallbackInfo<v8::Value
                     const int Cols = TNodeJsUtil::GetArgInt32(Args, 0, "cols");
                     const int Rows = TNodeJsUtil::GetArgInt32(Args, 0, "rows");
                     EAssert(Cols >= 0 && Rows >= 0);
+                    v8::Local<v8::Object> ArgObj = TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[0]));
+                    if (TNodeJsUtil::IsObjFld(ArgObj, "data")) {
+                        // share the memory of the typed array
+                        v8::Local<v8::Value> DataVal = TNodeJsUtil::ToLocal(Nan::Get(ArgObj, TNodeJsUtil::ToLocal(Nan::New("data"))));
+                        EAssertR(TNodeJsVecBuf<TFlt>::IsTypedArray(DataVal), "Matrix data should be a Float64Array");
+                        v8::Local<v8::TypedArray> TypedArray = v8::Local<v8::TypedArray>::Cast(DataVal);
+                        EAssertR((int64)TypedArray->Length() == (int64)Rows * Cols, "Matrix data should have rows * cols elements");
+                        TNodeJsFltVV* JsMat = new TNodeJsFltVV();
+                        JsMat->Mat.GenExt(JsMat->SharedBuf.Adopt(TypedArray), Rows, Cols);
+                        return JsMat;
+                    }
                     Mat.Gen(Rows, Cols);
                     if (GenRandom) {
                         TLinAlgTransform::FillRnd(Mat);
@@ -139,6 +151,10 @@ v8::Local<v8::Object> TNodeJsFltVV::New(const TFltVV& FltVV) {
     return TNodeJsUtil::NewInstance(new TNodeJsFltVV(FltVV));
 }
 
+v8::Local<v8::Object> TNodeJsFltVV::New(TFltVV&& FltVV) {
+    return TNodeJsUtil::NewInstance(new TNodeJsFltVV(std::move(FltVV)));
+}
+
 v8::Local<v8::Object> TNodeJsFltVV::New(const TFltV& FltV) {
     TFltVV FltVV;    TLinAlgTransform::Diag(FltV, FltVV);
     return TNodeJsUtil::NewInstance(new TNodeJsFltVV(FltVV));
@@ -468,6 +484,14 @@ void TNodeJsFltVV::toString(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     Args.GetReturnValue().Set(TNodeJsUtil::ToLocal(Nan::New(Out.CStr())));
 }
 
+void TNodeJsFltVV::toTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    TNodeJsFltVV* JsMat = ObjectWrap::Unwrap<TNodeJsFltVV>(Args.Holder());
+    Args.GetReturnValue().Set(JsMat->SharedBuf.GetTypedArray(JsMat->Mat.Get1DVec()));
+}
+
 void TNodeJsFltVV::rowMaxIdx(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
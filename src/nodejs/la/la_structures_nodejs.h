@@ -24,6 +24,7 @@
 * @property {number} rows - Number of rows.
 * @property {number} cols - Number of columns.
 * @property {boolean} [random=false] - Generate a random matrix with entries sampled from a uniform [0,1] distribution. If set to false, a zero matrix is created.
+* @property {Float64Array} [data] - Elements of the matrix in row major order. The matrix shares memory with the typed array, no elements are copied.
 */
 
 /**
@@ -41,6 +42,8 @@
 * var mat = new la.Matrix({"rows": 3, "cols": 2, "random": true}); // creates a 3 x 2 matrix with random values
 * // create a new matrix with nested arrays
 * var mat2 = new la.Matrix([[1, 7, 4], [-10, 0, 3]]); // creates a 2 x 3 matrix with the designated values
+* // create a new matrix on the memory of a typed array
+* var mat3 = new la.Matrix({"rows": 2, "cols": 2, "data": new Float64Array([1, 2, 3, 4])});
 */
 //# exports.Matrix = function(arg) { return Object.create(require('qminer').la.Matrix.prototype); }
 
@@ -56,10 +59,13 @@ public:
     static TNodeJsFltVV* NewFromArgs(const v8::FunctionCallbackInfo<v8::Value>& Args);
 
     static v8::Local<v8::Object> New(const TFltVV& FltVV);
+    /// takes over the memory of the matrix without copying
+    static v8::Local<v8::Object> New(TFltVV&& FltVV);
     static v8::Local<v8::Object> New(const TFltV& FltV);
 public:
     TNodeJsFltVV() { }
     TNodeJsFltVV(const TFltVV& _Mat) : Mat(_Mat) { }
+    TNodeJsFltVV(TFltVV&& _Mat) { Mat.Swap(_Mat); }
 private:
     /**
     * Returns an element of matrix.
@@ -267,6 +273,25 @@ private:
     //# exports.Matrix.prototype.toString = function () { return ""; }
     JsDeclareFunction(toString);
 
+    /**
+    * Returns a typed array which shares memory with the matrix, no elements are copied.
+    * The elements are in row major order, the element (i, j) is at index `i * mat.cols + j`.
+    * Changes made through the typed array are visible in the matrix and vice versa, until
+    * an operation replaces the elements of the matrix (e.g. `load`).
+    * @returns {Float64Array} Typed array over the elements of the matrix.
+    * @example
+    * // import la module
+    * var la = require('qminer').la;
+    * // create a new matrix
+    * var mat = new la.Matrix([[1, 2], [3, 5]]);
+    * // get the typed array sharing memory with the matrix
+    * var arr = mat.toTypedArray(); // arr is [1, 2, 3, 5]
+    * // changes are visible in the matrix
+    * arr[3] = 4; // mat.at(1, 1) is now 4
+    */
+    //# exports.Matrix.prototype.toTypedArray = function () { return new Float64Array(); }
+    JsDeclareFunction(toTypedArray);
+
     /**
     * Transforms the matrix from dense to sparse format.
     * @returns {module:la.SparseMatrix} Sparse column matrix representation of dense matrix.
@@ -514,6 +539,8 @@ private:
     JsDeclareFunction(loadascii);
 public:
     TFltVV Mat;
+    /// memory shared with typed arrays, when the matrix is a view on it
+    TNodeJsVecBuf<TFlt> SharedBuf;
 };
 
 
@@ -162,9 +162,10 @@ public:
 * <% title %>
 * @classdesc The <% elementType %> vector representation. Wraps a C++ array.
 * @class
-* @param {(Array.<<% elementType %>> | module:la.<% className %>)} [arg] - Constructor arguments. There are two ways of constructing:
+* @param {(Array.<<% elementType %>> | module:la.<% className %> | TypedArray)} [arg] - Constructor arguments. There are three ways of constructing:
 * <br>1. using an array of vector elements. Example: using `<% example1 %>` creates a vector of length 3,
-* <br>2. using a vector (copy constructor).
+* <br>2. using a vector (copy constructor),
+* <br>3. using a typed array. A `Float64Array` for {@link module:la.Vector} and an `Int32Array` for {@link module:la.IntVector} share their memory with the vector without copying, other typed arrays are copied.
 * @example
 * var la = require('qminer').la;
 * // create a new empty vector
@@ -183,6 +184,8 @@ public: // So we can register the class
     static void Init(v8::Local<v8::Object> exports);
 
     static v8::Local<v8::Object> New(const TVec<TVal>& Vec);
+    /// takes over the memory of the vector without copying
+    static v8::Local<v8::Object> New(TVec<TVal>&& Vec);
 
     template <typename T = TVal, typename = typename gtraits::enable_if<gtraits::is_same<T, TFlt>::value>::type>
     static v8::Local<v8::Object> New(const TIntV& IntV) {
@@ -243,6 +246,7 @@ public:
     TNodeJsVec() : Vec() { }
     TNodeJsVec(const int& Size) : Vec(Size) {}
     TNodeJsVec(const TVec<TVal>& ValV) : Vec(ValV) { }
+    TNodeJsVec(TVec<TVal>&& ValV) : Vec(std::move(ValV)) { }
 public:
     JsDeclareFunction(New);
 private:
@@ -590,6 +594,24 @@ private:
     //# exports.<% className %>.prototype.toString = function () { return ''; }
     JsDeclareFunction(toString);
 
+    /**
+    * Returns a typed array which shares memory with the vector, no elements are copied.
+    * Changes made through the typed array are visible in the vector and vice versa. After
+    * an operation which changes the length of the vector (e.g. `push`), the vector gets its
+    * own copy of the elements and stops sharing them with the typed array.
+    * @returns {<% typedArray %>} Typed array over the elements of the vector.
+    * @<% skipToTypedArray %>example
+    * var la = require('qminer').la;
+    * // create a new vector
+    * var vec = new la.<% className %>(<% example1 %>);
+    * // get the typed array sharing memory with the vector
+    * var arr = vec.toTypedArray();
+    * // changes are visible in the vector
+    * arr[0] = <% val1 %>; // vec[0] is now <% val1 %>
+    */
+    //# <% skipToTypedArray %>exports.<% className %>.prototype.toTypedArray = function () { return new <% typedArray %>(); }
+    JsDeclareSpecializedFunction(toTypedArray);
+
     /**
     * Creates a dense diagonal matrix out of the vector.
     * @returns{module:la.Matrix} Diagonal matrix, where the (i, i)-th element is the i-th element of vector.
@@ -729,6 +751,8 @@ private:
     JsDeclareFunction(loadascii);
 public:
     TVec<TVal> Vec;
+    /// memory shared with typed arrays, when the vector is a view on it
+    TNodeJsVecBuf<TVal> SharedBuf;
 private:
     static v8::Persistent<v8::Function> Constructor;
 };
@@ -764,6 +788,25 @@ inline v8::Local<v8::Object> TNodeJsVec<TVal, TAux>::New(const TVec<TVal>& ValV)
     return HandleScope.Escape(Instance);
 }
 
+template <typename TVal, typename TAux>
+inline v8::Local<v8::Object> TNodeJsVec<TVal, TAux>::New(TVec<TVal>&& ValV) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::EscapableHandleScope HandleScope(Isolate);
+    EAssertR(!Constructor.IsEmpty(), TStr(TAux::ClassId) + "::New: constructor is empty. Did you call TNodeJsVec<TFlt, TAuxFltV>::Init(exports); in this module's init function?");
+    v8::Local<v8::Function> Cons = v8::Local<v8::Function>::New(Isolate, Constructor);
+    v8::MaybeLocal<v8::Object> MaybeInstance = Cons->NewInstance(Isolate->GetCurrentContext());
+    v8::Local<v8::Object> Instance;
+    EAssertR(MaybeInstance.ToLocal(&Instance), "TNodeJsVec<TVal, TAux>::New: failed to create instance (empty)");
+
+    v8::Local<v8::String> Key = TNodeJsUtil::ToLocal(Nan::New("class"));
+    v8::Local<v8::String> Value = TNodeJsUtil::ToLocal(Nan::New(TAux::ClassId.CStr()));
+    TNodeJsUtil::SetPrivate(Instance, Key, Value);
+
+    TNodeJsVec<TVal, TAux>* JsVec = new TNodeJsVec<TVal, TAux>(std::move(ValV));
+    JsVec->Wrap(Instance);
+    return HandleScope.Escape(Instance);
+}
+
 template <typename TVal, typename TAux>
 template <typename T>
 inline v8::Local<v8::Object> TNodeJsVec<TVal, TAux>::New(const TVec<T>&) {
@@ -804,6 +847,7 @@ void TNodeJsVec<TVal, TAux>::Init(v8::Local<v8::Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "multiply", _multiply);
     NODE_SET_PROTOTYPE_METHOD(tpl, "normalize", _normalize);
     NODE_SET_PROTOTYPE_METHOD(tpl, "toString", _toString);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "toTypedArray", _toTypedArray);
     NODE_SET_PROTOTYPE_METHOD(tpl, "diag", _diag);
     NODE_SET_PROTOTYPE_METHOD(tpl, "spDiag", _spDiag);
     NODE_SET_PROTOTYPE_METHOD(tpl, "norm", _norm);
@@ -1075,6 +1119,24 @@ inline void TNodeJsVec<TFlt, TAuxFltV>::toMat(const v8::FunctionCallbackInfo<v8:
 
 //////
 
+template <>
+inline void TNodeJsVec<TFlt, TAuxFltV>::toTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    TNodeJsVec<TFlt, TAuxFltV>* JsVec = ObjectWrap::Unwrap<TNodeJsVec<TFlt, TAuxFltV> >(Args.Holder());
+    Args.GetReturnValue().Set(JsVec->SharedBuf.GetTypedArray(JsVec->Vec));
+}
+
+template <>
+inline void TNodeJsVec<TInt, TAuxIntV>::toTypedArray(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    TNodeJsVec<TInt, TAuxIntV>* JsVec = ObjectWrap::Unwrap<TNodeJsVec<TInt, TAuxIntV> >(Args.Holder());
+    Args.GetReturnValue().Set(JsVec->SharedBuf.GetTypedArray(JsVec->Vec));
+}
+
 template <typename TVal, typename TAux>
 void TNodeJsVec<TVal, TAux>::New(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
@@ -1089,13 +1151,25 @@ void TNodeJsVec<TVal, TAux>::New(const v8::FunctionCallbackInfo<v8::Value>& Args
         v8::Local<v8::String> Value = TNodeJsUtil::ToLocal(Nan::New(TAux::ClassId.CStr()));
         v8::Local<v8::Object> Instance = Args.This();
 
+        // If we got a typed array of the element type, share its memory: vector.new(new Float64Array([1,2,3]))
+        if (TNodeJsVecBuf<TVal>::IsTypedArray(Args[0])) {
+            v8::Local<v8::TypedArray> TypedArray = v8::Local<v8::TypedArray>::Cast(Args[0]);
+            JsVec->Vec.GenExt(JsVec->SharedBuf.Adopt(TypedArray), (int)TypedArray->Length());
+        }
         // If we got Javascript array on the input: vector.new([1,2,3])
-        if (Args[0]->IsArray()) {
+        else if (Args[0]->IsArray()) {
             //printf("vector construct call, class = %s, input array\n", TAux::ClassId.CStr());
             v8::Local<v8::Array> Arr = v8::Local<v8::Array>::Cast(Args[0]);
             const int Len = Arr->Length();
             for (int ElN = 0; ElN < Len; ++ElN) { JsVec->Vec.Add(TAux::CastVal(Context, TNodeJsUtil::ToLocal(Nan::Get(Arr, ElN)))); }
         }
+        // Other typed arrays are converted: vector.new(new Float32Array([1,2,3]))
+        else if (Args[0]->IsTypedArray()) {
+            v8::Local<v8::TypedArray> TypedArray = v8::Local<v8::TypedArray>::Cast(Args[0]);
+            const int Len = (int)TypedArray->Length();
+            JsVec->Vec.Gen(Len, 0);
+            for (int ElN = 0; ElN < Len; ++ElN) { JsVec->Vec.Add(TAux::CastVal(Context, TNodeJsUtil::ToLocal(Nan::Get(TypedArray, ElN)))); }
+        }
         else if (Args[0]->IsObject()) {
             if (TNodeJsUtil::IsArgWrapObj<TNodeJsFltV>(Args, 0)) {
                 //printf("vector construct call, class = %s, input TFltV\n", TAux::ClassId.CStr());
@@ -1295,7 +1369,8 @@ void TNodeJsVec<TVal, TAux>::push(const v8::FunctionCallbackInfo<v8::Value>& Arg
             TNodeJsUtil::ToLocal(Nan::New("Expected number, string or boolean"))));
     }
     else {
-
+        // typed arrays have a fixed length
+        JsVec->SharedBuf.Unshare(JsVec->Vec);
         JsVec->Vec.Add(TAux::CastVal(Context, Args[0]));
         Args.GetReturnValue().Set(Nan::New(JsVec->Vec.Len()));
     }
@@ -1333,6 +1408,9 @@ void TNodeJsVec<TVal, TAux>::splice(const v8::FunctionCallbackInfo<v8::Value>& A
         Vec[StartIdx + i] = TAux::CastVal(Context, Args[2 + i]);
     }
 
+    // typed arrays have a fixed length
+    if (NIns > 0 || NDel > 0) { JsVec->SharedBuf.Unshare(Vec); }
+
     // insert
     for (int i = 0; i < NIns; i++) {
         const int Idx = StartIdx + NOverride + i;
@@ -1382,6 +1460,7 @@ void TNodeJsVec<TVal, TAux>::pushV(const v8::FunctionCallbackInfo<v8::Value>& Ar
     TNodeJsVec<TVal, TAux>* JsVec = ObjectWrap::Unwrap<TNodeJsVec<TVal, TAux> >(Args.Holder());
     TNodeJsVec<TVal, TAux>* OthVec = ObjectWrap::Unwrap<TNodeJsVec<TVal, TAux> >(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[0])));
 
+    JsVec->SharedBuf.Unshare(JsVec->Vec);
     JsVec->Vec.AddV(OthVec->Vec);
 
     Args.GetReturnValue().Set(Nan::New(JsVec->Vec.Len()));
@@ -1434,6 +1513,7 @@ void TNodeJsVec<TVal, TAux>::trunc(const v8::FunctionCallbackInfo<v8::Value>& Ar
     TNodeJsVec<TVal, TAux>* JsVec =
         ObjectWrap::Unwrap<TNodeJsVec<TVal, TAux> >(Args.Holder());
     const int NewLen = Nan::To<int>(Args[0]).FromJust();
+    if (NewLen < JsVec->Vec.Len()) { JsVec->SharedBuf.Unshare(JsVec->Vec); }
     JsVec->Vec.Trunc(NewLen);
 
     Args.GetReturnValue().Set(Args.Holder());
@@ -1572,6 +1652,7 @@ void TNodeJsVec<TVal, TAux>::loadascii(const v8::FunctionCallbackInfo<v8::Value>
     TNodeJsVec<TVal, TAux>* JsVec = ObjectWrap::Unwrap<TNodeJsVec<TVal, TAux> >(Args.Holder());
     TNodeJsFIn* JsFIn = ObjectWrap::Unwrap<TNodeJsFIn>(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[0])));
     PSIn SIn = JsFIn->SIn;
+    JsVec->SharedBuf.Unshare(JsVec->Vec);
     TStr Line;
     while (SIn->GetNextLn(Line)) {
         JsVec->Vec.Add(TAux::Parse(Line));
@@ -931,6 +931,7 @@ TNodeTask::TNodeTask(const v8::FunctionCallbackInfo<v8::Value>& Args, const bool
 
 TNodeTask::~TNodeTask() {
     Callback.Reset();
+    Resolver.Reset();
     ArgPersist.Reset();
 }
 
@@ -947,6 +948,20 @@ void TNodeTask::AfterRun() {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
 
+    if (!Resolver.IsEmpty()) {
+        // callback scope runs the promise reactions when we are done
+        v8::Local<v8::Context> Context = Isolate->GetCurrentContext();
+        node::CallbackScope CallbackScope(Isolate, v8::Object::New(Isolate), { 0, 0 });
+        v8::Local<v8::Promise::Resolver> PromiseResolver = v8::Local<v8::Promise::Resolver>::New(Isolate, Resolver);
+        if (HasExcept()) {
+            v8::Local<v8::String> V8Msg = TNodeJsUtil::ToLocal(Nan::New(Except->GetMsgStr().CStr()));
+            PromiseResolver->Reject(Context, v8::Exception::Error(V8Msg)).FromJust();
+        } else {
+            PromiseResolver->Resolve(Context, WrapResult()).FromJust();
+        }
+        return;
+    }
+
     EAssertR(!Callback.IsEmpty(), "The callback was not defined!");
     v8::Local<v8::Function> Fun = v8::Local<v8::Function>::New(Isolate, Callback);
 
@@ -974,6 +989,21 @@ void TNodeTask::ExtractCallback(const v8::FunctionCallbackInfo<v8::Value>& Args)
     Callback.Reset(Isolate, GetCallback(Args));
 }
 
+v8::Local<v8::Value> TNodeTask::ExtractCallbackOrPromise(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::EscapableHandleScope HandleScope(Isolate);
+
+    if (Args.Length() > 0 && Args[Args.Length() - 1]->IsFunction()) {
+        ExtractCallback(Args);
+        return HandleScope.Escape(Nan::Undefined());
+    }
+
+    v8::Local<v8::Promise::Resolver> PromiseResolver =
+        TNodeJsUtil::ToLocal(v8::Promise::Resolver::New(Isolate->GetCurrentContext()));
+    Resolver.Reset(Isolate, PromiseResolver);
+    return HandleScope.Escape(PromiseResolver->GetPromise());
+}
+
 //////////////////////////////////////////////////////
 // Node - Asynchronous Utilities
 TCriticalSection TNodeJsAsyncUtil::UvSection;
@@ -1147,6 +1177,22 @@ void TNodeJsAsyncUtil::ExecuteOnWorker(TAsyncTask* Task) {
     uv_queue_work(uv_default_loop(), UvReq, OnWorker, AfterOnWorker);
 }
 
+void TNodeJsAsyncUtil::ExecuteOnCaller(TAsyncTask* Task) {
+    TWorkerData Data(Task);
+
+    try {
+        Task->Run();
+    } catch (const PExcept& Except) {
+        printf("Exception on main thread: %s!", Except->GetMsgStr().CStr());
+    }
+
+    try {
+        Task->AfterRun();
+    } catch (const PExcept& Except) {
+        printf("Exception when calling callback: %s!", Except->GetMsgStr().CStr());
+    }
+}
+
 PJsonVal TNodeJsUtil::GetObjToNmJson(const v8::Local<v8::Value>& Val) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
@@ -144,6 +144,21 @@
     };  \
     JsDeclareInternalFunction(Function);
 
+#define JsDeclarePromiseFunction(Function, TTask) \
+    static void Function(const v8::FunctionCallbackInfo<v8::Value>& Args) { \
+        v8::Isolate* Isolate = v8::Isolate::GetCurrent();   \
+        v8::HandleScope HandleScope(Isolate);   \
+        TTask* Task = new TTask(Args, true);  \
+        v8::Local<v8::Value> Promise = Task->ExtractCallbackOrPromise(Args);    \
+        if (Task->IsConcurrent()) { \
+            TNodeJsAsyncUtil::ExecuteOnWorker(Task);    \
+        } else {    \
+            TNodeJsAsyncUtil::ExecuteOnCaller(Task);    \
+        }   \
+        Args.GetReturnValue().Set(Promise);  \
+    };  \
+    JsDeclareInternalFunction(Function);
+
 #define JsDeclareSyncAsync(SyncFun, AsyncFun, Task) \
     JsDeclareSyncFunction(SyncFun, Task)    \
     JsDeclareAsyncFunction(AsyncFun, Task);
@@ -388,6 +403,49 @@ private:
     static uint64 GetTmMSecs(v8::Local<v8::Date>& Date);
 };
 
+//////////////////////////////////////////////////////
+// Node - Shared Vector Buffer
+/// Shares the memory of a vector with JavaScript typed arrays. The vector
+/// becomes a view (TVec::GenExt) on an ArrayBuffer, which owns the memory
+/// and is kept alive by this object. Supported for TFlt (Float64Array) and
+/// TInt (Int32Array) elements.
+template <class TVal>
+class TNodeJsVecBuf {
+private:
+    /// array buffer owning the shared memory
+    v8::Persistent<v8::ArrayBuffer> Buffer;
+    /// offset of the first element in the array buffer
+    size_t ByteOffset;
+    /// first element, used to detect that the vector moved to other memory
+    const TVal* ValT;
+
+public:
+    TNodeJsVecBuf(): ByteOffset(0), ValT(nullptr) { }
+    ~TNodeJsVecBuf() { Buffer.Reset(); }
+
+    /// true when the vector is a view on the shared buffer
+    bool IsShared(const TVec<TVal>& Vec) const {
+        return !Buffer.IsEmpty() && Vec.IsExt() && Vec.BegI() == ValT; }
+    /// shares the memory of the typed array and returns its first element,
+    /// which the caller wraps with GenExt
+    TVal* Adopt(const v8::Local<v8::TypedArray>& TypedArray);
+    /// returns a typed array over the vector; the first call hands the memory
+    /// of the vector over to an array buffer without copying it
+    v8::Local<v8::TypedArray> GetTypedArray(TVec<TVal>& Vec);
+    /// copies a shared vector into its own memory, so it can change its length
+    void Unshare(TVec<TVal>& Vec);
+
+    /// true when the value is a typed array of the element type
+    static bool IsTypedArray(const v8::Local<v8::Value>& Val) { return false; }
+
+private:
+    /// creates a typed array of the element type
+    static v8::Local<v8::TypedArray> NewTypedArray(const v8::Local<v8::ArrayBuffer>& ArrayBuffer,
+        const size_t& ByteOffset, const size_t& Len);
+    /// returns the contents of the array buffer
+    static char* GetData(const v8::Local<v8::ArrayBuffer>& ArrayBuffer);
+};
+
 //////////////////////////////////////////////////////
 // Async Stuff
 class TAsyncTask {
@@ -408,6 +466,7 @@ public:
 class TNodeTask: public TAsyncTask {
 private:
     v8::Persistent<v8::Function> Callback;
+    v8::Persistent<v8::Promise::Resolver> Resolver;
     v8::Persistent<v8::Array> ArgPersist;
     PExcept Except;
     bool AsyncP;
@@ -425,6 +484,11 @@ public:
     void AfterRunSync(const v8::FunctionCallbackInfo<v8::Value>& Args);
 
     void ExtractCallback(const v8::FunctionCallbackInfo<v8::Value>& Args);
+    /// extracts the callback when it is the last argument, otherwise creates a
+    /// promise which is settled with the result; returns the promise or undefined
+    v8::Local<v8::Value> ExtractCallbackOrPromise(const v8::FunctionCallbackInfo<v8::Value>& Args);
+    /// can the task run on a worker thread, in parallel with the main thread
+    virtual bool IsConcurrent() const { return true; }
 
     /// sets an exception which happened during task execution
     /// the exception is either passed to the callback or thrown
@@ -519,6 +583,9 @@ public:
             const bool& DelTask);
     /// executes the task on a worker thread
     static void ExecuteOnWorker(TAsyncTask* Task);
+    /// executes the task on the calling thread, for tasks which can not
+    /// run in parallel with the main thread
+    static void ExecuteOnCaller(TAsyncTask* Task);
 };
 
 // include some implementations at the end, so we don't get incomplete types
@@ -189,6 +189,105 @@ TClass* TNodeJsUtil::UnwrapCheckWatcher(v8::Local<v8::Object> Arg) {
     return Obj;
 }
 
+//////////////////////////////////////////////////////
+// Node - Shared Vector Buffer
+
+template <class TVal>
+TVal* TNodeJsVecBuf<TVal>::Adopt(const v8::Local<v8::TypedArray>& TypedArray) {
+    EAssertR(IsTypedArray(TypedArray), "TNodeJsVecBuf::Adopt: typed array does not match the element type!");
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    v8::Local<v8::ArrayBuffer> ArrayBuffer = TypedArray->Buffer();
+    Buffer.Reset(Isolate, ArrayBuffer);
+    ByteOffset = TypedArray->ByteOffset();
+    ValT = (TVal*)(GetData(ArrayBuffer) + ByteOffset);
+    return (TVal*)ValT;
+}
+
+template <class TVal>
+v8::Local<v8::TypedArray> TNodeJsVecBuf<TVal>::GetTypedArray(TVec<TVal>& Vec) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::EscapableHandleScope HandleScope(Isolate);
+
+    if (!IsShared(Vec)) {
+        const size_t Bytes = (size_t)Vec.Len() * sizeof(TVal);
+        if (Bytes == 0) {
+            // nothing to share
+            return HandleScope.Escape(NewTypedArray(v8::ArrayBuffer::New(Isolate, 0), 0, 0));
+        }
+        // vectors on external memory we do not know about need a private copy first
+        if (Vec.IsExt()) { Vec = TVec<TVal>(Vec); }
+#if NODE_MODULE_VERSION >= 83 /* Node.js >= v14.0.0 */
+        // move the memory to a heap vector, which the backing store deletes
+        // once the array buffer is garbage collected
+        TVec<TVal>* BufVec = new TVec<TVal>(std::move(Vec));
+        std::unique_ptr<v8::BackingStore> BackingStore = v8::ArrayBuffer::NewBackingStore(
+            BufVec->BegI(), Bytes, [](void* Data, size_t Len, void* DeleterData) {
+                delete static_cast<TVec<TVal>*>(DeleterData); }, BufVec);
+        v8::Local<v8::ArrayBuffer> ArrayBuffer = v8::ArrayBuffer::New(Isolate, std::move(BackingStore));
+        Vec.GenExt(BufVec->BegI(), BufVec->Len());
+#else
+        // older V8 can not take over external memory, copy it once to a V8 buffer
+        v8::Local<v8::ArrayBuffer> ArrayBuffer = v8::ArrayBuffer::New(Isolate, Bytes);
+        TVal* BufValT = (TVal*)GetData(ArrayBuffer);
+        memcpy(BufValT, Vec.BegI(), Bytes);
+        Vec.GenExt(BufValT, Vec.Len());
+#endif
+        Buffer.Reset(Isolate, ArrayBuffer);
+        ByteOffset = 0;
+        ValT = Vec.BegI();
+    }
+
+    v8::Local<v8::ArrayBuffer> ArrayBuffer = v8::Local<v8::ArrayBuffer>::New(Isolate, Buffer);
+    return HandleScope.Escape(NewTypedArray(ArrayBuffer, ByteOffset, Vec.Len()));
+}
+
+template <class TVal>
+void TNodeJsVecBuf<TVal>::Unshare(TVec<TVal>& Vec) {
+    if (IsShared(Vec)) { Vec = TVec<TVal>(Vec); }
+    Buffer.Reset();
+    ByteOffset = 0;
+    ValT = nullptr;
+}
+
+template <class TVal>
+v8::Local<v8::TypedArray> TNodeJsVecBuf<TVal>::NewTypedArray(const v8::Local<v8::ArrayBuffer>& ArrayBuffer,
+        const size_t& ByteOffset, const size_t& Len) {
+    throw TExcept::New("TNodeJsVecBuf: typed arrays are only supported for TFlt and TInt vectors!");
+}
+
+template <class TVal>
+char* TNodeJsVecBuf<TVal>::GetData(const v8::Local<v8::ArrayBuffer>& ArrayBuffer) {
+#if NODE_MODULE_VERSION >= 83 /* Node.js >= v14.0.0 */
+    return (char*)ArrayBuffer->GetBackingStore()->Data();
+#else
+    return (char*)ArrayBuffer->GetContents().Data();
+#endif
+}
+
+template <>
+inline bool TNodeJsVecBuf<TFlt>::IsTypedArray(const v8::Local<v8::Value>& Val) {
+    return Val->IsFloat64Array();
+}
+
+template <>
+inline bool TNodeJsVecBuf<TInt>::IsTypedArray(const v8::Local<v8::Value>& Val) {
+    return Val->IsInt32Array();
+}
+
+template <>
+inline v8::Local<v8::TypedArray> TNodeJsVecBuf<TFlt>::NewTypedArray(const v8::Local<v8::ArrayBuffer>& ArrayBuffer,
+        const size_t& ByteOffset, const size_t& Len) {
+    return v8::Float64Array::New(ArrayBuffer, ByteOffset, Len);
+}
+
+template <>
+inline v8::Local<v8::TypedArray> TNodeJsVecBuf<TInt>::NewTypedArray(const v8::Local<v8::ArrayBuffer>& ArrayBuffer,
+        const size_t& ByteOffset, const size_t& Len) {
+    return v8::Int32Array::New(ArrayBuffer, ByteOffset, Len);
+}
+
 //////////////////////////////////////////////////////
 // Node - Asynchronous Utilities
 
@@ -349,6 +349,45 @@ void TNodeJsQm::flags(v8::Local<v8::Name> Name, const v8::PropertyCallbackInfo<v
     Info.GetReturnValue().Set(JsObj);
 }
 
+///////////////////////////////
+// NodeJs QMiner Base Read Task
+TNodeJsBaseReadTask::TNodeJsBaseReadTask(const v8::FunctionCallbackInfo<v8::Value>& Args, const bool& IsAsync):
+        TNodeTask(Args, IsAsync), ConcurrentP(false), PendingP(false) { }
+
+TNodeJsBaseReadTask::~TNodeJsBaseReadTask() {
+    if (PendingP) { Watcher->DelReadTask(); }
+}
+
+v8::Local<v8::Function> TNodeJsBaseReadTask::GetCallback(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    return TNodeJsUtil::GetArgFun(Args, Args.Length() - 1);
+}
+
+void TNodeJsBaseReadTask::SetBase(const TWPt<TQm::TBase>& _Base, const PNodeJsBaseWatcher& _Watcher) {
+    Base = _Base; Watcher = _Watcher;
+    Watcher->AddReadTask(); PendingP = true;
+    // stores which cache records on read must only be read from the main thread
+    ConcurrentP = Base->IsConcurrentRead();
+}
+
+void TNodeJsBaseReadTask::Run() {
+    try {
+        if (ConcurrentP) {
+            // keep writers out while reading from the worker thread
+            TReadLock Lock(Base->GetDataRWLock());
+            RunRead();
+        } else {
+            RunRead();
+        }
+    } catch (const PExcept& Except) {
+        SetExcept(Except);
+    }
+}
+
+void TNodeJsBaseReadTask::AfterRun() {
+    if (PendingP) { Watcher->DelReadTask(); PendingP = false; }
+    TNodeTask::AfterRun();
+}
+
 ///////////////////////////////
 // NodeJs QMiner Base
 v8::Persistent<v8::Function> TNodeJsBase::Constructor;
@@ -383,8 +422,15 @@ void TNodeJsBase::Init(v8::Local<v8::Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "createJsStore", _createJsStore);
     NODE_SET_PROTOTYPE_METHOD(tpl, "addJsStoreCallback", _addJsStoreCallback);
     NODE_SET_PROTOTYPE_METHOD(tpl, "search", _search);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "searchAsync", _searchAsync);
     NODE_SET_PROTOTYPE_METHOD(tpl, "garbageCollect", _garbageCollect);
     NODE_SET_PROTOTYPE_METHOD(tpl, "partialFlush", _partialFlush);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "checkpoint", _checkpoint);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "startFlusher", _startFlusher);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "stopFlusher", _stopFlusher);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "openWal", _openWal);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "closeWal", _closeWal);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "walStreamAggr", _walStreamAggr);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getStats", _getStats);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getStreamAggr", _getStreamAggr);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getStreamAggrNames", _getStreamAggrNames);
@@ -542,6 +588,7 @@ void TNodeJsBase::close(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::HandleScope HandleScope(Isolate);
     // unwrap
     TNodeJsBase* JsBase = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsBase>(Args.Holder());
+    QmAssertR(!JsBase->Watcher->IsReadTasks(), "Base.close: asynchronous reads are still running");
 
     JsBase->Watcher->Close();
 
@@ -734,6 +781,25 @@ void TNodeJsBase::search(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     Args.GetReturnValue().Set(TNodeJsUtil::NewInstance<TNodeJsRecSet>(new TNodeJsRecSet(RecSet, JsBase->Watcher)));
 }
 
+TNodeJsBase::TSearchTask::TSearchTask(const v8::FunctionCallbackInfo<v8::Value>& Args, const bool& IsAsync):
+        TNodeJsBaseReadTask(Args, IsAsync) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    TNodeJsBase* JsBase = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsBase>(Args.Holder());
+    // parse the query here, parsing looks up words in the index vocabulary
+    Query = TQm::TQuery::New(JsBase->Base, TNodeJsUtil::GetArgJson(Args, 0));
+    SetBase(JsBase->Base, JsBase->Watcher);
+}
+
+void TNodeJsBase::TSearchTask::RunRead() {
+    RecSet = Base->Search(Query);
+}
+
+v8::Local<v8::Value> TNodeJsBase::TSearchTask::WrapResult() {
+    return TNodeJsUtil::NewInstance<TNodeJsRecSet>(new TNodeJsRecSet(RecSet, Watcher));
+}
+
 void TNodeJsBase::garbageCollect(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
@@ -762,6 +828,79 @@ void TNodeJsBase::partialFlush(const v8::FunctionCallbackInfo<v8::Value>& Args)
     Args.GetReturnValue().Set(v8::Integer::New(Isolate, res));
 }
 
+void TNodeJsBase::checkpoint(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+    // unwrap
+    TNodeJsBase* JsBase = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsBase>(Args.Holder());
+    TWPt<TQm::TBase> Base = JsBase->Base;
+
+    Base->Checkpoint();
+    Args.GetReturnValue().Set(Nan::Undefined());
+}
+
+void TNodeJsBase::startFlusher(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+    // unwrap
+    TNodeJsBase* JsBase = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsBase>(Args.Holder());
+    TWPt<TQm::TBase> Base = JsBase->Base;
+
+    const int IntervalMSecs = TNodeJsUtil::GetArgInt32(Args, 0, 1000);
+    const int BudgetMSecs = TNodeJsUtil::GetArgInt32(Args, 1, 50);
+
+    Base->StartFlusher(IntervalMSecs, BudgetMSecs);
+    Args.GetReturnValue().Set(Nan::Undefined());
+}
+
+void TNodeJsBase::stopFlusher(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+    // unwrap
+    TNodeJsBase* JsBase = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsBase>(Args.Holder());
+    TWPt<TQm::TBase> Base = JsBase->Base;
+
+    Base->StopFlusher();
+    Args.GetReturnValue().Set(Nan::Undefined());
+}
+
+void TNodeJsBase::openWal(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+    // unwrap
+    TNodeJsBase* JsBase = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsBase>(Args.Holder());
+    TWPt<TQm::TBase> Base = JsBase->Base;
+
+    PJsonVal ParamVal = TNodeJsUtil::IsArg(Args, 0) ? TNodeJsUtil::GetArgJson(Args, 0) : TJsonVal::NewObj();
+
+    Base->OpenWal(ParamVal);
+    Args.GetReturnValue().Set(Nan::Undefined());
+}
+
+void TNodeJsBase::closeWal(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+    // unwrap
+    TNodeJsBase* JsBase = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsBase>(Args.Holder());
+    TWPt<TQm::TBase> Base = JsBase->Base;
+
+    Base->CloseWal();
+    Args.GetReturnValue().Set(Nan::Undefined());
+}
+
+void TNodeJsBase::walStreamAggr(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+    // unwrap
+    TNodeJsBase* JsBase = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsBase>(Args.Holder());
+    TWPt<TQm::TBase> Base = JsBase->Base;
+
+    const TStr StreamAggrNm = TNodeJsUtil::GetArgStr(Args, 0);
+
+    Base->WalStreamAggr(StreamAggrNm);
+    Args.GetReturnValue().Set(Nan::Undefined());
+}
+
 void TNodeJsBase::getStats(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
@@ -830,6 +969,7 @@ void TNodeJsStore::Init(v8::Local<v8::Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "each", _each);
     NODE_SET_PROTOTYPE_METHOD(tpl, "map", _map);
     NODE_SET_PROTOTYPE_METHOD(tpl, "push", _push);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "pushBatch", _pushBatch);
     NODE_SET_PROTOTYPE_METHOD(tpl, "newRecord", _newRecord);
     NODE_SET_PROTOTYPE_METHOD(tpl, "newRecordSet", _newRecordSet);
     NODE_SET_PROTOTYPE_METHOD(tpl, "sample", _sample);
@@ -840,6 +980,8 @@ void TNodeJsStore::Init(v8::Local<v8::Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "key", _key);
     NODE_SET_PROTOTYPE_METHOD(tpl, "resetStreamAggregates", _resetStreamAggregates);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getStreamAggrNames", _getStreamAggrNames);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "getStreamAggrParams", _getStreamAggrParams);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "setStreamAggrParams", _setStreamAggrParams);
     NODE_SET_PROTOTYPE_METHOD(tpl, "toJSON", _toJSON);
     NODE_SET_PROTOTYPE_METHOD(tpl, "clear", _clear);
     NODE_SET_PROTOTYPE_METHOD(tpl, "getVector", _getVector);
@@ -1110,9 +1252,18 @@ void TNodeJsStore::push(const v8::FunctionCallbackInfo<v8::Value>& Args) {
         // check we can write
         QmAssertR(!Base->IsRdOnly(), "Base opened as read-only");
 
-        const PJsonVal RecVal = TNodeJsUtil::GetArgJson(Args, 0);
+        PJsonVal RecVal;
+        if (TNodeJsUtil::IsArgStr(Args, 0)) {
+            // parse JSON string directly, avoids building a JavaScript object
+            bool Ok = true; TStr MsgStr;
+            RecVal = TJsonVal::GetValFromStr(TNodeJsUtil::GetArgStr(Args, 0), Ok, MsgStr);
+            QmAssertR(Ok, "Store.push: invalid JSON string: " + MsgStr);
+        } else {
+            RecVal = TNodeJsUtil::GetArgJson(Args, 0);
+        }
         const bool TriggerEvents = TNodeJsUtil::GetArgBool(Args, 1, true);
 
+        TQm::TBase::TDataLock Lock(Store->GetBase());
         const uint64 RecId = Store->AddRec(RecVal, TriggerEvents);
 
         Args.GetReturnValue().Set(v8::Integer::NewFromUnsigned(Isolate, (uint32_t)RecId));
@@ -1122,6 +1273,127 @@ void TNodeJsStore::push(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     }
 }
 
+void TNodeJsStore::pushBatch(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    try {
+        TNodeJsStore* JsStore = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsStore>(Args.Holder());
+        TWPt<TQm::TStore> Store = JsStore->Store;
+        TWPt<TQm::TBase> Base = JsStore->Store->GetBase();
+
+        // check we can write
+        QmAssertR(!Base->IsRdOnly(), "Base opened as read-only");
+        QmAssertR(TNodeJsUtil::IsArgObj(Args, 0), "Store.pushBatch: first argument expected to be an object");
+        const bool TriggerEvents = TNodeJsUtil::GetArgBool(Args, 1, true);
+
+        // collect columns and their lengths
+        v8::Local<v8::Object> JsBatch = TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[0]));
+        v8::Local<v8::Array> FieldNmV = TNodeJsUtil::ToLocal(Nan::GetOwnPropertyNames(JsBatch));
+        TIntV FieldIdV; TVec<v8::Local<v8::Object> > JsColV;
+        int Recs = -1;
+        for (uint32_t FieldN = 0; FieldN < FieldNmV->Length(); FieldN++) {
+            v8::Local<v8::Value> JsFieldNm = TNodeJsUtil::ToLocal(Nan::Get(FieldNmV, FieldN));
+            const TStr FieldNm(*Nan::Utf8String(JsFieldNm));
+            QmAssertR(Store->IsFieldNm(FieldNm), "Store.pushBatch: unknown field " + FieldNm);
+            v8::Local<v8::Value> JsCol = TNodeJsUtil::ToLocal(Nan::Get(JsBatch, JsFieldNm));
+            int ColLen = -1;
+            if (JsCol->IsArray()) {
+                ColLen = (int)v8::Local<v8::Array>::Cast(JsCol)->Length();
+            } else if (JsCol->IsTypedArray()) {
+                ColLen = (int)v8::Local<v8::TypedArray>::Cast(JsCol)->Length();
+            } else {
+                throw TQm::TQmExcept::New("Store.pushBatch: field " + FieldNm + " should be an array");
+            }
+            QmAssertR(Recs == -1 || Recs == ColLen, "Store.pushBatch: field " + FieldNm + " has different number of values");
+            Recs = ColLen;
+            FieldIdV.Add(Store->GetFieldId(FieldNm));
+            JsColV.Add(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(JsCol)));
+        }
+
+        // copy values to the batch columns
+        TQm::TRecBatch RecBatch(Store, TInt::GetMx(Recs, 0));
+        for (int ColN = 0; ColN < FieldIdV.Len(); ColN++) {
+            const int FieldId = FieldIdV[ColN];
+            const TQm::TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
+            v8::Local<v8::Object> JsCol = JsColV[ColN];
+            // remember which values were null, they can be set only after the column is added
+            TIntV NullRecNV;
+            if (Desc.IsStr()) {
+                TStrV StrV(Recs, 0);
+                for (int RecN = 0; RecN < Recs; RecN++) {
+                    v8::Local<v8::Value> JsVal = TNodeJsUtil::ToLocal(Nan::Get(JsCol, RecN));
+                    if (JsVal->IsNull()) { NullRecNV.Add(RecN); StrV.Add(TStr()); continue; }
+                    QmAssertR(JsVal->IsString(), "Field " + Desc.GetFieldNm() + " not string");
+                    StrV.Add(TStr(*Nan::Utf8String(JsVal)));
+                }
+                RecBatch.AddFieldStr(FieldId, StrV);
+            } else if (Desc.IsTm()) {
+                TUInt64V TmMSecsV(Recs, 0);
+                for (int RecN = 0; RecN < Recs; RecN++) {
+                    v8::Local<v8::Value> JsVal = TNodeJsUtil::ToLocal(Nan::Get(JsCol, RecN));
+                    if (JsVal->IsNull()) { NullRecNV.Add(RecN); TmMSecsV.Add(0); continue; }
+                    TmMSecsV.Add(TNodeJsUtil::GetTmMSecs(JsVal));
+                }
+                RecBatch.AddFieldTmMSecs(FieldId, TmMSecsV);
+            } else if (Desc.IsFlt() || Desc.IsSFlt()) {
+                TFltV FltV(Recs, 0);
+                for (int RecN = 0; RecN < Recs; RecN++) {
+                    v8::Local<v8::Value> JsVal = TNodeJsUtil::ToLocal(Nan::Get(JsCol, RecN));
+                    if (JsVal->IsNull()) { NullRecNV.Add(RecN); FltV.Add(0.0); continue; }
+                    QmAssertR(JsVal->IsNumber(), "Field " + Desc.GetFieldNm() + " not numeric");
+                    FltV.Add(Nan::To<double>(JsVal).FromJust());
+                }
+                RecBatch.AddFieldFlt(FieldId, FltV);
+            } else if (Desc.IsUInt64()) {
+                TUInt64V UInt64V(Recs, 0);
+                for (int RecN = 0; RecN < Recs; RecN++) {
+                    v8::Local<v8::Value> JsVal = TNodeJsUtil::ToLocal(Nan::Get(JsCol, RecN));
+                    if (JsVal->IsNull()) { NullRecNV.Add(RecN); UInt64V.Add(0); continue; }
+                    QmAssertR(JsVal->IsNumber(), "Field " + Desc.GetFieldNm() + " not numeric");
+                    UInt64V.Add((uint64)Nan::To<double>(JsVal).FromJust());
+                }
+                RecBatch.AddFieldUInt64(FieldId, UInt64V);
+            } else if (Desc.IsBool()) {
+                TVec<TInt64> IntV(Recs, 0);
+                for (int RecN = 0; RecN < Recs; RecN++) {
+                    v8::Local<v8::Value> JsVal = TNodeJsUtil::ToLocal(Nan::Get(JsCol, RecN));
+                    if (JsVal->IsNull()) { NullRecNV.Add(RecN); IntV.Add(0); continue; }
+                    QmAssertR(JsVal->IsBoolean(), "Field " + Desc.GetFieldNm() + " not boolean");
+                    IntV.Add(Nan::To<bool>(JsVal).FromJust() ? 1 : 0);
+                }
+                RecBatch.AddFieldInt(FieldId, IntV);
+            } else {
+                // remaining scalar types are integers, batch reports unsupported ones
+                TVec<TInt64> IntV(Recs, 0);
+                for (int RecN = 0; RecN < Recs; RecN++) {
+                    v8::Local<v8::Value> JsVal = TNodeJsUtil::ToLocal(Nan::Get(JsCol, RecN));
+                    if (JsVal->IsNull()) { NullRecNV.Add(RecN); IntV.Add(0); continue; }
+                    QmAssertR(JsVal->IsNumber(), "Field " + Desc.GetFieldNm() + " not integer");
+                    IntV.Add(Nan::To<int64>(JsVal).FromJust());
+                }
+                RecBatch.AddFieldInt(FieldId, IntV);
+            }
+            for (int NullN = 0; NullN < NullRecNV.Len(); NullN++) {
+                RecBatch.SetFieldNull(FieldId, NullRecNV[NullN]);
+            }
+        }
+
+        TUInt64V RecIdV;
+        TQm::TBase::TDataLock Lock(Store->GetBase());
+        Store->AddRecBatch(RecBatch, RecIdV, TriggerEvents);
+
+        v8::Local<v8::Array> JsRecIdV = v8::Array::New(Isolate, RecIdV.Len());
+        for (int RecN = 0; RecN < RecIdV.Len(); RecN++) {
+            Nan::Set(JsRecIdV, RecN, v8::Number::New(Isolate, (double)RecIdV[RecN]));
+        }
+        Args.GetReturnValue().Set(JsRecIdV);
+    }
+    catch (const PExcept& Except) {
+        throw TQm::TQmExcept::New("[except] " + Except->GetMsgStr());
+    }
+}
+
 void TNodeJsStore::newRecord(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
@@ -1338,6 +1610,42 @@ void TNodeJsStore::getStreamAggrNames(const v8::FunctionCallbackInfo<v8::Value>&
     }
 }
 
+void TNodeJsStore::getStreamAggrParams(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    try {
+        TNodeJsStore* JsStore = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsStore>(Args.Holder());
+        TWPt<TQm::TStore>& Store = JsStore->Store;
+        const TWPt<TQm::TBase>& Base = JsStore->Store->GetBase();
+
+        PJsonVal ParamVal = Base->GetStreamAggrSet(Store->GetStoreId())->GetParams();
+        Args.GetReturnValue().Set(TNodeJsUtil::ParseJson(Isolate, ParamVal));
+    }
+    catch (const PExcept& Except) {
+        throw TQm::TQmExcept::New("[except] " + Except->GetMsgStr());
+    }
+}
+
+void TNodeJsStore::setStreamAggrParams(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    QmAssertR(Args.Length() == 1 && Args[0]->IsObject(), "store.setStreamAggrParams: expects one object argument");
+    try {
+        TNodeJsStore* JsStore = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsStore>(Args.Holder());
+        TWPt<TQm::TStore>& Store = JsStore->Store;
+        const TWPt<TQm::TBase>& Base = JsStore->Store->GetBase();
+
+        PJsonVal ParamVal = TNodeJsUtil::GetArgJson(Args, 0);
+        Base->GetStreamAggrSet(Store->GetStoreId())->SetParams(ParamVal);
+        Args.GetReturnValue().Set(Args.Holder());
+    }
+    catch (const PExcept& Except) {
+        throw TQm::TQmExcept::New("[except] " + Except->GetMsgStr());
+    }
+}
+
 void TNodeJsStore::toJSON(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
@@ -1360,6 +1668,7 @@ void TNodeJsStore::clear(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 
     try {
         TNodeJsStore* JsStore = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsStore>(Args.Holder());
+        TQm::TBase::TDataLock Lock(JsStore->Store->GetBase());
         if (TNodeJsUtil::IsArg(Args, 0)) {
             const int DelRecs = TNodeJsUtil::GetArgInt32(Args, 0, (int)JsStore->Store->GetRecs());
             JsStore->Store->DeleteFirstRecs(DelRecs);
@@ -1401,7 +1710,7 @@ void TNodeJsStore::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 Iter->Next();
             }
 
-            Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsInt16()) {
@@ -1413,7 +1722,7 @@ void TNodeJsStore::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 Iter->Next();
             }
 
-            Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsInt64()) {
@@ -1425,7 +1734,7 @@ void TNodeJsStore::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 Iter->Next();
             }
 
-            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsByte()) {
@@ -1437,7 +1746,7 @@ void TNodeJsStore::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 Iter->Next();
             }
 
-            Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsUInt()) {
@@ -1447,7 +1756,7 @@ void TNodeJsStore::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV[RecN] = (double)JsStore->Store->GetFieldUInt(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsUInt16()) {
@@ -1457,7 +1766,7 @@ void TNodeJsStore::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV[RecN] = (double)JsStore->Store->GetFieldUInt16(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsUInt64()) {
@@ -1467,7 +1776,7 @@ void TNodeJsStore::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV[RecN] = (double)JsStore->Store->GetFieldUInt64(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
             return;
         }
 
@@ -1478,7 +1787,7 @@ void TNodeJsStore::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV[RecN] = JsStore->Store->GetFieldStr(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsVec<TStr, TAuxStrV>::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsVec<TStr, TAuxStrV>::New(std::move(ColV)));
             return;
         }
 
@@ -1489,7 +1798,7 @@ void TNodeJsStore::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV[RecN] = (int)JsStore->Store->GetFieldBool(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsFlt()) {
@@ -1499,7 +1808,7 @@ void TNodeJsStore::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV[RecN] = JsStore->Store->GetFieldFlt(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsSFlt()) {
@@ -1509,7 +1818,7 @@ void TNodeJsStore::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV[RecN] = JsStore->Store->GetFieldSFlt(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsTm()) {
@@ -1521,7 +1830,7 @@ void TNodeJsStore::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV[RecN] = (double) TNodeJsUtil::GetJsTimestamp(TTm::GetMSecsFromTm(Tm));
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsFltV()) {
@@ -1561,7 +1870,7 @@ void TNodeJsStore::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.At(0, RecN) = (double)JsStore->Store->GetFieldInt(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsInt16()) {
@@ -1571,7 +1880,7 @@ void TNodeJsStore::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.At(0, RecN) = (double)JsStore->Store->GetFieldInt16(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
             return;
         } else if (Desc.IsInt64()) {
             TFltVV ColV(1, Recs);
@@ -1580,7 +1889,7 @@ void TNodeJsStore::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.At(0, RecN) = (double)JsStore->Store->GetFieldInt64(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
             return;
         } else if (Desc.IsByte()) {
             TFltVV ColV(1, Recs);
@@ -1589,7 +1898,7 @@ void TNodeJsStore::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.At(0, RecN) = (double)JsStore->Store->GetFieldByte(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
             return;
         } else if (Desc.IsUInt()) {
             TFltVV ColV(1, Recs);
@@ -1598,7 +1907,7 @@ void TNodeJsStore::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.At(0, RecN) = (double)JsStore->Store->GetFieldUInt(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
             return;
         } else if (Desc.IsUInt16()) {
             TFltVV ColV(1, Recs);
@@ -1607,7 +1916,7 @@ void TNodeJsStore::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.At(0, RecN) = (double)JsStore->Store->GetFieldUInt16(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
             return;
         } else if (Desc.IsUInt64()) {
             TFltVV ColV(1, Recs);
@@ -1616,7 +1925,7 @@ void TNodeJsStore::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.At(0, RecN) = (double)JsStore->Store->GetFieldUInt64(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsBool()) {
@@ -1626,7 +1935,7 @@ void TNodeJsStore::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.At(0, RecN) = (double)JsStore->Store->GetFieldBool(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsFlt()) {
@@ -1636,7 +1945,7 @@ void TNodeJsStore::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.At(0, RecN) = JsStore->Store->GetFieldFlt(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsSFlt()) {
@@ -1646,7 +1955,7 @@ void TNodeJsStore::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.At(0, RecN) = JsStore->Store->GetFieldSFlt(Iter->GetRecId(), FieldId);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsTm()) {
@@ -1658,7 +1967,7 @@ void TNodeJsStore::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.At(0, RecN) = (double)TTm::GetMSecsFromTm(Tm);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsFltV()) {
@@ -1674,7 +1983,7 @@ void TNodeJsStore::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.SetCol(RecN, Vec);
                 Iter->Next();
             }
-            Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+            Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
             return;
         }
         else if (Desc.IsNumSpV()) {
@@ -1736,6 +2045,20 @@ void TNodeJsStore::triggerOnAddCallbacks(const v8::FunctionCallbackInfo<v8::Valu
         if (Args[0]->IsInt32()) {
             int RecId = TNodeJsUtil::GetArgInt32(Args, 0);
             Store->OnAdd(RecId);
+        } else if (Args[0]->IsArray()) {
+            // batch of record IDs, passed to the aggregates at once
+            v8::Local<v8::Array> JsRecIdV = v8::Local<v8::Array>::Cast(Args[0]);
+            TUInt64V RecIdV(JsRecIdV->Length(), 0);
+            for (uint32_t RecN = 0; RecN < JsRecIdV->Length(); RecN++) {
+                v8::Local<v8::Value> JsRecId = TNodeJsUtil::ToLocal(Nan::Get(JsRecIdV, RecN));
+                QmAssertR(JsRecId->IsNumber(), "Store.triggerOnAddCallbacks: array should contain record IDs");
+                RecIdV.Add((uint64)Nan::To<double>(JsRecId).FromJust());
+            }
+            Store->OnAdd(RecIdV);
+        } else if (TNodeJsUtil::IsArgWrapObj<TNodeJsRecSet>(Args, 0)) {
+            TNodeJsRecSet* JsRecSet = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRecSet>(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[0])));
+            TUInt64V RecIdV; JsRecSet->RecSet->GetRecIdV(RecIdV);
+            Store->OnAdd(RecIdV);
         } else {
             TNodeJsRec* JsRec = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRec>(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[0])));
             Store->OnAdd(JsRec->Rec);
@@ -2111,6 +2434,7 @@ void TNodeJsRec::addJoin(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     // get generic store
     TWPt<TQm::TStore> Store = JsRec->Rec.GetStore();
     const int JoinId = Store->GetJoinId(JoinNm);
+    TQm::TBase::TDataLock Lock(Store->GetBase());
 
     if (Args[1]->IsInt32()) {
         int RecId = TNodeJsUtil::GetArgInt32(Args, 1);
@@ -2144,6 +2468,7 @@ void TNodeJsRec::delJoin(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     // get generic store
     TWPt<TQm::TStore> Store = JsRec->Rec.GetStore();
     const int JoinId = Store->GetJoinId(JoinNm);
+    TQm::TBase::TDataLock Lock(Store->GetBase());
 
     if (Args[1]->IsInt32()) {
         int RecId = TNodeJsUtil::GetArgInt32(Args, 1);
@@ -2241,6 +2566,8 @@ void TNodeJsRec::setField(v8::Local<v8::Name> Name, v8::Local<v8::Value> Value,
     const TWPt<TQm::TStore>& Store = Rec.GetStore();
     TStr FieldNm = TNodeJsUtil::GetStr(TNodeJsUtil::ToLocal(Nan::To<v8::String>(Name)));
     const int FieldId = Store->GetFieldId(FieldNm);
+    // field setters write to the store, keep the background flusher out
+    TQm::TBase::TDataLock Lock(Store->GetBase());
     //TODO: for now we don't support by-value records, fix this
     //QmAssertR(Rec.IsByRef(), "Only records by reference (from stores) supported for setters.");
     // not null, get value
@@ -2568,6 +2895,7 @@ void TNodeJsRecSet::Init(v8::Local<v8::Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "clone", _clone);
     NODE_SET_PROTOTYPE_METHOD(tpl, "join", _join);
     NODE_SET_PROTOTYPE_METHOD(tpl, "aggr", _aggr);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "aggrAsync", _aggrAsync);
     NODE_SET_PROTOTYPE_METHOD(tpl, "trunc", _trunc);
     NODE_SET_PROTOTYPE_METHOD(tpl, "sample", _sample);
     NODE_SET_PROTOTYPE_METHOD(tpl, "shuffle", _shuffle);
@@ -2579,6 +2907,7 @@ void TNodeJsRecSet::Init(v8::Local<v8::Object> exports) {
     NODE_SET_PROTOTYPE_METHOD(tpl, "filterById", _filterById);
     NODE_SET_PROTOTYPE_METHOD(tpl, "filterByFq", _filterByFq);
     NODE_SET_PROTOTYPE_METHOD(tpl, "filterByField", _filterByField);
+    NODE_SET_PROTOTYPE_METHOD(tpl, "filterByFieldAsync", _filterByFieldAsync);
     NODE_SET_PROTOTYPE_METHOD(tpl, "filter", _filter);
     NODE_SET_PROTOTYPE_METHOD(tpl, "split", _split);
     NODE_SET_PROTOTYPE_METHOD(tpl, "deleteRecords", _deleteRecords);
@@ -2682,6 +3011,46 @@ void TNodeJsRecSet::aggr(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     }
 }
 
+TNodeJsRecSet::TAggrTask::TAggrTask(const v8::FunctionCallbackInfo<v8::Value>& Args, const bool& IsAsync):
+        TNodeJsBaseReadTask(Args, IsAsync) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    TNodeJsRecSet* JsRecSet = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRecSet>(Args.Holder());
+    const TWPt<TQm::TStore>& Store = JsRecSet->RecSet->GetStore();
+    PJsonVal AggrVal = TNodeJsUtil::GetArgJson(Args, 0);
+    TQm::TQueryAggr::LoadJson(Store->GetBase(), Store, AggrVal, QueryAggrV);
+    // work on a copy, the record set can change on the main thread in the meantime
+    RecSet = JsRecSet->RecSet->Clone();
+    SetBase(Store->GetBase(), JsRecSet->Watcher);
+}
+
+void TNodeJsRecSet::TAggrTask::RunRead() {
+    // if recset empty, not much to do
+    if (RecSet->Empty()) { return; }
+    for (int QueryAggrN = 0; QueryAggrN < QueryAggrV.Len(); QueryAggrN++) {
+        TQm::PAggr Aggr = TQm::TAggr::New(Base, RecSet, QueryAggrV[QueryAggrN]);
+        AggrValV.Add(Aggr->SaveJson());
+    }
+}
+
+v8::Local<v8::Value> TNodeJsRecSet::TAggrTask::WrapResult() {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::EscapableHandleScope HandleScope(Isolate);
+
+    // same as aggr: null for empty record set, object for one aggregate, array otherwise
+    if (RecSet->Empty()) { return HandleScope.Escape(Nan::Null()); }
+    if (AggrValV.Len() == 1) {
+        v8::Local<v8::Value> AggrVal = TNodeJsUtil::ParseJson(Isolate, AggrValV[0]);
+        return HandleScope.Escape(AggrVal->IsObject() ? AggrVal : v8::Local<v8::Value>(Nan::Null()));
+    }
+    v8::Local<v8::Array> AggrValArr = v8::Array::New(Isolate, AggrValV.Len());
+    for (int AggrValN = 0; AggrValN < AggrValV.Len(); AggrValN++) {
+        Nan::Set(AggrValArr, AggrValN, TNodeJsUtil::ParseJson(Isolate, AggrValV[AggrValN]));
+    }
+    return HandleScope.Escape(AggrValArr);
+}
+
 void TNodeJsRecSet::trunc(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
@@ -2783,7 +3152,10 @@ void TNodeJsRecSet::sortByField(const v8::FunctionCallbackInfo<v8::Value>& Args)
             TNodeJsUtil::GetArgFlt(Args, 1) > 0;
     }
 
-    JsRecSet->RecSet->SortByField(Asc, SortFieldId);
+    const int Limit = TNodeJsUtil::GetArgInt32(Args, 2, -1);
+    QmAssertR(Limit >= -1, "TNodeJsRecSet::sortByField: Argument 2 expected to be a non-negative integer!");
+
+    JsRecSet->RecSet->SortByField(Asc, SortFieldId, Limit);
 
     Args.GetReturnValue().Set(Args.Holder());
 }
@@ -2843,17 +3215,14 @@ void TNodeJsRecSet::filterByFq(const v8::FunctionCallbackInfo<v8::Value>& Args)
     Args.GetReturnValue().Set(Args.Holder());
 }
 
-void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Args) {
-    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
-    v8::HandleScope HandleScope(Isolate);
-    TNodeJsRecSet* JsRecSet = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRecSet>(Args.Holder());
+TNodeJsRecSet::TFieldFilter TNodeJsRecSet::GetFieldFilter(const v8::FunctionCallbackInfo<v8::Value>& Args,
+        const TWPt<TQm::TStore>& Store) {
 
     // get field
     const TStr FieldNm = TNodeJsUtil::GetArgStr(Args, 0);
     int FieldId;
     bool IsFieldJoin = false;
     bool IsIndexJoin = false;
-    const TWPt<TQm::TStore>& Store = JsRecSet->RecSet->GetStore();
     if (Store->IsFieldNm(FieldNm)) {
         // normal field
         FieldId = Store->GetFieldId(FieldNm);
@@ -2878,7 +3247,7 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
         QmAssertR(is_ok, "RecordSet.filterByField: invalid field name " + FieldNm);
     }
 
-    const TQm::TFieldDesc& Desc = JsRecSet->RecSet->GetStore()->GetFieldDesc(FieldId);
+    const TQm::TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
     // parse filter according to field type
     if (IsIndexJoin) {
         uint64 MnVal = TUInt64::Mn;
@@ -2889,7 +3258,7 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
         if (Args.Length() >= 3 && !TNodeJsUtil::IsArgNull(Args, 2) && TNodeJsUtil::IsArgFlt(Args, 2)) {
             MxVal = static_cast<uint64> (TNodeJsUtil::GetArgFlt(Args, 2));
         }
-        JsRecSet->RecSet->FilterByIndexJoin(Store->GetBase(), FieldId, MnVal, MxVal);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByIndexJoin(Store->GetBase(), FieldId, MnVal, MxVal); };
     } else if (IsFieldJoin) {
         uint64 MnVal = TUInt64::Mn;
         uint64 MxVal = TUInt64::Mx;
@@ -2899,10 +3268,10 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
         if (Args.Length() >= 3 && !TNodeJsUtil::IsArgNull(Args, 2) && TNodeJsUtil::IsArgFlt(Args, 2)) {
             MxVal = static_cast<uint64> (TNodeJsUtil::GetArgFlt(Args, 2));
         }
-        JsRecSet->RecSet->FilterByFieldSafe(FieldId, MnVal, MxVal);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldSafe(FieldId, MnVal, MxVal); };
     } else if (Desc.IsBool()) {
         const bool Val = TNodeJsUtil::GetArgBool(Args, 1);
-        JsRecSet->RecSet->FilterByFieldBool(FieldId, Val);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldBool(FieldId, Val); };
     } else if (Desc.IsInt()) {
         int MnVal = TInt::Mn;
         int MxVal = TInt::Mx;
@@ -2912,7 +3281,7 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
         if (Args.Length() >= 3 && !TNodeJsUtil::IsArgNull(Args, 2) && TNodeJsUtil::IsArgFlt(Args, 2)) {
             MxVal = TNodeJsUtil::GetArgInt32(Args, 2);
         }
-        JsRecSet->RecSet->FilterByFieldInt(FieldId, MnVal, MxVal);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldInt(FieldId, MnVal, MxVal); };
     } else if (Desc.IsInt16()) {
         int16 MnVal = TInt16::Mn;
         int16 MxVal = TInt16::Mx;
@@ -2922,7 +3291,7 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
         if (Args.Length() >= 3 && !TNodeJsUtil::IsArgNull(Args, 2) && TNodeJsUtil::IsArgFlt(Args, 2)) {
             MxVal = (int16) TNodeJsUtil::GetArgInt32(Args, 2);
         }
-        JsRecSet->RecSet->FilterByFieldInt16(FieldId, MnVal, MxVal);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldInt16(FieldId, MnVal, MxVal); };
     } else if (Desc.IsInt64()) {
         int64 MnVal = TInt64::Mn;
         int64 MxVal = TInt64::Mx;
@@ -2932,7 +3301,7 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
         if (Args.Length() >= 3 && !TNodeJsUtil::IsArgNull(Args, 2) && TNodeJsUtil::IsArgFlt(Args, 2)) {
             MxVal = (int64)TNodeJsUtil::GetArgFlt(Args, 2);
         }
-        JsRecSet->RecSet->FilterByFieldInt64(FieldId, MnVal, MxVal);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldInt64(FieldId, MnVal, MxVal); };
     } else if (Desc.IsByte()) {
         uchar MnVal = TUCh::Mn;
         uchar MxVal = TUCh::Mx;
@@ -2942,15 +3311,15 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
         if (Args.Length() >= 3 && !TNodeJsUtil::IsArgNull(Args, 2) && TNodeJsUtil::IsArgFlt(Args, 2)) {
             MxVal = (uchar)TNodeJsUtil::GetArgInt32(Args, 2);
         }
-        JsRecSet->RecSet->FilterByFieldByte(FieldId, MnVal, MxVal);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldByte(FieldId, MnVal, MxVal); };
     } else if (Desc.IsStr()) {
         if (Args.Length() < 3 || !TNodeJsUtil::IsArgStr(Args, 2)) {
             TStr StrVal = TNodeJsUtil::GetArgStr(Args, 1);
-            JsRecSet->RecSet->FilterByFieldStr(FieldId, StrVal);
+            return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldStr(FieldId, StrVal); };
         } else {
             TStr StrValMin = TNodeJsUtil::GetArgStr(Args, 1);
             TStr StrValMax = TNodeJsUtil::GetArgStr(Args, 2);
-            JsRecSet->RecSet->FilterByFieldStr(FieldId, StrValMin, StrValMax);
+            return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldStr(FieldId, StrValMin, StrValMax); };
         }
     } else if (Desc.IsFlt()) {
         double MnVal = TFlt::Mn;
@@ -2961,7 +3330,7 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
         if (Args.Length() >= 3 && !TNodeJsUtil::IsArgNull(Args, 2) && TNodeJsUtil::IsArgFlt(Args, 2)) {
             MxVal = TNodeJsUtil::GetArgFlt(Args, 2);
         }
-        JsRecSet->RecSet->FilterByFieldFlt(FieldId, MnVal, MxVal);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldFlt(FieldId, MnVal, MxVal); };
     } else if (Desc.IsSFlt()) {
         float MnVal = TSFlt::Mn;
         float MxVal = TSFlt::Mx;
@@ -2971,7 +3340,7 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
         if (Args.Length() >= 3 && !TNodeJsUtil::IsArgNull(Args, 2) && TNodeJsUtil::IsArgFlt(Args, 2)) {
             MxVal = (float)TNodeJsUtil::GetArgFlt(Args, 2);
         }
-        JsRecSet->RecSet->FilterByFieldSFlt(FieldId, MnVal, MxVal);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldSFlt(FieldId, MnVal, MxVal); };
     } else if (Desc.IsUInt()) {
         uint MnVal = TUInt::Mn;
         uint MxVal = TUInt::Mx;
@@ -2981,7 +3350,7 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
         if (Args.Length() >= 3 && !TNodeJsUtil::IsArgNull(Args, 2) && TNodeJsUtil::IsArgFlt(Args, 2)) {
             MxVal = static_cast<uint> (TNodeJsUtil::GetArgFlt(Args, 2));
         }
-        JsRecSet->RecSet->FilterByFieldUInt(FieldId, MnVal, MxVal);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldUInt(FieldId, MnVal, MxVal); };
     } else if (Desc.IsUInt16()) {
         uint16 MnVal = TUInt16::Mn;
         uint16 MxVal = TUInt16::Mx;
@@ -2991,7 +3360,7 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
         if (Args.Length() >= 3 && !TNodeJsUtil::IsArgNull(Args, 2) && TNodeJsUtil::IsArgFlt(Args, 2)) {
             MxVal = static_cast<uint16> (TNodeJsUtil::GetArgFlt(Args, 2));
         }
-        JsRecSet->RecSet->FilterByFieldUInt16(FieldId, MnVal, MxVal);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldUInt16(FieldId, MnVal, MxVal); };
     } else if (Desc.IsUInt64()) {
         uint64 MnVal = TUInt64::Mn;
         uint64 MxVal = TUInt64::Mx;
@@ -3001,7 +3370,7 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
         if (Args.Length() >= 3 && !TNodeJsUtil::IsArgNull(Args, 2) && TNodeJsUtil::IsArgFlt(Args, 2)) {
             MxVal = static_cast<uint64_t> (TNodeJsUtil::GetArgFlt(Args, 2));
         }
-        JsRecSet->RecSet->FilterByFieldTm(FieldId, MnVal, MxVal);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldTm(FieldId, MnVal, MxVal); };
     } else if (Desc.IsTm()) {
         uint64 MnTmMSecs = TUInt64::Mn;
         uint64 MxTmMSecs = TUInt64::Mx;
@@ -3026,14 +3395,44 @@ void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Arg
                 MxTmMSecs = TTm::GetWinMSecsFromUnixMSecs(static_cast<uint64_t> (TNodeJsUtil::GetArgFlt(Args, 2)));
             }
         }
-        JsRecSet->RecSet->FilterByFieldTm(FieldId, MnTmMSecs, MxTmMSecs);
+        return [=](const TQm::PRecSet& RecSet) { RecSet->FilterByFieldTm(FieldId, MnTmMSecs, MxTmMSecs); };
     } else {
         throw TQm::TQmExcept::New("Unsupported filed type for record set filtering: " + Desc.GetFieldTypeStr());
     }
+}
+
+void TNodeJsRecSet::filterByField(const v8::FunctionCallbackInfo<v8::Value>& Args) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+    TNodeJsRecSet* JsRecSet = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRecSet>(Args.Holder());
+
+    // parse and apply the filter
+    GetFieldFilter(Args, JsRecSet->RecSet->GetStore())(JsRecSet->RecSet);
 
     Args.GetReturnValue().Set(Args.Holder());
 }
 
+TNodeJsRecSet::TFilterByFieldTask::TFilterByFieldTask(const v8::FunctionCallbackInfo<v8::Value>& Args, const bool& IsAsync):
+        TNodeJsBaseReadTask(Args, IsAsync) {
+    v8::Isolate* Isolate = v8::Isolate::GetCurrent();
+    v8::HandleScope HandleScope(Isolate);
+
+    TNodeJsRecSet* JsRecSet = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRecSet>(Args.Holder());
+    const TWPt<TQm::TStore>& Store = JsRecSet->RecSet->GetStore();
+    Filter = GetFieldFilter(Args, Store);
+    // filter a copy, the result is a new record set
+    RecSet = JsRecSet->RecSet->Clone();
+    SetBase(Store->GetBase(), JsRecSet->Watcher);
+}
+
+void TNodeJsRecSet::TFilterByFieldTask::RunRead() {
+    Filter(RecSet);
+}
+
+v8::Local<v8::Value> TNodeJsRecSet::TFilterByFieldTask::WrapResult() {
+    return TNodeJsUtil::NewInstance<TNodeJsRecSet>(new TNodeJsRecSet(RecSet, Watcher));
+}
+
 void TNodeJsRecSet::filter(const v8::FunctionCallbackInfo<v8::Value>& Args) {
     v8::Isolate* Isolate = v8::Isolate::GetCurrent();
     v8::HandleScope HandleScope(Isolate);
@@ -3273,7 +3672,7 @@ void TNodeJsRecSet::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.Add(Store->GetFieldInt(RecId, FieldId));
             }
         }
-        Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(std::move(ColV)));
         return;
     } else if (Desc.IsInt16()) {
         TIntV ColV(Recs, 0);
@@ -3283,7 +3682,7 @@ void TNodeJsRecSet::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.Add(Store->GetFieldInt16(RecId, FieldId));
             }
         }
-        Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(std::move(ColV)));
         return;
     } else if (Desc.IsInt64()) {
         TFltV ColV(Recs, 0);
@@ -3293,7 +3692,7 @@ void TNodeJsRecSet::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.Add((double)Store->GetFieldInt64(RecId, FieldId));
             }
         }
-        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
         return;
     } else if (Desc.IsByte()) {
         TIntV ColV(Recs, 0);
@@ -3303,7 +3702,7 @@ void TNodeJsRecSet::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.Add(Store->GetFieldByte(RecId, FieldId));
             }
         }
-        Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(std::move(ColV)));
         return;
     } else if (Desc.IsUInt()) {
         TFltV ColV(Recs, 0);
@@ -3313,7 +3712,7 @@ void TNodeJsRecSet::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.Add((double)Store->GetFieldUInt(RecId, FieldId));
             }
         }
-        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
         return;
     } else if (Desc.IsUInt16()) {
         TFltV ColV(Recs, 0);
@@ -3323,7 +3722,7 @@ void TNodeJsRecSet::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.Add((double)Store->GetFieldUInt16(RecId, FieldId));
             }
         }
-        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
         return;
     } else if (Desc.IsUInt64()) {
         TFltV ColV(Recs, 0);
@@ -3333,7 +3732,7 @@ void TNodeJsRecSet::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.Add((double)Store->GetFieldUInt64(RecId, FieldId));
             }
         }
-        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsStr()) {
@@ -3344,7 +3743,7 @@ void TNodeJsRecSet::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.Add(Store->GetFieldStr(RecId, FieldId));
             }
         }
-        Args.GetReturnValue().Set(TNodeJsVec<TStr, TAuxStrV>::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsVec<TStr, TAuxStrV>::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsBool()) {
@@ -3355,7 +3754,7 @@ void TNodeJsRecSet::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.Add((int)Store->GetFieldBool(RecId, FieldId));
             }
         }
-        Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsVec<TInt, TAuxIntV>::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsFlt()) {
@@ -3366,7 +3765,7 @@ void TNodeJsRecSet::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.Add(Store->GetFieldFlt(RecId, FieldId));
             }
         }
-        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsSFlt()) {
@@ -3377,7 +3776,7 @@ void TNodeJsRecSet::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.Add(Store->GetFieldSFlt(RecId, FieldId));
             }
         }
-        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsTm()) {
@@ -3390,7 +3789,7 @@ void TNodeJsRecSet::getVector(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.Add((double)TTm::GetMSecsFromTm(Tm)); // TODO is this correct?? Shouldn't it be UNIX timestamp???
             }
         }
-        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsVec<TFlt, TAuxFltV>::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsFltV()) {
@@ -3422,7 +3821,7 @@ void TNodeJsRecSet::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
         for (int RecN = 0; RecN < Recs; RecN++) {
             ColV(0, RecN) = (double)Store->GetFieldInt(RecSet()->GetRecId(RecN), FieldId);
         }
-        Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsInt16()) {
@@ -3430,42 +3829,42 @@ void TNodeJsRecSet::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
         for (int RecN = 0; RecN < Recs; RecN++) {
             ColV(0, RecN) = (double)Store->GetFieldInt16(RecSet()->GetRecId(RecN), FieldId);
         }
-        Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
         return;
     } else if (Desc.IsInt64()) {
         TFltVV ColV(1, Recs);
         for (int RecN = 0; RecN < Recs; RecN++) {
             ColV(0, RecN) = (double)Store->GetFieldInt64(RecSet()->GetRecId(RecN), FieldId);
         }
-        Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
         return;
     } else if (Desc.IsByte()) {
         TFltVV ColV(1, Recs);
         for (int RecN = 0; RecN < Recs; RecN++) {
             ColV(0, RecN) = (double)Store->GetFieldByte(RecSet()->GetRecId(RecN), FieldId);
         }
-        Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
         return;
     } else if (Desc.IsUInt()) {
         TFltVV ColV(1, Recs);
         for (int RecN = 0; RecN < Recs; RecN++) {
             ColV(0, RecN) = (double)Store->GetFieldUInt(RecSet()->GetRecId(RecN), FieldId);
         }
-        Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
         return;
     } else if (Desc.IsUInt16()) {
         TFltVV ColV(1, Recs);
         for (int RecN = 0; RecN < Recs; RecN++) {
             ColV(0, RecN) = (double)Store->GetFieldUInt16(RecSet()->GetRecId(RecN), FieldId);
         }
-        Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
         return;
     } else if (Desc.IsUInt64()) {
         TFltVV ColV(1, Recs);
         for (int RecN = 0; RecN < Recs; RecN++) {
             ColV(0, RecN) = (double)Store->GetFieldUInt64(RecSet()->GetRecId(RecN), FieldId);
         }
-        Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsBool()) {
@@ -3473,7 +3872,7 @@ void TNodeJsRecSet::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
         for (int RecN = 0; RecN < Recs; RecN++) {
             ColV(0, RecN) = (double)Store->GetFieldBool(RecSet()->GetRecId(RecN), FieldId);
         }
-        Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsFlt()) {
@@ -3481,7 +3880,7 @@ void TNodeJsRecSet::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
         for (int RecN = 0; RecN < Recs; RecN++) {
             ColV(0, RecN) = Store->GetFieldFlt(RecSet()->GetRecId(RecN), FieldId);
         }
-        Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsSFlt()) {
@@ -3489,7 +3888,7 @@ void TNodeJsRecSet::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
         for (int RecN = 0; RecN < Recs; RecN++) {
             ColV(0, RecN) = Store->GetFieldSFlt(RecSet()->GetRecId(RecN), FieldId);
         }
-        Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsTm()) {
@@ -3499,7 +3898,7 @@ void TNodeJsRecSet::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
             Store->GetFieldTm(RecSet()->GetRecId(RecN), FieldId, Tm);
             ColV(0, RecN) = (double)TTm::GetMSecsFromTm(Tm);
         }
-        Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsFltV()) {
@@ -3514,7 +3913,7 @@ void TNodeJsRecSet::getMatrix(const v8::FunctionCallbackInfo<v8::Value>& Args) {
                 ColV.GetRows(), Vec.Len(), RecN));
             ColV.SetCol(RecN, Vec);
         }
-        Args.GetReturnValue().Set(TNodeJsFltVV::New(ColV));
+        Args.GetReturnValue().Set(TNodeJsFltVV::New(std::move(ColV)));
         return;
     }
     else if (Desc.IsNumSpV()) {
@@ -8,6 +8,7 @@
 #ifndef QMINER_QM_NODEJS
 #define QMINER_QM_NODEJS
 
+#include <functional>
 #include <node.h>
 #include <node_object_wrap.h>
 #include <qminer.h>
@@ -295,6 +296,8 @@ private:
 * @property {string} [name] - Allows using a different name for the key in search queries. This allows for multiple keys to be put against the same field. Default value is the name of the field.
 * @property {string} [vocabulary] - Defines the name of the vocabulary used to store the tokens or values. This can be used indicate to several keys to use the same vocabulary, to save on memory. Supported by `'value'` and `'text'` keys.
 * @property {string} [tokenize] - Defines the tokenizer that is used for tokenizing the values stored in indexed fields. Tokenizer uses same parameters as in bag-of-words feature extractor. Default is english stopword list and no stemmer. Supported by `'text'` keys.
+* @property {boolean} [compress=false] - If true, the inverted index stores lists of records on disk delta encoded with variable-length integers. Saves disk space and IO at the cost of decoding when loading. Supported by `'value'` and `'text'` keys.
+* @property {boolean} [paged=false] - If true, the index keeps its B-tree nodes on disk and only caches recently used ones in memory, so the index does not need to fit in memory. Location keys are then indexed by geohash cells. Supported by `'linear'` and `'location'` keys.
 * @example
 * var qm = require('qminer');
 * // Create a store People which stores only names of persons.
@@ -331,6 +334,10 @@ private:
 * @property {number} duration - The size of the time window (in number of units).
 * @property {string} unit - Defines in which units the window size is specified. Possible options are `'second'`, `'minute'`, `'hour'`, `'day'`, `'week'` or `'month'`.
 * @property {string} [field] - Name of the datetime field, which defines the time of the record. In case it is not given, the insert time is used in its place.
+* @property {string} [partition] - Splits the store into time partitions of the given unit (same options as for `unit`). Garbage collector then
+* removes whole partitions which ended before the window, without reading their time field, so records are kept up to one partition longer.
+* Records of a partition are still deleted from the store and its indexes, but the index is updated in one batch.
+* Records are expected to arrive in time order.
 * @example <caption>Define window by number of records</caption>
 * var qm = require('qminer');
 * // create base
@@ -406,14 +413,50 @@ private:
     friend class TPt<TNodeJsBaseWatcher>;
 public:
     bool OpenP;
-    TNodeJsBaseWatcher() { OpenP = true; }
+    // Number of unfinished asynchronous reads, base can not be closed before they finish
+    int ReadTasks;
+    TNodeJsBaseWatcher() { OpenP = true; ReadTasks = 0; }
     static TPt<TNodeJsBaseWatcher> New() { return new TNodeJsBaseWatcher; }
     void AssertOpen() { EAssertR(OpenP, "Base is closed!"); }
     void Close() { OpenP = false; }
     bool IsClosed() const { return !OpenP; }
+    void AddReadTask() { ReadTasks++; }
+    void DelReadTask() { ReadTasks--; }
+    bool IsReadTasks() const { return ReadTasks > 0; }
 };
 typedef TPt<TNodeJsBaseWatcher> PNodeJsBaseWatcher;
 
+///////////////////////////////
+// NodeJs QMiner Base Read Task
+//   Base for asynchronous tasks which read stores and indexes. Runs on a worker
+//   thread holding the base read lock, so writers wait until it is done. When
+//   some store does not support concurrent reads, it runs on the main thread.
+//   The callback is the optional last argument, without it a promise is returned.
+class TNodeJsBaseReadTask: public TNodeTask {
+protected:
+    TWPt<TQm::TBase> Base;
+    PNodeJsBaseWatcher Watcher;
+private:
+    bool ConcurrentP;
+    bool PendingP;
+
+public:
+    TNodeJsBaseReadTask(const v8::FunctionCallbackInfo<v8::Value>& Args, const bool& IsAsync);
+    ~TNodeJsBaseReadTask();
+
+    v8::Local<v8::Function> GetCallback(const v8::FunctionCallbackInfo<v8::Value>& Args);
+    bool IsConcurrent() const { return ConcurrentP; }
+    void Run();
+    /// Releases the base before the callback, so the callback can close it
+    void AfterRun();
+
+protected:
+    /// Sets the base, called from the constructor of the derived task
+    void SetBase(const TWPt<TQm::TBase>& _Base, const PNodeJsBaseWatcher& _Watcher);
+    /// Does the reading, called while holding the read lock
+    virtual void RunRead() = 0;
+};
+
 /**
 * Base
 * @classdesc Represents the database and holds stores.
@@ -448,9 +491,24 @@ public:
 private:
     // parses arguments, called by javascript constructor
     static TNodeJsBase* NewFromArgs(const v8::FunctionCallbackInfo<v8::Value>& Args);
+
+    class TSearchTask: public TNodeJsBaseReadTask {
+    private:
+        TQm::PQuery Query;
+        TQm::PRecSet RecSet;
+
+    public:
+        TSearchTask(const v8::FunctionCallbackInfo<v8::Value>& Args, const bool& IsAsync);
+        v8::Local<v8::Value> WrapResult();
+
+    protected:
+        void RunRead();
+    };
+
 private:
     /**
-    * Closes the database.
+    * Closes the database. Throws an exception while asynchronous reads
+    * (e.g. {@link module:qm.Base#searchAsync}) are still running.
     * @returns {null} No value is returned.
     * @example
     * // import qm module
@@ -661,6 +719,36 @@ private:
 
     JsDeclareFunction(search);
 
+    /**
+    * Makes a query search on a worker thread. Records added in the meantime wait
+    * for the search to finish. When some store does not support concurrent reads,
+    * the search runs on the main thread.
+    * @param {module:qm~QueryObject} query - Query language JSON object.
+    * @param {function} [callback] - The callback function receiving the error parameter (`err`) and the record set (`rs`).
+    * @returns {Promise<module:qm.RecordSet>} When no callback is given, a promise of the record set that matches the search criterion.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a base with one store
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{
+    *        name: "Cities",
+    *        fields: [{ name: "Name", type: "string" }, { name: "Population", type: "int" }],
+    *        keys: [{ field: "Name", type: "value" }]
+    *    }]
+    * });
+    * base.store("Cities").push({ Name: "Ljubljana", Population: 280000 });
+    * base.store("Cities").push({ Name: "Maribor", Population: 95000 });
+    * // search without blocking the main thread
+    * base.searchAsync({ $from: "Cities", Name: "Maribor" }).then(function (rs) {
+    *    console.log(rs.length); // 1
+    *    base.close();
+    * });
+    */
+    //# exports.Base.prototype.searchAsync = function (query, callback) { return Promise.resolve(Object.create(require('qminer').RecordSet.prototype)); }
+    JsDeclarePromiseFunction(searchAsync, TSearchTask);
+
     /**
     * Calls qminer garbage collector to remove records outside time windows. For application example see {@link module:qm~SchemaTimeWindowDef}.
     * @param {number} [max_time=-1] - Maximal number of time each store can spend on cleaning backlog in milisecons. If -1 then no limit is applied.
@@ -669,7 +757,7 @@ private:
     JsDeclareFunction(garbageCollect);
 
     /**
-    * Base saves dirty data given some time window.
+    * Base saves dirty data given some time window. Throws while the write-ahead log is open.
     * @param {number} [window=500] - Length of available time window in miliseconds.
     * @returns {number} Number of records it flushed.
     * @example
@@ -703,6 +791,110 @@ private:
 
     JsDeclareFunction(partialFlush);
 
+    /**
+    * Saves all stores and the index, so the base can be opened from disk in its current state. When the
+    * write-ahead log is open, it is started again and only keeps updates made after the checkpoint. Writers
+    * wait until the checkpoint is done.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a base with one store
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{ name: "Sensor", fields: [{ name: "Value", type: "float" }] }]
+    * });
+    * base.openWal({ sync: "group" });
+    * base.store("Sensor").push({ Value: 1.0 });
+    * // save the base and empty the log
+    * base.checkpoint();
+    * base.close();
+    */
+    //# exports.Base.prototype.checkpoint = function () { }
+    JsDeclareFunction(checkpoint);
+
+    /**
+    * Starts a background thread which periodically saves dirty data, so that {@link module:qm.Base#partialFlush}
+    * does not need to be called from the application. Each round is limited to the given time budget. The round
+    * which finds nothing left to save makes a {@link module:qm.Base#checkpoint}, reported in {@link module:qm.Base#getStats}
+    * under `flusher`. While the write-ahead log is open, rounds make a checkpoint whenever updates were logged since the
+    * last one. Calling it again restarts the thread with the new parameters.
+    * @param {number} [interval=1000] - Pause between two flushing rounds in milliseconds.
+    * @param {number} [budget=50] - Time one flushing round may spend saving data in milliseconds.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a base with one store
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{ name: "Sensor", fields: [{ name: "Value", type: "float" }] }]
+    * });
+    * // save dirty data every 100ms, spending at most 20ms each time
+    * base.startFlusher(100, 20);
+    * base.store("Sensor").push({ Value: 1.0 });
+    * base.stopFlusher();
+    * base.close();
+    */
+    //# exports.Base.prototype.startFlusher = function (interval, budget) { }
+    JsDeclareFunction(startFlusher);
+
+    /**
+    * Stops the background flushing thread started with {@link module:qm.Base#startFlusher}.
+    */
+    //# exports.Base.prototype.stopFlusher = function () { }
+    JsDeclareFunction(stopFlusher);
+
+    /**
+    * @typedef {object} WalParam
+    * The write-ahead log parameters, used in {@link module:qm.Base#openWal}.
+    * @property {string} [sync='group'] - When the log is written to disk. Possible options:
+    * <br>1. `'rec'` - After each logged update. Slowest, nothing is lost in a crash.
+    * <br>2. `'group'` - After `groupSize` updates, which share one write to disk.
+    * <br>3. `'interval'` - With the first update after `interval` milliseconds passed since the last write. The log
+    * is also written when it is closed.
+    * @property {number} [groupSize=128] - Number of updates written together for `'group'`.
+    * @property {number} [interval=1000] - Time between writes in milliseconds for `'interval'`.
+    */
+
+    /**
+    * Starts logging added, updated and deleted records to a write-ahead log in the base folder. When the
+    * process dies before the base is closed, the updates from the log are replayed the next time the base
+    * is opened. The log is removed when the base is closed and starts again when it is reopened.
+    * The setting is stored with the base. Joins added and deleted with {@link module:qm.Record#$addJoin} and
+    * {@link module:qm.Record#$delJoin} and values set through record fields are logged. The log is replayed over
+    * the base as it was last saved, so while it is open {@link module:qm.Base#partialFlush} makes a
+    * {@link module:qm.Base#checkpoint} instead, which also empties the log.
+    * @param {module:qm~WalParam} [param] - The write-ahead log parameters.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a base with one store
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{ name: "Sensor", fields: [{ name: "Value", type: "float" }] }]
+    * });
+    * // log updates, writing them to disk in groups of 100
+    * base.openWal({ sync: "group", groupSize: 100 });
+    * base.store("Sensor").push({ Value: 1.0 });
+    * base.close();
+    */
+    //# exports.Base.prototype.openWal = function (param) { }
+    JsDeclareFunction(openWal);
+
+    /**
+    * Stops logging updates to the write-ahead log. Updates logged so far stay in the log until the base is closed
+    * or the next {@link module:qm.Base#checkpoint}.
+    */
+    //# exports.Base.prototype.closeWal = function () { }
+    JsDeclareFunction(closeWal);
+
+    /**
+    * Logs the current state of a stream aggregate to the write-ahead log. When the log is replayed, the
+    * state is loaded into the aggregate with the same name once it is created.
+    * @param {string} name - Name of the stream aggregate.
+    */
+    //# exports.Base.prototype.walStreamAggr = function (name) { }
+    JsDeclareFunction(walStreamAggr);
+
     /**
     * @typedef {object} PerformanceStat
     * The performance statistics used to describe {@link module:qm~PerformanceStatBase} and {@link module:qm~PerformanceStatStore}.
@@ -874,9 +1066,29 @@ private:
     JsDeclareFunction(getStreamAggrNames);
 
     /**
-    * Retrieves performance statistics for stream aggregates.
+    * Retrieves performance statistics for stream aggregates. For each aggregate it returns
+    * the total execution time (`msecs`), the memory footprint (`mem`), the number of calls per
+    * callback (`calls.onAdd`, `calls.onStep`, ...), call latencies in milliseconds (`latency.mean`,
+    * `latency.p50`, `latency.p99`, `latency.max`) and memory growth in bytes since the aggregate
+    * was created (`memGrowth`) and since the previous call of this function (`memLastGrowth`).
+    * @returns {Object} Statistics of individual aggregates (`aggregates`), of aggregate types (`types`) and totals.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a base with a simple store
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{ name: "Heat", fields: [{ name: "Celsius", type: "float" }, { name: "Time", type: "datetime" }] }]
+    * });
+    * var store = base.store("Heat");
+    * var tick = store.addStreamAggr({ type: "timeSeriesTick", timestamp: "Time", value: "Celsius" });
+    * store.push({ Time: "2015-06-10T14:13:32.0", Celsius: 25 });
+    * // get the slowest calls of the aggregate
+    * var stats = base.getStreamAggrStats();
+    * var p99 = stats.aggregates.filter(function (aggr) { return aggr.name == tick.name; })[0].latency.p99;
+    * base.close();
     */
-    //# exports.Base.prototype.getStreamAggrStats = function () { }
+    //# exports.Base.prototype.getStreamAggrStats = function () { return { aggregates: [], types: [], count: 0, msecs: 0, mem: 0 }; }
     JsDeclareFunction(getStreamAggrStats);
 
     //!JSIMPLEMENT:src/qminer/qminer.js
@@ -1068,7 +1280,8 @@ private:
 
     /**
     * Adds a record to the store.
-    * @param {object} rec - The added record. The record must be a object corresponding to store schema created at store creation using {@link module:qm~SchemaDef}.
+    * @param {object | string} rec - The added record. The record must be a object corresponding to store schema created at store creation using {@link module:qm~SchemaDef}.
+    * The record can also be given as a JSON string, which is parsed natively and skips the conversion from a JavaScript object.
     * @param {boolean} [triggerEvents=true] - If true, all stream aggregate callbacks `onAdd` will be called after the record is inserted. If false, no stream aggregate will be updated.
     * @returns {number} The ID of the added record.
     * @example
@@ -1102,6 +1315,42 @@ private:
     //# exports.Store.prototype.push = function (rec, triggerEvents) { return 0; }
     JsDeclareFunction(push);
 
+    /**
+    * Adds a batch of records to the store. Records are given by columns and are serialized
+    * directly into the store, without conversion of each record to JSON. Semantics are the same
+    * as calling {@link module:qm.Store#push} for each record, except that the `onAdd` callbacks
+    * of stream aggregates are called after all the records are added.
+    * @param {object} batch - Object mapping field names to arrays (or typed arrays) of values, one value
+    * per record. All arrays must be of the same length. Values of nullable fields can be `null`.
+    * Only fields of scalar types (numeric, boolean, string and datetime) are supported.
+    * @param {boolean} [triggerEvents=true] - If true, all stream aggregate callbacks `onAdd` will be called after the records are inserted. If false, no stream aggregate will be updated.
+    * @returns {Array<number>} The IDs of the added records.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a new base with a store of measurements
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{
+    *        name: "Measurements",
+    *        fields: [
+    *            { name: "Sensor", type: "string" },
+    *            { name: "Value", type: "float" },
+    *            { name: "Time", type: "datetime" }
+    *        ]
+    *    }]
+    * });
+    * // add three measurements at once
+    * base.store("Measurements").pushBatch({
+    *    Sensor: ["a", "b", "a"],
+    *    Value: new Float64Array([1.5, 2.5, 3.5]),
+    *    Time: ["2015-01-01T00:00:00", "2015-01-01T00:00:01", "2015-01-01T00:00:02"]
+    * }); // returns [0, 1, 2]
+    * base.close();
+    */
+    //# exports.Store.prototype.pushBatch = function (batch, triggerEvents) { return [0]; }
+    JsDeclareFunction(pushBatch);
+
     /**
     * Creates a new record of given store. The record is not added to the store.
     * @param {object} obj - An object describing the record.
@@ -1419,6 +1668,62 @@ private:
     //# exports.Store.prototype.getStreamAggrNames = function () { return [""]; }
     JsDeclareFunction(getStreamAggrNames);
 
+    /**
+    * Returns the parameters used when calling the stream aggregates connected to the store.
+    * @returns {Object} The parameters with properties:
+    * <br>1. `threads` - Number of threads used to run independent aggregates. Type `number`.
+    * <br>2. `deterministic` - Aggregates are run by dependency levels on the calling thread. Type `boolean`.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a simple base containing one store
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{
+    *        name: "Laser",
+    *        fields: [
+    *            { name: "Time", type: "datetime" },
+    *            { name: "WaveLength", type: "float" }
+    *        ]
+    *    }]
+    * });
+    * // get the parameters, by default aggregates are called one after another
+    * var params = base.store("Laser").getStreamAggrParams(); // returns { threads: 1, deterministic: false }
+    * base.close();
+    */
+    //# exports.Store.prototype.getStreamAggrParams = function () { return { threads: 1, deterministic: false }; }
+    JsDeclareFunction(getStreamAggrParams);
+
+    /**
+    * Sets the parameters used when calling the stream aggregates connected to the store.
+    * With more than one thread, aggregates are grouped by the aggregates they read from,
+    * and the ones that do not depend on each other are called in parallel. An aggregate
+    * is always called after all its input aggregates.
+    * @param {Object} params - The parameters:
+    * <br>1. `threads` - Number of threads used to run independent aggregates. Type `number`.
+    * <br>2. `deterministic` - If true, aggregates are run by dependency levels on the calling thread. Type `boolean`.
+    * @returns {module:qm.Store} Self.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a simple base containing one store
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{
+    *        name: "Laser",
+    *        fields: [
+    *            { name: "Time", type: "datetime" },
+    *            { name: "WaveLength", type: "float" }
+    *        ]
+    *    }]
+    * });
+    * // call independent stream aggregates using four threads
+    * base.store("Laser").setStreamAggrParams({ threads: 4 });
+    * base.close();
+    */
+    //# exports.Store.prototype.setStreamAggrParams = function (params) { return Object.create(require('qminer').Store.prototype); }
+    JsDeclareFunction(setStreamAggrParams);
+
    /**
     * Returns the store as a JSON.
     * @returns {Object} The store as a JSON.
@@ -1575,8 +1880,10 @@ private:
 
     /**
     * Calls `onAdd` callback on all stream aggregates.
-    * @param {(module:qm.Record | number)} [arg] - The record or record ID which will be passed to `onAdd` callbacks. If the record or record ID is not provided, the last record will be used. Throws exception if the record cannot be provided.
+    * @param {(module:qm.Record | number | Array.<number> | module:qm.RecordSet)} [arg] - The record or record ID which will be passed to `onAdd` callbacks. If the record or record ID is not provided, the last record will be used. Throws exception if the record cannot be provided.
     * <br>Defaults to the last {@link module:qm.Record} in store.
+    * <br>An array of record IDs or a record set is passed to the stream aggregates as one batch. Aggregates which support
+    * batches process all the records with one call, the rest get the records one by one.
     */
     //# exports.Store.prototype.triggerOnAddCallbacks = function (arg) {};
     JsDeclareFunction(triggerOnAddCallbacks);
@@ -2030,6 +2337,36 @@ public:
     // C++ constructors
     TNodeJsRecSet(const TQm::PRecSet& _RecSet, PNodeJsBaseWatcher& _Watcher) : RecSet(_RecSet), Watcher(_Watcher) {}
 private:
+    // filter parsed from filterByField arguments
+    typedef std::function<void(const TQm::PRecSet&)> TFieldFilter;
+    static TFieldFilter GetFieldFilter(const v8::FunctionCallbackInfo<v8::Value>& Args, const TWPt<TQm::TStore>& Store);
+
+    class TAggrTask: public TNodeJsBaseReadTask {
+    private:
+        TQm::PRecSet RecSet;
+        TQm::TQueryAggrV QueryAggrV;
+        TJsonValV AggrValV;
+
+    public:
+        TAggrTask(const v8::FunctionCallbackInfo<v8::Value>& Args, const bool& IsAsync);
+        v8::Local<v8::Value> WrapResult();
+
+    protected:
+        void RunRead();
+    };
+
+    class TFilterByFieldTask: public TNodeJsBaseReadTask {
+    private:
+        TQm::PRecSet RecSet;
+        TFieldFilter Filter;
+
+    public:
+        TFilterByFieldTask(const v8::FunctionCallbackInfo<v8::Value>& Args, const bool& IsAsync);
+        v8::Local<v8::Value> WrapResult();
+
+    protected:
+        void RunRead();
+    };
 
     /**
     * Creates a new instance of the record set.
@@ -2120,6 +2457,32 @@ private:
     //# exports.RecordSet.prototype.aggr = function (aggrQueryJSON) {};
     JsDeclareFunction(aggr);
 
+    /**
+    * Computes aggregates on a worker thread, see {@link module:qm.Base#searchAsync}
+    * for when it runs on the main thread. Works on a copy of the record set.
+    * @param {Object} aggrQueryJSON - Aggregate query, same as the `$aggr` part of a query.
+    * @param {function} [callback] - The callback function receiving the error parameter (`err`) and the aggregates (`res`).
+    * @returns {Promise<Object>} When no callback is given, a promise of the aggregate, or an array
+    * of aggregates when more are given. Resolves to `null` for an empty record set.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a base with one store
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{ name: "Rates", fields: [{ name: "Value", type: "float" }] }]
+    * });
+    * base.store("Rates").push({ Value: 1.0 });
+    * base.store("Rates").push({ Value: 3.0 });
+    * // compute a histogram of values without blocking the main thread
+    * base.store("Rates").allRecords.aggrAsync({ name: "Value", type: "histogram", field: "Value" }).then(function (aggr) {
+    *    console.log(aggr.count); // 2
+    *    base.close();
+    * });
+    */
+    //# exports.RecordSet.prototype.aggrAsync = function (aggrQueryJSON, callback) { return Promise.resolve({}); };
+    JsDeclarePromiseFunction(aggrAsync, TAggrTask);
+
     /**
     * Truncates the first records.
     * @param {number} limit_num - How many records to truncate.
@@ -2305,6 +2668,8 @@ private:
     * Sorts the records according to a specific record field.
     * @param {string} fieldName - The field by which the sort will work.
     * @param {number} [asc=-1] - if `asc` > 0, it sorts in ascending order. Otherwise, it sorts in descending order.
+    * @param {number} [limit] - If given, only the first `limit` records are kept in the record set. This is faster than sorting
+    * all the records and truncating the result afterwards.
     * @returns {module:qm.RecordSet} Self. Records are sorted according to `fieldName` and `asc`.
     * @example
     * // import qm module
@@ -2330,9 +2695,11 @@ private:
     * var recordSet = base.store("TVSeries").allRecords;
     * // sort the records by their "Title" field in ascending order
     * recordSet.sortByField("Title", true); // returns self, record are sorted by their "Title"
+    * // keep only the two series with the most episodes
+    * recordSet.sortByField("NumberOfEpisodes", false, 2); // returns self, with "The Simpsons" and "New Girl"
     * base.close();
     */
-    //# exports.RecordSet.prototype.sortByField = function (fieldName, asc) { return Object.create(require('qminer').RecordSet.prototype); };
+    //# exports.RecordSet.prototype.sortByField = function (fieldName, asc, limit) { return Object.create(require('qminer').RecordSet.prototype); };
     JsDeclareFunction(sortByField);
 
     /**
@@ -2462,6 +2829,34 @@ private:
     //# exports.RecordSet.prototype.filterByField = function (fieldName, minVal, maxVal) { return Object.create(require('qminer').RecordSet.prototype); };
     JsDeclareFunction(filterByField);
 
+    /**
+    * Filters the records like {@link module:qm.RecordSet#filterByField}, but on a worker
+    * thread (see {@link module:qm.Base#searchAsync}) and into a new record set.
+    * @param {string} fieldName - The field by which the records will be filtered.
+    * @param {(string | number)} minVal - Same as for {@link module:qm.RecordSet#filterByField}.
+    * @param {number} [maxVal] - Same as for {@link module:qm.RecordSet#filterByField}.
+    * @param {function} [callback] - The callback function receiving the error parameter (`err`) and the record set (`rs`).
+    * @returns {Promise<module:qm.RecordSet>} When no callback is given, a promise of the new record set
+    * with the records that pass the filter. This record set is not changed.
+    * @example
+    * // import qm module
+    * var qm = require('qminer');
+    * // create a base with one store
+    * var base = new qm.Base({
+    *    mode: "createClean",
+    *    schema: [{ name: "Rates", fields: [{ name: "Value", type: "float" }] }]
+    * });
+    * base.store("Rates").push({ Value: 1.0 });
+    * base.store("Rates").push({ Value: 3.0 });
+    * // keep records with values between 2 and 4
+    * base.store("Rates").allRecords.filterByFieldAsync("Value", 2, 4).then(function (rs) {
+    *    console.log(rs.length); // 1
+    *    base.close();
+    * });
+    */
+    //# exports.RecordSet.prototype.filterByFieldAsync = function (fieldName, minVal, maxVal, callback) { return Promise.resolve(Object.create(require('qminer').RecordSet.prototype)); };
+    JsDeclarePromiseFunction(filterByFieldAsync, TFilterByFieldTask);
+
     /**
     * Keeps only the records that pass the callback function.
     * @param {function} callback - The filter function. It takes one parameter:
@@ -3093,6 +3488,8 @@ public:
     bool Update(const TQm::TRec& Rec) { return false; }
     void AddSpV(const TQm::TRec& Rec, TIntFltKdV& SpV, int& Offset) const;
     void AddFullV(const TQm::TRec& Rec, TFltV& FullV, int& Offset) const;
+    // javascript callbacks can only be called from the main thread
+    bool IsThreadSafe() const { return false; }
     void InvFullV(const TFltV& FullV, int& Offset, TFltV& InvV) const {
         throw TExcept::New("Not implemented yet!", "TJsFuncFtrExt::InvFullV"); }
     double GetVal(const double& InVal) const { throw TExcept::New("Not implemented!"); }
@@ -177,6 +177,8 @@ void TNodeJsStreamAggr::onStep(const v8::FunctionCallbackInfo<v8::Value>& Args)
 
     // unwrap
     TNodeJsStreamAggr* JsSA = ObjectWrap::Unwrap<TNodeJsStreamAggr>(Args.Holder());
+    // record the call in aggregate statistics
+    TQm::TStreamAggrStats::TScope StatsScope(JsSA->SA->GetAggrStats(), TQm::saeStep);
     // if arg 1 exists, get the caller stream aggregate
     if (Args.Length() >= 1) {
         EAssertR(TNodeJsUtil::IsClass(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[0])), TNodeJsStreamAggr::GetClassId()), "Argument expected to be a stream aggregate!");
@@ -197,6 +199,8 @@ void TNodeJsStreamAggr::onTime(const v8::FunctionCallbackInfo<v8::Value>& Args)
     TNodeJsStreamAggr* JsSA = ObjectWrap::Unwrap<TNodeJsStreamAggr>(Args.Holder());
     QmAssertR(Args.Length() >= 1, "sa.onTime should take one argument of type TUInt64");
     const uint64 Time = TNodeJsUtil::GetArgTmMSecs(Args, 0);
+    // record the call in aggregate statistics
+    TQm::TStreamAggrStats::TScope StatsScope(JsSA->SA->GetAggrStats(), TQm::saeTime);
     // if arg 1 exists, get the caller stream aggregate
     if (Args.Length() >= 2) {
         EAssertR(TNodeJsUtil::IsClass(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[1])), TNodeJsStreamAggr::GetClassId()), "Argument expected to be a stream aggregate!");
@@ -218,6 +222,8 @@ void TNodeJsStreamAggr::onAdd(const v8::FunctionCallbackInfo<v8::Value>& Args) {
 
     QmAssertR(Args.Length() >= 1 && Args[0]->IsObject(), "sa.onAdd should take one argument of type TNodeJsRec");
     TNodeJsRec* JsRec = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRec>(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[0])));
+    // record the call in aggregate statistics
+    TQm::TStreamAggrStats::TScope StatsScope(JsSA->SA->GetAggrStats(), TQm::saeAddRec);
     // if arg 1 exists, get the caller stream aggregate
     if (Args.Length() >= 2) {
         EAssertR(TNodeJsUtil::IsClass(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[1])), TNodeJsStreamAggr::GetClassId()), "Argument expected to be a stream aggregate!");
@@ -238,6 +244,8 @@ void TNodeJsStreamAggr::onUpdate(const v8::FunctionCallbackInfo<v8::Value>& Args
     TNodeJsStreamAggr* JsSA = ObjectWrap::Unwrap<TNodeJsStreamAggr>(Args.Holder());
     QmAssertR(Args.Length() >= 1 && Args[0]->IsObject(), "sa.onUpdate should take one argument of type TNodeJsRec");
     TNodeJsRec* JsRec = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRec>(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[0])));
+    // record the call in aggregate statistics
+    TQm::TStreamAggrStats::TScope StatsScope(JsSA->SA->GetAggrStats(), TQm::saeUpdateRec);
     // if arg 1 exists, get the caller stream aggregate
     if (Args.Length() >= 2) {
         EAssertR(TNodeJsUtil::IsClass(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[1])), TNodeJsStreamAggr::GetClassId()), "Argument expected to be a stream aggregate!");
@@ -258,6 +266,8 @@ void TNodeJsStreamAggr::onDelete(const v8::FunctionCallbackInfo<v8::Value>& Args
     TNodeJsStreamAggr* JsSA = ObjectWrap::Unwrap<TNodeJsStreamAggr>(Args.Holder());
     QmAssertR(Args.Length() >= 1 && Args[0]->IsObject(), "sa.onDelete should take one argument of type TNodeJsRec");
     TNodeJsRec* JsRec = TNodeJsUtil::UnwrapCheckWatcher<TNodeJsRec>(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[0])));
+    // record the call in aggregate statistics
+    TQm::TStreamAggrStats::TScope StatsScope(JsSA->SA->GetAggrStats(), TQm::saeDeleteRec);
     // if arg 1 exists, get the caller stream aggregate
     if (Args.Length() >= 2) {
         EAssertR(TNodeJsUtil::IsClass(TNodeJsUtil::ToLocal(Nan::To<v8::Object>(Args[1])), TNodeJsStreamAggr::GetClassId()), "Argument expected to be a stream aggregate!");
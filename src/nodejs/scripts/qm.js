@@ -262,25 +262,43 @@ module.exports = exports = function (pathQmBinary) {
 
     /**
      * Load given file line by line, parse each line to JSON and push it to the store.
+     * Lines are parsed natively by the store, without creating JavaScript objects.
+     * Stream aggregates get the records in batches.
      * @param {String} file - Name of the JSON line file.
      * @param {Number} [limit] - Maximal number of records to load from file.
+     * @param {Number} [batchSize=1000] - Number of records passed to stream aggregates at once.
      * @returns {number} Number of records loaded from file.
      */
-    exports.Store.prototype.loadJson = function (file, limit) {
+    exports.Store.prototype.loadJson = function (file, limit, batchSize) {
         var fin = fs.openRead(file);
         var count = 0;
-        while (!fin.eof) {
-            var line = fin.readLine();
-            if (line == "") { continue; }
-            try {
-                var rec = JSON.parse(line);
-                this.push(rec);
-                // count, GC and report
-                count++;
-                if (limit != undefined && count == limit) { break; }
-            } catch (err) {
-                throw new Error("Error parsing line number: " + count + ", line content:[" + line + "]: " + err);                
+        var batch = [];
+        if (batchSize == undefined) { batchSize = 1000; }
+        var self = this;
+        var flushBatch = function () {
+            var pending = batch; batch = [];
+            if (pending.length > 0) { self.triggerOnAddCallbacks(pending); }
+        };
+        try {
+            while (!fin.eof) {
+                var line = fin.readLine();
+                if (line == "") { continue; }
+                try {
+                    // records which only update existing ones already called update triggers
+                    var length = this.length;
+                    var recId = this.push(line, false);
+                    if (this.length > length) { batch.push(recId); }
+                    // count, GC and report
+                    count++;
+                    if (batch.length >= batchSize) { flushBatch(); }
+                    if (limit != undefined && count == limit) { break; }
+                } catch (err) {
+                    throw new Error("Error parsing line number: " + count + ", line content:[" + line + "]: " + err);
+                }
             }
+        } finally {
+            // records stored before an error still go to stream aggregates
+            flushBatch();
         }
         return count;
     }
@@ -575,6 +575,22 @@ void TTimeSeriesTick::OnAddRec(const TRec& Rec, const TWPt<TStreamAggr>& CallerA
     InitP = true;
 }
 
+void TTimeSeriesTick::OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr) {
+    TScopeStopWatch StopWatch(ExeTm);
+    const int Recs = RecSet->GetRecs();
+    BatchValV.Gen(Recs, 0); BatchTmMSecsV.Gen(Recs, 0);
+    for (int RecN = 0; RecN < Recs; RecN++) {
+        const TRec Rec = RecSet->GetRec(RecN);
+        BatchValV.Add(ValReader.GetFlt(Rec));
+        BatchTmMSecsV.Add(Rec.GetFieldTmMSecs(TimeFieldId));
+    }
+    if (Recs > 0) {
+        TickVal = BatchValV.Last();
+        TmMSecs = BatchTmMSecsV.Last();
+        InitP = true;
+    }
+}
+
 void TTimeSeriesTick::OnTime(const uint64& Time, const TWPt<TStreamAggr>& CallerAggr) {
     TScopeStopWatch StopWatch(ExeTm);
     TmMSecs = Time;
@@ -827,12 +843,28 @@ void TEma::OnStep(const TWPt<TStreamAggr>& CallerAggr) {
     }
 }
 
+void TEma::OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr) {
+    TScopeStopWatch StopWatch(ExeTm);
+    const TFltV& InValV = InAggrBatch->GetBatchFltV();
+    const TUInt64V& InTmMSecsV = InAggrBatch->GetBatchTmMSecsV();
+    BatchValV.Gen(InValV.Len(), 0); BatchTmMSecsV.Gen(InValV.Len(), 0);
+    for (int ValN = 0; ValN < InValV.Len(); ValN++) {
+        Ema.Update(InValV[ValN], InTmMSecsV[ValN]);
+        // consumers only see initialized values
+        if (Ema.IsInit()) {
+            BatchValV.Add(Ema.GetValue());
+            BatchTmMSecsV.Add(Ema.GetTmMSecs());
+        }
+    }
+}
+
 TEma::TEma(const TWPt<TBase>& Base, const PJsonVal& ParamVal):
         TStreamAggr(Base, ParamVal), Ema(ParamVal) {
 
     InAggr = ParseAggr(ParamVal, "inAggr");
     InAggrTm = Cast<TStreamAggrOut::ITm>(InAggr);
     InAggrFlt = Cast<TStreamAggrOut::IFlt>(InAggr);
+    InAggrBatch = Cast<TStreamAggrOut::IFltTmBatch>(InAggr, false);
 }
 
 PStreamAggr TEma::New(const TWPt<TBase>& Base, const PJsonVal& ParamVal) {
@@ -2074,6 +2106,19 @@ void TOnlineHistogram::OnStep(const TWPt<TStreamAggr>& CallerAggr) {
     }
 }
 
+void TOnlineHistogram::OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr) {
+    if (BufferedP) {
+        // input buffer already holds changes from the whole batch
+        OnStep(CallerAggr);
+    } else {
+        TScopeStopWatch StopWatch(ExeTm);
+        const TFltV& InValV = InAggrBatch->GetBatchFltV();
+        for (int ValN = 0; ValN < InValV.Len(); ValN++) {
+            Model.Increment(InValV[ValN]);
+        }
+    }
+}
+
 TOnlineHistogram::TOnlineHistogram(const TWPt<TBase>& Base, const PJsonVal& ParamVal):
         TStreamAggr(Base, ParamVal), Model(ParamVal) {
 
@@ -2081,6 +2126,7 @@ TOnlineHistogram::TOnlineHistogram(const TWPt<TBase>& Base, const PJsonVal& Para
     InAggr = ParseAggr(ParamVal, "inAggr");
     InAggrFlt = Cast<TStreamAggrOut::IFlt>(InAggr, false);
     InAggrFltIO = Cast<TStreamAggrOut::IFltIO>(InAggr, false);
+    InAggrBatch = Cast<TStreamAggrOut::IFltTmBatch>(InAggr, false);
     /// Check if at least one cast is OK
     if (!InAggrFlt.Empty()) {
         // all cool
@@ -2114,6 +2160,16 @@ void TTDigest::OnStep(const TWPt<TStreamAggr>& CallerAggr) {
     }
 }
 
+void TTDigest::OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr) {
+    TScopeStopWatch StopWatch(ExeTm);
+    if (InAggr->IsInit()) {
+        const TFltV& InValV = InAggrBatch->GetBatchFltV();
+        for (int ValN = 0; ValN < InValV.Len(); ValN++) {
+            Model.Update(InValV[ValN]);
+        }
+    }
+}
+
 void TTDigest::Add(const TFlt& Val) {
     if (InAggr->IsInit()) {
         Model.Update(Val);
@@ -2125,6 +2181,7 @@ TTDigest::TTDigest(const TWPt<TBase>& Base, const PJsonVal& ParamVal):
 
     InAggr = ParseAggr(ParamVal, "inAggr");
     InAggrFlt = Cast<TStreamAggrOut::IFlt>(InAggr);
+    InAggrBatch = Cast<TStreamAggrOut::IFltTmBatch>(InAggr, false);
     // prase model parameters
     ParamVal->GetObjFltV("quantiles", QuantileV);
 }
@@ -261,7 +261,8 @@ public:
 /// Wrapper for exposing time series to signal processing aggregates
 class TTimeSeriesTick : public TStreamAggr,
                         public TStreamAggrOut::ITm,
-                        public TStreamAggrOut::IFlt {
+                        public TStreamAggrOut::IFlt,
+                        public TStreamAggrOut::IFltTmBatch {
 private:
     /// ID of the field from which we collect time points
     TInt TimeFieldId;
@@ -275,9 +276,16 @@ private:
     /// Last extracted value
     TFlt TickVal;
 
+    /// Values extracted from the last batch
+    TFltV BatchValV;
+    /// Timestamps extracted from the last batch
+    TUInt64V BatchTmMSecsV;
+
 protected:
     /// On new record we update value and timestamp
     void OnAddRec(const TRec& Rec, const TWPt<TStreamAggr>& CallerAggr);
+    /// On new batch we extract values and timestamps of all records
+    void OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr);
     /// On new timestamp we update timestamp
     void OnTime(const uint64& TmMsec, const TWPt<TStreamAggr>& CallerAggr);
     /// No on step supported
@@ -304,6 +312,15 @@ public:
     /// Last extracted value
     double GetFlt() const { return TickVal; }
 
+    /// Supports batches
+    bool IsBatch() const { return true; }
+    /// Values extracted from the last batch
+    const TFltV& GetBatchFltV() const { return BatchValV; }
+    /// Timestamps extracted from the last batch
+    const TUInt64V& GetBatchTmMSecsV() const { return BatchTmMSecsV; }
+    /// Outputs are kept in memory
+    bool IsOutThreadSafe() const { return true; }
+
     // serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
 
@@ -446,11 +463,15 @@ public:
     void LoadState(TSIn& SIn);
     /// Save state of stream aggregate to stream
     void SaveState(TSOut& SOut) const;
+    /// Memory footprint, including the window and delay buffers
+    uint64 GetMemUsed() const;
 
     /// did we finish initialization
     bool IsInit() const { return InitP; }
     /// Resets the model state
     void Reset();
+    /// Get list of input aggregates
+    void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm()); }
 
     // ITm
     /// time stamp of the last record
@@ -607,6 +628,9 @@ private:
 protected:
     /// Stream aggregate update function called when a record is added
     void OnAddRec(const TRec& Rec, const TWPt<TStreamAggr>& CallerAggr);
+    /// Moves the buffer to the last record of the batch; consumers see all the
+    /// records that entered or left the buffer since the previous update
+    void OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr);
     /// Stream aggregate that forgets records when time is updated
     void OnTime(const uint64& TmMsec, const TWPt<TStreamAggr>& CallerAggr);
     /// Just a expection-throwing placeholder
@@ -624,6 +648,8 @@ public:
     bool IsInit() const { return InitP; }
     /// Resets the model state
     void Reset();
+    /// Supports batches
+    bool IsBatch() const { return true; }
 
     // INTERFACE
 
@@ -770,6 +796,8 @@ private:
 protected:
     /// Update signal based on the changes from the input
     void OnStep(const TWPt<TStreamAggr>& CallerAggr);
+    /// Input buffer already holds changes from the whole batch
+    void OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr) { OnStep(CallerAggr); }
     /// Json constructor
     TWinAggr(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
 
@@ -787,6 +815,8 @@ public:
     bool IsInit() const { return Signal.IsInit(); }
     /// Resets the aggregate
     void Reset() { Signal.Reset(); }
+    /// Supports batches
+    bool IsBatch() const { return true; }
     /// Get current signal value
     double GetFlt() const { return Signal.GetValue(); }
     /// Get latest time stamp
@@ -794,6 +824,10 @@ public:
 
     /// Get list of input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm()); }
+    /// Only reads the input
+    bool IsThreadSafe() const { return InAggr->IsOutThreadSafe(); }
+    /// Signal is kept in memory, timestamp comes from the input
+    bool IsOutThreadSafe() const { return InAggr->IsOutThreadSafe(); }
     /// Serialization to json
     PJsonVal SaveJson(const int& Limit) const;
 
@@ -898,7 +932,8 @@ template <> inline TStr TWinAggrSpVec<TSignalProc::TSumSpVec>::GetType() { retur
 // Exponential Moving Average.
 class TEma : public TStreamAggr,
              public TStreamAggrOut::ITm,
-             public TStreamAggrOut::IFlt {
+             public TStreamAggrOut::IFlt,
+             public TStreamAggrOut::IFltTmBatch {
 private:
     /// Input aggregate
     TWPt<TStreamAggr> InAggr;
@@ -906,13 +941,22 @@ private:
     TWPt<TStreamAggrOut::ITm> InAggrTm;
     /// Input aggregate casted to time series
     TWPt<TStreamAggrOut::IFlt> InAggrFlt;
+    /// Input aggregate casted to batch time series (NULL when not supported)
+    TWPt<TStreamAggrOut::IFltTmBatch> InAggrBatch;
 
     /// EMA indicator
     TSignalProc::TEma Ema;
 
+    /// EMA values after each value from the last batch, once initialized
+    TFltV BatchValV;
+    /// Timestamps of values from the last batch
+    TUInt64V BatchTmMSecsV;
+
 protected:
     /// Update EMA
     void OnStep(const TWPt<TStreamAggr>& CallerAggr);
+    /// Update EMA with all values from the input batch
+    void OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr);
 
     /// Json constructor
     TEma(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
@@ -934,8 +978,19 @@ public:
     /// Timestamp of the latest value
     uint64 GetTmMSecs() const { return Ema.GetTmMSecs(); }
 
+    /// Supports batches when input does
+    bool IsBatch() const { return !InAggrBatch.Empty(); }
+    /// EMA values after each value from the last batch
+    const TFltV& GetBatchFltV() const { return BatchValV; }
+    /// Timestamps of values from the last batch
+    const TUInt64V& GetBatchTmMSecsV() const { return BatchTmMSecsV; }
+
     /// List of input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm());}
+    /// Only reads the input
+    bool IsThreadSafe() const { return InAggr->IsOutThreadSafe(); }
+    /// Outputs are kept in memory
+    bool IsOutThreadSafe() const { return true; }
     /// Serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
 
@@ -1045,6 +1100,10 @@ public:
     uint64 GetTmMSecs() const { return TmMSecs; }
     /// List of input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm());}
+    /// Only reads the input
+    bool IsThreadSafe() const { return InAggr->IsOutThreadSafe(); }
+    /// Outputs are kept in memory
+    bool IsOutThreadSafe() const { return true; }
     /// Serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
 
@@ -1080,6 +1139,8 @@ private:
 protected:
     /// Update covariance
     void OnStep(const TWPt<TStreamAggr>& CallerAggr);
+    /// Input buffers already hold changes from the whole batch
+    void OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr) { OnStep(CallerAggr); }
 
     /// Json constructor
     TCov(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
@@ -1096,6 +1157,8 @@ public:
     bool IsInit() const { return InAggrX->IsInit() && InAggrY->IsInit(); }
     /// Resets the aggregate
     void Reset() { Cov.Reset(); }
+    /// Supports batches
+    bool IsBatch() const { return true; }
     /// Get latest covariance
     double GetFlt() const { return Cov.GetCov(); }
     /// Get time of latest covariance
@@ -1103,6 +1166,10 @@ public:
 
     /// Get list of input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const;
+    /// Only reads the inputs
+    bool IsThreadSafe() const { return InAggrX->IsOutThreadSafe() && InAggrY->IsOutThreadSafe(); }
+    /// Initialization is taken from the inputs
+    bool IsOutThreadSafe() const { return IsThreadSafe(); }
     /// Serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
 
@@ -1166,6 +1233,11 @@ public:
 
     /// List input aggregates
     void GetInAggrNmV(TStrV& InAggrNmV) const;
+    /// Only reads the inputs
+    bool IsThreadSafe() const { return InAggrCov->IsOutThreadSafe() &&
+        InAggrVarX->IsOutThreadSafe() && InAggrVarY->IsOutThreadSafe(); }
+    /// Initialization is taken from the inputs
+    bool IsOutThreadSafe() const { return IsThreadSafe(); }
     /// Serialization to JSon
     PJsonVal SaveJson(const int& Limit) const;
 
@@ -1387,6 +1459,8 @@ public:
     void SetParams(const PJsonVal& ParamVal);
 
     void Reset() { throw TQmExcept::New("TResampler::Reset() not implemented!"); }
+    /// Get list of input aggregates
+    void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm()); }
 
     /// Load stream aggregate state from stream
     void LoadState(TSIn& SIn);
@@ -1443,6 +1517,8 @@ public:
     void SetParams(const PJsonVal& ParamVal);
     /// Resets the aggregate
     void Reset() { Resampler.Reset(); }
+    /// Get list of input aggregates
+    void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm()); }
     /// Load stream aggregate state from stream
     void LoadState(TSIn& SIn) { Resampler.LoadState(SIn); }
     /// Save state of stream aggregate to stream
@@ -1587,6 +1663,11 @@ public:
     /// Did we finish initialization
     bool IsInit() const { return Model.IsInit(); }
     void Reset();
+    /// Get list of input aggregates
+    void GetInAggrNmV(TStrV& InAggrNmV) const {
+        InAggrNmV.Add(InAggrTm->GetAggrNm());
+        InAggrNmV.Add(InAggrSparseVec->GetAggrNm());
+    }
 
     /// Load stream aggregate state from stream
     void LoadState(TSIn& SIn);
@@ -1621,6 +1702,8 @@ private:
     TWPt<TStreamAggrOut::IFlt> InAggrFlt;
     /// Input windowed time series (can be NULL if the input is a timeseries aggregate)
     TWPt<TStreamAggrOut::IFltIO> InAggrFltIO;
+    /// Input batch time series (can be NULL)
+    TWPt<TStreamAggrOut::IFltTmBatch> InAggrBatch;
 
     /// Is buffered input aggregate provided?
     TBool BufferedP;
@@ -1629,6 +1712,8 @@ private:
 protected:
     /// Update histogram
     void OnStep(const TWPt<TStreamAggr>& CallerAggr);
+    /// Update histogram with all values from the input batch
+    void OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr);
 
     /// JSON constructor
     TOnlineHistogram(const TWPt<TBase>& Base, const PJsonVal& ParamVal);
@@ -1641,6 +1726,10 @@ public:
     bool IsInit() const { return Model.IsInit(); }
     /// Resets the aggregate
     void Reset() { Model.Reset(); }
+    /// Supports batches when input is buffered or supports batches
+    bool IsBatch() const { return BufferedP || !InAggrBatch.Empty(); }
+    /// Get list of input aggregates
+    void GetInAggrNmV(TStrV& InAggrNmV) const { if (!InAggr.Empty()) { InAggrNmV.Add(InAggr->GetAggrNm()); } }
     /// Load from stream
     void LoadState(TSIn& SIn);
     /// Store state into stream
@@ -1681,6 +1770,8 @@ private:
     TWPt<TStreamAggr> InAggr;
     /// Input timeseries
     TWPt<TStreamAggrOut::IFlt> InAggrFlt;
+    /// Input batch timeseries (NULL when not supported)
+    TWPt<TStreamAggrOut::IFltTmBatch> InAggrBatch;
 
     /// TDigest model
     TSignalProc::TTDigest Model;
@@ -1690,6 +1781,8 @@ private:
 protected:
     /// Update the model
     void OnStep(const TWPt<TStreamAggr>& CallerAggr);
+    /// Update the model with all values from the input batch
+    void OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr);
     /// Add new data to statistics
     void Add(const TFlt& Val);
 
@@ -1708,6 +1801,8 @@ public:
     bool IsInit() const { return Model.IsInit(); }
     /// Resets the aggregate
     void Reset() { }
+    /// Supports batches when input does
+    bool IsBatch() const { return !InAggrBatch.Empty(); }
     /// returns the number of clusters
     int GetVals() const { return Model.GetClusters(); }
     /// get current Quantile value vector
@@ -1763,6 +1858,8 @@ public:
     bool IsInit() const;
     /// resets the model
     void Reset();
+    /// Get list of input aggregates
+    void GetInAggrNmV(TStrV& InAggrNmV) const { if (!InAggr.Empty()) { InAggrNmV.Add(InAggr->GetAggrNm()); } }
     /// Stream aggregator type name
     static TStr GetType() { return "windowQuantiles"; }
     /// Stream aggregator type name
@@ -1896,6 +1993,8 @@ public:
     bool IsInit() const { return true; }
     /// Reset the histogram model
     void Reset() { Model.Reset(); }
+    /// Get list of input aggregates
+    void GetInAggrNmV(TStrV& InAggrNmV) const { InAggrNmV.Add(InAggr->GetAggrNm()); }
 
     /// returns the number of bins
     int GetVals() const { return Model.GetBins(); }
@@ -1952,6 +2051,11 @@ public:
     bool IsInit() const { return InAggrX->IsInit() && InAggrY->IsInit(); }
     /// resets the aggregate
     void Reset() { }
+    /// Get list of input aggregates
+    void GetInAggrNmV(TStrV& InAggrNmV) const {
+        InAggrNmV.Add(InAggrX->GetAggrNm());
+        InAggrNmV.Add(InAggrY->GetAggrNm());
+    }
 
     /// returns the number of bins
     int GetVals() const { return InAggrValX->GetVals(); }
@@ -2028,6 +2132,11 @@ public:
     bool IsInit() const { return InAggrX->IsInit() && InAggrY->IsInit(); }
     /// Resets the aggregate
     void Reset();
+    /// Get list of input aggregates
+    void GetInAggrNmV(TStrV& InAggrNmV) const {
+        InAggrNmV.Add(InAggrX->GetAggrNm());
+        InAggrNmV.Add(InAggrY->GetAggrNm());
+    }
 
     /// JSON serialization
     PJsonVal SaveJson(const int& Limit) const { return Result; }
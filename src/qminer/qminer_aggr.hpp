@@ -99,6 +99,18 @@ void TWinBufMem<TVal>::SaveState(TSOut& SOut) const {
     OutValV.Save(SOut); OutTmMSecsV.Save(SOut);
 }
 
+template <class TVal>
+uint64 TWinBufMem<TVal>::GetMemUsed() const {
+    return sizeof(TWinBufMem<TVal>) +
+           (TStreamAggr::GetMemUsed() - sizeof(TStreamAggr)) +
+           TMemUtils::GetExtraMemberSize(WindowQ) +
+           TMemUtils::GetExtraMemberSize(DelayQ) +
+           TMemUtils::GetExtraMemberSize(InValV) +
+           TMemUtils::GetExtraMemberSize(InTmMSecsV) +
+           TMemUtils::GetExtraMemberSize(OutValV) +
+           TMemUtils::GetExtraMemberSize(OutTmMSecsV);
+}
+
 template <class TVal>
 void TWinBufMem<TVal>::Reset() {
     // no longer initialized
@@ -149,6 +161,16 @@ void TWinBuf<TVal>::OnAddRec(const TRec& Rec, const TWPt<TStreamAggr>& CallerAgg
     OnTime(Timestamp_, CallerAggr);
 }
 
+template <class TVal>
+void TWinBuf<TVal>::OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr) {
+    if (RecSet->Empty()) { return; }
+    InitP = true;
+    // buffer intervals are given by record IDs, so moving to the last record of the
+    // batch leaves all records since the previous update in the update interval
+    uint64 Timestamp_ = Time(RecSet->GetLastRecId());
+    OnTime(Timestamp_, CallerAggr);
+}
+
 template <class TVal>
 void TWinBuf<TVal>::OnTime(const uint64& TmMsec, const TWPt<TStreamAggr>& CallerAggr) {
     TScopeStopWatch StopWatch(ExeTm);
@@ -183,6 +183,96 @@ void TStoreWndDesc::Load(TSIn& SIn) {
     TimeFieldNm.Load(SIn);
 }
 
+///////////////////////////////
+// QMiner-Store-Partitions
+void TStorePartitions::Save(TSOut& SOut) const {
+    PartitionMSecs.Save(SOut);
+    StartMSecsV.Save(SOut);
+    FirstRecIdV.Save(SOut);
+    MnMSecsV.Save(SOut);
+    MxMSecsV.Save(SOut);
+}
+
+void TStorePartitions::Load(TSIn& SIn) {
+    PartitionMSecs.Load(SIn);
+    StartMSecsV.Load(SIn);
+    FirstRecIdV.Load(SIn);
+    MnMSecsV.Load(SIn);
+    MxMSecsV.Load(SIn);
+}
+
+void TStorePartitions::AddRec(const uint64& RecId, const uint64& TmMSecs) {
+    const uint64 StartMSecs = TmMSecs - (TmMSecs % PartitionMSecs);
+    if (StartMSecsV.Empty() || StartMSecs > StartMSecsV.Last()) {
+        // record belongs to a new partition
+        StartMSecsV.Add(StartMSecs);
+        FirstRecIdV.Add(RecId);
+        MnMSecsV.Add(TmMSecs);
+        MxMSecsV.Add(TmMSecs);
+    } else {
+        // record goes to the last partition, even if it is older
+        MnMSecsV.Last() = TUInt64::GetMn(MnMSecsV.Last(), TmMSecs);
+        MxMSecsV.Last() = TUInt64::GetMx(MxMSecsV.Last(), TmMSecs);
+    }
+}
+
+void TStorePartitions::DelRecs(const uint64& FirstRecId) {
+    // count partitions with all records before FirstRecId, always keep the last one
+    int DelParts = 0;
+    while (DelParts + 1 < FirstRecIdV.Len() && FirstRecIdV[DelParts + 1] <= FirstRecId) { DelParts++; }
+    if (DelParts > 0) {
+        StartMSecsV.Del(0, DelParts - 1);
+        FirstRecIdV.Del(0, DelParts - 1);
+        MnMSecsV.Del(0, DelParts - 1);
+        MxMSecsV.Del(0, DelParts - 1);
+    }
+    // first remaining partition starts with first remaining record
+    if (!FirstRecIdV.Empty() && FirstRecIdV[0] < FirstRecId) { FirstRecIdV[0] = FirstRecId; }
+}
+
+void TStorePartitions::Clr() {
+    StartMSecsV.Clr();
+    FirstRecIdV.Clr();
+    MnMSecsV.Clr();
+    MxMSecsV.Clr();
+}
+
+uint64 TStorePartitions::GetExpiredEndRecId(const uint64& WindowStartMSecs, const uint64& EndRecId) const {
+    if (FirstRecIdV.Empty()) { return 0; }
+    // only leading partitions can be dropped, records are deleted from the start
+    int PartN = 0;
+    while (PartN < FirstRecIdV.Len() && MxMSecsV[PartN] < WindowStartMSecs) { PartN++; }
+    return (PartN < FirstRecIdV.Len()) ? FirstRecIdV[PartN].Val : EndRecId;
+}
+
+bool TStorePartitions::GetRecIdRange(const uint64& MnMSecs, const uint64& MxMSecs,
+        uint64& MnRecId, uint64& MxRecId) const {
+
+    int FirstPartN = -1, LastPartN = -1;
+    for (int PartN = 0; PartN < FirstRecIdV.Len(); PartN++) {
+        if (MxMSecsV[PartN] < MnMSecs || MnMSecsV[PartN] > MxMSecs) { continue; }
+        if (FirstPartN == -1) { FirstPartN = PartN; }
+        LastPartN = PartN;
+    }
+    if (FirstPartN == -1) { return false; }
+    MnRecId = FirstRecIdV[FirstPartN];
+    MxRecId = (LastPartN + 1 < FirstRecIdV.Len()) ? FirstRecIdV[LastPartN + 1].Val : TUInt64::Mx;
+    return true;
+}
+
+PJsonVal TStorePartitions::GetJson() const {
+    PJsonVal PartArr = TJsonVal::NewArr();
+    for (int PartN = 0; PartN < FirstRecIdV.Len(); PartN++) {
+        PJsonVal PartVal = TJsonVal::NewObj();
+        PartVal->AddToObj("start", TTm::GetTmFromMSecs(StartMSecsV[PartN]).GetWebLogDateTimeStr(true, "T"));
+        PartVal->AddToObj("firstRecId", FirstRecIdV[PartN].Val);
+        PartVal->AddToObj("minTime", TTm::GetTmFromMSecs(MnMSecsV[PartN]).GetWebLogDateTimeStr(true, "T"));
+        PartVal->AddToObj("maxTime", TTm::GetTmFromMSecs(MxMSecsV[PartN]).GetWebLogDateTimeStr(true, "T"));
+        PartArr->AddToArr(PartVal);
+    }
+    return PartArr;
+}
+
 ///////////////////////////////
 // QMiner-Join-Description
 TJoinDesc::TJoinDesc(const TWPt<TBase>& Base, const TStr& _JoinNm, const uint& _JoinStoreId,
@@ -410,6 +500,14 @@ bool TStoreIterVec::Next() {
     return true;
 }
 
+///////////////////////////////
+// QMiner-Store-Trigger
+void TStoreTrigger::OnAddBatch(const PRecSet& RecSet) {
+    for (int RecN = 0; RecN < RecSet->GetRecs(); RecN++) {
+        OnAdd(RecSet->GetRec(RecN));
+    }
+}
+
 ///////////////////////////////
 // QMiner-Store
 void TStore::LoadStore(TSIn& SIn) {
@@ -478,6 +576,14 @@ void TStore::OnAdd(const TRec& Rec) {
     }
 }
 
+void TStore::OnAdd(const TUInt64V& RecIdV) {
+    if (TriggerV.Empty() || RecIdV.Empty()) { return; }
+    PRecSet RecSet = TRecSet::New(this, RecIdV);
+    for (int TriggerN = 0; TriggerN < TriggerV.Len(); TriggerN++) {
+        TriggerV[TriggerN]->OnAddBatch(RecSet);
+    }
+}
+
 void TStore::OnUpdate(const uint64& RecId) {
     OnUpdate(GetRec(RecId));
 }
@@ -591,6 +697,72 @@ void TStore::AddJoinRec(const uint64& RecId, const PJsonVal& RecVal) {
     }
 }
 
+void TStore::AddJoinRec(const uint64& RecId, const TRecBatch& RecBatch) {
+    for (int JoinN = 0; JoinN < GetJoins(); JoinN++) {
+        const TJoinDesc& JoinDesc = GetJoinDesc(JoinN);
+        // only field joins have anything to reset, and only when not given in the batch
+        if (!JoinDesc.IsFieldJoin() || RecBatch.IsField(JoinDesc.GetJoinRecFieldId())) { continue; }
+        SetFieldNull(RecId, JoinDesc.GetJoinRecFieldId());
+        if (JoinDesc.GetJoinFqFieldId() >= 0) {
+            SetFieldInt64Safe(RecId, JoinDesc.GetJoinFqFieldId(), 0);
+        }
+    }
+}
+
+void TStore::AddPartitionRec(const uint64& RecId) {
+    if (!Partitions.IsPartitioned()) { return; }
+    const int TimeFieldId = GetFieldId(WndDesc.TimeFieldNm);
+    // records without time stay in the partition of the previous record
+    if (IsFieldNull(RecId, TimeFieldId)) { return; }
+    Partitions.AddRec(RecId, GetFieldTmMSecs(RecId, TimeFieldId));
+}
+
+void TStore::GetExpiredPartitionRecIdV(const uint64& WindowStartMSecs, TUInt64V& DelRecIdV) const {
+    if (Empty()) { return; }
+    const uint64 EndRecId = Partitions.GetExpiredEndRecId(WindowStartMSecs, GetLastRecId() + 1);
+    // no need to look at the records, whole partitions are dropped
+    for (uint64 RecId = GetFirstRecId(); RecId < EndRecId; RecId++) {
+        if (IsRecId(RecId)) { DelRecIdV.Add(RecId); }
+    }
+}
+
+void TStore::DelPartitionRecs() {
+    if (!Partitions.IsPartitioned()) { return; }
+    if (Empty()) {
+        Partitions.Clr();
+    } else {
+        Partitions.DelRecs(GetFirstRecId());
+    }
+}
+
+void TStore::SavePartitions(const TStr& FNm) const {
+    if (!Partitions.IsPartitioned()) { return; }
+    TFOut FOut(FNm); Partitions.Save(FOut);
+}
+
+void TStore::LoadPartitions(const TStr& FNm) {
+    if (!TFile::Exists(FNm)) { return; }
+    TFIn FIn(FNm); Partitions.Load(FIn);
+    WndDesc.PartitionSize = Partitions.GetPartitionMSecs();
+}
+
+PRecSet TStore::GetPartitionRecSet(const uint64& MnMSecs, const uint64& MxMSecs) {
+    QmAssertR(IsPartitioned(), "Store " + GetStoreNm() + " is not partitioned");
+    TUInt64V RecIdV;
+    uint64 MnRecId, MxRecId;
+    if (!Empty() && Partitions.GetRecIdRange(MnMSecs, MxMSecs, MnRecId, MxRecId)) {
+        const int TimeFieldId = GetFieldId(WndDesc.TimeFieldNm);
+        MnRecId = TUInt64::GetMx(MnRecId, GetFirstRecId());
+        MxRecId = TUInt64::GetMn(MxRecId, GetLastRecId() + 1);
+        for (uint64 RecId = MnRecId; RecId < MxRecId; RecId++) {
+            if (!IsRecId(RecId) || IsFieldNull(RecId, TimeFieldId)) { continue; }
+            const uint64 TmMSecs = GetFieldTmMSecs(RecId, TimeFieldId);
+            if (MnMSecs <= TmMSecs && TmMSecs <= MxMSecs) { RecIdV.Add(RecId); }
+        }
+    }
+    return TRecSet::New(TWPt<TStore>(this), RecIdV);
+}
+
 int TStore::AddJoinDesc(const TJoinDesc& JoinDesc) {
     // Join and Field names must be unique
     QmAssertR(!IsJoinNm((JoinDesc.GetJoinNm())), "[AddJoinDesc] Name already taken: " + JoinDesc.GetJoinNm());
@@ -667,7 +839,21 @@ PRecSet TStore::GetRndRecs(const uint64& SampleSize) {
     return GetAllRecs()->GetSampleRecSet((int)SampleSize);
 }
 
+void TStore::AddRecBatch(TRecBatch& RecBatch, TUInt64V& RecIdV, const bool& TriggerEvents) {
+    QmAssertR(RecBatch.GetStore()() == this, "[TStore::AddRecBatch] Record batch from another store");
+    // no native support, go through JSon serialization of each record
+    RecIdV.Gen(RecBatch.GetRecs(), 0);
+    for (int RecN = 0; RecN < RecBatch.GetRecs(); RecN++) {
+        RecIdV.Add(AddRec(RecBatch.GetRecJson(RecN), false));
+    }
+    // call add triggers once all records are in
+    if (TriggerEvents) { OnAdd(RecIdV); }
+}
+
 void TStore::AddJoin(const int& JoinId, const uint64& RecId, const uint64 JoinRecId, const int& JoinFq) {
+    // inverse joins are part of the logged join
+    TBaseWal::TOp WalOp(Base->GetWal());
+    WalOp.AddJoin(GetStoreId(), JoinId, RecId, JoinRecId, JoinFq);
     const TJoinDesc& JoinDesc = GetJoinDesc(JoinId);
     // different handling for field and index joins
     if (JoinDesc.IsIndexJoin()) {
@@ -727,6 +913,9 @@ void TStore::AddJoin(const TStr& JoinNm, const uint64& RecId, const uint64 JoinR
 }
 
 void TStore::DelJoin(const int& JoinId, const uint64& RecId, const uint64 JoinRecId, const int& JoinFq) {
+    // inverse joins are part of the logged join
+    TBaseWal::TOp WalOp(Base->GetWal());
+    WalOp.DelJoin(GetStoreId(), JoinId, RecId, JoinRecId, JoinFq);
     const TJoinDesc& JoinDesc = GetJoinDesc(JoinId);
     // different handling for field and index joins
     if (JoinDesc.IsIndexJoin()) {
@@ -810,6 +999,45 @@ int64 TStore::GetFieldInt64Safe(const uint64& RecId, const int& FieldId) const {
     }
 }
 
+void TStore::GetFieldInt64Block(const TUInt64V& RecIdV, const int& FieldId,
+        TVec<TInt64>& ValV, TBoolV& NullV) const {
+
+    const bool BoolP = GetFieldDesc(FieldId).IsBool();
+    ValV.Reserve(RecIdV.Len(), RecIdV.Len()); NullV.Reserve(RecIdV.Len(), RecIdV.Len());
+    for (int RecN = 0; RecN < RecIdV.Len(); RecN++) {
+        const uint64 RecId = RecIdV[RecN];
+        NullV[RecN] = IsFieldNull(RecId, FieldId);
+        if (NullV[RecN]) { ValV[RecN] = 0; continue; }
+        ValV[RecN] = BoolP ? (GetFieldBool(RecId, FieldId) ? 1 : 0) : GetFieldInt64Safe(RecId, FieldId);
+    }
+}
+
+void TStore::GetFieldUInt64Block(const TUInt64V& RecIdV, const int& FieldId,
+        TUInt64V& ValV, TBoolV& NullV) const {
+
+    const bool TmP = GetFieldDesc(FieldId).IsTm();
+    ValV.Reserve(RecIdV.Len(), RecIdV.Len()); NullV.Reserve(RecIdV.Len(), RecIdV.Len());
+    for (int RecN = 0; RecN < RecIdV.Len(); RecN++) {
+        const uint64 RecId = RecIdV[RecN];
+        NullV[RecN] = IsFieldNull(RecId, FieldId);
+        if (NullV[RecN]) { ValV[RecN] = 0; continue; }
+        ValV[RecN] = TmP ? GetFieldTmMSecs(RecId, FieldId) : GetFieldUInt64Safe(RecId, FieldId);
+    }
+}
+
+void TStore::GetFieldFltBlock(const TUInt64V& RecIdV, const int& FieldId,
+        TFltV& ValV, TBoolV& NullV) const {
+
+    const bool SFltP = GetFieldDesc(FieldId).IsSFlt();
+    ValV.Reserve(RecIdV.Len(), RecIdV.Len()); NullV.Reserve(RecIdV.Len(), RecIdV.Len());
+    for (int RecN = 0; RecN < RecIdV.Len(); RecN++) {
+        const uint64 RecId = RecIdV[RecN];
+        NullV[RecN] = IsFieldNull(RecId, FieldId);
+        if (NullV[RecN]) { ValV[RecN] = 0.0; continue; }
+        ValV[RecN] = SFltP ? (double)GetFieldSFlt(RecId, FieldId) : GetFieldFlt(RecId, FieldId);
+    }
+}
+
 /// Set field value using field id (default implementation throws exception)
 void TStore::SetFieldUInt64Safe(const uint64& RecId, const int& FieldId, const uint64& UInt64) {
     switch (GetFieldDesc(FieldId).GetFieldType()) {
@@ -2062,9 +2290,15 @@ TStr TRec::GetFieldText(const int& FieldId) const {
     throw FieldError(FieldId, "GetDisplayText");
 }
 
+void TRec::LogSetField(const int& FieldId) const {
+    TBaseWal::TOp WalOp(Store->GetBase()->GetWal());
+    WalOp.SetField(Store, RecId, FieldId);
+}
+
 void TRec::SetFieldNull(const int& FieldId) {
     if (IsByRef()) {
         Store->SetFieldNull(RecId, FieldId);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, -1);
     }
@@ -2073,6 +2307,7 @@ void TRec::SetFieldNull(const int& FieldId) {
 void TRec::SetFieldByte(const int& FieldId, const uchar& Byte) {
     if (IsByRef()) {
         Store->SetFieldByte(RecId, FieldId, Byte);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         TUCh(Byte).Save(RecValOut);
@@ -2082,6 +2317,7 @@ void TRec::SetFieldByte(const int& FieldId, const uchar& Byte) {
 void TRec::SetFieldInt(const int& FieldId, const int& Int) {
     if (IsByRef()) {
         Store->SetFieldInt(RecId, FieldId, Int);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         TInt(Int).Save(RecValOut);
@@ -2091,6 +2327,7 @@ void TRec::SetFieldInt(const int& FieldId, const int& Int) {
 void TRec::SetFieldInt16(const int& FieldId, const int16& Int16) {
     if (IsByRef()) {
         Store->SetFieldInt16(RecId, FieldId, Int16);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         TInt16(Int16).Save(RecValOut);
@@ -2100,6 +2337,7 @@ void TRec::SetFieldInt16(const int& FieldId, const int16& Int16) {
 void TRec::SetFieldInt64(const int& FieldId, const int64& Int64) {
     if (IsByRef()) {
         Store->SetFieldInt64(RecId, FieldId, Int64);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         TInt64(Int64).Save(RecValOut);
@@ -2109,6 +2347,7 @@ void TRec::SetFieldInt64(const int& FieldId, const int64& Int64) {
 void TRec::SetFieldIntV(const int& FieldId, const TIntV& IntV) {
     if (IsByRef()) {
         Store->SetFieldIntV(RecId, FieldId, IntV);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         IntV.Save(RecValOut);
@@ -2118,6 +2357,7 @@ void TRec::SetFieldIntV(const int& FieldId, const TIntV& IntV) {
 void TRec::SetFieldUInt(const int& FieldId, const uint& UInt) {
     if (IsByRef()) {
         Store->SetFieldUInt(RecId, FieldId, UInt);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         TUInt(UInt).Save(RecValOut);
@@ -2127,6 +2367,7 @@ void TRec::SetFieldUInt(const int& FieldId, const uint& UInt) {
 void TRec::SetFieldUInt16(const int& FieldId, const uint16& UInt16) {
     if (IsByRef()) {
         Store->SetFieldUInt16(RecId, FieldId, UInt16);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         TUInt16(UInt16).Save(RecValOut);
@@ -2136,6 +2377,7 @@ void TRec::SetFieldUInt16(const int& FieldId, const uint16& UInt16) {
 void TRec::SetFieldUInt64(const int& FieldId, const uint64& UInt64) {
     if (IsByRef()) {
         Store->SetFieldUInt64(RecId, FieldId, UInt64);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         TUInt64(UInt64).Save(RecValOut);
@@ -2145,6 +2387,7 @@ void TRec::SetFieldUInt64(const int& FieldId, const uint64& UInt64) {
 void TRec::SetFieldStr(const int& FieldId, const TStr& Str) {
     if (IsByRef()) {
         Store->SetFieldStr(RecId, FieldId, Str);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         Str.Save(RecValOut);
@@ -2154,6 +2397,7 @@ void TRec::SetFieldStr(const int& FieldId, const TStr& Str) {
 void TRec::SetFieldStrV(const int& FieldId, const TStrV& StrV) {
     if (IsByRef()) {
         Store->SetFieldStrV(RecId, FieldId, StrV);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         StrV.Save(RecValOut);
@@ -2163,6 +2407,7 @@ void TRec::SetFieldStrV(const int& FieldId, const TStrV& StrV) {
 void TRec::SetFieldBool(const int& FieldId, const bool& Bool) {
     if (IsByRef()) {
         Store->SetFieldBool(RecId, FieldId, Bool);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         TBool(Bool).Save(RecValOut);
@@ -2172,6 +2417,7 @@ void TRec::SetFieldBool(const int& FieldId, const bool& Bool) {
 void TRec::SetFieldFlt(const int& FieldId, const double& Flt) {
     if (IsByRef()) {
         Store->SetFieldFlt(RecId, FieldId, Flt);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         TFlt(Flt).Save(RecValOut);
@@ -2181,6 +2427,7 @@ void TRec::SetFieldFlt(const int& FieldId, const double& Flt) {
 void TRec::SetFieldSFlt(const int& FieldId, const float& Flt) {
     if (IsByRef()) {
         Store->SetFieldSFlt(RecId, FieldId, Flt);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         TSFlt(Flt).Save(RecValOut);
@@ -2190,6 +2437,7 @@ void TRec::SetFieldSFlt(const int& FieldId, const float& Flt) {
 void TRec::SetFieldFltV(const int& FieldId, const TFltV& FltV) {
     if (IsByRef()) {
         Store->SetFieldFltV(RecId, FieldId, FltV);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         FltV.Save(RecValOut);
@@ -2199,6 +2447,7 @@ void TRec::SetFieldFltV(const int& FieldId, const TFltV& FltV) {
 void TRec::SetFieldFltPr(const int& FieldId, const TFltPr& FltPr) {
     if (IsByRef()) {
         Store->SetFieldFltPr(RecId, FieldId, FltPr);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         FltPr.Save(RecValOut);
@@ -2208,6 +2457,7 @@ void TRec::SetFieldFltPr(const int& FieldId, const TFltPr& FltPr) {
 void TRec::SetFieldTm(const int& FieldId, const TTm& Tm) {
     if (IsByRef()) {
         Store->SetFieldTm(RecId, FieldId, Tm);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         const uint64 TmMSecs = TTm::GetMSecsFromTm(Tm);
@@ -2218,6 +2468,7 @@ void TRec::SetFieldTm(const int& FieldId, const TTm& Tm) {
 void TRec::SetFieldTmMSecs(const int& FieldId, const uint64& TmMSecs) {
     if (IsByRef()) {
         Store->SetFieldTmMSecs(RecId, FieldId, TmMSecs);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         TUInt64(TmMSecs).Save(RecValOut);
@@ -2228,6 +2479,7 @@ void TRec::SetFieldTmMSecs(const int& FieldId, const uint64& TmMSecs) {
 void TRec::SetFieldNumSpV(const int& FieldId, const TIntFltKdV& NumSpV) {
     if (IsByRef()) {
         Store->SetFieldNumSpV(RecId, FieldId, NumSpV);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         NumSpV.Save(RecValOut);
@@ -2237,6 +2489,7 @@ void TRec::SetFieldNumSpV(const int& FieldId, const TIntFltKdV& NumSpV) {
 void TRec::SetFieldBowSpV(const int& FieldId, const PBowSpV& BowSpV) {
     if (IsByRef()) {
         Store->SetFieldBowSpV(RecId, FieldId, BowSpV);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         BowSpV->Save(RecValOut);
@@ -2246,6 +2499,7 @@ void TRec::SetFieldBowSpV(const int& FieldId, const PBowSpV& BowSpV) {
 void TRec::SetFieldTMem(const int& FieldId, const TMem& Mem) {
     if (IsByRef()) {
         Store->SetFieldTMem(RecId, FieldId, Mem);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         Mem.Save(RecValOut);
@@ -2255,6 +2509,7 @@ void TRec::SetFieldTMem(const int& FieldId, const TMem& Mem) {
 void TRec::SetFieldJsonVal(const int& FieldId, const PJsonVal& Json) {
     if (IsByRef()) {
         Store->SetFieldJsonVal(RecId, FieldId, Json);
+        LogSetField(FieldId);
     } else {
         FieldIdPosH.AddDat(FieldId, RecVal.Len());
         TJsonVal::GetStrFromVal(Json).Save(RecValOut);
@@ -2465,6 +2720,114 @@ PJsonVal TRec::GetJson(const TWPt<TBase>& Base, const bool& FieldsP,
     return RecVal;
 }
 
+///////////////////////////////
+// QMiner-Record-Batch
+TRecBatch::TFieldCol& TRecBatch::AddCol(const int& FieldId, const bool& TypeOkP,
+        const int& Vals, const TStr& TypeStr) {
+
+    QmAssertR(Store->IsFieldId(FieldId), TStr::Fmt("[TRecBatch] Unknown field id %d", FieldId));
+    QmAssertR(TypeOkP, "[TRecBatch] Field " + Store->GetFieldNm(FieldId) + " is not of type " + TypeStr);
+    QmAssertR(Vals == Recs, TStr::Fmt("[TRecBatch] Field %s has %d values, expected %d",
+        Store->GetFieldNm(FieldId).CStr(), Vals, Recs.Val));
+    QmAssertR(!IsField(FieldId), "[TRecBatch] Field " + Store->GetFieldNm(FieldId) + " already in batch");
+    FieldIdColNV[FieldId] = ColV.Add(TFieldCol(FieldId));
+    return ColV.Last();
+}
+
+const TRecBatch::TFieldCol& TRecBatch::GetCol(const int& FieldId) const {
+    Assert(IsField(FieldId));
+    return ColV[FieldIdColNV[FieldId]];
+}
+
+TRecBatch::TRecBatch(const TWPt<TStore>& _Store, const int& _Recs):
+        Store(_Store), Recs(_Recs), FieldIdColNV(_Store->GetFields()) {
+
+    QmAssertR(Recs >= 0, "[TRecBatch] Negative number of records");
+    FieldIdColNV.PutAll(-1);
+}
+
+TRecBatch::TRecBatch(const TWPt<TStore>& _Store, TSIn& SIn):
+        Store(_Store), Recs(SIn), ColV(SIn), FieldIdColNV(SIn) {
+
+    QmAssertR(FieldIdColNV.Len() == Store->GetFields(), "[TRecBatch] Batch does not match store " + Store->GetStoreNm());
+}
+
+void TRecBatch::Save(TSOut& SOut) const {
+    Recs.Save(SOut);
+    ColV.Save(SOut);
+    FieldIdColNV.Save(SOut);
+}
+
+void TRecBatch::AddFieldInt(const int& FieldId, const TVec<TInt64>& IntV) {
+    const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
+    const bool TypeOkP = Desc.IsByte() || Desc.IsInt() || Desc.IsInt16() || Desc.IsInt64() ||
+        Desc.IsUInt() || Desc.IsUInt16() || Desc.IsBool();
+    AddCol(FieldId, TypeOkP, IntV.Len(), "integer").IntV = IntV;
+}
+
+void TRecBatch::AddFieldUInt64(const int& FieldId, const TUInt64V& UInt64V) {
+    const bool TypeOkP = Store->GetFieldDesc(FieldId).IsUInt64();
+    AddCol(FieldId, TypeOkP, UInt64V.Len(), "uint64").UInt64V = UInt64V;
+}
+
+void TRecBatch::AddFieldFlt(const int& FieldId, const TFltV& FltV) {
+    const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
+    AddCol(FieldId, Desc.IsFlt() || Desc.IsSFlt(), FltV.Len(), "float").FltV = FltV;
+}
+
+void TRecBatch::AddFieldTmMSecs(const int& FieldId, const TUInt64V& TmMSecsV) {
+    const bool TypeOkP = Store->GetFieldDesc(FieldId).IsTm();
+    AddCol(FieldId, TypeOkP, TmMSecsV.Len(), "datetime").UInt64V = TmMSecsV;
+}
+
+void TRecBatch::AddFieldStr(const int& FieldId, const TStrV& StrV) {
+    const bool TypeOkP = Store->GetFieldDesc(FieldId).IsStr();
+    AddCol(FieldId, TypeOkP, StrV.Len(), "string").StrV = StrV;
+}
+
+void TRecBatch::SetFieldNull(const int& FieldId, const int& RecN) {
+    QmAssertR(IsField(FieldId), "[TRecBatch] Field " + Store->GetFieldNm(FieldId) + " not in batch");
+    QmAssertR(Store->GetFieldDesc(FieldId).IsNullable(),
+        "[TRecBatch] Non-nullable field " + Store->GetFieldNm(FieldId) + " set to null");
+    QmAssertR(0 <= RecN && RecN < Recs, TStr::Fmt("[TRecBatch] Record %d out of range, batch has %d records",
+        RecN, Recs.Val));
+    TFieldCol& Col = ColV[FieldIdColNV[FieldId]];
+    if (Col.NullV.Empty()) { Col.NullV.Gen(Recs); Col.NullV.PutAll(false); }
+    Col.NullV[RecN] = true;
+}
+
+bool TRecBatch::IsFieldNull(const int& FieldId, const int& RecN) const {
+    const TFieldCol& Col = GetCol(FieldId);
+    return !Col.NullV.Empty() && Col.NullV[RecN];
+}
+
+PJsonVal TRecBatch::GetFieldJson(const int& FieldId, const int& RecN) const {
+    if (IsFieldNull(FieldId, RecN)) { return TJsonVal::NewNull(); }
+    const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
+    if (Desc.IsBool()) {
+        return TJsonVal::NewBool(GetFieldInt(FieldId, RecN) != 0);
+    } else if (Desc.IsUInt64()) {
+        return TJsonVal::NewNum((double)GetFieldUInt64(FieldId, RecN));
+    } else if (Desc.IsFlt() || Desc.IsSFlt()) {
+        return TJsonVal::NewNum(GetFieldFlt(FieldId, RecN));
+    } else if (Desc.IsTm()) {
+        TTm Tm = TTm::GetTmFromMSecs(GetFieldTmMSecs(FieldId, RecN));
+        return TJsonVal::NewStr(Tm.GetWebLogDateTimeStr(true, "T", false));
+    } else if (Desc.IsStr()) {
+        return TJsonVal::NewStr(GetFieldStr(FieldId, RecN));
+    }
+    return TJsonVal::NewNum((double)GetFieldInt(FieldId, RecN));
+}
+
+PJsonVal TRecBatch::GetRecJson(const int& RecN) const {
+    PJsonVal RecVal = TJsonVal::NewObj();
+    for (int ColN = 0; ColN < ColV.Len(); ColN++) {
+        const int FieldId = ColV[ColN].FieldId;
+        RecVal->AddToObj(Store->GetFieldNm(FieldId), GetFieldJson(FieldId, RecN));
+    }
+    return RecVal;
+}
+
 ///////////////////////////////
 /// Record Comparator by Frequency
 bool TRecCmpByFq::operator()(const TUInt64IntKd& RecIdFq1, const TUInt64IntKd& RecIdFq2) const {
@@ -3541,6 +3904,9 @@ TStrV TFieldReader::GetDateRange() {
 
 ///////////////////////////////
 // QMiner-ResultSet
+const int TRecSet::FilterBlockLen = 1024;
+const int TRecSet::ParallelSortMnRecs = 100000;
+
 void TRecSet::GetSampleRecIdV(const int& SampleSize,
     const bool& FqSampleP, TUInt64IntKdV& SampleRecIdFqV) const {
 
@@ -3724,60 +4090,43 @@ void TRecSet::SortByFq(const bool& Asc) {
     RecIdFqV.SortCmp(TRecCmpByFq(Asc));
 }
 
-void TRecSet::SortByField(const bool& Asc, const int& SortFieldId) {
+void TRecSet::SortByField(const bool& Asc, const int& SortFieldId, const int& Limit) {
     // get store and field type
     const TFieldDesc& Desc = Store->GetFieldDesc(SortFieldId);
-    // apply appropriate comparator
-    if (Desc.IsInt()) {
-        typedef TKeyDat<TInt, TUInt64IntKd> TItem;
-        TVec<TItem> TItemV(RecIdFqV.Len());
-        for (int N = 0; N < RecIdFqV.Len(); N++) {
-            TItemV.SetVal(N, TItem(Store->GetFieldInt(RecIdFqV[N].Key, SortFieldId), RecIdFqV[N]));
-        }
-        TItemV.Sort(Asc);
-        for (int N = 0; N < TItemV.Len(); N++) {
-            RecIdFqV.SetVal(N, TItemV[N].Dat);
-        }
-    } else if (Desc.IsFlt()) {
-        typedef TKeyDat<TFlt, TUInt64IntKd> TItem;
-        TVec<TItem> TItemV(RecIdFqV.Len());
-        for (int N = 0; N < RecIdFqV.Len(); N++) {
-            TItemV.SetVal(N, TItem(Store->GetFieldFlt(RecIdFqV[N].Key, SortFieldId), RecIdFqV[N]));
-        }
-        TItemV.Sort(Asc);
-        for (int N = 0; N < TItemV.Len(); N++) {
-            RecIdFqV.SetVal(N, TItemV[N].Dat);
+    // collect record ids which are used to fetch the field values in blocks
+    const int Recs = GetRecs();
+    TUInt64V RecIdV(Recs, 0);
+    for (int RecN = 0; RecN < Recs; RecN++) { RecIdV.Add(RecIdFqV[RecN].Key); }
+    TBoolV NullV;
+    // apply appropriate key type
+    if (Desc.IsInt() || Desc.IsInt16() || Desc.IsInt64() || Desc.IsByte() ||
+            Desc.IsUInt() || Desc.IsUInt16() || Desc.IsBool()) {
+        TVec<TInt64> ValV; Store->GetFieldInt64Block(RecIdV, SortFieldId, ValV, NullV);
+        TVec<TPair<TInt64, TUInt64IntKd> > KeyRecV(Recs);
+        for (int RecN = 0; RecN < Recs; RecN++) {
+            KeyRecV[RecN] = TPair<TInt64, TUInt64IntKd>(ValV[RecN], RecIdFqV[RecN]);
         }
-    } else if (Desc.IsByte()) {
-        typedef TKeyDat<TUCh, TUInt64IntKd> TItem;
-        TVec<TItem> TItemV(RecIdFqV.Len());
-        for (int N = 0; N < RecIdFqV.Len(); N++) {
-            TItemV.SetVal(N, TItem(Store->GetFieldByte(RecIdFqV[N].Key, SortFieldId), RecIdFqV[N]));
+        SortByFieldKey(KeyRecV, Asc, Limit);
+    } else if (Desc.IsUInt64() || Desc.IsTm()) {
+        TUInt64V ValV; Store->GetFieldUInt64Block(RecIdV, SortFieldId, ValV, NullV);
+        TVec<TPair<TUInt64, TUInt64IntKd> > KeyRecV(Recs);
+        for (int RecN = 0; RecN < Recs; RecN++) {
+            KeyRecV[RecN] = TPair<TUInt64, TUInt64IntKd>(ValV[RecN], RecIdFqV[RecN]);
         }
-        TItemV.Sort(Asc);
-        for (int N = 0; N < TItemV.Len(); N++) {
-            RecIdFqV.SetVal(N, TItemV[N].Dat);
+        SortByFieldKey(KeyRecV, Asc, Limit);
+    } else if (Desc.IsFlt() || Desc.IsSFlt()) {
+        TFltV ValV; Store->GetFieldFltBlock(RecIdV, SortFieldId, ValV, NullV);
+        TVec<TPair<TFlt, TUInt64IntKd> > KeyRecV(Recs);
+        for (int RecN = 0; RecN < Recs; RecN++) {
+            KeyRecV[RecN] = TPair<TFlt, TUInt64IntKd>(ValV[RecN], RecIdFqV[RecN]);
         }
+        SortByFieldKey(KeyRecV, Asc, Limit);
     } else if (Desc.IsStr()) {
-        typedef TKeyDat<TStr, TUInt64IntKd> TItem;
-        TVec<TItem> TItemV(RecIdFqV.Len());
-        for (int N = 0; N < RecIdFqV.Len(); N++) {
-            TItemV.SetVal(N, TItem(Store->GetFieldStr(RecIdFqV[N].Key, SortFieldId), RecIdFqV[N]));
-        }
-        TItemV.Sort(Asc);
-        for (int N = 0; N < TItemV.Len(); N++) {
-            RecIdFqV.SetVal(N, TItemV[N].Dat);
-        }
-    } else if (Desc.IsTm()) {
-        typedef TKeyDat<TUInt64, TUInt64IntKd> TItem;
-        TVec<TItem> TItemV(RecIdFqV.Len());
-        for (int N = 0; N < RecIdFqV.Len(); N++) {
-            TItemV.SetVal(N, TItem(Store->GetFieldTmMSecs(RecIdFqV[N].Key, SortFieldId), RecIdFqV[N]));
-        }
-        TItemV.Sort(Asc);
-        for (int N = 0; N < TItemV.Len(); N++) {
-            RecIdFqV.SetVal(N, TItemV[N].Dat);
+        TVec<TPair<TStr, TUInt64IntKd> > KeyRecV(Recs);
+        for (int RecN = 0; RecN < Recs; RecN++) {
+            KeyRecV[RecN] = TPair<TStr, TUInt64IntKd>(Store->GetFieldStr(RecIdV[RecN], SortFieldId), RecIdFqV[RecN]);
         }
+        SortByFieldKey(KeyRecV, Asc, Limit);
     } else {
         throw TQmExcept::New("Unsupported sort field type!");
     }
@@ -3816,7 +4165,8 @@ void TRecSet::FilterByFieldBool(const int& FieldId, const bool& Val) {
     const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
     QmAssertR(Desc.IsBool(), "Wrong field type, boolean expected");
     // apply the filter
-    FilterBy<TRecFilterByFieldBool>(TRecFilterByFieldBool(Store->GetBase(), FieldId, Val));
+    const int64 IntVal = Val ? 1 : 0;
+    FilterByFieldBlock<int64, TVec<TInt64> >(FieldId, IntVal, IntVal, &TStore::GetFieldInt64Block);
 }
 
 void TRecSet::FilterByFieldInt(const int& FieldId, const int& MinVal, const int& MaxVal) {
@@ -3824,7 +4174,11 @@ void TRecSet::FilterByFieldInt(const int& FieldId, const int& MinVal, const int&
     const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
     QmAssertR(Desc.IsInt() || (Desc.IsStr() && Desc.IsCodebook()), "Wrong field type, integer or codebook string expected");
     // apply the filter
-    FilterBy<TRecFilterByFieldInt>(TRecFilterByFieldInt(Store->GetBase(), FieldId, MinVal, MaxVal));
+    if (Desc.IsInt()) {
+        FilterByFieldBlock<int64, TVec<TInt64> >(FieldId, MinVal, MaxVal, &TStore::GetFieldInt64Block);
+    } else {
+        FilterBy<TRecFilterByFieldInt>(TRecFilterByFieldInt(Store->GetBase(), FieldId, MinVal, MaxVal));
+    }
 }
 
 void TRecSet::FilterByFieldInt16(const int& FieldId, const int16& MinVal, const int16& MaxVal) {
@@ -3832,7 +4186,7 @@ void TRecSet::FilterByFieldInt16(const int& FieldId, const int16& MinVal, const
     const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
     QmAssertR(Desc.IsInt16(), "Wrong field type, 16bit integer expected");
     // apply the filter
-    FilterBy<TRecFilterByFieldInt16>(TRecFilterByFieldInt16(Store->GetBase(), FieldId, MinVal, MaxVal));
+    FilterByFieldBlock<int64, TVec<TInt64> >(FieldId, MinVal, MaxVal, &TStore::GetFieldInt64Block);
 }
 
 void TRecSet::FilterByFieldInt64(const int& FieldId, const int64& MinVal, const int64& MaxVal) {
@@ -3840,7 +4194,7 @@ void TRecSet::FilterByFieldInt64(const int& FieldId, const int64& MinVal, const
     const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
     QmAssertR(Desc.IsInt64(), "Wrong field type, 64bit integer expected");
     // apply the filter
-    FilterBy<TRecFilterByFieldInt64>(TRecFilterByFieldInt64(Store->GetBase(), FieldId, MinVal, MaxVal));
+    FilterByFieldBlock<int64, TVec<TInt64> >(FieldId, MinVal, MaxVal, &TStore::GetFieldInt64Block);
 }
 
 void TRecSet::FilterByFieldByte(const int& FieldId, const uchar& MinVal, const uchar& MaxVal) {
@@ -3848,7 +4202,7 @@ void TRecSet::FilterByFieldByte(const int& FieldId, const uchar& MinVal, const u
     const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
     QmAssertR(Desc.IsByte(), "Wrong field type, byte expected");
     // apply the filter
-    FilterBy<TRecFilterByFieldByte>(TRecFilterByFieldByte(Store->GetBase(), FieldId, MinVal, MaxVal));
+    FilterByFieldBlock<int64, TVec<TInt64> >(FieldId, MinVal, MaxVal, &TStore::GetFieldInt64Block);
 }
 
 void TRecSet::FilterByFieldByteSet(const int& FieldId, const TUChSet& ValSet) {
@@ -3864,7 +4218,7 @@ void TRecSet::FilterByFieldUInt(const int& FieldId, const uint& MinVal, const ui
     const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
     QmAssertR(Desc.IsUInt(), "Wrong field type, unsigned integer expected");
     // apply the filter
-    FilterBy<TRecFilterByFieldUInt>(TRecFilterByFieldUInt(Store->GetBase(), FieldId, MinVal, MaxVal));
+    FilterByFieldBlock<int64, TVec<TInt64> >(FieldId, MinVal, MaxVal, &TStore::GetFieldInt64Block);
 }
 
 void TRecSet::FilterByFieldUIntSet(const int& FieldId, const TUIntSet& ValSet) {
@@ -3880,7 +4234,7 @@ void TRecSet::FilterByFieldUInt16(const int& FieldId, const uint16& MinVal, cons
     const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
     QmAssertR(Desc.IsUInt16(), "Wrong field type, unsigned 16bit integer expected");
     // apply the filter
-    FilterBy<TRecFilterByFieldUInt16>(TRecFilterByFieldUInt16(Store->GetBase(), FieldId, MinVal, MaxVal));
+    FilterByFieldBlock<int64, TVec<TInt64> >(FieldId, MinVal, MaxVal, &TStore::GetFieldInt64Block);
 }
 
 void TRecSet::FilterByFieldFlt(const int& FieldId, const double& MinVal, const double& MaxVal) {
@@ -3888,15 +4242,15 @@ void TRecSet::FilterByFieldFlt(const int& FieldId, const double& MinVal, const d
     const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
     QmAssertR(Desc.IsFlt(), "Wrong field type, numeric expected");
     // apply the filter
-    FilterBy<TRecFilterByFieldFlt>(TRecFilterByFieldFlt(Store->GetBase(), FieldId, MinVal, MaxVal));
+    FilterByFieldBlock<double, TFltV>(FieldId, MinVal, MaxVal, &TStore::GetFieldFltBlock);
 }
 
 void TRecSet::FilterByFieldSFlt(const int& FieldId, const float& MinVal, const float& MaxVal) {
     // get store and field type
     const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
-    QmAssertR(Desc.IsFlt(), "Wrong field type, numeric expected");
+    QmAssertR(Desc.IsFlt() || Desc.IsSFlt(), "Wrong field type, numeric expected");
     // apply the filter
-    FilterBy<TRecFilterByFieldSFlt>(TRecFilterByFieldSFlt(Store->GetBase(), FieldId, MinVal, MaxVal));
+    FilterByFieldBlock<double, TFltV>(FieldId, MinVal, MaxVal, &TStore::GetFieldFltBlock);
 }
 
 void TRecSet::FilterByFieldUInt64(const int& FieldId, const uint64& MinVal, const uint64& MaxVal) {
@@ -3904,7 +4258,7 @@ void TRecSet::FilterByFieldUInt64(const int& FieldId, const uint64& MinVal, cons
     const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
     QmAssertR(Desc.IsUInt64(), "Wrong field type, unsigned 64bit integer expected");
     // apply the filter
-    FilterBy<TRecFilterByFieldUInt64>(TRecFilterByFieldUInt64(Store->GetBase(), FieldId, MinVal, MaxVal));
+    FilterByFieldBlock<uint64, TUInt64V>(FieldId, MinVal, MaxVal, &TStore::GetFieldUInt64Block);
 }
 
 void TRecSet::FilterByFieldUInt64Set(const int& FieldId, const TUInt64Set& ValSet) {
@@ -3948,7 +4302,7 @@ void TRecSet::FilterByFieldTm(const int& FieldId, const uint64& MinVal, const ui
     const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
     QmAssertR(Desc.IsTm() || Desc.IsUInt64(), "Wrong field type, time expected");
     // apply the filter
-    FilterBy<TRecFilterByFieldTm>(TRecFilterByFieldTm(Store->GetBase(), FieldId, MinVal, MaxVal));
+    FilterByFieldBlock<uint64, TUInt64V>(FieldId, MinVal, MaxVal, &TStore::GetFieldUInt64Block);
 }
 
 void TRecSet::FilterByFieldTm(const int& FieldId, const TTm& MinVal, const TTm& MaxVal) {
@@ -3956,7 +4310,9 @@ void TRecSet::FilterByFieldTm(const int& FieldId, const TTm& MinVal, const TTm&
     const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
     QmAssertR(Desc.IsTm(), "Wrong field type, time expected");
     // apply the filter
-    FilterBy<TRecFilterByFieldTm>(TRecFilterByFieldTm(Store->GetBase(), FieldId, MinVal, MaxVal));
+    const uint64 MinMSecs = MinVal.IsDef() ? TTm::GetMSecsFromTm(MinVal) : (uint64)TUInt64::Mn;
+    const uint64 MaxMSecs = MaxVal.IsDef() ? TTm::GetMSecsFromTm(MaxVal) : (uint64)TUInt64::Mx;
+    FilterByFieldBlock<uint64, TUInt64V>(FieldId, MinMSecs, MaxMSecs, &TStore::GetFieldUInt64Block);
 }
 
 void TRecSet::FilterByFieldSafe(const int& FieldId, const uint64& MinVal, const uint64& MaxVal) {
@@ -4335,12 +4691,40 @@ TIndexVoc::TIndexVoc(TSIn& SIn) {
     KeyH.Load(SIn);
     StoreIdKeyIdSetH.Load(SIn);
     WordVocV.Load(SIn);
+    // list of keys with compressed child vectors, missing in older indexes
+    if (!SIn.Eof()) {
+        TIntV CompressKeyIdV(SIn);
+        for (int KeyIdN = 0; KeyIdN < CompressKeyIdV.Len(); KeyIdN++) {
+            KeyH[CompressKeyIdV[KeyIdN]].PutCompress(true);
+        }
+    }
+    // list of keys with paged linear index, missing in older indexes
+    if (!SIn.Eof()) {
+        TIntV PagedKeyIdV(SIn);
+        for (int KeyIdN = 0; KeyIdN < PagedKeyIdV.Len(); KeyIdN++) {
+            KeyH[PagedKeyIdV[KeyIdN]].PutPaged(true);
+        }
+    }
 }
 
 void TIndexVoc::Save(TSOut& SOut) const {
     KeyH.Save(SOut);
     StoreIdKeyIdSetH.Save(SOut);
     WordVocV.Save(SOut);
+    // kept out of TIndexKey to stay compatible with older indexes
+    TIntV CompressKeyIdV;
+    int KeyId = KeyH.FFirstKeyId();
+    while (KeyH.FNextKeyId(KeyId)) {
+        if (KeyH[KeyId].IsCompress()) { CompressKeyIdV.Add(KeyId); }
+    }
+    CompressKeyIdV.Save(SOut);
+    // list of keys with paged linear index
+    TIntV PagedKeyIdV;
+    KeyId = KeyH.FFirstKeyId();
+    while (KeyH.FNextKeyId(KeyId)) {
+        if (KeyH[KeyId].IsPaged()) { PagedKeyIdV.Add(KeyId); }
+    }
+    PagedKeyIdV.Save(SOut);
 }
 
 bool TIndexVoc::IsKeyId(const int& KeyId) const {
@@ -4547,6 +4931,14 @@ void TIndexVoc::PutTokenizer(const int& KeyId, const PTokenizer& Tokenizer) {
     KeyH[KeyId].PutTokenizer(Tokenizer);
 }
 
+void TIndexVoc::PutCompress(const int& KeyId, const bool& CompressP) {
+    KeyH[KeyId].PutCompress(CompressP);
+}
+
+void TIndexVoc::PutPaged(const int& KeyId, const bool& PagedP) {
+    KeyH[KeyId].PutPaged(PagedP);
+}
+
 void TIndexVoc::SaveTxt(const TWPt<TBase>& Base, const TStr& FNm) const {
     TFOut FOut(FNm);
     // print store keys
@@ -4774,6 +5166,7 @@ void TQueryItem::ParseKeys(const TWPt<TBase>& Base, const TWPt<TStore>& Store,
             } else if (KeyNm == "$sort") {
             } else if (KeyNm == "$limit") {
             } else if (KeyNm == "$offset") {
+            } else if (KeyNm == "$threads") {
             } else {
                 throw TQmExcept::New("Query: unknown parameter " + KeyNm);
             }
@@ -5333,7 +5726,7 @@ void TQueryAggr::LoadJson(const TWPt<TBase>& Base, const TWPt<TStore>& Store,
 TQuery::TQuery(const TWPt<TBase>& Base, const TQueryItem& _QueryItem,
     const int& _SortFieldId, const bool& _SortAscP, const int& _Limit,
     const int& _Offset) : QueryItem(_QueryItem), SortFieldId(_SortFieldId),
-    SortAscP(_SortAscP), Limit(_Limit), Offset(_Offset) {}
+    SortAscP(_SortAscP), Limit(_Limit), Offset(_Offset), Threads(1) {}
 
 PQuery TQuery::New(const TWPt<TBase>& Base, const TQueryItem& QueryItem,
     const int& SortFieldId, const bool& SortAscP, const int& Limit, const int& Offset) {
@@ -5369,6 +5762,10 @@ PQuery TQuery::New(const TWPt<TBase>& Base, const PJsonVal& JsonVal) {
     if (JsonVal->IsObjKey("$offset")) {
         Query->Offset = TFlt::Round(JsonVal->GetObjNum("$offset"));
     }
+    // check if we can use more threads
+    if (JsonVal->IsObjKey("$threads")) {
+        Query->PutThreads(TFlt::Round(JsonVal->GetObjNum("$threads")));
+    }
     Query->Optimize();
     return Query;
 }
@@ -5389,7 +5786,9 @@ TWPt<TStore> TQuery::GetStore(const TWPt<TBase>& Base) {
 }
 
 void TQuery::Sort(const TWPt<TBase>& Base, const PRecSet& RecSet) {
-    RecSet->SortByField(SortAscP, SortFieldId);
+    // when limited, only records up to offset + limit need to be sorted
+    const int SortLimit = (Limit == -1) ? -1 : (Offset + Limit);
+    RecSet->SortByField(SortAscP, SortFieldId, SortLimit);
 }
 
 PRecSet TQuery::GetLimit(const PRecSet& RecSet) {
@@ -5435,6 +5834,7 @@ int TGeoIndex::AllRecs() const {
 }
 
 void TGeoIndex::AddKey(const TFltPr& Loc, const uint64& RecId) {
+    TWriteLock Lock(IndexLock);
     //const int RecsStart = AllRecs();
     TIntPr LocId = GetLocId(Loc);
     // check if new location
@@ -5447,6 +5847,7 @@ void TGeoIndex::AddKey(const TFltPr& Loc, const uint64& RecId) {
 }
 
 void TGeoIndex::DelKey(const TFltPr& Loc, const uint64& RecId) {
+    TWriteLock Lock(IndexLock);
     //const int RecsStart = AllRecs();
     TIntPr LocId = GetLocId(Loc);
     // check if known location
@@ -5468,11 +5869,13 @@ void TGeoIndex::DelKey(const TFltPr& Loc, const uint64& RecId) {
 void TGeoIndex::SearchRange(const TFltPr& Loc, const double& Radius,
     const int& Limit, TUInt64V& RecIdV) const {
 
+    TReadLock Lock(IndexLock);
     TIntV LocKeyIdV; SphereNn.NnQuery(Loc.Val1, Loc.Val2, Limit, Radius, LocKeyIdV);
     LocKeyIdToRecId(LocKeyIdV, Limit, RecIdV);
 }
 
 void TGeoIndex::SearchNn(const TFltPr& Loc, const int& Limit, TUInt64V& RecIdV) const {
+    TReadLock Lock(IndexLock);
     TIntV LocKeyIdV; SphereNn.NnQuery(Loc.Val1, Loc.Val2, Limit, LocKeyIdV);
     LocKeyIdToRecId(LocKeyIdV, Limit, RecIdV);
 }
@@ -5482,6 +5885,166 @@ bool TGeoIndex::LocEquals(const TFltPr& Loc1, const TFltPr& Loc2) const {
     return (LocId1 == LocId2);
 }
 
+///////////////////////////////
+// Geohash Index
+const int TGeoHashIndex::CellBits = 26;
+const double TGeoHashIndex::InitRadius = 1000.0;
+const double TGeoHashIndex::EarthRadius = 6371010.0;
+
+uint64 TGeoHashIndex::GetLatN(const double& Lat, const int& Bits) {
+    const uint64 Cells = TUInt64(1) << Bits;
+    const double LatN = floor((Lat + 90.0) / 180.0 * (double)Cells);
+    if (LatN < 0.0) { return 0; }
+    return (LatN >= (double)Cells) ? Cells - 1 : (uint64)LatN;
+}
+
+uint64 TGeoHashIndex::GetLonN(const double& Lon, const int& Bits) {
+    const uint64 Cells = TUInt64(1) << Bits;
+    // normalize longitude to [-180, 180)
+    const double NormLon = Lon - 360.0 * floor((Lon + 180.0) / 360.0);
+    const double LonN = floor((NormLon + 180.0) / 360.0 * (double)Cells);
+    if (LonN < 0.0) { return 0; }
+    return (LonN >= (double)Cells) ? Cells - 1 : (uint64)LonN;
+}
+
+uint64 TGeoHashIndex::GetCell(const uint64& LatN, const uint64& LonN, const int& Bits) {
+    uint64 Cell = 0;
+    for (int BitN = Bits - 1; BitN >= 0; BitN--) {
+        Cell = (Cell << 2) | (((LonN >> BitN) & 1) << 1) | ((LatN >> BitN) & 1);
+    }
+    return Cell;
+}
+
+uint64 TGeoHashIndex::GetLocCell(const TFltPr& Loc) {
+    return GetCell(GetLatN(Loc.Val1, CellBits), GetLonN(Loc.Val2, CellBits), CellBits);
+}
+
+double TGeoHashIndex::GetDist(const TFltPr& Loc1, const TFltPr& Loc2) {
+    const double Lat1 = Loc1.Val1 * TMath::Pi / 180.0, Lat2 = Loc2.Val1 * TMath::Pi / 180.0;
+    const double SinLat = sin(0.5 * (Lat2 - Lat1));
+    const double SinLon = sin(0.5 * (Loc2.Val2 - Loc1.Val2) * TMath::Pi / 180.0);
+    const double A = SinLat * SinLat + cos(Lat1) * cos(Lat2) * SinLon * SinLon;
+    return 2.0 * EarthRadius * asin(TFlt::GetMn(1.0, sqrt(A)));
+}
+
+void TGeoHashIndex::GetCellRangeV(const TFltPr& Loc, const double& Radius, TVec<TUInt64Pr>& CellRangeV) {
+    // bounding box of the circle
+    const double LatDelta = Radius / EarthRadius * 180.0 / TMath::Pi;
+    const double LatMin = TFlt::GetMx(-90.0, Loc.Val1 - LatDelta);
+    const double LatMax = TFlt::GetMn(90.0, Loc.Val1 + LatDelta);
+    // circle around a pole or wider than half the globe covers all longitudes
+    double LonDelta = 180.0;
+    if (LatMin > -90.0 && LatMax < 90.0) {
+        const double MxAbsLat = TFlt::GetMx(TFlt::Abs(LatMin), TFlt::Abs(LatMax));
+        LonDelta = TFlt::GetMn(180.0, LatDelta / cos(MxAbsLat * TMath::Pi / 180.0));
+    }
+    const bool AllLonP = (LonDelta >= 180.0);
+    // use cells with size at least half of the box, so we scan at most 3x3 of them
+    int Bits = CellBits;
+    while (Bits > 0 && ((LatMax - LatMin) > 2.0 * 180.0 / (double)(TUInt64(1) << Bits)
+        || (AllLonP && Bits > 2) || (!AllLonP && 2.0 * LonDelta > 2.0 * 360.0 / (double)(TUInt64(1) << Bits)))) {
+        Bits--;
+    }
+    const uint64 Cells = TUInt64(1) << Bits;
+    const uint64 LatMinN = GetLatN(LatMin, Bits), LatMaxN = GetLatN(LatMax, Bits);
+    uint64 LonMinN = 0, LonCells = Cells;
+    if (!AllLonP) {
+        // may wrap around the antimeridian
+        LonMinN = GetLonN(Loc.Val2 - LonDelta, Bits);
+        const uint64 LonMaxN = GetLonN(Loc.Val2 + LonDelta, Bits);
+        LonCells = TUInt64::GetMn(Cells, (LonMaxN + Cells - LonMinN) % Cells + 1);
+    }
+    // each cell is a continuous range of finest cells in Z-order
+    const int Shift = 2 * (CellBits - Bits);
+    CellRangeV.Clr();
+    for (uint64 LatN = LatMinN; LatN <= LatMaxN; LatN++) {
+        for (uint64 LonCellN = 0; LonCellN < LonCells; LonCellN++) {
+            const uint64 Cell = GetCell(LatN, (LonMinN + LonCellN) % Cells, Bits);
+            CellRangeV.Add(TUInt64Pr(Cell << Shift, ((Cell + 1) << Shift) - 1));
+        }
+    }
+    // merge neighbouring ranges
+    CellRangeV.Sort();
+    int LastRangeN = 0;
+    for (int RangeN = 1; RangeN < CellRangeV.Len(); RangeN++) {
+        if (CellRangeV[RangeN].Val1 == CellRangeV[LastRangeN].Val2 + 1) {
+            CellRangeV[LastRangeN].Val2 = CellRangeV[RangeN].Val2;
+        } else {
+            LastRangeN++; CellRangeV[LastRangeN] = CellRangeV[RangeN];
+        }
+    }
+    if (!CellRangeV.Empty()) { CellRangeV.Trunc(LastRangeN + 1); }
+}
+
+void TGeoHashIndex::GetDistRecIdV(const TFltPr& Loc, const double& Radius, TFltUInt64PrV& DistRecIdV) const {
+    TVec<TUInt64Pr> CellRangeV; GetCellRangeV(Loc, Radius, CellRangeV);
+    DistRecIdV.Clr();
+    TVec<TKeyDat<TTreeKey, TFltPr> > CellRecLocV;
+    for (int RangeN = 0; RangeN < CellRangeV.Len(); RangeN++) {
+        const TUInt64Pr& CellRange = CellRangeV[RangeN];
+        BTree.RangeQuery(TTreeKey(CellRange.Val1, 0), TTreeKey(CellRange.Val2, TUInt64::Mx), CellRecLocV);
+        // cells are bigger than the circle, keep only records inside of it
+        for (int RecN = 0; RecN < CellRecLocV.Len(); RecN++) {
+            const double Dist = GetDist(Loc, CellRecLocV[RecN].Dat);
+            if (Dist <= Radius) { DistRecIdV.Add(TFltUInt64Pr(Dist, CellRecLocV[RecN].Key.Val2)); }
+        }
+    }
+}
+
+void TGeoHashIndex::Search(const TFltPr& Loc, const double& Radius, const int& Limit, TUInt64V& RecIdV) const {
+    // lookups load nodes into the cache
+    TWriteLock Lock(IndexLock);
+    // start with small circle and widen it until we have enough records
+    const double MxRadius = TFlt::GetMn(Radius, TMath::Pi * EarthRadius);
+    double SearchRadius = TFlt::GetMn(MxRadius, InitRadius);
+    TFltUInt64PrV DistRecIdV;
+    forever {
+        GetDistRecIdV(Loc, SearchRadius, DistRecIdV);
+        if (DistRecIdV.Len() >= Limit || SearchRadius >= MxRadius) { break; }
+        SearchRadius = TFlt::GetMn(MxRadius, 4.0 * SearchRadius);
+    }
+    // keep nearest records
+    DistRecIdV.Sort();
+    if (DistRecIdV.Len() > Limit) { DistRecIdV.Trunc(Limit); }
+    RecIdV.Gen(DistRecIdV.Len(), 0);
+    for (int RecN = 0; RecN < DistRecIdV.Len(); RecN++) {
+        RecIdV.Add(DistRecIdV[RecN].Val2);
+    }
+    RecIdV.Sort();
+}
+
+TGeoHashIndex::TGeoHashIndex(const TStr& BlobFNm, const uint64& CacheSize):
+    BlobBs(TMBlobBs::New(BlobFNm, faCreate)),
+    InternalStore(new TInternalStore(BlobBs, CacheSize / 8)),
+    LeafStore(new TLeafStore(BlobBs, CacheSize - CacheSize / 8)),
+    BTree(InternalStore, LeafStore, 8, 64, false, false) { }
+
+void TGeoHashIndex::Open(const TStr& BlobFNm, const TFAccess& Access) {
+    BlobBs = TMBlobBs::New(BlobFNm, Access);
+    InternalStore->Open(BlobBs);
+    LeafStore->Open(BlobBs);
+}
+
+void TGeoHashIndex::AddKey(const TFltPr& Loc, const uint64& RecId) {
+    TWriteLock Lock(IndexLock);
+    BTree.Add(TTreeKey(GetLocCell(Loc), RecId), Loc);
+}
+
+void TGeoHashIndex::DelKey(const TFltPr& Loc, const uint64& RecId) {
+    TWriteLock Lock(IndexLock);
+    BTree.Del(TTreeKey(GetLocCell(Loc), RecId));
+}
+
+void TGeoHashIndex::SearchRange(const TFltPr& Loc, const double& Radius,
+    const int& Limit, TUInt64V& RecIdV) const {
+
+    Search(Loc, Radius, Limit, RecIdV);
+}
+
+void TGeoHashIndex::SearchNn(const TFltPr& Loc, const int& Limit, TUInt64V& RecIdV) const {
+    Search(Loc, TMath::Pi * EarthRadius, Limit, RecIdV);
+}
+
 ///////////////////////////////
 // QMiner-Index
 TIndex::TQmGixKeyStr::TQmGixKeyStr(const TWPt<TBase>& _Base,
@@ -5779,6 +6342,8 @@ void TIndex::DoQueryPos(const int& KeyId, const TUInt64V& WordIdV,
 }
 
 
+const uint64 TIndex::BTreeCacheSize = 16 * TInt::Mega;
+
 TIndex::TIndex(const TStr& _IndexFPath, const TFAccess& _Access, const PIndexVoc& _IndexVoc,
     const int64& CacheSizeFull, const int64& CacheSizeSmall, const uint64& CacheSizeTiny,
     const int64& CacheSizePos, const int& SplitLen) {
@@ -5786,17 +6351,17 @@ TIndex::TIndex(const TStr& _IndexFPath, const TFAccess& _Access, const PIndexVoc
     IndexFPath = _IndexFPath;
     Access = _Access;
     // initialize full invered index
-    SumItemHandlerFull = new TQmGixSumItemHandler<TQmGixItemFull>;
+    SumItemHandlerFull = new TQmGixSumItemHandler<TQmGixItemFull>(_IndexVoc);
     GixFull = TGix<TQmGixKey, TQmGixItemFull>::New("Index.GixFull",
         IndexFPath, Access, SumItemHandlerFull, CacheSizeFull, SplitLen);
     SumMergerFull = new TQmGixSumWithFqMerger<TQmGixItemFull>;
     // initialize small inverted index
-    SumItemHandlerSmall = new TQmGixSumItemHandler<TQmGixItemSmall>;
+    SumItemHandlerSmall = new TQmGixSumItemHandler<TQmGixItemSmall>(_IndexVoc);
     GixSmall = TGix<TQmGixKey, TQmGixItemSmall>::New("Index.GixSmall",
         IndexFPath, Access, SumItemHandlerSmall, CacheSizeSmall, SplitLen);
     SumMergerSmall = new TQmGixSumWithFqMerger<TQmGixItemSmall>;
     // initialize tiny inverted index
-    ItemHandlerTiny = new TGixDefItemHandler<TQmGixKey, TQmGixItemTiny>;
+    ItemHandlerTiny = new TQmGixDefItemHandler<TQmGixItemTiny>(_IndexVoc);
     GixTiny = TGix<TQmGixKey, TQmGixItemTiny>::New("Index.GixTiny",
         IndexFPath, Access, ItemHandlerTiny, CacheSizeTiny, SplitLen);
     MergerTiny = new TQmGixSumWithoutFqMerger<TQmGixItemTiny, TQmGixItemFull>;
@@ -5811,6 +6376,15 @@ TIndex::TIndex(const TStr& _IndexFPath, const TFAccess& _Access, const PIndexVoc
         TFIn SphereFIn(SphereFNm);
         GeoIndexH.Load(SphereFIn);
     }
+    TStr GeoHashFNm = IndexFPath + "Index.GeoHash";
+    if (TFile::Exists(GeoHashFNm) && Access != faCreate) {
+        TFIn GeoHashFIn(GeoHashFNm);
+        GeoHashIndexH.Load(GeoHashFIn);
+        int KeyId = GeoHashIndexH.FFirstKeyId();
+        while (GeoHashIndexH.FNextKeyId(KeyId)) {
+            GeoHashIndexH[KeyId]->Open(GetGeoHashBlobFNm(GeoHashIndexH.GetKey(KeyId)), Access);
+        }
+    }
     // initialize btree index
     TStr BTreeFNm = IndexFPath + "Index.BTree";
     if (TFile::Exists(BTreeFNm) && Access != faCreate) {
@@ -5824,6 +6398,16 @@ TIndex::TIndex(const TStr& _IndexFPath, const TFAccess& _Access, const PIndexVoc
         BTreeIndexUInt64H.Load(BTreeFIn);
         BTreeIndexFltH.Load(BTreeFIn);
         BTreeIndexSFltH.Load(BTreeFIn);
+        // paged indexes keep nodes in separate blob bases
+        OpenBTreeIndexH(BTreeIndexByteH);
+        OpenBTreeIndexH(BTreeIndexIntH);
+        OpenBTreeIndexH(BTreeIndexInt16H);
+        OpenBTreeIndexH(BTreeIndexInt64H);
+        OpenBTreeIndexH(BTreeIndexUIntH);
+        OpenBTreeIndexH(BTreeIndexUInt16H);
+        OpenBTreeIndexH(BTreeIndexUInt64H);
+        OpenBTreeIndexH(BTreeIndexFltH);
+        OpenBTreeIndexH(BTreeIndexSFltH);
     }
     // initialize vocabularies
     IndexVoc = _IndexVoc;
@@ -5857,24 +6441,7 @@ TIndex::~TIndex() {
             delete ItemHandlerPos;
             delete MergerPos;
         }
-        {
-            TEnv::Logger->OnStatus("Saving and closing location index");
-            TFOut SphereFOut(IndexFPath + "Index.Geo");
-            GeoIndexH.Save(SphereFOut);
-        }
-        {
-            TEnv::Logger->OnStatus("Saving and closing btree index");
-            TFOut BTreeFOut(IndexFPath + "Index.BTree");
-            BTreeIndexByteH.Save(BTreeFOut);
-            BTreeIndexIntH.Save(BTreeFOut);
-            BTreeIndexInt16H.Save(BTreeFOut);
-            BTreeIndexInt64H.Save(BTreeFOut);
-            BTreeIndexUIntH.Save(BTreeFOut);
-            BTreeIndexUInt16H.Save(BTreeFOut);
-            BTreeIndexUInt64H.Save(BTreeFOut);
-            BTreeIndexFltH.Save(BTreeFOut);
-            BTreeIndexSFltH.Save(BTreeFOut);
-        }
+        SaveIndexH();
         TEnv::Logger->OnStatus("Index closed");
     } else {
         TEnv::Logger->OnStatus("Index opened in read-only mode, no saving needed");
@@ -5937,6 +6504,13 @@ void TIndex::IndexGix(const int& KeyId, const uint64& WordId, const uint64& RecI
     Assert(KeyId != -1);
     // we shouldn't modify read-only index
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
+    // collect for later when indexing a batch
+    if (BatchDepth > 0) {
+        // adds must come after deletes collected so far
+        if (BatchDelItemH.IsKey(TKeyWord(KeyId, WordId))) { FlushBatch(); }
+        BatchItemH.AddDat(TKeyWord(KeyId, WordId)).Add(TQmGixItemFull(RecId, RecFq));
+        return;
+    }
     // check which Gix to use
     const TIndexKeyGixType GixType = GetGixType(KeyId);
     // send to appropriate index
@@ -5952,6 +6526,64 @@ void TIndex::IndexGix(const int& KeyId, const uint64& WordId, const uint64& RecI
     }
 }
 
+void TIndex::EndBatch() {
+    Assert(BatchDepth > 0);
+    BatchDepth--;
+    if (BatchDepth == 0) { FlushBatch(); }
+}
+
+void TIndex::FlushBatch() {
+    int KeyId = BatchItemH.FFirstKeyId();
+    while (BatchItemH.FNextKeyId(KeyId)) {
+        const TKeyWord& Key = BatchItemH.GetKey(KeyId);
+        const TVec<TQmGixItemFull>& ItemV = BatchItemH[KeyId];
+        switch (GetGixType(Key.Val1)) {
+        case oikgtFull:
+            GixFull->AddItemV(Key, ItemV); break;
+        case oikgtSmall: {
+            TVec<TQmGixItemSmall> SmallItemV(ItemV.Len(), 0);
+            for (int ItemN = 0; ItemN < ItemV.Len(); ItemN++) {
+                SmallItemV.Add(TQmGixItemSmall((uint)ItemV[ItemN].Key, (int16)ItemV[ItemN].Dat));
+            }
+            GixSmall->AddItemV(Key, SmallItemV); break; }
+        case oikgtTiny: {
+            TVec<TQmGixItemTiny> TinyItemV(ItemV.Len(), 0);
+            for (int ItemN = 0; ItemN < ItemV.Len(); ItemN++) {
+                TinyItemV.Add(TQmGixItemTiny((uint)ItemV[ItemN].Key));
+            }
+            GixTiny->AddItemV(Key, TinyItemV); break; }
+        default:
+            throw TQmExcept::New("[TIndex::FlushBatch] Unsupported gix type!");
+        }
+    }
+    BatchItemH.Clr();
+    // deletes are collected after adds of the same key
+    KeyId = BatchDelItemH.FFirstKeyId();
+    while (BatchDelItemH.FNextKeyId(KeyId)) {
+        const TKeyWord& Key = BatchDelItemH.GetKey(KeyId);
+        const TVec<TQmGixItemFull>& ItemV = BatchDelItemH[KeyId];
+        switch (GetGixType(Key.Val1)) {
+        case oikgtFull:
+            GixFull->DelItemV(Key, ItemV); break;
+        case oikgtSmall: {
+            TVec<TQmGixItemSmall> SmallItemV(ItemV.Len(), 0);
+            for (int ItemN = 0; ItemN < ItemV.Len(); ItemN++) {
+                SmallItemV.Add(TQmGixItemSmall((uint)ItemV[ItemN].Key, 0));
+            }
+            GixSmall->DelItemV(Key, SmallItemV); break; }
+        case oikgtTiny: {
+            TVec<TQmGixItemTiny> TinyItemV(ItemV.Len(), 0);
+            for (int ItemN = 0; ItemN < ItemV.Len(); ItemN++) {
+                TinyItemV.Add(TQmGixItemTiny((uint)ItemV[ItemN].Key));
+            }
+            GixTiny->DelItemV(Key, TinyItemV); break; }
+        default:
+            throw TQmExcept::New("[TIndex::FlushBatch] Unsupported gix type!");
+        }
+    }
+    BatchDelItemH.Clr();
+}
+
 void TIndex::DeleteValue(const int& KeyId, const TStr& WordStr, const uint64& RecId) {
     const uint64 WordId = IndexVoc->AddWordStr(KeyId, WordStr);
     DeleteGix(KeyId, WordId, RecId, 1);
@@ -6001,6 +6633,19 @@ void TIndex::DeleteGix(const int& KeyId, const uint64& WordId, const uint64& Rec
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
     // check which Gix to use
     const TIndexKeyGixType GixType = GetGixType(KeyId);
+    // collect for later when deindexing a batch
+    if (BatchDepth > 0) {
+        const TKeyWord Key(KeyId, WordId);
+        if (RecFq != TInt::Mx && GixType != oikgtTiny) {
+            // deleting some occurrences adds item with negative frequency
+            IndexGix(KeyId, WordId, RecId, -RecFq);
+        } else {
+            // deletes must come after adds collected so far
+            if (BatchItemH.IsKey(Key)) { FlushBatch(); }
+            BatchDelItemH.AddDat(Key).Add(TQmGixItemFull(RecId, 0));
+        }
+        return;
+    }
     // are we deleting all items or just few occurences?
     if (RecFq == TInt::Mx) {
         // full delete from index
@@ -6110,6 +6755,14 @@ void TIndex::DeleteTextPos(const int& KeyId, const TUInt64V& WordIdV, const uint
 void TIndex::IndexGeo(const int& KeyId, const TFltPr& Loc, const uint64& RecId) {
     // we shouldn't modify read-only index
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
+    // paged keys use geohash index
+    if (IndexVoc->GetKey(KeyId).IsPaged()) {
+        if (!GeoHashIndexH.IsKey(KeyId)) {
+            GeoHashIndexH.AddDat(KeyId, TGeoHashIndex::New(GetGeoHashBlobFNm(KeyId), BTreeCacheSize));
+        }
+        GeoHashIndexH.GetDat(KeyId)->AddKey(Loc, RecId);
+        return;
+    }
     // if new key, create sphere first
     if (!GeoIndexH.IsKey(KeyId)) { GeoIndexH.AddDat(KeyId, TGeoIndex::New()); }
     // index new location
@@ -6121,9 +6774,11 @@ void TIndex::DeleteGeo(const int& KeyId, const TFltPr& Loc, const uint64& RecId)
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
     // delete only if index exist
     if (GeoIndexH.IsKey(KeyId)) { GeoIndexH.GetDat(KeyId)->DelKey(Loc, RecId); }
+    if (GeoHashIndexH.IsKey(KeyId)) { GeoHashIndexH.GetDat(KeyId)->DelKey(Loc, RecId); }
 }
 
 bool TIndex::LocEquals(const int& KeyId, const TFltPr& Loc1, const TFltPr& Loc2) const {
+    if (GeoHashIndexH.IsKey(KeyId)) { return GeoHashIndexH.GetDat(KeyId)->LocEquals(Loc1, Loc2); }
     return GeoIndexH.IsKey(KeyId) ? GeoIndexH.GetDat(KeyId)->LocEquals(Loc1, Loc2) : false;
 }
 
@@ -6131,7 +6786,7 @@ void TIndex::IndexLinear(const int& KeyId, const uchar& Val, const uint64& RecId
     // we shouldn't modify read-only index
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
     // if new key, create sphere first
-    if (!BTreeIndexByteH.IsKey(KeyId)) { BTreeIndexByteH.AddDat(KeyId, PBTreeIndexUCh::New()); }
+    if (!BTreeIndexByteH.IsKey(KeyId)) { BTreeIndexByteH.AddDat(KeyId, NewBTreeIndex<TUCh>(KeyId)); }
     // index new location
     BTreeIndexByteH.GetDat(KeyId)->AddKey(Val, RecId);
 }
@@ -6140,7 +6795,7 @@ void TIndex::IndexLinear(const int& KeyId, const int& Val, const uint64& RecId)
     // we shouldn't modify read-only index
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
     // if new key, create sphere first
-    if (!BTreeIndexIntH.IsKey(KeyId)) { BTreeIndexIntH.AddDat(KeyId, PBTreeIndexInt::New()); }
+    if (!BTreeIndexIntH.IsKey(KeyId)) { BTreeIndexIntH.AddDat(KeyId, NewBTreeIndex<TInt>(KeyId)); }
     // index new location
     BTreeIndexIntH.GetDat(KeyId)->AddKey(Val, RecId);
 }
@@ -6149,7 +6804,7 @@ void TIndex::IndexLinear(const int& KeyId, const int16& Val, const uint64& RecId
     // we shouldn't modify read-only index
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
     // if new key, create sphere first
-    if (!BTreeIndexInt16H.IsKey(KeyId)) { BTreeIndexInt16H.AddDat(KeyId, PBTreeIndexInt16::New()); }
+    if (!BTreeIndexInt16H.IsKey(KeyId)) { BTreeIndexInt16H.AddDat(KeyId, NewBTreeIndex<TInt16>(KeyId)); }
     // index new location
     BTreeIndexInt16H.GetDat(KeyId)->AddKey(Val, RecId);
 }
@@ -6158,7 +6813,7 @@ void TIndex::IndexLinear(const int& KeyId, const int64& Val, const uint64& RecId
     // we shouldn't modify read-only index
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
     // if new key, create sphere first
-    if (!BTreeIndexInt64H.IsKey(KeyId)) { BTreeIndexInt64H.AddDat(KeyId, PBTreeIndexInt64::New()); }
+    if (!BTreeIndexInt64H.IsKey(KeyId)) { BTreeIndexInt64H.AddDat(KeyId, NewBTreeIndex<TInt64>(KeyId)); }
     // index new location
     BTreeIndexInt64H.GetDat(KeyId)->AddKey(Val, RecId);
 }
@@ -6167,7 +6822,7 @@ void TIndex::IndexLinear(const int& KeyId, const uint& Val, const uint64& RecId)
     // we shouldn't modify read-only index
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
     // if new key, create sphere first
-    if (!BTreeIndexUIntH.IsKey(KeyId)) { BTreeIndexUIntH.AddDat(KeyId, PBTreeIndexUInt::New()); }
+    if (!BTreeIndexUIntH.IsKey(KeyId)) { BTreeIndexUIntH.AddDat(KeyId, NewBTreeIndex<TUInt>(KeyId)); }
     // index new location
     BTreeIndexUIntH.GetDat(KeyId)->AddKey(Val, RecId);
 }
@@ -6176,7 +6831,7 @@ void TIndex::IndexLinear(const int& KeyId, const uint16& Val, const uint64& RecI
     // we shouldn't modify read-only index
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
     // if new key, create sphere first
-    if (!BTreeIndexUInt16H.IsKey(KeyId)) { BTreeIndexUInt16H.AddDat(KeyId, PBTreeIndexUInt16::New()); }
+    if (!BTreeIndexUInt16H.IsKey(KeyId)) { BTreeIndexUInt16H.AddDat(KeyId, NewBTreeIndex<TUInt16>(KeyId)); }
     // index new location
     BTreeIndexUInt16H.GetDat(KeyId)->AddKey(Val, RecId);
 }
@@ -6185,7 +6840,7 @@ void TIndex::IndexLinear(const int& KeyId, const uint64& Val, const uint64& RecI
     // we shouldn't modify read-only index
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
     // if new key, create sphere first
-    if (!BTreeIndexUInt64H.IsKey(KeyId)) { BTreeIndexUInt64H.AddDat(KeyId, PBTreeIndexUInt64::New()); }
+    if (!BTreeIndexUInt64H.IsKey(KeyId)) { BTreeIndexUInt64H.AddDat(KeyId, NewBTreeIndex<TUInt64>(KeyId)); }
     // index new location
     BTreeIndexUInt64H.GetDat(KeyId)->AddKey(Val, RecId);
 }
@@ -6195,7 +6850,7 @@ void TIndex::IndexLinear(const int& KeyId, const double& Val, const uint64& RecI
     // we shouldn't modify read-only index
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
     // if new key, create sphere first
-    if (!BTreeIndexFltH.IsKey(KeyId)) { BTreeIndexFltH.AddDat(KeyId, PBTreeIndexFlt::New()); }
+    if (!BTreeIndexFltH.IsKey(KeyId)) { BTreeIndexFltH.AddDat(KeyId, NewBTreeIndex<TFlt>(KeyId)); }
     // index new location
     BTreeIndexFltH.GetDat(KeyId)->AddKey(Val, RecId);
 }
@@ -6204,7 +6859,7 @@ void TIndex::IndexLinear(const int& KeyId, const float& Val, const uint64& RecId
     // we shouldn't modify read-only index
     QmAssertR(!IsReadOnly(), "Cannot edit read-only index!");
     // if new key, create sphere first
-    if (!BTreeIndexSFltH.IsKey(KeyId)) { BTreeIndexSFltH.AddDat(KeyId, PBTreeIndexSFlt::New()); }
+    if (!BTreeIndexSFltH.IsKey(KeyId)) { BTreeIndexSFltH.AddDat(KeyId, NewBTreeIndex<TSFlt>(KeyId)); }
     // index new location
     BTreeIndexSFltH.GetDat(KeyId)->AddKey(Val, RecId);
 }
@@ -6305,14 +6960,15 @@ PRecSet TIndex::SearchGixAnd(const TWPt<TBase>& Base, const int& KeyId, const TU
     TVec<TQmGixItemFull> RecIdFqV;
     // check which Gix to use
     const TIndexKeyGixType GixType = GetGixType(KeyId);
-    // go to appropriate gix and always first check if we have the key at all
+    // go to appropriate gix, keys are ordered from rarest on so frequent keys only
+    // load child vectors which can contain matches
     switch (GixType) {
     case oikgtFull:
-        DoQueryFull(TQmGixExpItemFull::NewAndV(KeyWordV), RecIdFqV); break;
+        DoQueryFull(TQmGixExpItemFull::NewAndV(GixFull, KeyWordV), RecIdFqV); break;
     case oikgtSmall:
-        DoQuerySmall(TQmGixExpItemSmall::NewAndV(KeyWordV), RecIdFqV); break;
+        DoQuerySmall(TQmGixExpItemSmall::NewAndV(GixSmall, KeyWordV), RecIdFqV); break;
     case oikgtTiny:
-        DoQueryTiny(TQmGixExpItemTiny::NewAndV(KeyWordV), RecIdFqV); break;
+        DoQueryTiny(TQmGixExpItemTiny::NewAndV(GixTiny, KeyWordV), RecIdFqV); break;
     default:
         throw TQmExcept::New("[TIndex::SearchGixAnd] Unsupported gix type!");
     }
@@ -6400,6 +7056,7 @@ PRecSet TIndex::SearchGeoRange(const TWPt<TBase>& Base, const int& KeyId,
     TUInt64V RecIdV;
     const uint StoreId = IndexVoc->GetKey(KeyId).GetStoreId();
     if (GeoIndexH.IsKey(KeyId)) { GeoIndexH.GetDat(KeyId)->SearchRange(Loc, Radius, Limit, RecIdV); }
+    if (GeoHashIndexH.IsKey(KeyId)) { GeoHashIndexH.GetDat(KeyId)->SearchRange(Loc, Radius, Limit, RecIdV); }
     return TRecSet::New(Base->GetStoreByStoreId(StoreId), RecIdV);
 }
 
@@ -6409,6 +7066,7 @@ PRecSet TIndex::SearchGeoNn(const TWPt<TBase>& Base, const int& KeyId,
     TUInt64V RecIdV;
     const uint StoreId = IndexVoc->GetKey(KeyId).GetStoreId();
     if (GeoIndexH.IsKey(KeyId)) { GeoIndexH.GetDat(KeyId)->SearchNn(Loc, Limit, RecIdV); }
+    if (GeoHashIndexH.IsKey(KeyId)) { GeoHashIndexH.GetDat(KeyId)->SearchNn(Loc, Limit, RecIdV); }
     return TRecSet::New(Base->GetStoreByStoreId(StoreId), RecIdV);
 }
 
@@ -6571,6 +7229,38 @@ int TIndex::PartialFlush(const int& WndInMsec) {
     return Res;
 }
 
+void TIndex::Flush() {
+    QmAssertR(!IsReadOnly(), "Index opened in read-only mode");
+    GixFull->Save();
+    GixSmall->Save();
+    GixTiny->Save();
+    GixPos->Save();
+    SaveIndexH();
+}
+
+void TIndex::SaveIndexH() {
+    {
+        TEnv::Logger->OnStatus("Saving location index");
+        TFOut SphereFOut(IndexFPath + "Index.Geo");
+        GeoIndexH.Save(SphereFOut);
+        TFOut GeoHashFOut(IndexFPath + "Index.GeoHash");
+        GeoHashIndexH.Save(GeoHashFOut);
+    }
+    {
+        TEnv::Logger->OnStatus("Saving btree index");
+        TFOut BTreeFOut(IndexFPath + "Index.BTree");
+        BTreeIndexByteH.Save(BTreeFOut);
+        BTreeIndexIntH.Save(BTreeFOut);
+        BTreeIndexInt16H.Save(BTreeFOut);
+        BTreeIndexInt64H.Save(BTreeFOut);
+        BTreeIndexUIntH.Save(BTreeFOut);
+        BTreeIndexUInt16H.Save(BTreeFOut);
+        BTreeIndexUInt64H.Save(BTreeFOut);
+        BTreeIndexFltH.Save(BTreeFOut);
+        BTreeIndexSFltH.Save(BTreeFOut);
+    }
+}
+
 ///////////////////////////////
 // QMiner-Aggregator
 TFunRouter<TAggr::TNewF> TAggr::NewRouter;
@@ -6592,6 +7282,118 @@ PAggr TAggr::New(const TWPt<TBase>& Base, const PRecSet& RecSet, const TQueryAgg
     return NewRouter.Fun(QueryAggr.GetType())(Base, QueryAggr.GetNm(), RecSet, QueryAggr.GetParamVal());
 }
 
+///////////////////////////////
+// QMiner-Stream-Aggregator-Statistics
+int TStreamAggrStats::GetBucketN(const uint64& NSecs) {
+    if (NSecs < 4) { return (int)NSecs; }
+    // keep the highest set bit and the two bits below it
+    const int Exp = (int)TMath::FloorLog2(NSecs) - 2;
+    return 4 + 4 * Exp + (int)((NSecs >> Exp) - 4);
+}
+
+uint64 TStreamAggrStats::GetBucketMxNSecs(const int& BucketN) {
+    if (BucketN < 4) { return (uint64)BucketN; }
+    const int Exp = (BucketN - 4) / 4;
+    const uint64 Val = 4 + (BucketN - 4) % 4;
+    return ((Val + 1) << Exp) - 1;
+}
+
+uint64 TStreamAggrStats::GetNSecs(const uint64& Ticks) {
+    static const uint64 TicksPerSec = TTm::GetPerfTimerFq();
+    if (TicksPerSec == 1000000000) { return Ticks; }
+    return (uint64)((double)Ticks * (1e9 / (double)TicksPerSec));
+}
+
+void TStreamAggrStats::Add(const TStreamAggrEvent& Event, const uint64& NSecs) {
+    CallsV[(int)Event]++;
+    BucketV[GetBucketN(NSecs)]++;
+    SumNSecs += NSecs;
+    if (NSecs > MxNSecs) { MxNSecs = NSecs; }
+}
+
+void TStreamAggrStats::AddMem(const uint64& MemUsed) {
+    if (!MemP) { StartMem = MemUsed; LastMem = MemUsed; MemP = true; }
+    PrevMem = LastMem;
+    LastMem = MemUsed;
+}
+
+void TStreamAggrStats::Clr() {
+    CallsV.PutAll(0);
+    BucketV.PutAll(0);
+    SumNSecs = 0;
+    MxNSecs = 0;
+    // next report of memory footprint starts tracking anew
+    MemP = false;
+}
+
+uint64 TStreamAggrStats::GetCalls() const {
+    uint64 Calls = 0;
+    for (int EventN = 0; EventN < CallsV.Len(); EventN++) {
+        Calls += CallsV[EventN];
+    }
+    return Calls;
+}
+
+double TStreamAggrStats::GetLatencyMSecs(const double& Percentile) const {
+    const uint64 Calls = GetCalls();
+    if (Calls == 0) { return 0.0; }
+    // number of calls at or below the percentile
+    const uint64 TargetCalls = TUInt64::GetMx(1, (uint64)ceil(Percentile * (double)Calls));
+    uint64 SumCalls = 0;
+    for (int BucketN = 0; BucketN < Buckets; BucketN++) {
+        SumCalls += BucketV[BucketN];
+        if (SumCalls >= TargetCalls) {
+            return (double)TUInt64::GetMn(GetBucketMxNSecs(BucketN), MxNSecs) / 1e6;
+        }
+    }
+    return GetMxLatencyMSecs();
+}
+
+double TStreamAggrStats::GetMeanLatencyMSecs() const {
+    const uint64 Calls = GetCalls();
+    return (Calls > 0) ? ((double)SumNSecs / (double)Calls / 1e6) : 0.0;
+}
+
+PJsonVal TStreamAggrStats::GetJson() const {
+    PJsonVal CallsVal = TJsonVal::NewObj();
+    for (int EventN = 0; EventN < saeMx; EventN++) {
+        CallsVal->AddToObj(GetEventStr((TStreamAggrEvent)EventN), CallsV[EventN].Val);
+    }
+    CallsVal->AddToObj("total", GetCalls());
+
+    PJsonVal LatencyVal = TJsonVal::NewObj();
+    LatencyVal->AddToObj("mean", GetMeanLatencyMSecs());
+    LatencyVal->AddToObj("p50", GetLatencyMSecs(0.5));
+    LatencyVal->AddToObj("p99", GetLatencyMSecs(0.99));
+    LatencyVal->AddToObj("max", GetMxLatencyMSecs());
+
+    PJsonVal StatsVal = TJsonVal::NewObj();
+    StatsVal->AddToObj("calls", CallsVal);
+    StatsVal->AddToObj("latency", LatencyVal);
+    StatsVal->AddToObj("memStart", StartMem.Val);
+    StatsVal->AddToObj("memGrowth", GetMemGrowth());
+    StatsVal->AddToObj("memLastGrowth", GetLastMemGrowth());
+    return StatsVal;
+}
+
+uint64 TStreamAggrStats::GetMemUsed() const {
+    return sizeof(TStreamAggrStats) +
+           TMemUtils::GetExtraMemberSize(CallsV) +
+           TMemUtils::GetExtraMemberSize(BucketV);
+}
+
+TStr TStreamAggrStats::GetEventStr(const TStreamAggrEvent& Event) {
+    switch (Event) {
+        case saeStep: return "onStep";
+        case saeTime: return "onTime";
+        case saeAddRec: return "onAdd";
+        case saeAddRecBatch: return "onAddBatch";
+        case saeUpdateRec: return "onUpdate";
+        case saeDeleteRec: return "onDelete";
+        default: throw TQmExcept::New("Unknown stream aggregate event");
+    }
+}
+
 ///////////////////////////////
 // QMiner-Stream-Aggregator
 TFunRouter<TStreamAggr::TNewF> TStreamAggr::NewRouter;
@@ -6673,6 +7475,12 @@ PJsonVal TStreamAggr::SaveStateJson() const {
     throw TQmExcept::New("TStreamAggr::SaveStateJson not implemented:" + GetAggrNm());
 };
 
+void TStreamAggr::OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr) {
+    for (int RecN = 0; RecN < RecSet->GetRecs(); RecN++) {
+        OnAddRec(RecSet->GetRec(RecN), CallerAggr);
+    }
+}
+
 uint64 TStreamAggr::GetMemUsed() const {
     // sizeof(TStreamAggr) returns the size of this class including all its members and
     // alignment, but discards the size of any pointers that the members hold which
@@ -6680,16 +7488,129 @@ uint64 TStreamAggr::GetMemUsed() const {
     return sizeof(TStreamAggr) +
            TMemUtils::GetExtraMemberSize(CRef) +
            TMemUtils::GetExtraMemberSize(AggrNm) +
-           TMemUtils::GetExtraMemberSize(ExeTm);
+           TMemUtils::GetExtraMemberSize(ExeTm) +
+           TMemUtils::GetExtraMemberSize(AggrStats);
 }
 
 ///////////////////////////////
 // QMiner-Stream-Aggregator-Set
+void TStreamAggrSet::OnEvent(const TWPt<TStreamAggr>& StreamAggr, const TStreamAggrEvent& Event,
+        const uint64& TmMsec, const TRec& Rec, const PRecSet& RecSet) {
+
+    TStreamAggrStats::TScope StatsScope(StreamAggr->GetAggrStats(), Event);
+    switch (Event) {
+        case saeStep: StreamAggr->OnStep(this); break;
+        case saeTime: StreamAggr->OnTime(TmMsec, this); break;
+        case saeAddRec: StreamAggr->OnAddRec(Rec, this); break;
+        case saeAddRecBatch: StreamAggr->OnAddRecBatch(RecSet, this); break;
+        case saeUpdateRec: StreamAggr->OnUpdateRec(Rec, this); break;
+        case saeDeleteRec: StreamAggr->OnDeleteRec(Rec, this); break;
+        default: throw TQmExcept::New("Unknown stream aggregate event");
+    }
+}
+
+void TStreamAggrSet::OnEvent(const TStreamAggrEvent& Event, const uint64& TmMsec,
+        const TRec& Rec, const PRecSet& RecSet) {
+
+    TScopeStopWatch StopWatch(ExeTm);
+    // default is to call aggregates in the order they were added; batches
+    // always go by levels, since all records must pass inputs before consumers
+    if (Threads <= 1 && !DeterministicP && Event != saeAddRecBatch) {
+        for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
+            OnEvent(StreamAggr, Event, TmMsec, Rec, RecSet);
+        }
+        return;
+    }
+    // go over levels, each depends only on the previous ones
+    for (const TIntV& AggrNV : LevelAggrNVV) {
+        if (DeterministicP || Threads <= 1 || AggrNV.Len() == 1) {
+            for (int AggrNN = 0; AggrNN < AggrNV.Len(); AggrNN++) {
+                OnEvent(StreamAggrV[AggrNV[AggrNN]], Event, TmMsec, Rec, RecSet);
+            }
+            continue;
+        }
+        // consecutive thread safe aggregates run in parallel, others alone
+        int AggrNN = 0;
+        while (AggrNN < AggrNV.Len()) {
+            int EndNN = AggrNN;
+            while (EndNN < AggrNV.Len() && ThreadSafeV[AggrNV[EndNN]]) { EndNN++; }
+            if (EndNN - AggrNN > 1) {
+                OnEventPar(AggrNV, AggrNN, EndNN, Event, TmMsec, Rec, RecSet);
+                AggrNN = EndNN;
+            } else {
+                OnEvent(StreamAggrV[AggrNV[AggrNN]], Event, TmMsec, Rec, RecSet);
+                AggrNN++;
+            }
+        }
+    }
+}
+
+void TStreamAggrSet::OnEventPar(const TIntV& AggrNV, const int& StartNN, const int& EndNN,
+        const TStreamAggrEvent& Event, const uint64& TmMsec, const TRec& Rec, const PRecSet& RecSet) {
+
+    PExcept Except; const int ParThreads = TInt::GetMn(Threads, EndNN - StartNN);
+    #pragma omp parallel for schedule(dynamic,1) num_threads(ParThreads)
+    for (int AggrNN = StartNN; AggrNN < EndNN; AggrNN++) {
+        try {
+            OnEvent(StreamAggrV[AggrNV[AggrNN]], Event, TmMsec, Rec, RecSet);
+        } catch (PExcept& _Except) {
+            #pragma omp critical(TStreamAggrSetExcept)
+            if (Except.Empty()) { Except = _Except; }
+        }
+    }
+    // rethrow first exception
+    if (!Except.Empty()) { throw Except; }
+}
+
+void TStreamAggrSet::UpdateLevels() {
+    // positions of aggregates in the set
+    TStrH AggrNmToNH;
+    for (int AggrN = 0; AggrN < StreamAggrV.Len(); AggrN++) {
+        AggrNmToNH.AddDat(StreamAggrV[AggrN]->GetAggrNm(), AggrN);
+    }
+    // inputs of each aggregate which are also in the set
+    TVec<TIntV> InAggrNVV(StreamAggrV.Len()); InAggrInSetP = true;
+    for (int AggrN = 0; AggrN < StreamAggrV.Len(); AggrN++) {
+        TStrV InAggrNmV; StreamAggrV[AggrN]->GetInAggrNmV(InAggrNmV);
+        for (const TStr& InAggrNm : InAggrNmV) {
+            if (AggrNmToNH.IsKey(InAggrNm)) {
+                InAggrNVV[AggrN].Add(AggrNmToNH.GetDat(InAggrNm));
+            } else {
+                InAggrInSetP = false;
+            }
+        }
+    }
+    // level of an aggregate is one more than the highest level of its inputs from the set;
+    // inputs are usually added before their consumers, so this converges in one or two passes
+    TIntV LevelV(StreamAggrV.Len()); int MxLevel = 0; bool ChangeP = true;
+    for (int PassN = 0; ChangeP; PassN++) {
+        QmAssertR(PassN <= StreamAggrV.Len(), "[TStreamAggrSet] Cycle between stream aggregates");
+        ChangeP = false;
+        for (int AggrN = 0; AggrN < StreamAggrV.Len(); AggrN++) {
+            for (int InAggrNN = 0; InAggrNN < InAggrNVV[AggrN].Len(); InAggrNN++) {
+                const int InLevel = LevelV[InAggrNVV[AggrN][InAggrNN]];
+                if (LevelV[AggrN] <= InLevel) { LevelV[AggrN] = InLevel + 1; ChangeP = true; }
+            }
+            MxLevel = TInt::GetMx(MxLevel, LevelV[AggrN]);
+        }
+    }
+    // group aggregates by levels, keeping order of adding within a level
+    LevelAggrNVV.Gen(StreamAggrV.Empty() ? 0 : MxLevel + 1);
+    for (int AggrN = 0; AggrN < StreamAggrV.Len(); AggrN++) {
+        LevelAggrNVV[LevelV[AggrN]].Add(AggrN);
+    }
+    // remember which aggregates can run in parallel with others
+    ThreadSafeV.Gen(StreamAggrV.Len());
+    for (int AggrN = 0; AggrN < StreamAggrV.Len(); AggrN++) {
+        ThreadSafeV[AggrN] = StreamAggrV[AggrN]->IsThreadSafe();
+    }
+}
+
 TStreamAggrSet::TStreamAggrSet(const TWPt<TBase>& _Base, const TStr& _AggrNm):
-    TStreamAggr(_Base, _AggrNm) { }
+    TStreamAggr(_Base, _AggrNm), Threads(1), DeterministicP(false), InAggrInSetP(true) { }
 
 TStreamAggrSet::TStreamAggrSet(const TWPt<TBase>& _Base, const PJsonVal& ParamVal):
-        TStreamAggr(_Base, ParamVal) {
+        TStreamAggr(_Base, ParamVal), Threads(1), DeterministicP(false), InAggrInSetP(true) {
 
     // get list of arrays
     QmAssertR(ParamVal->IsObjKey("aggregates"), "[TStreamAggrSet] Expecting array of aggregates");
@@ -6706,6 +7627,8 @@ TStreamAggrSet::TStreamAggrSet(const TWPt<TBase>& _Base, const PJsonVal& ParamVa
         // get it and add it to the set
         AddStreamAggr(GetBase()->GetStreamAggr(SubAggrNm));
     }
+    // parallel execution
+    SetParams(ParamVal);
 }
 
 PStreamAggr TStreamAggrSet::New(const TWPt<TBase>& Base) {
@@ -6733,6 +7656,7 @@ void TStreamAggrSet::AddStreamAggr(const PStreamAggr& StreamAggr) {
     QmAssertR(GetBase()->IsStreamAggr(StreamAggr->GetAggrNm()),
         "[TStreamAggrSet] Unregistered stream aggregate " + StreamAggr->GetAggrNm());
     StreamAggrV.Add(StreamAggr());
+    UpdateLevels();
 }
 
 const TWPt<TStreamAggr>& TStreamAggrSet::GetStreamAggr(const int& StreamAggrN) const {
@@ -6747,6 +7671,34 @@ TStrV TStreamAggrSet::GetStreamAggrNmV() const {
     return StreamAggrNmV;
 }
 
+void TStreamAggrSet::PutThreads(const int& _Threads) {
+    QmAssertR(_Threads >= 1, "[TStreamAggrSet] Number of threads must be positive");
+    Threads = _Threads;
+}
+
+TVec<TStrV> TStreamAggrSet::GetLevelStreamAggrNmVV() const {
+    TVec<TStrV> LevelAggrNmVV(LevelAggrNVV.Len(), 0);
+    for (const TIntV& AggrNV : LevelAggrNVV) {
+        TStrV& AggrNmV = LevelAggrNmVV[LevelAggrNmVV.Add()];
+        for (int AggrNN = 0; AggrNN < AggrNV.Len(); AggrNN++) {
+            AggrNmV.Add(StreamAggrV[AggrNV[AggrNN]]->GetAggrNm());
+        }
+    }
+    return LevelAggrNmVV;
+}
+
+PJsonVal TStreamAggrSet::GetParams() const {
+    PJsonVal ParamVal = TJsonVal::NewObj();
+    ParamVal->AddToObj("threads", Threads);
+    ParamVal->AddToObj("deterministic", DeterministicP);
+    return ParamVal;
+}
+
+void TStreamAggrSet::SetParams(const PJsonVal& ParamVal) {
+    if (ParamVal->IsObjKey("threads")) { PutThreads(ParamVal->GetObjInt("threads")); }
+    if (ParamVal->IsObjKey("deterministic")) { PutDeterministic(ParamVal->GetObjBool("deterministic")); }
+}
+
 void TStreamAggrSet::Reset() {
     for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
         StreamAggr->Reset();
@@ -6754,38 +7706,43 @@ void TStreamAggrSet::Reset() {
 }
 
 void TStreamAggrSet::OnStep(const TWPt<TStreamAggr>& CallerAggr) {
-    TScopeStopWatch StopWatch(ExeTm);
-    for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
-        StreamAggr->OnStep(this);
-    }
+    OnEvent(saeStep, 0, TRec(), NULL);
 }
 
 void TStreamAggrSet::OnTime(const uint64& TmMsec, const TWPt<TStreamAggr>& CallerAggr) {
-    TScopeStopWatch StopWatch(ExeTm);
-    for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
-        StreamAggr->OnTime(TmMsec, this);
-    }
+    OnEvent(saeTime, TmMsec, TRec(), NULL);
 }
 
 void TStreamAggrSet::OnAddRec(const TRec& Rec, const TWPt<TStreamAggr>& CallerAggr) {
-    TScopeStopWatch StopWatch(ExeTm);
-    for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
-        StreamAggr->OnAddRec(Rec, this);
+    OnEvent(saeAddRec, 0, Rec, NULL);
+}
+
+bool TStreamAggrSet::IsBatch() const {
+    if (!InAggrInSetP) { return false; }
+    for (const TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
+        if (!StreamAggr->IsBatch()) { return false; }
     }
+    return true;
 }
 
-void TStreamAggrSet::OnUpdateRec(const TRec& Rec, const TWPt<TStreamAggr>& CallerAggr) {
-    TScopeStopWatch StopWatch(ExeTm);
-    for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
-        StreamAggr->OnUpdateRec(Rec, this);
+void TStreamAggrSet::OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr) {
+    if (IsBatch()) {
+        // each aggregate gets the whole batch after its inputs
+        OnEvent(saeAddRecBatch, 0, TRec(), RecSet);
+    } else {
+        // one record after another through all the aggregates
+        for (int RecN = 0; RecN < RecSet->GetRecs(); RecN++) {
+            OnEvent(saeAddRec, 0, RecSet->GetRec(RecN), NULL);
+        }
     }
 }
 
+void TStreamAggrSet::OnUpdateRec(const TRec& Rec, const TWPt<TStreamAggr>& CallerAggr) {
+    OnEvent(saeUpdateRec, 0, Rec, NULL);
+}
+
 void TStreamAggrSet::OnDeleteRec(const TRec& Rec, const TWPt<TStreamAggr>& CallerAggr) {
-    TScopeStopWatch StopWatch(ExeTm);
-    for (TWPt<TStreamAggr>& StreamAggr : StreamAggrV) {
-        StreamAggr->OnDeleteRec(Rec, this);
-    }
+    OnEvent(saeDeleteRec, 0, Rec, NULL);
 }
 
 void TStreamAggrSet::PrintStat() const {
@@ -6810,17 +7767,480 @@ PStoreTrigger TStreamAggrTrigger::New(const TWPt<TStreamAggr>& StreamAggr) {
 }
 
 void TStreamAggrTrigger::OnAdd(const TRec& Rec) {
+    TStreamAggrStats::TScope StatsScope(StreamAggr->GetAggrStats(), saeAddRec);
     StreamAggr->OnAddRec(Rec, NULL);
 }
 
+void TStreamAggrTrigger::OnAddBatch(const PRecSet& RecSet) {
+    TStreamAggrStats::TScope StatsScope(StreamAggr->GetAggrStats(), saeAddRecBatch);
+    StreamAggr->OnAddRecBatch(RecSet, NULL);
+}
+
 void TStreamAggrTrigger::OnUpdate(const TRec& Rec) {
+    TStreamAggrStats::TScope StatsScope(StreamAggr->GetAggrStats(), saeUpdateRec);
     StreamAggr->OnUpdateRec(Rec, NULL);
 }
 
 void TStreamAggrTrigger::OnDelete(const TRec& Rec) {
+    TStreamAggrStats::TScope StatsScope(StreamAggr->GetAggrStats(), saeDeleteRec);
     StreamAggr->OnDeleteRec(Rec, NULL);
 }
 
+///////////////////////////////
+// QMiner-Base-Write-Ahead-Log
+void TBaseWal::TOp::AddRec(const uint& StoreId, const PJsonVal& RecVal) const {
+    if (!IsLog()) { return; }
+    TMOut EntryOut; StartEntry(wetAddRec, EntryOut);
+    TUInt(StoreId).Save(EntryOut);
+    TJsonVal::GetStrFromVal(RecVal).Save(EntryOut);
+    Wal->AddEntry(EntryOut);
+}
+
+void TBaseWal::TOp::UpdateRec(const uint& StoreId, const uint64& RecId, const PJsonVal& RecVal) const {
+    if (!IsLog()) { return; }
+    TMOut EntryOut; StartEntry(wetUpdateRec, EntryOut);
+    TUInt(StoreId).Save(EntryOut);
+    TUInt64(RecId).Save(EntryOut);
+    TJsonVal::GetStrFromVal(RecVal).Save(EntryOut);
+    Wal->AddEntry(EntryOut);
+}
+
+void TBaseWal::TOp::AddRecBatch(const uint& StoreId, const TRecBatch& RecBatch) const {
+    if (!IsLog()) { return; }
+    TMOut EntryOut; StartEntry(wetAddRecBatch, EntryOut);
+    TUInt(StoreId).Save(EntryOut);
+    RecBatch.Save(EntryOut);
+    Wal->AddEntry(EntryOut);
+}
+
+void TBaseWal::TOp::DelRecs(const uint& StoreId, const TUInt64V& DelRecIdV, const int& DelRecs) const {
+    if (!IsLog() || DelRecs == 0) { return; }
+    TMOut EntryOut; StartEntry(wetDelRecs, EntryOut);
+    TUInt(StoreId).Save(EntryOut);
+    // only the records which were actually deleted
+    TUInt64V LogRecIdV; DelRecIdV.GetSubValV(0, DelRecs - 1, LogRecIdV);
+    LogRecIdV.Save(EntryOut);
+    Wal->AddEntry(EntryOut);
+}
+
+void TBaseWal::TOp::DelAllRecs(const uint& StoreId) const {
+    if (!IsLog()) { return; }
+    TMOut EntryOut; StartEntry(wetDelAllRecs, EntryOut);
+    TUInt(StoreId).Save(EntryOut);
+    Wal->AddEntry(EntryOut);
+}
+
+void TBaseWal::TOp::AddJoin(const uint& StoreId, const int& JoinId, const uint64& RecId,
+        const uint64& JoinRecId, const int& JoinFq) const {
+
+    if (!IsLog()) { return; }
+    TMOut EntryOut; StartEntry(wetAddJoin, EntryOut);
+    TUInt(StoreId).Save(EntryOut); TInt(JoinId).Save(EntryOut);
+    TUInt64(RecId).Save(EntryOut); TUInt64(JoinRecId).Save(EntryOut);
+    TInt(JoinFq).Save(EntryOut);
+    Wal->AddEntry(EntryOut);
+}
+
+void TBaseWal::TOp::DelJoin(const uint& StoreId, const int& JoinId, const uint64& RecId,
+        const uint64& JoinRecId, const int& JoinFq) const {
+
+    if (!IsLog()) { return; }
+    TMOut EntryOut; StartEntry(wetDelJoin, EntryOut);
+    TUInt(StoreId).Save(EntryOut); TInt(JoinId).Save(EntryOut);
+    TUInt64(RecId).Save(EntryOut); TUInt64(JoinRecId).Save(EntryOut);
+    TInt(JoinFq).Save(EntryOut);
+    Wal->AddEntry(EntryOut);
+}
+
+void TBaseWal::TOp::SetField(const TWPt<TStore>& Store, const uint64& RecId, const int& FieldId) const {
+    if (!IsLog()) { return; }
+    TMOut EntryOut; StartEntry(wetSetField, EntryOut);
+    TUInt(Store->GetStoreId()).Save(EntryOut);
+    TUInt64(RecId).Save(EntryOut); TInt(FieldId).Save(EntryOut);
+    // value is logged in its native form, so replay sets exactly the same value
+    const bool NullP = Store->IsFieldNull(RecId, FieldId);
+    TBool(NullP).Save(EntryOut);
+    if (NullP) { Wal->AddEntry(EntryOut); return; }
+    const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
+    if (Desc.IsInt()) {
+        TInt(Store->GetFieldInt(RecId, FieldId)).Save(EntryOut);
+    } else if (Desc.IsInt16()) {
+        TInt(Store->GetFieldInt16(RecId, FieldId)).Save(EntryOut);
+    } else if (Desc.IsInt64()) {
+        TInt64(Store->GetFieldInt64(RecId, FieldId)).Save(EntryOut);
+    } else if (Desc.IsByte()) {
+        TUCh(Store->GetFieldByte(RecId, FieldId)).Save(EntryOut);
+    } else if (Desc.IsIntV()) {
+        TIntV FieldIntV; Store->GetFieldIntV(RecId, FieldId, FieldIntV);
+        FieldIntV.Save(EntryOut);
+    } else if (Desc.IsUInt()) {
+        TUInt(Store->GetFieldUInt(RecId, FieldId)).Save(EntryOut);
+    } else if (Desc.IsUInt16()) {
+        TUInt(Store->GetFieldUInt16(RecId, FieldId)).Save(EntryOut);
+    } else if (Desc.IsUInt64()) {
+        TUInt64(Store->GetFieldUInt64(RecId, FieldId)).Save(EntryOut);
+    } else if (Desc.IsStr()) {
+        Store->GetFieldStr(RecId, FieldId).Save(EntryOut);
+    } else if (Desc.IsStrV()) {
+        TStrV FieldStrV; Store->GetFieldStrV(RecId, FieldId, FieldStrV);
+        FieldStrV.Save(EntryOut);
+    } else if (Desc.IsBool()) {
+        TBool(Store->GetFieldBool(RecId, FieldId)).Save(EntryOut);
+    } else if (Desc.IsFlt()) {
+        TFlt(Store->GetFieldFlt(RecId, FieldId)).Save(EntryOut);
+    } else if (Desc.IsSFlt()) {
+        TSFlt(Store->GetFieldSFlt(RecId, FieldId)).Save(EntryOut);
+    } else if (Desc.IsFltPr()) {
+        Store->GetFieldFltPr(RecId, FieldId).Save(EntryOut);
+    } else if (Desc.IsFltV()) {
+        TFltV FieldFltV; Store->GetFieldFltV(RecId, FieldId, FieldFltV);
+        FieldFltV.Save(EntryOut);
+    } else if (Desc.IsTm()) {
+        TUInt64(Store->GetFieldTmMSecs(RecId, FieldId)).Save(EntryOut);
+    } else if (Desc.IsNumSpV()) {
+        TIntFltKdV FieldIntFltKdV; Store->GetFieldNumSpV(RecId, FieldId, FieldIntFltKdV);
+        FieldIntFltKdV.Save(EntryOut);
+    } else if (Desc.IsBowSpV()) {
+        PBowSpV FieldBowSpV; Store->GetFieldBowSpV(RecId, FieldId, FieldBowSpV);
+        FieldBowSpV->Save(EntryOut);
+    } else if (Desc.IsTMem()) {
+        TMem FieldMem; Store->GetFieldTMem(RecId, FieldId, FieldMem);
+        FieldMem.Save(EntryOut);
+    } else if (Desc.IsJson()) {
+        TJsonVal::GetStrFromVal(Store->GetFieldJsonVal(RecId, FieldId)).Save(EntryOut);
+    } else {
+        throw TQmExcept::New("Write-ahead log: unsupported type of field " + Desc.GetFieldNm());
+    }
+    Wal->AddEntry(EntryOut);
+}
+
+void TBaseWal::PutEntry(const TMOut& EntryOut, TSOut& SOut) {
+    const int EntryLen = EntryOut.Len();
+    TInt(EntryLen).Save(SOut);
+    TInt(TCs::GetCsFromBf(EntryOut.GetBfAddr(), EntryLen).Get()).Save(SOut);
+    SOut.PutBf(EntryOut.GetBfAddr(), EntryLen);
+}
+
+void TBaseWal::AddEntry(const TMOut& EntryOut) {
+    PutEntry(EntryOut, PendingOut);
+    PendingEntries++; Entries++;
+    // commit when required by the sync policy
+    if (SyncPolicy == wspRec) {
+        Commit();
+    } else if (SyncPolicy == wspGroup) {
+        if (PendingEntries >= GroupSize) { Commit(); }
+    } else if (TTm::GetCurUniMSecs() - SyncMSecs >= (uint64)IntervalMSecs.Val) {
+        Commit();
+    }
+}
+
+void TBaseWal::ReplayEntry(const TWPt<TBase>& Base, TSIn& EntrySIn, THash<TStr, TMem>& StreamAggrStateH) {
+    const TEntryType Type = (TEntryType)TCh(EntrySIn).Val;
+    if (Type == wetStreamAggr) {
+        TStr StreamAggrNm(EntrySIn); TMem State(EntrySIn);
+        // keep the state in the log after the next checkpoint
+        StreamAggrNmSet.AddKey(StreamAggrNm);
+        if (Base->IsStreamAggr(StreamAggrNm)) {
+            TMemIn StateIn(State);
+            Base->GetStreamAggr(StreamAggrNm)->LoadState(StateIn);
+        } else {
+            // aggregate not registered yet, keep the state for later
+            StreamAggrStateH.AddDat(StreamAggrNm, State);
+        }
+        return;
+    }
+    // remaining entries are store updates
+    const TWPt<TStore> Store = Base->GetStoreByStoreId(TUInt(EntrySIn));
+    if (Type == wetAddRec) {
+        Store->AddRec(TJsonVal::GetValFromStr(TStr(EntrySIn)));
+    } else if (Type == wetUpdateRec) {
+        const TUInt64 RecId(EntrySIn);
+        Store->UpdateRec(RecId, TJsonVal::GetValFromStr(TStr(EntrySIn)));
+    } else if (Type == wetAddRecBatch) {
+        TRecBatch RecBatch(Store, EntrySIn); TUInt64V RecIdV;
+        Store->AddRecBatch(RecBatch, RecIdV);
+    } else if (Type == wetDelRecs) {
+        const TUInt64V DelRecIdV(EntrySIn);
+        Store->DeleteRecs(DelRecIdV, -1, false);
+    } else if (Type == wetDelAllRecs) {
+        Store->DeleteAllRecs();
+    } else if (Type == wetAddJoin || Type == wetDelJoin) {
+        const TInt JoinId(EntrySIn);
+        const TUInt64 RecId(EntrySIn), JoinRecId(EntrySIn);
+        const TInt JoinFq(EntrySIn);
+        if (Type == wetAddJoin) {
+            Store->AddJoin(JoinId, RecId, JoinRecId, JoinFq);
+        } else {
+            Store->DelJoin(JoinId, RecId, JoinRecId, JoinFq);
+        }
+    } else if (Type == wetSetField) {
+        const TUInt64 RecId(EntrySIn);
+        const TInt FieldId(EntrySIn);
+        const TBool NullP(EntrySIn);
+        if (NullP) { Store->SetFieldNull(RecId, FieldId); return; }
+        const TFieldDesc& Desc = Store->GetFieldDesc(FieldId);
+        if (Desc.IsInt()) {
+            Store->SetFieldInt(RecId, FieldId, TInt(EntrySIn));
+        } else if (Desc.IsInt16()) {
+            Store->SetFieldInt16(RecId, FieldId, (int16)TInt(EntrySIn).Val);
+        } else if (Desc.IsInt64()) {
+            Store->SetFieldInt64(RecId, FieldId, TInt64(EntrySIn));
+        } else if (Desc.IsByte()) {
+            Store->SetFieldByte(RecId, FieldId, TUCh(EntrySIn));
+        } else if (Desc.IsIntV()) {
+            Store->SetFieldIntV(RecId, FieldId, TIntV(EntrySIn));
+        } else if (Desc.IsUInt()) {
+            Store->SetFieldUInt(RecId, FieldId, TUInt(EntrySIn));
+        } else if (Desc.IsUInt16()) {
+            Store->SetFieldUInt16(RecId, FieldId, (uint16)TUInt(EntrySIn).Val);
+        } else if (Desc.IsUInt64()) {
+            Store->SetFieldUInt64(RecId, FieldId, TUInt64(EntrySIn));
+        } else if (Desc.IsStr()) {
+            Store->SetFieldStr(RecId, FieldId, TStr(EntrySIn));
+        } else if (Desc.IsStrV()) {
+            Store->SetFieldStrV(RecId, FieldId, TStrV(EntrySIn));
+        } else if (Desc.IsBool()) {
+            Store->SetFieldBool(RecId, FieldId, TBool(EntrySIn));
+        } else if (Desc.IsFlt()) {
+            Store->SetFieldFlt(RecId, FieldId, TFlt(EntrySIn));
+        } else if (Desc.IsSFlt()) {
+            Store->SetFieldSFlt(RecId, FieldId, TSFlt(EntrySIn));
+        } else if (Desc.IsFltPr()) {
+            Store->SetFieldFltPr(RecId, FieldId, TFltPr(EntrySIn));
+        } else if (Desc.IsFltV()) {
+            Store->SetFieldFltV(RecId, FieldId, TFltV(EntrySIn));
+        } else if (Desc.IsTm()) {
+            Store->SetFieldTmMSecs(RecId, FieldId, TUInt64(EntrySIn));
+        } else if (Desc.IsNumSpV()) {
+            Store->SetFieldNumSpV(RecId, FieldId, TIntFltKdV(EntrySIn));
+        } else if (Desc.IsBowSpV()) {
+            Store->SetFieldBowSpV(RecId, FieldId, TBowSpV::Load(EntrySIn));
+        } else if (Desc.IsTMem()) {
+            Store->SetFieldTMem(RecId, FieldId, TMem(EntrySIn));
+        } else if (Desc.IsJson()) {
+            Store->SetFieldJsonVal(RecId, FieldId, TJsonVal::GetValFromStr(TStr(EntrySIn)));
+        } else {
+            throw TQmExcept::New("Write-ahead log: unsupported type of field " + Desc.GetFieldNm());
+        }
+    } else {
+        throw TQmExcept::New(TStr::Fmt("Unknown write-ahead log entry type %d", (int)Type));
+    }
+}
+
+TBaseWal::~TBaseWal() {
+    Close();
+    if (DelP && TFile::Exists(FNm)) { TFile::Del(FNm); }
+}
+
+int TBaseWal::Replay(const TWPt<TBase>& Base, THash<TStr, TMem>& StreamAggrStateH) {
+    if (!TFile::Exists(FNm)) { return 0; }
+    const uint64 FLen = TFile::GetSize(FNm);
+    const uint64 HdLen = 2 * sizeof(int);
+    uint64 ValidLen = 0; int Replayed = 0;
+    {
+        TFIn FIn(FNm); TMem EntryMem;
+        while (FLen - ValidLen >= HdLen) {
+            const TInt EntryLen(FIn), EntryCs(FIn);
+            // stop at an entry which was not completely written
+            if (EntryLen < 0 || (uint64)EntryLen.Val > FLen - ValidLen - HdLen) { break; }
+            EntryMem.Gen(EntryLen);
+            FIn.GetBf(EntryMem.GetBf(), EntryLen);
+            if (TCs::GetCsFromBf(EntryMem.GetBf(), EntryLen).Get() != EntryCs) { break; }
+            ValidLen += HdLen + EntryLen;
+            // entry which failed originally fails also now, report and continue
+            try {
+                TMemIn EntrySIn(EntryMem);
+                ReplayEntry(Base, EntrySIn, StreamAggrStateH);
+            } catch (const PExcept& Except) {
+                TEnv::Error->OnStatusFmt("Write-ahead log entry %d failed: %s",
+                    Replayed, Except->GetMsgStr().CStr());
+            }
+            Replayed++;
+        }
+    }
+    TEnv::Logger->OnStatusFmt("Replayed %d write-ahead log entries", Replayed);
+    // cut off damaged tail, so new entries can be appended
+    if (ValidLen < FLen) {
+        TEnv::Logger->OnStatusFmt("Cutting off %s damaged bytes from write-ahead log",
+            TUInt64::GetStr(FLen - ValidLen).CStr());
+        const TStr TmpFNm = FNm + ".tmp";
+        {
+            TFIn FIn(FNm); TFOut TmpFOut(TmpFNm);
+            TMem BlockMem; uint64 CopyLen = 0;
+            while (CopyLen < ValidLen) {
+                const uint64 LeftLen = ValidLen - CopyLen;
+                const int BlockLen = (LeftLen < 1024 * 1024) ? (int)LeftLen : 1024 * 1024;
+                BlockMem.Gen(BlockLen);
+                FIn.GetBf(BlockMem.GetBf(), BlockLen);
+                TmpFOut.PutBf(BlockMem.GetBf(), BlockLen);
+                CopyLen += BlockLen;
+            }
+            TmpFOut.Sync();
+        }
+        TFile::Del(FNm);
+        TFile::Rename(TmpFNm, FNm);
+    }
+    return Replayed;
+}
+
+void TBaseWal::Open(const PJsonVal& ParamVal) {
+    Close();
+    // parse parameters
+    const TStr SyncStr = ParamVal->GetObjStr("sync", "group");
+    if (SyncStr == "rec") {
+        SyncPolicy = wspRec;
+    } else if (SyncStr == "group") {
+        SyncPolicy = wspGroup;
+    } else if (SyncStr == "interval") {
+        SyncPolicy = wspInterval;
+    } else {
+        throw TQmExcept::New("Unknown write-ahead log sync policy: " + SyncStr);
+    }
+    GroupSize = ParamVal->GetObjInt("groupSize", 128);
+    IntervalMSecs = ParamVal->GetObjInt("interval", 1000);
+    QmAssertR(GroupSize > 0 && IntervalMSecs > 0, "Write-ahead log group size and interval must be positive");
+    // open for appending
+    FOut = new TFOut(FNm, true);
+    SyncMSecs = TTm::GetCurUniMSecs();
+}
+
+void TBaseWal::Close() {
+    if (FOut == NULL) { return; }
+    Commit();
+    delete FOut; FOut = NULL;
+}
+
+void TBaseWal::AddStreamAggr(const TWPt<TStreamAggr>& StreamAggr) {
+    QmAssertR(IsOpen(), "Write-ahead log is not open");
+    TMOut StateOut; StreamAggr->SaveState(StateOut);
+    TMOut EntryOut; StartEntry(wetStreamAggr, EntryOut);
+    StreamAggr->GetAggrNm().Save(EntryOut);
+    TMem(StateOut.GetBfAddr(), StateOut.Len()).Save(EntryOut);
+    AddEntry(EntryOut);
+    StreamAggrNmSet.AddKey(StreamAggr->GetAggrNm());
+}
+
+void TBaseWal::Commit() {
+    if (FOut == NULL || PendingEntries == 0) { return; }
+    FOut->PutBf(PendingOut.GetBfAddr(), PendingOut.Len());
+    FOut->Sync();
+    Bytes += PendingOut.Len(); Syncs++;
+    PendingOut.Clr(); PendingEntries = 0;
+    SyncMSecs = TTm::GetCurUniMSecs();
+}
+
+void TBaseWal::Checkpoint(const THash<TStr, TMem>& StreamAggrStateH) {
+    if (!IsOpen()) {
+        // log left from before the save would be replayed over newer data
+        if (TFile::Exists(FNm)) { TFile::Del(FNm); }
+        StreamAggrNmSet.Clr();
+        return;
+    }
+    // entries logged so far are part of the save
+    PendingOut.Clr(); PendingEntries = 0;
+    delete FOut; FOut = NULL;
+    // new log starts with the stream aggregate states, written next to the old one
+    StreamAggrNmSet.Clr();
+    const TStr TmpFNm = FNm + ".tmp";
+    {
+        TFOut TmpFOut(TmpFNm);
+        int KeyId = StreamAggrStateH.FFirstKeyId();
+        while (StreamAggrStateH.FNextKeyId(KeyId)) {
+            const TStr& StreamAggrNm = StreamAggrStateH.GetKey(KeyId);
+            TMOut EntryOut; StartEntry(wetStreamAggr, EntryOut);
+            StreamAggrNm.Save(EntryOut);
+            StreamAggrStateH[KeyId].Save(EntryOut);
+            PutEntry(EntryOut, TmpFOut);
+            StreamAggrNmSet.AddKey(StreamAggrNm);
+        }
+        TmpFOut.Sync();
+    }
+    TFile::Del(FNm);
+    TFile::Rename(TmpFNm, FNm);
+    FOut = new TFOut(FNm, true);
+    SyncMSecs = TTm::GetCurUniMSecs();
+    CheckpointEntries = Entries; Checkpoints++;
+}
+
+PJsonVal TBaseWal::GetParamVal() const {
+    PJsonVal ParamVal = TJsonVal::NewObj();
+    ParamVal->AddToObj("sync", (SyncPolicy == wspRec) ? "rec" : ((SyncPolicy == wspGroup) ? "group" : "interval"));
+    ParamVal->AddToObj("groupSize", GroupSize.Val);
+    ParamVal->AddToObj("interval", IntervalMSecs.Val);
+    return ParamVal;
+}
+
+PJsonVal TBaseWal::GetJson() const {
+    PJsonVal ResVal = GetParamVal();
+    ResVal->AddToObj("entries", Entries.Val);
+    ResVal->AddToObj("bytes", Bytes.Val);
+    ResVal->AddToObj("syncs", Syncs.Val);
+    ResVal->AddToObj("pending", PendingEntries.Val);
+    ResVal->AddToObj("checkpoints", Checkpoints.Val);
+    return ResVal;
+}
+
+///////////////////////////////
+// QMiner-Base-Flusher
+TBaseFlusher::TBaseFlusher(const TWPt<TBase>& _Base, const int& _IntervalMSecs, const int& _BudgetMSecs):
+    Base(_Base), IntervalMSecs(_IntervalMSecs), BudgetMSecs(_BudgetMSecs), StopP(false),
+    Rounds(0), Saved(0), CheckpointMSecs(0), FlushedP(true) { }
+
+void TBaseFlusher::Run() {
+    while (!StopP) {
+        WaitForInterrupt(IntervalMSecs);
+        if (StopP) { break; }
+        try {
+            bool WalP, CheckpointP;
+            {
+                TBase::TDataLock Lock(Base);
+                WalP = Base->IsWal();
+                CheckpointP = WalP && Base->GetWal()->IsCheckpointDue();
+            }
+            if (WalP) {
+                // log is replayed over the last checkpoint, so data is only saved as a whole
+                if (CheckpointP) {
+                    Base->Checkpoint();
+                    CheckpointMSecs = TTm::GetCurUniMSecs();
+                }
+            } else {
+                // partial flush takes the base lock for each store and index slice
+                const int RoundSaved = Base->PartialFlush(BudgetMSecs);
+                Saved += RoundSaved;
+                if (RoundSaved > 0) {
+                    FlushedP = true;
+                } else if (FlushedP) {
+                    // everything is on disk, save what partial flushes do not write
+                    Base->Checkpoint();
+                    CheckpointMSecs = TTm::GetCurUniMSecs();
+                    FlushedP = false;
+                }
+            }
+            Rounds++;
+        } catch (const PExcept& Except) {
+            TEnv::Error->OnStatusFmt("Background flush failed: %s", Except->GetMsgStr().CStr());
+        }
+    }
+}
+
+void TBaseFlusher::Stop() {
+    StopP = true;
+    Interrupt();
+    Join();
+}
+
+PJsonVal TBaseFlusher::GetJson() const {
+    PJsonVal ResVal = TJsonVal::NewObj();
+    ResVal->AddToObj("interval", IntervalMSecs.Val);
+    ResVal->AddToObj("budget", BudgetMSecs.Val);
+    ResVal->AddToObj("rounds", (uint64)Rounds);
+    ResVal->AddToObj("saved", (uint64)Saved);
+    if (CheckpointMSecs > 0) {
+        ResVal->AddToObj("checkpoint", TTm::GetTmFromMSecs(CheckpointMSecs).GetWebLogDateTimeStr(true, "T"));
+    }
+    return ResVal;
+}
+
 ///////////////////////////////
 // QMiner-Base
 PRecSet TBase::Invert(const PRecSet& RecSet) {
@@ -6860,7 +8280,26 @@ TPair<TBool, PRecSet> TBase::_Search(const TQueryItem& QueryItem) {
             // unknown operator
             throw TQmExcept::New("Index: Unknown query item operator");
         }
-    } else if (QueryItem.IsTextPos()) {
+    } else if (QueryItem.IsAnd() || QueryItem.IsOr() || QueryItem.IsNot()) {
+        // exeucte all interal query items
+        TBoolV NotV; TRecSetV RecSetV;
+        for (int ItemN = 0; ItemN < QueryItem.GetItems(); ItemN++) {
+            // do subsequent search
+            TPair<TBool, PRecSet> NotRecSet = _Search(QueryItem.GetItem(ItemN));
+            NotV.Add(NotRecSet.Val1); RecSetV.Add(NotRecSet.Val2);
+        }
+        // merge the results according to the operator
+        return _SearchMerge(QueryItem, NotV, RecSetV);
+    } else if (IsSearchSubItems(QueryItem)) {
+        // join, do the subordinate queries and join the results
+        return _SearchJoin(QueryItem, _Search(QueryItem.GetItem(0)));
+    }
+    // other leafs go to stores and indexes
+    return _SearchLeaf(QueryItem);
+}
+
+TPair<TBool, PRecSet> TBase::_SearchLeaf(const TQueryItem& QueryItem) {
+    if (QueryItem.IsTextPos()) {
         // we have text position query
         PRecSet RecSet = Index->SearchTextPos(this, QueryItem.GetKeyId(),
             QueryItem.GetWordIdV(), QueryItem.GetMaxPosDiff());
@@ -6919,23 +8358,13 @@ TPair<TBool, PRecSet> TBase::_Search(const TQueryItem& QueryItem) {
         PRecSet RecSet = Index->SearchLinear(this, QueryItem.GetKeyId(), QueryItem.GetRangeSFltMinMax());
         return TPair<TBool, PRecSet>(false, RecSet);
     } else if (QueryItem.IsJoin()) {
-        // special case when it's record passed by value
+        // join of record passed by value
         const TQueryItem& SubItem = QueryItem.GetItem(0);
-        if (SubItem.IsRec() && SubItem.GetRec().IsByVal()) {
-            // do the join
-            PRecSet JoinRecSet = SubItem.GetRec().DoJoin(this, QueryItem.GetJoinId());
-            // return joined record set
-            return TPair<TBool, PRecSet>(false, JoinRecSet);
-        } else {
-            // do the subordinate queries
-            TPair<TBool, PRecSet> NotRecSet = _Search(QueryItem.GetItem(0));
-            // in case it's negated, we must invert it
-            if (NotRecSet.Val1) { NotRecSet.Val2 = Invert(NotRecSet.Val2); }
-            // do the join
-            PRecSet JoinRecSet = NotRecSet.Val2->DoJoin(this, QueryItem.GetJoinId(), QueryItem.GetSampleSize());
-            // return joined record set
-            return TPair<TBool, PRecSet>(false, JoinRecSet);
-        }
+        QmAssert(SubItem.IsRec() && SubItem.GetRec().IsByVal());
+        // do the join
+        PRecSet JoinRecSet = SubItem.GetRec().DoJoin(this, QueryItem.GetJoinId());
+        // return joined record set
+        return TPair<TBool, PRecSet>(false, JoinRecSet);
     } else if (QueryItem.IsRec()) {
         // make sure record past by reference
         QmAssert(QueryItem.GetRec().IsByRef());
@@ -6949,92 +8378,184 @@ TPair<TBool, PRecSet> TBase::_Search(const TQueryItem& QueryItem) {
         const uint StoreId = QueryItem.GetStoreId();
         const TWPt<TStore> Store = GetStoreByStoreId(StoreId);
         return TPair<TBool, PRecSet>(false, Store->GetAllRecs());
-    } else {
-        // we have an operator, make sure it is so!
-        QmAssert(QueryItem.IsAnd() || QueryItem.IsOr() || QueryItem.IsNot());
-        // exeucte all interal query items
-        TBoolV NotV; TRecSetV RecSetV;
+    }
+    // we should never have come to here
+    throw TQmExcept::New("Unsupported query item type");
+}
+
+TPair<TBool, PRecSet> TBase::_SearchMerge(const TQueryItem& QueryItem, const TBoolV& NotV, const TRecSetV& RecSetV) {
+    // we have an operator, make sure it is so!
+    QmAssert(QueryItem.IsAnd() || QueryItem.IsOr() || QueryItem.IsNot());
+    if (QueryItem.IsAnd()) {
+        // prepare working vectors with the first records set
+        TUInt64IntKdV ResRecIdFqV = RecSetV[0]->GetRecIdFqV();
+        QmAssert(ResRecIdFqV.IsSorted());
+        // current negation status
+        bool NotP = NotV[0];
+        // than handle the rest here
+        for (int ItemN = 1; ItemN < RecSetV.Len(); ItemN++) {
+            // get the vector
+            const TUInt64IntKdV& RecIdFqV = RecSetV[ItemN]->GetRecIdFqV();
+            // decide for the operation based on not status
+            if (!NotP && !NotV[ItemN]) {
+                // life is easy, just do the intersect
+                Index->GetSumMerger()->Intrs(ResRecIdFqV, RecIdFqV);
+            } else if (NotP && NotV[ItemN]) {
+                // all negation, do the union
+                Index->GetSumMerger()->Union(ResRecIdFqV, RecIdFqV);
+            } else if (NotP && !NotV[ItemN]) {
+                // records from RecIdFqV should not be in the main
+                TUInt64IntKdV _ResRecIdFqV;
+                Index->GetSumMerger()->Minus(RecIdFqV, ResRecIdFqV, _ResRecIdFqV);
+                ResRecIdFqV = _ResRecIdFqV;
+                NotP = false;
+            } else if (!NotP && NotV[ItemN]) {
+                // records from main should not be in the RecIdFqV
+                TUInt64IntKdV _ResRecIdFqV;
+                Index->GetSumMerger()->Minus(ResRecIdFqV, RecIdFqV, _ResRecIdFqV);
+                ResRecIdFqV = _ResRecIdFqV;
+                NotP = false;
+            }
+        }
+        // prepare resulting record set
+        PRecSet RecSet = TRecSet::New(RecSetV[0]->GetStore(), ResRecIdFqV, QueryItem.IsFq());
+        return TPair<TBool, PRecSet>(NotP, RecSet);
+    } else if (QueryItem.IsOr()) {
+        // prepare working vectors with the first records set
+        TUInt64IntKdV ResRecIdFqV = RecSetV[0]->GetRecIdFqV();
+        QmAssert(ResRecIdFqV.IsSorted());
+        // current negation status
+        bool NotP = NotV[0];
+        // than handle the rest here
+        for (int ItemN = 1; ItemN < RecSetV.Len(); ItemN++) {
+            // get the vector
+            const TUInt64IntKdV& RecIdFqV = RecSetV[ItemN]->GetRecIdFqV();
+            // decide for the operation based on not status
+            if (!NotP && !NotV[ItemN]) {
+                Index->GetSumMerger()->Union(ResRecIdFqV, RecIdFqV);
+            } else if (NotP && NotV[ItemN]) {
+                // all negation, do the intersect
+                Index->GetSumMerger()->Intrs(ResRecIdFqV, RecIdFqV);
+            } else if (NotP && !NotV[ItemN]) {
+                // records not from main or from RecIdFqV
+                TUInt64IntKdV _ResRecIdFqV;
+                Index->GetSumMerger()->Minus(ResRecIdFqV, RecIdFqV, _ResRecIdFqV);
+                ResRecIdFqV = _ResRecIdFqV;
+                NotP = true;
+            } else if (!NotP && NotV[ItemN]) {
+                // records from main or not from RecIdFqV
+                TUInt64IntKdV _ResRecIdFqV;
+                Index->GetSumMerger()->Minus(RecIdFqV, ResRecIdFqV, _ResRecIdFqV);
+                ResRecIdFqV = _ResRecIdFqV;
+                NotP = true;
+            }
+        }
+        // prepare resulting record set
+        PRecSet RecSet = TRecSet::New(RecSetV[0]->GetStore(), ResRecIdFqV, QueryItem.IsFq());
+        return TPair<TBool, PRecSet>(NotP, RecSet);
+    } else if (QueryItem.IsNot()) {
+        // just return records set but negate the current negation status
+        QmAssert(RecSetV.Len() == 1);
+        return TPair<TBool, PRecSet>(!NotV[0], RecSetV[0]);
+    }
+    // we should never have come to here
+    throw TQmExcept::New("Unsupported query item type");
+}
+
+TPair<TBool, PRecSet> TBase::_SearchJoin(const TQueryItem& QueryItem, TPair<TBool, PRecSet> NotRecSet) {
+    // in case it's negated, we must invert it
+    if (NotRecSet.Val1) { NotRecSet.Val2 = Invert(NotRecSet.Val2); }
+    // do the join
+    PRecSet JoinRecSet = NotRecSet.Val2->DoJoin(this, QueryItem.GetJoinId(), QueryItem.GetSampleSize());
+    // return joined record set
+    return TPair<TBool, PRecSet>(false, JoinRecSet);
+}
+
+bool TBase::IsSearchSubItems(const TQueryItem& QueryItem) {
+    if (QueryItem.IsAnd() || QueryItem.IsOr() || QueryItem.IsNot()) { return true; }
+    // joins of records passed by value are executed directly
+    if (QueryItem.IsJoin()) {
+        const TQueryItem& SubItem = QueryItem.GetItem(0);
+        return !(SubItem.IsRec() && SubItem.GetRec().IsByVal());
+    }
+    return false;
+}
+
+int TBase::GetSearchNodes(const TQueryItem& QueryItem, TVec<const TQueryItem*>& NodeV,
+        TIntV& HeightV, TVec<TIntV>& SubNodeNVV) const {
+
+    // first add subordinate items, height of the node is one more than of the highest one
+    TIntV SubNodeNV; int Height = 0;
+    if (IsSearchSubItems(QueryItem)) {
         for (int ItemN = 0; ItemN < QueryItem.GetItems(); ItemN++) {
-            // do subsequent search
-            TPair<TBool, PRecSet> NotRecSet = _Search(QueryItem.GetItem(ItemN));
-            NotV.Add(NotRecSet.Val1); RecSetV.Add(NotRecSet.Val2);
+            const int SubNodeN = GetSearchNodes(QueryItem.GetItem(ItemN), NodeV, HeightV, SubNodeNVV);
+            SubNodeNV.Add(SubNodeN);
+            Height = TInt::GetMx(Height, HeightV[SubNodeN] + 1);
         }
-        // merge the results according to the operator
-        if (QueryItem.IsAnd()) {
-            // prepare working vectors with the first records set
-            TUInt64IntKdV ResRecIdFqV = RecSetV[0]->GetRecIdFqV();
-            QmAssert(ResRecIdFqV.IsSorted());
-            // current negation status
-            bool NotP = NotV[0];
-            // than handle the rest here
-            for (int ItemN = 1; ItemN < RecSetV.Len(); ItemN++) {
-                // get the vector
-                const TUInt64IntKdV& RecIdFqV = RecSetV[ItemN]->GetRecIdFqV();
-                // decide for the operation based on not status
-                if (!NotP && !NotV[ItemN]) {
-                    // life is easy, just do the intersect
-                    Index->GetSumMerger()->Intrs(ResRecIdFqV, RecIdFqV);
-                } else if (NotP && NotV[ItemN]) {
-                    // all negation, do the union
-                    Index->GetSumMerger()->Union(ResRecIdFqV, RecIdFqV);
-                } else if (NotP && !NotV[ItemN]) {
-                    // records from RecIdFqV should not be in the main
-                    TUInt64IntKdV _ResRecIdFqV;
-                    Index->GetSumMerger()->Minus(RecIdFqV, ResRecIdFqV, _ResRecIdFqV);
-                    ResRecIdFqV = _ResRecIdFqV;
-                    NotP = false;
-                } else if (!NotP && NotV[ItemN]) {
-                    // records from main should not be in the RecIdFqV
-                    TUInt64IntKdV _ResRecIdFqV;
-                    Index->GetSumMerger()->Minus(ResRecIdFqV, RecIdFqV, _ResRecIdFqV);
-                    ResRecIdFqV = _ResRecIdFqV;
-                    NotP = false;
-                }
+    }
+    NodeV.Add(&QueryItem); HeightV.Add(Height); SubNodeNVV.Add(SubNodeNV);
+    return NodeV.Len() - 1;
+}
+
+TPair<TBool, PRecSet> TBase::_SearchPar(const TQueryItem& QueryItem, const int& Threads) {
+    // flatten the query tree and group nodes by their height
+    TVec<const TQueryItem*> NodeV; TIntV HeightV; TVec<TIntV> SubNodeNVV;
+    const int RootNodeN = GetSearchNodes(QueryItem, NodeV, HeightV, SubNodeNVV);
+    TVec<TIntV> HeightNodeNVV(HeightV[RootNodeN] + 1);
+    for (int NodeN = 0; NodeN < NodeV.Len(); NodeN++) {
+        HeightNodeNVV[HeightV[NodeN]].Add(NodeN);
+    }
+    // execute nodes level by level, nodes on the same level do not depend on each other
+    TVec<TPair<TBool, PRecSet> > NotRecSetV(NodeV.Len());
+    for (int Height = 0; Height < HeightNodeNVV.Len(); Height++) {
+        const TIntV& NodeNV = HeightNodeNVV[Height];
+        // record sets can be shared with other parts of the query, copy them before
+        // going parallel, since their reference counts are not safe to change concurrently
+        for (int NodeNN = 0; NodeNN < NodeNV.Len(); NodeNN++) {
+            const int NodeN = NodeNV[NodeNN];
+            if (NodeV[NodeN]->IsRecSet()) {
+                NotRecSetV[NodeN] = TPair<TBool, PRecSet>(false, NodeV[NodeN]->GetRecSet()->Clone());
             }
-            // prepare resulting record set
-            PRecSet RecSet = TRecSet::New(RecSetV[0]->GetStore(), ResRecIdFqV, QueryItem.IsFq());
-            return TPair<TBool, PRecSet>(NotP, RecSet);
-        } else if (QueryItem.IsOr()) {
-            // prepare working vectors with the first records set
-            TUInt64IntKdV ResRecIdFqV = RecSetV[0]->GetRecIdFqV();
-            QmAssert(ResRecIdFqV.IsSorted());
-            // current negation status
-            bool NotP = NotV[0];
-            // than handle the rest here
-            for (int ItemN = 1; ItemN < RecSetV.Len(); ItemN++) {
-                // get the vector
-                const TUInt64IntKdV& RecIdFqV = RecSetV[ItemN]->GetRecIdFqV();
-                // decide for the operation based on not status
-                if (!NotP && !NotV[ItemN]) {
-                    Index->GetSumMerger()->Union(ResRecIdFqV, RecIdFqV);
-                } else if (NotP && NotV[ItemN]) {
-                    // all negation, do the intersect
-                    Index->GetSumMerger()->Intrs(ResRecIdFqV, RecIdFqV);
-                } else if (NotP && !NotV[ItemN]) {
-                    // records not from main or from RecIdFqV
-                    TUInt64IntKdV _ResRecIdFqV;
-                    Index->GetSumMerger()->Minus(ResRecIdFqV, RecIdFqV, _ResRecIdFqV);
-                    ResRecIdFqV = _ResRecIdFqV;
-                    NotP = true;
-                } else if (!NotP && NotV[ItemN]) {
-                    // records from main or not from RecIdFqV
-                    TUInt64IntKdV _ResRecIdFqV;
-                    Index->GetSumMerger()->Minus(RecIdFqV, ResRecIdFqV, _ResRecIdFqV);
-                    ResRecIdFqV = _ResRecIdFqV;
-                    NotP = true;
+        }
+        PExcept Except;
+        #pragma omp parallel for schedule(dynamic, 1) num_threads(Threads) if (NodeNV.Len() > 1)
+        for (int NodeNN = 0; NodeNN < NodeNV.Len(); NodeNN++) {
+            const int NodeN = NodeNV[NodeNN];
+            const TQueryItem& NodeItem = *NodeV[NodeN];
+            const TIntV& SubNodeNV = SubNodeNVV[NodeN];
+            try {
+                if (NodeItem.IsRecSet()) {
+                    // copied above
+                } else if (NodeItem.IsJoin() && !SubNodeNV.Empty()) {
+                    NotRecSetV[NodeN] = _SearchJoin(NodeItem, NotRecSetV[SubNodeNV[0]]);
+                } else if (!SubNodeNV.Empty()) {
+                    // merge results of subordinate items
+                    TBoolV NotV(SubNodeNV.Len(), 0); TRecSetV RecSetV(SubNodeNV.Len(), 0);
+                    for (int SubNodeNN = 0; SubNodeNN < SubNodeNV.Len(); SubNodeNN++) {
+                        NotV.Add(NotRecSetV[SubNodeNV[SubNodeNN]].Val1);
+                        RecSetV.Add(NotRecSetV[SubNodeNV[SubNodeNN]].Val2);
+                    }
+                    NotRecSetV[NodeN] = _SearchMerge(NodeItem, NotV, RecSetV);
+                } else {
+                    // indexes guard concurrent lookups internally
+                    NotRecSetV[NodeN] = _Search(NodeItem);
                 }
+            } catch (PExcept& _Except) {
+                #pragma omp critical(TQmSearchExcept)
+                if (Except.Empty()) { Except = _Except; }
+            }
+        }
+        // rethrow first exception
+        if (!Except.Empty()) { throw Except; }
+        // release results which are not needed anymore
+        for (int NodeNN = 0; NodeNN < NodeNV.Len(); NodeNN++) {
+            const TIntV& SubNodeNV = SubNodeNVV[NodeNV[NodeNN]];
+            for (int SubNodeNN = 0; SubNodeNN < SubNodeNV.Len(); SubNodeNN++) {
+                NotRecSetV[SubNodeNV[SubNodeNN]].Val2.Clr();
             }
-            // prepare resulting record set
-            PRecSet RecSet = TRecSet::New(RecSetV[0]->GetStore(), ResRecIdFqV, QueryItem.IsFq());
-            return TPair<TBool, PRecSet>(NotP, RecSet);
-        } else if (QueryItem.IsNot()) {
-            // just return records set but negate the current negation status
-            QmAssert(RecSetV.Len() == 1);
-            return TPair<TBool, PRecSet>(!NotV[0], RecSetV[0]);
         }
     }
-    // we should never have come to here
-    throw TQmExcept::New("Unsupported query item type");
+    return NotRecSetV[RootNodeN];
 }
 
 void TBase::LoadBaseConf(const TStr& FPath) {
@@ -7049,12 +8570,14 @@ void TBase::LoadBaseConf(const TStr& FPath) {
     }
 
     NmValidator.SetStrictNmP(BaseConfJson->GetObjBool("strictNames", true));
+    if (BaseConfJson->IsObjKey("wal")) { WalParamVal = BaseConfJson->GetObjKey("wal"); }
 }
 
 void TBase::SaveBaseConf(const TStr& FPath) const {
     PJsonVal BaseConfJson = TJsonVal::NewObj();
 
     BaseConfJson->AddToObj("strictNames", NmValidator.IsStrictNmP());
+    if (IsWal()) { BaseConfJson->AddToObj("wal", Wal->GetParamVal()); }
 
     const TStr BaseConfStr = TJsonVal::GetStrFromVal(BaseConfJson);
     TFOut BasePropsFOut(GetConfFNm(FPath));
@@ -7063,7 +8586,7 @@ void TBase::SaveBaseConf(const TStr& FPath) const {
 }
 
 TBase::TBase(const TStr& _FPath, const int64& IndexCacheSize, const TStrUInt64H& IndexTypeCacheSizeH,
-        const int& SplitLen, const bool& StrictNmP): InitP(false), NmValidator(StrictNmP) {
+        const int& SplitLen, const bool& StrictNmP): InitP(false), NmValidator(StrictNmP), DataLockDepth(0) {
 
     IAssertR(TEnv::IsInit(), "QMiner environment (TQm::TEnv) is not initialized");
     // open as create
@@ -7083,10 +8606,12 @@ TBase::TBase(const TStr& _FPath, const int64& IndexCacheSize, const TStrUInt64H&
     StoreV.Gen(TEnv::GetMxStores()); StoreV.PutAll(NULL);
     // initialize empty stream aggregate bases for each store
     StreamAggrSetV.Gen(TEnv::GetMxStores()); StreamAggrSetV.PutAll(NULL);
+    // closed write-ahead log, opened on request
+    Wal = TBaseWal::New(TBaseWal::GetFNm(FPath));
 }
 
 TBase::TBase(const TStr& _FPath, const TFAccess& _FAccess, const int64& IndexCacheSize,
-        const TStrUInt64H& IndexTypeCacheSizeH, const int& SplitLen): InitP(false), NmValidator(true) {
+        const TStrUInt64H& IndexTypeCacheSizeH, const int& SplitLen): InitP(false), NmValidator(true), DataLockDepth(0) {
 
     IAssertR(TEnv::IsInit(), "QMiner environment (TQm::TEnv) is not initialized");
     // assert open type and remember location
@@ -7098,6 +8623,13 @@ TBase::TBase(const TStr& _FPath, const TFAccess& _FAccess, const int64& IndexCac
         TEnv::Logger->OnStatus("Opening in update mode");
     } else if (FAccess == faRestore) {
         TEnv::Logger->OnStatus("Opening in restore mode");
+        // base was not closed, so its blob bases are not marked as closed; opening
+        // them in restore mode marks them, after which we continue as in update mode
+        TFFile FFile(FPath, ".mbb", false); TStr BlobBsFNm;
+        while (FFile.Next(BlobBsFNm)) {
+            TMBlobBs::New(BlobBsFNm.GetFPath() + BlobBsFNm.GetFMid(), faRestore);
+        }
+        FAccess = faUpdate;
     }
 
     // open file input streams
@@ -7120,10 +8652,16 @@ TBase::TBase(const TStr& _FPath, const TFAccess& _FAccess, const int64& IndexCac
 
     // load the base properties
     LoadBaseConf(_FPath);
+    // write-ahead log, replayed and opened in Init
+    if (FAccess != faRdOnly) { Wal = TBaseWal::New(TBaseWal::GetFNm(FPath)); }
 }
 
 TBase::~TBase() {
+    // no flushing while stores and index are being saved
+    StopFlusher();
     if (FAccess != faRdOnly) {
+        // stores are saved after this, so the log is no longer needed
+        Wal->SetDelOnClose();
         TEnv::Logger->OnStatus("Saving index vocabulary ... ");
 
         TFOut IndexVocFOut(FPath + "IndexVoc.dat");
@@ -7135,6 +8673,17 @@ TBase::~TBase() {
     }
 }
 
+TBase::TDataLock::TDataLock(const TWPt<TBase>& _Base): Base(_Base()) {
+    Base->DataLock.Enter();
+    // only the outermost lock waits for readers to leave
+    if (Base->DataLockDepth++ == 0) { Base->DataRWLock.EnterWrite(); }
+}
+
+TBase::TDataLock::~TDataLock() {
+    if (--Base->DataLockDepth == 0) { Base->DataRWLock.LeaveWrite(); }
+    Base->DataLock.Leave();
+}
+
 bool TBase::Exists(const TStr& FPath) {
     return TIndex::Exists(FPath) &&
         TFile::Exists(FPath + "IndexVoc.dat") &&
@@ -7142,6 +8691,21 @@ bool TBase::Exists(const TStr& FPath) {
 }
 
 void TBase::Init() {
+    const TStr WalFNm = TBaseWal::GetFNm(FPath);
+    if (FAccess == faCreate) {
+        // new base, log left from before has nothing to do with it
+        if (TFile::Exists(WalFNm)) { TFile::Del(WalFNm); }
+    } else if (FAccess == faRdOnly) {
+        if (TFile::Exists(WalFNm)) {
+            TEnv::Logger->OnStatus("Write-ahead log found, open base in update mode to replay it");
+        }
+    } else {
+        TDataLock Lock(this);
+        // replay updates logged since the last save, left behind by a crash
+        Wal->Replay(this, WalStreamAggrStateH);
+    }
+    // continue logging when enabled in base config
+    if (!Wal.Empty() && !WalParamVal.Empty()) { Wal->Open(WalParamVal); }
     InitP = true;
 }
 
@@ -7193,6 +8757,14 @@ void TBase::AddStreamAggr(const PStreamAggr& StreamAggr) {
     QmAssertR(!IsStreamAggr(StreamAggr->GetAggrNm()),
         "Aggregate with this name already exists: " + StreamAggr->GetAggrNm());
     StreamAggrH.AddDat(StreamAggr->GetAggrNm(), StreamAggr);
+    // restore state from write-ahead log replay
+    if (WalStreamAggrStateH.IsKey(StreamAggr->GetAggrNm())) {
+        TMemIn StateIn(WalStreamAggrStateH.GetDat(StreamAggr->GetAggrNm()));
+        StreamAggr->LoadState(StateIn);
+        WalStreamAggrStateH.DelKey(StreamAggr->GetAggrNm());
+    }
+    // memory growth is tracked from the footprint at registration
+    StreamAggr->GetAggrStats().AddMem(StreamAggr->GetMemUsed());
 }
 
 TWPt<TStreamAggr> TBase::GetStreamAggr(const TStr& StreamAggrNm) const {
@@ -7246,6 +8818,7 @@ int TBase::NewFieldIndexKey(const TWPt<TStore>& Store, const TStr& KeyNm, const
 
 uint64 TBase::AddRec(const TWPt<TStore>& Store, const PJsonVal& RecVal) {
     QmAssertR(RecVal->IsObj(), "Invalid input JSon, not an object");
+    TDataLock Lock(this);
     return Store->AddRec(RecVal);
 }
 
@@ -7257,9 +8830,16 @@ uint64 TBase::AddRec(const uint& StoreId, const PJsonVal& RecVal) {
     return AddRec(GetStoreByStoreId(StoreId), RecVal);
 }
 
+void TBase::AddRecBatch(const TWPt<TStore>& Store, TRecBatch& RecBatch, TUInt64V& RecIdV) {
+    QmAssertR(!IsRdOnly(), "Base opened as read-only");
+    TDataLock Lock(this);
+    Store->AddRecBatch(RecBatch, RecIdV);
+}
+
 PRecSet TBase::Search(const PQuery& Query) {
-    // do the search
-    TPair<TBool, PRecSet> NotRecSet = _Search(Query->GetQueryItem());
+    // do the search, in parallel when query can use more threads
+    TPair<TBool, PRecSet> NotRecSet = (Query->GetThreads() > 1) ?
+        _SearchPar(Query->GetQueryItem(), Query->GetThreads()) : _Search(Query->GetQueryItem());
     // take the resulting record set
     PRecSet RecSet = NotRecSet.Val2;
     Assert(!RecSet.Empty());
@@ -7288,6 +8868,7 @@ PRecSet TBase::Search(const PJsonVal& QueryVal) {
 }
 
 void TBase::GarbageCollect(const int& MxTimeMSecs) {
+    TDataLock Lock(this);
     int StoreKeyId = StoreH.FFirstKeyId();
     while (StoreH.FNextKeyId(StoreKeyId)) {
         StoreH[StoreKeyId]->GarbageCollect(MxTimeMSecs);
@@ -7295,17 +8876,21 @@ void TBase::GarbageCollect(const int& MxTimeMSecs) {
 }
 
 int TBase::PartialFlush(const int& WndInMsec) {
-    int DirtyStores = (GetStores() + 1);
+    // log is replayed over the last save, partially flushed data would be updated twice
+    if (IsWal()) { Checkpoint(); return 0; }
     int Saved = 100;
     int TotalSaved = 0;
     TTmStopWatch Sw(true);
 
     TVec<TPair<TWPt<TStore>, bool>> DirtyStoreV;
     bool FlushIndex = true;
-
-    for (int i = 0; i < GetStores(); i++) {
-        DirtyStoreV.Add(TPair<TWPt<TStore>, bool>(GetStoreByStoreN(i), true));
+    {
+        TDataLock Lock(this);
+        for (int i = 0; i < GetStores(); i++) {
+            DirtyStoreV.Add(TPair<TWPt<TStore>, bool>(GetStoreByStoreN(i), true));
+        }
     }
+    int DirtyStores = (DirtyStoreV.Len() + 1);
 
     while (Saved > 0) {
         if (Sw.GetMSecInt() > WndInMsec) {
@@ -7318,7 +8903,11 @@ int TBase::PartialFlush(const int& WndInMsec) {
         for (int i = 0; i < DirtyStoreV.Len(); i++) {
             if (!DirtyStoreV[i].Val2)
                 continue; // this store had no dirty data in previous loop
-            xsaved = DirtyStoreV[i].Val1->PartialFlush(TimeSliceMs);
+            {
+                // writers only wait for one slice
+                TDataLock Lock(this);
+                xsaved = DirtyStoreV[i].Val1->PartialFlush(TimeSliceMs);
+            }
             if (xsaved == 0) {
                 DirtyStoreV[i].Val2 = false; // ok, this store is clean now
             } else {
@@ -7328,7 +8917,10 @@ int TBase::PartialFlush(const int& WndInMsec) {
             TQm::TEnv::Debug->OnStatusFmt("Partial flush:     store %s = %d", DirtyStoreV[i].Val1->GetStoreNm().CStr(), xsaved);
         }
         if (FlushIndex) { // save index
-            xsaved = Index->PartialFlush(TimeSliceMs);
+            {
+                TDataLock Lock(this);
+                xsaved = Index->PartialFlush(TimeSliceMs);
+            }
             FlushIndex = (xsaved > 0);
             if (FlushIndex) {
                 DirtyStores++;
@@ -7345,6 +8937,83 @@ int TBase::PartialFlush(const int& WndInMsec) {
     return TotalSaved;
 }
 
+void TBase::Checkpoint() {
+    QmAssertR(!IsRdOnly(), "Base opened as read-only");
+    TDataLock Lock(this);
+    TEnv::Logger->OnStatus("Checkpoint ...");
+    for (int StoreN = 0; StoreN < GetStores(); StoreN++) {
+        GetStoreByStoreN(StoreN)->Flush();
+    }
+    Index->Flush();
+    TFOut IndexVocFOut(FPath + "IndexVoc.dat");
+    IndexVoc->Save(IndexVocFOut);
+    StoreBlobBs->Flush();
+    SaveBaseConf(FPath);
+    // logged stream aggregate states are not part of the save, keep the latest ones
+    TStrV StreamAggrNmV; Wal->GetStreamAggrNmV(StreamAggrNmV);
+    THash<TStr, TMem> StreamAggrStateH;
+    for (int StreamAggrNmN = 0; StreamAggrNmN < StreamAggrNmV.Len(); StreamAggrNmN++) {
+        const TStr& StreamAggrNm = StreamAggrNmV[StreamAggrNmN];
+        if (IsStreamAggr(StreamAggrNm)) {
+            TMOut StateOut; GetStreamAggr(StreamAggrNm)->SaveState(StateOut);
+            StreamAggrStateH.AddDat(StreamAggrNm, TMem(StateOut.GetBfAddr(), StateOut.Len()));
+        } else if (WalStreamAggrStateH.IsKey(StreamAggrNm)) {
+            StreamAggrStateH.AddDat(StreamAggrNm, WalStreamAggrStateH.GetDat(StreamAggrNm));
+        }
+    }
+    Wal->Checkpoint(StreamAggrStateH);
+    TEnv::Logger->OnStatus("Checkpoint done");
+}
+
+bool TBase::IsConcurrentRead() const {
+    int StoreKeyId = StoreH.FFirstKeyId();
+    while (StoreH.FNextKeyId(StoreKeyId)) {
+        if (!StoreH[StoreKeyId]->IsConcurrentRead()) { return false; }
+    }
+    return true;
+}
+
+void TBase::StartFlusher(const int& IntervalMSecs, const int& BudgetMSecs) {
+    QmAssertR(!IsRdOnly(), "Base opened as read-only");
+    QmAssertR(IntervalMSecs > 0 && BudgetMSecs > 0, "Flusher interval and budget must be positive");
+    StopFlusher();
+    Flusher = TBaseFlusher::New(this, IntervalMSecs, BudgetMSecs);
+    Flusher->Start();
+}
+
+void TBase::StopFlusher() {
+    if (Flusher.Empty()) { return; }
+    Flusher->Stop();
+    Flusher.Clr();
+}
+
+void TBase::OpenWal(const PJsonVal& ParamVal) {
+    QmAssertR(!IsRdOnly(), "Base opened as read-only");
+    TDataLock Lock(this);
+    Wal->Open(ParamVal);
+    // remember the setting right away, it is needed after a crash
+    SaveBaseConf(FPath);
+}
+
+void TBase::CloseWal() {
+    if (!IsWal()) { return; }
+    TDataLock Lock(this);
+    Wal->Close();
+    SaveBaseConf(FPath);
+}
+
+void TBase::CommitWal() {
+    if (!IsWal()) { return; }
+    TDataLock Lock(this);
+    Wal->Commit();
+}
+
+void TBase::WalStreamAggr(const TStr& StreamAggrNm) {
+    QmAssertR(IsWal(), "Write-ahead log is not open");
+    TDataLock Lock(this);
+    Wal->AddStreamAggr(GetStreamAggr(StreamAggrNm));
+}
+
 bool TBase::SaveJSonDump(const TStr& DumpDir) {
     TStrSet SeenJoinsH;
 
@@ -7589,6 +9258,9 @@ PJsonVal TBase::GetStats() {
     Res->AddToObj("gix_stats", GixStatsToJson(gix_stats));
     Res->AddToObj("gix_blob", BlobBsStatsToJson(gix_blob_stats));
     Res->AddToObj("access", GetFAccess());
+    Res->AddToObj("stream_aggrs", GetStreamAggrStats());
+    if (IsFlusher()) { Res->AddToObj("flusher", Flusher->GetJson()); }
+    if (IsWal()) { Res->AddToObj("wal", Wal->GetJson()); }
     return Res;
 }
 
@@ -7610,8 +9282,11 @@ PJsonVal TBase::GetStreamAggrStats() const {
         const double ExeMSecs = StreamAggr.Dat->GetExeTm().GetMSec();
         // get the memory footprint
         const uint64 MemUsed = StreamAggr.Dat->GetMemUsed();
+        // get calls, latencies and memory growth
+        TStreamAggrStats& AggrStats = StreamAggr.Dat->GetAggrStats();
+        AggrStats.AddMem(MemUsed);
         // store to result output
-        PJsonVal AggrVal = TJsonVal::NewObj();
+        PJsonVal AggrVal = AggrStats.GetJson();
         AggrVal->AddToObj("name", AggrNm);
         AggrVal->AddToObj("type", AggrType);
         AggrVal->AddToObj("msecs", ExeMSecs);
@@ -7686,6 +9361,9 @@ PJsonVal GixStatsToJson(const TGixStats& stats) {
     res->AddToObj("cache_dirty", stats.CacheDirty);
     res->AddToObj("cache_dirty_loaded_perc", stats.CacheDirtyLoadedPerc);
     res->AddToObj("mem_sed", (uint64)stats.MemUsed);
+    res->AddToObj("cache_hits", (uint64)stats.CacheHits);
+    res->AddToObj("cache_misses", (uint64)stats.CacheMisses);
+    res->AddToObj("cache_evictions", (uint64)stats.CacheEvictions);
     return res;
 }
 
@@ -11,6 +11,7 @@
 
 #include <base.h>
 #include <mine.h>
+#include <thread.h>
 
 namespace TQm {
 
@@ -19,6 +20,7 @@ namespace TQm {
 class TBase; typedef TPt<TBase> PBase;
 class TStore; typedef TPt<TStore> PStore;
 class TRec;
+class TRecBatch;
 class TRecSet; typedef TPt<TRecSet> PRecSet;
 class TIndexVoc; typedef TPt<TIndexVoc> PIndexVoc;
 class TIndex; typedef TPt<TIndex> PIndex;
@@ -291,6 +293,9 @@ public:
     TBool InsertP;
     /// Name of the field that serves as time-window indicator
     TStr TimeFieldNm;
+    /// Length of time partitions in milliseconds, zero when store is not partitioned.
+    /// Not part of the saved description, stores keep it with their partitions.
+    TUInt64 PartitionSize;
 
 public:
     TStoreWndDesc() : WindowType(swtNone) { }
@@ -300,6 +305,68 @@ public:
     void Load(TSIn& SIn);
 };
 
+///////////////////////////////
+/// Store time partitions.
+/// Splits records of a time-windowed store into partitions of fixed length
+/// based on the time field. Records are added in time order, so each partition
+/// covers a continuous range of record ids, starting with the id of its first
+/// record. Expired partitions are found without reading their records and
+/// time-range queries only need to look at the overlapping partitions.
+/// Partitions share the store's data blobs and indexes, so dropping a partition
+/// still deletes its records, but their inverted index entries are removed in
+/// one batch, with one item set update per key.
+class TStorePartitions {
+private:
+    /// Length of a partition in milliseconds, zero when not partitioned
+    TUInt64 PartitionMSecs;
+    /// Start of each partition, aligned to partition length
+    TUInt64V StartMSecsV;
+    /// Id of the first record in each partition
+    TUInt64V FirstRecIdV;
+    /// Earliest record time in each partition
+    TUInt64V MnMSecsV;
+    /// Latest record time in each partition
+    TUInt64V MxMSecsV;
+
+public:
+    TStorePartitions() { }
+    TStorePartitions(const uint64& _PartitionMSecs): PartitionMSecs(_PartitionMSecs) { }
+    TStorePartitions(TSIn& SIn) { Load(SIn); }
+
+    void Save(TSOut& SOut) const;
+    void Load(TSIn& SIn);
+
+    /// Is the store partitioned
+    bool IsPartitioned() const { return PartitionMSecs > 0; }
+    /// Length of a partition in milliseconds
+    uint64 GetPartitionMSecs() const { return PartitionMSecs; }
+    /// Number of partitions
+    int GetPartitions() const { return FirstRecIdV.Len(); }
+    /// Id of the first record in the partition
+    uint64 GetFirstRecId(const int& PartN) const { return FirstRecIdV[PartN]; }
+
+    /// Register new record. Records older than the last partition go into
+    /// the last partition, so partitions always follow record ids.
+    void AddRec(const uint64& RecId, const uint64& TmMSecs);
+    /// Forget records before given id, after they were deleted from the store
+    void DelRecs(const uint64& FirstRecId);
+    /// Forget all partitions
+    void Clr();
+
+    /// Id of the first record which is not in a leading partition that ended
+    /// before the window start. Returns EndRecId when all partitions expired
+    /// and zero when there are no partitions.
+    uint64 GetExpiredEndRecId(const uint64& WindowStartMSecs, const uint64& EndRecId) const;
+    /// Range of record ids [MnRecId, MxRecId) covering partitions which overlap
+    /// with time interval [MnMSecs, MxMSecs]. MxRecId is TUInt64::Mx when the
+    /// range reaches the last partition. Returns false when there is no overlap.
+    bool GetRecIdRange(const uint64& MnMSecs, const uint64& MxMSecs,
+        uint64& MnRecId, uint64& MxRecId) const;
+
+    /// Partitions as JSON array
+    PJsonVal GetJson() const;
+};
+
 ///////////////////////////////
 /// Join Description
 class TJoinDesc {
@@ -590,6 +657,8 @@ public:
     virtual void Init(const TWPt<TStore>& Store) { }
     /// Called after record added to the store
     virtual void OnAdd(const TRec& Rec) = 0;
+    /// Called after a batch of records added to the store. Default calls OnAdd for each record.
+    virtual void OnAddBatch(const PRecSet& RecSet);
     /// Called after record updated in the store
     virtual void OnUpdate(const TRec& Rec) = 0;
     /// Called before record from the store
@@ -641,6 +710,8 @@ private:
 protected:
     /// Time window settings
     TStoreWndDesc WndDesc;
+    /// Time partitions, used when WndDesc.PartitionSize is set
+    TStorePartitions Partitions;
 
     /// Create new store with given ID and name
     TStore(const TWPt<TBase>& _Base, uint _StoreId, const TStr& _StoreNm);
@@ -674,6 +745,9 @@ public:
     void OnAdd(const uint64& RecId);
     /// Should be called after record Rec added; executes OnAdd event in all registered triggers
     void OnAdd(const TRec& Rec);
+    /// Should be called after a batch of records added; executes OnAddBatch event in all
+    /// registered triggers, one trigger after another
+    void OnAdd(const TUInt64V& RecIdV);
     /// Should be called after record RecId updated; executes OnUpdate event in all registered triggers
     void OnUpdate(const uint64& RecId);
     /// Should be called after record Rec updated; executes OnUpdate event in all registered triggers
@@ -693,6 +767,19 @@ protected:
 
     /// Processing nested join records in JSon
     void AddJoinRec(const uint64& RecId, const PJsonVal& RecVal);
+    /// Set field joins not given in the record batch to point to nothing
+    void AddJoinRec(const uint64& RecId, const TRecBatch& RecBatch);
+
+    /// Register new record with time partitions (when store is partitioned)
+    void AddPartitionRec(const uint64& RecId);
+    /// Get ids of records in partitions which ended before the window start
+    void GetExpiredPartitionRecIdV(const uint64& WindowStartMSecs, TUInt64V& DelRecIdV) const;
+    /// Sync partitions after records were deleted from the store
+    void DelPartitionRecs();
+    /// Save time partitions to a file (when store is partitioned)
+    void SavePartitions(const TStr& FNm) const;
+    /// Load time partitions from a file (when it exists)
+    void LoadPartitions(const TStr& FNm);
 
 public:
     /// Get store ID
@@ -702,6 +789,13 @@ public:
 
     // get time window settings
     const TStoreWndDesc& GetWndDesc() { return WndDesc; }
+    /// Is the store split into time partitions
+    bool IsPartitioned() const { return Partitions.IsPartitioned(); }
+    /// Get time partitions
+    const TStorePartitions& GetPartitions() const { return Partitions; }
+    /// Get records with the time-window field within [MnMSecs, MxMSecs], only
+    /// reading records from partitions which overlap with the interval
+    PRecSet GetPartitionRecSet(const uint64& MnMSecs, const uint64& MxMSecs);
 
 
     /// Load store ID from the stream and retrieve store
@@ -758,6 +852,8 @@ public:
 
     /// True when records have names (default is false)
     virtual bool HasRecNm() const { return false; }
+    /// True when record fields can be read from several threads at the same time (default is false)
+    virtual bool IsConcurrentRead() const { return false; }
     /// Check if record with given ID exists
     virtual bool IsRecId(const uint64& RecId) const = 0;
     /// check if record with given name exists
@@ -806,6 +902,10 @@ public:
     virtual uint64 AddRec(const PJsonVal& RecVal, const bool& TriggerEvents = true) = 0;
     /// Update existing record with updates in provided JSon
     virtual void UpdateRec(const uint64& RecId, const PJsonVal& RecVal) = 0;
+    /// Add batch of new records. Default implementation goes through AddRec
+    /// with JSon serialization of each record. Stores can override this with
+    /// direct serialization. Add triggers are called after all records are added.
+    virtual void AddRecBatch(TRecBatch& RecBatch, TUInt64V& RecIdV, const bool& TriggerEvents = true);
 
     /// Add join
     void AddJoin(const int& JoinId, const uint64& RecId, const uint64 JoinRecId, const int& JoinFq = 1);
@@ -879,6 +979,17 @@ public:
     /// Get field value using field id safely
     int64 GetFieldInt64Safe(const uint64& RecId, const int& FieldId) const;
 
+    /// Get values of integer or boolean field for a block of records. Null values are
+    /// set to zero and flagged in NullV. Both output vectors are resized to RecIdV.Len().
+    virtual void GetFieldInt64Block(const TUInt64V& RecIdV, const int& FieldId,
+        TVec<TInt64>& ValV, TBoolV& NullV) const;
+    /// Get values of uint64 or time field (in milliseconds) for a block of records
+    virtual void GetFieldUInt64Block(const TUInt64V& RecIdV, const int& FieldId,
+        TUInt64V& ValV, TBoolV& NullV) const;
+    /// Get values of numeric field for a block of records
+    virtual void GetFieldFltBlock(const TUInt64V& RecIdV, const int& FieldId,
+        TFltV& ValV, TBoolV& NullV) const;
+
     /// Check if the value of given field for a given record is NULL
     bool IsFieldNmNull(const uint64& RecId, const TStr& FieldNm) const;
     /// Get field value using field name
@@ -1058,6 +1169,8 @@ public:
 
     /// Save part of the data, given time-window
     virtual int PartialFlush(int WndInMsec = 500) { throw TQmExcept::New("Not implemented"); }
+    /// Save all the data, so the store can be opened from disk in its current state
+    virtual void Flush() { throw TQmExcept::New("Not implemented"); }
     /// Retrieve performance statistics for this store
     virtual PJsonVal GetStats() { return TJsonVal::NewObj(); }
     /// Run verification for whole store
@@ -1091,6 +1204,9 @@ private:
 private:
     /// Get QMiner exception for requesting wrong field-type combinations
     PExcept FieldError(const int& FieldId, const TStr& TypeStr) const;
+    /// Log field value set on a record by reference to the write-ahead log,
+    /// unless the set is part of a logged store operation
+    void LogSetField(const int& FieldId) const;
 
 public:
     /// Create empty record (no reference, no value)
@@ -1286,6 +1402,101 @@ public:
         const bool& JoinRecFieldsP = false, const bool& RecInfoP = true) const;
 };
 
+///////////////////////////////
+/// Record Batch.
+/// Holds field values for a batch of new records in columnar form, one typed vector
+/// per field. Used for bulk inserts which bypass building a JSon object per record.
+/// Supports fixed-width fields (integers, bool, numeric, time) and strings. Fields
+/// without a column are treated the same as fields missing in JSon (default value
+/// or null). Joins and nested records are not supported.
+class TRecBatch {
+private:
+    /// Values of one field for all the records in the batch
+    class TFieldCol {
+    public:
+        /// Field ID
+        TInt FieldId;
+        /// Values for integer and boolean fields
+        TVec<TInt64> IntV;
+        /// Values for uint64 and time fields (time in milliseconds)
+        TUInt64V UInt64V;
+        /// Values for numeric fields
+        TFltV FltV;
+        /// Values for string fields
+        TStrV StrV;
+        /// Null flags (empty when no value is null)
+        TBoolV NullV;
+
+    public:
+        TFieldCol() { }
+        TFieldCol(const int& _FieldId): FieldId(_FieldId) { }
+        TFieldCol(TSIn& SIn): FieldId(SIn), IntV(SIn), UInt64V(SIn), FltV(SIn), StrV(SIn), NullV(SIn) { }
+        void Save(TSOut& SOut) const { FieldId.Save(SOut); IntV.Save(SOut);
+            UInt64V.Save(SOut); FltV.Save(SOut); StrV.Save(SOut); NullV.Save(SOut); }
+    };
+
+private:
+    /// Store into which the records are added
+    TWPt<TStore> Store;
+    /// Number of records in the batch
+    TInt Recs;
+    /// Field columns
+    TVec<TFieldCol> ColV;
+    /// Map from field ID to column position in ColV (-1 when field has no column)
+    TIntV FieldIdColNV;
+
+    /// Register new column for a given field, checks field type and column length
+    TFieldCol& AddCol(const int& FieldId, const bool& TypeOkP, const int& Vals, const TStr& TypeStr);
+    /// Get column for a given field
+    const TFieldCol& GetCol(const int& FieldId) const;
+
+public:
+    /// Create empty batch of given size for a given store
+    TRecBatch(const TWPt<TStore>& _Store, const int& _Recs);
+    /// Load batch for a given store
+    TRecBatch(const TWPt<TStore>& _Store, TSIn& SIn);
+    /// Save batch, without the store
+    void Save(TSOut& SOut) const;
+
+    /// Get batch's store
+    const TWPt<TStore>& GetStore() const { return Store; }
+    /// Number of records in the batch
+    int GetRecs() const { return Recs; }
+    /// Check if batch has values for a given field
+    bool IsField(const int& FieldId) const { return FieldIdColNV[FieldId] != -1; }
+
+    /// Add column for byte, int, int16, int64, uint, uint16 or bool field
+    void AddFieldInt(const int& FieldId, const TVec<TInt64>& IntV);
+    /// Add column for uint64 field
+    void AddFieldUInt64(const int& FieldId, const TUInt64V& UInt64V);
+    /// Add column for float or sfloat field
+    void AddFieldFlt(const int& FieldId, const TFltV& FltV);
+    /// Add column for time field, time given in milliseconds (see TTm::GetMSecsFromTm)
+    void AddFieldTmMSecs(const int& FieldId, const TUInt64V& TmMSecsV);
+    /// Add column for string field
+    void AddFieldStr(const int& FieldId, const TStrV& StrV);
+    /// Mark value of the field as null for a given record
+    void SetFieldNull(const int& FieldId, const int& RecN);
+
+    /// Check if the value of field is null
+    bool IsFieldNull(const int& FieldId, const int& RecN) const;
+    /// Get value of integer or boolean field
+    int64 GetFieldInt(const int& FieldId, const int& RecN) const { return GetCol(FieldId).IntV[RecN]; }
+    /// Get value of uint64 field
+    uint64 GetFieldUInt64(const int& FieldId, const int& RecN) const { return GetCol(FieldId).UInt64V[RecN]; }
+    /// Get value of numeric field
+    double GetFieldFlt(const int& FieldId, const int& RecN) const { return GetCol(FieldId).FltV[RecN]; }
+    /// Get value of time field in milliseconds
+    uint64 GetFieldTmMSecs(const int& FieldId, const int& RecN) const { return GetCol(FieldId).UInt64V[RecN]; }
+    /// Get value of string field
+    const TStr& GetFieldStr(const int& FieldId, const int& RecN) const { return GetCol(FieldId).StrV[RecN]; }
+
+    /// Get value of the field as JSon
+    PJsonVal GetFieldJson(const int& FieldId, const int& RecN) const;
+    /// Get record as JSon object, used by stores without native batch support
+    PJsonVal GetRecJson(const int& RecN) const;
+};
+
 ///////////////////////////////
 /// Record Comparator by Frequency. If same, sort by ID
 class TRecCmpByFq {
@@ -2031,6 +2242,29 @@ private:
     /// Removes records from this result set that are not part of the provided
     void LimitToSampleRecIdV(const TUInt64IntKdV& SampleRecIdFqV);
 
+    /// Number of records for which field values are fetched at once by block filters
+    static const int FilterBlockLen;
+    /// Keep records with non-null values of a fixed-width field within [MinVal, MaxVal].
+    /// Values are fetched from the store in blocks using GetFieldBlock, and the range
+    /// check runs over the contiguous buffer of values.
+    template <class TVal, class TValV>
+    void FilterByFieldBlock(const int& FieldId, const TVal& MinVal, const TVal& MaxVal,
+        void (TStore::*GetFieldBlock)(const TUInt64V&, const int&, TValV&, TBoolV&) const);
+
+    /// Minimal number of records for which a full sort is split across threads
+    static const int ParallelSortMnRecs;
+    /// Sort (key, record) pairs and keep the first `Limit' records in the result set.
+    /// Ties on the key are broken by record id, so the order is the same regardless
+    /// of the number of threads or the limit.
+    template <class TKey>
+    void SortByFieldKey(TVec<TPair<TKey, TUInt64IntKd> >& KeyRecV, const bool& Asc, const int& Limit);
+    /// Keep `Limit' smallest items according to `Cmp' using a bounded heap, sorted
+    template <class TItem, class TCmp>
+    static void SortTopK(TVec<TItem>& ItemV, const int& Limit, const TCmp& Cmp);
+    /// Sort items in chunks over several threads and merge the sorted chunks
+    template <class TItem>
+    static void SortParallel(TVec<TItem>& ItemV, const bool& Asc);
+
     TRecSet() { }
     TRecSet(const TWPt<TStore>& Store, const uint64& RecId, const int& Fq);
     TRecSet(const TWPt<TStore>& Store, const TUInt64V& RecIdV);
@@ -2115,7 +2349,9 @@ public:
     void SortByFq(const bool& Asc = true);
     /// Sort records according to filed with id `SortFieldId'
     /// @param Asc True for sorting in increasing order
-    void SortByField(const bool& Asc, const int& SortFieldId);
+    /// @param Limit When non-negative, only the first `Limit' records are kept,
+    ///   which is computed with a bounded heap instead of a full sort
+    void SortByField(const bool& Asc, const int& SortFieldId, const int& Limit = -1);
     /// Sort records according to given comparator
     template <class TCmp> void SortCmp(const TCmp& Cmp) { RecIdFqV.SortCmp(Cmp); }
 
@@ -2269,6 +2505,10 @@ private:
     TStr JoinNm;
     /// Tokenizer, when key requires one (e.g. text)
     PTokenizer Tokenizer;
+    /// Store inverted index child vectors compressed
+    TBool CompressP;
+    /// Keep linear or location index nodes on disk
+    TBool PagedP;
 
 public:
     /// Empty constructor creates undefined key
@@ -2378,6 +2618,16 @@ public:
     const PTokenizer& GetTokenizer() const { return Tokenizer; }
     /// Set the tokenizer
     void PutTokenizer(const PTokenizer& _Tokenizer) { Tokenizer = _Tokenizer; }
+
+    /// Does the key store inverted index child vectors compressed
+    bool IsCompress() const { return CompressP; }
+    /// Set compression of inverted index child vectors
+    void PutCompress(const bool& _CompressP) { CompressP = _CompressP; }
+
+    /// Does the key keep linear or location index nodes on disk
+    bool IsPaged() const { return PagedP; }
+    /// Set keeping linear or location index nodes on disk
+    void PutPaged(const bool& _PagedP) { PagedP = _PagedP; }
 };
 
 ///////////////////////////////
@@ -2557,6 +2807,10 @@ public:
     const PTokenizer& GetTokenizer(const int& KeyId) const;
     /// Set tokenizer for a key
     void PutTokenizer(const int& KeyId, const PTokenizer& Tokenizer);
+    /// Set compression of inverted index child vectors for a key
+    void PutCompress(const int& KeyId, const bool& CompressP);
+    /// Set keeping linear index nodes on disk for a key
+    void PutPaged(const int& KeyId, const bool& PagedP);
 
     /// Save human-readable statistics to a file
     void SaveTxt(const TWPt<TBase>& Base, const TStr& FNm) const;
@@ -2891,6 +3145,8 @@ private:
     TInt Limit;
     /// Return only records after (and including the) Offset-th record
     TInt Offset;
+    /// Number of threads the query can use to evaluate independent subtrees
+    TInt Threads;
 
     /// Internal method that traverses through the query tree and removes unneeded nodes
     void Optimize();
@@ -2923,6 +3179,10 @@ public:
     bool IsLimit() const { return (Limit != -1) || (Offset != 0); }
     /// Do the range limit, when specified
     PRecSet GetLimit(const PRecSet& RecSet);
+    /// Number of threads the query can use (1 for sequential execution)
+    int GetThreads() const { return Threads; }
+    /// Set number of threads the query can use
+    void PutThreads(const int& _Threads) { Threads = TInt::GetMx(_Threads, 1); }
 
     /// Check if query is valid
     bool IsOk(const TWPt<TBase>& Base, TStr& MsgStr) const;
@@ -2950,6 +3210,8 @@ private:
     THash<TIntPr, TUInt64V> LocRecIdH;
     /// Location index
     TSphereNn<TInt, double> SphereNn;
+    /// Lookups share it, changes take it exclusively
+    mutable TRWLock IndexLock;
 
     TIntPr GetLocId(const TFltPr& Loc) const;
     void LocKeyIdToRecId(const TIntV& LocKeyIdV, const int& Limit, TUInt64V& AllRecIdV) const;
@@ -2967,7 +3229,7 @@ public:
     /// Load existing index from stream
     static PGeoIndex Load(TSIn& SIn) { return new TGeoIndex(SIn); }
     /// Save index to stream
-    void Save(TSOut& SOut) { Precision.Save(SOut); LocRecIdH.Save(SOut); SphereNn.Save(SOut); }
+    void Save(TSOut& SOut) { TReadLock Lock(IndexLock); Precision.Save(SOut); LocRecIdH.Save(SOut); SphereNn.Save(SOut); }
 
     /// Add new record
     void AddKey(const TFltPr& Loc, const uint64& RecId);
@@ -2983,6 +3245,94 @@ public:
     bool LocEquals(const TFltPr& Loc1, const TFltPr& Loc2) const;
 };
 
+///////////////////////////////
+// Geohash Index
+/// Disk-backed location index. Locations are mapped to cells of a Z-order (geohash)
+/// grid and (cell, record) pairs are kept in a paged B-tree together with exact
+/// locations. Queries scan only cells around the query location, widening the search
+/// until enough records are found, so memory use is bounded by the node cache.
+class TGeoHashIndex; typedef TPt<TGeoHashIndex> PGeoHashIndex;
+class TGeoHashIndex {
+private:
+    // smart-pointer
+    TCRef CRef;
+    friend class TPt<TGeoHashIndex>;
+
+    /// Records are stored as (cell, record id) pairs
+    typedef TPair<TUInt64, TUInt64> TTreeKey;
+    /// Store for internal nodes
+    typedef TBtree::TBtreeNodeDiskStore<TTreeKey, TInt, TInt> TInternalStore;
+    /// Store for leaf nodes, each entry also keeps exact location
+    typedef TBtree::TBtreeNodeDiskStore<TTreeKey, TFltPr, TInt> TLeafStore;
+    /// BTree over cells
+    typedef TBtree::TBtreeOps<TTreeKey, TFltPr, TCmp<TTreeKey>, TInt, TInternalStore, TLeafStore> TBtreeOps;
+
+    /// Number of bits per coordinate of the finest cells (~0.3m latitude)
+    static const int CellBits;
+    /// Radius of the first query when widening the search (in meters)
+    static const double InitRadius;
+    /// Earth radius (in meters)
+    static const double EarthRadius;
+
+    /// Blob base with nodes
+    PBlobBs BlobBs;
+    /// Internal store instance
+    TPt<TInternalStore> InternalStore;
+    /// Leaf store instance
+    TPt<TLeafStore> LeafStore;
+    /// BTree instance
+    TBtreeOps BTree;
+    /// Taken exclusively by lookups too, since they load nodes into the cache
+    mutable TRWLock IndexLock;
+
+    /// Cell row of latitude
+    static uint64 GetLatN(const double& Lat, const int& Bits);
+    /// Cell column of longitude
+    static uint64 GetLonN(const double& Lon, const int& Bits);
+    /// Interleave row and column bits into Z-order cell id
+    static uint64 GetCell(const uint64& LatN, const uint64& LonN, const int& Bits);
+    /// Finest cell of location
+    static uint64 GetLocCell(const TFltPr& Loc);
+    /// Great-circle distance (in meters)
+    static double GetDist(const TFltPr& Loc1, const TFltPr& Loc2);
+    /// Ranges of finest cells covering a circle around location
+    static void GetCellRangeV(const TFltPr& Loc, const double& Radius, TVec<TUInt64Pr>& CellRangeV);
+    /// Collect records within radius, together with their distance
+    void GetDistRecIdV(const TFltPr& Loc, const double& Radius, TFltUInt64PrV& DistRecIdV) const;
+    /// Get at most Limit nearest records within radius
+    void Search(const TFltPr& Loc, const double& Radius, const int& Limit, TUInt64V& RecIdV) const;
+
+public:
+    /// Create new empty index with nodes kept in a blob base, caching about CacheSize bytes of them
+    TGeoHashIndex(const TStr& BlobFNm, const uint64& CacheSize);
+    /// Create new empty index with nodes kept in a blob base, caching about CacheSize bytes of them
+    static PGeoHashIndex New(const TStr& BlobFNm, const uint64& CacheSize) { return new TGeoHashIndex(BlobFNm, CacheSize); }
+    /// Load existing index from stream. Needs to be opened before use.
+    TGeoHashIndex(TSIn& SIn): InternalStore(SIn), LeafStore(SIn), BTree(SIn, InternalStore, LeafStore) { }
+    /// Load existing index from stream. Needs to be opened before use.
+    static PGeoHashIndex Load(TSIn& SIn) { return new TGeoHashIndex(SIn); }
+    /// Save index to stream, writes modified nodes to the blob base
+    void Save(TSOut& SOut) { TWriteLock Lock(IndexLock); InternalStore.Save(SOut); LeafStore.Save(SOut);
+        BTree.Save(SOut); if (!BlobBs.Empty()) { BlobBs->Flush(); } }
+    /// Open blob base with nodes of a loaded index
+    void Open(const TStr& BlobFNm, const TFAccess& Access);
+
+    /// Add new record
+    void AddKey(const TFltPr& Loc, const uint64& RecId);
+    /// Delete record
+    void DelKey(const TFltPr& Loc, const uint64& RecId);
+    /// Range query (in meters), returns at most Limit nearest records
+    void SearchRange(const TFltPr& Loc, const double& Radius,
+        const int& Limit, TUInt64V& RecIdV) const;
+    /// Nearest neighbour query
+    void SearchNn(const TFltPr& Loc, const int& Limit, TUInt64V& RecIdV) const;
+
+    /// Tells if two locations identical (index keeps exact locations)
+    bool LocEquals(const TFltPr& Loc1, const TFltPr& Loc2) const { return Loc1 == Loc2; }
+    /// Number of nodes currently held in memory
+    int GetCachedNodes() const { return InternalStore->GetCachedNodes() + LeafStore->GetCachedNodes(); }
+};
+
 ///////////////////////////////
 // B-Tree Index
 template <class TVal>
@@ -2996,18 +3346,23 @@ private:
     /// That ensures that values are sorted primarly by value, and for same value by record id
     typedef TPair<TVal, TUInt64> TTreeVal;
     /// Define store for internal nodes
-    typedef TBtree::TBtreeNodeMemStore<TTreeVal, TInt, TInt> TInternalStore;
+    typedef TBtree::TBtreeNodeDiskStore<TTreeVal, TInt, TInt> TInternalStore;
     /// Define store for external nodes
-    typedef TBtree::TBtreeNodeMemStore<TTreeVal, TVoid, TInt> TLeafStore;
+    typedef TBtree::TBtreeNodeDiskStore<TTreeVal, TVoid, TInt> TLeafStore;
     /// Define btree with given stores and value type. Each leaf node has a vector of record ids
     typedef TBtree::TBtreeOps<TTreeVal, TVoid, TCmp<TTreeVal>, TInt, TInternalStore, TLeafStore> TBtreeOps;
 
+    /// Blob base with nodes of a paged index
+    PBlobBs BlobBs;
     /// Internal store instance
     TPt<TInternalStore> InternalStore;
     /// Leaf store instance
     TPt<TLeafStore> LeafStore;
     /// BTree instance
     TBtreeOps BTree;
+    /// Lookups of unpaged index share it. Changes and lookups of paged index,
+    /// which load nodes into the cache, take it exclusively.
+    mutable TRWLock IndexLock;
 
 public:
     /// Create new empty index
@@ -3015,12 +3370,26 @@ public:
         BTree(InternalStore, LeafStore, 8, 64, false, false) { }
     /// Create new empty index
     static TPt<TBTreeIndex> New() { return new TBTreeIndex; }
-    /// Load existing index from stream
+    /// Create new empty index with nodes kept in a blob base, caching about CacheSize bytes of them
+    TBTreeIndex(const TStr& BlobFNm, const uint64& CacheSize): BlobBs(TMBlobBs::New(BlobFNm, faCreate)),
+        InternalStore(new TInternalStore(BlobBs, CacheSize / 8)), LeafStore(new TLeafStore(BlobBs, CacheSize - CacheSize / 8)),
+        BTree(InternalStore, LeafStore, 8, 64, false, false) { }
+    /// Create new empty index with nodes kept in a blob base, caching about CacheSize bytes of them
+    static TPt<TBTreeIndex> New(const TStr& BlobFNm, const uint64& CacheSize) { return new TBTreeIndex(BlobFNm, CacheSize); }
+    /// Load existing index from stream. Paged index needs to be opened before use.
     TBTreeIndex(TSIn& SIn): InternalStore(SIn), LeafStore(SIn), BTree(SIn, InternalStore, LeafStore) {  }
-    /// Load existing index from stream
+    /// Load existing index from stream. Paged index needs to be opened before use.
     static TPt<TBTreeIndex> Load(TSIn& SIn) { return new TBTreeIndex(SIn); }
-    /// Save index to stream
-    void Save(TSOut& SOut) { InternalStore.Save(SOut); LeafStore.Save(SOut); BTree.Save(SOut); }
+    /// Save index to stream. Paged index writes modified nodes to the blob base.
+    void Save(TSOut& SOut) { TWriteLock Lock(IndexLock); InternalStore.Save(SOut); LeafStore.Save(SOut);
+        BTree.Save(SOut); if (!BlobBs.Empty()) { BlobBs->Flush(); } }
+
+    /// Are nodes kept on disk
+    bool IsPaged() const { return InternalStore->IsPaged(); }
+    /// Open blob base with nodes of a loaded paged index
+    void Open(const TStr& BlobFNm, const TFAccess& Access);
+    /// Number of nodes currently held in memory
+    int GetCachedNodes() const { return InternalStore->GetCachedNodes() + LeafStore->GetCachedNodes(); }
 
     /// Add new record
     void AddKey(const TVal& Val, const uint64& RecId);
@@ -3046,7 +3415,13 @@ private:
     /// ItemHandler which sums up the frequencies of items
     template <class TQmGixItem>
     class TQmGixSumItemHandler : public TGixItemHandler<TQmGixKey, TQmGixItem> {
+    private:
+        /// Index vocabulary, used to check which keys store compressed child vectors
+        TWPt<TIndexVoc> IndexVoc;
+
     public:
+        TQmGixSumItemHandler(const TWPt<TIndexVoc>& _IndexVoc): IndexVoc(_IndexVoc) { }
+
         /// Merge given items when they have same record ID. Frequency is sumed together
         void Merge(TVec<TQmGixItem>& ItemV, const bool& IsLocal) const;
         /// Remove given item from the list
@@ -3056,10 +3431,38 @@ private:
         /// <= comparator between items
         bool IsLtE(const TQmGixItem& Item1, const TQmGixItem& Item2) const { return Item1 <= Item2; }
 
+        /// Check if key stores compressed child vectors
+        bool IsCompress(const TQmGixKey& Key) const { return IndexVoc->GetKey(Key.Val1).IsCompress(); }
+        /// Encode record IDs as deltas and frequencies using variable-length integers
+        bool Encode(const TVec<TQmGixItem>& ItemV, TMem& Mem) const;
+        /// Decode items encoded by Encode
+        void Decode(const TMem& Mem, const int& Items, TVec<TQmGixItem>& ItemV) const;
+
         /// Memory footprint
         uint64 GetMemUsed() const { return sizeof(TQmGixSumItemHandler<TQmGixItem>); }
     };
 
+    /// ItemHandler for items without frequency
+    template <class TQmGixItem>
+    class TQmGixDefItemHandler : public TGixDefItemHandler<TQmGixKey, TQmGixItem> {
+    private:
+        /// Index vocabulary, used to check which keys store compressed child vectors
+        TWPt<TIndexVoc> IndexVoc;
+
+    public:
+        TQmGixDefItemHandler(const TWPt<TIndexVoc>& _IndexVoc): IndexVoc(_IndexVoc) { }
+
+        /// Check if key stores compressed child vectors
+        bool IsCompress(const TQmGixKey& Key) const { return IndexVoc->GetKey(Key.Val1).IsCompress(); }
+        /// Encode record IDs as deltas using variable-length integers
+        bool Encode(const TVec<TQmGixItem>& ItemV, TMem& Mem) const;
+        /// Decode items encoded by Encode
+        void Decode(const TMem& Mem, const int& Items, TVec<TQmGixItem>& ItemV) const;
+
+        /// Memory footprint
+        uint64 GetMemUsed() const { return sizeof(TQmGixDefItemHandler<TQmGixItem>); }
+    };
+
     /// Merger which sums up the frequencies of items.
     /// Assumes TGixResItem is a TKeyDat< , >.
     template <class TQmGixItem, class TQmGixResItem>
@@ -3067,7 +3470,8 @@ private:
     public:
         /// Union sums up frequencies of overlapping items
         void Union(TVec<TQmGixResItem>& MainV, const TVec<TQmGixResItem>& JoinV) const;
-        /// Intersection sums up frequencies of overlapping items
+        /// Intersection sums up frequencies of overlapping items. Gallops over
+        /// the longer vector when one side is much shorter than the other.
         void Intrs(TVec<TQmGixResItem>& MainV, const TVec<TQmGixResItem>& JoinV) const;
         /// Minus does not deal with frequencies
         void Minus(const TVec<TQmGixResItem>& MainV, const TVec<TQmGixResItem>& JoinV, TVec<TQmGixResItem>& ResV) const;
@@ -3079,6 +3483,8 @@ private:
     public:
         /// Move MainV to ResV since no changes needed
         void Def(const TQmGixKey& Key, TVec<TQmGixItem>& MainV, TVec<TQmGixItem>& ResV) const;
+        /// Items are already result items
+        bool GetResItem(const TQmGixItem& Item, TQmGixItem& ResItem) const { ResItem = Item; return true; }
 
         /// Memory footprint
         uint64 GetMemUsed() const { return sizeof(TQmGixSumWithFqMerger<TQmGixItem>); }
@@ -3090,6 +3496,9 @@ private:
     public:
         /// Copy MainV to ResV and init frequency to 1
         void Def(const TQmGixKey& Key, TVec<TQmGixItem>& MainV, TVec<TQmGixResItem>& ResV) const;
+        /// Result item with frequency 1
+        bool GetResItem(const TQmGixItem& Item, TQmGixResItem& ResItem) const {
+            ResItem = TQmGixResItem(Item.Val, 1); return true; }
 
         /// Memory footprint
         uint64 GetMemUsed() const { return sizeof(TQmGixSumWithoutFqMerger<TQmGixItem, TQmGixResItem>); }
@@ -3242,6 +3651,8 @@ private:
 
     /// Location index (one for each key)
     THash<TInt, PGeoIndex> GeoIndexH;
+    /// Paged location index (one for each key)
+    THash<TInt, PGeoHashIndex> GeoHashIndexH;
 
     /// BTree index for bytes (one for each key)
     THash<TInt, PBTreeIndexUCh> BTreeIndexByteH;
@@ -3265,6 +3676,31 @@ private:
     /// Index Vocabulary
     PIndexVoc IndexVoc;
 
+    /// Nesting depth of batch indexing, inverted index items are collected while above zero
+    TInt BatchDepth;
+    /// Inverted index items collected during batch indexing, grouped by key. Deletes of
+    /// some occurrences are collected here too, as items with negative frequency.
+    THash<TQmGixKey, TVec<TQmGixItemFull> > BatchItemH;
+    /// Inverted index items collected for deletion during batch indexing, grouped by key
+    THash<TQmGixKey, TVec<TQmGixItemFull> > BatchDelItemH;
+    /// Add and then delete items collected during batch indexing, one call per key
+    void FlushBatch();
+
+    /// Node cache size for each paged BTree index
+    static const uint64 BTreeCacheSize;
+    /// Blob base file for nodes of a paged location index
+    TStr GetGeoHashBlobFNm(const int& KeyId) const { return IndexFPath + "Index.GeoHash" + TInt::GetStr(KeyId) + ".GeoDat"; }
+    /// Blob base file for nodes of a paged BTree index
+    TStr GetBTreeBlobFNm(const int& KeyId) const { return IndexFPath + "Index.BTree" + TInt::GetStr(KeyId) + ".BTreeDat"; }
+    /// Create new BTree index for a key, paged if the key requires so
+    template <class TVal>
+    TPt<TBTreeIndex<TVal> > NewBTreeIndex(const int& KeyId) const;
+    /// Open blob bases of loaded paged BTree indexes
+    template <class TVal>
+    void OpenBTreeIndexH(const THash<TInt, TPt<TBTreeIndex<TVal> > >& BTreeIndexH) const;
+    /// Save location and BTree indexes
+    void SaveIndexH();
+
     /// Inverted Index Default ItemHandler Full
     const TGixItemHandler<TQmGixKey, TQmGixItemFull>* SumItemHandlerFull;
     /// Inverted Index Default ItemHandler Small
@@ -3343,6 +3779,13 @@ public:
         const uint64& RecId, const uint64& JoinRecId, const int& JoinFq = 1);
     /// Add to inverted index (RecId, RecFq) under key (KeyId, WordId).
     void IndexGix(const int& KeyId, const uint64& WordId, const uint64& RecId, const int& RecFq);
+    /// Start batch indexing. Inverted index items are collected until the matching
+    /// EndBatch and then added or deleted with one item set update per key. Searches
+    /// do not see the collected items, so only (de)indexing should run within a batch.
+    /// Order of adds and deletes is kept for each key.
+    void StartBatch() { BatchDepth++; }
+    /// End batch indexing and add the collected items to the inverted index
+    void EndBatch();
 
     /// Delete index for RecId under (Key, Word). WordStr is sent through index vocabulary.
     void DeleteValue(const int& KeyId, const TStr& WordStr, const uint64& RecId);
@@ -3474,6 +3917,8 @@ public:
 
     /// perform partial flush of index contents
     int PartialFlush(const int& WndInMsec = 500);
+    /// save all index contents, keeping the index open
+    void Flush();
 };
 
 ///////////////////////////////
@@ -3521,6 +3966,94 @@ public:
     virtual PJsonVal SaveJson() const = 0;
 };
 
+///////////////////////////////
+/// Stream aggregate callbacks.
+typedef enum { saeStep, saeTime, saeAddRec, saeAddRecBatch, saeUpdateRec, saeDeleteRec, saeMx } TStreamAggrEvent;
+
+///////////////////////////////
+/// Stream aggregate statistics.
+/// Counts calls by callback type and keeps a histogram of their latencies. Buckets
+/// split each power of two nanoseconds into four, so recording a call costs two reads
+/// of the monotonic clock and a few shifts, and percentiles are within 25% of the
+/// true value. Memory growth is measured from the first to the last reported footprint.
+class TStreamAggrStats {
+private:
+    /// Number of latency histogram buckets
+    static const int Buckets = 256;
+
+    /// Number of calls per callback type
+    TUInt64V CallsV;
+    /// Latency histogram
+    TUInt64V BucketV;
+    /// Sum of all latencies in nanoseconds
+    TUInt64 SumNSecs;
+    /// Longest latency in nanoseconds
+    TUInt64 MxNSecs;
+    /// Memory footprint when first reported
+    TUInt64 StartMem;
+    /// Memory footprint when last reported
+    TUInt64 LastMem;
+    /// Memory footprint when reported before the last time
+    TUInt64 PrevMem;
+    /// Was memory footprint reported yet
+    TBool MemP;
+
+    /// Get bucket for a latency
+    static int GetBucketN(const uint64& NSecs);
+    /// Get upper bound of the latencies in the bucket
+    static uint64 GetBucketMxNSecs(const int& BucketN);
+    /// Convert performance timer ticks to nanoseconds
+    static uint64 GetNSecs(const uint64& Ticks);
+
+public:
+    TStreamAggrStats(): CallsV(saeMx), BucketV(Buckets) { }
+
+    /// Record one call of the callback
+    void Add(const TStreamAggrEvent& Event, const uint64& NSecs);
+    /// Report current memory footprint of the aggregate
+    void AddMem(const uint64& MemUsed);
+    /// Forget all the statistics
+    void Clr();
+
+    /// Number of calls of the callback
+    uint64 GetCalls(const TStreamAggrEvent& Event) const { return CallsV[(int)Event]; }
+    /// Number of calls of all the callbacks
+    uint64 GetCalls() const;
+    /// Latency percentile (between 0 and 1) in milliseconds
+    double GetLatencyMSecs(const double& Percentile) const;
+    /// Average latency in milliseconds
+    double GetMeanLatencyMSecs() const;
+    /// Longest latency in milliseconds
+    double GetMxLatencyMSecs() const { return (double)MxNSecs / 1e6; }
+    /// Memory growth since first reported footprint
+    int64 GetMemGrowth() const { return (int64)LastMem.Val - (int64)StartMem.Val; }
+    /// Memory growth since the previous report
+    int64 GetLastMemGrowth() const { return (int64)LastMem.Val - (int64)PrevMem.Val; }
+
+    /// Calls, latencies and memory growth as JSON
+    PJsonVal GetJson() const;
+    /// Get the memory footprint
+    uint64 GetMemUsed() const;
+    /// Name of the callback used in JSON
+    static TStr GetEventStr(const TStreamAggrEvent& Event);
+
+    /// Records latency of the call made during the lifetime of the object
+    class TScope {
+    private:
+        /// Statistics where to record the call
+        TStreamAggrStats& Stats;
+        /// Type of the callback
+        const TStreamAggrEvent Event;
+        /// Performance timer ticks at the start of the call
+        const uint64 StartTicks;
+
+    public:
+        TScope(TStreamAggrStats& _Stats, const TStreamAggrEvent& _Event):
+            Stats(_Stats), Event(_Event), StartTicks(TTm::GetPerfTimerTicks()) { }
+        ~TScope() { Stats.Add(Event, GetNSecs(TTm::GetPerfTimerTicks() - StartTicks)); }
+    };
+};
+
 ///////////////////////////////
 /// Stream Aggregator.
 /// Computes and holds statistics from a record stream.
@@ -3552,6 +4085,8 @@ private:
 protected:
     /// Counter of time spent running this stream aggregate
     TAggrExeTm ExeTm;
+    /// Calls, latencies and memory growth of the callbacks
+    TStreamAggrStats AggrStats;
 
 protected:
     /// Create new stream aggregate from JSon parameters
@@ -3600,6 +4135,11 @@ public:
     virtual void OnTime(const uint64& TmMsec, const TWPt<TStreamAggr>& CallerAggr) { OnStep(CallerAggr); }
     /// Add new record to the aggregate
     virtual void OnAddRec(const TRec& Rec, const TWPt<TStreamAggr>& CallerAggr) { OnStep(CallerAggr); }
+    /// Can the aggregate process a batch of records with one call to OnAddRecBatch.
+    /// It gets the batch after all its input aggregates already processed it.
+    virtual bool IsBatch() const { return false; }
+    /// Add a batch of new records to the aggregate. Default calls OnAddRec for each record.
+    virtual void OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr);
     /// Recored already added to the aggregate is being updated
     virtual void OnUpdateRec(const TRec& Rec, const TWPt<TStreamAggr>& CallerAggr) { }
     /// Recored already added to the aggregate is being deleted from the store
@@ -3607,6 +4147,14 @@ public:
 
     // retrieving input aggregate names
     virtual void GetInAggrNmV(TStrV& InAggrNmV) const { };
+    /// True when the callbacks can run on a worker thread, in parallel with other
+    /// aggregates of the same level in TStreamAggrSet. Such aggregate only changes
+    /// its own state, does not read records from stores, reports all its inputs
+    /// through GetInAggrNmV and reads only inputs which are IsOutThreadSafe.
+    virtual bool IsThreadSafe() const { return false; }
+    /// True when the output interfaces (TStreamAggrOut) only read the state of
+    /// the aggregate and can be called from several threads at the same time
+    virtual bool IsOutThreadSafe() const { return false; }
 
     /// Print latest statistics to logger
     virtual void PrintStat() const { }
@@ -3616,6 +4164,10 @@ public:
     virtual uint64 GetMemUsed() const;
     /// Get access to the timmer
     const TAggrExeTm& GetExeTm() const { return ExeTm; }
+    /// Get statistics of the callbacks
+    const TStreamAggrStats& GetAggrStats() const { return AggrStats; }
+    /// Get statistics of the callbacks for update
+    TStreamAggrStats& GetAggrStats() { return AggrStats; }
 
     /// Unique ID of the stream aggregate
     virtual TStr Type() const = 0;
@@ -3708,6 +4260,14 @@ namespace TStreamAggrOut {
         virtual void GetOutTmMSecsV(TUInt64V& MSecsV) const = 0;
     };
 
+    /// values and timestamps produced by the last batch of records
+    class IFltTmBatch {
+    public:
+        virtual ~IFltTmBatch() {}
+        virtual const TFltV& GetBatchFltV() const = 0;
+        virtual const TUInt64V& GetBatchTmMSecsV() const = 0;
+    };
+
     class INmInt {
     public:
         // retrieving named values
@@ -3731,11 +4291,41 @@ namespace TStreamAggrOut {
 ///////////////////////////////
 /// Stream aggregator set.
 /// Holds a set of stream aggregates and triggers them all on call.
-/// Aggregates are triggered in the same order as they are added to the set.
+/// By default aggregates are triggered in the same order as they are added to the set.
+/// With more than one thread, aggregates are grouped into levels based on the input
+/// aggregates they report through GetInAggrNmV. Aggregates from the same level run in
+/// parallel, and each level runs only after all the previous levels are done.
+/// Only aggregates which are IsThreadSafe run in parallel, the others run alone
+/// on the calling thread, in the order of adding.
+/// Deterministic mode runs the levels in the same order on the calling thread.
+/// A batch of records is passed to each aggregate with one call when all aggregates
+/// in the set support batches and read only from aggregates in the set. Otherwise
+/// the records are passed one by one.
 class TStreamAggrSet : public TStreamAggr {
 protected:
     /// List of aggregates triggered in step
     TVec<TWPt<TStreamAggr> > StreamAggrV;
+    /// Number of threads for running independent aggregates (1 runs them in order of adding)
+    TInt Threads;
+    /// Run aggregates by levels on the calling thread
+    TBool DeterministicP;
+    /// Positions of aggregates in StreamAggrV, grouped by dependency level
+    TVec<TIntV> LevelAggrNVV;
+    /// Which aggregates from StreamAggrV can run in parallel with others
+    TBoolV ThreadSafeV;
+    /// True when all input aggregates of the aggregates are also in the set
+    TBool InAggrInSetP;
+
+    /// Forward event to one aggregate
+    void OnEvent(const TWPt<TStreamAggr>& StreamAggr, const TStreamAggrEvent& Event,
+        const uint64& TmMsec, const TRec& Rec, const PRecSet& RecSet);
+    /// Forward event in parallel to aggregates between positions StartNN and EndNN of AggrNV
+    void OnEventPar(const TIntV& AggrNV, const int& StartNN, const int& EndNN,
+        const TStreamAggrEvent& Event, const uint64& TmMsec, const TRec& Rec, const PRecSet& RecSet);
+    /// Forward event to all aggregates in the set
+    void OnEvent(const TStreamAggrEvent& Event, const uint64& TmMsec, const TRec& Rec, const PRecSet& RecSet);
+    /// Group aggregates into levels based on their input aggregates
+    void UpdateLevels();
 
     /// Create empty aggregate base
     TStreamAggrSet(const TWPt<TBase>& _Base, const TStr& _AggrNm);
@@ -3760,6 +4350,22 @@ public:
     /// Get list of all aggregates
     TStrV GetStreamAggrNmV() const;
 
+    /// Number of threads used to run independent aggregates
+    int GetThreads() const { return Threads; }
+    /// Set number of threads used to run independent aggregates
+    void PutThreads(const int& _Threads);
+    /// Are aggregates run by levels on the calling thread
+    bool IsDeterministic() const { return DeterministicP; }
+    /// Run aggregates by levels on the calling thread
+    void PutDeterministic(const bool& _DeterministicP) { DeterministicP = _DeterministicP; }
+    /// Aggregate names grouped by dependency level
+    TVec<TStrV> GetLevelStreamAggrNmVV() const;
+
+    /// Get parameters (threads and deterministic mode)
+    PJsonVal GetParams() const;
+    /// Set parameters (threads and deterministic mode)
+    void SetParams(const PJsonVal& ParamVal);
+
     /// Reset all aggregates in the set
     void Reset();
 
@@ -3769,6 +4375,10 @@ public:
     void OnTime(const uint64& TmMsec, const TWPt<TStreamAggr>& CallerAggr);
     /// Add new record to the aggregates
     void OnAddRec(const TRec& Rec, const TWPt<TStreamAggr>& CallerAggr);
+    /// Can all aggregates in the set process batches
+    bool IsBatch() const;
+    /// Add a batch of new records to the aggregates
+    void OnAddRecBatch(const PRecSet& RecSet, const TWPt<TStreamAggr>& CallerAggr);
     /// Recored already added to the aggregates is being updated
     void OnUpdateRec(const TRec& Rec, const TWPt<TStreamAggr>& CallerAggr);
     /// Recored already added to the aggregates is being deleted from the store
@@ -3800,12 +4410,220 @@ public:
 
     /// new record added to the store, call stream aggregate OnAddRec
     void OnAdd(const TRec& Rec);
+    /// batch of new records added to the store, call stream aggregate OnAddRecBatch
+    void OnAddBatch(const PRecSet& RecSet);
     /// record is updated in the store, call stream aggregate OnUpdateRec
     void OnUpdate(const TRec& Rec);
     /// record is deleted from the store, call stream aggregate OnDeleteRec
     void OnDelete(const TRec& Rec);
 };
 
+///////////////////////////////
+/// Write-ahead log sync policy
+typedef enum {
+    wspRec = 0,     ///< Write and sync after every entry
+    wspGroup = 1,   ///< Write and sync after a group of entries
+    wspInterval = 2 ///< Write and sync when interval passed since the last sync
+} TWalSyncPolicy;
+
+///////////////////////////////
+/// Base write-ahead log.
+/// Append-only log of store updates (added, updated and deleted records, set
+/// fields, added and deleted joins) and stream aggregate states since the last
+/// checkpoint of the base. Entries are kept in a buffer and written out together
+/// with one sync (group commit), as given by the sync policy. Each entry is
+/// checksummed, so replay stops at the last complete entry when the process died
+/// in the middle of a write. A checkpoint saves the stores and the index and then
+/// truncates the log, keeping only the latest states of logged stream aggregates.
+/// Closing the base is the final checkpoint and removes the log. Only the outermost
+/// store operation is logged; nested ones (e.g. records added through joins) are
+/// repeated when the outer one is replayed.
+ClassTP(TBaseWal, PBaseWal)// {
+private:
+    /// Entry types
+    typedef enum {
+        wetAddRec = 1,
+        wetUpdateRec = 2,
+        wetAddRecBatch = 3,
+        wetDelRecs = 4,
+        wetDelAllRecs = 5,
+        wetStreamAggr = 6,
+        wetAddJoin = 7,
+        wetDelJoin = 8,
+        wetSetField = 9
+    } TEntryType;
+
+public:
+    /// Marks a store operation for the log, only the outermost operation is logged
+    class TOp {
+    private:
+        /// Log, NULL when base has none
+        TBaseWal* Wal;
+    public:
+        TOp(const PBaseWal& _Wal): Wal((!_Wal.Empty() && _Wal->IsOpen()) ? _Wal() : NULL) {
+            if (Wal != NULL) { Wal->OpDepth++; } }
+        ~TOp() { if (Wal != NULL) { Wal->OpDepth--; } }
+
+        /// Is this the outermost operation of a base with a log
+        bool IsLog() const { return (Wal != NULL) && (Wal->OpDepth == 1); }
+        /// Log added record
+        void AddRec(const uint& StoreId, const PJsonVal& RecVal) const;
+        /// Log updated record
+        void UpdateRec(const uint& StoreId, const uint64& RecId, const PJsonVal& RecVal) const;
+        /// Log added record batch
+        void AddRecBatch(const uint& StoreId, const TRecBatch& RecBatch) const;
+        /// Log deletion of the first DelRecs records from DelRecIdV
+        void DelRecs(const uint& StoreId, const TUInt64V& DelRecIdV, const int& DelRecs) const;
+        /// Log deletion of all records
+        void DelAllRecs(const uint& StoreId) const;
+        /// Log added join
+        void AddJoin(const uint& StoreId, const int& JoinId, const uint64& RecId,
+            const uint64& JoinRecId, const int& JoinFq) const;
+        /// Log deleted join
+        void DelJoin(const uint& StoreId, const int& JoinId, const uint64& RecId,
+            const uint64& JoinRecId, const int& JoinFq) const;
+        /// Log field value, as it was set in the store
+        void SetField(const TWPt<TStore>& Store, const uint64& RecId, const int& FieldId) const;
+    };
+
+private:
+    /// Log file name
+    TStr FNm;
+    /// Log file, NULL when closed
+    TFOut* FOut;
+    /// When to sync
+    TWalSyncPolicy SyncPolicy;
+    /// Entries in a group for wspGroup
+    TInt GroupSize;
+    /// Time between syncs for wspInterval
+    TInt IntervalMSecs;
+
+    /// Entries not yet written to the file
+    TMOut PendingOut;
+    /// Number of entries in PendingOut
+    TInt PendingEntries;
+    /// Time of the last sync
+    TUInt64 SyncMSecs;
+    /// Depth of store operations in progress
+    TInt OpDepth;
+
+    /// Number of logged entries
+    TUInt64 Entries;
+    /// Number of written bytes
+    TUInt64 Bytes;
+    /// Number of syncs
+    TUInt64 Syncs;
+    /// Number of checkpoints
+    TUInt64 Checkpoints;
+    /// Number of logged entries at the last checkpoint
+    TUInt64 CheckpointEntries;
+    /// Remove the log file when closed
+    TBool DelP;
+    /// Names of stream aggregates with state in the log
+    TStrSet StreamAggrNmSet;
+
+    TBaseWal(const TStr& _FNm): FNm(_FNm), FOut(NULL), SyncPolicy(wspGroup), GroupSize(128), IntervalMSecs(1000) { }
+
+    /// Add entry and commit when required by the sync policy
+    void AddEntry(const TMOut& EntryOut);
+    /// Start new entry of a given type
+    static void StartEntry(const TEntryType& Type, TSOut& EntryOut) { TCh((char)Type).Save(EntryOut); }
+    /// Write entry prefixed with its length and checksum
+    static void PutEntry(const TMOut& EntryOut, TSOut& SOut);
+    /// Replay one entry
+    void ReplayEntry(const TWPt<TBase>& Base, TSIn& EntrySIn, THash<TStr, TMem>& StreamAggrStateH);
+
+public:
+    /// Create closed log with a given file name
+    static PBaseWal New(const TStr& FNm) { return new TBaseWal(FNm); }
+    /// Closes the log, the file is removed only when marked by SetDelOnClose
+    ~TBaseWal();
+
+    /// Log file name for base located at a given path
+    static TStr GetFNm(const TStr& FPath) { return FPath + "Base.wal"; }
+    /// Replay log entries to the base. Stream aggregate states which have no
+    /// registered aggregate yet are returned in StreamAggrStateH. Returns number
+    /// of replayed entries; a damaged tail left by a crash is cut off.
+    int Replay(const TWPt<TBase>& Base, THash<TStr, TMem>& StreamAggrStateH);
+
+    /// Open log for appending, with parameters
+    /// `{ "sync": "rec" | "group" | "interval", "groupSize": 128, "interval": 1000 }`
+    void Open(const PJsonVal& ParamVal);
+    /// Commit pending entries and close the file
+    void Close();
+    /// Is the log open for appending
+    bool IsOpen() const { return FOut != NULL; }
+    /// Remove the log file when closed, set when the base is saved
+    void SetDelOnClose() { DelP = true; }
+
+    /// Log state of a stream aggregate
+    void AddStreamAggr(const TWPt<TStreamAggr>& StreamAggr);
+    /// Write pending entries to the file and sync it
+    void Commit();
+    /// Names of stream aggregates with state in the log
+    void GetStreamAggrNmV(TStrV& StreamAggrNmV) const { StreamAggrNmSet.GetKeyV(StreamAggrNmV); }
+    /// Were entries logged since the last checkpoint
+    bool IsCheckpointDue() const { return Entries > CheckpointEntries; }
+    /// Start the log again after the base was saved, with given stream aggregate
+    /// states as the only entries. Closed log only removes the file.
+    void Checkpoint(const THash<TStr, TMem>& StreamAggrStateH);
+
+    /// Parameters in JSon form, as accepted by New
+    PJsonVal GetParamVal() const;
+    /// Log statistics in JSon form
+    PJsonVal GetJson() const;
+};
+
+///////////////////////////////
+/// Background flusher.
+/// Thread which periodically writes dirty store and index data (in-memory and
+/// cached store blocks, paged blobs and gix item sets) to disk, so the insert
+/// thread does not need to call TBase::PartialFlush itself. Each round spends
+/// at most BudgetMSecs on flushing. The base data lock is taken for one store or
+/// index slice at a time, so writers wait for at most one slice. Readers do not take the base data lock; stores and
+/// gix caches lock their reads against the flush of the same store or cache instead.
+/// Rounds are incremental and do not stop writers for a full flush; a round which
+/// finds nothing dirty saves the base with TBase::Checkpoint. While the write-ahead
+/// log is open, rounds skip partial flushes and make a checkpoint whenever entries
+/// were logged since the last one, which keeps the log short.
+ClassTPE(TBaseFlusher, PBaseFlusher, TInterruptibleThread)// {
+private:
+    /// Base we are flushing
+    TWPt<TBase> Base;
+    /// Pause between rounds
+    TInt IntervalMSecs;
+    /// Maximal time spent flushing in one round
+    TInt BudgetMSecs;
+    /// Set when the flusher should finish
+    volatile bool StopP;
+    /// Number of finished rounds
+    std::atomic<uint64> Rounds;
+    /// Number of flushed blocks, pages and item sets
+    std::atomic<uint64> Saved;
+    /// Time of the last checkpoint, zero when none yet
+    std::atomic<uint64> CheckpointMSecs;
+    /// Was anything flushed since the last checkpoint
+    bool FlushedP;
+
+    TBaseFlusher(const TWPt<TBase>& _Base, const int& _IntervalMSecs, const int& _BudgetMSecs);
+
+public:
+    static PBaseFlusher New(const TWPt<TBase>& Base, const int& IntervalMSecs, const int& BudgetMSecs) {
+        return new TBaseFlusher(Base, IntervalMSecs, BudgetMSecs); }
+
+    /// Flushing loop, runs until Stop is called
+    void Run();
+    /// Finish the current round and wait for the thread to end
+    void Stop();
+
+    /// Pause between rounds in milliseconds
+    int GetIntervalMSecs() const { return IntervalMSecs; }
+    /// Maximal time spent flushing in one round in milliseconds
+    int GetBudgetMSecs() const { return BudgetMSecs; }
+    /// Flusher statistics in JSON form
+    PJsonVal GetJson() const;
+};
+
 ///////////////////////////////
 // QMiner-Base
 class TBase {
@@ -3817,6 +4635,13 @@ private:
 
     /// True after the base is initialized
     TBool InitP;
+    /// Write-ahead log, empty for read-only base. Declared before the stores and
+    /// the index, so it is closed and removed only after they are saved.
+    PBaseWal Wal;
+    /// Write-ahead log parameters from base config, null when not used
+    PJsonVal WalParamVal;
+    /// Logged stream aggregate states waiting for their aggregates to be registered
+    THash<TStr, TMem> WalStreamAggrStateH;
 
     /// Location of base on the disk
     TStr FPath;
@@ -3842,11 +4667,35 @@ private:
     /// Name validates used for validating field, join and key names
     TNmValidator NmValidator;
 
+    /// Lock for store and index data, shared with background flusher
+    TCriticalSection DataLock;
+    /// Held for reading by readers outside the main thread and for writing by TDataLock
+    TRWLock DataRWLock;
+    /// Nesting depth of TDataLock, only changed while holding DataLock
+    int DataLockDepth;
+    /// Background flusher, empty when not running
+    PBaseFlusher Flusher;
+
 private:
     /// Invert given record set (replace with all the records from the store that are not in it)
     PRecSet Invert(const PRecSet& RecSet);
     /// Execute search query. Returns results and a flag indicating if the results should be inverted.
     TPair<TBool, PRecSet> _Search(const TQueryItem& QueryItem);
+    /// Execute leaf query item, which does not go to inverted index
+    TPair<TBool, PRecSet> _SearchLeaf(const TQueryItem& QueryItem);
+    /// Merge results of operator query item (and, or, not) subordinate items
+    TPair<TBool, PRecSet> _SearchMerge(const TQueryItem& QueryItem, const TBoolV& NotV, const TRecSetV& RecSetV);
+    /// Execute join query item on results of its subordinate query
+    TPair<TBool, PRecSet> _SearchJoin(const TQueryItem& QueryItem, TPair<TBool, PRecSet> NotRecSet);
+    /// Does query item have subordinate items which are executed before it
+    static bool IsSearchSubItems(const TQueryItem& QueryItem);
+    /// Flatten query tree for parallel execution, subordinate items come before their parents
+    int GetSearchNodes(const TQueryItem& QueryItem, TVec<const TQueryItem*>& NodeV,
+        TIntV& HeightV, TVec<TIntV>& SubNodeNVV) const;
+    /// Execute search query on up to Threads threads. Subtrees of the same height are
+    /// executed in parallel. Indexes guard their lookups with their own locks,
+    /// so this is safe to call on a read-only base from several threads.
+    TPair<TBool, PRecSet> _SearchPar(const TQueryItem& QueryItem, const int& Threads);
 
     /// Get config name for base located on a given path
     static TStr GetConfFNm(const TStr& FPath) { return FPath + "Base.json"; }
@@ -3861,6 +4710,18 @@ private:
     TBase(const TStr& _FPath, const TFAccess& _FAccess, const int64& IndexCacheSize, const TStrUInt64H& IndexTypeCacheSizeH, const int& SplitLen);
 
 public:
+    /// Exclusive lock for store and index data, taken by writers. Excludes other
+    /// writers, background flusher and readers holding GetDataRWLock() for reading.
+    /// The same thread can take it more than once.
+    class TDataLock {
+    private:
+        TBase* Base;
+        UndefCopyAssign(TDataLock);
+    public:
+        TDataLock(const TWPt<TBase>& _Base);
+        ~TDataLock();
+    };
+
     ~TBase();
 
     /// Create new base on the given folder
@@ -3943,6 +4804,8 @@ public:
     uint64 AddRec(const TStr& StoreNm, const PJsonVal& RecVal);
     /// Add new record to a give store
     uint64 AddRec(const uint& StoreId, const PJsonVal& RecVal);
+    /// Add batch of new records to a given store
+    void AddRecBatch(const TWPt<TStore>& Store, TRecBatch& RecBatch, TUInt64V& RecIdV);
 
     /// Searching records (default search interface)
     PRecSet Search(const PQuery& Query);
@@ -3956,8 +4819,43 @@ public:
     /// Execute garbage collection on all stores.
     /// Each store is given MxTimeMSecs for the collection.
     void GarbageCollect(const int& MxTimeMSecs = -1);
-    /// Perform partial flush of data
+    /// Perform partial flush of data. While write-ahead log is open, the log is
+    /// replayed over the saved state, which partial writes would mix with newer
+    /// data, so a checkpoint is made instead and zero is returned.
     int PartialFlush(const int& WndInMSec = 500);
+    /// Save stores, index and index vocabulary under the data lock and start the
+    /// write-ahead log again, so it only holds updates made after this point
+    void Checkpoint();
+
+    /// Start background thread which flushes dirty data every IntervalMSecs,
+    /// spending at most BudgetMSecs per round. While it runs, writes which do not
+    /// go through TBase (e.g. direct TStore calls) must hold TDataLock. While the
+    /// write-ahead log is open, rounds make checkpoints instead.
+    void StartFlusher(const int& IntervalMSecs = 1000, const int& BudgetMSecs = 50);
+    /// Stop background flusher, if running
+    void StopFlusher();
+    /// Is background flusher running
+    bool IsFlusher() const { return !Flusher.Empty(); }
+    /// Readers running outside the main thread hold this lock for reading, which
+    /// keeps writers out. Such readers also require IsConcurrentRead().
+    TRWLock& GetDataRWLock() { return DataRWLock; }
+    /// Can records of all stores be read from several threads at the same time
+    bool IsConcurrentRead() const;
+
+    /// Start logging store updates to the write-ahead log, see TBaseWal::Open for
+    /// parameters. The setting is remembered, so the log is reopened with the base.
+    void OpenWal(const PJsonVal& ParamVal);
+    /// Stop logging, the log is kept until the next checkpoint
+    void CloseWal();
+    /// Is write-ahead log open
+    bool IsWal() const { return !Wal.Empty() && Wal->IsOpen(); }
+    /// Get write-ahead log, empty for read-only base
+    const PBaseWal& GetWal() const { return Wal; }
+    /// Write pending log entries to disk
+    void CommitWal();
+    /// Log current state of a stream aggregate. After a crash the state is
+    /// loaded into the aggregate with the same name once it is registered.
+    void WalStreamAggr(const TStr& StreamAggrNm);
 
     /// asserts if a field name is valid
     void AssertValidNm(const TStr& FldNm) const { NmValidator.AssertValidNm(FldNm); }
@@ -3984,7 +4882,8 @@ public:
     void ResetGixStats() { Index->ResetStats(); }
     /// Get performance statistics in JSON form
     PJsonVal GetStats();
-    /// Get stream aggregates stats
+    /// Get stream aggregates stats: execution times, calls and latencies per callback
+    /// and memory footprint. Also marks the footprint for reporting memory growth.
     PJsonVal GetStreamAggrStats() const;
 };
 
@@ -15,6 +15,114 @@ void TRecSet::FilterBy(const TFilter& Filter) {
     RecIdFqV = NewRecIdFqV;
 }
 
+template <class TVal, class TValV>
+void TRecSet::FilterByFieldBlock(const int& FieldId, const TVal& MinVal, const TVal& MaxVal,
+        void (TStore::*GetFieldBlock)(const TUInt64V&, const int&, TValV&, TBoolV&) const) {
+
+    const int Recs = GetRecs();
+    TUInt64V RecIdV(FilterBlockLen, 0);
+    TValV ValV; TBoolV NullV;
+    TVec<uchar> KeepV(FilterBlockLen);
+    // number of records kept so far, kept records are compacted to the front of RecIdFqV
+    int NewRecs = 0;
+    for (int BlockStart = 0; BlockStart < Recs; BlockStart += FilterBlockLen) {
+        const int BlockLen = TInt::GetMn(FilterBlockLen, Recs - BlockStart);
+        // fetch values of the field for the whole block
+        RecIdV.Clr(false);
+        for (int RecN = BlockStart; RecN < BlockStart + BlockLen; RecN++) {
+            RecIdV.Add(RecIdFqV[RecN].Key);
+        }
+        ((*Store).*GetFieldBlock)(RecIdV, FieldId, ValV, NullV);
+        // evaluate predicate without branches, so the loop can be vectorized
+        for (int ValN = 0; ValN < BlockLen; ValN++) {
+            const TVal Val = ValV[ValN].Val;
+            KeepV[ValN] = (uchar)((MinVal <= Val) & (Val <= MaxVal) & !NullV[ValN].Val);
+        }
+        // compact in place; write position never overtakes read position
+        for (int ValN = 0; ValN < BlockLen; ValN++) {
+            RecIdFqV[NewRecs] = RecIdFqV[BlockStart + ValN];
+            NewRecs += KeepV[ValN];
+        }
+    }
+    RecIdFqV.Trunc(NewRecs);
+}
+
+template <class TKey>
+void TRecSet::SortByFieldKey(TVec<TPair<TKey, TUInt64IntKd> >& KeyRecV, const bool& Asc, const int& Limit) {
+    typedef TPair<TKey, TUInt64IntKd> TItem;
+    const int Recs = KeyRecV.Len();
+    if (0 <= Limit && Limit < Recs) {
+        // only need the first `Limit' records
+        if (Asc) { SortTopK(KeyRecV, Limit, TLss<TItem>()); }
+        else { SortTopK(KeyRecV, Limit, TGtr<TItem>()); }
+    } else {
+        SortParallel(KeyRecV, Asc);
+    }
+    // copy sorted records back to the result set
+    RecIdFqV.Gen(KeyRecV.Len(), 0);
+    for (int RecN = 0; RecN < KeyRecV.Len(); RecN++) {
+        RecIdFqV.Add(KeyRecV[RecN].Val2);
+    }
+}
+
+template <class TItem, class TCmp>
+void TRecSet::SortTopK(TVec<TItem>& ItemV, const int& Limit, const TCmp& Cmp) {
+    if (Limit == 0) { ItemV.Clr(); return; }
+    // top of the heap is the worst of the items kept so far
+    THeap<TItem, TCmp> Heap(Cmp);
+    Heap().Reserve(Limit);
+    for (int ItemN = 0; ItemN < ItemV.Len(); ItemN++) {
+        const TItem& Item = ItemV[ItemN];
+        if (Heap.Len() < Limit) {
+            Heap.PushHeap(Item);
+        } else if (Cmp(Item, Heap.TopHeap())) {
+            Heap.PopHeap();
+            Heap.PushHeap(Item);
+        }
+    }
+    ItemV = Heap();
+    ItemV.SortCmp(Cmp);
+}
+
+template <class TItem>
+void TRecSet::SortParallel(TVec<TItem>& ItemV, const bool& Asc) {
+    const int Items = ItemV.Len();
+#ifdef GLib_OPENMP
+    const int Threads = omp_get_max_threads();
+#else
+    const int Threads = 1;
+#endif
+    if (Threads <= 1 || Items < ParallelSortMnRecs) { ItemV.Sort(Asc); return; }
+    // sort chunks independently, each thread with its own random generator
+    const int ChunkLen = (Items + Threads - 1) / Threads;
+    #pragma omp parallel for schedule(static, 1)
+    for (int ChunkN = 0; ChunkN < Threads; ChunkN++) {
+        const int ChunkStart = ChunkN * ChunkLen;
+        const int ChunkEnd = TInt::GetMn(ChunkStart + ChunkLen, Items);
+        TRnd Rnd(ChunkN + 1);
+        if (ChunkStart < ChunkEnd) { ItemV.QSort(ChunkStart, ChunkEnd - 1, Asc, Rnd); }
+    }
+    // merge pairs of sorted runs, doubling the run length in each round
+    TVec<TItem> MergeV(Items);
+    for (int RunLen = ChunkLen; RunLen < Items; RunLen *= 2) {
+        const int Runs = (Items + 2 * RunLen - 1) / (2 * RunLen);
+        #pragma omp parallel for schedule(static, 1)
+        for (int RunN = 0; RunN < Runs; RunN++) {
+            const int LeftN = RunN * 2 * RunLen;
+            const int MidN = TInt::GetMn(LeftN + RunLen, Items);
+            const int EndN = TInt::GetMn(LeftN + 2 * RunLen, Items);
+            int LItemN = LeftN, RItemN = MidN, ItemN = LeftN;
+            while (LItemN < MidN && RItemN < EndN) {
+                const bool RightP = Asc ? (ItemV[RItemN] < ItemV[LItemN]) : (ItemV[LItemN] < ItemV[RItemN]);
+                MergeV[ItemN++] = RightP ? ItemV[RItemN++] : ItemV[LItemN++];
+            }
+            while (LItemN < MidN) { MergeV[ItemN++] = ItemV[LItemN++]; }
+            while (RItemN < EndN) { MergeV[ItemN++] = ItemV[RItemN++]; }
+        }
+        ItemV.Swap(MergeV);
+    }
+}
+
 template <class TSplitter>
 TVec<PRecSet> TRecSet::SplitBy(const TSplitter& Splitter) const {
     TRecSetV ResV;
@@ -41,13 +149,23 @@ TVec<PRecSet> TRecSet::SplitBy(const TSplitter& Splitter) const {
 
 ///////////////////////////////
 // B-Tree Index
+template <class TVal>
+void TBTreeIndex<TVal>::Open(const TStr& BlobFNm, const TFAccess& Access) {
+    if (!IsPaged()) { return; }
+    BlobBs = TMBlobBs::New(BlobFNm, Access);
+    InternalStore->Open(BlobBs);
+    LeafStore->Open(BlobBs);
+}
+
 template <class TVal>
 void TBTreeIndex<TVal>::AddKey(const TVal& Val, const uint64& RecId) {
+    TWriteLock Lock(IndexLock);
     BTree.Add(TTreeVal(Val, RecId));
 }
 
 template <class TVal>
 void TBTreeIndex<TVal>::DelKey(const TVal& Val, const uint64& RecId) {
+    TWriteLock Lock(IndexLock);
     BTree.Del(TTreeVal(Val, RecId));
 }
 
@@ -55,8 +173,14 @@ template <class TVal>
 void TBTreeIndex<TVal>::SearchRange(const TPair<TVal, TVal>& RangeMinMax, TUInt64V& RecIdV) const {
 
     TVec<TTreeVal> ResValRecIdV;
-    // execute query
-    BTree.RangeQuery(TTreeVal(RangeMinMax.Val1, 0), TTreeVal(RangeMinMax.Val2, TUInt64::Mx), ResValRecIdV);
+    // execute query, paged index loads nodes into the cache
+    if (IsPaged()) {
+        TWriteLock Lock(IndexLock);
+        BTree.RangeQuery(TTreeVal(RangeMinMax.Val1, 0), TTreeVal(RangeMinMax.Val2, TUInt64::Mx), ResValRecIdV);
+    } else {
+        TReadLock Lock(IndexLock);
+        BTree.RangeQuery(TTreeVal(RangeMinMax.Val1, 0), TTreeVal(RangeMinMax.Val2, TUInt64::Mx), ResValRecIdV);
+    }
     // parse out record ids
     RecIdV.Gen(ResValRecIdV.Len(), 0);
     for (int ResN = 0; ResN < ResValRecIdV.Len(); ResN++) {
@@ -64,6 +188,25 @@ void TBTreeIndex<TVal>::SearchRange(const TPair<TVal, TVal>& RangeMinMax, TUInt6
     }
 }
 
+///////////////////////////////
+/// Index
+template <class TVal>
+TPt<TBTreeIndex<TVal> > TIndex::NewBTreeIndex(const int& KeyId) const {
+    if (IndexVoc->GetKey(KeyId).IsPaged()) {
+        return TBTreeIndex<TVal>::New(GetBTreeBlobFNm(KeyId), BTreeCacheSize);
+    }
+    return TBTreeIndex<TVal>::New();
+}
+
+template <class TVal>
+void TIndex::OpenBTreeIndexH(const THash<TInt, TPt<TBTreeIndex<TVal> > >& BTreeIndexH) const {
+    int KeyId = BTreeIndexH.FFirstKeyId();
+    while (BTreeIndexH.FNextKeyId(KeyId)) {
+        const int IndexKeyId = BTreeIndexH.GetKey(KeyId);
+        BTreeIndexH[KeyId]->Open(GetBTreeBlobFNm(IndexKeyId), Access);
+    }
+}
+
 ///////////////////////////////
 /// QMiner Index Frequency Summation Item Handler
 template <class TQmGixItem>
@@ -99,6 +242,54 @@ void TIndex::TQmGixSumItemHandler<TQmGixItem>::Merge(TVec<TQmGixItem>& ItemV, co
     }
 }
 
+template <class TQmGixItem>
+bool TIndex::TQmGixSumItemHandler<TQmGixItem>::Encode(const TVec<TQmGixItem>& ItemV, TMem& Mem) const {
+    uint64 PrevRecId = 0;
+    for (int ItemN = 0; ItemN < ItemV.Len(); ItemN++) {
+        const uint64 RecId = (uint64)ItemV[ItemN].Key;
+        // only sorted vectors can be delta encoded
+        if (ItemN > 0 && RecId < PrevRecId) { return false; }
+        TGixVarInt::Save(RecId - PrevRecId, Mem);
+        TGixVarInt::Save(TGixVarInt::GetZigZag((int64)ItemV[ItemN].Dat), Mem);
+        PrevRecId = RecId;
+    }
+    return true;
+}
+
+template <class TQmGixItem>
+void TIndex::TQmGixSumItemHandler<TQmGixItem>::Decode(const TMem& Mem, const int& Items, TVec<TQmGixItem>& ItemV) const {
+    ItemV.Gen(Items, 0); int BfC = 0; uint64 RecId = 0;
+    for (int ItemN = 0; ItemN < Items; ItemN++) {
+        RecId += TGixVarInt::Load(Mem, BfC);
+        const int64 Fq = TGixVarInt::GetUnZigZag(TGixVarInt::Load(Mem, BfC));
+        ItemV.Add(TQmGixItem(RecId, Fq));
+    }
+}
+
+///////////////////////////////
+/// QMiner Index Item Handler
+template <class TQmGixItem>
+bool TIndex::TQmGixDefItemHandler<TQmGixItem>::Encode(const TVec<TQmGixItem>& ItemV, TMem& Mem) const {
+    uint64 PrevRecId = 0;
+    for (int ItemN = 0; ItemN < ItemV.Len(); ItemN++) {
+        const uint64 RecId = (uint64)ItemV[ItemN];
+        // only sorted vectors can be delta encoded
+        if (ItemN > 0 && RecId < PrevRecId) { return false; }
+        TGixVarInt::Save(RecId - PrevRecId, Mem);
+        PrevRecId = RecId;
+    }
+    return true;
+}
+
+template <class TQmGixItem>
+void TIndex::TQmGixDefItemHandler<TQmGixItem>::Decode(const TMem& Mem, const int& Items, TVec<TQmGixItem>& ItemV) const {
+    ItemV.Gen(Items, 0); int BfC = 0; uint64 RecId = 0;
+    for (int ItemN = 0; ItemN < Items; ItemN++) {
+        RecId += TGixVarInt::Load(Mem, BfC);
+        ItemV.Add(TQmGixItem(RecId));
+    }
+}
+
 ///////////////////////////////
 /// QMiner Index Frequency Summation Merger
 template <class TQmGixItem, class TQmGixResItem>
@@ -130,8 +321,8 @@ void TIndex::TQmGixSumMerger<TQmGixItem, TQmGixResItem>::Intrs(
     while ((ValN1 < MainV.Len()) && (ValN2 < JoinV.Len())) {
         const TQmGixResItem& Val1 = MainV.GetVal(ValN1);
         const TQmGixResItem& Val2 = JoinV.GetVal(ValN2);
-        if (Val1 < Val2) { ValN1++; }
-        else if (Val1 > Val2) { ValN2++; }
+        if (Val1 < Val2) { ValN1 = TGixGallop::GetLowerBoundN(MainV, ValN1 + 1, Val2); }
+        else if (Val1 > Val2) { ValN2 = TGixGallop::GetLowerBoundN(JoinV, ValN2 + 1, Val1); }
         else { ResV.Add(TQmGixResItem(Val1.Key, Val1.Dat + Val2.Dat)); ValN1++; ValN2++; }
     }
     MainV = ResV;
@@ -152,6 +152,28 @@ void TFtrSpace::Init() {
         DimV.Add(FtrExtDim); Dim += FtrExtDim;
     }   
 }
+
+const int TFtrSpace::ExtractChunkSize = 1000;
+
+int TFtrSpace::GetExtractThreads(const PRecSet& RecSet, const int& FtrExtN) const {
+#ifdef GLib_OPENMP
+    // not worth the overhead for small record sets
+    const int Chunks = (RecSet->GetRecs() + ExtractChunkSize - 1) / ExtractChunkSize;
+    if (Chunks < 2) { return 1; }
+    // all feature extractors involved must support concurrent extraction
+    for (int _FtrExtN = 0; _FtrExtN < FtrExtV.Len(); _FtrExtN++) {
+        if (FtrExtN >= 0 && _FtrExtN != FtrExtN) { continue; }
+        if (!FtrExtV[_FtrExtN]->IsThreadSafe()) { return 1; }
+    }
+    // extractors can join into any store, all must support concurrent reads
+    for (int StoreN = 0; StoreN < Base->GetStores(); StoreN++) {
+        if (!Base->GetStoreByStoreN(StoreN)->IsConcurrentRead()) { return 1; }
+    }
+    return TInt::GetMn(omp_get_max_threads(), Chunks);
+#else
+    return 1;
+#endif
+}
     
 TFtrSpace::TFtrSpace(const TWPt<TBase>& _Base, const PFtrExt& FtrExt): 
     Base(_Base), FtrExtV(TFtrExtV::GetV(FtrExt)) { Init(); }
@@ -295,41 +317,89 @@ void TFtrSpace::GetFullV(const TRec& Rec, TFltV& FullV, const int& FtrExtN) cons
 }
 
 void TFtrSpace::GetSpVV(const PRecSet& RecSet, TVec<TIntFltKdV>& SpVV, const int& FtrExtN) const {
-    TEnv::Logger->OnStatusFmt("Creating sparse feature vectors from %d records", RecSet->GetRecs());
-    for (int RecN = 0; RecN < RecSet->GetRecs(); RecN++) {
-        if (RecN % 10000 == 0) { TEnv::Logger->OnStatusFmt("%d\r", RecN); }
-        SpVV.Add(TIntFltKdV()); GetSpV(RecSet->GetRec(RecN), SpVV.Last(), FtrExtN);
+    const int Recs = RecSet->GetRecs();
+    TEnv::Logger->OnStatusFmt("Creating sparse feature vectors from %d records", Recs);
+    // prepare space for all the records, new vectors are appended to existing ones
+    const int FirstRecN = SpVV.Len(); SpVV.Reserve(FirstRecN + Recs);
+    for (int RecN = 0; RecN < Recs; RecN++) { SpVV.Add(TIntFltKdV()); }
+    // extract chunks of records, each chunk writes into its own range of vectors
+    const int Threads = GetExtractThreads(RecSet, FtrExtN);
+    const int Chunks = (Recs + ExtractChunkSize - 1) / ExtractChunkSize;
+    PExcept Except;
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(Threads) if (Threads > 1)
+    for (int ChunkN = 0; ChunkN < Chunks; ChunkN++) {
+        const int MnRecN = ChunkN * ExtractChunkSize;
+        const int MxRecN = TInt::GetMn(MnRecN + ExtractChunkSize, Recs);
+        if (Threads == 1 && MnRecN % 10000 == 0) { TEnv::Logger->OnStatusFmt("%d\r", MnRecN); }
+        try {
+            for (int RecN = MnRecN; RecN < MxRecN; RecN++) {
+                GetSpV(RecSet->GetRec(RecN), SpVV[FirstRecN + RecN], FtrExtN);
+            }
+        } catch (PExcept& _Except) {
+            #pragma omp critical(TFtrSpaceExcept)
+            if (Except.Empty()) { Except = _Except; }
+        }
     }
+    // rethrow first exception
+    if (!Except.Empty()) { throw Except; }
 }
 
 void TFtrSpace::GetFullVV(const PRecSet& RecSet, TVec<TFltV>& FullVV, const int& FtrExtN) const {
-    TEnv::Logger->OnStatusFmt("Creating full feature vectors from %d records", RecSet->GetRecs());
-    for (int RecN = 0; RecN < RecSet->GetRecs(); RecN++) {
-        if (RecN % 10000 == 0) { TEnv::Logger->OnStatusFmt("%d\r", RecN); }
-        FullVV.Add(TFltV()); GetFullV(RecSet->GetRec(RecN), FullVV.Last(), FtrExtN);
+    const int Recs = RecSet->GetRecs();
+    TEnv::Logger->OnStatusFmt("Creating full feature vectors from %d records", Recs);
+    // prepare space for all the records, new vectors are appended to existing ones
+    const int FirstRecN = FullVV.Len(); FullVV.Reserve(FirstRecN + Recs);
+    for (int RecN = 0; RecN < Recs; RecN++) { FullVV.Add(TFltV()); }
+    // extract chunks of records, each chunk writes into its own range of vectors
+    const int Threads = GetExtractThreads(RecSet, FtrExtN);
+    const int Chunks = (Recs + ExtractChunkSize - 1) / ExtractChunkSize;
+    PExcept Except;
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(Threads) if (Threads > 1)
+    for (int ChunkN = 0; ChunkN < Chunks; ChunkN++) {
+        const int MnRecN = ChunkN * ExtractChunkSize;
+        const int MxRecN = TInt::GetMn(MnRecN + ExtractChunkSize, Recs);
+        if (Threads == 1 && MnRecN % 10000 == 0) { TEnv::Logger->OnStatusFmt("%d\r", MnRecN); }
+        try {
+            for (int RecN = MnRecN; RecN < MxRecN; RecN++) {
+                GetFullV(RecSet->GetRec(RecN), FullVV[FirstRecN + RecN], FtrExtN);
+            }
+        } catch (PExcept& _Except) {
+            #pragma omp critical(TFtrSpaceExcept)
+            if (Except.Empty()) { Except = _Except; }
+        }
     }
+    // rethrow first exception
+    if (!Except.Empty()) { throw Except; }
 }
 
 void TFtrSpace::GetFullVV(const PRecSet& RecSet, TFltVV& FullVV, const int& FtrExtN) const {
-    TEnv::Logger->OnStatusFmt("Creating full feature vectors from %d records", RecSet->GetRecs());
-    if (FtrExtN < 0) {
-        FullVV.Gen(GetDim(), RecSet->GetRecs());
-        TFltV Temp(GetDim());
-        for (int RecN = 0; RecN < RecSet->GetRecs(); RecN++) {
-            if (RecN % 10000 == 0) { TEnv::Logger->OnStatusFmt("%d\r", RecN); }
-            GetFullV(RecSet->GetRec(RecN), Temp);
-            FullVV.SetCol(RecN, Temp);
-        }
-    } else {
-        EAssert(FtrExtN < FtrExtV.Len());
-        FullVV.Gen(FtrExtV[FtrExtN]->GetDim(), RecSet->GetRecs());
-        TFltV Temp(FtrExtV[FtrExtN]->GetDim());
-        for (int RecN = 0; RecN < RecSet->GetRecs(); RecN++) {
-            if (RecN % 10000 == 0) { TEnv::Logger->OnStatusFmt("%d\r", RecN); }
-            GetFullV(RecSet->GetRec(RecN), Temp, FtrExtN);
-            FullVV.SetCol(RecN, Temp);
+    const int Recs = RecSet->GetRecs();
+    TEnv::Logger->OnStatusFmt("Creating full feature vectors from %d records", Recs);
+    EAssert(FtrExtN < FtrExtV.Len());
+    const int Dim = (FtrExtN < 0) ? GetDim() : FtrExtV[FtrExtN]->GetDim();
+    // matrix is allocated upfront, each chunk fills its own range of columns
+    FullVV.Gen(Dim, Recs);
+    const int Threads = GetExtractThreads(RecSet, FtrExtN);
+    const int Chunks = (Recs + ExtractChunkSize - 1) / ExtractChunkSize;
+    PExcept Except;
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(Threads) if (Threads > 1)
+    for (int ChunkN = 0; ChunkN < Chunks; ChunkN++) {
+        const int MnRecN = ChunkN * ExtractChunkSize;
+        const int MxRecN = TInt::GetMn(MnRecN + ExtractChunkSize, Recs);
+        if (Threads == 1 && MnRecN % 10000 == 0) { TEnv::Logger->OnStatusFmt("%d\r", MnRecN); }
+        try {
+            TFltV Temp(Dim);
+            for (int RecN = MnRecN; RecN < MxRecN; RecN++) {
+                GetFullV(RecSet->GetRec(RecN), Temp, FtrExtN);
+                FullVV.SetCol(RecN, Temp);
+            }
+        } catch (PExcept& _Except) {
+            #pragma omp critical(TFtrSpaceExcept)
+            if (Except.Empty()) { Except = _Except; }
         }
     }
+    // rethrow first exception
+    if (!Except.Empty()) { throw Except; }
 }
     
 void TFtrSpace::GetCentroidSpV(const PRecSet& RecSet, 
@@ -93,6 +93,9 @@ public:
     virtual void AddSpV(const TRec& Rec, TIntFltKdV& SpV, int& Offset) const = 0;
     /// Attaches features to a given full feature vectors with a given offset
     virtual void AddFullV(const TRec& Rec, TFltV& FullV, int& Offset) const;
+    /// True when AddSpV and AddFullV can be called from several threads at the
+    /// same time. Feature space falls back to sequential extraction otherwise.
+    virtual bool IsThreadSafe() const { return true; }
 
     // deprecated, to be removed
     virtual double __GetVal(const double& InVal) const { printf("__GetVal is DEPRECATED\n"); throw TQmExcept::New("TFtrExt::GetVal not implemented"); };
@@ -143,8 +146,15 @@ private:
     TIntV VarDimFtrExtNV;
     /// Feature extractors composing the feature space
     TFtrExtV FtrExtV;
+
+    /// Number of consecutive records extracted together by one thread
+    static const int ExtractChunkSize;
     
     void Init();
+    /// Number of threads to use for extracting features from the given record set.
+    /// Returns 1 when some of the feature extractors or stores do not support
+    /// concurrent reads or when the record set is too small to be worth it.
+    int GetExtractThreads(const PRecSet& RecSet, const int& FtrExtN) const;
 
     TFtrSpace(const TWPt<TBase>& _Base, const PFtrExt& FtrExt);
     TFtrSpace(const TWPt<TBase>& _Base, const TFtrExtV& _FtrExtV);
@@ -177,11 +187,12 @@ public:
     void GetSpV(const TRec& Rec, TIntFltKdV& SpV, const int& FtrExtN = -1) const;
     /// Extract full feature vector from a record
     void GetFullV(const TRec& Rec, TFltV& FullV, const int& FtrExtN = -1) const;
-    /// Extracting sparse feature vectors from a record set
+    /// Extracting sparse feature vectors from a record set. Records are split into
+    /// chunks which are extracted in parallel when all feature extractors allow it.
     void GetSpVV(const PRecSet& RecSet, TVec<TIntFltKdV>& SpVV, const int& FtrExtN = -1) const;
-    /// Extracting full feature vectors from a record set
+    /// Extracting full feature vectors from a record set, in parallel when possible
     void GetFullVV(const PRecSet& RecSet, TVec<TFltV>& FullVV, const int& FtrExtN = -1) const;
-    /// Extracting full feature vectors (columns) from a record set
+    /// Extracting full feature vectors (columns) from a record set, in parallel when possible
     void GetFullVV(const PRecSet& RecSet, TFltVV& FullVV, const int& FtrExtN = -1) const;
     /// Compute sparse centroid of a given record set
     void GetCentroidSpV(const PRecSet& RecSet, TIntFltKdV& CentroidSpV, const bool& NormalizeP = true) const;
@@ -289,6 +300,8 @@ public:
     bool Update(const TRec& Rec) { return false; }
     void AddSpV(const TRec& Rec, TIntFltKdV& SpV, int& Offset) const;
     void AddFullV(const TRec& Rec, TFltV& FullV, int& Offset) const;
+    /// Random generator is shared between calls
+    bool IsThreadSafe() const { return false; }
 
     // flat feature extraction
     void ExtractFltV(const TRec& FtrRec, TFltV& FltV) const;
@@ -695,6 +708,8 @@ public:
     bool Update(const TRec& FtrRec);
     void AddSpV(const TRec& FtrRec, TIntFltKdV& SpV, int& Offset) const;
     //void AddFullV(const TRec& Rec, TFltV& FullV, int& Offset) const;
+    /// Thread-safe when both combined feature extractors are
+    bool IsThreadSafe() const { return FtrExt1->IsThreadSafe() && FtrExt2->IsThreadSafe(); }
 
     // flat feature extraction
     void ExtractStrV(const TRec& FtrRec, TStrV& StrV) const;
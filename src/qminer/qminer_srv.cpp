@@ -20,6 +20,7 @@ void TSrvFun::RegDefFun(const TWPt<TBase>& Base, TSAppSrvFunV& SrvFunV) {
     SrvFunV.Add(TSfWordVoc::New(Base));
     SrvFunV.Add(TSfStoreRec::New(Base));
     SrvFunV.Add(TSfPartialFlush::New(Base));
+    SrvFunV.Add(TSfStreamAggrStats::New(Base));
 }
 
 ///////////////////////////////////////////
@@ -202,6 +203,12 @@ TStr TSfDebug::ExecJSon(const TStrKdV& FldNmValPrV, const PSAppSrvRqEnv& RqEnv)
     return TJsonVal::GetStrFromVal(TJsonVal::NewObj("Debug", "Done"));
 }
 
+///////////////////////////////////////////
+// QMiner-Server-Function-Stream-Aggregate-Statistics
+TStr TSfStreamAggrStats::ExecJSon(const TStrKdV& FldNmValPrV, const PSAppSrvRqEnv& RqEnv) {
+    return TJsonVal::GetStrFromVal(Base->GetStreamAggrStats());
+}
+
 ///////////////////////////////////////////
 // QMiner-Server-Function-Debug
 TStr TSfPartialFlush::ExecJSon(const TStrKdV& FldNmValPrV, const PSAppSrvRqEnv& RqEnv) {
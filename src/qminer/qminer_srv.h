@@ -108,6 +108,18 @@ public:
     TStr ExecJSon(const TStrKdV& FldNmValPrV, const PSAppSrvRqEnv& RqEnv);
 };
 
+///////////////////////////////////////////
+// QMiner-Server-Function-Stream-Aggregate-Statistics
+//  calls, latencies and memory growth of stream aggregates
+class TSfStreamAggrStats : public TSrvFun {
+private:
+    TSfStreamAggrStats(const TWPt<TBase>& Base) : TSrvFun(Base, "qm_stream_aggr_stats", saotJSon) {}
+public:
+    static PSAppSrvFun New(const TWPt<TBase>& Base) { return new TSfStreamAggrStats(Base); }
+
+    TStr ExecJSon(const TStrKdV& FldNmValPrV, const PSAppSrvRqEnv& RqEnv);
+};
+
 ///////////////////////////////////////////
 // QMiner-Server-Function-PartialFlush
 //  executes partial flush of data from memory to disk
@@ -88,7 +88,7 @@ TFieldDescEx TStoreSchema::ParseFieldDescEx(const PJsonVal& FieldVal) {
     if (FieldVal->IsObjKey("default")) {
         FieldDescEx.DefaultVal = FieldVal->GetObjKey("default");
     }
-    // get storage place (cache or memory)
+    // get storage place (cache, memory or column)
 
     if (FieldVal->IsObjKey("store")) {
         TStr StoreLocStr = FieldVal->GetObjStr("store");
@@ -96,6 +96,8 @@ TFieldDescEx TStoreSchema::ParseFieldDescEx(const PJsonVal& FieldVal) {
             FieldDescEx.FieldStoreLoc = slMemory;
         } else if (StoreLocStr == "cache") {
             FieldDescEx.FieldStoreLoc = slDisk;
+        } else if (StoreLocStr == "column") {
+            FieldDescEx.FieldStoreLoc = slColumn;
         } else {
             throw TQmExcept::New(TStr::Fmt("Unsupported 'store' flag for field: %s", StoreLocStr.CStr()));
         }
@@ -229,6 +231,16 @@ TIndexKeyEx TStoreSchema::ParseIndexKeyEx(const PJsonVal& IndexKeyVal) {
     } else {
         throw TQmExcept::New("Unkown gix storage type '" + StorageStr + "' for field '" + IndexKeyEx.FieldName + "'");
     }
+    // parse out child vector compression (default is none)
+    IndexKeyEx.CompressP = IndexKeyVal->GetObjBool("compress", false);
+    if (IndexKeyEx.CompressP && !(IndexKeyEx.IsValue() || IndexKeyEx.IsText() || IndexKeyEx.IsTextPos())) {
+        throw TQmExcept::New("Compression only possible for inverted index keys and not '" + KeyTypeStr + "'");
+    }
+    // parse out paged linear or location index (default is in memory)
+    IndexKeyEx.PagedP = IndexKeyVal->GetObjBool("paged", false);
+    if (IndexKeyEx.PagedP && !(IndexKeyEx.IsLinear() || IndexKeyEx.IsLocation())) {
+        throw TQmExcept::New("Paging only possible for linear and location index keys and not '" + KeyTypeStr + "'");
+    }
     // check field type and index type match
     if (FieldType == oftStr && IndexKeyEx.IsValue()) {
     } else if (FieldType == oftStr && IndexKeyEx.IsText()) {
@@ -422,6 +434,13 @@ TStoreSchema::TStoreSchema(const TWPt<TBase>& Base, const PJsonVal& StoreVal) :
         // set time duration in milliseconds
         const uint64 FactorMSecs = Maps.TimeWindowUnitMap.GetDat(UnitStr);
         WndDesc.WindowSize = WindowSize * FactorMSecs;
+        // split store into time partitions of given unit, so whole partitions can expire at once
+        if (TimeWindow->IsObjKey("partition")) {
+            TStr PartitionUnitStr = TimeWindow->GetObjStr("partition");
+            QmAssertR(Maps.TimeWindowUnitMap.IsKey(PartitionUnitStr),
+                "Unsupported timeWindow partition unit type: " + PartitionUnitStr);
+            WndDesc.PartitionSize = Maps.TimeWindowUnitMap.GetDat(PartitionUnitStr);
+        }
         // get field giving the tact for time
         if (TimeWindow->IsObjKey("field")) {
             WndDesc.TimeFieldNm = TimeWindow->GetObjStr("field");
@@ -571,19 +590,24 @@ TInMemStorage::TInMemStorage(const TStr& _FNm, const PBlobBs& _BlobStorage, cons
 
 TInMemStorage::~TInMemStorage() {
     if (Access != faRdOnly) {
-        // store dirty vectors
-        for (int i = 0; i < ValV.Len(); i++) {
-            SaveRec(i);
-        }
-        // save vector
-        TFOut FOut(FNm);
-        BlobPtV.Save(FOut);
-        // save rest
-        TInt64(ValV.Len()).Save(FOut);
-        FirstValOffset.Save(FOut);
-        FirstValOffsetMem.Save(FOut);
-        BlockSize.Save(FOut);
+        Save();
+    }
+}
+
+void TInMemStorage::Save() {
+    AssertReadOnly();
+    // store dirty vectors
+    for (int i = 0; i < ValV.Len(); i++) {
+        SaveRec(i);
     }
+    // save vector
+    TFOut FOut(FNm);
+    BlobPtV.Save(FOut);
+    // save rest
+    TInt64(ValV.Len()).Save(FOut);
+    FirstValOffset.Save(FOut);
+    FirstValOffsetMem.Save(FOut);
+    BlockSize.Save(FOut);
 }
 
 /// Utility method for loading specific record
@@ -651,6 +675,12 @@ void TInMemStorage::GetVal(const uint64& ValId, TMem& Val) const {
     Val = ValV[i];
 }
 
+const TMem& TInMemStorage::GetValRef(const uint64& ValId) const {
+    uint64 i = ValId - FirstValOffsetMem;
+    LoadRec(i);
+    return ValV[i];
+}
+
 uint64 TInMemStorage::AddVal(const TMem& Val) {
     uint64 res = ValV.Add(Val);
     DirtyV.Add(isdfNew);
@@ -721,6 +751,405 @@ void TInMemStorage::LoadAll() {
     }
 }
 
+///////////////////////////////
+// Column storage
+TColumnStorage::TColumn::TColumn(const int& _FieldId, const TFieldDesc& FieldDesc, const PJsonVal& _DefaultVal):
+    FieldId(_FieldId), FieldNm(FieldDesc.GetFieldNm()), FieldType((int)FieldDesc.GetFieldType()),
+    NullableP(FieldDesc.IsNullable()), DefaultVal(_DefaultVal) { }
+
+void TColumnStorage::TColumn::Load(TSIn& SIn) {
+    FieldId.Load(SIn);
+    FieldNm.Load(SIn);
+    FieldType.Load(SIn);
+    NullableP.Load(SIn);
+    DefaultVal = PJsonVal(SIn);
+    IntV.Load(SIn);
+    UInt64V.Load(SIn);
+    FltV.Load(SIn);
+    NullV.Load(SIn);
+}
+
+void TColumnStorage::TColumn::Save(TSOut& SOut) const {
+    FieldId.Save(SOut);
+    FieldNm.Save(SOut);
+    FieldType.Save(SOut);
+    NullableP.Save(SOut);
+    DefaultVal.Save(SOut);
+    IntV.Save(SOut);
+    UInt64V.Save(SOut);
+    FltV.Save(SOut);
+    NullV.Save(SOut);
+}
+
+bool TColumnStorage::TColumn::IsInt() const {
+    return FieldType == oftByte || FieldType == oftInt || FieldType == oftInt16 || FieldType == oftInt64 ||
+        FieldType == oftUInt || FieldType == oftUInt16 || FieldType == oftBool;
+}
+
+bool TColumnStorage::TColumn::IsUInt64() const {
+    return FieldType == oftUInt64 || FieldType == oftTm;
+}
+
+bool TColumnStorage::TColumn::IsFlt() const {
+    return FieldType == oftFlt || FieldType == oftSFlt;
+}
+
+void TColumnStorage::TColumn::AddVal() {
+    if (IsInt()) { IntV.Add(0); }
+    else if (IsUInt64()) { UInt64V.Add(0); }
+    else { FltV.Add(0.0); }
+    NullV.Add(false);
+    DirtyP = true;
+}
+
+void TColumnStorage::TColumn::DelVals(const int64& Vals) {
+    if (Vals <= 0) { return; }
+    if (IsInt()) { IntV.Del(0, Vals - 1); }
+    else if (IsUInt64()) { UInt64V.Del(0, Vals - 1); }
+    else { FltV.Del(0, Vals - 1); }
+    NullV.Del(0, Vals - 1);
+    DirtyP = true;
+}
+
+void TColumnStorage::TColumn::Trunc(const int64& Vals) {
+    if (IsInt()) { IntV.Trunc(Vals); }
+    else if (IsUInt64()) { UInt64V.Trunc(Vals); }
+    else { FltV.Trunc(Vals); }
+    NullV.Trunc(Vals);
+}
+
+void TColumnStorage::TColumn::SetJsonVal(const int64& ValN, const PJsonVal& JsonVal) {
+    DirtyP = true;
+    if (JsonVal->IsNull()) {
+        // we are setting field explicitly to null
+        QmAssertR(NullableP, "Non-nullable field " + FieldNm + " set to null");
+        NullV[ValN] = true;
+        return;
+    }
+    // parse value the same way as record serializator
+    switch (FieldType) {
+    case oftByte:
+        QmAssertR(JsonVal->IsNum(), "Provided JSon data field " + FieldNm + " is not numeric.");
+        IntV[ValN] = (int64)(uchar)JsonVal->GetUInt64();
+        break;
+    case oftInt:
+        QmAssertR(JsonVal->IsNum(), "Provided JSon data field " + FieldNm + " is not numeric.");
+        IntV[ValN] = (int64)JsonVal->GetInt();
+        break;
+    case oftInt16:
+        QmAssertR(JsonVal->IsNum(), "Provided JSon data field " + FieldNm + " is not numeric.");
+        IntV[ValN] = (int64)(int16)JsonVal->GetInt();
+        break;
+    case oftInt64:
+        QmAssertR(JsonVal->IsNum(), "Provided JSon data field " + FieldNm + " is not numeric.");
+        IntV[ValN] = (int64)JsonVal->GetNum();
+        break;
+    case oftUInt:
+        QmAssertR(JsonVal->IsNum(), "Provided JSon data field " + FieldNm + " is not numeric.");
+        IntV[ValN] = (int64)(uint)JsonVal->GetUInt64();
+        break;
+    case oftUInt16:
+        QmAssertR(JsonVal->IsNum(), "Provided JSon data field " + FieldNm + " is not numeric.");
+        IntV[ValN] = (int64)(uint16)JsonVal->GetUInt64();
+        break;
+    case oftBool:
+        QmAssertR(JsonVal->IsBool(), "Provided JSon data field " + FieldNm + " is not boolean.");
+        IntV[ValN] = JsonVal->GetBool() ? 1 : 0;
+        break;
+    case oftUInt64:
+        QmAssertR(JsonVal->IsNum(), "Provided JSon data field " + FieldNm + " is not numeric.");
+        UInt64V[ValN] = JsonVal->GetUInt64();
+        break;
+    case oftTm:
+        QmAssertR(JsonVal->IsStr() || JsonVal->IsNum(), "Provided JSon data field " + FieldNm +
+            " is not a number or a string that represents DateTime.");
+        if (JsonVal->IsStr()) {
+            TTm Tm = TTm::GetTmFromWebLogDateTimeStr(JsonVal->GetStr(), '-', ':', '.', 'T');
+            UInt64V[ValN] = TTm::GetMSecsFromTm(Tm);
+        } else {
+            UInt64V[ValN] = TTm::GetWinMSecsFromUnixMSecs(JsonVal->GetInt64());
+        }
+        break;
+    case oftFlt:
+        QmAssertR(JsonVal->IsNum(), "Provided JSon data field " + FieldNm + " is not numeric.");
+        FltV[ValN] = JsonVal->GetNum();
+        break;
+    case oftSFlt:
+        QmAssertR(JsonVal->IsNum(), "Provided JSon data field " + FieldNm + " is not numeric.");
+        FltV[ValN] = (double)(float)JsonVal->GetNum();
+        break;
+    default:
+        throw TQmExcept::New("Unsupported JSon data type for column storage: " + FieldNm);
+    }
+    NullV[ValN] = false;
+}
+
+void TColumnStorage::TColumn::SetBatchVal(const int64& ValN, const TRecBatch& RecBatch, const int& RecN) {
+    DirtyP = true;
+    switch (FieldType) {
+    case oftByte: IntV[ValN] = (int64)(uchar)RecBatch.GetFieldInt(FieldId, RecN); break;
+    case oftInt: IntV[ValN] = (int64)(int)RecBatch.GetFieldInt(FieldId, RecN); break;
+    case oftInt16: IntV[ValN] = (int64)(int16)RecBatch.GetFieldInt(FieldId, RecN); break;
+    case oftInt64: IntV[ValN] = RecBatch.GetFieldInt(FieldId, RecN); break;
+    case oftUInt: IntV[ValN] = (int64)(uint)RecBatch.GetFieldInt(FieldId, RecN); break;
+    case oftUInt16: IntV[ValN] = (int64)(uint16)RecBatch.GetFieldInt(FieldId, RecN); break;
+    case oftBool: IntV[ValN] = (RecBatch.GetFieldInt(FieldId, RecN) != 0) ? 1 : 0; break;
+    case oftUInt64: UInt64V[ValN] = RecBatch.GetFieldUInt64(FieldId, RecN); break;
+    case oftTm: UInt64V[ValN] = RecBatch.GetFieldTmMSecs(FieldId, RecN); break;
+    case oftFlt: FltV[ValN] = RecBatch.GetFieldFlt(FieldId, RecN); break;
+    case oftSFlt: FltV[ValN] = (double)(float)RecBatch.GetFieldFlt(FieldId, RecN); break;
+    default: throw TQmExcept::New("Unsupported batch data type for column storage: " + FieldNm);
+    }
+    NullV[ValN] = false;
+}
+
+TColumnStorage::~TColumnStorage() {
+    if (Access != faRdOnly) { Save(); }
+}
+
+bool TColumnStorage::IsFieldType(const TFieldDesc& FieldDesc) {
+    return FieldDesc.IsByte() || FieldDesc.IsInt() || FieldDesc.IsInt16() || FieldDesc.IsInt64() ||
+        FieldDesc.IsUInt() || FieldDesc.IsUInt16() || FieldDesc.IsUInt64() || FieldDesc.IsBool() ||
+        FieldDesc.IsFlt() || FieldDesc.IsSFlt() || FieldDesc.IsTm();
+}
+
+void TColumnStorage::AssertReadOnly() const {
+    QmAssertR(((Access == faCreate) || (Access == faUpdate)), FNm + " opened in Read-Only mode!");
+}
+
+void TColumnStorage::AddField(const int& FieldId, const TFieldDesc& FieldDesc, const PJsonVal& DefaultVal) {
+    QmAssertR(IsFieldType(FieldDesc), "Field " + FieldDesc.GetFieldNm() + " of type " +
+        FieldDesc.GetFieldTypeStr() + " cannot be stored in a column");
+    QmAssertR(Len() == 0, "Columns can be added only to empty column storage");
+    while (FieldIdColNV.Len() <= FieldId) { FieldIdColNV.Add(-1); }
+    FieldIdColNV[FieldId] = ColV.Add(TColumn(FieldId, FieldDesc, DefaultVal));
+    // new columns have no file yet
+    ColV.Last().DirtyP = true;
+}
+
+void TColumnStorage::LoadField(const int& FieldId, const TStr& FieldNm) {
+    TFIn FIn(GetColFNm(FieldNm));
+    // all columns start with the same record
+    FirstValId.Load(FIn);
+    TColumn Col(FIn);
+    QmAssertR(Col.FieldId == FieldId, "Column file " + GetColFNm(FieldNm) + " does not match the field");
+    while (FieldIdColNV.Len() <= FieldId) { FieldIdColNV.Add(-1); }
+    FieldIdColNV[FieldId] = ColV.Add(Col);
+    QmAssertR(ColV.Last().Len() == ColV[0].Len(), "Column file " + GetColFNm(FieldNm) + " has wrong length");
+}
+
+bool TColumnStorage::IsValId(const uint64& ValId) const {
+    return (ValId >= FirstValId) && (ValId < FirstValId + Len());
+}
+
+void TColumnStorage::UndoAddVal(const int64& ValN) {
+    for (int ColN = 0; ColN < ColV.Len(); ColN++) {
+        ColV[ColN].Trunc(ValN);
+    }
+}
+
+uint64 TColumnStorage::AddVal(const PJsonVal& RecVal) {
+    AssertReadOnly();
+    const int64 ValN = (int64)Len();
+    try {
+        for (int ColN = 0; ColN < ColV.Len(); ColN++) {
+            TColumn& Col = ColV[ColN];
+            Col.AddVal();
+            if (RecVal->IsObjKey(Col.FieldNm)) {
+                Col.SetJsonVal(ValN, RecVal->GetObjKey(Col.FieldNm));
+            } else if (!Col.DefaultVal.Empty()) {
+                Col.SetJsonVal(ValN, Col.DefaultVal);
+            } else if (Col.NullableP) {
+                Col.NullV[ValN] = true;
+            } else {
+                throw TQmExcept::New("JSon data is missing field - expecting " + Col.FieldNm);
+            }
+        }
+    } catch (const PExcept&) {
+        UndoAddVal(ValN);
+        throw;
+    }
+    return FirstValId + (uint64)ValN;
+}
+
+uint64 TColumnStorage::AddVal(const TRecBatch& RecBatch, const int& RecN) {
+    AssertReadOnly();
+    const int64 ValN = (int64)Len();
+    try {
+        for (int ColN = 0; ColN < ColV.Len(); ColN++) {
+            TColumn& Col = ColV[ColN];
+            Col.AddVal();
+            if (RecBatch.IsField(Col.FieldId) && !RecBatch.IsFieldNull(Col.FieldId, RecN)) {
+                Col.SetBatchVal(ValN, RecBatch, RecN);
+            } else if (!RecBatch.IsField(Col.FieldId) && !Col.DefaultVal.Empty()) {
+                Col.SetJsonVal(ValN, Col.DefaultVal);
+            } else if (Col.NullableP) {
+                Col.NullV[ValN] = true;
+            } else {
+                throw TQmExcept::New("Record batch is missing field - expecting " + Col.FieldNm);
+            }
+        }
+    } catch (const PExcept&) {
+        UndoAddVal(ValN);
+        throw;
+    }
+    return FirstValId + (uint64)ValN;
+}
+
+void TColumnStorage::SetVal(const uint64& ValId, const PJsonVal& RecVal) {
+    AssertReadOnly();
+    const int64 ValN = GetValN(ValId);
+    for (int ColN = 0; ColN < ColV.Len(); ColN++) {
+        TColumn& Col = ColV[ColN];
+        if (RecVal->IsObjKey(Col.FieldNm)) {
+            Col.SetJsonVal(ValN, RecVal->GetObjKey(Col.FieldNm));
+        }
+    }
+}
+
+void TColumnStorage::DelVals(const int& Vals) {
+    if (Vals <= 0 || Empty()) { return; }
+    AssertReadOnly();
+    const int64 DelVals = TMath::Mn((int64)Vals, (int64)Len());
+    for (int ColN = 0; ColN < ColV.Len(); ColN++) {
+        ColV[ColN].DelVals(DelVals);
+    }
+    FirstValId += (uint64)DelVals;
+}
+
+void TColumnStorage::DelLastVal() {
+    AssertReadOnly();
+    QmAssertR(Len() > 0, "No records in column storage");
+    UndoAddVal((int64)Len() - 1);
+}
+
+uint64 TColumnStorage::Len() const {
+    return ColV.Empty() ? 0 : (uint64)ColV[0].Len();
+}
+
+bool TColumnStorage::IsFieldNull(const uint64& ValId, const int& FieldId) const {
+    return GetCol(FieldId).NullV[GetValN(ValId)];
+}
+
+int64 TColumnStorage::GetFieldInt64(const uint64& ValId, const int& FieldId) const {
+    const TColumn& Col = GetCol(FieldId);
+    QmAssertR(Col.IsInt(), "Column " + Col.FieldNm + " is not integer");
+    return Col.IntV[GetValN(ValId)];
+}
+
+uint64 TColumnStorage::GetFieldUInt64(const uint64& ValId, const int& FieldId) const {
+    const TColumn& Col = GetCol(FieldId);
+    QmAssertR(Col.IsUInt64(), "Column " + Col.FieldNm + " is not uint64 or time");
+    return Col.UInt64V[GetValN(ValId)];
+}
+
+double TColumnStorage::GetFieldFlt(const uint64& ValId, const int& FieldId) const {
+    const TColumn& Col = GetCol(FieldId);
+    QmAssertR(Col.IsFlt(), "Column " + Col.FieldNm + " is not numeric");
+    return Col.FltV[GetValN(ValId)];
+}
+
+void TColumnStorage::GetFieldInt64Block(const TUInt64V& ValIdV, const int& FieldId,
+        TVec<TInt64>& ValV, TBoolV& NullV) const {
+
+    const TColumn& Col = GetCol(FieldId);
+    QmAssertR(Col.IsInt(), "Column " + Col.FieldNm + " is not integer");
+    ValV.Gen(ValIdV.Len()); NullV.Gen(ValIdV.Len());
+    for (int ValN = 0; ValN < ValIdV.Len(); ValN++) {
+        const int64 ColValN = GetValN(ValIdV[ValN]);
+        ValV[ValN] = Col.IntV[ColValN];
+        NullV[ValN] = Col.NullV[ColValN];
+    }
+}
+
+void TColumnStorage::GetFieldUInt64Block(const TUInt64V& ValIdV, const int& FieldId,
+        TUInt64V& ValV, TBoolV& NullV) const {
+
+    const TColumn& Col = GetCol(FieldId);
+    QmAssertR(Col.IsUInt64(), "Column " + Col.FieldNm + " is not uint64 or time");
+    ValV.Gen(ValIdV.Len()); NullV.Gen(ValIdV.Len());
+    for (int ValN = 0; ValN < ValIdV.Len(); ValN++) {
+        const int64 ColValN = GetValN(ValIdV[ValN]);
+        ValV[ValN] = Col.UInt64V[ColValN];
+        NullV[ValN] = Col.NullV[ColValN];
+    }
+}
+
+void TColumnStorage::GetFieldFltBlock(const TUInt64V& ValIdV, const int& FieldId,
+        TFltV& ValV, TBoolV& NullV) const {
+
+    const TColumn& Col = GetCol(FieldId);
+    QmAssertR(Col.IsFlt(), "Column " + Col.FieldNm + " is not numeric");
+    ValV.Gen(ValIdV.Len()); NullV.Gen(ValIdV.Len());
+    for (int ValN = 0; ValN < ValIdV.Len(); ValN++) {
+        const int64 ColValN = GetValN(ValIdV[ValN]);
+        ValV[ValN] = Col.FltV[ColValN];
+        NullV[ValN] = Col.NullV[ColValN];
+    }
+}
+
+void TColumnStorage::SetFieldNull(const uint64& ValId, const int& FieldId) {
+    AssertReadOnly();
+    TColumn& Col = GetCol(FieldId);
+    QmAssertR(Col.NullableP, "Non-nullable field " + Col.FieldNm + " set to null");
+    Col.NullV[GetValN(ValId)] = true;
+    Col.DirtyP = true;
+}
+
+void TColumnStorage::SetFieldInt64(const uint64& ValId, const int& FieldId, const int64& Int64) {
+    AssertReadOnly();
+    TColumn& Col = GetCol(FieldId);
+    QmAssertR(Col.IsInt(), "Column " + Col.FieldNm + " is not integer");
+    Col.IntV[GetValN(ValId)] = Int64;
+    Col.NullV[GetValN(ValId)] = false;
+    Col.DirtyP = true;
+}
+
+void TColumnStorage::SetFieldUInt64(const uint64& ValId, const int& FieldId, const uint64& UInt64) {
+    AssertReadOnly();
+    TColumn& Col = GetCol(FieldId);
+    QmAssertR(Col.IsUInt64(), "Column " + Col.FieldNm + " is not uint64 or time");
+    Col.UInt64V[GetValN(ValId)] = UInt64;
+    Col.NullV[GetValN(ValId)] = false;
+    Col.DirtyP = true;
+}
+
+void TColumnStorage::SetFieldFlt(const uint64& ValId, const int& FieldId, const double& Flt) {
+    AssertReadOnly();
+    TColumn& Col = GetCol(FieldId);
+    QmAssertR(Col.IsFlt(), "Column " + Col.FieldNm + " is not numeric");
+    Col.FltV[GetValN(ValId)] = Flt;
+    Col.NullV[GetValN(ValId)] = false;
+    Col.DirtyP = true;
+}
+
+void TColumnStorage::SaveCol(TColumn& Col) {
+    TFOut FOut(GetColFNm(Col.FieldNm));
+    FirstValId.Save(FOut);
+    Col.Save(FOut);
+    Col.DirtyP = false;
+}
+
+void TColumnStorage::Save() {
+    for (int ColN = 0; ColN < ColV.Len(); ColN++) {
+        SaveCol(ColV[ColN]);
+    }
+}
+
+int TColumnStorage::PartialFlush(int WndInMsec) {
+    if (Access == faRdOnly) { return 0; }
+    TTmStopWatch sw(true);
+    int res = 0;
+    for (int ColN = 0; ColN < ColV.Len(); ColN++) {
+        if (sw.GetMSecInt() > WndInMsec)
+            break;
+        if (!ColV[ColN].DirtyP) { continue; }
+        SaveCol(ColV[ColN]);
+        res++;
+    }
+    return res;
+}
+
 ///////////////////////////////
 // Field serialization parameters
 void TRecSerializator::TFieldSerialDesc::Save(TSOut& SOut) const {
@@ -1361,6 +1790,67 @@ void TRecSerializator::SetVarJsonVal(TMem& RecMem, TMOut& SOut,
     }
 }
 
+void TRecSerializator::SetFixedBatchVal(TMem& RecMem, const TFieldSerialDesc& FieldSerialDesc,
+        const TFieldDesc& FieldDesc, const TRecBatch& RecBatch, const int& RecN) {
+
+    const int FieldId = FieldSerialDesc.FieldId;
+    // call type-appropriate setter, batch already checked the column types
+    switch (FieldDesc.GetFieldType()) {
+    case oftByte:
+        SetFieldByte(RecMem, FieldSerialDesc, (uchar)RecBatch.GetFieldInt(FieldId, RecN));
+        break;
+    case oftInt:
+        SetFieldInt(RecMem, FieldSerialDesc, (int)RecBatch.GetFieldInt(FieldId, RecN));
+        break;
+    case oftInt16:
+        SetFieldInt16(RecMem, FieldSerialDesc, (int16)RecBatch.GetFieldInt(FieldId, RecN));
+        break;
+    case oftInt64:
+        SetFieldInt64(RecMem, FieldSerialDesc, RecBatch.GetFieldInt(FieldId, RecN));
+        break;
+    case oftUInt:
+        SetFieldUInt(RecMem, FieldSerialDesc, (uint)RecBatch.GetFieldInt(FieldId, RecN));
+        break;
+    case oftUInt16:
+        SetFieldUInt16(RecMem, FieldSerialDesc, (uint16)RecBatch.GetFieldInt(FieldId, RecN));
+        break;
+    case oftUInt64:
+        SetFieldUInt64(RecMem, FieldSerialDesc, RecBatch.GetFieldUInt64(FieldId, RecN));
+        break;
+    case oftStr:
+        // this string should be encoded using a codebook
+        SetFieldStr(RecMem, FieldSerialDesc, RecBatch.GetFieldStr(FieldId, RecN));
+        break;
+    case oftBool:
+        SetFieldBool(RecMem, FieldSerialDesc, RecBatch.GetFieldInt(FieldId, RecN) != 0);
+        break;
+    case oftFlt:
+        SetFieldFlt(RecMem, FieldSerialDesc, RecBatch.GetFieldFlt(FieldId, RecN));
+        break;
+    case oftSFlt:
+        SetFieldSFlt(RecMem, FieldSerialDesc, (float)RecBatch.GetFieldFlt(FieldId, RecN));
+        break;
+    case oftTm:
+        SetFieldTmMSecs(RecMem, FieldSerialDesc, RecBatch.GetFieldTmMSecs(FieldId, RecN));
+        break;
+    default:
+        throw TQmExcept::New("Unsupported record batch data type for DB storage (fixed part): " + FieldDesc.GetFieldTypeStr());
+    }
+}
+
+void TRecSerializator::SetVarBatchVal(TMem& RecMem, TMOut& SOut, const TFieldSerialDesc& FieldSerialDesc,
+        const TFieldDesc& FieldDesc, const TRecBatch& RecBatch, const int& RecN) {
+
+    // only strings can be passed through a batch in the variable part
+    switch (FieldDesc.GetFieldType()) {
+    case oftStr:
+        SetFieldStr(RecMem, SOut, FieldSerialDesc, RecBatch.GetFieldStr(FieldSerialDesc.FieldId, RecN));
+        break;
+    default:
+        throw TQmExcept::New("Unsupported record batch data type for DB storage (variable part) - " + FieldDesc.GetFieldTypeStr());
+    }
+}
+
 void TRecSerializator::CopyFieldVar(const TMemBase& InRecMem, TMem& FixedMem,
         TMOut& VarSOut, const TFieldSerialDesc& FieldSerialDesc) {
 
@@ -1563,6 +2053,51 @@ void TRecSerializator::Serialize(const PJsonVal& RecVal, TMem& RecMem, const TWP
     Merge(FixedMem, VarSOut, RecMem);
 }
 
+void TRecSerializator::Serialize(const TRecBatch& RecBatch, const int& RecN,
+        TMem& RecMem, const TWPt<TStore>& Store) {
+
+    // Reserve fixed space - null map, fixed fields and var-field indexes
+    TMem FixedMem(VarContentPartOffset);
+    // Overwrite fixed part with zeros to start with
+    FixedMem.GenZeros(VarContentPartOffset);
+    // Prepare output stream for storing variable width values
+    TMOut VarSOut;
+
+    // iterate over fields and serialize them
+    for (int FieldSerialDescId = 0; FieldSerialDescId < FieldSerialDescV.Len(); FieldSerialDescId++) {
+        const TFieldSerialDesc& FieldSerialDesc = FieldSerialDescV[FieldSerialDescId];
+        const TFieldDesc& FieldDesc = Store->GetFieldDesc(FieldSerialDesc.FieldId);
+        if (RecBatch.IsField(FieldSerialDesc.FieldId) && !RecBatch.IsFieldNull(FieldSerialDesc.FieldId, RecN)) {
+            // value given in the batch
+            if (FieldSerialDesc.FixedPartP) {
+                SetFixedBatchVal(FixedMem, FieldSerialDesc, FieldDesc, RecBatch, RecN);
+            } else {
+                SetVarBatchVal(FixedMem, VarSOut, FieldSerialDesc, FieldDesc, RecBatch, RecN);
+            }
+        } else if (!RecBatch.IsField(FieldSerialDesc.FieldId) && !FieldSerialDesc.DefaultVal.Empty()) {
+            // use the provided default value, same as for JSon records
+            if (FieldSerialDesc.FixedPartP) {
+                SetFixedJsonVal(FixedMem, FieldSerialDesc, FieldDesc, FieldSerialDesc.DefaultVal);
+            } else {
+                SetVarJsonVal(FixedMem, VarSOut, FieldSerialDesc, FieldDesc, FieldSerialDesc.DefaultVal);
+            }
+        } else if (FieldDesc.IsNullable()) {
+            // value not provided or explicitly null
+            SetFieldNull(FixedMem, FieldSerialDesc, true);
+            // update variable-length index to point to the end of stream
+            if (!FieldSerialDesc.FixedPartP) {
+                SetLocationVar(FixedMem, FieldSerialDesc, VarSOut.Len());
+            }
+        } else {
+            // report missing field value since no other option available
+            throw TQmExcept::New("Record batch is missing field - expecting " + FieldDesc.GetFieldNm() + ", store " + Store->GetStoreNm());
+        }
+    }
+
+    // merge fixed and variable parts for final result
+    Merge(FixedMem, VarSOut, RecMem);
+}
+
 void TRecSerializator::SerializeUpdateInPlace(const PJsonVal& RecVal,
     TThinMIn MIn, const TWPt<TStore>& Store, TIntSet& ChangedFieldIdSet) {
 
@@ -1840,6 +2375,83 @@ PJsonVal TRecSerializator::GetFieldJsonVal(TThinMIn& min, const int& FieldId) co
     }
 }
 
+void TRecSerializator::GetFieldInt64Block(const TVec<char*>& RecBfV,
+        const TFieldDesc& FieldDesc, TVec<TInt64>& ValV, TBoolV& NullV) const {
+
+    const TFieldType FieldType = FieldDesc.GetFieldType();
+    const TFieldSerialDesc& FieldSerialDesc = GetFieldSerialDesc(FieldDesc.GetFieldId());
+    QmAssertR(FieldSerialDesc.FixedPartP, "Block field getter supports only fixed-width fields");
+    QmAssertR(FieldType == oftByte || FieldType == oftInt || FieldType == oftInt16 || FieldType == oftInt64 ||
+        FieldType == oftUInt || FieldType == oftUInt16 || FieldType == oftBool,
+        "Unsupported field type for integer block getter: " + FieldDesc.GetFieldTypeStr());
+    // resolve location of the field once for all records
+    const int NullMapByte = FieldSerialDesc.NullMapByte;
+    const uchar NullMapMask = FieldSerialDesc.NullMapMask;
+    const int ValOffset = FixedPartOffset + FieldSerialDesc.Offset;
+    const int Recs = RecBfV.Len();
+    ValV.Reserve(Recs, Recs); NullV.Reserve(Recs, Recs);
+    for (int RecN = 0; RecN < Recs; RecN++) {
+        const char* Bf = RecBfV[RecN];
+        NullV[RecN] = (((uchar)Bf[NullMapByte] & NullMapMask) != 0);
+        if (NullV[RecN]) { ValV[RecN] = 0; continue; }
+        const char* ValBf = Bf + ValOffset;
+        switch (FieldType) {
+            case oftByte: ValV[RecN] = *((uchar*)ValBf); break;
+            case oftInt: ValV[RecN] = *((int*)ValBf); break;
+            case oftInt16: ValV[RecN] = *((int16*)ValBf); break;
+            case oftInt64: ValV[RecN] = TInt64::GetFromBufSafe(ValBf); break;
+            case oftUInt: ValV[RecN] = *((uint*)ValBf); break;
+            case oftUInt16: ValV[RecN] = *((uint16*)ValBf); break;
+            default: ValV[RecN] = *((bool*)ValBf) ? 1 : 0; break;
+        }
+    }
+}
+
+void TRecSerializator::GetFieldUInt64Block(const TVec<char*>& RecBfV,
+        const TFieldDesc& FieldDesc, TUInt64V& ValV, TBoolV& NullV) const {
+
+    const TFieldType FieldType = FieldDesc.GetFieldType();
+    const TFieldSerialDesc& FieldSerialDesc = GetFieldSerialDesc(FieldDesc.GetFieldId());
+    QmAssertR(FieldSerialDesc.FixedPartP, "Block field getter supports only fixed-width fields");
+    QmAssertR(FieldType == oftUInt64 || FieldType == oftTm,
+        "Unsupported field type for uint64 block getter: " + FieldDesc.GetFieldTypeStr());
+    // resolve location of the field once for all records
+    const int NullMapByte = FieldSerialDesc.NullMapByte;
+    const uchar NullMapMask = FieldSerialDesc.NullMapMask;
+    const int ValOffset = FixedPartOffset + FieldSerialDesc.Offset;
+    const int Recs = RecBfV.Len();
+    ValV.Reserve(Recs, Recs); NullV.Reserve(Recs, Recs);
+    for (int RecN = 0; RecN < Recs; RecN++) {
+        const char* Bf = RecBfV[RecN];
+        NullV[RecN] = (((uchar)Bf[NullMapByte] & NullMapMask) != 0);
+        ValV[RecN] = NullV[RecN] ? (uint64)0 : TUInt64::GetFromBufSafe(Bf + ValOffset);
+    }
+}
+
+void TRecSerializator::GetFieldFltBlock(const TVec<char*>& RecBfV,
+        const TFieldDesc& FieldDesc, TFltV& ValV, TBoolV& NullV) const {
+
+    const TFieldType FieldType = FieldDesc.GetFieldType();
+    const TFieldSerialDesc& FieldSerialDesc = GetFieldSerialDesc(FieldDesc.GetFieldId());
+    QmAssertR(FieldSerialDesc.FixedPartP, "Block field getter supports only fixed-width fields");
+    QmAssertR(FieldType == oftFlt || FieldType == oftSFlt,
+        "Unsupported field type for numeric block getter: " + FieldDesc.GetFieldTypeStr());
+    // resolve location of the field once for all records
+    const int NullMapByte = FieldSerialDesc.NullMapByte;
+    const uchar NullMapMask = FieldSerialDesc.NullMapMask;
+    const int ValOffset = FixedPartOffset + FieldSerialDesc.Offset;
+    const bool SFltP = (FieldType == oftSFlt);
+    const int Recs = RecBfV.Len();
+    ValV.Reserve(Recs, Recs); NullV.Reserve(Recs, Recs);
+    for (int RecN = 0; RecN < Recs; RecN++) {
+        const char* Bf = RecBfV[RecN];
+        NullV[RecN] = (((uchar)Bf[NullMapByte] & NullMapMask) != 0);
+        if (NullV[RecN]) { ValV[RecN] = 0.0; continue; }
+        // do not cast (not portable to ARM)
+        ValV[RecN] = SFltP ? (double)TSFlt::GetFromBufSafe(Bf + ValOffset) : TFlt::GetFromBufSafe(Bf + ValOffset);
+    }
+}
+
 bool TRecSerializator::IsFieldNull(const TMemBase& RecMem, const int& FieldId) const {
     TThinMIn ThinMIn(RecMem);
     return IsFieldNull(ThinMIn, FieldId);
@@ -2781,6 +3393,120 @@ TStoreEmpty::TStoreEmpty(const TWPt<TBase>& _Base, const uint& StoreId, const TS
     }
 }
 
+///////////////////////////////
+/// Record batch insert shared by the stores with native batch support
+template <class TStoreT>
+void TStoreBatch::AddRecBatch(TStoreT& Store, TRecBatch& RecBatch, TUInt64V& RecIdV, const bool& TriggerEvents) {
+    QmAssertR(RecBatch.GetStore()() == &Store, "[TStoreBatch::AddRecBatch] Record batch from another store");
+    // primary field cannot be nullable, so we must have it
+    if (Store.IsPrimaryField()) {
+        QmAssertR(RecBatch.IsField(Store.PrimaryFieldId), "Missing primary field in the record batch: " +
+            Store.GetFieldNm(Store.PrimaryFieldId));
+    }
+    // always add system field that means "inserted_at"
+    bool InsertedAtP = false;
+    if (Store.IsFieldNm(TStoreWndDesc::SysInsertedAtFieldName)) {
+        const int SysFieldId = Store.GetFieldId(TStoreWndDesc::SysInsertedAtFieldName);
+        if (!RecBatch.IsField(SysFieldId)) {
+            TUInt64V InsertedAtV(RecBatch.GetRecs());
+            InsertedAtV.PutAll(TTm::GetMSecsFromTm(TTm::GetCurUniTm()));
+            RecBatch.AddFieldTmMSecs(SysFieldId, InsertedAtV);
+            InsertedAtP = true;
+        }
+    }
+    // log the batch with the insert times, so replay sees the same records
+    TBaseWal::TOp WalOp(Store.GetBase()->GetWal());
+    WalOp.AddRecBatch(Store.GetStoreId(), RecBatch);
+
+    RecIdV.Gen(RecBatch.GetRecs(), 0);
+    // only new records get add triggers, existing ones are handled same as with AddRec
+    TUInt64V NewRecIdV(RecBatch.GetRecs(), 0);
+    // new records are stored first and indexed together, so the inverted index
+    // is updated once per key; serializations are kept until then
+    int IndexedRecs = 0;
+    TVec<TMem> CacheRecMemV(RecBatch.GetRecs()), MemRecMemV(RecBatch.GetRecs());
+    auto IndexNewRecs = [&]() {
+        const int FirstNewRecN = IndexedRecs;
+        const TWPt<TIndex>& Index = Store.GetIndex();
+        Index->StartBatch();
+        try {
+            while (IndexedRecs < NewRecIdV.Len()) {
+                const int NewRecN = IndexedRecs++;
+                Store.IndexBatchRec(NewRecIdV[NewRecN], CacheRecMemV[NewRecN], MemRecMemV[NewRecN]);
+                CacheRecMemV[NewRecN].Clr(); MemRecMemV[NewRecN].Clr();
+            }
+        } catch (...) {
+            // records stored so far stay in the store, so they also stay indexed
+            Index->EndBatch();
+            throw;
+        }
+        Index->EndBatch();
+        // reset field joins not given in the batch, once the records are indexed
+        for (int NewRecN = FirstNewRecN; NewRecN < NewRecIdV.Len(); NewRecN++) {
+            Store.AddJoinRec(NewRecIdV[NewRecN], RecBatch);
+        }
+    };
+    try {
+        for (int RecN = 0; RecN < RecBatch.GetRecs(); RecN++) {
+            // check if primary field points to existing record
+            if (Store.IsPrimaryField()) {
+                const uint64 PrimaryRecId = GetPrimaryRecId(Store, RecBatch, RecN);
+                if (PrimaryRecId != TUInt64::Mx) {
+                    PJsonVal RecVal = RecBatch.GetRecJson(RecN);
+                    if (InsertedAtP) { RecVal->DelObjKey(TStoreWndDesc::SysInsertedAtFieldName); }
+                    // check if we have anything more than primary field, which would require redirect to UpdateRec
+                    if (RecVal->GetObjKeys() > 1) {
+                        // record can be from this batch, so it must be indexed before update
+                        IndexNewRecs();
+                        Store.UpdateRec(PrimaryRecId, RecVal);
+                    }
+                    RecIdV.Add(PrimaryRecId);
+                    continue;
+                }
+            }
+            const int NewRecN = NewRecIdV.Len();
+            const uint64 RecId = Store.AddBatchRec(RecBatch, RecN, CacheRecMemV[NewRecN], MemRecMemV[NewRecN]);
+            // remember value-recordId map when primary field available
+            if (Store.IsPrimaryField()) { Store.SetPrimaryField(RecId); }
+            // track time partitions
+            Store.AddPartitionRec(RecId);
+            RecIdV.Add(RecId); NewRecIdV.Add(RecId);
+        }
+    } catch (...) {
+        // index records which were already stored
+        IndexNewRecs();
+        throw;
+    }
+    IndexNewRecs();
+    // call add triggers
+    if (TriggerEvents) {
+        Store.OnAdd(NewRecIdV);
+    }
+}
+
+template <class TStoreT>
+uint64 TStoreBatch::GetPrimaryRecId(const TStoreT& Store, const TRecBatch& RecBatch, const int& RecN) {
+    const int PrimaryFieldId = Store.PrimaryFieldId;
+    if (Store.PrimaryFieldType == oftStr) {
+        const TStr& FieldVal = RecBatch.GetFieldStr(PrimaryFieldId, RecN);
+        return Store.PrimaryStrIdH.IsKey(FieldVal) ? Store.PrimaryStrIdH.GetDat(FieldVal).Val : TUInt64::Mx;
+    } else if (Store.PrimaryFieldType == oftInt) {
+        const int FieldVal = (int)RecBatch.GetFieldInt(PrimaryFieldId, RecN);
+        return Store.PrimaryIntIdH.IsKey(FieldVal) ? Store.PrimaryIntIdH.GetDat(FieldVal).Val : TUInt64::Mx;
+    } else if (Store.PrimaryFieldType == oftUInt64) {
+        const uint64 FieldVal = RecBatch.GetFieldUInt64(PrimaryFieldId, RecN);
+        return Store.PrimaryUInt64IdH.IsKey(FieldVal) ? Store.PrimaryUInt64IdH.GetDat(FieldVal).Val : TUInt64::Mx;
+    } else if (Store.PrimaryFieldType == oftFlt) {
+        const double FieldVal = RecBatch.GetFieldFlt(PrimaryFieldId, RecN);
+        return Store.PrimaryFltIdH.IsKey(FieldVal) ? Store.PrimaryFltIdH.GetDat(FieldVal).Val : TUInt64::Mx;
+    } else if (Store.PrimaryFieldType == oftTm) {
+        const uint64 FieldVal = RecBatch.GetFieldTmMSecs(PrimaryFieldId, RecN);
+        return Store.PrimaryTmMSecsIdH.IsKey(FieldVal) ? Store.PrimaryTmMSecsIdH.GetDat(FieldVal).Val : TUInt64::Mx;
+    }
+    EAssertR(false, "Unsupported primary-field type");
+    return TUInt64::Mx;
+}
+
 ///////////////////////////////
 /// Implementation of store which can be initialized from a schema.
 void TStoreImpl::InitFieldLocV() {
@@ -2789,6 +3515,8 @@ void TStoreImpl::InitFieldLocV() {
             FieldLocV.Add(slDisk);
         } else if (SerializatorMem->IsFieldId(FieldId)) {
             FieldLocV.Add(slMemory);
+        } else if (DataColumn.IsFieldId(FieldId)) {
+            FieldLocV.Add(slColumn);
         } else {
             throw TQmExcept::New("Unknown storage location for field " +
                 GetFieldNm(FieldId) + " in store " + GetStoreNm());
@@ -2797,12 +3525,13 @@ void TStoreImpl::InitFieldLocV() {
 }
 
 void TStoreImpl::GetRecMem(const TStoreLoc& RecLoc, const uint64& RecId, TMem& Rec) const {
-    if (RecLoc == slDisk) {
-        DataCache.GetVal(RecId, Rec);
-    } else if (RecLoc == slMemory)  {
-        DataMem.GetVal(RecId, Rec);
+    QmAssertR(RecLoc == slDisk || RecLoc == slMemory, "Unknown storage location");
+    if (IsLockedRead()) {
+        // disk cache and lazy loading of in-memory records both modify internal state
+        TLock Lock(RecMemLock);
+        if (RecLoc == slDisk) { DataCache.GetVal(RecId, Rec); } else { DataMem.GetVal(RecId, Rec); }
     } else {
-        throw TQmExcept::New("Unknown storage location");
+        if (RecLoc == slDisk) { DataCache.GetVal(RecId, Rec); } else { DataMem.GetVal(RecId, Rec); }
     }
 }
 
@@ -2810,6 +3539,47 @@ void TStoreImpl::GetRecMem(const uint64& RecId, const int& FieldId, TMem& Rec) c
     GetRecMem(FieldLocV[FieldId], RecId, Rec);
 }
 
+void TStoreImpl::GetRecBfV(const TStoreLoc& RecLoc, const TUInt64V& RecIdV,
+        TVec<TMem>& RecMemV, TVec<char*>& RecBfV) const {
+
+    QmAssertR(RecLoc == slDisk || RecLoc == slMemory, "Unknown storage location");
+    RecBfV.Gen(RecIdV.Len(), 0);
+    if (RecLoc == slMemory && !IsParallelRead()) {
+        // in-memory records are accessed directly, flusher only writes them out
+        // and does not move them, so the lock is needed only while loading
+        if (IsLockedRead()) {
+            TLock Lock(RecMemLock);
+            for (int RecN = 0; RecN < RecIdV.Len(); RecN++) {
+                RecBfV.Add(DataMem.GetValRef(RecIdV[RecN]).GetBf());
+            }
+        } else {
+            for (int RecN = 0; RecN < RecIdV.Len(); RecN++) {
+                RecBfV.Add(DataMem.GetValRef(RecIdV[RecN]).GetBf());
+            }
+        }
+    } else {
+        // copy records to RecMemV, reading them one by one takes the lock when needed
+        RecMemV.Gen(RecIdV.Len());
+        for (int RecN = 0; RecN < RecIdV.Len(); RecN++) {
+            GetRecMem(RecLoc, RecIdV[RecN], RecMemV[RecN]);
+            RecBfV.Add(RecMemV[RecN].GetBf());
+        }
+    }
+}
+
+bool TStoreImpl::IsParallelRead() {
+#ifdef GLib_OPENMP
+    return omp_in_parallel() != 0;
+#else
+    return false;
+#endif
+}
+
+bool TStoreImpl::IsLockedRead() const {
+    // flusher is started and stopped by the thread which reads outside parallel regions
+    return IsParallelRead() || GetBase()->IsFlusher();
+}
+
 void TStoreImpl::PutRecMem(const TStoreLoc& RecLoc, const uint64& RecId, const TMem& Rec) {
     if (RecLoc == slDisk) {
         DataCache.SetVal(RecId, Rec);
@@ -2942,6 +3712,12 @@ void TStoreImpl::InitFromSchema(const TStoreSchema& StoreSchema) {
             PrimaryFieldId = GetFieldId(FieldDesc.GetFieldNm());
             PrimaryFieldType = FieldDesc.GetFieldType();
         }
+        // check if field goes to column storage
+        const TFieldDescEx& FieldDescEx = StoreSchema.FieldExH.GetDat(FieldDesc.GetFieldNm());
+        if (FieldDescEx.FieldStoreLoc == slColumn) {
+            QmAssertR(!FieldDesc.IsPrimary(), "Primary field " + FieldDesc.GetFieldNm() + " cannot be stored in a column");
+            DataColumn.AddField(GetFieldId(FieldDesc.GetFieldNm()), FieldDesc, FieldDescEx.DefaultVal);
+        }
     }
     // create index keys
     TWPt<TIndexVoc> IndexVoc = GetIndex()->GetIndexVoc();
@@ -2949,6 +3725,8 @@ void TStoreImpl::InitFromSchema(const TStoreSchema& StoreSchema) {
         TIndexKeyEx IndexKeyEx = StoreSchema.IndexKeyExV[IndexKeyExN];
         // get associated field
         const int FieldId = GetFieldId(IndexKeyEx.FieldName);
+        // column fields are not part of record serializations used by the indexer
+        QmAssertR(!DataColumn.IsFieldId(FieldId), "Field " + IndexKeyEx.FieldName + " stored in a column cannot be indexed");
         // if we are given vocabulary name, check if we have one with such name already
         const int WordVocId = GetBase()->NewIndexWordVoc(IndexKeyEx.KeyType, IndexKeyEx.WordVocName);
         // create new index key
@@ -2956,6 +3734,10 @@ void TStoreImpl::InitFromSchema(const TStoreSchema& StoreSchema) {
             FieldId, WordVocId, IndexKeyEx.KeyType, IndexKeyEx.GixType, IndexKeyEx.SortType);
         // assign tokenizer to it if we have one
         if (IndexKeyEx.IsTokenizer()) { IndexVoc->PutTokenizer(KeyId, IndexKeyEx.Tokenizer); }
+        // store child vectors compressed if so requested
+        if (IndexKeyEx.CompressP) { IndexVoc->PutCompress(KeyId, true); }
+        // keep linear index nodes on disk if so requested
+        if (IndexKeyEx.PagedP) { IndexVoc->PutPaged(KeyId, true); }
     }
     // prepare serializators for disk and in-memory store
     SerializatorCache = new TRecSerializator(this, this, StoreSchema, slDisk);
@@ -2966,18 +3748,21 @@ void TStoreImpl::InitFromSchema(const TStoreSchema& StoreSchema) {
     RecIndexer = TRecIndexer(GetIndex(), this);
     // remember window parameters
     WndDesc = StoreSchema.WndDesc;
+    Partitions = TStorePartitions(WndDesc.PartitionSize);
 }
 
 void TStoreImpl::InitDataFlags() {
     // go over all the fields and remember if we use in-memory or cache storage
     DataCacheP = false;
     DataMemP = false;
+    DataColumnP = false;
     for (int FieldId = 0; FieldId < GetFields(); FieldId++) {
         DataCacheP = DataCacheP || (FieldLocV[FieldId] == slDisk);
         DataMemP = DataMemP || (FieldLocV[FieldId] == slMemory);
+        DataColumnP = DataColumnP || (FieldLocV[FieldId] == slColumn);
     }
     // at least one must be true, otherwise we have no fields, which is not good
-    EAssert(DataCacheP || DataMemP);
+    EAssert(DataCacheP || DataMemP || DataColumnP);
 }
 
 TStoreImpl::TStoreImpl(const TWPt<TBase>& Base, const uint& StoreId,
@@ -2985,7 +3770,8 @@ TStoreImpl::TStoreImpl(const TWPt<TBase>& Base, const uint& StoreId,
     const int64& _MxCacheSize, const int& BlockSize):
         TStore(Base, StoreId, StoreName), StoreFNm(_StoreFNm), FAccess(Base->GetFAccess()),
         DataCache(_StoreFNm + ".Cache", Base->GetStoreBlobBs(), _MxCacheSize, 1024),
-        DataMem(_StoreFNm + ".MemCache", Base->GetStoreBlobBs(), BlockSize) {
+        DataMem(_StoreFNm + ".MemCache", Base->GetStoreBlobBs(), BlockSize),
+        DataColumn(_StoreFNm + ".Column", Base->GetFAccess()) {
 
     SetStoreType("TStoreImpl");
     InitFromSchema(StoreSchema);
@@ -2997,7 +3783,8 @@ TStoreImpl::TStoreImpl(const TWPt<TBase>& Base, const TStr& _StoreFNm,
     const int64& _MxCacheSize, const bool& _Lazy): TStore(Base, _StoreFNm + ".BaseStore"),
         StoreFNm(_StoreFNm), FAccess(Base->GetFAccess()), PrimaryFieldType(oftUndef),
         DataCache(_StoreFNm + ".Cache", Base->GetStoreBlobBs(), Base->GetFAccess(), _MxCacheSize),
-        DataMem(_StoreFNm + ".MemCache", Base->GetStoreBlobBs(), Base->GetFAccess(), _Lazy) {
+        DataMem(_StoreFNm + ".MemCache", Base->GetStoreBlobBs(), Base->GetFAccess(), _Lazy),
+        DataColumn(_StoreFNm + ".Column", Base->GetFAccess()) {
 
     SetStoreType("TStoreImpl");
     // load members
@@ -3026,11 +3813,18 @@ TStoreImpl::TStoreImpl(const TWPt<TBase>& Base, const TStr& _StoreFNm,
     }
     // load time window
     WndDesc.Load(FIn);
+    LoadPartitions(StoreFNm + ".Partitions");
     // load data
     SerializatorCache = new TRecSerializator(this);
     SerializatorMem = new TRecSerializator(this);
     SerializatorCache->Load(FIn);
     SerializatorMem->Load(FIn);
+    // fields not handled by serializators are stored in columns
+    for (int FieldId = 0; FieldId < GetFields(); FieldId++) {
+        if (!SerializatorCache->IsFieldId(FieldId) && !SerializatorMem->IsFieldId(FieldId)) {
+            DataColumn.LoadField(FieldId, GetFieldNm(FieldId));
+        }
+    }
 
     // initialize field to storage location map
     InitFieldLocV();
@@ -3045,30 +3839,7 @@ TStoreImpl::~TStoreImpl() {
     // save if necessary
     if (FAccess != faRdOnly) {
         TEnv::Logger->OnStatus(TStr::Fmt("Saving store '%s'...", GetStoreNm().CStr()));
-        // save base store
-        TFOut BaseFOut(StoreFNm + ".BaseStore");
-        SaveStore(BaseFOut);
-        // save store parameters
-        TFOut FOut(StoreFNm + ".GenericStore");
-        // save parameters about primary field
-        RecNmFieldP.Save(FOut);
-        PrimaryFieldId.Save(FOut);
-        if (PrimaryFieldType == oftInt) {
-            PrimaryIntIdH.Save(FOut);
-        } else if (PrimaryFieldType == oftUInt64) {
-            PrimaryUInt64IdH.Save(FOut);
-        } else if (PrimaryFieldType == oftFlt) {
-            PrimaryFltIdH.Save(FOut);
-        } else if (PrimaryFieldType == oftTm) {
-            PrimaryTmMSecsIdH.Save(FOut);
-        } else {
-            PrimaryStrIdH.Save(FOut);
-        }
-        // save time window
-        WndDesc.Save(FOut);
-        // save data
-        SerializatorCache->Save(FOut);
-        SerializatorMem->Save(FOut);
+        SaveParams();
     } else {
         TEnv::Logger->OnStatus("No saving of generic store " + GetStoreNm() + " neccessary!");
     }
@@ -3076,12 +3847,41 @@ TStoreImpl::~TStoreImpl() {
     delete SerializatorMem;
 }
 
+void TStoreImpl::SaveParams() const {
+    // save base store
+    TFOut BaseFOut(StoreFNm + ".BaseStore");
+    SaveStore(BaseFOut);
+    // save store parameters
+    TFOut FOut(StoreFNm + ".GenericStore");
+    // save parameters about primary field
+    RecNmFieldP.Save(FOut);
+    PrimaryFieldId.Save(FOut);
+    if (PrimaryFieldType == oftInt) {
+        PrimaryIntIdH.Save(FOut);
+    } else if (PrimaryFieldType == oftUInt64) {
+        PrimaryUInt64IdH.Save(FOut);
+    } else if (PrimaryFieldType == oftFlt) {
+        PrimaryFltIdH.Save(FOut);
+    } else if (PrimaryFieldType == oftTm) {
+        PrimaryTmMSecsIdH.Save(FOut);
+    } else {
+        PrimaryStrIdH.Save(FOut);
+    }
+    // save time window
+    WndDesc.Save(FOut);
+    SavePartitions(StoreFNm + ".Partitions");
+    // save data
+    SerializatorCache->Save(FOut);
+    SerializatorMem->Save(FOut);
+}
+
 bool TStoreImpl::IsRecId(const uint64& RecId) const {
-    return DataMemP ? DataMem.IsValId(RecId) : DataCache.IsValId(RecId);
+    return DataMemP ? DataMem.IsValId(RecId) :
+        (DataCacheP ? DataCache.IsValId(RecId) : DataColumn.IsValId(RecId));
 }
 
 uint64 TStoreImpl::GetRecs() const {
-    return DataMemP ? DataMem.Len() : DataCache.Len();
+    return DataMemP ? DataMem.Len() : (DataCacheP ? DataCache.Len() : DataColumn.Len());
 }
 
 bool TStoreImpl::IsRecNm(const TStr& RecNm) const {
@@ -3101,29 +3901,27 @@ uint64 TStoreImpl::GetRecId(const TStr& RecNm) const {
 
 PStoreIter TStoreImpl::GetIter() const {
     if (Empty()) { return TStoreIterVec::New(); }
-    return DataMemP ?
-        TStoreIterVec::New(DataMem.GetFirstValId(), DataMem.GetLastValId(), true) :
-        TStoreIterVec::New(DataCache.GetFirstValId(), DataCache.GetLastValId(), true);
+    return TStoreIterVec::New(GetFirstRecId(), GetLastRecId(), true);
 }
 
 uint64 TStoreImpl::GetFirstRecId() const {
-    return Empty() ? TUInt64::Mx :
-        (DataMemP ? DataMem.GetFirstValId() : DataCache.GetFirstValId());
+    return Empty() ? TUInt64::Mx : (DataMemP ? DataMem.GetFirstValId() :
+        (DataCacheP ? DataCache.GetFirstValId() : DataColumn.GetFirstValId()));
 }
 
 uint64 TStoreImpl::GetLastRecId() const {
-    return Empty() ? TUInt64::Mx :
-        (DataMemP ? DataMem.GetLastValId() : DataCache.GetLastValId());
+    return Empty() ? TUInt64::Mx : (DataMemP ? DataMem.GetLastValId() :
+        (DataCacheP ? DataCache.GetLastValId() : DataColumn.GetLastValId()));
 }
 
 PStoreIter TStoreImpl::BackwardIter() const {
     if (Empty()) { return TStoreIterVec::New(); }
-    return DataMemP ?
-        TStoreIterVec::New(DataMem.GetLastValId(), DataMem.GetFirstValId(), false) :
-        TStoreIterVec::New(DataCache.GetLastValId(), DataCache.GetFirstValId(), false);
+    return TStoreIterVec::New(GetLastRecId(), GetFirstRecId(), false);
 }
 
 uint64 TStoreImpl::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {
+    // records added through joins are part of this operation
+    TBaseWal::TOp WalOp(GetBase()->GetWal());
     // check if we are given reference to existing record
     try {
         // parse out record id, if referred directly
@@ -3131,7 +3929,10 @@ uint64 TStoreImpl::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {
             const uint64 RecId = TStore::GetRecId(RecVal);
             if (IsRecId(RecId)) {
                 // check if we have anything more than record identifier, which would require calling UpdateRec
-                if (RecVal->GetObjKeys() > 1) { UpdateRec(RecId, RecVal); }
+                if (RecVal->GetObjKeys() > 1) {
+                    WalOp.UpdateRec(GetStoreId(), RecId, RecVal);
+                    UpdateRec(RecId, RecVal);
+                }
                 // return named record
                 return RecId;
             }
@@ -3174,7 +3975,10 @@ uint64 TStoreImpl::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {
             // check if we found primary field with existing value
             if (PrimaryRecId != TUInt64::Mx) {
                 // check if we have anything more than primary field, which would require redirect to UpdateRec
-                if (RecVal->GetObjKeys() > 1) { UpdateRec(PrimaryRecId, RecVal); }
+                if (RecVal->GetObjKeys() > 1) {
+                    WalOp.UpdateRec(GetStoreId(), PrimaryRecId, RecVal);
+                    UpdateRec(PrimaryRecId, RecVal);
+                }
                 // return id of named record
                 return PrimaryRecId;
             }
@@ -3186,39 +3990,30 @@ uint64 TStoreImpl::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {
         return TUInt64::Mx;
     }
 
-    // always add system field that means "inserted_at"
-    RecVal->AddToObj(TStoreWndDesc::SysInsertedAtFieldName, TTm::GetCurUniTm().GetStr());
-
-    // for storing record id
-    uint64 RecId = TUInt64::Mx;
-    uint64 CacheRecId = TUInt64::Mx;
-    uint64 MemRecId = TUInt64::Mx;
-    // store to disk storage
-    if (DataCacheP) {
-        TMem CacheRecMem;
-        SerializatorCache->Serialize(RecVal, CacheRecMem, this);
-        CacheRecId = DataCache.AddVal(CacheRecMem);
-        RecId = CacheRecId;
-        // index new record
-        RecIndexer.IndexRec(CacheRecMem, RecId, *SerializatorCache);
-    }
-    // store to in-memory storage
-    if (DataMemP) {
-        TMem MemRecMem;
-        SerializatorMem->Serialize(RecVal, MemRecMem, this);
-        MemRecId = DataMem.AddVal(MemRecMem);
-        RecId = MemRecId;
-        // index new record
-        RecIndexer.IndexRec(MemRecMem, RecId, *SerializatorMem);
-    }
-    // make sure we are consistent with respect to Ids!
-    if (DataCacheP && DataMemP) {
-        EAssert(CacheRecId == MemRecId);
+    // always add system field that means "inserted_at", unless replayed from the log
+    if (!RecVal->IsObjKey(TStoreWndDesc::SysInsertedAtFieldName)) {
+        RecVal->AddToObj(TStoreWndDesc::SysInsertedAtFieldName, TTm::GetCurUniTm().GetStr());
     }
+    // log the record with the insert time, so replay sees the same record
+    WalOp.AddRec(GetStoreId(), RecVal);
+
+    // serialize first, so missing or invalid fields throw before anything is stored
+    TMem CacheRecMem, MemRecMem;
+    if (DataCacheP) { SerializatorCache->Serialize(RecVal, CacheRecMem, this); }
+    if (DataMemP) { SerializatorMem->Serialize(RecVal, MemRecMem, this); }
+    // column values are validated while added and rolled back on failure
+    const uint64 ColumnRecId = DataColumnP ? DataColumn.AddVal(RecVal) : TUInt64::Mx;
+    // store the serializations
+    const uint64 RecId = AddRecMem(CacheRecMem, MemRecMem, ColumnRecId);
+    // index new record
+    if (DataCacheP) { RecIndexer.IndexRec(CacheRecMem, RecId, *SerializatorCache); }
+    if (DataMemP) { RecIndexer.IndexRec(MemRecMem, RecId, *SerializatorMem); }
 
     // remember value-recordId map when primary field available
     if (IsPrimaryField()) { SetPrimaryField(RecId); }
 
+    // track time partitions
+    AddPartitionRec(RecId);
     // insert nested join records
     AddJoinRec(RecId, RecVal);
     // call add triggers
@@ -3230,15 +4025,65 @@ uint64 TStoreImpl::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {
     return RecId;
 }
 
+void TStoreImpl::AddRecBatch(TRecBatch& RecBatch, TUInt64V& RecIdV, const bool& TriggerEvents) {
+    TStoreBatch::AddRecBatch(*this, RecBatch, RecIdV, TriggerEvents);
+}
+
+uint64 TStoreImpl::AddRecMem(const TMem& CacheRecMem, const TMem& MemRecMem, const uint64& ColumnRecId) {
+    // for storing record id
+    uint64 RecId = ColumnRecId;
+    uint64 CacheRecId = TUInt64::Mx;
+    uint64 MemRecId = TUInt64::Mx;
+    try {
+        // store to disk storage
+        if (DataCacheP) {
+            CacheRecId = DataCache.AddVal(CacheRecMem);
+            RecId = CacheRecId;
+        }
+        // store to in-memory storage
+        if (DataMemP) {
+            MemRecId = DataMem.AddVal(MemRecMem);
+            RecId = MemRecId;
+        }
+    } catch (const PExcept&) {
+        // keep column storage aligned with the other storages
+        if (DataColumnP) { DataColumn.DelLastVal(); }
+        throw;
+    }
+    // make sure we are consistent with respect to Ids!
+    EAssert(!DataColumnP || RecId == ColumnRecId);
+    if (DataCacheP && DataMemP) {
+        EAssert(CacheRecId == MemRecId);
+    }
+    return RecId;
+}
+
+uint64 TStoreImpl::AddBatchRec(const TRecBatch& RecBatch, const int& RecN, TMem& CacheRecMem, TMem& MemRecMem) {
+    // serialize first, so missing or invalid fields throw before anything is stored
+    if (DataCacheP) { SerializatorCache->Serialize(RecBatch, RecN, CacheRecMem, this); }
+    if (DataMemP) { SerializatorMem->Serialize(RecBatch, RecN, MemRecMem, this); }
+    // column values are validated while added and rolled back on failure
+    const uint64 ColumnRecId = DataColumnP ? DataColumn.AddVal(RecBatch, RecN) : TUInt64::Mx;
+    return AddRecMem(CacheRecMem, MemRecMem, ColumnRecId);
+}
+
+void TStoreImpl::IndexBatchRec(const uint64& RecId, const TMem& CacheRecMem, const TMem& MemRecMem) {
+    if (DataCacheP) { RecIndexer.IndexRec(CacheRecMem, RecId, *SerializatorCache); }
+    if (DataMemP) { RecIndexer.IndexRec(MemRecMem, RecId, *SerializatorMem); }
+}
+
 void TStoreImpl::UpdateRec(const uint64& RecId, const PJsonVal& RecVal) {
+    TBaseWal::TOp WalOp(GetBase()->GetWal());
+    WalOp.UpdateRec(GetStoreId(), RecId, RecVal);
     // figure out which storage fields are affected
-    bool CacheP = false, MemP = false, PrimaryP = false;
+    bool CacheP = false, MemP = false, ColumnP = false, PrimaryP = false;
     for (int FieldId = 0; FieldId < GetFields(); FieldId++) {
         // check if field appears in the record JSon
         TStr FieldNm = GetFieldNm(FieldId);
         if (RecVal->IsObjKey(FieldNm)) {
             CacheP = CacheP || (FieldLocV[FieldId] == slDisk);
             MemP = MemP || (FieldLocV[FieldId] == slMemory);
+            ColumnP = ColumnP || (FieldLocV[FieldId] == slColumn);
             PrimaryP = PrimaryP || (FieldId == PrimaryFieldId);
         }
     }
@@ -3268,6 +4113,8 @@ void TStoreImpl::UpdateRec(const uint64& RecId, const PJsonVal& RecVal) {
         // update indexes pointing to the record
         RecIndexer.UpdateRec(MemOldRecMem, MemNewRecMem, RecId, MemChangedFieldIdSet, *SerializatorMem);
     }
+    // update column values when necessary
+    if (ColumnP) { DataColumn.SetVal(RecId, RecVal); }
     // check if primary key changed and update the mapping
     if (PrimaryP) { SetPrimaryField(RecId); }
     // call update triggers
@@ -3299,16 +4146,21 @@ void TStoreImpl::GarbageCollect(const int& MxTimeMSecs) {
         TEnv::Logger->OnStatusFmt("  window: %s - %s",
             TTm::GetTmFromMSecs(WindowStartMSecs).GetWebLogDateTimeStr(true, "T", false).CStr(),
             TTm::GetTmFromMSecs(CurMSecs).GetWebLogDateTimeStr(true, "T", false).CStr());
-        // iterate from the start until we hit the time window
-        PStoreIter Iter = GetIter();
-        while (Iter->Next()) {
-            uint64 RecId = Iter->GetRecId();
-            // get record time
-            uint64 TmMSecs = GetFieldTmMSecs(RecId, TimeFieldId);
-            // if we are within time window we stop
-            if (TmMSecs >= WindowStartMSecs) break;
-            // otherwise we mark the record for deletion
-            DelRecIdV.Add(RecId);
+        if (IsPartitioned()) {
+            // drop whole partitions which ended before the window
+            GetExpiredPartitionRecIdV(WindowStartMSecs, DelRecIdV);
+        } else {
+            // iterate from the start until we hit the time window
+            PStoreIter Iter = GetIter();
+            while (Iter->Next()) {
+                uint64 RecId = Iter->GetRecId();
+                // get record time
+                uint64 TmMSecs = GetFieldTmMSecs(RecId, TimeFieldId);
+                // if we are within time window we stop
+                if (TmMSecs >= WindowStartMSecs) break;
+                // otherwise we mark the record for deletion
+                DelRecIdV.Add(RecId);
+            }
         }
         // report progress
     } else if (GetRecs() > WndDesc.WindowSize) {
@@ -3333,6 +4185,8 @@ void TStoreImpl::GarbageCollect(const int& MxTimeMSecs) {
 void TStoreImpl::DeleteAllRecs() {
     // if no records, nothing to do here
     if (Empty()) { return; }
+    TBaseWal::TOp WalOp(GetBase()->GetWal());
+    WalOp.DelAllRecs(GetStoreId());
     TEnv::Logger->OnStatusFmt("Deleting all (%d) records in %s", GetRecs(), GetStoreNm().CStr());
 
     // NOTE: if you change the logic bellow, be sure to also change the DeleteRecs() method
@@ -3376,6 +4230,8 @@ void TStoreImpl::DeleteAllRecs() {
     PrimaryTmMSecsIdH.Clr();
     DataCache.DelVals(TInt::Mx);
     DataMem.DelVals(TInt::Mx);
+    DataColumn.DelVals(TInt::Mx);
+    DelPartitionRecs();
     PartialFlush(TInt::Mx);
 }
 
@@ -3401,6 +4257,7 @@ void TStoreImpl::DeleteFirstRecs(const int& DelRecs)  {
 }
 
 void TStoreImpl::DeleteRecs(const TUInt64V& DelRecIdV, const int& MxTimeMSecs, const bool& AssertOK) {
+    TBaseWal::TOp WalOp(GetBase()->GetWal());
     if (AssertOK) {
         // assert that DelRecIdV is valid, without gaps and that deleting will not create gaps
         PStoreIter Iter = GetIter();
@@ -3417,7 +4274,7 @@ void TStoreImpl::DeleteRecs(const TUInt64V& DelRecIdV, const int& MxTimeMSecs, c
 
     // NOTE: if you change the logic bellow, be sure to also change the DeleteAllRecs() method
 
-    // delete records from index
+    // run triggers and delete records from joins
     TTmStopWatch StopWatch(true);
     int DeletedRecs = 0;
     for (int DelRecN = 0; DelRecN < DelRecIdV.Len(); DelRecN++) {
@@ -3438,17 +4295,6 @@ void TStoreImpl::DeleteRecs(const TUInt64V& DelRecIdV, const int& MxTimeMSecs, c
         if (IsPrimaryField()) {
             DelPrimaryField(DelRecId);
         }
-        // delete record from indexes
-        if (DataCacheP) {
-            TMem CacheRecMem;
-            DataCache.GetVal(DelRecId, CacheRecMem);
-            RecIndexer.DeindexRec(CacheRecMem, DelRecId, *SerializatorCache);
-        }
-        if (DataMemP) {
-            TMem MemRecMem;
-            DataMem.GetVal(DelRecId, MemRecMem);
-            RecIndexer.DeindexRec(MemRecMem, DelRecId, *SerializatorMem);
-        }
         // delete record from joins
         TRec Rec(this, DelRecId);
         for (int JoinN = 0; JoinN < GetJoins(); JoinN++) {
@@ -3464,6 +4310,28 @@ void TStoreImpl::DeleteRecs(const TUInt64V& DelRecIdV, const int& MxTimeMSecs, c
         // count what we deleted
         DeletedRecs++;
     }
+    // delete records from indexes, inverted index is updated once per key
+    const TWPt<TIndex>& Index = GetIndex();
+    Index->StartBatch();
+    try {
+        for (int DelRecN = 0; DelRecN < DeletedRecs; DelRecN++) {
+            const uint64 DelRecId = DelRecIdV[DelRecN];
+            if (DataCacheP) {
+                TMem CacheRecMem;
+                DataCache.GetVal(DelRecId, CacheRecMem);
+                RecIndexer.DeindexRec(CacheRecMem, DelRecId, *SerializatorCache);
+            }
+            if (DataMemP) {
+                TMem MemRecMem;
+                DataMem.GetVal(DelRecId, MemRecMem);
+                RecIndexer.DeindexRec(MemRecMem, DelRecId, *SerializatorMem);
+            }
+        }
+    } catch (...) {
+        Index->EndBatch();
+        throw;
+    }
+    Index->EndBatch();
     // delete records from disk
     if (DataCacheP) {
         DataCache.DelVals(DeletedRecs);
@@ -3472,6 +4340,14 @@ void TStoreImpl::DeleteRecs(const TUInt64V& DelRecIdV, const int& MxTimeMSecs, c
     if (DataMemP) {
         DataMem.DelVals(DeletedRecs);
     }
+    // delete records from column store
+    if (DataColumnP) {
+        DataColumn.DelVals(DeletedRecs);
+    }
+    // drop deleted records from time partitions
+    DelPartitionRecs();
+    // log what was deleted before running out of time
+    WalOp.DelRecs(GetStoreId(), DelRecIdV, DeletedRecs);
 
     // report success :-)
     if (DelRecIdV.Len() > 1000) {
@@ -3480,26 +4356,31 @@ void TStoreImpl::DeleteRecs(const TUInt64V& DelRecIdV, const int& MxTimeMSecs, c
 }
 
 bool TStoreImpl::IsFieldNull(const uint64& RecId, const int& FieldId) const {
+    if (IsFieldColumn(FieldId)) { return DataColumn.IsFieldNull(RecId, FieldId); }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->IsFieldNull(RecMem, FieldId);
 }
 
 uchar TStoreImpl::GetFieldByte(const uint64& RecId, const int& FieldId) const {
+    if (IsFieldColumn(FieldId)) { return (uchar)DataColumn.GetFieldInt64(RecId, FieldId); }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->GetFieldByte(RecMem, FieldId);
 }
 
 int TStoreImpl::GetFieldInt(const uint64& RecId, const int& FieldId) const {
+    if (IsFieldColumn(FieldId)) { return (int)DataColumn.GetFieldInt64(RecId, FieldId); }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->GetFieldInt(RecMem, FieldId);
 }
 
 int16 TStoreImpl::GetFieldInt16(const uint64& RecId, const int& FieldId) const {
+    if (IsFieldColumn(FieldId)) { return (int16)DataColumn.GetFieldInt64(RecId, FieldId); }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->GetFieldInt16(RecMem, FieldId);
 }
 
 int64 TStoreImpl::GetFieldInt64(const uint64& RecId, const int& FieldId) const {
+    if (IsFieldColumn(FieldId)) { return DataColumn.GetFieldInt64(RecId, FieldId); }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->GetFieldInt64(RecMem, FieldId);
 }
@@ -3510,16 +4391,19 @@ TStr TStoreImpl::GetFieldStr(const uint64& RecId, const int& FieldId) const {
 }
 
 bool TStoreImpl::GetFieldBool(const uint64& RecId, const int& FieldId) const {
+    if (IsFieldColumn(FieldId)) { return DataColumn.GetFieldInt64(RecId, FieldId) != 0; }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->GetFieldBool(RecMem, FieldId);
 }
 
 double TStoreImpl::GetFieldFlt(const uint64& RecId, const int& FieldId) const {
+    if (IsFieldColumn(FieldId)) { return DataColumn.GetFieldFlt(RecId, FieldId); }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->GetFieldFlt(RecMem, FieldId);
 }
 
 float TStoreImpl::GetFieldSFlt(const uint64& RecId, const int& FieldId) const {
+    if (IsFieldColumn(FieldId)) { return (float)DataColumn.GetFieldFlt(RecId, FieldId); }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->GetFieldSFlt(RecMem, FieldId);
 }
@@ -3530,16 +4414,19 @@ TFltPr TStoreImpl::GetFieldFltPr(const uint64& RecId, const int& FieldId) const
 }
 
 uint TStoreImpl::GetFieldUInt(const uint64& RecId, const int& FieldId) const {
+    if (IsFieldColumn(FieldId)) { return (uint)DataColumn.GetFieldInt64(RecId, FieldId); }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->GetFieldUInt(RecMem, FieldId);
 }
 
 uint16 TStoreImpl::GetFieldUInt16(const uint64& RecId, const int& FieldId) const {
+    if (IsFieldColumn(FieldId)) { return (uint16)DataColumn.GetFieldInt64(RecId, FieldId); }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->GetFieldUInt16(RecMem, FieldId);
 }
 
 uint64 TStoreImpl::GetFieldUInt64(const uint64& RecId, const int& FieldId) const {
+    if (IsFieldColumn(FieldId)) { return DataColumn.GetFieldUInt64(RecId, FieldId); }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->GetFieldUInt64(RecMem, FieldId);
 }
@@ -3560,11 +4447,13 @@ void TStoreImpl::GetFieldFltV(const uint64& RecId, const int& FieldId, TFltV& Fl
 }
 
 void TStoreImpl::GetFieldTm(const uint64& RecId, const int& FieldId, TTm& Tm) const {
+    if (IsFieldColumn(FieldId)) { Tm = TTm::GetTmFromMSecs(DataColumn.GetFieldUInt64(RecId, FieldId)); return; }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     GetFieldSerializator(FieldId)->GetFieldTm(RecMem, FieldId, Tm);
 }
 
 uint64 TStoreImpl::GetFieldTmMSecs(const uint64& RecId, const int& FieldId) const {
+    if (IsFieldColumn(FieldId)) { return DataColumn.GetFieldUInt64(RecId, FieldId); }
     TMem RecMem; GetRecMem(RecId, FieldId, RecMem);
     return GetFieldSerializator(FieldId)->GetFieldTmMSecs(RecMem, FieldId);
 }
@@ -3589,7 +4478,35 @@ PJsonVal TStoreImpl::GetFieldJsonVal(const uint64& RecId, const int& FieldId) co
     return GetFieldSerializator(FieldId)->GetFieldJsonVal(RecMem, FieldId);
 }
 
+void TStoreImpl::GetFieldInt64Block(const TUInt64V& RecIdV, const int& FieldId,
+        TVec<TInt64>& ValV, TBoolV& NullV) const {
+
+    if (IsFieldColumn(FieldId)) { DataColumn.GetFieldInt64Block(RecIdV, FieldId, ValV, NullV); return; }
+    TVec<TMem> RecMemV; TVec<char*> RecBfV;
+    GetRecBfV(FieldLocV[FieldId], RecIdV, RecMemV, RecBfV);
+    GetFieldSerializator(FieldId)->GetFieldInt64Block(RecBfV, GetFieldDesc(FieldId), ValV, NullV);
+}
+
+void TStoreImpl::GetFieldUInt64Block(const TUInt64V& RecIdV, const int& FieldId,
+        TUInt64V& ValV, TBoolV& NullV) const {
+
+    if (IsFieldColumn(FieldId)) { DataColumn.GetFieldUInt64Block(RecIdV, FieldId, ValV, NullV); return; }
+    TVec<TMem> RecMemV; TVec<char*> RecBfV;
+    GetRecBfV(FieldLocV[FieldId], RecIdV, RecMemV, RecBfV);
+    GetFieldSerializator(FieldId)->GetFieldUInt64Block(RecBfV, GetFieldDesc(FieldId), ValV, NullV);
+}
+
+void TStoreImpl::GetFieldFltBlock(const TUInt64V& RecIdV, const int& FieldId,
+        TFltV& ValV, TBoolV& NullV) const {
+
+    if (IsFieldColumn(FieldId)) { DataColumn.GetFieldFltBlock(RecIdV, FieldId, ValV, NullV); return; }
+    TVec<TMem> RecMemV; TVec<char*> RecBfV;
+    GetRecBfV(FieldLocV[FieldId], RecIdV, RecMemV, RecBfV);
+    GetFieldSerializator(FieldId)->GetFieldFltBlock(RecBfV, GetFieldDesc(FieldId), ValV, NullV);
+}
+
 void TStoreImpl::SetFieldNull(const uint64& RecId, const int& FieldId) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldNull(RecId, FieldId); return; }
     TMem InRecMem; GetRecMem(RecId, FieldId, InRecMem);
     TRecSerializator* FieldSerializator = GetFieldSerializator(FieldId);
     TMem OutRecMem; FieldSerializator->SetFieldNull(InRecMem, OutRecMem, FieldId);
@@ -3598,6 +4515,7 @@ void TStoreImpl::SetFieldNull(const uint64& RecId, const int& FieldId) {
 }
 
 void TStoreImpl::SetFieldByte(const uint64& RecId, const int& FieldId, const uchar& Byte) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldInt64(RecId, FieldId, (int64)Byte); return; }
     TMem InRecMem; GetRecMem(RecId, FieldId, InRecMem);
     TRecSerializator* FieldSerializator = GetFieldSerializator(FieldId);
     TMem OutRecMem;
@@ -3607,6 +4525,7 @@ void TStoreImpl::SetFieldByte(const uint64& RecId, const int& FieldId, const uch
 }
 
 void TStoreImpl::SetFieldInt(const uint64& RecId, const int& FieldId, const int& Int) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldInt64(RecId, FieldId, (int64)Int); return; }
     // special case if field is primary field
     if (FieldId == PrimaryFieldId) {
         // it is, make sure new value does not exist yet
@@ -3629,6 +4548,7 @@ void TStoreImpl::SetFieldInt(const uint64& RecId, const int& FieldId, const int&
 }
 
 void TStoreImpl::SetFieldInt16(const uint64& RecId, const int& FieldId, const int16& Int16) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldInt64(RecId, FieldId, (int64)Int16); return; }
     TMem InRecMem; GetRecMem(RecId, FieldId, InRecMem);
     TRecSerializator* FieldSerializator = GetFieldSerializator(FieldId);
     TMem OutRecMem;
@@ -3638,6 +4558,7 @@ void TStoreImpl::SetFieldInt16(const uint64& RecId, const int& FieldId, const in
 }
 
 void TStoreImpl::SetFieldInt64(const uint64& RecId, const int& FieldId, const int64& Int64) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldInt64(RecId, FieldId, Int64); return; }
     TMem InRecMem; GetRecMem(RecId, FieldId, InRecMem);
     TRecSerializator* FieldSerializator = GetFieldSerializator(FieldId);
     TMem OutRecMem;
@@ -3656,6 +4577,7 @@ void TStoreImpl::SetFieldIntV(const uint64& RecId, const int& FieldId, const TIn
 }
 
 void TStoreImpl::SetFieldUInt(const uint64& RecId, const int& FieldId, const uint& UInt) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldInt64(RecId, FieldId, (int64)UInt); return; }
     TMem InRecMem; GetRecMem(RecId, FieldId, InRecMem);
     TRecSerializator* FieldSerializator = GetFieldSerializator(FieldId);
     TMem OutRecMem;
@@ -3665,6 +4587,7 @@ void TStoreImpl::SetFieldUInt(const uint64& RecId, const int& FieldId, const uin
 }
 
 void TStoreImpl::SetFieldUInt16(const uint64& RecId, const int& FieldId, const uint16& UInt16) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldInt64(RecId, FieldId, (int64)UInt16); return; }
     TMem InRecMem; GetRecMem(RecId, FieldId, InRecMem);
     TRecSerializator* FieldSerializator = GetFieldSerializator(FieldId);
     TMem OutRecMem;
@@ -3674,6 +4597,7 @@ void TStoreImpl::SetFieldUInt16(const uint64& RecId, const int& FieldId, const u
 }
 
 void TStoreImpl::SetFieldUInt64(const uint64& RecId, const int& FieldId, const uint64& UInt64) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldUInt64(RecId, FieldId, UInt64); return; }
     // special case if field is primary field
     if (FieldId == PrimaryFieldId) {
         // it is, make sure new value does not exist yet
@@ -3727,6 +4651,7 @@ void TStoreImpl::SetFieldStrV(const uint64& RecId, const int& FieldId, const TSt
 }
 
 void TStoreImpl::SetFieldBool(const uint64& RecId, const int& FieldId, const bool& Bool) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldInt64(RecId, FieldId, Bool ? 1 : 0); return; }
     TMem InRecMem; GetRecMem(RecId, FieldId, InRecMem);
     TRecSerializator* FieldSerializator = GetFieldSerializator(FieldId);
     TMem OutRecMem;
@@ -3736,6 +4661,7 @@ void TStoreImpl::SetFieldBool(const uint64& RecId, const int& FieldId, const boo
 }
 
 void TStoreImpl::SetFieldFlt(const uint64& RecId, const int& FieldId, const double& Flt) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldFlt(RecId, FieldId, Flt); return; }
     // special case if field is primary field
     if (FieldId == PrimaryFieldId) {
         // it is, make sure new value does not exist yet
@@ -3757,6 +4683,7 @@ void TStoreImpl::SetFieldFlt(const uint64& RecId, const int& FieldId, const doub
     if (FieldId == PrimaryFieldId) { SetPrimaryFieldFlt(RecId, Flt); }
 }
 void TStoreImpl::SetFieldSFlt(const uint64& RecId, const int& FieldId, const float& SFlt) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldFlt(RecId, FieldId, (double)SFlt); return; }
     TMem InRecMem; GetRecMem(RecId, FieldId, InRecMem);
     TRecSerializator* FieldSerializator = GetFieldSerializator(FieldId);
     TMem OutRecMem;
@@ -3784,6 +4711,7 @@ void TStoreImpl::SetFieldFltV(const uint64& RecId, const int& FieldId, const TFl
 }
 
 void TStoreImpl::SetFieldTm(const uint64& RecId, const int& FieldId, const TTm& Tm) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldUInt64(RecId, FieldId, TTm::GetMSecsFromTm(Tm)); return; }
     TMem InRecMem; GetRecMem(RecId, FieldId, InRecMem);
     TRecSerializator* FieldSerializator = GetFieldSerializator(FieldId);
     TMem OutRecMem;
@@ -3793,6 +4721,7 @@ void TStoreImpl::SetFieldTm(const uint64& RecId, const int& FieldId, const TTm&
 }
 
 void TStoreImpl::SetFieldTmMSecs(const uint64& RecId, const int& FieldId, const uint64& TmMSecs) {
+    if (IsFieldColumn(FieldId)) { DataColumn.SetFieldUInt64(RecId, FieldId, TmMSecs); return; }
     // special case if field is primary field
     if (FieldId == PrimaryFieldId) {
         // it is, make sure new value does not exist yet
@@ -3875,11 +4804,23 @@ int TStoreImpl::GetCodebookId(const int& FieldId, const TStr& Str) const {
 }
 
 int TStoreImpl::PartialFlush(int WndInMsec) {
-    int slice = WndInMsec / 2;
+    int slice = WndInMsec / 3;
     TTmStopWatch sw(true);
+    // writers are kept out by the base data lock, readers by the record storage lock
+    TLock Lock(RecMemLock);
     int res = DataMem.PartialFlush(slice);
     int res2 = DataCache.PartialFlush(slice);
-    return res + res2;
+    int res3 = DataColumnP ? DataColumn.PartialFlush(slice) : 0;
+    return res + res2 + res3;
+}
+
+void TStoreImpl::Flush() {
+    QmAssertR(FAccess != faRdOnly, "Store " + GetStoreNm() + " opened in read-only mode");
+    TLock Lock(RecMemLock);
+    DataMem.Save();
+    DataCache.Save();
+    if (DataColumnP) { DataColumn.Save(); }
+    SaveParams();
 }
 
 PJsonVal TStoreImpl::GetStats() {
@@ -3887,6 +4828,7 @@ PJsonVal TStoreImpl::GetStats() {
     res->AddToObj("name", GetStoreNm());
     res->AddToObj("blob_storage_memory", BlobBsStatsToJson(DataMem.GetBlobBsStats()));
     res->AddToObj("blob_storage_cache", BlobBsStatsToJson(DataCache.GetBlobBsStats()));
+    if (IsPartitioned()) { res->AddToObj("partitions", Partitions.GetJson()); }
     return res;
 }
 
@@ -3903,14 +4845,20 @@ void TStoreImpl::RunVerificationForRecord(const uint64& RecId) {
 ///////////////////////////////
 /// TStorePbBlob
 
-uint64 TStorePbBlob::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {// check if we are given reference to existing record
+uint64 TStorePbBlob::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {
+    // records added through joins are part of this operation
+    TBaseWal::TOp WalOp(GetBase()->GetWal());
+    // check if we are given reference to existing record
     try {
         // parse out record id, if referred directly
         {
             const uint64 RecId = TStore::GetRecId(RecVal);
             if (IsRecId(RecId)) {
                 // check if we have anything more than record identifier, which would require calling UpdateRec
-                if (RecVal->GetObjKeys() > 1) { UpdateRec(RecId, RecVal); }
+                if (RecVal->GetObjKeys() > 1) {
+                    WalOp.UpdateRec(GetStoreId(), RecId, RecVal);
+                    UpdateRec(RecId, RecVal);
+                }
                 // return named record
                 return RecId;
             }
@@ -3955,7 +4903,10 @@ uint64 TStorePbBlob::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {
             // check if we found primary field with existing value
             if (PrimaryRecId != TUInt64::Mx) {
                 // check if we have anything more than primary field, which would require redirect to UpdateRec
-                if (RecVal->GetObjKeys() > 1) { UpdateRec(PrimaryRecId, RecVal); }
+                if (RecVal->GetObjKeys() > 1) {
+                    WalOp.UpdateRec(GetStoreId(), PrimaryRecId, RecVal);
+                    UpdateRec(PrimaryRecId, RecVal);
+                }
                 // return id of named record
                 return PrimaryRecId;
             }
@@ -3967,8 +4918,12 @@ uint64 TStorePbBlob::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {
         return TUInt64::Mx;
     }
 
-    // always add system field that means "inserted_at"
-    RecVal->AddToObj(TStoreWndDesc::SysInsertedAtFieldName, TTm::GetCurUniTm().GetStr());
+    // always add system field that means "inserted_at", unless replayed from the log
+    if (!RecVal->IsObjKey(TStoreWndDesc::SysInsertedAtFieldName)) {
+        RecVal->AddToObj(TStoreWndDesc::SysInsertedAtFieldName, TTm::GetCurUniTm().GetStr());
+    }
+    // log the record with the insert time, so replay sees the same record
+    WalOp.AddRec(GetStoreId(), RecVal);
 
     // for storing record id
     TPgBlobPt CacheRecId;
@@ -4001,6 +4956,8 @@ uint64 TStorePbBlob::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {
     // remember value-recordId map when primary field available
     if (IsPrimaryField()) { SetPrimaryField(RecId); }
 
+    // track time partitions
+    AddPartitionRec(RecId);
     // insert nested join records
     AddJoinRec(RecId, RecVal);
     // call add triggers
@@ -4012,8 +4969,34 @@ uint64 TStorePbBlob::AddRec(const PJsonVal& RecVal, const bool& TriggerEvents) {
     return RecId;
 }
 
+void TStorePbBlob::AddRecBatch(TRecBatch& RecBatch, TUInt64V& RecIdV, const bool& TriggerEvents) {
+    TStoreBatch::AddRecBatch(*this, RecBatch, RecIdV, TriggerEvents);
+}
+
+uint64 TStorePbBlob::AddBatchRec(const TRecBatch& RecBatch, const int& RecN, TMem& CacheRecMem, TMem& MemRecMem) {
+    const uint64 RecId = RecIdCounter++;
+    // store to disk storage
+    if (DataBlobP) {
+        SerializatorCache->Serialize(RecBatch, RecN, CacheRecMem, this);
+        RecIdBlobPtH.AddDat(RecId) = DataBlob->Put(CacheRecMem.GetBf(), CacheRecMem.Len());
+    }
+    // store to in-memory storage
+    if (DataMemP) {
+        SerializatorMem->Serialize(RecBatch, RecN, MemRecMem, this);
+        RecIdBlobPtHMem.AddDat(RecId) = DataMem->Put(MemRecMem.GetBf(), MemRecMem.Len());
+    }
+    return RecId;
+}
+
+void TStorePbBlob::IndexBatchRec(const uint64& RecId, const TMem& CacheRecMem, const TMem& MemRecMem) {
+    if (DataBlobP) { RecIndexer.IndexRec(CacheRecMem, RecId, *SerializatorCache); }
+    if (DataMemP) { RecIndexer.IndexRec(MemRecMem, RecId, *SerializatorMem); }
+}
+
 /// Update existing record
 void TStorePbBlob::UpdateRec(const uint64& RecId, const PJsonVal& RecVal) {
+    TBaseWal::TOp WalOp(GetBase()->GetWal());
+    WalOp.UpdateRec(GetStoreId(), RecId, RecVal);
     // figure out which storage fields are affected
     bool CacheP = false, MemP = false, PrimaryP = false;
     bool CacheVarP = false, MemVarP = false, KeyP = false;
@@ -4124,15 +5107,15 @@ void TStorePbBlob::UpdateRec(const uint64& RecId, const PJsonVal& RecVal) {
 
 /// Load page with with given record and return pointer to it
 TThinMIn TStorePbBlob::GetPgBf(const uint64& RecId, const bool& UseMem) const {
-    if (UseMem) {
-        const TPgBlobPt& PgPt = RecIdBlobPtHMem.GetDat(RecId);
-        TThinMIn min = DataMem->Get(PgPt);
-        return min;
-    } else {
-        const TPgBlobPt& PgPt = RecIdBlobPtH.GetDat(RecId);
-        TThinMIn min = DataBlob->Get(PgPt);
-        return min;
+    const PPgBlob& Blob = UseMem ? DataMem : DataBlob;
+    const TPgBlobPt& PgPt = UseMem ? RecIdBlobPtHMem.GetDat(RecId) : RecIdBlobPtH.GetDat(RecId);
+    if (GetBase()->IsFlusher()) {
+        // loading a page changes the page cache, which the flusher walks at the same
+        // time; flusher does not evict pages, so the returned buffer stays valid
+        TLock Lock(PgBlobLock);
+        return Blob->Get(PgPt);
     }
+    return Blob->Get(PgPt);
 }
 
 /// Get serializator for given location
@@ -4909,16 +5892,26 @@ int TStorePbBlob::GetCodebookId(const int& FieldId, const TStr& Str) const {
 
 /// Save part of the data, given time-window
 int TStorePbBlob::PartialFlush(int WndInMsec) {
+    TLock Lock(PgBlobLock);
     DataBlob->PartialFlush(WndInMsec);
     return 0;
 }
 
+void TStorePbBlob::Flush() {
+    QmAssertR(FAccess != faRdOnly, "Store " + GetStoreNm() + " opened in read-only mode");
+    TLock Lock(PgBlobLock);
+    DataBlob->Flush();
+    DataMem->Flush();
+    SaveParams();
+}
+
 /// Retrieve performance statistics for this store
 PJsonVal TStorePbBlob::GetStats() {
     PJsonVal res = TJsonVal::NewObj();
     res->AddToObj("name", GetStoreNm());
     res->AddToObj("blob_storage", DataBlob->GetStats());
     res->AddToObj("mem_storage", DataMem->GetStats());
+    if (IsPartitioned()) { res->AddToObj("partitions", Partitions.GetJson()); }
     return res;
 }
 
@@ -4967,16 +5960,21 @@ void TStorePbBlob::GarbageCollect(const int& MxTimeMSecs) {
         TEnv::Logger->OnStatusFmt("  window: %s - %s",
             TTm::GetTmFromMSecs(WindowStartMSecs).GetWebLogDateTimeStr(true, "T", false).CStr(),
             TTm::GetTmFromMSecs(CurMSecs).GetWebLogDateTimeStr(true, "T", false).CStr());
-        // iterate from the start until we hit the time window
-        PStoreIter Iter = GetIter();
-        while (Iter->Next()) {
-            uint64 RecId = Iter->GetRecId();
-            // get record time
-            uint64 TmMSecs = GetFieldTmMSecs(RecId, TimeFieldId);
-            // if we are within time window we stop
-            if (TmMSecs >= WindowStartMSecs) break;
-            // otherwise we mark the record for deletion
-            DelRecIdV.Add(RecId);
+        if (IsPartitioned()) {
+            // drop whole partitions which ended before the window
+            GetExpiredPartitionRecIdV(WindowStartMSecs, DelRecIdV);
+        } else {
+            // iterate from the start until we hit the time window
+            PStoreIter Iter = GetIter();
+            while (Iter->Next()) {
+                uint64 RecId = Iter->GetRecId();
+                // get record time
+                uint64 TmMSecs = GetFieldTmMSecs(RecId, TimeFieldId);
+                // if we are within time window we stop
+                if (TmMSecs >= WindowStartMSecs) break;
+                // otherwise we mark the record for deletion
+                DelRecIdV.Add(RecId);
+            }
         }
     }
     else if (GetRecs() > WndDesc.WindowSize) {
@@ -5008,6 +6006,8 @@ void TStorePbBlob::Defrag() {
 void TStorePbBlob::DeleteAllRecs() {
     // if no records, nothing to do here
     if (Empty()) { return; }
+    TBaseWal::TOp WalOp(GetBase()->GetWal());
+    WalOp.DelAllRecs(GetStoreId());
     TEnv::Logger->OnStatusFmt("Deleting all (%d) records in %s", GetRecs(), GetStoreNm().CStr());
 
     // delete records from index
@@ -5061,6 +6061,7 @@ void TStorePbBlob::DeleteAllRecs() {
     RecIdBlobPtHMem.Clr();
     DataBlob->Clr();
     DataMem->Clr();
+    DelPartitionRecs();
     PartialFlush(TInt::Mx);
 }
 
@@ -5083,6 +6084,7 @@ void TStorePbBlob::DeleteFirstRecs(const int& Recs) {
 }
 
 void TStorePbBlob::DeleteRecs(const TUInt64V& DelRecIdV, const int& MxTimeMSecs, const bool& AssertOK) {
+    TBaseWal::TOp WalOp(GetBase()->GetWal());
     if (AssertOK) {
         // assert that DelRecIdV is valid
         THash<TUInt64, TPgBlobPt>* Ht = (DataMemP ? &RecIdBlobPtHMem : &RecIdBlobPtH);
@@ -5091,8 +6093,9 @@ void TStorePbBlob::DeleteRecs(const TUInt64V& DelRecIdV, const int& MxTimeMSecs,
                 "TStorePbBlob::DeleteRecs - incorrect record id. Record with specified ID not found.");
         }
     }
-    // delete records
+    // run triggers and delete records from joins
     TTmStopWatch StopWatch(true);
+    int DeletedRecs = 0;
     for (int DelRecN = 0; DelRecN < DelRecIdV.Len(); DelRecN++) {
         // report progress
         if (DelRecN > 0 && DelRecN % 1000 == 0) { TEnv::Logger->OnStatusFmt("    %d\r", DelRecN); }
@@ -5120,23 +6123,39 @@ void TStorePbBlob::DeleteRecs(const TUInt64V& DelRecIdV, const int& MxTimeMSecs,
                 DelJoin(JoinDesc.GetJoinId(), DelRecId, JoinRecId);
             }
         }
-
-        // delete record from indexes
-        if (DataBlobP) {
-            TPgBlobPt Pt = RecIdBlobPtH.GetDat(DelRecId);
-            TMemBase CacheRecMem = DataBlob->GetMemBase(Pt);
-            RecIndexer.DeindexRec(CacheRecMem, DelRecId, *SerializatorCache);
-            DataBlob->Del(Pt);
-            RecIdBlobPtH.DelKey(DelRecId);
-        }
-        if (DataMemP) {
-            TPgBlobPt Pt = RecIdBlobPtHMem.GetDat(DelRecId);
-            TMemBase RecMem = DataMem->GetMemBase(Pt);
-            RecIndexer.DeindexRec(RecMem, DelRecId, *SerializatorMem);
-            DataMem->Del(Pt);
-            RecIdBlobPtHMem.DelKey(DelRecId);
+        // count what we deleted
+        DeletedRecs++;
+    }
+    // delete records from indexes and storage, inverted index is updated once per key
+    const TWPt<TIndex>& Index = GetIndex();
+    Index->StartBatch();
+    try {
+        for (int DelRecN = 0; DelRecN < DeletedRecs; DelRecN++) {
+            const uint64 DelRecId = DelRecIdV[DelRecN];
+            if (DataBlobP) {
+                TPgBlobPt Pt = RecIdBlobPtH.GetDat(DelRecId);
+                TMemBase CacheRecMem = DataBlob->GetMemBase(Pt);
+                RecIndexer.DeindexRec(CacheRecMem, DelRecId, *SerializatorCache);
+                DataBlob->Del(Pt);
+                RecIdBlobPtH.DelKey(DelRecId);
+            }
+            if (DataMemP) {
+                TPgBlobPt Pt = RecIdBlobPtHMem.GetDat(DelRecId);
+                TMemBase RecMem = DataMem->GetMemBase(Pt);
+                RecIndexer.DeindexRec(RecMem, DelRecId, *SerializatorMem);
+                DataMem->Del(Pt);
+                RecIdBlobPtHMem.DelKey(DelRecId);
+            }
         }
+    } catch (...) {
+        Index->EndBatch();
+        throw;
     }
+    Index->EndBatch();
+    // drop deleted records from time partitions
+    DelPartitionRecs();
+    // log what was deleted before running out of time
+    WalOp.DelRecs(GetStoreId(), DelRecIdV, DeletedRecs);
 
     // report success :-)
     if (DelRecIdV.Len() > 1000) {
@@ -5175,6 +6194,9 @@ void TStorePbBlob::InitFromSchema(const TStoreSchema& StoreSchema) {
             PrimaryFieldId = GetFieldId(FieldDesc.GetFieldNm());
             PrimaryFieldType = FieldDesc.GetFieldType();
         }
+        // column storage is only implemented by TStoreImpl
+        QmAssertR(StoreSchema.FieldExH.GetDat(FieldDesc.GetFieldNm()).FieldStoreLoc != slColumn,
+            "TStorePbBlob does not support column storage for field " + FieldDesc.GetFieldNm());
     }
     // create index keys
     TWPt<TIndexVoc> IndexVoc = GetIndex()->GetIndexVoc();
@@ -5189,6 +6211,10 @@ void TStorePbBlob::InitFromSchema(const TStoreSchema& StoreSchema) {
             FieldId, WordVocId, IndexKeyEx.KeyType, IndexKeyEx.GixType, IndexKeyEx.SortType);
         // assign tokenizer to it if we have one
         if (IndexKeyEx.IsTokenizer()) { IndexVoc->PutTokenizer(KeyId, IndexKeyEx.Tokenizer); }
+        // store child vectors compressed if so requested
+        if (IndexKeyEx.CompressP) { IndexVoc->PutCompress(KeyId, true); }
+        // keep linear index nodes on disk if so requested
+        if (IndexKeyEx.PagedP) { IndexVoc->PutPaged(KeyId, true); }
     }
     // prepare serializators for disk and in-memory store
     SerializatorCache = new TRecSerializator(this, this, StoreSchema, slDisk);
@@ -5199,6 +6225,7 @@ void TStorePbBlob::InitFromSchema(const TStoreSchema& StoreSchema) {
     RecIndexer = TRecIndexer(GetIndex(), this);
     // remember window parameters
     WndDesc = StoreSchema.WndDesc;
+    Partitions = TStorePartitions(WndDesc.PartitionSize);
 }
 
 /// initialize field storage location map
@@ -5268,6 +6295,7 @@ TStorePbBlob::TStorePbBlob(const TWPt<TBase>& Base, const TStr& _StoreFNm,
     }
     // load time window
     WndDesc.Load(FIn);
+    LoadPartitions(StoreFNm + ".Partitions");
     // load data
     SerializatorCache = new TRecSerializator(this);
     SerializatorMem = new TRecSerializator(this);
@@ -5290,39 +6318,44 @@ TStorePbBlob::~TStorePbBlob() {
     // save if necessary
     if (FAccess != faRdOnly) {
         TEnv::Logger->OnStatus(TStr::Fmt("Saving store '%s'...", GetStoreNm().CStr()));
-        // save base store
-        TFOut BaseFOut(StoreFNm + ".BaseStore");
-        SaveStore(BaseFOut);
-        // save store parameters
-        TFOut FOut(StoreFNm + "PgBlobStore");
-        // save parameters about primary field
-        RecNmFieldP.Save(FOut);
-        PrimaryFieldId.Save(FOut);
-        if (PrimaryFieldType == oftInt) {
-            PrimaryIntIdH.Save(FOut);
-        } else if (PrimaryFieldType == oftUInt64) {
-            PrimaryUInt64IdH.Save(FOut);
-        } else if (PrimaryFieldType == oftFlt) {
-            PrimaryFltIdH.Save(FOut);
-        } else if (PrimaryFieldType == oftTm) {
-            PrimaryTmMSecsIdH.Save(FOut);
-        } else {
-            PrimaryStrIdH.Save(FOut);
-        }
-        // save time window
-        WndDesc.Save(FOut);
-        // save data
-        SerializatorCache->Save(FOut);
-        SerializatorMem->Save(FOut);
-
-        RecIdBlobPtH.Save(FOut);
-        RecIdBlobPtHMem.Save(FOut);
-        RecIdCounter.Save(FOut);
+        SaveParams();
     } else {
         TEnv::Logger->OnStatus("No saving of generic store " + GetStoreNm() + " neccessary!");
     }
 }
 
+void TStorePbBlob::SaveParams() const {
+    // save base store
+    TFOut BaseFOut(StoreFNm + ".BaseStore");
+    SaveStore(BaseFOut);
+    // save store parameters
+    TFOut FOut(StoreFNm + "PgBlobStore");
+    // save parameters about primary field
+    RecNmFieldP.Save(FOut);
+    PrimaryFieldId.Save(FOut);
+    if (PrimaryFieldType == oftInt) {
+        PrimaryIntIdH.Save(FOut);
+    } else if (PrimaryFieldType == oftUInt64) {
+        PrimaryUInt64IdH.Save(FOut);
+    } else if (PrimaryFieldType == oftFlt) {
+        PrimaryFltIdH.Save(FOut);
+    } else if (PrimaryFieldType == oftTm) {
+        PrimaryTmMSecsIdH.Save(FOut);
+    } else {
+        PrimaryStrIdH.Save(FOut);
+    }
+    // save time window
+    WndDesc.Save(FOut);
+    SavePartitions(StoreFNm + ".Partitions");
+    // save data
+    SerializatorCache->Save(FOut);
+    SerializatorMem->Save(FOut);
+
+    RecIdBlobPtH.Save(FOut);
+    RecIdBlobPtHMem.Save(FOut);
+    RecIdCounter.Save(FOut);
+}
+
 /// Store value into internal storage using TOAST method
 TPgBlobPt TStorePbBlob::ToastVal(const TMemBase& Mem) {
     TVec<TPgBlobPt> Pts;
@@ -5341,6 +6374,7 @@ TPgBlobPt TStorePbBlob::ToastVal(const TMemBase& Mem) {
 
 /// Retrieve value that is saved using TOAST method from storage
 void TStorePbBlob::UnToastVal(const TPgBlobPt& Pt, TMem& Mem) {
+    TLock Lock(PgBlobLock);
     TVec<TPgBlobPt> Pts;
     TThinMIn MIn = DataBlob->Get(Pt);
     Pts.Load(MIn);
@@ -5679,7 +6713,14 @@ TWPt<TBase> LoadBase(const TStr& FPath, const TFAccess& FAccess, const uint64& I
     const bool& InitP, const int& SplitLen) {
 
     InfoLog("Loading base created from schema definition");
-    TWPt<TBase> Base = TBase::Load(FPath, FAccess, IndexCacheSize, IndexTypeCacheSizeH, SplitLen);
+    // write-ahead log is left behind only when the base was not closed, so its
+    // blob bases are not marked as closed and need to be opened in restore mode
+    TFAccess BaseFAccess = FAccess;
+    if (FAccess == faUpdate && TFile::Exists(TBaseWal::GetFNm(FPath))) {
+        InfoLog("Base was not closed, opening in restore mode to replay write-ahead log");
+        BaseFAccess = faRestore;
+    }
+    TWPt<TBase> Base = TBase::Load(FPath, BaseFAccess, IndexCacheSize, IndexTypeCacheSizeH, SplitLen);
     // load stores
     InfoLog("Loading stores");
     // read store names from file
@@ -5696,7 +6737,7 @@ TWPt<TBase> LoadBase(const TStr& FPath, const TFAccess& FAccess, const uint64& I
             StoreNmCacheSizeH.GetDat(StoreNm).Val : DefStoreCacheSize;
         PStore Store;
         if (StoreType == "TStorePbBlob") {
-            Store = new TStorePbBlob(Base, FPath + StoreNm, FAccess, StoreCacheSize);
+            Store = new TStorePbBlob(Base, FPath + StoreNm, Base->GetFAccess(), StoreCacheSize);
         } else {
             Store = new TStoreImpl(Base, FPath + StoreNm, StoreCacheSize);
         }
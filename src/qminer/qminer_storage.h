@@ -19,7 +19,8 @@ namespace TStorage {
 /// Location to where field is serialized
 typedef enum {
     slMemory, ///< in-memory storage
-    slDisk    ///< disk storage with most-recently-used memory cache
+    slDisk,   ///< disk storage with most-recently-used memory cache
+    slColumn  ///< in-memory storage with one dense vector per field (fixed-width fields only)
 } TStoreLoc;
 
 ///////////////////////////////
@@ -61,6 +62,10 @@ public:
     TStr WordVocName;
     /// Tokenizer (used by inverted index)
     PTokenizer Tokenizer;
+    /// Store child vectors compressed (used by inverted index)
+    TBool CompressP;
+    /// Keep nodes on disk (used by linear and location index)
+    TBool PagedP;
 
 public:
     TIndexKeyEx() {}
@@ -234,6 +239,8 @@ public:
 
     bool IsValId(const uint64& ValId) const;
     void GetVal(const uint64& ValId, TMem& Val) const;
+    /// Get value by reference, without copying. Valid until the value is changed or deleted.
+    const TMem& GetValRef(const uint64& ValId) const;
     uint64 AddVal(const TMem& Val);
     void SetVal(const uint64& ValId, const TMem& Val);
     void DelVals(int Vals);
@@ -243,6 +250,8 @@ public:
     uint64 GetLastValId() const;
 
     int PartialFlush(int WndInMsec = 500);
+    /// Save dirty records and the blob pointers, keeping the records loaded
+    void Save();
     void LoadAll();
 
     TBlobBsStats GetBlobBsStats() { return BlobStorage->GetStats(); }
@@ -254,6 +263,148 @@ private:
 #endif
 };
 
+///////////////////////////////
+/// Column storage.
+/// Keeps values of fixed-width fields in dense per-field vectors indexed by record id,
+/// so scanning one field does not touch serializations of whole records. Integer,
+/// byte and boolean values are kept as int64, uint64 and time (milliseconds) as uint64
+/// and numeric values as double. Each column is saved to its own file.
+class TColumnStorage {
+private:
+    /// Values of one field for all the records
+    class TColumn {
+    public:
+        /// Field ID
+        TInt FieldId;
+        /// Field name, used for column file name and parsing JSon records
+        TStr FieldNm;
+        /// Field type
+        TInt FieldType;
+        /// Can values be null
+        TBool NullableP;
+        /// Default value if value not specified
+        PJsonVal DefaultVal;
+        /// Values for integer, byte and boolean fields
+        TVec<TInt64, int64> IntV;
+        /// Values for uint64 and time fields
+        TVec<TUInt64, int64> UInt64V;
+        /// Values for numeric fields
+        TVec<TFlt, int64> FltV;
+        /// Null flags
+        TVec<TBool, int64> NullV;
+        /// Changed since last saved, not serialized
+        TBool DirtyP;
+
+    public:
+        TColumn() { }
+        TColumn(const int& _FieldId, const TFieldDesc& FieldDesc, const PJsonVal& _DefaultVal);
+        TColumn(TSIn& SIn) { Load(SIn); }
+
+        void Load(TSIn& SIn);
+        void Save(TSOut& SOut) const;
+
+        bool IsInt() const;
+        bool IsUInt64() const;
+        bool IsFlt() const;
+
+        /// Number of values in the column
+        int64 Len() const { return NullV.Len(); }
+        /// Append empty value
+        void AddVal();
+        /// Remove first `Vals' values
+        void DelVals(const int64& Vals);
+        /// Keep only first `Vals' values
+        void Trunc(const int64& Vals);
+        /// Set value at given position from JSon
+        void SetJsonVal(const int64& ValN, const PJsonVal& JsonVal);
+        /// Set value at given position from record batch
+        void SetBatchVal(const int64& ValN, const TRecBatch& RecBatch, const int& RecN);
+    };
+
+private:
+    /// Storage filename prefix, column files have field name appended
+    TStr FNm;
+    /// Access type with which the storage is opened
+    TFAccess Access;
+    /// ID of the first record
+    TUInt64 FirstValId;
+    /// Columns
+    TVec<TColumn> ColV;
+    /// Map from field ID to column position in ColV (-1 when field has no column)
+    TIntV FieldIdColNV;
+
+    /// Get file name of the column
+    TStr GetColFNm(const TStr& FieldNm) const { return FNm + "." + FieldNm; }
+    /// Get column of a field
+    const TColumn& GetCol(const int& FieldId) const { return ColV[FieldIdColNV[FieldId]]; }
+    /// Get column of a field
+    TColumn& GetCol(const int& FieldId) { return ColV[FieldIdColNV[FieldId]]; }
+    /// Get position of record in column vectors
+    int64 GetValN(const uint64& ValId) const { return (int64)(ValId - FirstValId); }
+    /// Remove partially added record from all columns
+    void UndoAddVal(const int64& ValN);
+    /// Save column to its file
+    void SaveCol(TColumn& Col);
+
+public:
+    TColumnStorage(const TStr& _FNm, const TFAccess& _Access):
+        FNm(_FNm), Access(_Access), FirstValId() { }
+    ~TColumnStorage();
+
+    /// Can fields of this type be stored in columns
+    static bool IsFieldType(const TFieldDesc& FieldDesc);
+
+    // asserts if we are allowed to change stuff
+    void AssertReadOnly() const;
+
+    /// Create new empty column for a field
+    void AddField(const int& FieldId, const TFieldDesc& FieldDesc, const PJsonVal& DefaultVal);
+    /// Load column of a field from its file
+    void LoadField(const int& FieldId, const TStr& FieldNm);
+    /// Is field stored in columns
+    bool IsFieldId(const int& FieldId) const {
+        return FieldId < FieldIdColNV.Len() && FieldIdColNV[FieldId] != -1; }
+    /// Do we have any columns
+    bool Empty() const { return ColV.Empty(); }
+
+    bool IsValId(const uint64& ValId) const;
+    /// Add new record, values are parsed from JSon
+    uint64 AddVal(const PJsonVal& RecVal);
+    /// Add new record, values are read from the record batch
+    uint64 AddVal(const TRecBatch& RecBatch, const int& RecN);
+    /// Update values of the fields present in the JSon
+    void SetVal(const uint64& ValId, const PJsonVal& RecVal);
+    /// Delete first `Vals' records
+    void DelVals(const int& Vals);
+    /// Remove the last added record, used to roll back a failed insert
+    void DelLastVal();
+
+    uint64 Len() const;
+    uint64 GetFirstValId() const { return FirstValId; }
+    uint64 GetLastValId() const { return FirstValId + Len() - 1; }
+
+    bool IsFieldNull(const uint64& ValId, const int& FieldId) const;
+    int64 GetFieldInt64(const uint64& ValId, const int& FieldId) const;
+    uint64 GetFieldUInt64(const uint64& ValId, const int& FieldId) const;
+    double GetFieldFlt(const uint64& ValId, const int& FieldId) const;
+    /// Get values of a field for a block of records
+    void GetFieldInt64Block(const TUInt64V& ValIdV, const int& FieldId, TVec<TInt64>& ValV, TBoolV& NullV) const;
+    /// Get values of a field for a block of records
+    void GetFieldUInt64Block(const TUInt64V& ValIdV, const int& FieldId, TUInt64V& ValV, TBoolV& NullV) const;
+    /// Get values of a field for a block of records
+    void GetFieldFltBlock(const TUInt64V& ValIdV, const int& FieldId, TFltV& ValV, TBoolV& NullV) const;
+
+    void SetFieldNull(const uint64& ValId, const int& FieldId);
+    void SetFieldInt64(const uint64& ValId, const int& FieldId, const int64& Int64);
+    void SetFieldUInt64(const uint64& ValId, const int& FieldId, const uint64& UInt64);
+    void SetFieldFlt(const uint64& ValId, const int& FieldId, const double& Flt);
+
+    /// Save all columns to their files
+    void Save();
+    /// Save changed columns until the time window runs out, returns number of saved columns
+    int PartialFlush(int WndInMsec = 500);
+};
+
 //////////////////////////////////////////////////////////////////////////////
 /// API for storing large fields.
 class TToaster {
@@ -497,6 +648,12 @@ private:
     /// parse variable-length field JSon value and serialize it accordingly to it's type
     void SetVarJsonVal(TMem& RecMem, TMOut& SOut, const TFieldSerialDesc& FieldSerialDesc,
         const TFieldDesc& FieldDesc, const PJsonVal& JsonVal);
+    /// Serialize fixed-length type field value from a record batch
+    void SetFixedBatchVal(TMem& RecMem, const TFieldSerialDesc& FieldSerialDesc,
+        const TFieldDesc& FieldDesc, const TRecBatch& RecBatch, const int& RecN);
+    /// Serialize variable-length type field value from a record batch
+    void SetVarBatchVal(TMem& RecMem, TMOut& SOut, const TFieldSerialDesc& FieldSerialDesc,
+        const TFieldDesc& FieldDesc, const TRecBatch& RecBatch, const int& RecN);
     /// copy variable-length field from InRecMem to FixedMem and SOut
     void CopyFieldVar(const TMemBase& InRecMem, TMem& FixedMem, TMOut& VarSOut, const TFieldSerialDesc& FieldSerialDesc);
 
@@ -522,6 +679,8 @@ public:
 
     /// Serialize JSon object
     void Serialize(const PJsonVal& RecVal, TMem& RecMem, const TWPt<TStore>& Store);
+    /// Serialize RecN-th record from a record batch, without going through JSon
+    void Serialize(const TRecBatch& RecBatch, const int& RecN, TMem& RecMem, const TWPt<TStore>& Store);
     /// Update existing serialization with updated fields from JSon object
     void SerializeUpdate(const PJsonVal& RecVal, const TMemBase& InRecMem, TMem& OutRecMem,
         const TWPt<TStore>& Store, TIntSet& ChangedFieldIdSet);
@@ -583,6 +742,17 @@ public:
     /// Field getter
     PJsonVal GetFieldJsonVal(TThinMIn& min, const int& FieldId) const;
 
+    /// Block field getter for integer and boolean fields. Reads the field from a block of
+    /// serialized records, with the field location resolved only once for the whole block.
+    void GetFieldInt64Block(const TVec<char*>& RecBfV,
+        const TFieldDesc& FieldDesc, TVec<TInt64>& ValV, TBoolV& NullV) const;
+    /// Block field getter for uint64 and time fields
+    void GetFieldUInt64Block(const TVec<char*>& RecBfV,
+        const TFieldDesc& FieldDesc, TUInt64V& ValV, TBoolV& NullV) const;
+    /// Block field getter for numeric fields
+    void GetFieldFltBlock(const TVec<char*>& RecBfV,
+        const TFieldDesc& FieldDesc, TFltV& ValV, TBoolV& NullV) const;
+
     /// Field getter
     bool IsFieldNull(const TMemBase& RecMem, const int& FieldId) const;
     /// Field getter
@@ -882,10 +1052,26 @@ public:
     void SetFieldJsonVal(const uint64& RecId, const int& FieldId, const PJsonVal& Json) { throw TQmExcept::New("TStoreEmpty does not store records"); };
 };
 
+///////////////////////////////
+/// Record batch insert shared by the stores with native batch support (TStoreImpl, TStorePbBlob).
+/// Stores implement AddBatchRec, which stores a single new record from the batch, and IndexBatchRec.
+/// The rest (primary keys, write-ahead log, batched indexing, joins, partitions, triggers) is done here.
+class TStoreBatch {
+public:
+    /// Add records from the batch, see TStore::AddRecBatch
+    template <class TStoreT>
+    static void AddRecBatch(TStoreT& Store, TRecBatch& RecBatch, TUInt64V& RecIdV, const bool& TriggerEvents);
+    /// Get id of existing record with the same primary field value as in the batch, TUInt64::Mx when none
+    template <class TStoreT>
+    static uint64 GetPrimaryRecId(const TStoreT& Store, const TRecBatch& RecBatch, const int& RecN);
+};
+
 ///////////////////////////////
 /// Implementation of store which can be initialized from a schema.
 class TStoreImpl : public TStore, public TToaster {
 private:
+    friend class TStoreBatch;
+
     /// For temporarily storing inverse joins which need to be indexed after adding records
     struct TFieldJoinDat {
         TWPt<TStore> JoinStore;
@@ -925,6 +1111,13 @@ private:
     TBool DataMemP;
     /// Store for parts of records that should be in-memory
     TInMemStorage DataMem;
+    /// Guards disk cache and lazy loading of in-memory records when read from parallel
+    /// regions or while the background flusher runs, taken by PartialFlush
+    mutable TCriticalSection RecMemLock;
+    /// Flag if we are using column storage
+    TBool DataColumnP;
+    /// Store for fixed-width fields kept in columns
+    TColumnStorage DataColumn;
     /// Serializator to disk
     TRecSerializator *SerializatorCache;
     /// Serializator to memory
@@ -937,18 +1130,32 @@ private:
 
     /// initialize field storage location map
     void InitFieldLocV();
+    /// Save store parameters, primary field map and serializators
+    void SaveParams() const;
     /// Get TMem serialization of record from specified storage
     void GetRecMem(const TStoreLoc& RecLoc, const uint64& RecId, TMem& Rec) const;
     /// Get TMem serialization of record from specified where field is stored
     void GetRecMem(const uint64& RecId, const int& FieldId, TMem& Rec) const;
+    /// Get pointers to serializations of a block of records from specified storage.
+    /// Records from disk, and all records when called from a parallel region, are copied
+    /// to RecMemV, which must be kept while pointers are used.
+    void GetRecBfV(const TStoreLoc& RecLoc, const TUInt64V& RecIdV,
+        TVec<TMem>& RecMemV, TVec<char*>& RecBfV) const;
     /// Set TMem serialization of record to a specified storage
     void PutRecMem(const TStoreLoc& RecLoc, const uint64& RecId, const TMem& Rec);
     /// Set TMem serialization of record to storage where field is stored
     void PutRecMem(const uint64& RecId, const int& FieldId, const TMem& Rec);
+    /// True when called from a parallel region, where record storage reads must be locked
+    static bool IsParallelRead();
+    /// True when record storage reads must be locked, from a parallel region or
+    /// while the background flusher can write the storage out
+    bool IsLockedRead() const;
     /// True when field is stored on disk
     bool IsFieldDisk(const int &FieldId) const;
     /// True when field is stored in-memory
     bool IsFieldInMemory(const int &FieldId) const;
+    /// True when field is stored in column storage
+    bool IsFieldColumn(const int &FieldId) const { return FieldLocV[FieldId] == slColumn; }
     /// Get serializator for given location
     TRecSerializator* GetSerializator(const TStoreLoc& StoreLoc);
     /// Get serializator for given location
@@ -961,6 +1168,13 @@ private:
     inline void DelRecNm(const uint64& RecId);
     /// Do we have a primary field
     bool IsPrimaryField() const { return PrimaryFieldId != -1; }
+    /// Store serialized record after its values were added to the columns, returns its id.
+    /// Removes the column values when storing fails.
+    uint64 AddRecMem(const TMem& CacheRecMem, const TMem& MemRecMem, const uint64& ColumnRecId);
+    /// Store RecN-th record from the batch as a new record, returns its id and serializations
+    uint64 AddBatchRec(const TRecBatch& RecBatch, const int& RecN, TMem& CacheRecMem, TMem& MemRecMem);
+    /// Index record stored by AddBatchRec
+    void IndexBatchRec(const uint64& RecId, const TMem& CacheRecMem, const TMem& MemRecMem);
     /// Set primary field map
     void SetPrimaryField(const uint64& RecId);
     /// Set primary field map for a given string value
@@ -1002,6 +1216,8 @@ public:
     // need to override destructor, to clear cache
     ~TStoreImpl();
 
+    /// Reads from parallel regions lock the record storage
+    bool IsConcurrentRead() const { return true; }
     bool IsRecId(const uint64& RecId) const;
     bool HasRecNm() const { return RecNmFieldP; }
     bool IsRecNm(const TStr& RecNm) const;
@@ -1033,6 +1249,8 @@ public:
 
     /// Add new record
     uint64 AddRec(const PJsonVal& RecVal, const bool& TriggerEvents = true);
+    /// Add batch of new records, serialized directly from the batch columns
+    void AddRecBatch(TRecBatch& RecBatch, TUInt64V& RecIdV, const bool& TriggerEvents = true);
     /// Update existing record
     void UpdateRec(const uint64& RecId, const PJsonVal& RecVal);
 
@@ -1090,6 +1308,16 @@ public:
     /// Get field value using field id (default implementation throws exception)
     PJsonVal GetFieldJsonVal(const uint64& RecId, const int& FieldId) const;
 
+    /// Get values of integer or boolean field for a block of records
+    void GetFieldInt64Block(const TUInt64V& RecIdV, const int& FieldId,
+        TVec<TInt64>& ValV, TBoolV& NullV) const;
+    /// Get values of uint64 or time field for a block of records
+    void GetFieldUInt64Block(const TUInt64V& RecIdV, const int& FieldId,
+        TUInt64V& ValV, TBoolV& NullV) const;
+    /// Get values of numeric field for a block of records
+    void GetFieldFltBlock(const TUInt64V& RecIdV, const int& FieldId,
+        TFltV& ValV, TBoolV& NullV) const;
+
     /// Get field value using field id safely (default implementation throws exception)
     uint64 GetFieldUInt64Safe(const uint64& RecId, const int& FieldId) const;
     /// Get field value using field id safely (default implementation throws exception)
@@ -1152,6 +1380,8 @@ public:
 
     /// Save part of the data, given time-window
     int PartialFlush(int WndInMsec = 500);
+    /// Save all the data, keeping the store open
+    void Flush();
     /// Retrieve performance statistics for this store
     PJsonVal GetStats();
     /// Run verification for whole store
@@ -1165,6 +1395,7 @@ public:
 /// It also uses Paged-BLOB storage engine.
 class TStorePbBlob : public TStore, public TToaster {
 private:
+    friend class TStoreBatch;
 
     /// For temporarily storing inverse joins which need to be
     /// indexed after adding records
@@ -1210,6 +1441,9 @@ private:
     TBool DataMemP;
     /// Store for parts of records that should be in-memory
     PPgBlob DataMem;
+    /// Guards page caches of DataBlob and DataMem when read while the background
+    /// flusher runs, taken by PartialFlush
+    mutable TCriticalSection PgBlobLock;
 
     /// Counter for record IDs
     TUInt64 RecIdCounter;
@@ -1226,6 +1460,8 @@ private:
 
     /// initialize field storage location map
     void InitFieldLocV();
+    /// Save store parameters, primary field map, serializators and record pointers
+    void SaveParams() const;
 
     /// Load page with with given record and return pointer to it
     TThinMIn GetPgBf(const uint64& RecId, const bool& UseMem = false) const;
@@ -1251,6 +1487,10 @@ private:
 
     /// Do we have a primary field
     bool IsPrimaryField() const { return PrimaryFieldId != -1; }
+    /// Store RecN-th record from the batch as a new record, returns its id and serializations
+    uint64 AddBatchRec(const TRecBatch& RecBatch, const int& RecN, TMem& CacheRecMem, TMem& MemRecMem);
+    /// Index record stored by AddBatchRec
+    void IndexBatchRec(const uint64& RecId, const TMem& CacheRecMem, const TMem& MemRecMem);
     /// Set primary field map
     void SetPrimaryField(const uint64& RecId);
     /// Set primary field map for a given string value
@@ -1325,6 +1565,8 @@ public:
 
     /// Add new record
     uint64 AddRec(const PJsonVal& RecVal, const bool& TriggerEvents=true);
+    /// Add batch of new records, serialized directly from the batch columns
+    void AddRecBatch(TRecBatch& RecBatch, TUInt64V& RecIdV, const bool& TriggerEvents = true);
     /// Update existing record
     void UpdateRec(const uint64& RecId, const PJsonVal& RecVal);
 
@@ -1435,6 +1677,8 @@ public:
 
     /// Save part of the data, given time-window
     int PartialFlush(int WndInMsec = 500);
+    /// Save all the data, keeping the store open
+    void Flush();
     /// Retrieve performance statistics for this store
     PJsonVal GetStats();
     /// Run verification for whole store
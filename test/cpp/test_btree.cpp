@@ -0,0 +1,104 @@
+#include <base.h>
+#include <mine.h>
+#include <qminer.h>
+
+#include "microtest.h"
+
+// Paged B-tree index keeps only a bounded number of nodes in memory and
+// returns the same results before and after reloading
+TEST(TBTreeIndexPaged) {
+    typedef TPt<TQm::TBTreeIndex<TInt> > PBTreeIndexInt;
+    const TStr FPath = "./";
+    const TStr BlobFNm = FPath + "test_btree.BTreeDat";
+    const TStr IndexFNm = FPath + "test_btree.dat";
+    const int Vals = 100000;
+    {
+        PBTreeIndexInt Index = TQm::TBTreeIndex<TInt>::New(BlobFNm, 64 * TInt::Kilo);
+        ASSERT_TRUE(Index->IsPaged());
+        for (int ValN = 0; ValN < Vals; ValN++) {
+            Index->AddKey((ValN * 7919) % Vals, ValN);
+        }
+        // 64KB of cache holds far fewer nodes than the tree has
+        ASSERT_TRUE(Index->GetCachedNodes() < 200);
+        for (int ValN = 0; ValN < Vals; ValN += 2) {
+            Index->DelKey((ValN * 7919) % Vals, ValN);
+        }
+        TUInt64V RecIdV; Index->SearchRange(TIntPr(1000, 1999), RecIdV);
+        ASSERT_EQ(RecIdV.Len(), 500);
+        TFOut FOut(IndexFNm); Index->Save(FOut);
+    }
+    {
+        TFIn FIn(IndexFNm);
+        PBTreeIndexInt Index = TQm::TBTreeIndex<TInt>::Load(FIn);
+        Index->Open(BlobFNm, faRdOnly);
+        ASSERT_TRUE(Index->IsPaged());
+        ASSERT_EQ(Index->GetCachedNodes(), 0);
+        TUInt64V RecIdV; Index->SearchRange(TIntPr(1000, 1999), RecIdV);
+        ASSERT_EQ(RecIdV.Len(), 500);
+        for (int RecIdN = 0; RecIdN < RecIdV.Len(); RecIdN++) {
+            const int RecId = (int)RecIdV[RecIdN];
+            ASSERT_EQ(RecId % 2, 1);
+            const int Val = (RecId * 7919) % Vals;
+            ASSERT_TRUE(1000 <= Val && Val <= 1999);
+        }
+        // only the nodes on the paths to the queried leaves were loaded
+        ASSERT_TRUE(Index->GetCachedNodes() < 200);
+    }
+    TFile::DelWc(FPath + "test_btree*");
+}
+
+// In-memory disk store loads trees saved with the memory store
+TEST(TBtreeNodeDiskStoreLoadMemStore) {
+    typedef TBtree::TBtreeNodeMemStore<TInt, TInt, TInt> TMemInternalStore;
+    typedef TBtree::TBtreeNodeMemStore<TInt, TVoid, TInt> TMemLeafStore;
+    typedef TBtree::TBtreeNodeDiskStore<TInt, TInt, TInt> TDiskInternalStore;
+    typedef TBtree::TBtreeNodeDiskStore<TInt, TVoid, TInt> TDiskLeafStore;
+    typedef TBtree::TBtreeOps<TInt, TVoid, TCmp<TInt>, TInt, TMemInternalStore, TMemLeafStore> TMemBtree;
+    typedef TBtree::TBtreeOps<TInt, TVoid, TCmp<TInt>, TInt, TDiskInternalStore, TDiskLeafStore> TDiskBtree;
+
+    TMOut MOut;
+    {
+        TPt<TMemInternalStore> InternalStore = new TMemInternalStore;
+        TPt<TMemLeafStore> LeafStore = new TMemLeafStore;
+        TMemBtree Btree(InternalStore, LeafStore, 4, 8, false, false);
+        for (int Val = 0; Val < 1000; Val++) { Btree.Add(Val); }
+        InternalStore.Save(MOut); LeafStore.Save(MOut); Btree.Save(MOut);
+    }
+    PSIn SIn = MOut.GetSIn();
+    TPt<TDiskInternalStore> InternalStore(*SIn);
+    TPt<TDiskLeafStore> LeafStore(*SIn);
+    TDiskBtree Btree(*SIn, InternalStore, LeafStore);
+    ASSERT_FALSE(InternalStore->IsPaged());
+    TIntV ValV; Btree.RangeQuery(100, 199, ValV);
+    ASSERT_EQ(ValV.Len(), 100);
+    ASSERT_EQ(ValV[0], 100);
+    ASSERT_EQ(ValV.Last(), 199);
+}
+
+// Checking out a node twice returns the same copy, even when the node was
+// evicted from the cache in between
+TEST(TBtreeNodeDiskStoreCheckOutTwice) {
+    typedef TBtree::TBtreeNodeDiskStore<TInt, TVoid, TInt> TDiskLeafStore;
+    const TStr BlobFNm = "./test_btree_checkout.BTreeDat";
+    {
+        // cache too small to hold more than one node
+        TPt<TDiskLeafStore> Store = new TDiskLeafStore(TMBlobBs::New(BlobFNm, faCreate), 1);
+        const TInt NodeId1 = Store->AllocNode();
+        const TInt NodeId2 = Store->AllocNode();
+        Store->Flush();
+        TDiskLeafStore::TNode* Node = Store->CheckOutNode(NodeId1);
+        Node->v.Add(TDiskLeafStore::TNode::TKd(7));
+        // evicts the first node from the cache
+        Store->CheckInNode(NodeId2, Store->CheckOutNode(NodeId2), false);
+        ASSERT_TRUE(Store->CheckOutNode(NodeId1) == Node);
+        Store->CheckInNode(NodeId1, Node, true);
+        Store->CheckInNode(NodeId1, Node, true);
+        Store->IAssertNoCheckouts();
+        // the change is not lost when the node is loaded again
+        Store->CheckInNode(NodeId2, Store->CheckOutNode(NodeId2), false);
+        Node = Store->CheckOutNode(NodeId1);
+        ASSERT_EQ(Node->v.Len(), 1);
+        Store->CheckInNode(NodeId1, Node, false);
+    }
+    TFile::DelWc("./test_btree_checkout*");
+}
@@ -0,0 +1,143 @@
+#include <base.h>
+#include <mine.h>
+
+#include "microtest.h"
+
+// three well separated blobs, more instances than fit into one assignment block
+static void GenBlobs(const int& NInst, TFltVV& FtrVV, TIntV& ClustV) {
+    const double CenterVV[3][2] = {{0, 0}, {10, 10}, {-10, 10}};
+    TRnd Rnd(1);
+    FtrVV.Gen(2, NInst);
+    ClustV.Gen(NInst);
+    for (int InstN = 0; InstN < NInst; InstN++) {
+        const int ClustN = InstN % 3;
+        FtrVV(0, InstN) = CenterVV[ClustN][0] + Rnd.GetNrmDev();
+        FtrVV(1, InstN) = CenterVV[ClustN][1] + Rnd.GetNrmDev();
+        ClustV[InstN] = ClustN;
+    }
+}
+
+// initial centroids, one in each of the blobs
+static void GenInitCentroids(const TFltVV& FtrVV, TFltVV& CentroidVV) {
+    CentroidVV.Gen(2, 3);
+    for (int ClustN = 0; ClustN < 3; ClustN++) {
+        CentroidVV(0, ClustN) = FtrVV(0, ClustN);
+        CentroidVV(1, ClustN) = FtrVV(1, ClustN);
+    }
+}
+
+// checks that the assignments match the ones computed from the whole distance matrix
+template <class TDataType, class TCentroidType>
+static void AssertAssign(const TClustering::TAbsKMeans<TCentroidType>& Model, const TDataType& FtrVV) {
+    TFltVV DistVV; Model.GetDistMetric()->GetQuasiDistVV(Model.GetCentroidVV(), FtrVV, DistVV);
+    TIntV ExpectedV; TLinAlgSearch::GetColMinIdxV(DistVV, ExpectedV);
+    TIntV AssignV; Model.Assign(FtrVV, AssignV);
+    ASSERT_EQ(ExpectedV.Len(), AssignV.Len());
+    for (int InstN = 0; InstN < AssignV.Len(); InstN++) {
+        ASSERT_EQ(ExpectedV[InstN], AssignV[InstN]);
+    }
+}
+
+// checks that the instances of each true cluster share one centroid
+static void AssertClusters(const TIntV& AssignV, const TIntV& ClustV) {
+    TIntV ClustToCentroidV(3); ClustToCentroidV.PutAll(-1);
+    for (int InstN = 0; InstN < AssignV.Len(); InstN++) {
+        const int ClustN = ClustV[InstN];
+        if (ClustToCentroidV[ClustN] == -1) { ClustToCentroidV[ClustN] = AssignV[InstN]; }
+        ASSERT_EQ(ClustToCentroidV[ClustN], AssignV[InstN]);
+    }
+    ASSERT_NEQ(ClustToCentroidV[0], ClustToCentroidV[1]);
+    ASSERT_NEQ(ClustToCentroidV[0], ClustToCentroidV[2]);
+    ASSERT_NEQ(ClustToCentroidV[1], ClustToCentroidV[2]);
+}
+
+TEST(TDnsKMeansAssignBlocked) {
+    TFltVV FtrVV; TIntV ClustV; GenBlobs(5000, FtrVV, ClustV);
+    TFltVV InitCentroidVV; GenInitCentroids(FtrVV, InitCentroidVV);
+    TClustering::TDenseKMeans KMeans(3, TRnd(1));
+    KMeans.Apply(FtrVV, InitCentroidVV, true, 100);
+
+    AssertAssign(KMeans, FtrVV);
+    TIntV AssignV; KMeans.Assign(FtrVV, AssignV);
+    AssertClusters(AssignV, ClustV);
+}
+
+TEST(TDnsKMeansThreadsAgree) {
+    TFltVV FtrVV; TIntV ClustV; GenBlobs(5000, FtrVV, ClustV);
+    TVec<TIntFltKdV> SpFtrVV; TLinAlgTransform::Sparse(FtrVV, SpFtrVV);
+
+    TFltVV InitCentroidVV; GenInitCentroids(FtrVV, InitCentroidVV);
+
+    TFltVV CentroidVV[2];
+    TFltVV SpCentroidVV[2];
+    const int ThreadsV[2] = {1, 4};
+    for (int RunN = 0; RunN < 2; RunN++) {
+#ifdef GLib_OPENMP
+        omp_set_num_threads(ThreadsV[RunN]);
+#endif
+        TClustering::TDenseKMeans KMeans(3, TRnd(1));
+        KMeans.Apply(FtrVV, InitCentroidVV, true, 100);
+        CentroidVV[RunN] = KMeans.GetCentroidVV();
+
+        TClustering::TDenseKMeans SpKMeans(3, TRnd(1));
+        SpKMeans.Apply(SpFtrVV, InitCentroidVV, true, 100);
+        SpCentroidVV[RunN] = SpKMeans.GetCentroidVV();
+    }
+
+    for (int RowN = 0; RowN < 2; RowN++) {
+        for (int ClustN = 0; ClustN < 3; ClustN++) {
+            ASSERT_NEAR(CentroidVV[0](RowN, ClustN), CentroidVV[1](RowN, ClustN), 1e-8);
+            ASSERT_NEAR(CentroidVV[0](RowN, ClustN), SpCentroidVV[1](RowN, ClustN), 1e-8);
+        }
+    }
+}
+
+TEST(TSparseKMeansCentroids) {
+    TFltVV FtrVV; TIntV ClustV; GenBlobs(5000, FtrVV, ClustV);
+    TVec<TIntFltKdV> SpFtrVV; TLinAlgTransform::Sparse(FtrVV, SpFtrVV);
+    TFltVV InitCentroidVV; GenInitCentroids(FtrVV, InitCentroidVV);
+
+    TClustering::TDenseKMeans KMeans(3, TRnd(1));
+    KMeans.Apply(FtrVV, InitCentroidVV, true, 100);
+    TClustering::TSparseKMeans SpKMeans(3, TRnd(1));
+    SpKMeans.Apply(SpFtrVV, InitCentroidVV, true, 100);
+    AssertAssign(SpKMeans, SpFtrVV);
+
+    // both represent the same centroids
+    TFltVV SpCentroidVV; TLinAlgTransform::Full(SpKMeans.GetCentroidVV(), SpCentroidVV, 2);
+    for (int RowN = 0; RowN < 2; RowN++) {
+        for (int ClustN = 0; ClustN < 3; ClustN++) {
+            const double Expected = KMeans.GetCentroidVV()(RowN, ClustN);
+            ASSERT_NEAR(Expected, SpCentroidVV(RowN, ClustN), 1e-8);
+        }
+    }
+}
+
+TEST(TDnsKMeansMiniBatch) {
+    TFltVV FtrVV; TIntV ClustV; GenBlobs(30000, FtrVV, ClustV);
+    TFltVV InitCentroidVV; GenInitCentroids(FtrVV, InitCentroidVV);
+
+    TClustering::TDenseKMeans KMeans(3, TRnd(1));
+    KMeans.SetBatchSize(2000);
+    ASSERT_EQ(2000, KMeans.GetBatchSize());
+    KMeans.Apply(FtrVV, InitCentroidVV, true, 20);
+
+    // mini-batch centroids approach the means of the blobs
+    TIntV AssignV; KMeans.Assign(FtrVV, AssignV);
+    AssertClusters(AssignV, ClustV);
+    const double CenterVV[3][2] = {{0, 0}, {10, 10}, {-10, 10}};
+    for (int ClustN = 0; ClustN < 3; ClustN++) {
+        ASSERT_NEAR(CenterVV[ClustN][0], KMeans.GetCentroidVV()(0, ClustN), 0.2);
+        ASSERT_NEAR(CenterVV[ClustN][1], KMeans.GetCentroidVV()(1, ClustN), 0.2);
+    }
+}
+
+TEST(TDpMeansBlocked) {
+    TFltVV FtrVV; TIntV ClustV; GenBlobs(5000, FtrVV, ClustV);
+    TClustering::TDpMeans<TFltVV> DpMeans(6, 1, 10, TRnd(1));
+    DpMeans.Apply(FtrVV, true, 100);
+
+    // every blob needs its own centroid
+    ASSERT_TRUE(DpMeans.GetClusts() >= 3);
+    AssertAssign(DpMeans, FtrVV);
+}
@@ -0,0 +1,81 @@
+#include <base.h>
+#include <mine.h>
+#include <qminer.h>
+
+#include "microtest.h"
+
+// Great-circle distance, used to check the index
+double GetTestDist(const TFltPr& Loc1, const TFltPr& Loc2) {
+    const double Lat1 = Loc1.Val1 * TMath::Pi / 180.0, Lat2 = Loc2.Val1 * TMath::Pi / 180.0;
+    const double SinLat = sin(0.5 * (Lat2 - Lat1));
+    const double SinLon = sin(0.5 * (Loc2.Val2 - Loc1.Val2) * TMath::Pi / 180.0);
+    const double A = SinLat * SinLat + cos(Lat1) * cos(Lat2) * SinLon * SinLon;
+    return 2.0 * 6371010.0 * asin(TFlt::GetMn(1.0, sqrt(A)));
+}
+
+// Nearest Limit records within Radius, sorted by record id
+void GetTestNn(const TFltPrV& LocV, const TBoolV& DelV, const TFltPr& Loc,
+        const double& Radius, const int& Limit, TUInt64V& RecIdV) {
+
+    TFltUInt64PrV DistRecIdV;
+    for (int RecId = 0; RecId < LocV.Len(); RecId++) {
+        if (DelV[RecId]) { continue; }
+        const double Dist = GetTestDist(Loc, LocV[RecId]);
+        if (Dist <= Radius) { DistRecIdV.Add(TFltUInt64Pr(Dist, RecId)); }
+    }
+    DistRecIdV.Sort();
+    if (DistRecIdV.Len() > Limit) { DistRecIdV.Trunc(Limit); }
+    RecIdV.Clr();
+    for (int RecN = 0; RecN < DistRecIdV.Len(); RecN++) { RecIdV.Add(DistRecIdV[RecN].Val2); }
+    RecIdV.Sort();
+}
+
+// Geohash index returns the same records as a linear scan, also after reload
+TEST(TGeoHashIndexQuery) {
+    const TStr FPath = "./";
+    const TStr BlobFNm = FPath + "test_geohash.GeoDat";
+    const TStr IndexFNm = FPath + "test_geohash.dat";
+    // points around Ljubljana and around the antimeridian
+    TRnd Rnd(1); TFltPrV LocV; TBoolV DelV;
+    for (int RecId = 0; RecId < 20000; RecId++) {
+        if (RecId % 2 == 0) {
+            LocV.Add(TFltPr(46.0 + Rnd.GetUniDev(), 14.0 + Rnd.GetUniDev()));
+        } else {
+            LocV.Add(TFltPr(-10.0 + Rnd.GetUniDev(), 179.5 + Rnd.GetUniDev()));
+            if (LocV.Last().Val2 >= 180.0) { LocV.Last().Val2 -= 360.0; }
+        }
+        DelV.Add(false);
+    }
+    TFltPrV QueryLocV = TFltPrV::GetV(TFltPr(46.5, 14.5), TFltPr(46.05, 14.5),
+        TFltPr(-9.5, 180.0), TFltPr(-9.5, -179.9), TFltPr(0.0, 0.0));
+    {
+        TQm::PGeoHashIndex Index = TQm::TGeoHashIndex::New(BlobFNm, 64 * TInt::Kilo);
+        for (int RecId = 0; RecId < LocV.Len(); RecId++) { Index->AddKey(LocV[RecId], RecId); }
+        for (int RecId = 0; RecId < LocV.Len(); RecId += 3) { Index->DelKey(LocV[RecId], RecId); DelV[RecId] = true; }
+        ASSERT_TRUE(Index->GetCachedNodes() < 200);
+        for (int QueryN = 0; QueryN < QueryLocV.Len(); QueryN++) {
+            TUInt64V RecIdV, TestRecIdV;
+            Index->SearchRange(QueryLocV[QueryN], 5000.0, 1000000, RecIdV);
+            GetTestNn(LocV, DelV, QueryLocV[QueryN], 5000.0, 1000000, TestRecIdV);
+            ASSERT_EQ(RecIdV.Len(), TestRecIdV.Len());
+            ASSERT_TRUE(RecIdV == TestRecIdV);
+            Index->SearchRange(QueryLocV[QueryN], 50000.0, 10, RecIdV);
+            GetTestNn(LocV, DelV, QueryLocV[QueryN], 50000.0, 10, TestRecIdV);
+            ASSERT_TRUE(RecIdV == TestRecIdV);
+        }
+        TFOut FOut(IndexFNm); Index->Save(FOut);
+    }
+    {
+        TFIn FIn(IndexFNm);
+        TQm::PGeoHashIndex Index = TQm::TGeoHashIndex::Load(FIn);
+        Index->Open(BlobFNm, faRdOnly);
+        for (int QueryN = 0; QueryN < QueryLocV.Len(); QueryN++) {
+            TUInt64V RecIdV, TestRecIdV;
+            Index->SearchNn(QueryLocV[QueryN], 25, RecIdV);
+            GetTestNn(LocV, DelV, QueryLocV[QueryN], TFlt::Mx, 25, TestRecIdV);
+            ASSERT_EQ(RecIdV.Len(), 25);
+            ASSERT_TRUE(RecIdV == TestRecIdV);
+        }
+    }
+    TFile::DelWc(FPath + "test_geohash*");
+}
@@ -0,0 +1,130 @@
+#include <base.h>
+#include <mine.h>
+#include <qminer.h>
+
+#include "microtest.h"
+
+// Galloping search finds first element not smaller than the given one
+TEST(TGixGallopGetLowerBoundN) {
+    TIntV ItemV;
+    for (int ItemN = 0; ItemN < 1000; ItemN++) { ItemV.Add(2 * ItemN); }
+    ASSERT_EQ(TGixGallop::GetLowerBoundN(ItemV, 0, TInt(-1)), 0);
+    ASSERT_EQ(TGixGallop::GetLowerBoundN(ItemV, 0, TInt(0)), 0);
+    ASSERT_EQ(TGixGallop::GetLowerBoundN(ItemV, 0, TInt(1)), 1);
+    ASSERT_EQ(TGixGallop::GetLowerBoundN(ItemV, 0, TInt(998)), 499);
+    ASSERT_EQ(TGixGallop::GetLowerBoundN(ItemV, 0, TInt(1997)), 999);
+    ASSERT_EQ(TGixGallop::GetLowerBoundN(ItemV, 0, TInt(1999)), 1000);
+    ASSERT_EQ(TGixGallop::GetLowerBoundN(ItemV, 600, TInt(10)), 600);
+    ASSERT_EQ(TGixGallop::GetLowerBoundN(ItemV, 1000, TInt(10)), 1000);
+    for (int Val = 0; Val < 2000; Val += 3) {
+        ASSERT_EQ(TGixGallop::GetLowerBoundN(ItemV, 0, TInt(Val)), (Val + 1) / 2);
+    }
+}
+
+// Intersection of a rare and a frequent key loads only child vectors of the
+// frequent key which can contain matches
+TEST(TGixAndSkipChildVectors) {
+    typedef TGix<TInt, TInt> TIntGix;
+    typedef TGixExpItem<TInt, TInt, TInt> TIntGixExpItem;
+    const TStr FPath = "./";
+    TGixDefItemHandler<TInt, TInt> ItemHandler;
+    TGixDefMerger<TInt, TInt, TInt> Merger;
+    {
+        TPt<TIntGix> Gix = TIntGix::New("test_gix_and", FPath, faCreate, &ItemHandler, 100000000, 100, true, 50, 200);
+        for (int ItemN = 0; ItemN < 10000; ItemN++) { Gix->AddItem(1, ItemN); }
+        Gix->AddItem(2, 5); Gix->AddItem(2, 5000); Gix->AddItem(2, 9999); Gix->AddItem(2, 20000);
+        for (int ItemN = 0; ItemN < 10000; ItemN += 2) { Gix->AddItem(3, ItemN); }
+        // make sure all item sets and child vectors are on disk
+        Gix->Flush(); Gix->ResetStats();
+
+        TIntV ResItemV;
+        TPt<TIntGixExpItem> ExpItem = TIntGixExpItem::NewAndV(Gix, TIntV::GetV(1, 2));
+        ExpItem->Eval(Gix, ResItemV, &Merger);
+        ASSERT_EQ(ResItemV.Len(), 3);
+        ASSERT_EQ(ResItemV[0], 5);
+        ASSERT_EQ(ResItemV[1], 5000);
+        ASSERT_EQ(ResItemV[2], 9999);
+        // two item sets and at most three child vectors
+        ASSERT_TRUE(Gix->GetBlobStats().Gets <= 5);
+
+        // three keys, independent of the order given
+        ExpItem = TIntGixExpItem::NewAndV(Gix, TIntV::GetV(3, 1, 2));
+        ExpItem->Eval(Gix, ResItemV, &Merger);
+        ASSERT_EQ(ResItemV.Len(), 1);
+        ASSERT_EQ(ResItemV[0], 5000);
+
+        // missing key gives empty result
+        ExpItem = TIntGixExpItem::NewAndV(Gix, TIntV::GetV(1, 4));
+        ExpItem->Eval(Gix, ResItemV, &Merger);
+        ASSERT_EQ(ResItemV.Len(), 0);
+
+        // intersection of two frequent keys
+        ExpItem = TIntGixExpItem::NewAndV(Gix, TIntV::GetV(1, 3));
+        ExpItem->Eval(Gix, ResItemV, &Merger);
+        ASSERT_EQ(ResItemV.Len(), 5000);
+        for (int ItemN = 0; ItemN < ResItemV.Len(); ItemN++) {
+            ASSERT_EQ(ResItemV[ItemN], 2 * ItemN);
+        }
+    }
+    TFile::DelWc(FPath + "test_gix_and.*");
+}
+
+// Deleting several items under one key gives the same item set as deleting them one by one
+TEST(TGixDelItemV) {
+    typedef TGix<TInt, TInt> TIntGix;
+    const TStr FPath = "./";
+    TGixDefItemHandler<TInt, TInt> ItemHandler;
+    {
+        TPt<TIntGix> Gix = TIntGix::New("test_gix_delv", FPath, faCreate, &ItemHandler, 100000000, 100, true, 50, 200);
+        for (int ItemN = 0; ItemN < 1000; ItemN++) { Gix->AddItem(1, ItemN); Gix->AddItem(2, ItemN); }
+        TIntV DelItemV;
+        for (int ItemN = 0; ItemN < 1000; ItemN += 3) { DelItemV.Add(ItemN); }
+        Gix->DelItemV(1, DelItemV);
+        for (int ItemN = 0; ItemN < DelItemV.Len(); ItemN++) { Gix->DelItem(2, DelItemV[ItemN]); }
+        // deleting from missing key does nothing
+        Gix->DelItemV(3, DelItemV);
+        ASSERT_FALSE(Gix->IsKey(3));
+
+        TIntV ItemV1, ItemV2;
+        Gix->GetItemV(1, ItemV1);
+        Gix->GetItemV(2, ItemV2);
+        ASSERT_EQ(ItemV1.Len(), 1000 - DelItemV.Len());
+        ASSERT_EQ(ItemV1.Len(), ItemV2.Len());
+        for (int ItemN = 0; ItemN < ItemV1.Len(); ItemN++) {
+            ASSERT_EQ(ItemV1[ItemN], ItemV2[ItemN]);
+            ASSERT_TRUE(ItemV1[ItemN] % 3 != 0);
+        }
+    }
+    TFile::DelWc(FPath + "test_gix_delv.*");
+}
+
+// Every read counts once in cache statistics, also when the cached item set
+// has to be merged first
+TEST(TGixReadCacheStats) {
+    typedef TGix<TInt, TInt> TIntGix;
+    const TStr FPath = "./";
+    TGixDefItemHandler<TInt, TInt> ItemHandler;
+    {
+        TPt<TIntGix> Gix = TIntGix::New("test_gix_stats", FPath, faCreate, &ItemHandler, 100000000, 100, true, 50, 200);
+        for (int ItemN = 0; ItemN < 1000; ItemN++) { Gix->AddItem(1, ItemN); }
+        TIntV ItemV;
+        // cached, but not merged
+        Gix->AddItem(1, 5000);
+        uint64 Hits = Gix->GetGixStats().CacheHits, Misses = Gix->GetGixStats().CacheMisses;
+        Gix->GetItemV(1, ItemV);
+        ASSERT_EQ(ItemV.Len(), 1001);
+        ASSERT_EQ((int)(Gix->GetGixStats().CacheHits - Hits), 1);
+        ASSERT_EQ((int)(Gix->GetGixStats().CacheMisses - Misses), 0);
+        // cached and merged
+        Gix->GetItemV(1, ItemV);
+        ASSERT_EQ((int)(Gix->GetGixStats().CacheHits - Hits), 2);
+        ASSERT_EQ((int)(Gix->GetGixStats().CacheMisses - Misses), 0);
+        // not cached
+        Gix->Flush();
+        Gix->GetItemV(1, ItemV);
+        ASSERT_EQ(ItemV.Len(), 1001);
+        ASSERT_EQ((int)(Gix->GetGixStats().CacheHits - Hits), 2);
+        ASSERT_EQ((int)(Gix->GetGixStats().CacheMisses - Misses), 1);
+    }
+    TFile::DelWc(FPath + "test_gix_stats.*");
+}
@@ -91,3 +91,98 @@ TEST(TLinAlgOperatorsDivide) {
         ASSERT_NEAR(DivV[RowN], FltV[RowN] / k, Tol);
     }
 }
+
+template <bool ColMajor>
+void InitMat(TVVec<TFlt, int, ColMajor>& Mat, TRnd& Rnd) {
+    for (int RowN = 0; RowN < Mat.GetRows(); RowN++) {
+        for (int ColN = 0; ColN < Mat.GetCols(); ColN++) {
+            Mat(RowN, ColN) = Rnd.GetUniDev() - 0.5;
+        }
+    }
+}
+
+template <bool ColMajor>
+void AssertProduct(const TVVec<TFlt, int, ColMajor>& A, const bool& TransA,
+        const TVVec<TFlt, int, ColMajor>& B, const bool& TransB,
+        const TVVec<TFlt, int, ColMajor>& C) {
+
+    const int K = TransA ? A.GetRows() : A.GetCols();
+    for (int RowN = 0; RowN < C.GetRows(); RowN++) {
+        for (int ColN = 0; ColN < C.GetCols(); ColN++) {
+            double Sum = 0.0;
+            for (int k = 0; k < K; k++) {
+                Sum += (TransA ? A(k, RowN) : A(RowN, k)) * (TransB ? B(ColN, k) : B(k, ColN));
+            }
+            ASSERT_NEAR(C(RowN, ColN), Sum, Tol);
+        }
+    }
+}
+
+template <bool ColMajor>
+void TestKernelProducts() {
+    typedef TVVec<TFlt, int, ColMajor> TMat;
+    TRnd Rnd(1);
+    // sizes are not multiples of block sizes and large enough to run in parallel
+    const int M = 131, K = 301, N = 259;
+    TMat A(M, K); InitMat(A, Rnd);
+    TMat At(K, M); InitMat(At, Rnd);
+    TMat B(K, N); InitMat(B, Rnd);
+    TMat Bt(N, K); InitMat(Bt, Rnd);
+
+    TMat C; TLinAlg::Multiply(A, B, C);
+    AssertProduct(A, false, B, false, C);
+    TMat Ct; TLinAlg::MultiplyT(At, B, Ct);
+    AssertProduct(At, true, B, false, Ct);
+    TMat Ctt(M, N); TLinAlg::Multiply(At, Bt, Ctt, TLinAlg::TRANS, TLinAlg::TRANS);
+    AssertProduct(At, true, Bt, true, Ctt);
+
+    // D = 2 * A * B + 0.5 * C
+    TMat D(M, N); TLinAlg::Gemm(2.0, A, B, 0.5, C, D, TLinAlg::GEMM_NO_T);
+    for (int RowN = 0; RowN < M; RowN++) {
+        for (int ColN = 0; ColN < N; ColN++) {
+            ASSERT_NEAR(D(RowN, ColN), 2.5 * C(RowN, ColN), Tol);
+        }
+    }
+
+    // matrix-vector products
+    TFltV x(K); for (int ValN = 0; ValN < K; ValN++) { x[ValN] = Rnd.GetUniDev(); }
+    TFltV y; TLinAlg::Multiply(A, x, y);
+    TFltV yt; TLinAlg::MultiplyT(At, x, yt);
+    ASSERT_EQ(y.Len(), M);
+    ASSERT_EQ(yt.Len(), M);
+    for (int RowN = 0; RowN < M; RowN++) {
+        double Sum = 0.0, SumT = 0.0;
+        for (int k = 0; k < K; k++) {
+            Sum += A(RowN, k) * x[k];
+            SumT += At(k, RowN) * x[k];
+        }
+        ASSERT_NEAR(y[RowN], Sum, Tol);
+        ASSERT_NEAR(yt[RowN], SumT, Tol);
+    }
+}
+
+TEST(TLinAlgKernelProductsRowMajor) {
+    TestKernelProducts<false>();
+}
+
+TEST(TLinAlgKernelProductsColMajor) {
+    TestKernelProducts<true>();
+}
+
+TEST(TLinAlgKernelDotProduct) {
+    TRnd Rnd(1);
+    for (int Len = 0; Len < 20; Len++) {
+        TFltV x(Len), y(Len); double Sum = 0.0;
+        for (int ValN = 0; ValN < Len; ValN++) {
+            x[ValN] = Rnd.GetUniDev(); y[ValN] = Rnd.GetUniDev();
+            Sum += x[ValN] * y[ValN];
+        }
+        ASSERT_NEAR(TLinAlg::DotProduct(x, y), Sum, Tol);
+        // y := 2 * x + y
+        TFltV z = y; TLinAlg::AddVec(2.0, x, z);
+        for (int ValN = 0; ValN < Len; ValN++) {
+            const double Expected = 2.0 * x[ValN] + y[ValN];
+            ASSERT_NEAR(z[ValN], Expected, Tol);
+        }
+    }
+}
@@ -41,3 +41,93 @@ TEST(TMathFloorLog2_uint64) {
     ASSERT_EQ(TMath::FloorLog2((uint64)TMath::Pow2<uint64>(63)), 63);
     //ASSERT_EQ(TMath::FloorLog2((uint64)TMath::Pow2<uint64>(64) - 1), 63);
 }
+
+TEST(TStreamAggrStatsLatency) {
+    TQm::TStreamAggrStats Stats;
+    ASSERT_EQ(Stats.GetCalls(), (uint64)0);
+    ASSERT_EQ(Stats.GetLatencyMSecs(0.5), 0.0);
+
+    // 98 fast calls of 1 microsecond and two slow ones of 1 millisecond
+    for (int CallN = 0; CallN < 98; CallN++) {
+        Stats.Add(TQm::saeAddRec, 1000);
+    }
+    Stats.Add(TQm::saeStep, 1000000);
+    Stats.Add(TQm::saeStep, 1000000);
+    ASSERT_EQ(Stats.GetCalls(TQm::saeAddRec), (uint64)98);
+    ASSERT_EQ(Stats.GetCalls(TQm::saeStep), (uint64)2);
+    ASSERT_EQ(Stats.GetCalls(), (uint64)100);
+
+    // percentiles are within a quarter of the true latency
+    const double P50 = Stats.GetLatencyMSecs(0.5);
+    ASSERT_TRUE(0.001 <= P50 && P50 <= 0.00125);
+    const double P99 = Stats.GetLatencyMSecs(0.99);
+    ASSERT_EQ(P99, 1.0);
+    ASSERT_EQ(Stats.GetMxLatencyMSecs(), 1.0);
+    const double Mean = (98 * 0.001 + 2 * 1.0) / 100;
+    ASSERT_NEAR(Stats.GetMeanLatencyMSecs(), Mean, 1e-12);
+
+    PJsonVal StatsVal = Stats.GetJson();
+    ASSERT_EQ(StatsVal->GetObjKey("calls")->GetObjInt("onAdd"), 98);
+    ASSERT_EQ(StatsVal->GetObjKey("calls")->GetObjInt("total"), 100);
+    ASSERT_EQ(StatsVal->GetObjKey("latency")->GetObjNum("max"), 1.0);
+
+    Stats.Clr();
+    ASSERT_EQ(Stats.GetCalls(), (uint64)0);
+    ASSERT_EQ(Stats.GetMxLatencyMSecs(), 0.0);
+}
+
+TEST(TStreamAggrStatsMem) {
+    TQm::TStreamAggrStats Stats;
+    Stats.AddMem(100);
+    ASSERT_EQ(Stats.GetMemGrowth(), (int64)0);
+    Stats.AddMem(250);
+    ASSERT_EQ(Stats.GetMemGrowth(), (int64)150);
+    ASSERT_EQ(Stats.GetLastMemGrowth(), (int64)150);
+    Stats.AddMem(200);
+    ASSERT_EQ(Stats.GetMemGrowth(), (int64)100);
+    ASSERT_EQ(Stats.GetLastMemGrowth(), (int64)-50);
+}
+
+TEST(TStorePartitions) {
+    const uint64 MinMSecs = 60 * 1000;
+    TQm::TStorePartitions Partitions(60 * MinMSecs);
+    ASSERT_TRUE(Partitions.IsPartitioned());
+    ASSERT_EQ(0, (int)Partitions.GetExpiredEndRecId(0, 10));
+    // four records per hour, record 9 is late and goes into the last partition
+    for (uint64 RecId = 0; RecId < 12; RecId++) {
+        const uint64 TmMSecs = (RecId == 9) ? 70 * MinMSecs : RecId * 15 * MinMSecs;
+        Partitions.AddRec(RecId, TmMSecs);
+    }
+    ASSERT_EQ(3, Partitions.GetPartitions());
+    ASSERT_EQ(4, (int)Partitions.GetFirstRecId(1));
+    ASSERT_EQ(8, (int)Partitions.GetFirstRecId(2));
+
+    // only partitions which ended before the window start expire
+    ASSERT_EQ(0, (int)Partitions.GetExpiredEndRecId(30 * MinMSecs, 12));
+    ASSERT_EQ(4, (int)Partitions.GetExpiredEndRecId(60 * MinMSecs, 12));
+    ASSERT_EQ(8, (int)Partitions.GetExpiredEndRecId(150 * MinMSecs, 12));
+    ASSERT_EQ(12, (int)Partitions.GetExpiredEndRecId(180 * MinMSecs, 12));
+
+    // ranges of overlapping partitions
+    uint64 MnRecId, MxRecId;
+    ASSERT_TRUE(Partitions.GetRecIdRange(60 * MinMSecs, 61 * MinMSecs, MnRecId, MxRecId));
+    ASSERT_EQ(4, (int)MnRecId);
+    ASSERT_EQ(8, (int)MxRecId);
+    ASSERT_TRUE(Partitions.GetRecIdRange(0, 0, MnRecId, MxRecId));
+    ASSERT_EQ(0, (int)MnRecId);
+    ASSERT_EQ(4, (int)MxRecId);
+    // late record makes the last partition overlap with the previous one
+    ASSERT_TRUE(Partitions.GetRecIdRange(65 * MinMSecs, 75 * MinMSecs, MnRecId, MxRecId));
+    ASSERT_EQ(4, (int)MnRecId);
+    ASSERT_TRUE(MxRecId == TUInt64::Mx);
+    ASSERT_TRUE(!Partitions.GetRecIdRange(240 * MinMSecs, 300 * MinMSecs, MnRecId, MxRecId));
+
+    // records deleted from the start
+    Partitions.DelRecs(6);
+    ASSERT_EQ(2, Partitions.GetPartitions());
+    ASSERT_EQ(6, (int)Partitions.GetFirstRecId(0));
+    Partitions.DelRecs(12);
+    ASSERT_EQ(1, Partitions.GetPartitions());
+    Partitions.Clr();
+    ASSERT_EQ(0, Partitions.GetPartitions());
+}
@@ -0,0 +1,39 @@
+#include <base.h>
+#include <mine.h>
+#include <qminer.h>
+
+#include "microtest.h"
+
+// Blobs written in update mode can be read back from memory-mapped files in read-only mode
+TEST(TPgBlobRdOnlyMap) {
+    const TStr FNm = "./test.pgblob";
+    const int Blobs = 5000;
+    TVec<TPgBlobPt> PtV;
+    {
+        PPgBlob Blob = TPgBlob::Create(FNm, 4 * PG_PAGE_SIZE);
+        for (int BlobN = 0; BlobN < Blobs; BlobN++) {
+            TStr Val = "blob" + TInt::GetStr(BlobN);
+            PtV.Add(Blob->Put(Val.CStr(), Val.Len() + 1));
+        }
+        // overwrite some blobs, so not all pages are in the same state
+        for (int BlobN = 0; BlobN < Blobs; BlobN += 7) {
+            TStr Val = "update" + TInt::GetStr(BlobN);
+            PtV[BlobN] = Blob->Put(Val.CStr(), Val.Len() + 1, PtV[BlobN]);
+        }
+    }
+    {
+        PPgBlob Blob = new TPgBlob(FNm, faRdOnly, PG_PAGE_SIZE);
+        Blob->LoadAll();
+        for (int BlobN = 0; BlobN < Blobs; BlobN++) {
+            TStr Val = ((BlobN % 7 == 0) ? "update" : "blob") + TInt::GetStr(BlobN);
+            TThinMIn MIn = Blob->Get(PtV[BlobN]);
+            ASSERT_EQ(MIn.Len(), Val.Len() + 1);
+            ASSERT_TRUE(Val == TStr(MIn.GetBfAddrChar()));
+        }
+        // pages are served from the map and not loaded into the cache
+        PJsonVal StatsVal = Blob->GetStats();
+        ASSERT_EQ(StatsVal->GetObjInt("loaded_pages"), 0);
+        ASSERT_EQ(StatsVal->GetObjInt("mapped_files"), 1);
+    }
+    TFile::DelWc(FNm + ".*");
+}
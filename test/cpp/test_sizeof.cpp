@@ -37,7 +37,7 @@ TEST(sizeofBasicTypes) {
      ASSERT_EQ(sizeof(TQm::TRecSet), (uint)56);
      ASSERT_EQ(sizeof(TQm::TRecFilter), (uint)24);
      ASSERT_EQ(sizeof(TQm::TAggr), (uint)32);
-     ASSERT_EQ(sizeof(TQm::TStreamAggr), (uint)40);
+     ASSERT_EQ(sizeof(TQm::TStreamAggr), (uint)120);
      ASSERT_EQ(sizeof(TQm::TFtrExt), (uint)80);
      ASSERT_EQ(sizeof(TQm::TFtrSpace), (uint)72);
  }
@@ -0,0 +1,96 @@
+#include <base.h>
+#include <mine.h>
+
+#include "microtest.h"
+
+// two dimensional data, the target depends on the sign of x0 + x1
+static void GenData(const int& Vecs, TFltVV& VecV, TFltV& ClsV, TFltV& RegV) {
+    TRnd Rnd(1);
+    VecV.Gen(2, Vecs);
+    ClsV.Gen(Vecs);
+    RegV.Gen(Vecs);
+    for (int VecN = 0; VecN < Vecs; VecN++) {
+        VecV(0, VecN) = Rnd.GetNrmDev();
+        VecV(1, VecN) = Rnd.GetNrmDev();
+        const double Val = VecV(0, VecN) + VecV(1, VecN);
+        ClsV[VecN] = (Val > 0.0) ? 1.0 : -1.0;
+        RegV[VecN] = 2.0 * VecV(0, VecN) - VecV(1, VecN);
+    }
+}
+
+static TSvm::TLinModel GetModel(const int& Threads, const int& MxIter = 500) {
+    TSvm::TLinModel Model;
+    PJsonVal ParamVal = TJsonVal::NewObj();
+    ParamVal->AddToObj("batchSize", 100);
+    ParamVal->AddToObj("maxIterations", MxIter);
+    ParamVal->AddToObj("maxTime", 1000);
+    ParamVal->AddToObj("threads", Threads);
+    Model.UpdateParams(ParamVal);
+    return Model;
+}
+
+static double GetAccuracy(const TSvm::TLinModel& Model, const TFltVV& VecV, const TFltV& ClsV) {
+    int Correct = 0;
+    for (int VecN = 0; VecN < ClsV.Len(); VecN++) {
+        if (Model.Predict(VecV, VecN) * ClsV[VecN] > 0.0) { Correct++; }
+    }
+    return double(Correct) / double(ClsV.Len());
+}
+
+TEST(TLinModelThreadsParam) {
+    TSvm::TLinModel Model = GetModel(4);
+    ASSERT_EQ(4, Model.GetParams()->GetObjInt("threads"));
+    ASSERT_EQ(1, TSvm::TLinModel().GetParams()->GetObjInt("threads"));
+
+    PJsonVal ParamVal = TJsonVal::NewObj();
+    ParamVal->AddToObj("threads", -1);
+    bool Thrown = false;
+    try { Model.UpdateParams(ParamVal); } catch (PExcept& Except) { Thrown = true; }
+    ASSERT_TRUE(Thrown);
+}
+
+TEST(TLinModelClassificationThreads) {
+    TFltVV VecV; TFltV ClsV, RegV; GenData(2000, VecV, ClsV, RegV);
+    TVec<TIntFltKdV> SpVecV; TLinAlgTransform::Sparse(VecV, SpVecV);
+
+    TSvm::TLinModel Model = GetModel(1);
+    Model.FitClassification(VecV, 2, 2000, ClsV, TNotify::NullNotify, TNotify::NullNotify);
+    // dense updates are split by dimension and give the same model
+    TSvm::TLinModel ParModel = GetModel(4);
+    ParModel.FitClassification(VecV, 2, 2000, ClsV, TNotify::NullNotify, TNotify::NullNotify);
+    ASSERT_EQ(Model.GetWgtV()[0], ParModel.GetWgtV()[0]);
+    ASSERT_EQ(Model.GetWgtV()[1], ParModel.GetWgtV()[1]);
+
+    // sparse hogwild updates only differ in the order of additions
+    TSvm::TLinModel SpModel = GetModel(4);
+    SpModel.FitClassification(SpVecV, 2, 2000, ClsV, TNotify::NullNotify, TNotify::NullNotify);
+    for (int DimN = 0; DimN < 2; DimN++) {
+        const double Expected = Model.GetWgtV()[DimN];
+        ASSERT_NEAR(Expected, SpModel.GetWgtV()[DimN], 1e-6 * TFlt::Abs(Expected));
+    }
+
+    ASSERT_TRUE(GetAccuracy(Model, VecV, ClsV) > 0.95);
+    ASSERT_TRUE(GetAccuracy(SpModel, VecV, ClsV) > 0.95);
+}
+
+TEST(TLinModelRegressionThreads) {
+    TFltVV VecV; TFltV ClsV, RegV; GenData(2000, VecV, ClsV, RegV);
+    TVec<TIntFltKdV> SpVecV; TLinAlgTransform::Sparse(VecV, SpVecV);
+
+    TSvm::TLinModel Model = GetModel(1, 10000);
+    Model.FitRegression(VecV, 2, 2000, RegV, TNotify::NullNotify, TNotify::NullNotify);
+    TSvm::TLinModel ParModel = GetModel(4, 10000);
+    ParModel.FitRegression(VecV, 2, 2000, RegV, TNotify::NullNotify, TNotify::NullNotify);
+    ASSERT_EQ(Model.GetWgtV()[0], ParModel.GetWgtV()[0]);
+    ASSERT_EQ(Model.GetWgtV()[1], ParModel.GetWgtV()[1]);
+
+    TSvm::TLinModel SpModel = GetModel(4, 10000);
+    SpModel.FitRegression(SpVecV, 2, 2000, RegV, TNotify::NullNotify, TNotify::NullNotify);
+    for (int DimN = 0; DimN < 2; DimN++) {
+        const double Expected = Model.GetWgtV()[DimN];
+        ASSERT_NEAR(Expected, SpModel.GetWgtV()[DimN], 1e-6 * TFlt::Abs(Expected));
+    }
+    // both recover the generating weights
+    ASSERT_NEAR(2.0, SpModel.GetWgtV()[0], 0.1);
+    ASSERT_NEAR(-1.0, SpModel.GetWgtV()[1], 0.1);
+}
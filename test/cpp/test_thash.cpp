@@ -505,6 +505,93 @@ TEST(TStrIntHManipulateTable) {
     ASSERT_EQ(0, DatSum);
 }
 
+// cached data of fixed size, remembers keys removed from cache
+class TSegCacheDat {
+private:
+    TCRef CRef;
+public:
+    int GetMemUsed() const { return 1000; }
+    void OnDelFromCache(const TInt& Key, void* RefToBs) { ((TIntV*)RefToBs)->Add(Key); }
+    friend class TPt<TSegCacheDat>;
+};
+typedef TPt<TSegCacheDat> PSegCacheDat;
+
+TEST(TSegCacheShards) {
+    TIntV DelKeyV;
+    // each shard needs at least a megabyte
+    TSegCache<TInt, PSegCacheDat> SmallCache(20000, 8, &DelKeyV);
+    ASSERT_EQ(1, SmallCache.GetShards());
+    TSegCache<TInt, PSegCacheDat> LargeCache(8 * 1024 * 1024, 8, &DelKeyV);
+    ASSERT_EQ(8, LargeCache.GetShards());
+
+    for (int Key = 0; Key < 1000; Key++) { LargeCache.Put(Key, PSegCacheDat(new TSegCacheDat)); }
+    ASSERT_EQ(1000, LargeCache.Len());
+    // readers from several threads
+    int Hits = 0;
+    #pragma omp parallel for reduction(+:Hits)
+    for (int Key = 0; Key < 2000; Key++) {
+        PSegCacheDat Dat;
+        if (LargeCache.Get(Key, Dat)) { Hits++; }
+    }
+    ASSERT_EQ(1000, Hits);
+    ASSERT_EQ(1000, (int)LargeCache.GetHits());
+    ASSERT_EQ(1000, (int)LargeCache.GetMisses());
+    ASSERT_EQ(0, (int)LargeCache.GetEvictions());
+}
+
+TEST(TSegCacheScanResistant) {
+    TIntV DelKeyV;
+    // room for 19 entries of 1004 bytes
+    TSegCache<TInt, PSegCacheDat> Cache(20000, 1, &DelKeyV);
+    // working set, read twice
+    for (int Key = 0; Key < 10; Key++) { Cache.Put(Key, PSegCacheDat(new TSegCacheDat)); }
+    PSegCacheDat Dat;
+    for (int Key = 0; Key < 10; Key++) { ASSERT_TRUE(Cache.Get(Key, Dat)); }
+    ASSERT_EQ(10, (int)Cache.GetHits());
+    // scan over keys which are read only once
+    for (int Key = 100; Key < 200; Key++) {
+        if (!Cache.Get(Key, Dat)) { Cache.Put(Key, PSegCacheDat(new TSegCacheDat)); }
+    }
+    ASSERT_EQ(100, (int)Cache.GetMisses());
+    ASSERT_EQ(19, Cache.Len());
+    ASSERT_EQ(91, (int)Cache.GetEvictions());
+    ASSERT_EQ(91, DelKeyV.Len());
+    // working set survived the scan
+    for (int Key = 0; Key < 10; Key++) { ASSERT_TRUE(Cache.IsKey(Key)); }
+    for (int DelKeyN = 0; DelKeyN < DelKeyV.Len(); DelKeyN++) { ASSERT_TRUE(DelKeyV[DelKeyN] >= 100); }
+    // peek does not count
+    ASSERT_TRUE(Cache.Peek(0, Dat));
+    ASSERT_EQ(10, (int)Cache.GetHits());
+    Cache.ResetStats();
+    ASSERT_EQ(0, (int)Cache.GetMisses());
+}
+
+TEST(TSegCacheChangeKey) {
+    TIntV DelKeyV;
+    TSegCache<TInt, PSegCacheDat> Cache(20000, 1, &DelKeyV);
+    for (int Key = 0; Key < 5; Key++) { Cache.Put(Key, PSegCacheDat(new TSegCacheDat)); }
+    Cache.ChangeKey(3, 30);
+    ASSERT_EQ(5, Cache.Len());
+    ASSERT_TRUE(!Cache.IsKey(3));
+    ASSERT_TRUE(Cache.IsKey(30));
+    // eviction order is kept: 0 is the least recently used
+    TVec<TPair<TInt, PSegCacheDat> > KeyDatV;
+    Cache.GetKeyDatV(KeyDatV);
+    ASSERT_EQ(5, KeyDatV.Len());
+    ASSERT_EQ(0, KeyDatV[0].Val1);
+    // delete without and with notification
+    Cache.Del(1, false);
+    ASSERT_EQ(0, DelKeyV.Len());
+    Cache.Del(2);
+    ASSERT_EQ(1, DelKeyV.Len());
+    ASSERT_EQ(2, DelKeyV[0]);
+    ASSERT_EQ(3, Cache.Len());
+    ASSERT_EQ(0, (int)Cache.GetEvictions());
+    Cache.FlushAndClr();
+    ASSERT_EQ(4, DelKeyV.Len());
+    ASSERT_EQ(0, Cache.Len());
+}
+
 int Prime(const int& n) {
     int d;
 
@@ -1,79 +1,243 @@
-#include <base.h>
-#include <mine.h>
-#include <thread.h>
-#include "microtest.h"
-
-#ifdef GLib_UNIX
-
-class TestRunnable : public TThreadPool::TRunnable {
-public:
-    int Input;
-    int* Output;
-    TestRunnable(const int& Input, int* Output): Input(Input), Output(Output) { }
-    void Run() { *Output = Input + 1; }
-    ~TestRunnable() {}
-};
-
-class TestSlowRunnable : public TThreadPool::TRunnable {
-public:
-    int Input;
-    uint MSecBefore;
-    uint MSecAfter;
-    TIntV* Output;
-    TCriticalSection& CriticalSection;
-    TestSlowRunnable(const int& Input, const uint& MSecBefore, const uint& MSecAfter, TIntV* Output, TCriticalSection& CriticalSection):
-      Input(Input), MSecBefore(MSecBefore), MSecAfter(MSecAfter), Output(Output), CriticalSection(CriticalSection) { }
-    void Run() {
-        TSysProc::Sleep(MSecBefore);
-        // todo lock
-        CriticalSection.Enter();
-        Output->Add(Input);
-        CriticalSection.Leave();
-        TSysProc::Sleep(MSecAfter);
-    }
-    ~TestSlowRunnable() {}
-};
-
-TEST(constructor_destructor) {
-    TThreadPool ThreadPool(1);
-}
-
-TEST(increment1) {
-    TThreadPool ThreadPool(1);
-    int Result;
-    TestRunnable* Runnable = new TestRunnable(1, &Result);
-    ThreadPool.Execute(Runnable);
-    TSysProc::Sleep(50);
-    ASSERT_EQ(Result, 2);
-}
-
-TEST(two_slow) {
-    TThreadPool ThreadPool(2);
-    TIntV Result;
-    TCriticalSection CriticalSection;
-    TestSlowRunnable* Runnable1 = new TestSlowRunnable(1, 0, 0, &Result, CriticalSection);
-    TestSlowRunnable* Runnable2 = new TestSlowRunnable(2, 50, 0, &Result, CriticalSection);
-    ThreadPool.Execute(Runnable2);
-    ThreadPool.Execute(Runnable1);
-    TSysProc::Sleep(100);
-    ASSERT_EQ(Result.Len(), 2);
-    ASSERT_EQ(Result[0], 1);
-    ASSERT_EQ(Result[1], 2);
-}
-
-
-TEST(two_race) {
-    PNotify Notify = TStdNotify::New();
-    //PNotify Notify = TNullNotify::New();
-    TThreadPool ThreadPool(2, Notify);
-    TIntV Result;
-    TCriticalSection CriticalSection;
-    TestSlowRunnable* Runnable1 = new TestSlowRunnable(1, 0, 0, &Result, CriticalSection);
-    TestSlowRunnable* Runnable2 = new TestSlowRunnable(2, 0, 0, &Result, CriticalSection);
-    ThreadPool.Execute(Runnable2);
-    ThreadPool.Execute(Runnable1);
-    TSysProc::Sleep(100);
-    ASSERT_EQ(Result.Len(), 2);
-}
-
-#endif
+#include <base.h>
+#include <mine.h>
+#include <thread.h>
+#include <task.h>
+#include "microtest.h"
+
+#ifdef GLib_UNIX
+
+class TestRunnable : public TThreadPool::TRunnable {
+public:
+    int Input;
+    int* Output;
+    TestRunnable(const int& Input, int* Output): Input(Input), Output(Output) { }
+    void Run() { *Output = Input + 1; }
+    ~TestRunnable() {}
+};
+
+class TestSlowRunnable : public TThreadPool::TRunnable {
+public:
+    int Input;
+    uint MSecBefore;
+    uint MSecAfter;
+    TIntV* Output;
+    TCriticalSection& CriticalSection;
+    TestSlowRunnable(const int& Input, const uint& MSecBefore, const uint& MSecAfter, TIntV* Output, TCriticalSection& CriticalSection):
+      Input(Input), MSecBefore(MSecBefore), MSecAfter(MSecAfter), Output(Output), CriticalSection(CriticalSection) { }
+    void Run() {
+        TSysProc::Sleep(MSecBefore);
+        // todo lock
+        CriticalSection.Enter();
+        Output->Add(Input);
+        CriticalSection.Leave();
+        TSysProc::Sleep(MSecAfter);
+    }
+    ~TestSlowRunnable() {}
+};
+
+TEST(constructor_destructor) {
+    TThreadPool ThreadPool(1);
+}
+
+TEST(increment1) {
+    TThreadPool ThreadPool(1);
+    int Result;
+    TestRunnable* Runnable = new TestRunnable(1, &Result);
+    ThreadPool.Execute(Runnable);
+    TSysProc::Sleep(50);
+    ASSERT_EQ(Result, 2);
+}
+
+TEST(two_slow) {
+    TThreadPool ThreadPool(2);
+    TIntV Result;
+    TCriticalSection CriticalSection;
+    TestSlowRunnable* Runnable1 = new TestSlowRunnable(1, 0, 0, &Result, CriticalSection);
+    TestSlowRunnable* Runnable2 = new TestSlowRunnable(2, 50, 0, &Result, CriticalSection);
+    ThreadPool.Execute(Runnable2);
+    ThreadPool.Execute(Runnable1);
+    TSysProc::Sleep(100);
+    ASSERT_EQ(Result.Len(), 2);
+    ASSERT_EQ(Result[0], 1);
+    ASSERT_EQ(Result[1], 2);
+}
+
+
+TEST(two_race) {
+    PNotify Notify = TStdNotify::New();
+    //PNotify Notify = TNullNotify::New();
+    TThreadPool ThreadPool(2, Notify);
+    TIntV Result;
+    TCriticalSection CriticalSection;
+    TestSlowRunnable* Runnable1 = new TestSlowRunnable(1, 0, 0, &Result, CriticalSection);
+    TestSlowRunnable* Runnable2 = new TestSlowRunnable(2, 0, 0, &Result, CriticalSection);
+    ThreadPool.Execute(Runnable2);
+    ThreadPool.Execute(Runnable1);
+    TSysProc::Sleep(100);
+    ASSERT_EQ(Result.Len(), 2);
+}
+
+class TestSquareBody : public TParallelForBody {
+public:
+    TIntV& ValV;
+    TestSquareBody(TIntV& _ValV): ValV(_ValV) { }
+    void Run(const int& MnValN, const int& MxValN) const {
+        for (int ValN = MnValN; ValN < MxValN; ValN++) { ValV[ValN] = ValN * ValN; }
+    }
+};
+
+class TestSumBody : public TParallelReduceBody<TFlt> {
+public:
+    const TFltV& ValV;
+    TestSumBody(const TFltV& _ValV): ValV(_ValV) { }
+    void Run(const int& MnValN, const int& MxValN, TFlt& Sum) const {
+        for (int ValN = MnValN; ValN < MxValN; ValN++) { Sum += ValV[ValN]; }
+    }
+    void Merge(TFlt& Sum, const TFlt& OtherSum) const { Sum += OtherSum; }
+};
+
+/// Sums a range by spawning another parallel loop from inside a task
+class TestNestedBody : public TParallelReduceBody<TInt> {
+public:
+    TTaskScheduler& Scheduler;
+    TestNestedBody(TTaskScheduler& _Scheduler): Scheduler(_Scheduler) { }
+    void Run(const int& MnValN, const int& MxValN, TInt& Count) const {
+        for (int ValN = MnValN; ValN < MxValN; ValN++) {
+            TIntV ValV(100);
+            TParallelLoop::For(Scheduler, 0, ValV.Len(), TestSquareBody(ValV), 7);
+            if (ValV[99] == 99 * 99) { Count++; }
+        }
+    }
+    void Merge(TInt& Count, const TInt& OtherCount) const { Count += OtherCount; }
+};
+
+class TestThrowBody : public TParallelForBody {
+public:
+    void Run(const int& MnValN, const int& MxValN) const {
+        if (MnValN <= 500 && 500 < MxValN) { throw TExcept::New("task failed"); }
+    }
+};
+
+class TestIncTask : public TTask<int, int> {
+public:
+    void Each(const int& It, int& Out, int Index) { Out = It + Index; }
+};
+
+TEST(scheduler_parallel_for) {
+    TTaskScheduler Scheduler(4);
+    TIntV ValV(10000);
+    TParallelLoop::For(Scheduler, 0, ValV.Len(), TestSquareBody(ValV), 16);
+    for (int ValN = 0; ValN < ValV.Len(); ValN++) {
+        ASSERT_EQ(ValV[ValN], ValN * ValN);
+    }
+    // empty and single element ranges
+    TParallelLoop::For(Scheduler, 0, 0, TestSquareBody(ValV));
+    TParallelLoop::For(Scheduler, 3, 4, TestSquareBody(ValV));
+    ASSERT_EQ(ValV[3], 9);
+}
+
+TEST(scheduler_parallel_reduce) {
+    TTaskScheduler Scheduler(3);
+    TFltV ValV(100000);
+    for (int ValN = 0; ValN < ValV.Len(); ValN++) { ValV[ValN] = 1.0 / (ValN + 1); }
+    TFlt Sum1 = 0.0, Sum2 = 0.0;
+    TParallelLoop::Reduce(Scheduler, 0, ValV.Len(), TestSumBody(ValV), Sum1, 100);
+    TParallelLoop::Reduce(Scheduler, 0, ValV.Len(), TestSumBody(ValV), Sum2, 100);
+    // merge order is fixed, so the result is reproducible
+    ASSERT_EQ(Sum1.Val, Sum2.Val);
+    ASSERT_NEAR(Sum1.Val, 12.0901461298634, 1e-9);
+}
+
+TEST(scheduler_nested) {
+    TTaskScheduler Scheduler(2);
+    TInt Count = 0;
+    TParallelLoop::Reduce(Scheduler, 0, 200, TestNestedBody(Scheduler), Count, 1);
+    ASSERT_EQ(Count.Val, 200);
+}
+
+TEST(scheduler_exception) {
+    TTaskScheduler Scheduler(2);
+    ASSERT_ANY_THROW(TParallelLoop::For(Scheduler, 0, 1000, TestThrowBody(), 10));
+    // scheduler is still usable
+    TIntV ValV(100);
+    TParallelLoop::For(Scheduler, 0, ValV.Len(), TestSquareBody(ValV), 10);
+    ASSERT_EQ(ValV[10], 100);
+}
+
+TEST(scheduler_task_parallel) {
+    TParallel<int, int> Parallel(3);
+    TVec<int> Items(1000), Outputs(1000);
+    for (int ItemN = 0; ItemN < Items.Len(); ItemN++) { Items[ItemN] = 2 * ItemN; }
+    TestIncTask Task;
+    Parallel.ForEach(Items, Outputs, Task);
+    for (int ItemN = 0; ItemN < Items.Len(); ItemN++) {
+        ASSERT_EQ(Outputs[ItemN], 3 * ItemN);
+    }
+}
+
+class TestSleepTask : public TTaskScheduler::TTask {
+public:
+    void Run() { TSysProc::Sleep(300); }
+};
+
+// returns CPU time used by the calling thread in milliseconds
+static double GetThreadCpuMSecs() {
+    timespec Time; clock_gettime(CLOCK_THREAD_CPUTIME_ID, &Time);
+    return 1000.0 * Time.tv_sec + Time.tv_nsec / 1000000.0;
+}
+
+TEST(scheduler_wait_blocks) {
+    TTaskScheduler Scheduler(1);
+    TTaskScheduler::TTaskGroup Group(Scheduler);
+    TestSleepTask Task;
+    Group.Spawn(Task);
+    // let the worker take the task
+    TSysProc::Sleep(50);
+    const double StartMSecs = GetThreadCpuMSecs();
+    Group.Wait();
+    // waiting for a task running on another thread does not use the CPU
+    ASSERT_TRUE(GetThreadCpuMSecs() - StartMSecs < 100.0);
+    ASSERT_EQ(Group.GetPendingTasks(), 0);
+}
+
+class TestRWLockBody : public TParallelForBody {
+public:
+    TRWLock& RWLock;
+    std::atomic<int>& Readers;
+    std::atomic<int>& MxReaders;
+    std::atomic<int>& Overlaps;
+    int& Writes;
+    TestRWLockBody(TRWLock& _RWLock, std::atomic<int>& _Readers, std::atomic<int>& _MxReaders,
+            std::atomic<int>& _Overlaps, int& _Writes): RWLock(_RWLock), Readers(_Readers),
+            MxReaders(_MxReaders), Overlaps(_Overlaps), Writes(_Writes) { }
+    void Run(const int& MnValN, const int& MxValN) const {
+        for (int ValN = MnValN; ValN < MxValN; ValN++) {
+            if (ValN % 10 == 0) {
+                // writer must not see any readers
+                TWriteLock Lock(RWLock);
+                if (Readers > 0) { Overlaps++; }
+                Writes++;
+            } else {
+                TReadLock Lock(RWLock);
+                const int NewReaders = ++Readers;
+                int OldMxReaders = MxReaders;
+                while (NewReaders > OldMxReaders && !MxReaders.compare_exchange_weak(OldMxReaders, NewReaders)) { }
+                TSysProc::Sleep(1);
+                Readers--;
+            }
+        }
+    }
+};
+
+TEST(rwlock) {
+    TTaskScheduler Scheduler(4);
+    TRWLock RWLock;
+    std::atomic<int> Readers(0), MxReaders(0), Overlaps(0); int Writes = 0;
+    TParallelLoop::For(Scheduler, 0, 400, TestRWLockBody(RWLock, Readers, MxReaders, Overlaps, Writes), 1);
+    ASSERT_EQ(Writes, 40);
+    ASSERT_EQ(Overlaps.load(), 0);
+    ASSERT_EQ(Readers.load(), 0);
+    ASSERT_TRUE(MxReaders.load() >= 1);
+}
+
+#endif
@@ -27,4 +27,61 @@ TEST(TJsonValParsing) {
     // handling of escapes
      ASSERT_EQ_TSTR(TJsonVal::GetValFromStr("\"\\t\"")->GetStr(), TStr("\t"));
      ASSERT_EQ_TSTR(TJsonVal::GetValFromStr("\"\\R\"")->GetStr(), TStr("R"));
-}
\ No newline at end of file
+}
+TEST(TJsonValParsingDialect) {
+    // comments
+    PJsonVal Val = TJsonVal::GetValFromStr("// line\n{ /* block */ \"a\": 1, # hash\n \"b\": [1, -2.5e1, true, null] }");
+    ASSERT_TRUE(Val->IsObj());
+    ASSERT_EQ(Val->GetObjNum("a"), 1.0);
+    ASSERT_EQ(Val->GetObjKey("b")->GetArrVals(), 4);
+    ASSERT_EQ(Val->GetObjKey("b")->GetArrVal(1)->GetNum(), -25.0);
+    ASSERT_TRUE(Val->GetObjKey("b")->GetArrVal(2)->GetBool());
+    ASSERT_TRUE(Val->GetObjKey("b")->GetArrVal(3)->IsNull());
+    // single quotes and escapes
+    ASSERT_EQ_TSTR(TJsonVal::GetValFromStr("'a\\'b'")->GetStr(), TStr("a'b"));
+    ASSERT_EQ_TSTR(TJsonVal::GetValFromStr("\"\\\"\\\\\\/\\n\"")->GetStr(), TStr("\"\\/\n"));
+    ASSERT_EQ_TSTR(TJsonVal::GetValFromStr("\"\\u00e9\"")->GetStr(), TStr("\xc3\xa9"));
+    // errors
+    bool Ok; TStr MsgStr;
+    ASSERT_FALSE(TJsonVal::GetValFromStr("[1, 2", Ok, MsgStr)->IsDef());
+    ASSERT_FALSE(Ok);
+    ASSERT_FALSE(TJsonVal::GetValFromStr("{\"a\" 1}")->IsDef());
+    ASSERT_FALSE(TJsonVal::GetValFromStr("\"abc")->IsDef());
+    ASSERT_FALSE(TJsonVal::GetValFromStr("nul")->IsDef());
+    ASSERT_FALSE(TJsonVal::GetValFromStr("")->IsDef());
+    // round trip
+    TStr JsonStr = "{\"x\":[1,{\"y\":\"z\"}],\"w\":false}";
+    PJsonVal RoundVal = TJsonVal::GetValFromStr(JsonStr, Ok, MsgStr);
+    ASSERT_TRUE(Ok);
+    ASSERT_TRUE(*RoundVal == *TJsonVal::GetValFromStr(TJsonVal::GetStrFromVal(RoundVal)));
+}
+
+/// Records SAX events as a string
+class TJsonSaxTrace : public TJsonSaxHandler {
+public:
+    TChA Trace;
+    void OnNull() { Trace += "n "; }
+    void OnBool(const bool& Bool) { Trace += Bool ? "t " : "f "; }
+    void OnNum(const double& Num) { Trace += TFlt::GetStr(Num); Trace += " "; }
+    void OnStr(const TChA& Str) { Trace += "s:"; Trace += Str; Trace += " "; }
+    void OnBeginArr() { Trace += "[ "; }
+    void OnEndArr() { Trace += "] "; }
+    void OnBeginObj() { Trace += "{ "; }
+    void OnKey(const TChA& Key) { Trace += "k:"; Trace += Key; Trace += " "; }
+    void OnEndObj() { Trace += "} "; }
+};
+
+TEST(TJsonSaxParser) {
+    TJsonSaxTrace Trace;
+    TJsonSaxParser::Parse("{\"a\": [1, \"x\", null], \"b\": {\"c\": false}}", Trace);
+    ASSERT_EQ_TSTR(TStr(Trace.Trace), TStr("{ k:a [ 1 s:x n ] k:b { k:c f } } "));
+    TJsonSaxTrace ErrTrace;
+    ASSERT_ANY_THROW(TJsonSaxParser::Parse("[1,,2]", ErrTrace));
+    // sign without digits
+    ASSERT_ANY_THROW(TJsonSaxParser::Parse("[-]", ErrTrace));
+    ASSERT_ANY_THROW(TJsonSaxParser::Parse("{\"a\": +}", ErrTrace));
+    ASSERT_ANY_THROW(TJsonSaxParser::Parse("-.", ErrTrace));
+    TJsonSaxTrace NumTrace;
+    TJsonSaxParser::Parse("[-1, +2, -.5]", NumTrace);
+    ASSERT_EQ_TSTR(TStr(NumTrace.Trace), TStr("[ -1 2 -0.5 ] "));
+}
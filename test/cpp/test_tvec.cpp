@@ -13,4 +13,39 @@ TEST(TVecDelMemCpy) {
 
     ASSERT_EQ(14, Vec.Len());
     ASSERT_EQ(6, Vec[0]);
-}
\ No newline at end of file
+}
+TEST(TVecCopyExt) {
+    TIntV Vec;
+    for (int i = 0; i < 10; i++) {
+        Vec.Add(i);
+    }
+    // vector on external memory
+    TIntV ExtVec;
+    ExtVec.GenExt(Vec.BegI(), 5);
+    ASSERT_TRUE(ExtVec.IsExt());
+
+    // the copy owns its memory and can grow
+    TIntV CopyVec(ExtVec);
+    ASSERT_FALSE(CopyVec.IsExt());
+    ASSERT_EQ(5, CopyVec.Len());
+    ASSERT_TRUE(Vec.BegI() != CopyVec.BegI());
+    CopyVec.Add(5);
+    ASSERT_EQ(6, CopyVec.Len());
+    ASSERT_EQ(4, CopyVec[4]);
+    ASSERT_EQ(5, CopyVec[5]);
+
+    // matrix on external memory, row major
+    TFltV ValV(6);
+    for (int i = 0; i < 6; i++) {
+        ValV[i] = i;
+    }
+    TFltVV ExtMat;
+    ExtMat.GenExt(ValV.BegI(), 2, 3);
+    ASSERT_EQ(2, ExtMat.GetRows());
+    ASSERT_EQ(3, ExtMat.GetCols());
+    ASSERT_NEAR(5.0, ExtMat(1, 2), 1e-12);
+    TFltVV CopyMat(ExtMat);
+    ExtMat(1, 2) = 7;
+    ASSERT_NEAR(7.0, ValV[5], 1e-12);
+    ASSERT_NEAR(5.0, CopyMat(1, 2), 1e-12);
+}
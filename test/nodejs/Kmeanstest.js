@@ -1078,6 +1078,25 @@ describe("Kmeans test", function () {
             var frob = expectedC.minus(sparseKMeans.centroids).frob();
             assert(frob < 1e-9, 'Centroids differ by norm: ' + frob + ' which should be 0!');
         })
+
+        it('should fit mini-batches asynchronously', function (done) {
+            var batchKMeans = new analytics.KMeans({ k: 2, iter: 50, batchSize: 4, fitStart: { C: C } });
+            assert.strictEqual(batchKMeans.getParams().batchSize, 4);
+
+            batchKMeans.fitAsync(X, function (err) {
+                if (err) { return done(err); }
+                try {
+                    var prediction = batchKMeans.predict(X);
+                    var expected = [0, 0, 0, 0, 1, 1, 1];
+                    for (var i = 0; i < expected.length; i++) {
+                        assert.strictEqual(prediction[i], expected[i]);
+                    }
+                    done();
+                } catch (e) {
+                    done(e);
+                }
+            });
+        })
     })
 
     describe('Quality measure tests', function () {
@@ -233,6 +233,17 @@ describe("SVC test", function () {
             assert.eqtol(model.weights[0], 1, 1e-3);
             assert.eqtol(model.weights[1], 1, 1e-3);
         })
+        it('should create the same model using multiple threads', function () {
+            var matrix = new la.Matrix([[0, 1, -1, 0], [1, 0, 0, -1]]);
+            var vec = new la.Vector([1, 1, -1, -1]);
+            var SVC = new analytics.SVC({ threads: 4 });
+            assert.strictEqual(SVC.getParams().threads, 4);
+
+            SVC.fit(matrix, vec);
+            var model = SVC.getModel();
+            assert.eqtol(model.weights[0], 1, 1e-3);
+            assert.eqtol(model.weights[1], 1, 1e-3);
+        })
         it('should throw an exception if the number of matrix columns and vector length are not equal', function () {
             var matrix = new la.Matrix([[0, 1, -1, 0], [1, 0, 0, -1]]);
             var vec = new la.Vector([1, 1, -1]);
@@ -158,3 +158,257 @@ describe('Testing base without strict names ...', function () {
         });
     });
 });
+
+describe('Testing background flusher ...', function () {
+    var base = null;
+
+    beforeEach(function () {
+        base = new qm.Base({
+            mode: 'createClean',
+            dbPath: DB_PATH,
+            schema: [{
+                "name": "People",
+                "fields": [
+                    { "name": "Name", "type": "string", "primary": true },
+                    { "name": "Age", "type": "int" }
+                ]
+            }]
+        });
+    });
+    afterEach(function () {
+        if (!base.isClosed()) base.close();
+    });
+
+    it('Should report the flusher in stats only while running', function () {
+        assert.strictEqual(base.getStats().flusher, undefined);
+        base.startFlusher(10, 5);
+        var flusher = base.getStats().flusher;
+        assert.strictEqual(flusher.interval, 10);
+        assert.strictEqual(flusher.budget, 5);
+        base.stopFlusher();
+        assert.strictEqual(base.getStats().flusher, undefined);
+    });
+
+    it('Should flush records pushed while running', function (done) {
+        base.startFlusher(10, 5);
+        for (var i = 0; i < 1000; i++) {
+            base.store("People").push({ Name: "Person" + i, Age: i });
+        }
+        setTimeout(function () {
+            try {
+                var flusher = base.getStats().flusher;
+                assert.ok(flusher.rounds > 0);
+                base.close();
+                var base1 = new qm.Base({ mode: 'open', dbPath: DB_PATH });
+                assert.strictEqual(base1.store("People").length, 1000);
+                base1.close();
+                done();
+            } catch (e) {
+                done(e);
+            }
+        }, 200);
+    });
+
+    it('Should read records while rounds run', function () {
+        var store = base.store("People");
+        base.startFlusher(1, 5);
+        var start = Date.now();
+        for (var i = 0; Date.now() - start < 200; i++) {
+            store.push({ Name: "Person" + i, Age: i });
+            for (var j = 0; j < 10; j++) {
+                var recId = Math.floor(Math.random() * store.length);
+                assert.strictEqual(store[recId].Name, "Person" + recId);
+                assert.strictEqual(store[recId].Age, recId);
+            }
+        }
+        assert.ok(base.getStats().flusher.rounds > 0);
+        base.stopFlusher();
+    });
+
+    it('Should throw on invalid parameters', function () {
+        assert.throws(function () { base.startFlusher(0, 5); });
+        assert.throws(function () { base.startFlusher(10, -1); });
+    });
+});
+
+describe('Testing write-ahead log ...', function () {
+    var base = null;
+
+    beforeEach(function () {
+        base = new qm.Base({
+            mode: 'createClean',
+            dbPath: DB_PATH,
+            schema: [{
+                "name": "People",
+                "fields": [
+                    { "name": "Name", "type": "string", "primary": true },
+                    { "name": "Age", "type": "int" }
+                ]
+            }]
+        });
+    });
+    afterEach(function () {
+        if (!base.isClosed()) base.close();
+    });
+
+    it('Should log updates and remove the log when closed', function () {
+        base.openWal({ sync: 'group', groupSize: 10 });
+        for (var i = 0; i < 25; i++) {
+            base.store("People").push({ Name: "Person" + i, Age: i });
+        }
+        base.store("People").clear(5);
+        var wal = base.getStats().wal;
+        assert.strictEqual(wal.sync, 'group');
+        assert.strictEqual(wal.entries, 26);
+        assert.strictEqual(wal.syncs, 2);
+        assert.strictEqual(wal.pending, 6);
+        assert.ok(fs.exists(DB_PATH + '/Base.wal'));
+        base.close();
+        assert.ok(!fs.exists(DB_PATH + '/Base.wal'));
+    });
+
+    it('Should keep logging after the base is reopened', function () {
+        base.openWal({ sync: 'rec' });
+        base.close();
+        base = new qm.Base({ mode: 'open', dbPath: DB_PATH });
+        assert.strictEqual(base.getStats().wal.sync, 'rec');
+        base.store("People").push({ Name: "Homer", Age: 40 });
+        assert.strictEqual(base.getStats().wal.syncs, 1);
+        base.closeWal();
+        assert.strictEqual(base.getStats().wal, undefined);
+    });
+
+    it('Should throw on unknown sync policy', function () {
+        assert.throws(function () { base.openWal({ sync: 'never' }); });
+    });
+
+    it('Should recover from a checkpoint without closing the base', function () {
+        var nodefs = require('fs');
+        var SNAP_PATH = DB_PATH + '-ckpt';
+        base.openWal({ sync: 'rec' });
+        var people = base.store("People");
+        for (var i = 0; i < 10; i++) {
+            people.push({ Name: "Person" + i, Age: i });
+        }
+        base.checkpoint();
+        var wal = base.getStats().wal;
+        assert.strictEqual(wal.checkpoints, 1);
+        assert.strictEqual(nodefs.statSync(DB_PATH + '/Base.wal').size, 0);
+        people.push({ Name: "Homer", Age: 40 });
+        people[0].Age = 41;
+        people[1].Name = "Marge";
+        // files as left behind by a crash after the checkpoint
+        if (nodefs.existsSync(SNAP_PATH)) { nodefs.rmSync(SNAP_PATH, { recursive: true }); }
+        nodefs.mkdirSync(SNAP_PATH);
+        nodefs.readdirSync(DB_PATH).forEach(function (f) { nodefs.copyFileSync(DB_PATH + '/' + f, SNAP_PATH + '/' + f); });
+        base.close();
+        base = new qm.Base({ mode: 'open', dbPath: SNAP_PATH });
+        people = base.store("People");
+        assert.strictEqual(people.length, 11);
+        assert.strictEqual(people[0].Age, 41);
+        assert.strictEqual(people[1].Name, "Marge");
+        assert.strictEqual(people.recordByName("Marge").$id, 1);
+        assert.strictEqual(people.recordByName("Person1"), undefined);
+        assert.strictEqual(people[10].Name, "Homer");
+        base.close();
+        nodefs.rmSync(SNAP_PATH, { recursive: true });
+    });
+
+    it('Should make checkpoints from the flusher while open', function (done) {
+        base.openWal({ sync: 'group' });
+        base.startFlusher(5, 5);
+        for (var i = 0; i < 100; i++) {
+            base.store("People").push({ Name: "Person" + i, Age: i });
+        }
+        var start = Date.now();
+        var check = function () {
+            try {
+                var stats = base.getStats();
+                if (stats.wal.checkpoints == 0 && Date.now() - start < 2000) { return setTimeout(check, 10); }
+                assert.ok(stats.wal.checkpoints > 0);
+                assert.ok(stats.flusher.checkpoint != undefined);
+                base.close();
+                base = new qm.Base({ mode: 'open', dbPath: DB_PATH });
+                assert.strictEqual(base.store("People").length, 100);
+                done();
+            } catch (e) {
+                done(e);
+            }
+        };
+        setTimeout(check, 10);
+    });
+
+    it('Should replay records and joins over the last save', function () {
+        var nodefs = require('fs');
+        var SNAP_PATH = DB_PATH + '-snap';
+        var copyDir = function (src, dst) {
+            if (nodefs.existsSync(dst)) { nodefs.rmSync(dst, { recursive: true }); }
+            nodefs.mkdirSync(dst);
+            nodefs.readdirSync(src).forEach(function (f) { nodefs.copyFileSync(src + '/' + f, dst + '/' + f); });
+        };
+        base.close();
+        base = new qm.Base({
+            mode: 'createClean',
+            dbPath: DB_PATH,
+            schema: [{
+                "name": "People",
+                "fields": [{ "name": "Name", "type": "string", "primary": true }],
+                "joins": [{ "name": "friends", "type": "index", "store": "People" }]
+            }]
+        });
+        base.openWal({ sync: 'rec' });
+        base.close();
+        // state of the last save, as left behind by a crash
+        copyDir(DB_PATH, SNAP_PATH);
+        base = new qm.Base({ mode: 'open', dbPath: DB_PATH });
+        var people = base.store("People");
+        people.push({ Name: "Homer" });
+        people.push({ Name: "Marge" });
+        people.push({ Name: "Bart" });
+        people[0].$addJoin("friends", people[1]);
+        people[0].$addJoin("friends", people[2]);
+        people[0].$delJoin("friends", people[2]);
+        nodefs.copyFileSync(DB_PATH + '/Base.wal', SNAP_PATH + '/Base.wal');
+        base.close();
+        base = new qm.Base({ mode: 'open', dbPath: SNAP_PATH });
+        people = base.store("People");
+        assert.strictEqual(people.length, 3);
+        var friends = people[0].friends;
+        assert.strictEqual(friends.length, 1);
+        assert.strictEqual(friends[0].Name, "Marge");
+        base.close();
+        nodefs.rmSync(SNAP_PATH, { recursive: true });
+    });
+
+    it('Should replay records with their insert time', function () {
+        var nodefs = require('fs');
+        var SNAP_PATH = DB_PATH + '-snap';
+        base.close();
+        base = new qm.Base({
+            mode: 'createClean',
+            dbPath: DB_PATH,
+            schema: [{
+                "name": "Events",
+                "fields": [{ "name": "Name", "type": "string" }],
+                "timeWindow": { "duration": 1, "unit": "day" }
+            }]
+        });
+        base.openWal({ sync: 'rec' });
+        base.close();
+        if (nodefs.existsSync(SNAP_PATH)) { nodefs.rmSync(SNAP_PATH, { recursive: true }); }
+        nodefs.mkdirSync(SNAP_PATH);
+        nodefs.readdirSync(DB_PATH).forEach(function (f) { nodefs.copyFileSync(DB_PATH + '/' + f, SNAP_PATH + '/' + f); });
+        base = new qm.Base({ mode: 'open', dbPath: DB_PATH });
+        base.store("Events").push({ Name: "Start" });
+        var insertedAt = base.store("Events").getVector("_sys_inserted_at")[0];
+        nodefs.copyFileSync(DB_PATH + '/Base.wal', SNAP_PATH + '/Base.wal');
+        base.close();
+        // replay happens later, but must not take a new insert time
+        var start = Date.now(); while (Date.now() - start < 20) { }
+        base = new qm.Base({ mode: 'open', dbPath: SNAP_PATH });
+        assert.strictEqual(base.store("Events").length, 1);
+        assert.strictEqual(base.store("Events").getVector("_sys_inserted_at")[0], insertedAt);
+        base.close();
+        nodefs.rmSync(SNAP_PATH, { recursive: true });
+    });
+});
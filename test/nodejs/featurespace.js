@@ -1930,5 +1930,29 @@ describe('Feature Space Tests', function () {
             assert.eqtol(mat.at(0, 10), 2);
             assert.eqtol(mat.at(2, 10), 1);
         })
+        it('should return the same matrix as extracting records one by one for a big record set', function () {
+            // enough records to be extracted in several chunks
+            var texts = Store.allRecords.map(function (rec) { return rec.Text; });
+            for (var i = 0; i < 5000; i++) {
+                Store.push({ Value: i / 100, Category: ["a", "b", "c"][i % 3], Values: [i / 100], Categories: ["a"],
+                    Date: "2014-10-10T00:11:22", Text: texts[i % texts.length] + " " + i });
+            }
+            var ftr = new qm.FeatureSpace(base, [
+                { type: "numeric", source: "FtrSpaceTest", field: "Value" },
+                { type: "categorical", source: "FtrSpaceTest", field: "Category", values: ["a", "b", "c"] },
+                { type: "text", source: "FtrSpaceTest", field: "Text", tokenizer: { type: "simple", stemmer: "porter" } }
+            ]);
+            var rs = Store.allRecords;
+            ftr.updateRecords(rs);
+            var mat = ftr.extractMatrix(rs);
+            var spMat = ftr.extractSparseMatrix(rs);
+
+            assert.strictEqual(mat.cols, rs.length);
+            assert.strictEqual(spMat.cols, rs.length);
+            assert.eqtol(mat.minus(spMat.full()).frob(), 0);
+            for (var i = 0; i < rs.length; i += 997) {
+                assert.eqtol(mat.getCol(i).minus(ftr.extractVector(rs[i])).norm(), 0);
+            }
+        })
     });
 })
@@ -12,6 +12,7 @@
 //
 var assert = require("../../src/nodejs/scripts/assert.js")
 var la = require('../../index.js').la;
+var fs = require('../../index.js').fs;
 
 
 describe('Import test', function () {
@@ -4416,3 +4417,148 @@ describe('Rectangle Sparse Matrix Tests', function () {
 
     })
 });
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Typed array tests
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+describe('Typed Array Tests', function () {
+    describe('Vector Test', function () {
+        it('should share memory with a Float64Array given to the constructor', function () {
+            var arr = new Float64Array([1, 2, 3]);
+            var vec = new la.Vector(arr);
+            assert.strictEqual(vec.length, 3);
+            assert.strictEqual(vec.sum(), 6);
+            arr[0] = 10;
+            assert.strictEqual(vec[0], 10);
+            vec[2] = 5;
+            assert.strictEqual(arr[2], 5);
+        })
+        it('should share memory with a Float64Array subarray', function () {
+            var arr = new Float64Array([1, 2, 3, 4]);
+            var vec = new la.Vector(arr.subarray(1, 3));
+            assert.deepEqual(vec.toArray(), [2, 3]);
+            vec[0] = 7;
+            assert.strictEqual(arr[1], 7);
+            var view = vec.toTypedArray();
+            assert.strictEqual(view.buffer, arr.buffer);
+            assert.strictEqual(view.byteOffset, 8);
+            assert.strictEqual(view.length, 2);
+        })
+        it('should copy typed arrays of other types', function () {
+            var arr = new Float32Array([1, 2, 3]);
+            var vec = new la.Vector(arr);
+            assert.deepEqual(vec.toArray(), [1, 2, 3]);
+            arr[0] = 10;
+            assert.strictEqual(vec[0], 1);
+        })
+        it('should return a Float64Array sharing memory with the vector', function () {
+            var vec = new la.Vector([1, 2, 3]);
+            var arr = vec.toTypedArray();
+            assert.ok(arr instanceof Float64Array);
+            assert.deepEqual(Array.prototype.slice.call(arr), [1, 2, 3]);
+            arr[1] = 5;
+            assert.strictEqual(vec[1], 5);
+            vec.put(2, 4);
+            assert.strictEqual(arr[2], 4);
+            // next call returns a view on the same buffer
+            assert.strictEqual(vec.toTypedArray().buffer, arr.buffer);
+        })
+        it('should keep the typed array valid after the vector is gone', function () {
+            var arr = new la.Vector([1, 2, 3]).toTypedArray();
+            if (global.gc) { global.gc(); }
+            assert.deepEqual(Array.prototype.slice.call(arr), [1, 2, 3]);
+        })
+        it('should stop sharing when the length of the vector changes', function () {
+            var vec = new la.Vector([1, 2, 3]);
+            var arr = vec.toTypedArray();
+            vec.push(4);
+            assert.strictEqual(vec.length, 4);
+            arr[0] = 10;
+            assert.strictEqual(vec[0], 1);
+            vec.splice(0, 1, 5, 6);
+            vec.trunc(2);
+            assert.deepEqual(vec.toArray(), [5, 6]);
+            assert.strictEqual(arr.length, 3);
+        })
+        it('should return a shorter typed array after a splice that only deletes', function () {
+            var vec = new la.Vector([1, 2, 3, 4]);
+            var arr = vec.toTypedArray();
+            vec.splice(1, 2);
+            assert.deepEqual(vec.toArray(), [1, 4]);
+            assert.deepEqual(Array.prototype.slice.call(arr), [1, 2, 3, 4]);
+            assert.strictEqual(vec.toTypedArray().length, 2);
+        })
+        it('should stop sharing before loading values from a file', function () {
+            var fout = fs.openWrite('./vec_loadascii.txt');
+            fout.writeLine('3'); fout.writeLine('4');
+            fout.close();
+            var vec = new la.Vector([1, 2]);
+            var arr = vec.toTypedArray();
+            var fin = fs.openRead('./vec_loadascii.txt');
+            vec.loadascii(fin);
+            fin.close();
+            fs.del('./vec_loadascii.txt');
+            assert.deepEqual(vec.toArray(), [1, 2, 3, 4]);
+            assert.strictEqual(arr.length, 2);
+            assert.strictEqual(vec.toTypedArray().length, 4);
+        })
+        it('should return an empty Float64Array for an empty vector', function () {
+            var arr = new la.Vector().toTypedArray();
+            assert.ok(arr instanceof Float64Array);
+            assert.strictEqual(arr.length, 0);
+        })
+        it('should copy a shared vector', function () {
+            var arr = new Float64Array([1, 2, 3]);
+            var vec = new la.Vector(new la.Vector(arr));
+            vec.push(4);
+            arr[0] = 10;
+            assert.deepEqual(vec.toArray(), [1, 2, 3, 4]);
+        })
+    });
+
+    describe('IntVector Test', function () {
+        it('should share memory with an Int32Array', function () {
+            var arr = new Int32Array([1, 2, 3]);
+            var vec = new la.IntVector(arr);
+            arr[0] = 10;
+            assert.strictEqual(vec[0], 10);
+            var view = vec.toTypedArray();
+            assert.ok(view instanceof Int32Array);
+            assert.strictEqual(view.buffer, arr.buffer);
+        })
+        it('should throw for vectors without typed arrays', function () {
+            assert.throws(function () {
+                new la.StrVector(['a']).toTypedArray();
+            });
+        })
+    });
+
+    describe('Matrix Test', function () {
+        it('should return a row major Float64Array sharing memory with the matrix', function () {
+            var mat = new la.Matrix([[1, 2, 3], [4, 5, 6]]);
+            var arr = mat.toTypedArray();
+            assert.deepEqual(Array.prototype.slice.call(arr), [1, 2, 3, 4, 5, 6]);
+            arr[5] = 7;
+            assert.strictEqual(mat.at(1, 2), 7);
+            mat.put(0, 1, 8);
+            assert.strictEqual(arr[1], 8);
+        })
+        it('should create a matrix on the memory of a Float64Array', function () {
+            var arr = new Float64Array([1, 2, 3, 4, 5, 6]);
+            var mat = new la.Matrix({ rows: 3, cols: 2, data: arr });
+            assert.strictEqual(mat.rows, 3);
+            assert.strictEqual(mat.cols, 2);
+            assert.strictEqual(mat.at(2, 1), 6);
+            arr[0] = 10;
+            assert.strictEqual(mat.at(0, 0), 10);
+            var prod = mat.multiply(new la.Vector([1, 1]));
+            assert.deepEqual(prod.toArray(), [12, 7, 11]);
+        })
+        it('should throw when the data does not match the dimensions', function () {
+            assert.throws(function () {
+                new la.Matrix({ rows: 3, cols: 2, data: new Float64Array(5) });
+            });
+        })
+    });
+});
@@ -331,6 +331,16 @@ describe('Record Set Tests', function () {
             assert.strictEqual(recSet[0].Title, "Every Day");
             assert.strictEqual(recSet[1].Title, "Enteng Kabisote 3: Okay ka fairy ko... The legend goes on and on and on");
         })
+        it('should keep only the first limit records', function () {
+            recSet.sortByField("Title", 1, 1);
+            assert.strictEqual(recSet.length, 1);
+            assert.strictEqual(recSet[0].Title, "Enteng Kabisote 3: Okay ka fairy ko... The legend goes on and on and on");
+        })
+        it('should keep all records if limit is larger than the record set', function () {
+            recSet.sortByField("Title", -1, 10);
+            assert.strictEqual(recSet.length, 2);
+            assert.strictEqual(recSet[0].Title, "Every Day");
+        })
         it('should throw an exception if no parameters are given', function () {
             assert.throws(function () {
                 recSet.sortByField();
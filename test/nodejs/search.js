@@ -1531,6 +1531,59 @@ describe('Gix Tests', function () {
     testGixFrequency2("tiny");
 })
 
+describe('Gix Compression Tests', function () {
+    var base = undefined;
+
+    beforeEach(function () {
+        qm.delLock();
+        base = new qm.Base({ mode: 'createClean' });
+    });
+    afterEach(function () {
+        base.close();
+    });
+
+    function testGixCompression(gixType) {
+        describe('Test compressed child vectors for gix type "' + gixType + '"', function () {
+            it('should return same records for compressed and uncompressed keys', function () {
+                base.createStore({
+                    name: 'CompressStore',
+                    fields: [ { name: 'Value', type: 'string' } ],
+                    keys: [
+                        { field: 'Value', type: 'value', name: 'Plain', storage: gixType },
+                        { field: 'Value', type: 'value', name: 'Compressed', storage: gixType, compress: true }
+                    ]
+                });
+                var store = base.store('CompressStore');
+                for (var i = 0; i < 5000; i++) {
+                    store.push({ Value: 'v' + (i % 7) });
+                }
+                for (var i = 0; i < 7; i++) {
+                    var plain = base.search({ $from: 'CompressStore', Plain: 'v' + i });
+                    var compressed = base.search({ $from: 'CompressStore', Compressed: 'v' + i });
+                    assert.strictEqual(compressed.length, plain.length);
+                    for (var j = 0; j < plain.length; j++) {
+                        assert.strictEqual(compressed[j].$id, plain[j].$id);
+                        assert.strictEqual(compressed[j].$fq, plain[j].$fq);
+                    }
+                }
+            })
+        })
+    }
+    testGixCompression("full");
+    testGixCompression("small");
+    testGixCompression("tiny");
+
+    it('should not allow compression of linear keys', function () {
+        assert.throws(function () {
+            base.createStore({
+                name: 'CompressStore',
+                fields: [ { name: 'Value', type: 'int' } ],
+                keys: [ { field: 'Value', type: 'linear', compress: true } ]
+            });
+        });
+    })
+})
+
 describe('Gix Position Tests', function () {
     var base = undefined;
 
@@ -1729,3 +1782,158 @@ describe('Gix Join Test', function () {
         assert.strictEqual(res.length, 3);
     });
 });
+
+describe('Parallel Query Tests', function () {
+    var base = undefined;
+
+    beforeEach(function () {
+        qm.delLock();
+        base = new qm.Base({
+            mode: 'createClean',
+            schema: [
+                { name: 'Items',
+                  fields: [{ name: 'Tags', type: 'string_v' }, { name: 'Value', type: 'int' }],
+                  keys: [
+                      { field: 'Tags', type: 'value' },
+                      { field: 'Tags', type: 'value', name: 'TinyTags', storage: 'tiny' },
+                      { field: 'Value', type: 'linear' }
+                  ] }
+            ]
+        });
+        var store = base.store('Items');
+        for (var i = 0; i < 1000; i++) {
+            var tags = [];
+            for (var t = 2; t < 8; t++) { if (i % t == 0) { tags.push('t' + t); } }
+            store.push({ Tags: tags, Value: i % 100 });
+        }
+    });
+    afterEach(function () {
+        base.close();
+    });
+
+    function checkSame(query) {
+        var res = base.search(query);
+        query.$threads = 4;
+        var resPar = base.search(query);
+        assert.strictEqual(resPar.length, res.length);
+        for (var i = 0; i < res.length; i++) {
+            assert.strictEqual(resPar[i].$id, res[i].$id);
+            assert.strictEqual(resPar[i].$fq, res[i].$fq);
+        }
+    }
+
+    it('should return same results for OR of several branches', function () {
+        checkSame({ $from: 'Items', $or: [{ Tags: 't2' }, { Tags: 't3' }, { TinyTags: 't5' },
+            { Tags: 't7', Value: { $gt: 50 } }, { $not: { Tags: 't2' } }] });
+    });
+    it('should return same results for nested AND and OR', function () {
+        checkSame({ $from: 'Items', $or: [{ Tags: 't2' }, { Tags: 't3', $or: [{ Tags: 't5' }, { TinyTags: 't7' }] }],
+            $not: { Value: { $lt: 10 } }, TinyTags: 't4' });
+    });
+    it('should apply sort and limit after parallel search', function () {
+        checkSame({ $from: 'Items', $or: [{ Tags: 't6' }, { Tags: 't7' }], $sort: { Value: 1 }, $limit: 10 });
+    });
+});
+
+describe('Async Query Tests', function () {
+    var base = undefined;
+    var store = undefined;
+
+    beforeEach(function () {
+        qm.delLock();
+        base = new qm.Base({
+            mode: 'createClean',
+            schema: [
+                { name: 'Items',
+                  fields: [{ name: 'Tags', type: 'string_v' }, { name: 'Value', type: 'int' }],
+                  keys: [
+                      { field: 'Tags', type: 'value' },
+                      { field: 'Value', type: 'linear' }
+                  ] }
+            ]
+        });
+        store = base.store('Items');
+        for (var i = 0; i < 1000; i++) {
+            var tags = [];
+            for (var t = 2; t < 8; t++) { if (i % t == 0) { tags.push('t' + t); } }
+            store.push({ Tags: tags, Value: i % 100 });
+        }
+    });
+    afterEach(function () {
+        base.close();
+    });
+
+    function assertSameRecs(rs1, rs2) {
+        assert.strictEqual(rs1.length, rs2.length);
+        for (var i = 0; i < rs1.length; i++) {
+            assert.strictEqual(rs1[i].$id, rs2[i].$id);
+        }
+    }
+
+    it('should resolve searchAsync with the same records as search', function () {
+        var query = { $from: 'Items', $or: [{ Tags: 't3' }, { Value: { $lt: 10 } }], $sort: { Value: 1 } };
+        var res = base.search(query);
+        return base.searchAsync(query).then(function (resAsync) {
+            assertSameRecs(resAsync, res);
+        });
+    });
+    it('should call the callback when given one', function (done) {
+        var res = base.search({ $from: 'Items', Tags: 't5' });
+        var ret = base.searchAsync({ $from: 'Items', Tags: 't5' }, function (err, resAsync) {
+            if (err) { return done(err); }
+            try {
+                assertSameRecs(resAsync, res);
+                done();
+            } catch (e) {
+                done(e);
+            }
+        });
+        assert.strictEqual(ret, undefined);
+    });
+    it('should throw on an invalid query', function () {
+        assert.throws(function () {
+            base.searchAsync({ $from: 'NoSuchStore' });
+        });
+    });
+    it('should run several searches in parallel', function () {
+        var queries = [];
+        for (var t = 2; t < 8; t++) { queries.push({ $from: 'Items', Tags: 't' + t, Value: { $gt: 20 } }); }
+        return Promise.all(queries.map(function (query) { return base.searchAsync(query); }))
+            .then(function (results) {
+                for (var i = 0; i < queries.length; i++) {
+                    assertSameRecs(results[i], base.search(queries[i]));
+                }
+            });
+    });
+    it('should wait for pending searches before pushing', function () {
+        var promise = base.searchAsync({ $from: 'Items', Value: { $gt: 50 } });
+        store.push({ Tags: ['t2'], Value: 99 });
+        return promise.then(function (res) {
+            assert(res.length == 500 || res.length == 501);
+            assert.strictEqual(store.length, 1001);
+        });
+    });
+    it('should not close the base while a search is pending', function () {
+        var promise = base.searchAsync({ $from: 'Items', Tags: 't2' });
+        assert.throws(function () { base.close(); });
+        return promise.then(function (res) {
+            assert.strictEqual(res.length, 500);
+        });
+    });
+    it('should resolve aggrAsync with the same aggregates as aggr', function () {
+        var rs = base.search({ $from: 'Items', Tags: 't2' });
+        var aggr = rs.aggr({ name: 'ValueHist', field: 'Value', type: 'histogram', min: 0, max: 100, buckets: 10 });
+        return rs.aggrAsync({ name: 'ValueHist', field: 'Value', type: 'histogram', min: 0, max: 100, buckets: 10 })
+            .then(function (aggrAsync) {
+                assert.deepEqual(aggrAsync, aggr);
+            });
+    });
+    it('should resolve filterByFieldAsync without changing the record set', function () {
+        var rs = base.search({ $from: 'Items', Tags: 't3' });
+        var length = rs.length;
+        return rs.filterByFieldAsync('Value', 10, 20).then(function (filtered) {
+            assert.strictEqual(rs.length, length);
+            assertSameRecs(filtered, rs.clone().filterByField('Value', 10, 20));
+        });
+    });
+});
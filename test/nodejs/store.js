@@ -196,6 +196,47 @@ describe('Store Tests', function () {
         })
     });
 
+    describe('PushBatch Test', function () {
+        it('should add a batch of persons to the store', function () {
+            var ids = table.base.store("People").pushBatch({
+                "Name": ["Janez Novak", "Micka Kovacic"],
+                "Gender": ["Male", "Female"]
+            });
+            assert.deepEqual(ids, [2, 3]);
+            assert.strictEqual(table.base.store("People").length, 4);
+            assert.strictEqual(table.base.store("People")[3].Name, "Micka Kovacic");
+            assert.strictEqual(table.base.store("People").recordByName("Janez Novak").Gender, "Male");
+        })
+        it('should update existing person with the same primary field', function () {
+            var ids = table.base.store("People").pushBatch({
+                "Name": ["Blaz Fortuna"],
+                "Gender": ["Extraterrestrial"]
+            });
+            assert.deepEqual(ids, [1]);
+            assert.strictEqual(table.base.store("People").length, 2);
+            assert.strictEqual(table.base.store("People")[1].Gender, "Extraterrestrial");
+        })
+        it('should keep existing person when only the primary field is given', function () {
+            var ids = table.base.store("People").pushBatch({ "Name": ["Blaz Fortuna"] });
+            assert.deepEqual(ids, [1]);
+            assert.strictEqual(table.base.store("People")[1].Gender, "Male");
+        })
+        it('should update person added earlier in the same batch', function () {
+            var ids = table.base.store("People").pushBatch({
+                "Name": ["Janez Novak", "Janez Novak"],
+                "Gender": ["Male", "Female"]
+            });
+            assert.deepEqual(ids, [2, 2]);
+            assert.strictEqual(table.base.store("People").length, 3);
+            assert.strictEqual(table.base.store("People")[2].Gender, "Female");
+        })
+        it('should throw if columns are of different length', function () {
+            assert.throws(function () {
+                table.base.store("People").pushBatch({ "Name": ["Janez Novak"], "Gender": [] });
+            });
+        })
+    });
+
     describe('Update Test', function () {
         it('should update the existing person', function () {
             table.base.store("People").push({ "Name": "Blaz Fortuna", "Gender": "Male" });
@@ -880,6 +921,25 @@ describe('AddTrigger Tests', function () {
             assert.strictEqual(MoviesAdd, 2);
             assert.strictEqual(MoviesUpdate, 0);
         })
+
+        it('should call the addTrigger for records loaded before a bad line', function () {
+            var PeopleAdd = 0;
+            table.base.store("People").addTrigger({
+                onAdd: function (person) { PeopleAdd = PeopleAdd + 1; }
+            });
+            var filename = "./loadjson_error.txt";
+            var fout = qm.fs.openWrite(filename);
+            fout.writeLine(JSON.stringify({ Name: "Jan Rupnik", Gender: "Male" }));
+            fout.writeLine(JSON.stringify({ Name: "Mario Karlovcec", Gender: "Male" }));
+            fout.writeLine("{ Name: ");
+            fout.close();
+            assert.throws(function () {
+                table.base.store("People").loadJson(filename);
+            });
+            qm.fs.del(filename);
+            assert.strictEqual(table.base.store("People").length, 4);
+            assert.strictEqual(PeopleAdd, 2);
+        })
     });
 })
 
@@ -1078,6 +1138,61 @@ describe('Schema Time Window Test', function () {
         base.close();
     });
 
+    describe('Testing partitioned timeWindow (size: 2h, partition: hour)', function () {
+        base = new qm.Base({ mode: 'createClean' });
+        base.createStore({
+            "name": "TestStore",
+            "fields": [
+                { "name": "DateTime", "type": "datetime" },
+                { "name": "Hour", "type": "string" },
+                { "name": "Measurement", "type": "float" }
+            ],
+            "keys": [
+                { "field": "Hour", "type": "value" }
+            ],
+            timeWindow: {
+                duration: 2,
+                unit: "hour",
+                field: "DateTime",
+                partition: "hour"
+            }
+        });
+
+        // push 5 hours of records, 4 per hour
+        var start = Date.UTC(2017, 0, 1);
+        for (var i = 0; i < 20; i++) {
+            base.store("TestStore").push({
+                "DateTime": new Date(start + i * 15 * 60 * 1000).toISOString(),
+                "Hour": "h" + Math.floor(i / 4),
+                "Measurement": i
+            });
+        }
+
+        var before = base.store("TestStore").allRecords.length;
+        base.garbageCollect();
+        // read everything before the base is closed
+        var after = base.store("TestStore").allRecords;
+        var afterLength = after.length;
+        var afterFirst = after[0].Measurement;
+        var expiredHits = base.search({ $from: "TestStore", Hour: "h1" }).length;
+        var keptHits = base.search({ $from: "TestStore", Hour: "h2" }).length;
+
+        it('store should contain 20 records before .garbageCollect()', function () {
+            assert.strictEqual(20, before);
+        });
+        // window starts at 02:45, partitions for hours 0 and 1 ended before it
+        it('store should drop whole expired partitions', function () {
+            assert.strictEqual(12, afterLength);
+            assert.strictEqual(8, afterFirst);
+        });
+        it('index should not return records from dropped partitions', function () {
+            assert.strictEqual(0, expiredHits);
+            assert.strictEqual(4, keptHits);
+        });
+
+        base.close();
+    });
+
     describe('Testing window garbage collection timeout', function () {
         // generate store with window 3
         base = new qm.Base({ mode: 'createClean' });
@@ -1315,6 +1430,29 @@ describe('Int-ish field-type tests ', function () {
         assert.strictEqual(rs.length, 1);
         assert.strictEqual(rs[0].$id, id2);
 
+        base.close();
+    })
+    it('should index all records of a batch', function () {
+        var base = new qm.Base({ mode: 'createClean' });
+        base.createStore({
+            "name": "Tags",
+            "fields": [
+                { "name": "tag", "type": "string" },
+                { "name": "title", "type": "string" }
+            ],
+            "keys": [
+                { "field": "tag", "type": "value" },
+                { "field": "title", "type": "text" }
+            ]
+        });
+        var store = base.store("Tags");
+        store.push({ tag: "a", title: "first title" });
+        store.pushBatch({ tag: ["b", "a", "b"], title: ["second title", "third", "fourth title"] });
+
+        assert.strictEqual(base.search({ $from: "Tags", tag: "a" }).length, 2);
+        assert.strictEqual(base.search({ $from: "Tags", tag: "b" }).length, 2);
+        assert.strictEqual(base.search({ $from: "Tags", title: "title" }).length, 3);
+
         base.close();
     })
 })
@@ -42,4 +42,83 @@ describe('Default field-location tests ', function () {
         assert.strictEqual(store_desc.fields.length, 2);
         db.close();
     })
-})
\ No newline at end of file
+})
+describe('Column field-location tests ', function () {
+    function GetColumnStoreTemplate() {
+        return {
+            "name": store_name,
+            "fields": [
+                { "name": "name", "type": "string" },
+                { "name": "val", "type": "int", "store": "column" },
+                { "name": "score", "type": "float", "null": true, "store": "column" },
+                { "name": "time", "type": "datetime", "store": "column" }
+            ]
+        };
+    }
+    it('should read and update values of column fields', function () {
+        var db = new qm.Base({ mode: 'createClean' });
+        db.createStore(GetColumnStoreTemplate());
+        var store = db.store(store_name);
+        store.push({ name: "a", val: 1, score: 0.5, time: "2015-01-01T00:00:00" });
+        store.push({ name: "b", val: 2, time: "2015-01-02T00:00:00" });
+        store.push({ name: "c", val: 3, score: 1.5, time: "2015-01-03T00:00:00" });
+        assert.strictEqual(store.length, 3);
+        assert.strictEqual(store[1].name, "b");
+        assert.strictEqual(store[1].val, 2);
+        assert.strictEqual(store[1].score, null);
+        assert.strictEqual(store[2].score, 1.5);
+        assert.strictEqual(store[2].time.getTime(), new Date("2015-01-03T00:00:00Z").getTime());
+        store[0].val = 10;
+        assert.strictEqual(store[0].val, 10);
+        var recs = store.allRecords.filterByField("val", 3, 10);
+        assert.strictEqual(recs.length, 2);
+        db.close();
+    })
+    it('should persist column fields when base is reopened', function () {
+        var db = new qm.Base({ mode: 'createClean' });
+        db.createStore(GetColumnStoreTemplate());
+        var store = db.store(store_name);
+        for (var i = 0; i < 10; i++) {
+            store.push({ name: "n" + i, val: i, score: i / 2, time: "2015-01-01T00:00:00" });
+        }
+        store.clear(4);
+        db.close();
+        db = new qm.Base({ mode: 'openReadOnly' });
+        store = db.store(store_name);
+        assert.strictEqual(store.length, 6);
+        assert.strictEqual(store.first.val, 4);
+        assert.strictEqual(store.last.score, 4.5);
+        db.close();
+    })
+    it('should not change the store when a column field is missing', function () {
+        var db = new qm.Base({ mode: 'createClean' });
+        db.createStore(GetColumnStoreTemplate());
+        var store = db.store(store_name);
+        store.push({ name: "a", val: 1, time: "2015-01-01T00:00:00" });
+        assert.throws(function () {
+            store.push({ name: "b", time: "2015-01-02T00:00:00" });
+        });
+        assert.strictEqual(store.length, 1);
+        store.push({ name: "c", val: 3, time: "2015-01-03T00:00:00" });
+        assert.strictEqual(store.length, 2);
+        assert.strictEqual(store[1].name, "c");
+        assert.strictEqual(store[1].val, 3);
+        db.close();
+    })
+    it('should save changed columns on partial flush', function () {
+        var db = new qm.Base({ mode: 'createClean' });
+        db.createStore(GetColumnStoreTemplate());
+        var store = db.store(store_name);
+        var colFNm = './db/' + store_name + '.Column.val';
+        store.push({ name: "a", val: 1, time: "2015-01-01T00:00:00" });
+        db.partialFlush();
+        assert.ok(fs.exists(colFNm));
+        var size = fs.fileInfo(colFNm).size;
+        for (var i = 0; i < 10; i++) {
+            store.push({ name: "n" + i, val: i, time: "2015-01-01T00:00:00" });
+        }
+        db.partialFlush();
+        assert.ok(fs.fileInfo(colFNm).size > size);
+        db.close();
+    })
+})
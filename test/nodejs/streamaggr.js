@@ -5415,6 +5415,129 @@ describe('Stream aggregate set tests', function () {
         store.push({ Value: 3, Date: new Date(time + 3000).toISOString() });
         assert.strictEqual(ma.getFloat(), 2);
     });
+
+    it('should run independent aggregates in parallel', function () {
+        var tick = new qm.StreamAggr(base, { type: "timeSeriesWinBuf", store: "Test", timestamp: "Date", value: "Value", winsize: 5000 });
+        var ma = new qm.StreamAggr(base, { type: "ma", inAggr: tick });
+        var variance = new qm.StreamAggr(base, { type: "variance", inAggr: tick });
+        var sum = new qm.StreamAggr(base, { type: "winBufSum", inAggr: tick });
+        var set = store.addStreamAggr({ type: "set", aggregates: [tick, ma, variance, sum], threads: 4 });
+        assert.strictEqual(set.getParams().threads, 4);
+        assert.strictEqual(set.getParams().deterministic, false);
+
+        var time = new Date('2015-06-10T14:13:45.0').getTime();
+        for (var i = 1; i <= 10; i++) {
+            store.push({ Value: i, Date: new Date(time + i * 1000).toISOString() });
+        }
+        // compare with values in the window
+        var vals = tick.getFloatVector();
+        var mean = vals.sum() / vals.length;
+        var sqr = 0;
+        for (var j = 0; j < vals.length; j++) { sqr += (vals[j] - mean) * (vals[j] - mean); }
+        assert.eqtol(sum.getFloat(), vals.sum());
+        assert.eqtol(ma.getFloat(), mean);
+        assert.eqtol(variance.getFloat(), sqr / (vals.length - 1));
+    });
+
+    it('should run javascript aggregates on the calling thread', function () {
+        var tick = new qm.StreamAggr(base, { type: "timeSeriesTick", store: "Test", timestamp: "Date", value: "Value" });
+        var ema1 = new qm.StreamAggr(base, { type: "ema", inAggr: tick, emaType: "previous", interval: 2000, initWindow: 0 });
+        var ema2 = new qm.StreamAggr(base, { type: "ema", inAggr: tick, emaType: "previous", interval: 5000, initWindow: 0 });
+        var calls = 0;
+        var counter = new qm.StreamAggr(base, new function () {
+            this.onAdd = function (rec) { calls++; }
+        });
+        var ema3 = new qm.StreamAggr(base, { type: "ema", inAggr: tick, emaType: "previous", interval: 8000, initWindow: 0 });
+        store.addStreamAggr({ type: "set", aggregates: [tick, ema1, counter, ema2, ema3], threads: 4 });
+
+        var time = new Date('2015-06-10T14:13:45.0').getTime();
+        for (var i = 1; i <= 10; i++) {
+            store.push({ Value: i, Date: new Date(time + i * 1000).toISOString() });
+        }
+        assert.strictEqual(calls, 10);
+        assert(ema1.getFloat() > ema2.getFloat());
+        assert(ema2.getFloat() > ema3.getFloat());
+    });
+
+    it('should set parameters of store aggregates', function () {
+        assert.deepEqual(store.getStreamAggrParams(), { threads: 1, deterministic: false });
+        store.setStreamAggrParams({ threads: 2, deterministic: true });
+        assert.deepEqual(store.getStreamAggrParams(), { threads: 2, deterministic: true });
+        assert.throws(function () { store.setStreamAggrParams({ threads: 0 }); });
+
+        var tick = store.addStreamAggr({ type: "timeSeriesWinBuf", timestamp: "Date", value: "Value", winsize: 5000 });
+        var ma = store.addStreamAggr({ type: "ma", inAggr: tick.name });
+        var time = new Date('2015-06-10T14:13:45.0').getTime();
+        store.push({ Value: 1, Date: new Date(time + 1000).toISOString() });
+        store.push({ Value: 2, Date: new Date(time + 2000).toISOString() });
+        assert.strictEqual(ma.getFloat(), 1.5);
+    });
+});
+
+describe('Stream aggregate batch tests', function () {
+    var base = undefined;
+
+    beforeEach(function () {
+        base = new qm.Base({
+            mode: "createClean",
+            schema: [
+                { name: "Single", fields: [{ name: "Value", type: "float" }, { name: "Date", type: "datetime" }] },
+                { name: "Batch", fields: [{ name: "Value", type: "float" }, { name: "Date", type: "datetime" }] }
+            ]
+        });
+    });
+    afterEach(function () {
+        base.close();
+    });
+
+    function addAggregates(store) {
+        var aggrs = {};
+        aggrs.tick = store.addStreamAggr({ type: "timeSeriesTick", timestamp: "Date", value: "Value" });
+        aggrs.ema = store.addStreamAggr({ type: "ema", inAggr: aggrs.tick.name, emaType: "previous", interval: 3000, initWindow: 1000 });
+        aggrs.tdigest = store.addStreamAggr({ type: "tdigest", inAggr: aggrs.ema.name, quantiles: [0.1, 0.5, 0.9] });
+        aggrs.hist = store.addStreamAggr({ type: "onlineHistogram", inAggr: aggrs.tick.name, lowerBound: 0, upperBound: 10, bins: 5 });
+        aggrs.winbuf = store.addStreamAggr({ type: "timeSeriesWinBuf", timestamp: "Date", value: "Value", winsize: 2000 });
+        aggrs.ma = store.addStreamAggr({ type: "ma", inAggr: aggrs.winbuf.name });
+        return aggrs;
+    }
+
+    it('should give the same results for single and batch updates', function () {
+        var single = addAggregates(base.store("Single"));
+        var batch = addAggregates(base.store("Batch"));
+
+        var time = new Date('2015-06-10T14:13:45.0').getTime();
+        var values = [], dates = [];
+        for (var i = 0; i < 100; i++) {
+            values.push(i % 10);
+            dates.push(new Date(time + i * 500).toISOString());
+            base.store("Single").push({ Value: values[i], Date: dates[i] });
+        }
+        base.store("Batch").pushBatch({ Value: values, Date: dates });
+
+        assert.strictEqual(batch.tick.getFloat(), single.tick.getFloat());
+        assert.eqtol(batch.ema.getFloat(), single.ema.getFloat());
+        assert.deepEqual(batch.tdigest.getFloatVector().toArray(), single.tdigest.getFloatVector().toArray());
+        assert.deepEqual(batch.hist.getFloatVector().toArray(), single.hist.getFloatVector().toArray());
+        assert.eqtol(batch.ma.getFloat(), single.ma.getFloat());
+    });
+
+    it('should pass an array of record ids as a batch', function () {
+        var single = addAggregates(base.store("Single"));
+        var batch = addAggregates(base.store("Batch"));
+
+        var time = new Date('2015-06-10T14:13:45.0').getTime();
+        var ids = [];
+        for (var i = 0; i < 20; i++) {
+            var rec = { Value: i % 7, Date: new Date(time + i * 500).toISOString() };
+            base.store("Single").push(rec);
+            ids.push(base.store("Batch").push(rec, false));
+        }
+        base.store("Batch").triggerOnAddCallbacks(ids);
+
+        assert.eqtol(batch.ema.getFloat(), single.ema.getFloat());
+        assert.deepEqual(batch.hist.getFloatVector().toArray(), single.hist.getFloatVector().toArray());
+        assert.eqtol(batch.ma.getFloat(), single.ma.getFloat());
+    });
 });
 
 describe('Online histogram tests', function () {
@@ -6766,6 +6889,89 @@ describe('Stream aggregate statistics', function () {
         assert(stats.mem == totalMem, 'Total memory usage does not match the usage of individual aggregates!');
         assert(stats.mem == totalByType, 'Total memory usage does not match the usage by type!');
     });
+
+    describe('Calls and latency', function () {
+        function getAggrStats(name) {
+            return base.getStreamAggrStats().aggregates.filter(function (aggr) {
+                return aggr.name == name;
+            })[0];
+        }
+
+        it('should count calls per callback', function () {
+            var tick = store.addStreamAggr({
+                type: 'timeSeriesTick',
+                timestamp: 'Time',
+                value: 'Value'
+            });
+            var counter = new qm.StreamAggr(base, new function () {
+                this.name = 'counter';
+                this.onAdd = function (rec) { };
+                this.onStep = function () { };
+                this.saveJson = function (limit) { return {}; };
+            }, 'testStore');
+            for (var i = 0; i < 100; i++) {
+                store.push({ Time: i * 1000, Value: i });
+            }
+            counter.onStep();
+
+            var tickStats = getAggrStats(tick.name);
+            assert.strictEqual(tickStats.calls.onAdd, 100);
+            assert.strictEqual(tickStats.calls.onStep, 0);
+            assert.strictEqual(tickStats.calls.total, 100);
+            var counterStats = getAggrStats(counter.name);
+            assert.strictEqual(counterStats.calls.onAdd, 100);
+            assert.strictEqual(counterStats.calls.onStep, 1);
+            assert.strictEqual(counterStats.calls.total, 101);
+        });
+        it('should order latency percentiles', function () {
+            var tick = store.addStreamAggr({
+                type: 'timeSeriesTick',
+                timestamp: 'Time',
+                value: 'Value'
+            });
+            var latency = getAggrStats(tick.name).latency;
+            assert.strictEqual(latency.max, 0);
+            assert.strictEqual(latency.p99, 0);
+
+            for (var i = 0; i < 1000; i++) {
+                store.push({ Time: i, Value: i });
+            }
+            latency = getAggrStats(tick.name).latency;
+            assert(latency.p50 > 0);
+            assert(latency.p50 <= latency.p99);
+            assert(latency.p99 <= latency.max);
+            assert(latency.mean <= latency.max);
+        });
+        it('should track memory growth', function () {
+            var tick = store.addStreamAggr({
+                type: 'timeSeriesTick',
+                timestamp: 'Time',
+                value: 'Value'
+            });
+            // keeps values of all the records in the window
+            var buffer = store.addStreamAggr({
+                type: 'timeSeriesWinBufVector',
+                inAggr: tick.name,
+                winsize: 1000000
+            });
+            var stats = getAggrStats(buffer.name);
+            assert.strictEqual(stats.memGrowth, stats.mem - stats.memStart);
+
+            for (var i = 0; i < 1000; i++) {
+                store.push({ Time: i * 1000, Value: i });
+            }
+            stats = getAggrStats(buffer.name);
+            assert(stats.memGrowth > 0);
+            assert.strictEqual(stats.memGrowth, stats.memLastGrowth);
+            // nothing changed since the last call
+            stats = getAggrStats(buffer.name);
+            assert.strictEqual(stats.memLastGrowth, 0);
+        });
+        it('should be part of base statistics', function () {
+            var stats = base.getStats();
+            assert.strictEqual(stats.stream_aggrs.count, 1);
+        });
+    });
 });
 
 describe('HistogramAD Tests', function () {